@@ -0,0 +1,114 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "archive.h"
+#include "program/programExecutionEngine.h"
+
+#include "benchmarks.h"
+
+void Bench::registerArchiveBenchmarks(Runner& runner)
+{
+    // Archive at full capacity: each new recording evicts an older one.
+    runner.add("archive/addRecording/full", [](State& state) {
+        const size_t capacity = 1000;
+        Fixture fixture;
+        Mutator::RNG rng(0);
+        Archive archive(capacity, 1.0, 0);
+        auto program = fixture.makeRandomProgram(8, rng);
+        std::vector<std::reference_wrapper<const Data::DataHandler>> dHandlers{
+            fixture.data};
+
+        // Changing the data changes the hash of the recording.
+        double value = 0.0;
+        for (size_t i = 0; i < capacity; i++) {
+            fixture.data.setDataAt(typeid(double), 0, value++);
+            archive.addRecording(program.get(), dHandlers, value, true);
+        }
+
+        while (state.keepRunning()) {
+            fixture.data.setDataAt(typeid(double), 0, value++);
+            archive.addRecording(program.get(), dHandlers, value, true);
+        }
+    });
+
+    // Full archive of programs executed on a few data states, each queried
+    // with new results of a mutated program.
+    runner.add("archive/areProgramResultsUnique", [](State& state) {
+        const size_t nbPrograms = 50;
+        const size_t nbDataStates = 20;
+        Fixture fixture;
+        Mutator::RNG rng(0);
+        Archive archive(nbPrograms * nbDataStates, 1.0, 0);
+        std::vector<std::reference_wrapper<const Data::DataHandler>> dHandlers{
+            fixture.data};
+
+        std::vector<std::shared_ptr<Program::Program>> programs;
+        for (size_t i = 0; i < nbPrograms; i++) {
+            programs.push_back(fixture.makeRandomProgram(8, rng));
+        }
+
+        std::map<size_t, double> hashesAndResults;
+        for (size_t d = 0; d < nbDataStates; d++) {
+            fixture.data.setDataAt(typeid(double), 0, (double)d);
+            for (const auto& program : programs) {
+                Program::ProgramExecutionEngine engine(*program);
+                archive.addRecording(program.get(), dHandlers,
+                                     engine.executeProgram(), true);
+            }
+            hashesAndResults[fixture.data.getHash()] = 1e6 + (double)d;
+        }
+
+        while (state.keepRunning()) {
+            doNotOptimize(archive.areProgramResultsUnique(hashesAndResults));
+        }
+    });
+
+    for (size_t size : {64, 1024}) {
+        runner.add("data/hash/" + std::to_string(size), [size](State& state) {
+            Data::PrimitiveTypeArray<double> data(size);
+            double value = 0.0;
+
+            state.setItemsPerIteration(size);
+            while (state.keepRunning()) {
+                // Invalidate the cached hash.
+                data.setDataAt(typeid(double), 0, value++);
+                doNotOptimize(data.getHash());
+            }
+        });
+    }
+}
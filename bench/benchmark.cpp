@@ -0,0 +1,351 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+#include "../lib/JsonCpp/json.h"
+
+#include "benchmark.h"
+
+#ifndef GEGELATI_VERSION
+#define GEGELATI_VERSION "unknown"
+#endif
+
+#ifndef BENCH_BUILD_TYPE
+#define BENCH_BUILD_TYPE "unknown"
+#endif
+
+/// Reset the peak resident memory of the process, when supported.
+static void resetMemoryHighWaterMark()
+{
+#ifdef __linux__
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs.is_open()) {
+        clearRefs << "5";
+    }
+#endif
+}
+
+/// Get the peak resident memory of the process in kB, or 0 if unknown.
+static uint64_t getMemoryHighWaterMark()
+{
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stoull(line.substr(6));
+        }
+    }
+#endif
+    return 0;
+}
+
+Bench::State::State(uint64_t nbIterations)
+    : nbIterations{nbIterations}, nbRemainingIterations{nbIterations}
+{
+}
+
+bool Bench::State::keepRunning()
+{
+    if (this->nbRemainingIterations == this->nbIterations && !this->isTiming &&
+        this->elapsed == Clock::duration::zero()) {
+        // First call
+        this->resumeTiming();
+    }
+    if (this->nbRemainingIterations == 0) {
+        this->pauseTiming();
+        return false;
+    }
+    this->nbRemainingIterations--;
+    return true;
+}
+
+void Bench::State::pauseTiming()
+{
+    if (this->isTiming) {
+        this->elapsed += Clock::now() - this->start;
+        this->isTiming = false;
+    }
+}
+
+void Bench::State::resumeTiming()
+{
+    if (!this->isTiming) {
+        this->isTiming = true;
+        this->start = Clock::now();
+    }
+}
+
+void Bench::State::setItemsPerIteration(uint64_t items)
+{
+    this->itemsPerIteration = items;
+}
+
+void Bench::State::addCounter(const std::string& name, double value)
+{
+    this->counters[name] += value;
+}
+
+const std::map<std::string, double>& Bench::State::getCounters() const
+{
+    return this->counters;
+}
+
+uint64_t Bench::State::getNbIterations() const
+{
+    return this->nbIterations;
+}
+
+uint64_t Bench::State::getItemsPerIteration() const
+{
+    return this->itemsPerIteration;
+}
+
+double Bench::State::getElapsedNs() const
+{
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               this->elapsed)
+        .count();
+}
+
+double Bench::Result::getMinNs() const
+{
+    return *std::min_element(this->nsPerIteration.begin(),
+                             this->nsPerIteration.end());
+}
+
+/// Get the median of a non-empty vector of values.
+static double getMedian(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return (values.size() % 2 == 1)
+               ? values[middle]
+               : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+double Bench::Result::getMedianNs() const
+{
+    return getMedian(this->nsPerIteration);
+}
+
+double Bench::Result::getMeanNs() const
+{
+    return std::accumulate(this->nsPerIteration.begin(),
+                           this->nsPerIteration.end(), 0.0) /
+           (double)this->nsPerIteration.size();
+}
+
+double Bench::Result::getMedianRate(const std::string& counter) const
+{
+    return getMedian(this->counterRates.at(counter));
+}
+
+void Bench::Runner::add(const std::string& name, Function function,
+                        uint64_t nbIterations)
+{
+    for (const auto& benchmark : this->benchmarks) {
+        if (benchmark.name == name) {
+            throw std::invalid_argument("Benchmark " + name +
+                                        " is already registered.");
+        }
+    }
+    this->benchmarks.push_back({name, function, nbIterations});
+}
+
+void Bench::Runner::setFilter(const std::string& filter)
+{
+    this->filter = filter;
+}
+
+void Bench::Runner::setMinTime(double seconds)
+{
+    this->minTime = seconds;
+}
+
+void Bench::Runner::setNbRepetitions(size_t nbRepetitions)
+{
+    if (nbRepetitions == 0) {
+        throw std::invalid_argument("At least one repetition is needed.");
+    }
+    this->nbRepetitions = nbRepetitions;
+}
+
+size_t Bench::Runner::getNbRepetitions() const
+{
+    return this->nbRepetitions;
+}
+
+double Bench::Runner::getMinTime() const
+{
+    return this->minTime;
+}
+
+std::vector<std::string> Bench::Runner::getNames() const
+{
+    std::vector<std::string> names;
+    for (const auto& benchmark : this->benchmarks) {
+        names.push_back(benchmark.name);
+    }
+    return names;
+}
+
+std::vector<Bench::Result> Bench::Runner::run(std::ostream& log) const
+{
+    const double minTimeNs = this->minTime * 1e9;
+    const uint64_t maxNbIterations = 1000000000;
+
+    std::vector<Result> results;
+    for (const auto& benchmark : this->benchmarks) {
+        if (benchmark.name.find(this->filter) == std::string::npos) {
+            continue;
+        }
+
+        // Calibrate the number of iterations.
+        uint64_t nbIterations =
+            (benchmark.nbIterations > 0) ? benchmark.nbIterations : 1;
+        while (benchmark.nbIterations == 0) {
+            State state(nbIterations);
+            benchmark.function(state);
+            double elapsedNs = state.getElapsedNs();
+            if (elapsedNs >= minTimeNs || nbIterations >= maxNbIterations) {
+                break;
+            }
+            // Aim slightly above the minimum time, growing at most tenfold.
+            double target =
+                (elapsedNs > 0.0)
+                    ? 1.2 * minTimeNs * (double)nbIterations / elapsedNs
+                    : 10.0 * (double)nbIterations;
+            nbIterations = std::max(
+                nbIterations + 1,
+                std::min((uint64_t)std::ceil(target), nbIterations * 10));
+        }
+
+        // Measure
+        Result result{benchmark.name, nbIterations, 0, {}, {}, 0};
+        resetMemoryHighWaterMark();
+        for (size_t rep = 0; rep < this->nbRepetitions; rep++) {
+            State state(nbIterations);
+            benchmark.function(state);
+            result.itemsPerIteration = state.getItemsPerIteration();
+            result.nsPerIteration.push_back(state.getElapsedNs() /
+                                            (double)nbIterations);
+            for (const auto& counter : state.getCounters()) {
+                result.counterRates[counter.first].push_back(
+                    counter.second * 1e9 / state.getElapsedNs());
+            }
+        }
+        result.memoryHighWaterMark = getMemoryHighWaterMark();
+
+        log << std::left << std::setw(48) << result.name << std::right
+            << std::setw(14) << std::fixed << std::setprecision(1)
+            << result.getMedianNs() << " ns" << std::setw(12)
+            << result.nbIterations << " it";
+        for (const auto& counter : result.counterRates) {
+            log << "  " << counter.first << "/s=" << std::setprecision(0)
+                << result.getMedianRate(counter.first);
+        }
+        log << std::endl;
+        results.push_back(result);
+    }
+    return results;
+}
+
+void Bench::Runner::writeJson(const std::vector<Result>& results,
+                              std::ostream& out) const
+{
+    Json::Value root;
+
+    // Context of the run
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S",
+                  std::localtime(&now));
+    Json::Value& context = root["context"];
+    context["date"] = std::string(date);
+    context["gegelatiVersion"] = GEGELATI_VERSION;
+    context["buildType"] = BENCH_BUILD_TYPE;
+#if defined(__clang__)
+    context["compiler"] = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    context["compiler"] = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    context["compiler"] = "msvc " + std::to_string(_MSC_VER);
+#endif
+    context["hardwareConcurrency"] = std::thread::hardware_concurrency();
+    context["minTime"] = this->minTime;
+    context["nbRepetitions"] = (Json::UInt64)this->nbRepetitions;
+
+    // Results
+    root["benchmarks"] = Json::Value(Json::arrayValue);
+    for (const Result& result : results) {
+        Json::Value benchmark;
+        benchmark["name"] = result.name;
+        benchmark["iterations"] = (Json::UInt64)result.nbIterations;
+        benchmark["minNs"] = result.getMinNs();
+        benchmark["medianNs"] = result.getMedianNs();
+        benchmark["meanNs"] = result.getMeanNs();
+        if (result.itemsPerIteration > 0) {
+            benchmark["itemsPerSecond"] =
+                (double)result.itemsPerIteration * 1e9 / result.getMedianNs();
+        }
+        for (const auto& counter : result.counterRates) {
+            benchmark[counter.first + "PerSecond"] =
+                result.getMedianRate(counter.first);
+        }
+        if (result.memoryHighWaterMark > 0) {
+            benchmark["memoryHighWaterMarkKb"] =
+                (Json::UInt64)result.memoryHighWaterMark;
+        }
+        benchmark["repetitionsNs"] = Json::Value(Json::arrayValue);
+        for (double ns : result.nsPerIteration) {
+            benchmark["repetitionsNs"].append(ns);
+        }
+        root["benchmarks"].append(benchmark);
+    }
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+    writer->write(root, &out);
+    out << std::endl;
+}
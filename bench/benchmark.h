@@ -0,0 +1,287 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+    /**
+     * \brief Prevent the compiler from optimizing away the computation of a
+     * value.
+     *
+     * \param[in] value the value whose computation must be kept.
+     */
+    template <typename T> inline void doNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const T* sink;
+        sink = &value;
+#endif
+    }
+
+    /**
+     * \brief State of one measurement of a benchmark.
+     *
+     * The benchmark function prepares its data, then repeats the measured
+     * operation while keepRunning() returns true. Only the time elapsed
+     * between the first and last call to keepRunning() is measured, except
+     * for periods between pauseTiming() and resumeTiming().
+     */
+    class State
+    {
+      protected:
+        /// Clock used for measurements.
+        typedef std::chrono::steady_clock Clock;
+
+        /// Number of iterations of the measured operation.
+        uint64_t nbIterations;
+
+        /// Number of iterations not yet done.
+        uint64_t nbRemainingIterations;
+
+        /// Whether the timer is currently running.
+        bool isTiming = false;
+
+        /// Start of the current timed period.
+        Clock::time_point start;
+
+        /// Total time of the timed periods.
+        Clock::duration elapsed{0};
+
+        /// Number of processed items per iteration.
+        uint64_t itemsPerIteration = 0;
+
+        /// Named counters of events accumulated over all iterations.
+        std::map<std::string, double> counters;
+
+      public:
+        /**
+         * \brief Constructor of the State.
+         *
+         * \param[in] nbIterations the number of iterations of the measured
+         * operation.
+         */
+        explicit State(uint64_t nbIterations);
+
+        /**
+         * \brief Check whether the measured operation must be repeated once
+         * more.
+         *
+         * The timer is started on the first call, and stopped when all
+         * iterations are done.
+         */
+        bool keepRunning();
+
+        /// Stop the timer, for example to prepare the data of the next
+        /// iteration.
+        void pauseTiming();
+
+        /// Restart the timer after a call to pauseTiming().
+        void resumeTiming();
+
+        /**
+         * \brief Set the number of items processed by each iteration, used to
+         * report a throughput in items per second.
+         *
+         * \param[in] items the number of items per iteration.
+         */
+        void setItemsPerIteration(uint64_t items);
+
+        /**
+         * \brief Add a value to a named counter of events.
+         *
+         * Counters are reported as a rate of events per second of measured
+         * time.
+         *
+         * \param[in] name the name of the counter.
+         * \param[in] value the number of events to add to the counter.
+         */
+        void addCounter(const std::string& name, double value);
+
+        /// Get the named counters of events.
+        const std::map<std::string, double>& getCounters() const;
+
+        /// Get the number of iterations of the measured operation.
+        uint64_t getNbIterations() const;
+
+        /// Get the number of items processed by each iteration.
+        uint64_t getItemsPerIteration() const;
+
+        /// Get the measured time, in nanoseconds.
+        double getElapsedNs() const;
+    };
+
+    /// Measurements of one benchmark.
+    struct Result
+    {
+        /// Name of the benchmark.
+        std::string name;
+
+        /// Number of iterations of each repetition.
+        uint64_t nbIterations;
+
+        /// Number of items processed by each iteration.
+        uint64_t itemsPerIteration;
+
+        /// Time per iteration of each repetition, in nanoseconds.
+        std::vector<double> nsPerIteration;
+
+        /// Rate of each named counter, in events per second, for each
+        /// repetition.
+        std::map<std::string, std::vector<double>> counterRates;
+
+        /// Peak resident memory of the process during the repetitions, in
+        /// kB. 0 if unknown.
+        uint64_t memoryHighWaterMark = 0;
+
+        /// Get the minimum time per iteration, in nanoseconds.
+        double getMinNs() const;
+
+        /// Get the median time per iteration, in nanoseconds.
+        double getMedianNs() const;
+
+        /// Get the mean time per iteration, in nanoseconds.
+        double getMeanNs() const;
+
+        /// Get the median rate of a named counter, in events per second.
+        double getMedianRate(const std::string& counter) const;
+    };
+
+    /**
+     * \brief Registry and runner of benchmarks.
+     *
+     * Each benchmark is first run with an increasing number of iterations
+     * until one run lasts at least the minimum time, unless its number of
+     * iterations is fixed. Then, the given number of repetitions are
+     * measured with this number of iterations.
+     *
+     * On Linux, the peak resident memory of the process is reset before the
+     * repetitions of each benchmark, and read after them.
+     */
+    class Runner
+    {
+      public:
+        /// Type of the benchmark functions.
+        typedef std::function<void(State&)> Function;
+
+      protected:
+        /// A registered benchmark.
+        struct Benchmark
+        {
+            /// Name of the benchmark.
+            std::string name;
+
+            /// Benchmark function.
+            Function function;
+
+            /// Fixed number of iterations, or 0 for a calibrated number.
+            uint64_t nbIterations;
+        };
+
+        /// Registered benchmarks, in registration order.
+        std::vector<Benchmark> benchmarks;
+
+        /// Only benchmarks whose name contains this string are run.
+        std::string filter;
+
+        /// Minimum duration of a repetition, in seconds.
+        double minTime = 0.1;
+
+        /// Number of measured repetitions.
+        size_t nbRepetitions = 5;
+
+      public:
+        /**
+         * \brief Register a benchmark.
+         *
+         * \param[in] name the name of the benchmark, which must be unique.
+         * \param[in] function the benchmark function.
+         * \param[in] nbIterations when not 0, the number of iterations of
+         * the benchmark is fixed to this value instead of being calibrated.
+         * This is needed when the cost of an iteration depends on the
+         * previous ones, as for generations of a training.
+         * \throws std::invalid_argument if a benchmark with the same name was
+         * already registered.
+         */
+        void add(const std::string& name, Function function,
+                 uint64_t nbIterations = 0);
+
+        /// Set the filter of names of run benchmarks.
+        void setFilter(const std::string& filter);
+
+        /// Set the minimum duration of a repetition, in seconds.
+        void setMinTime(double seconds);
+
+        /// Set the number of measured repetitions.
+        void setNbRepetitions(size_t nbRepetitions);
+
+        /// Get the number of measured repetitions.
+        size_t getNbRepetitions() const;
+
+        /// Get the minimum duration of a repetition, in seconds.
+        double getMinTime() const;
+
+        /// Get the names of the registered benchmarks.
+        std::vector<std::string> getNames() const;
+
+        /**
+         * \brief Run all registered benchmarks matching the filter.
+         *
+         * \param[in] log stream where a line is printed for each benchmark.
+         * \return the Result of each run benchmark.
+         */
+        std::vector<Result> run(std::ostream& log) const;
+
+        /**
+         * \brief Write the results of benchmarks in JSON format.
+         *
+         * \param[in] results the results to write.
+         * \param[in] out the output stream.
+         */
+        void writeJson(const std::vector<Result>& results,
+                       std::ostream& out) const;
+    };
+} // namespace Bench
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <cmath>
+
+#include "mutator/lineMutator.h"
+
+#include "benchmarks.h"
+
+Bench::Fixture::Fixture(bool mixed, size_t dataSize)
+    : minus{[](double a, double b) { return a - b; }},
+      cosine{[](double a) { return std::cos(a); }}, data(dataSize)
+{
+    for (size_t i = 0; i < dataSize; i++) {
+        this->data.setDataAt(typeid(double), i, 0.5 * (double)i - 3.0);
+    }
+
+    this->set.add(this->add);
+    this->set.add(this->minus);
+    if (mixed) {
+        this->set.add(this->multByConst);
+        this->set.add(this->cosine);
+    }
+
+    this->env.reset(new Environment(this->set, {this->data}, 8, 2));
+
+    this->params.tpg.initNbRoots = 20;
+    this->params.tpg.nbRoots = 100;
+    this->params.prog.maxProgramSize = 20;
+    this->params.prog.minConstValue = -10;
+    this->params.prog.maxConstValue = 10;
+}
+
+std::shared_ptr<Program::Program> Bench::Fixture::makeRandomProgram(
+    size_t nbLines, Mutator::RNG& rng) const
+{
+    auto program = std::make_shared<Program::Program>(*this->env);
+    for (size_t i = 0; i < nbLines; i++) {
+        Program::Line& line = program->addNewLine();
+        Mutator::LineMutator::initRandomCorrectLine(line, rng);
+    }
+    for (size_t i = 0; i < this->env->getNbConstant(); i++) {
+        program->getConstantHandler().setDataAt(
+            typeid(Data::Constant), i,
+            {static_cast<int32_t>(rng.getInt32(-10, 10))});
+    }
+    return program;
+}
@@ -0,0 +1,173 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <memory>
+
+#include "data/primitiveTypeArray.h"
+#include "environment.h"
+#include "instructions/addPrimitiveType.h"
+#include "instructions/lambdaInstruction.h"
+#include "instructions/multByConstant.h"
+#include "instructions/set.h"
+#include "mutator/mutationParameters.h"
+#include "mutator/rng.h"
+#include "program/program.h"
+
+#include "benchmark.h"
+
+namespace Bench {
+
+    /**
+     * \brief Environment shared by the benchmarks of the library.
+     *
+     * The Environment contains a single PrimitiveTypeArray<double> whose
+     * values are deterministic, 8 registers and 2 constants.
+     */
+    class Fixture
+    {
+      protected:
+        /// Addition instruction.
+        Instructions::AddPrimitiveType<double> add;
+
+        /// Multiplication by a constant instruction.
+        Instructions::MultByConstant<double> multByConst;
+
+        /// Subtraction instruction.
+        Instructions::LambdaInstruction<double, double> minus;
+
+        /// Cosine instruction.
+        Instructions::LambdaInstruction<double> cosine;
+
+      public:
+        /// Data source of the Environment.
+        Data::PrimitiveTypeArray<double> data;
+
+        /// Instructions of the Environment.
+        Instructions::Set set;
+
+        /// Environment built with the set and data.
+        std::unique_ptr<Environment> env;
+
+        /// Parameters used to initialize and populate TPGGraph.
+        Mutator::MutationParameters params;
+
+        /// Index of the data source in the Environment.
+        static const uint64_t DATA_INDEX = 2;
+
+        /// Number of actions of the TPGGraph of benchmarks.
+        static const uint64_t NB_ACTIONS = 4;
+
+        /**
+         * \brief Constructor of the Fixture.
+         *
+         * \param[in] mixed when false, the Set only contains the addition
+         * and subtraction instructions. When true, multiplication by a
+         * constant and cosine are added to the Set.
+         * \param[in] dataSize number of double in the data source.
+         */
+        Fixture(bool mixed = true, size_t dataSize = 32);
+
+        /// The Set and Environment refer to the members of the Fixture.
+        Fixture(const Fixture& other) = delete;
+
+        /**
+         * \brief Create a Program made of random correct lines.
+         *
+         * Introns are not identified, so all lines are executed.
+         *
+         * \param[in] nbLines the number of lines of the Program.
+         * \param[in] rng the Random Number Generator used for the lines.
+         * \return a shared pointer to the new Program.
+         */
+        std::shared_ptr<Program::Program> makeRandomProgram(
+            size_t nbLines, Mutator::RNG& rng) const;
+    };
+
+    /// Register the ProgramExecutionEngine benchmarks.
+    void registerProgramBenchmarks(Runner& runner);
+
+    /// Register the TPGGraph and TPGExecutionEngine benchmarks.
+    void registerTPGBenchmarks(Runner& runner);
+
+    /// Register the Archive and DataHandler benchmarks.
+    void registerArchiveBenchmarks(Runner& runner);
+
+    /// Register the TPGMutator benchmarks.
+    void registerMutatorBenchmarks(Runner& runner);
+
+    /// Register the dot export and import benchmarks.
+    void registerFileBenchmarks(Runner& runner);
+
+    /**
+     * \brief Register the LearningEnvironment step benchmarks.
+     *
+     * Steps of a StickGameWithOpponent are measured in process, and through
+     * a SharedMemoryLearningEnvironment served by a child process.
+     */
+    void registerEnvironmentBenchmarks(Runner& runner);
+
+    /**
+     * \brief Register the training benchmarks.
+     *
+     * Full trainings of the learning agents on synthetic environments are
+     * measured with an increasing number of threads, for strong and weak
+     * scaling.
+     *
+     * \param[in] runner the Runner where benchmarks are registered.
+     * \param[in] maxNbThreads the largest number of threads of the sweeps.
+     */
+    void registerTrainingBenchmarks(Runner& runner, size_t maxNbThreads);
+
+#ifdef CODE_GENERATION
+    /**
+     * \brief Generate the C code of a same TPGGraph with each code generation
+     * engine.
+     *
+     * The TPGGraph is a layered graph of random Programs, with printable
+     * instructions. The code of each engine is generated in
+     * <path>/<engine>/policy.c, and in <path>/<engine>-profiled/policy.c with
+     * a profile of the inputs of bench/codeGen/codeGenBench.c, together with
+     * the externHeader.h and benchConfig.h files needed by codeGenBench.c.
+     * The scripts/compare_codegen_backends.sh script compiles and compares
+     * them.
+     *
+     * \param[in] path the folder where the code is generated.
+     */
+    void generateCodeGenComparison(const std::string& path);
+#endif // CODE_GENERATION
+} // namespace Bench
+
+#endif
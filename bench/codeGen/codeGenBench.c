@@ -0,0 +1,77 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+/*
+ * Timing main of the code generated by gegelati-bench --codegen.
+ *
+ * Usage: codeGenBench [nbInferences]
+ *
+ * Prints the mean duration of an inference and a checksum of the actions,
+ * which must be identical for all code generation engines.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// NB_DATA, and NB_INPUTS the number of input vectors, reused cyclically.
+#include "benchConfig.h"
+#include "policy.h"
+
+double* in1;
+
+int main(int argc, char* argv[])
+{
+    long nbInferences = (argc > 1) ? atol(argv[1]) : 1000000;
+    static double inputs[NB_INPUTS * NB_DATA];
+    uint32_t seed = 1;
+    for (int i = 0; i < NB_INPUTS * NB_DATA; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        inputs[i] = (double)(seed >> 8) / (double)(1 << 24) * 20.0 - 10.0;
+    }
+
+    long checksum = 0;
+    struct timespec start, stop;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long i = 0; i < nbInferences; i++) {
+        in1 = inputs + (i % NB_INPUTS) * NB_DATA;
+        checksum += (i % 7 + 1) * inferenceTPG();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    double ns = (double)(stop.tv_sec - start.tv_sec) * 1e9 +
+                (double)(stop.tv_nsec - start.tv_nsec);
+    printf("%.1f %ld\n", ns / (double)nbInferences, checksum);
+    return 0;
+}
@@ -0,0 +1,185 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifdef CODE_GENERATION
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "codeGen/tpgGenerationEngineFactory.h"
+#include "data/primitiveTypeArray.h"
+#include "environment.h"
+#include "instructions/addPrimitiveType.h"
+#include "instructions/lambdaInstruction.h"
+#include "instructions/multByConstant.h"
+#include "instructions/set.h"
+#include "mutator/lineMutator.h"
+#include "mutator/rng.h"
+#include "program/program.h"
+#include "tpg/instrumented/executionStats.h"
+#include "tpg/tpgExecutionEngine.h"
+#include "tpg/tpgGraph.h"
+
+#include "benchmarks.h"
+
+/// Number of double in the data source of the generated TPGGraph.
+static const size_t NB_DATA = 16;
+
+/// Number of input vectors of bench/codeGen/codeGenBench.c.
+static const size_t NB_INPUTS = 1024;
+
+void Bench::generateCodeGenComparison(const std::string& path)
+{
+    Instructions::AddPrimitiveType<double> add("$0 = $1 + $2;");
+    Instructions::LambdaInstruction<double, double> minus(
+        [](double a, double b) { return a - b; }, "$0 = $1 - $2;");
+    Instructions::LambdaInstruction<double, double> mult(
+        [](double a, double b) { return a * b; }, "$0 = $1 * $2;");
+    Instructions::LambdaInstruction<double> cosine(
+        [](double a) { return std::cos(a); }, "$0 = cos($1);");
+    Instructions::MultByConstant<double> multByConst;
+
+    Instructions::Set set;
+    set.add(add);
+    set.add(minus);
+    set.add(mult);
+    set.add(cosine);
+    set.add(multByConst);
+
+    Data::PrimitiveTypeArray<double> data(NB_DATA);
+    Environment env(set, {data}, 8, 2);
+    TPG::TPGGraph graph(env);
+    Mutator::RNG rng(0);
+
+    auto makeProgram = [&env, &rng]() {
+        auto program = std::make_shared<Program::Program>(env);
+        for (size_t i = 0; i < 12; i++) {
+            Program::Line& line = program->addNewLine();
+            Mutator::LineMutator::initRandomCorrectLine(line, rng);
+        }
+        for (size_t i = 0; i < env.getNbConstant(); i++) {
+            program->getConstantHandler().setDataAt(
+                typeid(Data::Constant), i,
+                {static_cast<int32_t>(rng.getInt32(-10, 10))});
+        }
+        program->identifyIntrons();
+        return program;
+    };
+
+    // Layered graph with a single root: each team is connected to all teams
+    // of the next layer and to one action. Programs are random, so the path
+    // followed by an inference depends on the data.
+    const size_t depth = 6;
+    const size_t width = 8;
+    std::vector<const TPG::TPGAction*> actions;
+    for (size_t i = 0; i < width; i++) {
+        actions.push_back(&graph.addNewAction(i));
+    }
+    std::vector<std::vector<const TPG::TPGTeam*>> layers(depth);
+    for (size_t l = 0; l < depth; l++) {
+        for (size_t i = 0; i < ((l == 0) ? 1 : width); i++) {
+            layers.at(l).push_back(&graph.addNewTeam());
+        }
+    }
+    for (size_t l = 0; l < depth; l++) {
+        for (size_t i = 0; i < layers.at(l).size(); i++) {
+            const TPG::TPGTeam& team = *layers.at(l).at(i);
+            if (l + 1 < depth) {
+                for (const TPG::TPGTeam* dest : layers.at(l + 1)) {
+                    graph.addNewEdge(team, *dest, makeProgram());
+                }
+                graph.addNewEdge(team, *actions.at(i), makeProgram());
+            }
+            else {
+                for (const TPG::TPGAction* dest : actions) {
+                    graph.addNewEdge(team, *dest, makeProgram());
+                }
+            }
+        }
+    }
+
+    // Profile the inferences on the inputs of codeGenBench.c, generated
+    // with the same linear congruential generator.
+    TPG::ExecutionStats profile;
+    TPG::TPGExecutionEngine engine(env);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < NB_INPUTS; i++) {
+        for (size_t j = 0; j < NB_DATA; j++) {
+            seed = seed * 1664525u + 1013904223u;
+            data.setDataAt(typeid(double), j,
+                           (double)(seed >> 8) / (double)(1 << 24) * 20.0 -
+                               10.0);
+        }
+        profile.analyzeInferenceTrace(
+            engine.executeFromRoot(*layers.at(0).at(0)));
+    }
+
+    const std::filesystem::path folder(path);
+    std::filesystem::create_directories(folder);
+    std::ofstream externHeader(folder / "externHeader.h");
+    std::ofstream config(folder / "benchConfig.h");
+    if (!externHeader.is_open() || !config.is_open()) {
+        throw std::runtime_error("Could not create files in " + path);
+    }
+    externHeader << "#ifndef EXTERN_HEADER_H\n#define EXTERN_HEADER_H\n"
+                 << "#include <float.h>\n#include <math.h>\n#endif\n";
+    config << "#define NB_DATA " << NB_DATA << "\n"
+           << "#define NB_INPUTS " << NB_INPUTS << "\n";
+
+    using Mode = CodeGen::TPGGenerationEngineFactory::generationEngineMode;
+    for (auto backend : std::vector<std::pair<std::string, Mode>>{
+             {"switch", Mode::switchMode},
+             {"stack", Mode::stackMode},
+             {"table", Mode::tableMode}}) {
+        // Each engine is generated without and with the profile.
+        for (bool profiled : {false, true}) {
+            std::string name = backend.first + (profiled ? "-profiled" : "");
+            std::filesystem::create_directories(folder / name);
+            CodeGen::TPGGenerationEngineFactory factory(backend.second);
+            auto generator =
+                factory.create("policy", graph, (folder / name).string() + "/");
+            if (profiled) {
+                generator->setProfile(profile);
+            }
+            generator->generateTPGGraph();
+        }
+    }
+}
+
+#endif // CODE_GENERATION
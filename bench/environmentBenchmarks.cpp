@@ -0,0 +1,106 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <stdexcept>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "learn/sharedMemoryLearningEnvironment.h"
+#endif
+
+#include "../test/learn/stickGameWithOpponent.h"
+
+#include "benchmarks.h"
+
+/**
+ * \brief Perform one step of a LearningEnvironment per iteration.
+ *
+ * Actions follow a fixed sequence, and the LearningEnvironment is reset when
+ * a terminal state is reached.
+ */
+static void measureSteps(Bench::State& state, Learn::LearningEnvironment& le)
+{
+    uint64_t step = 0;
+    le.reset(0);
+    while (state.keepRunning()) {
+        if (le.isTerminal()) {
+            le.reset(step);
+        }
+        le.doAction(step % 3);
+        step++;
+    }
+}
+
+void Bench::registerEnvironmentBenchmarks(Runner& runner)
+{
+    // Reference for the overhead of the shared-memory adapter.
+    runner.add("environment/step/inProcess", [](State& state) {
+        StickGameWithOpponent le;
+        measureSteps(state, le);
+    });
+
+#ifndef _WIN32
+    // Same game, served by a simulator in a child process.
+    runner.add("environment/step/sharedMemory", [](State& state) {
+        std::string name = "/gegelati_bench_" + std::to_string(getpid());
+        pid_t pid;
+        {
+            Learn::SharedMemoryLearningEnvironment<int> le(name, 3, 4);
+            pid = fork();
+            if (pid == 0) {
+                int status = 0;
+                try {
+                    StickGameWithOpponent simulator;
+                    Learn::SharedMemoryEnvironmentServer<int> server(
+                        name, simulator);
+                    server.serve();
+                }
+                catch (...) {
+                    status = 1;
+                }
+                _exit(status);
+            }
+            if (pid < 0) {
+                throw std::runtime_error("Could not fork the simulator.");
+            }
+            measureSteps(state, le);
+        }
+        // Destruction of the environment stops the simulator.
+        waitpid(pid, nullptr, 0);
+    });
+#endif
+}
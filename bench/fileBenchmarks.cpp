@@ -0,0 +1,108 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "archive.h"
+#include "file/tpgGraphDotExporter.h"
+#include "file/tpgGraphDotImporter.h"
+#include "mutator/tpgMutator.h"
+#include "tpg/tpgGraph.h"
+
+#include "benchmarks.h"
+
+/**
+ * \brief Initialize and populate a TPGGraph with the parameters of the
+ * Fixture.
+ *
+ * \param[in] fixture the Fixture of the TPGGraph.
+ * \param[out] graph the TPGGraph to fill.
+ */
+static void makeRandomTPG(const Bench::Fixture& fixture, TPG::TPGGraph& graph)
+{
+    Mutator::RNG rng(0);
+    Archive archive(0);
+    Mutator::TPGMutator::initRandomTPG(graph, fixture.params, rng,
+                                       Bench::Fixture::NB_ACTIONS);
+    Mutator::TPGMutator::populateTPG(graph, archive, fixture.params, rng,
+                                     Bench::Fixture::NB_ACTIONS, 1);
+}
+
+/// Get the path of a temporary file for the given file name.
+static std::string getTempPath(const std::string& fileName)
+{
+    return (std::filesystem::temp_directory_path() / fileName).string();
+}
+
+void Bench::registerFileBenchmarks(Runner& runner)
+{
+    runner.add("file/dotExport", [](State& state) {
+        Fixture fixture;
+        TPG::TPGGraph graph(*fixture.env);
+        makeRandomTPG(fixture, graph);
+        const std::string path = getTempPath("gegelati-bench-export.dot");
+
+        state.setItemsPerIteration(graph.getNbVertices());
+        while (state.keepRunning()) {
+            File::TPGGraphDotExporter exporter(path.c_str(), graph);
+            exporter.print();
+        }
+        std::remove(path.c_str());
+    });
+
+    runner.add("file/dotImport", [](State& state) {
+        Fixture fixture;
+        const std::string path = getTempPath("gegelati-bench-import.dot");
+        std::unique_ptr<TPG::TPGGraph> graph =
+            std::make_unique<TPG::TPGGraph>(*fixture.env);
+        makeRandomTPG(fixture, *graph);
+        {
+            File::TPGGraphDotExporter exporter(path.c_str(), *graph);
+            exporter.print();
+        }
+
+        state.setItemsPerIteration(graph->getNbVertices());
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            graph = std::make_unique<TPG::TPGGraph>(*fixture.env);
+            state.resumeTiming();
+
+            File::TPGGraphDotImporter importer(path.c_str(), *fixture.env,
+                                               *graph);
+        }
+        std::remove(path.c_str());
+    });
+}
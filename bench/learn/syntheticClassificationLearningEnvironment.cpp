@@ -0,0 +1,123 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include "mutator/rng.h"
+
+#include "syntheticClassificationLearningEnvironment.h"
+
+Bench::SyntheticClassificationLearningEnvironment::
+    SyntheticClassificationLearningEnvironment(uint64_t nbClasses,
+                                               size_t nbFeatures,
+                                               size_t nbSamples, size_t seed)
+    : ClassificationLearningEnvironment(nbClasses), nbFeatures{nbFeatures},
+      currentSample(nbFeatures), firstSample{0}, nbClassifiedSamples{0}
+{
+    Mutator::RNG rng(seed);
+
+    std::vector<double> centroids(nbClasses * nbFeatures);
+    for (double& value : centroids) {
+        value = rng.getDouble(-1.0, 1.0);
+    }
+
+    auto samples = std::make_shared<std::vector<double>>();
+    auto classes = std::make_shared<std::vector<uint64_t>>();
+    for (size_t i = 0; i < nbSamples; i++) {
+        uint64_t label = i % nbClasses;
+        classes->push_back(label);
+        for (size_t f = 0; f < nbFeatures; f++) {
+            samples->push_back(centroids.at(label * nbFeatures + f) +
+                               rng.getDouble(-0.5, 0.5));
+        }
+    }
+    this->features = samples;
+    this->labels = classes;
+
+    this->loadSample();
+}
+
+bool Bench::SyntheticClassificationLearningEnvironment::isCopyable() const
+{
+    return true;
+}
+
+Learn::LearningEnvironment* Bench::SyntheticClassificationLearningEnvironment::
+    clone() const
+{
+    // Samples are shared by the copy.
+    return new SyntheticClassificationLearningEnvironment(*this);
+}
+
+void Bench::SyntheticClassificationLearningEnvironment::loadSample()
+{
+    size_t index =
+        (this->firstSample + this->nbClassifiedSamples) % this->labels->size();
+    for (size_t f = 0; f < this->nbFeatures; f++) {
+        this->currentSample.setDataAt(
+            typeid(double), f,
+            this->features->at(index * this->nbFeatures + f));
+    }
+    this->currentClass = this->labels->at(index);
+}
+
+void Bench::SyntheticClassificationLearningEnvironment::doAction(
+    uint64_t actionID)
+{
+    ClassificationLearningEnvironment::doAction(actionID);
+
+    this->nbClassifiedSamples++;
+    if (!this->isTerminal()) {
+        this->loadSample();
+    }
+}
+
+void Bench::SyntheticClassificationLearningEnvironment::reset(
+    size_t seed, Learn::LearningMode mode, uint16_t iterationNumber,
+    uint64_t generationNumber)
+{
+    ClassificationLearningEnvironment::reset(seed, mode);
+
+    this->firstSample = seed % this->labels->size();
+    this->nbClassifiedSamples = 0;
+    this->loadSample();
+}
+
+std::vector<std::reference_wrapper<const Data::DataHandler>> Bench::
+    SyntheticClassificationLearningEnvironment::getDataSources()
+{
+    return {this->currentSample};
+}
+
+bool Bench::SyntheticClassificationLearningEnvironment::isTerminal() const
+{
+    return this->nbClassifiedSamples >= this->labels->size();
+}
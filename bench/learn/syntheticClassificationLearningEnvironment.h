@@ -0,0 +1,117 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef SYNTHETIC_CLASSIFICATION_LEARNING_ENVIRONMENT_H
+#define SYNTHETIC_CLASSIFICATION_LEARNING_ENVIRONMENT_H
+
+#include <memory>
+#include <vector>
+
+#include "data/primitiveTypeArray.h"
+#include "learn/classificationLearningEnvironment.h"
+
+namespace Bench {
+
+    /**
+     * \brief Classification of samples drawn around one random centroid per
+     * class.
+     *
+     * Samples are generated once, with a fixed seed, and shared by all clones
+     * of the LearningEnvironment. Each episode presents all samples, starting
+     * from an offset depending on the reset seed.
+     */
+    class SyntheticClassificationLearningEnvironment
+        : public Learn::ClassificationLearningEnvironment
+    {
+      protected:
+        /// Number of features of each sample.
+        const size_t nbFeatures;
+
+        /// Features of all samples, sample after sample.
+        std::shared_ptr<const std::vector<double>> features;
+
+        /// Class of each sample.
+        std::shared_ptr<const std::vector<uint64_t>> labels;
+
+        /// Features of the current sample.
+        Data::PrimitiveTypeArray<double> currentSample;
+
+        /// Index of the first sample of the episode.
+        size_t firstSample;
+
+        /// Number of samples classified during the episode.
+        size_t nbClassifiedSamples;
+
+        /// Load the sample following the classified ones in currentSample.
+        void loadSample();
+
+      public:
+        /**
+         * \brief Constructor.
+         *
+         * \param[in] nbClasses the number of classes.
+         * \param[in] nbFeatures the number of features of each sample.
+         * \param[in] nbSamples the number of samples.
+         * \param[in] seed the seed used to generate the samples.
+         */
+        SyntheticClassificationLearningEnvironment(uint64_t nbClasses = 4,
+                                                   size_t nbFeatures = 16,
+                                                   size_t nbSamples = 200,
+                                                   size_t seed = 0);
+
+        /// Inherited via LearningEnvironment
+        virtual bool isCopyable() const override;
+
+        /// Inherited via LearningEnvironment
+        virtual Learn::LearningEnvironment* clone() const override;
+
+        /// Inherited via ClassificationLearningEnvironment
+        virtual void doAction(uint64_t actionID) override;
+
+        /// Inherited via ClassificationLearningEnvironment
+        virtual void reset(
+            size_t seed = 0,
+            Learn::LearningMode mode = Learn::LearningMode::TRAINING,
+            uint16_t iterationNumber = 0,
+            uint64_t generationNumber = 0) override;
+
+        /// Inherited via LearningEnvironment
+        virtual std::vector<std::reference_wrapper<const Data::DataHandler>>
+        getDataSources() override;
+
+        /// The episode ends when all samples were classified.
+        virtual bool isTerminal() const override;
+    };
+} // namespace Bench
+
+#endif
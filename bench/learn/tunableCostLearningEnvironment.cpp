@@ -0,0 +1,121 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <algorithm>
+
+#include "tunableCostLearningEnvironment.h"
+
+Bench::TunableCostLearningEnvironment::TunableCostLearningEnvironment(
+    uint64_t nbActions, size_t observationSize, uint64_t episodeLength,
+    uint64_t workPerAction)
+    : LearningEnvironment(nbActions), workPerAction{workPerAction},
+      episodeLength{episodeLength},
+      observation(std::max(observationSize, (size_t)nbActions)), state{0},
+      rewardedAction{0}, nbSteps{0}, nbRewards{0}
+{
+    this->reset(0);
+}
+
+bool Bench::TunableCostLearningEnvironment::isCopyable() const
+{
+    return true;
+}
+
+Learn::LearningEnvironment* Bench::TunableCostLearningEnvironment::clone()
+    const
+{
+    return new TunableCostLearningEnvironment(*this);
+}
+
+void Bench::TunableCostLearningEnvironment::advance(uint64_t nbStepsOfWork)
+{
+    // Linear congruential generator from Knuth's MMIX.
+    for (uint64_t i = 0; i < nbStepsOfWork; i++) {
+        this->state = this->state * 6364136223846793005ULL +
+                      1442695040888963407ULL;
+    }
+
+    double bestValue = -1.0;
+    uint64_t value = this->state;
+    const size_t size = this->observation.getAddressSpace(typeid(double));
+    for (size_t i = 0; i < size; i++) {
+        value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+        double observed = (double)(value >> 40) / (double)(1ULL << 24);
+        this->observation.setDataAt(typeid(double), i, observed);
+        if (i < this->nbActions && observed > bestValue) {
+            bestValue = observed;
+            this->rewardedAction = i;
+        }
+    }
+}
+
+void Bench::TunableCostLearningEnvironment::doAction(uint64_t actionID)
+{
+    LearningEnvironment::doAction(actionID);
+
+    if (actionID == this->rewardedAction) {
+        this->nbRewards++;
+    }
+    this->nbSteps++;
+    this->state ^= actionID;
+    this->advance(1 + this->workPerAction);
+}
+
+void Bench::TunableCostLearningEnvironment::reset(size_t seed,
+                                                  Learn::LearningMode mode,
+                                                  uint16_t iterationNumber,
+                                                  uint64_t generationNumber)
+{
+    this->state = seed;
+    this->nbSteps = 0;
+    this->nbRewards = 0;
+    this->advance(1);
+}
+
+std::vector<std::reference_wrapper<const Data::DataHandler>> Bench::
+    TunableCostLearningEnvironment::getDataSources()
+{
+    return {this->observation};
+}
+
+double Bench::TunableCostLearningEnvironment::getScore() const
+{
+    return (this->nbSteps > 0)
+               ? (double)this->nbRewards / (double)this->nbSteps
+               : 0.0;
+}
+
+bool Bench::TunableCostLearningEnvironment::isTerminal() const
+{
+    return this->nbSteps >= this->episodeLength;
+}
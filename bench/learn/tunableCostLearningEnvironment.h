@@ -0,0 +1,125 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef TUNABLE_COST_LEARNING_ENVIRONMENT_H
+#define TUNABLE_COST_LEARNING_ENVIRONMENT_H
+
+#include <cstdint>
+
+#include "data/primitiveTypeArray.h"
+#include "learn/learningEnvironment.h"
+
+namespace Bench {
+
+    /**
+     * \brief LearningEnvironment whose observation size, episode length and
+     * simulation cost per action are parameters.
+     *
+     * The state of the environment is a pseudo-random generator, advanced by
+     * a given number of steps after each action to emulate the cost of a
+     * simulation. The observation is derived from this state, and the
+     * rewarded action is the index of the largest of the first observed
+     * values.
+     */
+    class TunableCostLearningEnvironment : public Learn::LearningEnvironment
+    {
+      protected:
+        /// Number of generator steps after each action.
+        const uint64_t workPerAction;
+
+        /// Number of actions of an episode.
+        const uint64_t episodeLength;
+
+        /// Observation of the state.
+        Data::PrimitiveTypeArray<double> observation;
+
+        /// State of the pseudo-random generator.
+        uint64_t state;
+
+        /// Action rewarded in the current state.
+        uint64_t rewardedAction;
+
+        /// Number of actions done during the episode.
+        uint64_t nbSteps;
+
+        /// Number of rewarded actions during the episode.
+        uint64_t nbRewards;
+
+        /// Advance the state by the given number of steps, and update the
+        /// observation.
+        void advance(uint64_t nbStepsOfWork);
+
+      public:
+        /**
+         * \brief Constructor.
+         *
+         * \param[in] nbActions the number of actions.
+         * \param[in] observationSize the number of observed double values.
+         * \param[in] episodeLength the number of actions of an episode.
+         * \param[in] workPerAction the number of generator steps emulating the
+         * simulation of each action.
+         */
+        TunableCostLearningEnvironment(uint64_t nbActions = 4,
+                                       size_t observationSize = 32,
+                                       uint64_t episodeLength = 100,
+                                       uint64_t workPerAction = 0);
+
+        /// Inherited via LearningEnvironment
+        virtual bool isCopyable() const override;
+
+        /// Inherited via LearningEnvironment
+        virtual Learn::LearningEnvironment* clone() const override;
+
+        /// Inherited via LearningEnvironment
+        virtual void doAction(uint64_t actionID) override;
+
+        /// Inherited via LearningEnvironment
+        virtual void reset(
+            size_t seed = 0,
+            Learn::LearningMode mode = Learn::LearningMode::TRAINING,
+            uint16_t iterationNumber = 0,
+            uint64_t generationNumber = 0) override;
+
+        /// Inherited via LearningEnvironment
+        virtual std::vector<std::reference_wrapper<const Data::DataHandler>>
+        getDataSources() override;
+
+        /// Returns the ratio of rewarded actions during the episode.
+        virtual double getScore() const override;
+
+        /// The episode ends after episodeLength actions.
+        virtual bool isTerminal() const override;
+    };
+} // namespace Bench
+
+#endif
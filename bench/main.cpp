@@ -0,0 +1,166 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "benchmarks.h"
+
+/// Print the usage of the gegelati-bench executable.
+static void printUsage(const char* executable)
+{
+    std::cout
+        << "Usage: " << executable << " [options]\n"
+        << "  --filter <str>       Only run benchmarks whose name contains "
+           "<str>.\n"
+        << "  --json <file>        Write the results in <file> "
+           "(default: gegelati-bench.json).\n"
+        << "  --repetitions <n>    Number of measured repetitions "
+           "(default: 5).\n"
+        << "  --min-time <s>       Minimum duration of a repetition in "
+           "seconds (default: 0.1).\n"
+        << "  --max-threads <n>    Largest number of threads of training "
+           "benchmarks\n"
+        << "                       (default: hardware concurrency).\n"
+#ifdef CODE_GENERATION
+        << "  --codegen <dir>      Generate the C code of a TPG with each code "
+           "generation\n"
+        << "                       engine in <dir> and exit.\n"
+#endif // CODE_GENERATION
+        << "  --list               List the benchmarks and exit.\n"
+        << "  --help               Print this message and exit."
+        << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    Bench::Runner runner;
+    std::string jsonPath = "gegelati-bench.json";
+    size_t maxNbThreads = std::max(1u, std::thread::hardware_concurrency());
+    bool list = false;
+    std::string codeGenPath;
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--list") {
+                list = true;
+                continue;
+            }
+            if (arg == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            }
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            std::string value = argv[++i];
+            if (arg == "--filter") {
+                runner.setFilter(value);
+            }
+            else if (arg == "--json") {
+                jsonPath = value;
+            }
+            else if (arg == "--repetitions") {
+                runner.setNbRepetitions(std::stoul(value));
+            }
+            else if (arg == "--min-time") {
+                runner.setMinTime(std::stod(value));
+            }
+            else if (arg == "--max-threads") {
+                maxNbThreads = std::stoul(value);
+                if (maxNbThreads == 0) {
+                    throw std::invalid_argument(
+                        "At least one thread is needed.");
+                }
+            }
+#ifdef CODE_GENERATION
+            else if (arg == "--codegen") {
+                codeGenPath = value;
+            }
+#endif // CODE_GENERATION
+            else {
+                throw std::invalid_argument("Unknown option " + arg);
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+#ifdef CODE_GENERATION
+    if (!codeGenPath.empty()) {
+        try {
+            Bench::generateCodeGenComparison(codeGenPath);
+        }
+        catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Code generated in " << codeGenPath << std::endl;
+        return 0;
+    }
+#endif // CODE_GENERATION
+
+    Bench::registerProgramBenchmarks(runner);
+    Bench::registerTPGBenchmarks(runner);
+    Bench::registerArchiveBenchmarks(runner);
+    Bench::registerMutatorBenchmarks(runner);
+    Bench::registerFileBenchmarks(runner);
+    Bench::registerEnvironmentBenchmarks(runner);
+    Bench::registerTrainingBenchmarks(runner, maxNbThreads);
+
+    if (list) {
+        for (const std::string& name : runner.getNames()) {
+            std::cout << name << std::endl;
+        }
+        return 0;
+    }
+
+    auto results = runner.run(std::cout);
+
+    std::ofstream out(jsonPath);
+    if (!out.is_open()) {
+        std::cerr << "Could not open file " << jsonPath << std::endl;
+        return 1;
+    }
+    runner.writeJson(results, out);
+    std::cout << "Results written in " << jsonPath << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "archive.h"
+#include "mutator/tpgMutator.h"
+#include "program/programExecutionEngine.h"
+#include "tpg/tpgGraph.h"
+
+#include "benchmarks.h"
+
+void Bench::registerMutatorBenchmarks(Runner& runner)
+{
+    // Populate a freshly initialized TPGGraph up to its number of roots.
+    runner.add("mutator/populateTPG", [](State& state) {
+        Fixture fixture;
+        Mutator::RNG rng(0);
+        std::vector<std::reference_wrapper<const Data::DataHandler>> dHandlers{
+            fixture.data};
+
+        // Fill the archive with the behavior of random programs, as a
+        // learning agent would, so that the uniqueness of mutated programs
+        // is checked against actual recordings.
+        Archive archive(1000, 1.0, 0);
+        std::vector<std::shared_ptr<Program::Program>> programs;
+        for (size_t i = 0; i < 100; i++) {
+            programs.push_back(fixture.makeRandomProgram(8, rng));
+        }
+        for (size_t d = 0; d < 10; d++) {
+            fixture.data.setDataAt(typeid(double), 0, (double)d);
+            for (const auto& program : programs) {
+                Program::ProgramExecutionEngine engine(*program);
+                archive.addRecording(program.get(), dHandlers,
+                                     engine.executeProgram(), true);
+            }
+        }
+
+        std::unique_ptr<TPG::TPGGraph> graph;
+        state.setItemsPerIteration(fixture.params.tpg.nbRoots -
+                                   fixture.params.tpg.initNbRoots);
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            graph = std::make_unique<TPG::TPGGraph>(*fixture.env);
+            Mutator::RNG mutationRng(1);
+            Mutator::TPGMutator::initRandomTPG(*graph, fixture.params,
+                                               mutationRng,
+                                               Fixture::NB_ACTIONS);
+            state.resumeTiming();
+
+            Mutator::TPGMutator::populateTPG(*graph, archive, fixture.params,
+                                             mutationRng, Fixture::NB_ACTIONS,
+                                             1);
+        }
+    });
+}
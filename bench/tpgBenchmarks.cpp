@@ -0,0 +1,165 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tpg/tpgAction.h"
+#include "tpg/tpgEdge.h"
+#include "tpg/tpgExecutionEngine.h"
+#include "tpg/tpgGraph.h"
+#include "tpg/tpgTeam.h"
+
+#include "benchmarks.h"
+
+/**
+ * \brief Create a Program whose result is the double of a data.
+ *
+ * The Program starts with random lines whose destination is never register
+ * 0, so that the final line alone decides the bid of the Program.
+ *
+ * \param[in] fixture the Fixture of the Program.
+ * \param[in] rng the Random Number Generator used for the random lines.
+ * \param[in] address the location of the data doubled by the Program.
+ */
+static std::shared_ptr<Program::Program> makeBidProgram(
+    const Bench::Fixture& fixture, Mutator::RNG& rng, uint64_t address)
+{
+    auto program = fixture.makeRandomProgram(7, rng);
+    const size_t nbRegisters = fixture.env->getNbRegisters();
+    for (size_t i = 0; i < program->getNbLines(); i++) {
+        program->getLine(i).setDestinationIndex(1 + i % (nbRegisters - 1));
+    }
+
+    Program::Line& line = program->addNewLine();
+    line.setInstructionIndex(0); // AddPrimitiveType
+    line.setOperand(0, Bench::Fixture::DATA_INDEX, address);
+    line.setOperand(1, Bench::Fixture::DATA_INDEX, address);
+    line.setDestinationIndex(0);
+    return program;
+}
+
+void Bench::registerTPGBenchmarks(Runner& runner)
+{
+    // Layered graphs: each team of a layer is connected to all teams of the
+    // next layer and to one action. Edges leading to teams bid higher than
+    // edges leading to actions, so each execution goes through all layers.
+    for (auto depthWidth : std::vector<std::pair<size_t, size_t>>{
+             {2, 4}, {8, 4}, {8, 16}, {32, 4}}) {
+        const size_t depth = depthWidth.first;
+        const size_t width = depthWidth.second;
+        std::string name = "tpg/executeFromRoot/d" + std::to_string(depth) +
+                           "w" + std::to_string(width);
+        runner.add(name, [depth, width](State& state) {
+            Fixture fixture;
+            Mutator::RNG rng(0);
+            TPG::TPGGraph graph(*fixture.env);
+
+            std::vector<const TPG::TPGAction*> actions;
+            for (size_t i = 0; i < width; i++) {
+                actions.push_back(&graph.addNewAction(i));
+            }
+            std::vector<std::vector<const TPG::TPGTeam*>> layers(depth);
+            for (auto& layer : layers) {
+                for (size_t i = 0; i < width; i++) {
+                    layer.push_back(&graph.addNewTeam());
+                }
+            }
+
+            // data[10] is 2.0 and data[0] is -3.0
+            for (size_t l = 0; l < depth; l++) {
+                for (size_t i = 0; i < width; i++) {
+                    const TPG::TPGTeam& team = *layers.at(l).at(i);
+                    if (l + 1 < depth) {
+                        for (const TPG::TPGTeam* dest : layers.at(l + 1)) {
+                            graph.addNewEdge(team, *dest,
+                                             makeBidProgram(fixture, rng, 10));
+                        }
+                        graph.addNewEdge(team, *actions.at(i),
+                                         makeBidProgram(fixture, rng, 0));
+                    }
+                    else {
+                        for (const TPG::TPGAction* dest : actions) {
+                            graph.addNewEdge(team, *dest,
+                                             makeBidProgram(fixture, rng, 0));
+                        }
+                    }
+                }
+            }
+
+            TPG::TPGExecutionEngine engine(*fixture.env);
+            const TPG::TPGVertex& root = *layers.at(0).at(0);
+
+            // One team per layer is evaluated.
+            state.setItemsPerIteration((depth - 1) * (width + 1) + width);
+            while (state.keepRunning()) {
+                doNotOptimize(engine.executeFromRoot(root).back());
+            }
+        });
+    }
+
+    // Add and remove many teams, each with a few outgoing edges.
+    const size_t nbTeams = 1000;
+    auto addRemove = [nbTeams](State& state) {
+        Fixture fixture;
+        Mutator::RNG rng(0);
+        TPG::TPGGraph graph(*fixture.env);
+        auto program = fixture.makeRandomProgram(8, rng);
+
+        const size_t nbActions = 4;
+        std::vector<const TPG::TPGAction*> actions;
+        for (size_t i = 0; i < nbActions; i++) {
+            actions.push_back(&graph.addNewAction(i));
+        }
+
+        std::vector<const TPG::TPGTeam*> teams(nbTeams);
+        state.setItemsPerIteration(nbTeams);
+        while (state.keepRunning()) {
+            for (size_t i = 0; i < nbTeams; i++) {
+                teams[i] = &graph.addNewTeam();
+                for (size_t j = 0; j < 3; j++) {
+                    graph.addNewEdge(*teams[i], *actions[(i + j) % nbActions],
+                                     program);
+                }
+                if (i > 0) {
+                    graph.addNewEdge(*teams[i], *teams[i - 1], program);
+                }
+            }
+            for (size_t i = 0; i < nbTeams; i++) {
+                graph.removeVertex(*teams[i]);
+            }
+        }
+    };
+    runner.add("tpg/addRemove/" + std::to_string(nbTeams), addRemove);
+}
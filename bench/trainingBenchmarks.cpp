@@ -0,0 +1,231 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "instructions/addPrimitiveType.h"
+#include "instructions/lambdaInstruction.h"
+#include "instructions/set.h"
+#include "learn/adversarialLearningAgent.h"
+#include "learn/classificationLearningAgent.h"
+#include "learn/learningAgent.h"
+#include "learn/learningParameters.h"
+#include "learn/parallelLearningAgent.h"
+
+#include "../test/learn/stickGameAdversarial.h"
+#include "../test/learn/stickGameWithOpponent.h"
+
+#include "benchmarks.h"
+#include "learn/syntheticClassificationLearningEnvironment.h"
+#include "learn/tunableCostLearningEnvironment.h"
+#include "trainingCounters.h"
+
+/// Number of trained generations in each repetition of a training benchmark.
+static const uint64_t NB_GENERATIONS = 10;
+
+/// Get the Instructions::Set of training benchmarks on int observations.
+static const Instructions::Set& getIntInstructionSet()
+{
+    static const Instructions::AddPrimitiveType<int> addInt;
+    static const Instructions::AddPrimitiveType<double> addDouble;
+    static const Instructions::Set set = [] {
+        Instructions::Set s;
+        s.add(addInt);
+        s.add(addDouble);
+        return s;
+    }();
+    return set;
+}
+
+/// Get the Instructions::Set of training benchmarks on double observations.
+static const Instructions::Set& getDoubleInstructionSet()
+{
+    static const Instructions::AddPrimitiveType<double> add;
+    static const Instructions::LambdaInstruction<double, double> minus(
+        [](double a, double b) { return a - b; });
+    static const Instructions::LambdaInstruction<double, double> mult(
+        [](double a, double b) { return a * b; });
+    static const Instructions::Set set = [] {
+        Instructions::Set s;
+        s.add(add);
+        s.add(minus);
+        s.add(mult);
+        return s;
+    }();
+    return set;
+}
+
+/**
+ * \brief Get the LearningParameters of training benchmarks.
+ *
+ * Parameters are small enough for a generation to last a fraction of a
+ * second on all synthetic environments.
+ *
+ * \param[in] nbThreads the number of threads of the training.
+ */
+static Learn::LearningParameters getTrainingParameters(size_t nbThreads)
+{
+    Learn::LearningParameters params;
+    params.mutation.tpg.nbRoots = 50;
+    params.mutation.tpg.maxInitOutgoingEdges = 3;
+    params.mutation.tpg.maxOutgoingEdges = 4;
+    params.mutation.prog.maxProgramSize = 20;
+    params.mutation.prog.minConstValue = -10;
+    params.mutation.prog.maxConstValue = 10;
+    params.nbIterationsPerPolicyEvaluation = 3;
+    params.maxNbActionsPerEval = 50;
+    params.nbThreads = nbThreads;
+    return params;
+}
+
+/**
+ * \brief Create the function of a training benchmark.
+ *
+ * Each iteration of the benchmark trains one generation. The number of
+ * actions and of Program executions are counted with the TrainingCounters.
+ *
+ * \tparam Agent the class of the LearningAgent.
+ * \tparam Env the class of the LearningEnvironment.
+ * \param[in] set the Instructions::Set of the training.
+ * \param[in] params the LearningParameters of the training.
+ * \param[in] envArgs the arguments of the Env constructor.
+ */
+template <class Agent, class Env, class... EnvArgs>
+static Bench::Runner::Function makeTrainingBenchmark(
+    const Instructions::Set& set, const Learn::LearningParameters& params,
+    EnvArgs... envArgs)
+{
+    return [&set, params, envArgs...](Bench::State& state) {
+        auto counters = std::make_shared<Bench::TrainingCounters>();
+        {
+            Bench::ActionCountingLearningEnvironment<Env> le(counters,
+                                                             envArgs...);
+            Bench::CountingTPGFactory factory(counters);
+            std::unique_ptr<Agent> agent;
+            // Adversarial agents take the number of agents per evaluation.
+            if constexpr (std::is_base_of<Learn::AdversarialLearningAgent,
+                                          Agent>::value) {
+                agent = std::make_unique<Agent>(le, set, params, 2, factory);
+            }
+            else {
+                agent = std::make_unique<Agent>(le, set, params, factory);
+            }
+            agent->init(0);
+
+            uint64_t generation = 0;
+            while (state.keepRunning()) {
+                agent->trainOneGeneration(generation++);
+            }
+        }
+        // Counters are complete once the agent and environments are
+        // destroyed.
+        state.addCounter("generations", (double)state.getNbIterations());
+        state.addCounter("actions", (double)counters->nbActions);
+        state.addCounter("programExecutions",
+                         (double)counters->nbProgramExecutions);
+    };
+}
+
+/// Get the numbers of threads of scaling benchmarks: powers of 2 up to, and
+/// including, the maximum.
+static std::vector<size_t> getNbThreadsSweep(size_t maxNbThreads)
+{
+    std::vector<size_t> nbThreads;
+    for (size_t n = 1; n < maxNbThreads; n *= 2) {
+        nbThreads.push_back(n);
+    }
+    nbThreads.push_back(maxNbThreads);
+    return nbThreads;
+}
+
+void Bench::registerTrainingBenchmarks(Runner& runner, size_t maxNbThreads)
+{
+    const Instructions::Set& intSet = getIntInstructionSet();
+    const Instructions::Set& doubleSet = getDoubleInstructionSet();
+
+    runner.add(
+        "train/stickGame/sequential",
+        makeTrainingBenchmark<Learn::LearningAgent, StickGameWithOpponent>(
+            intSet, getTrainingParameters(1)),
+        NB_GENERATIONS);
+
+    for (size_t n : getNbThreadsSweep(maxNbThreads)) {
+        const std::string threads = "/t" + std::to_string(n);
+        Learn::LearningParameters params = getTrainingParameters(n);
+
+        // Strong scaling: the same training with more threads.
+        runner.add("train/stickGame/parallel/strong" + threads,
+                   makeTrainingBenchmark<Learn::ParallelLearningAgent,
+                                         StickGameWithOpponent>(intSet, params),
+                   NB_GENERATIONS);
+        runner.add(
+            "train/classification/strong" + threads,
+            makeTrainingBenchmark<Learn::ClassificationLearningAgent<>,
+                                  SyntheticClassificationLearningEnvironment>(
+                doubleSet, params),
+            NB_GENERATIONS);
+        runner.add("train/adversarial/strong" + threads,
+                   makeTrainingBenchmark<Learn::AdversarialLearningAgent,
+                                         StickGameAdversarial>(intSet, params),
+                   NB_GENERATIONS);
+        runner.add("train/tunableCost/cheap/strong" + threads,
+                   makeTrainingBenchmark<Learn::ParallelLearningAgent,
+                                         TunableCostLearningEnvironment>(
+                       doubleSet, params, 4, 32, 50, 0),
+                   NB_GENERATIONS);
+        runner.add("train/tunableCost/costly/strong" + threads,
+                   makeTrainingBenchmark<Learn::ParallelLearningAgent,
+                                         TunableCostLearningEnvironment>(
+                       doubleSet, params, 4, 32, 50, 2000),
+                   NB_GENERATIONS);
+
+        // Weak scaling: the evaluation workload grows with the number of
+        // threads.
+        Learn::LearningParameters weakParams = params;
+        weakParams.nbIterationsPerPolicyEvaluation *= n;
+        runner.add(
+            "train/stickGame/parallel/weak" + threads,
+            makeTrainingBenchmark<Learn::ParallelLearningAgent,
+                                  StickGameWithOpponent>(intSet, weakParams),
+            NB_GENERATIONS);
+        runner.add("train/tunableCost/costly/weak" + threads,
+                   makeTrainingBenchmark<Learn::ParallelLearningAgent,
+                                         TunableCostLearningEnvironment>(
+                       doubleSet, weakParams, 4, 32, 50, 2000),
+                   NB_GENERATIONS);
+    }
+}
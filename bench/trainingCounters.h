@@ -0,0 +1,201 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef TRAINING_COUNTERS_H
+#define TRAINING_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "learn/learningEnvironment.h"
+#include "tpg/tpgExecutionEngine.h"
+#include "tpg/tpgFactory.h"
+#include "tpg/tpgGraph.h"
+
+namespace Bench {
+
+    /**
+     * \brief Counters of events of a training, shared by all clones of its
+     * LearningEnvironment and by all its TPGExecutionEngine.
+     *
+     * To keep the counting overhead low in parallel trainings, events are
+     * counted locally by each object, and added to the shared counters when
+     * the object is destroyed.
+     */
+    struct TrainingCounters
+    {
+        /// Number of actions done in the LearningEnvironment.
+        std::atomic<uint64_t> nbActions{0};
+
+        /// Number of Program executions, one for each evaluated TPGEdge.
+        std::atomic<uint64_t> nbProgramExecutions{0};
+    };
+
+    /**
+     * \brief LearningEnvironment counting the actions done in a wrapped
+     * LearningEnvironment class.
+     *
+     * \tparam Env the class of the wrapped LearningEnvironment.
+     */
+    template <class Env> class ActionCountingLearningEnvironment : public Env
+    {
+      protected:
+        /// Shared counters of the training.
+        std::shared_ptr<TrainingCounters> counters;
+
+        /// Actions done by this instance, not yet added to the counters.
+        uint64_t nbActions = 0;
+
+      public:
+        /**
+         * \brief Constructor.
+         *
+         * \param[in] counters the shared counters of the training.
+         * \param[in] args the arguments of the Env constructor.
+         */
+        template <class... Args>
+        ActionCountingLearningEnvironment(
+            std::shared_ptr<TrainingCounters> counters, Args&&... args)
+            : Env(std::forward<Args>(args)...), counters{counters}
+        {
+        }
+
+        /// Copy constructor, used by clone(). Actions are not copied.
+        ActionCountingLearningEnvironment(
+            const ActionCountingLearningEnvironment& other)
+            : Env(other), counters{other.counters}
+        {
+        }
+
+        /// Destructor adding the counted actions to the shared counters.
+        virtual ~ActionCountingLearningEnvironment()
+        {
+            this->counters->nbActions += this->nbActions;
+        }
+
+        /// Inherited via LearningEnvironment
+        virtual Learn::LearningEnvironment* clone() const override
+        {
+            return new ActionCountingLearningEnvironment<Env>(*this);
+        }
+
+        /// Count the action, then do it in the wrapped LearningEnvironment.
+        virtual void doAction(uint64_t actionID) override
+        {
+            this->nbActions++;
+            Env::doAction(actionID);
+        }
+    };
+
+    /**
+     * \brief TPGExecutionEngine counting the evaluated TPGEdge.
+     */
+    class CountingTPGExecutionEngine : public TPG::TPGExecutionEngine
+    {
+      protected:
+        /// Shared counters of the training.
+        std::shared_ptr<TrainingCounters> counters;
+
+        /// Edges evaluated by this engine, not yet added to the counters.
+        uint64_t nbEvaluatedEdges = 0;
+
+      public:
+        /**
+         * \brief Constructor.
+         *
+         * \param[in] env the Environment of the TPGGraph.
+         * \param[in] arch the Archive where recordings are made, if any.
+         * \param[in] counters the shared counters of the training.
+         */
+        CountingTPGExecutionEngine(const Environment& env, Archive* arch,
+                                   std::shared_ptr<TrainingCounters> counters)
+            : TPGExecutionEngine(env, arch), counters{counters}
+        {
+        }
+
+        /// Destructor adding the counted edges to the shared counters.
+        virtual ~CountingTPGExecutionEngine()
+        {
+            this->counters->nbProgramExecutions += this->nbEvaluatedEdges;
+        }
+
+        /// Count the edge, then evaluate it.
+        virtual double evaluateEdge(const TPG::TPGEdge& edge) override
+        {
+            this->nbEvaluatedEdges++;
+            return TPGExecutionEngine::evaluateEdge(edge);
+        }
+    };
+
+    /**
+     * \brief TPGFactory creating CountingTPGExecutionEngine.
+     */
+    class CountingTPGFactory : public TPG::TPGFactory
+    {
+      protected:
+        /// Shared counters of the training.
+        std::shared_ptr<TrainingCounters> counters;
+
+      public:
+        /**
+         * \brief Constructor.
+         *
+         * \param[in] counters the shared counters of the training.
+         */
+        CountingTPGFactory(std::shared_ptr<TrainingCounters> counters)
+            : counters{counters}
+        {
+        }
+
+        /// Inherited via TPGFactory
+        virtual std::shared_ptr<TPG::TPGGraph> createTPGGraph(
+            const Environment& env) const override
+        {
+            return std::make_shared<TPG::TPGGraph>(
+                env, std::make_unique<CountingTPGFactory>(*this));
+        }
+
+        /// Inherited via TPGFactory
+        virtual std::unique_ptr<TPG::TPGExecutionEngine>
+        createTPGExecutionEngine(const Environment& env,
+                                 Archive* arch = NULL) const override
+        {
+            return std::make_unique<CountingTPGExecutionEngine>(env, arch,
+                                                                this->counters);
+        }
+    };
+} // namespace Bench
+
+#endif
@@ -41,11 +41,16 @@
 #include <map>
 #include <memory>
 #include <random>
+#include <unordered_map>
 
 #include "data/dataHandler.h"
 #include "mutator/rng.h"
 #include "program/program.h"
 
+namespace File {
+    class LearningAgentCheckpoint;
+}
+
 /**
  * \brief Class used to store one recording of an Archive.
  *
@@ -128,6 +133,18 @@ class Archive
      */
     const double archivingProbability;
 
+    /**
+     * \brief Programs standing for Programs referenced by recordings restored
+     * from a checkpoint, when the original Program was already freed.
+     *
+     * These Programs are never executed, their address is only used to
+     * group recordings in the recordingsPerProgram map.
+     */
+    std::vector<std::unique_ptr<Program::Program>> placeholderPrograms;
+
+    // Friend relation needed to save and restore the Archive content.
+    friend class File::LearningAgentCheckpoint;
+
   public:
     /**
      * \brief Main constructor for Archive.
@@ -263,6 +280,21 @@ class Archive
         size_t, std::vector<std::reference_wrapper<const Data::DataHandler>>>&
     getDataHandlers() const;
 
+    /**
+     * \brief Replace the Program referenced by recordings.
+     *
+     * This method is used when recordings were made by copies of the
+     * Program, such as replicas of a TPGGraph, to make them reference the
+     * original Program.
+     *
+     * \param[in] replacements map associating Program referenced by
+     * recordings with their replacement. Recordings of other Program are
+     * left unchanged.
+     */
+    void replacePrograms(
+        const std::unordered_map<const Program::Program*,
+                                 const Program::Program*>& replacements);
+
     /**
      * \brief Clear all content from the Archive.
      */
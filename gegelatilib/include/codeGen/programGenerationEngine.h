@@ -39,6 +39,9 @@
 #ifndef PROGRAM_GENERATION_ENGINE_H
 #define PROGRAM_GENERATION_ENGINE_H
 #include <fstream>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "data/dataHandlerPrinter.h"
 #include "data/primitiveTypeArray.h"
@@ -92,6 +95,44 @@ namespace CodeGen {
         ///  Utility class used to print data accesses in generated code.
         Data::DataHandlerPrinter dataPrinter;
 
+        /// Stream in which the lines of the Program are generated.
+        std::ostream* code = &fileC;
+
+        /// Indentation of the lines of the Program currently generated.
+        std::string indent = "\t";
+
+        /**
+         * \brief Functions already generated, indexed by their body.
+         *
+         * The generated body of a Program is used as its canonical form to
+         * share a single function between identical Programs.
+         */
+        std::map<std::string, uint64_t> generatedPrograms;
+
+        /**
+         * \brief Functions generated with an attribute, indexed by their
+         * identifier.
+         *
+         * Each function is associated to its attribute and to its code. The
+         * attribute of a function shared by several Programs depends on all
+         * of them, so these functions are printed by printAttributedPrograms()
+         * when the engine is destroyed.
+         */
+        std::map<uint64_t, std::pair<std::string, std::string>>
+            attributedPrograms;
+
+        /// When true, the lines of Programs are optimized when generated.
+        bool optimization = false;
+
+        /**
+         * \brief Number of writes in each register since the beginning of the
+         * optimized Program generated.
+         *
+         * Write number v in register k is stored in the local variable
+         * reg<k>_<v>.
+         */
+        std::vector<uint64_t> registerVersions;
+
       public:
         /// inherited from Program::ProgramEngine
         virtual void processLine() override;
@@ -156,6 +197,7 @@ namespace CodeGen {
          */
         ~ProgramGenerationEngine()
         {
+            printAttributedPrograms();
             fileH << "#endif" << std::endl;
             fileC.close();
             fileH.close();
@@ -179,6 +221,10 @@ namespace CodeGen {
          * declaration of function of the program with ID=1 is double P1(int*
          * action)
          *
+         * If a function with the same body was already generated by this
+         * engine, no function is printed and the identifier of the existing
+         * function is returned instead.
+         *
          * \param[in] progID : unique identifier of the program used to generate
          *            the name of the function in the C file.
          * \param[in] ignoreException When true, all exceptions thrown when
@@ -188,11 +234,163 @@ namespace CodeGen {
          *            correct by construction, and any exception is re-thrown
          *            for higher-level handling, thus stopping the program.
          *            Exception thrown by getCurrentLine are never ignored.
+         * \param[in] attribute : prefix of the declaration of the function,
+         *            such as "TPG_HOT " or "TPG_COLD " (see
+         *            initProfileMacros()). A function shared by several
+         *            Programs is "TPG_HOT " if any of them is. Functions with
+         *            an attribute are printed when the engine is destroyed.
+         * \return the identifier of the function implementing the Program.
+         */
+        uint64_t generateProgram(uint64_t progID,
+                                 const bool ignoreException = false,
+                                 const std::string& attribute = "");
+
+        /**
+         * \brief Print the macros used by profile-guided code in the header
+         * file.
+         *
+         * TPG_HOT and TPG_COLD mark functions whose code is placed with the
+         * frequently and rarely executed code. TPG_LIKELY(x) and
+         * TPG_UNLIKELY(x) give the expected value of a condition to the
+         * compiler. The macros expand to GCC and Clang builtins, and to
+         * nothing with other compilers.
          */
-        void generateProgram(uint64_t progID,
-                             const bool ignoreException = false);
+        void initProfileMacros();
 
       protected:
+        /**
+         * \brief Print the declaration and the definition of a function
+         * implementing a Program.
+         *
+         * \param[in] progID identifier of the function.
+         * \param[in] attribute prefix of the declaration of the function.
+         * \param[in] functionCode body of the function, including its
+         *            closing brace.
+         */
+        void printProgram(uint64_t progID, const std::string& attribute,
+                          const std::string& functionCode);
+
+        /**
+         * \brief Print the functions of attributedPrograms, by increasing
+         * identifier, and clear it.
+         */
+        void printAttributedPrograms();
+
+      public:
+
+        /**
+         * \brief Generate the batched C code of the member program of the
+         * class.
+         *
+         * Print a function in the file "filename"_program.c that executes the
+         * program on a group of samples of a batch. The declaration of the
+         * function of the program with ID=1 is
+         * void P1_batch(int n, const int* restrict samples,
+         * double* restrict results, const double* restrict in1Batch, ...),
+         * with one pointer per data source of the Environment, as given by
+         * getBatchDataParameters().
+         *
+         * Sample samples[b] of the batch uses the data stored at
+         * in1Batch + samples[b] * size, where size is the address space of the
+         * data source, and its result is written in results[b]. The loop over
+         * the group carries no dependency between iterations so that it can
+         * be vectorized by the C compiler.
+         *
+         * \param[in] progID : unique identifier of the program used to generate
+         *            the name of the function in the C file.
+         * \param[in] ignoreException see generateProgram().
+         */
+        void generateProgramBatch(uint64_t progID,
+                                  const bool ignoreException = false);
+
+        /**
+         * \brief Get the parameters declaring the batched data sources.
+         *
+         * \return the list of parameters, separated by commas, used in the
+         * generated code to give the batched data of each data source of the
+         * Environment. For example: "const double* restrict in1Batch".
+         */
+        std::string getBatchDataParameters() const;
+
+        /**
+         * \brief Get the arguments giving the batched data sources.
+         *
+         * \param[in] firstSample name of a variable of the generated code
+         * holding the index of the first sample of the batch to give. When
+         * empty, the batched data are given from their first sample.
+         *
+         * \return the list of arguments, separated by commas, matching the
+         * parameters returned by getBatchDataParameters().
+         */
+        std::string getBatchDataArguments(
+            const std::string& firstSample = "") const;
+
+        /**
+         * \brief Enable or disable the optimization of generated Programs.
+         *
+         * When enabled, only the lines contributing to the result of a
+         * Program are generated. Registers are replaced with scalar local
+         * variables, a new one being declared for each write in a register,
+         * and reads of constants are replaced with their value. The
+         * printTemplate of instructions is expected to only write in $0.
+         *
+         * \param[in] enable whether generated Programs are optimized.
+         */
+        void setOptimization(bool enable);
+
+        /// Get whether generated Programs are optimized.
+        bool isOptimization() const;
+
+        /**
+         * \brief Find the lines of the Program contributing to its result.
+         *
+         * A backward pass over the non-intron lines keeps the lines writing a
+         * register read by a later kept line, or register 0.
+         *
+         * \param[in] ignoreException see generateProgram(). Lines throwing an
+         *            exception are not kept when true.
+         * \return the indexes of the kept lines, in increasing order.
+         */
+        std::vector<uint64_t> findLiveLines(
+            const bool ignoreException = false);
+
+      protected:
+        /**
+         * \brief Generate the lines of the Program.
+         *
+         * \param[in] ignoreException see generateProgram().
+         * \return the C expression of the result of the Program.
+         */
+        std::string generateLines(const bool ignoreException);
+
+        /**
+         * \brief Rename the registers and constants in generated code.
+         *
+         * Each register access is replaced with the local variable holding
+         * the current value of the register, or 0 if it was not written yet,
+         * and each constant access is replaced with the value of the
+         * constant.
+         *
+         * \param[in] codeLine the code to rename.
+         * \return a copy of codeLine with the accesses renamed.
+         */
+        std::string renameVariables(const std::string& codeLine) const;
+
+        /**
+         * \brief Print the declaration of the registers of the program.
+         *
+         * Registers are declared with the current indentation and initialized
+         * to zero.
+         */
+        void initRegisters();
+
+        /**
+         * \brief Print the declaration of the constants of the program.
+         *
+         * Nothing is printed if the Environment has no Data::Constant.
+         */
+        void initConstants();
+
         /**
          * \brief Set global variables in the file holding the programs.
          *
@@ -41,9 +41,12 @@
 #define TPG_GENERATION_ENGINE_H
 #include <ios>
 #include <iostream>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "codeGen/programGenerationEngine.h"
+#include "tpg/instrumented/executionStats.h"
 #include "tpg/tpgAbstractEngine.h"
 #include "tpg/tpgEdge.h"
 #include "tpg/tpgGraph.h"
@@ -88,6 +91,28 @@ namespace CodeGen {
          */
         CodeGen::ProgramGenerationEngine progGenerationEngine;
 
+        /**
+         * \brief When true, generateTPGGraph() also generates the function
+         * inferenceTPGBatch().
+         */
+        bool batchInference = false;
+
+        /// Identifier of the C function implementing each Program identifier.
+        std::map<uint64_t, uint64_t> programFunctionIDs;
+
+        /// When true, the layout of the generated code follows the profile
+        /// given to setProfile().
+        bool profileGuided = false;
+
+        /// Number of profiled inferences visiting each vertex.
+        std::map<const TPG::TPGVertex*, uint64_t> vertexVisits;
+
+        /// Number of profiled evaluations of each Program.
+        std::map<const Program::Program*, uint64_t> programEvaluations;
+
+        /// Number of profiled inferences following each edge.
+        std::map<const TPG::TPGEdge*, uint64_t> edgeTraversals;
+
         /**
          * \brief function printing generic code in the main file.
          *
@@ -139,7 +164,130 @@ namespace CodeGen {
          */
         virtual void generateTPGGraph() = 0;
 
+        /**
+         * \brief Enable or disable the generation of the batch inference.
+         *
+         * When enabled, the generated code also contains the function
+         * void inferenceTPGBatch(int n, const double* in1Batch, ...,
+         * int* actions) that infers the actions of n samples at once. The
+         * data of sample i of data source k starts at
+         * in<k>Batch + i * size, where size is the address space of the data
+         * source, and its action is written in actions[i]. The batch is
+         * processed by chunks of TPG_BATCH_SIZE samples, a macro that can be
+         * defined when compiling the generated code (64 by default).
+         *
+         * Within a chunk, the teams are visited in topological order and
+         * samples reaching the same team are regrouped, so that each Program
+         * of the team is executed on the whole group by a vectorizable loop.
+         * Batch inference thus requires the TPGGraph reachable from the root
+         * to be acyclic.
+         *
+         * Batch inference is disabled by default and its generation does not
+         * alter the code generated for inferenceTPG().
+         *
+         * \param[in] enable whether inferenceTPGBatch() must be generated.
+         */
+        void setBatchInference(bool enable);
+
+        /// Get whether inferenceTPGBatch() is generated.
+        bool isBatchInference() const;
+
+        /**
+         * \brief Enable or disable the optimization of generated Programs.
+         *
+         * See ProgramGenerationEngine::setOptimization(). Optimization is
+         * disabled by default.
+         *
+         * \param[in] enable whether generated Programs are optimized.
+         */
+        void setProgramOptimization(bool enable);
+
+        /// Get whether generated Programs are optimized.
+        bool isProgramOptimization() const;
+
+        /**
+         * \brief Use an execution profile to lay out the generated code.
+         *
+         * The profile is made of the inference traces analyzed by the
+         * ExecutionStats, with ExecutionStats::analyzeExecution() or
+         * ExecutionStats::analyzeInferenceTrace(). Traces must have been
+         * recorded on the TPGGraph given to the constructor, as vertices are
+         * identified by their address.
+         *
+         * With a profile, vertices are generated by decreasing number of
+         * visits, so that hot teams are contiguous. Functions of Programs
+         * evaluated during the profiled inferences are marked hot, and the
+         * others cold. A function shared by several Programs is hot if any
+         * of them was evaluated. Engines whose generated code compares the bids of a
+         * team explicitly also hint the compiler about the comparisons
+         * that select the winning edge in most profiled visits of the team.
+         * Actions returned by the generated code are unchanged.
+         *
+         * This method must be called before generateTPGGraph(). The content
+         * of stats is copied.
+         *
+         * \param[in] stats the ExecutionStats holding the profiled traces.
+         */
+        void setProfile(const TPG::ExecutionStats& stats);
+
+        /// Get whether the layout of the generated code follows a profile.
+        bool isProfileGuided() const;
+
       protected:
+        /**
+         * \brief Get the vertices of the TPGGraph in the order in which they
+         * are generated.
+         *
+         * \return the vertices of the TPGGraph, sorted by decreasing number
+         * of profiled visits when a profile is set, or in the order of
+         * TPGGraph::getVertices() otherwise. Ties keep the latter order.
+         */
+        std::vector<const TPG::TPGVertex*> getVerticesInLayoutOrder() const;
+
+        /**
+         * \brief Get the expected outcome of the comparison selecting an edge
+         * in the generated code.
+         *
+         * The comparison is the one replacing the best bid of the team with
+         * the bid of the edge. It is true for every inference following the
+         * edge, and, unless the edge is the last one of the team, for some
+         * other inferences where a later edge wins. It is hinted as likely
+         * when the edge is followed by more than half of the visits of the
+         * team, and as unlikely when the edge is the last one and is followed
+         * by less than half of them.
+         *
+         * \param[in] team the team evaluating the edge.
+         * \param[in] edge the edge whose comparison is printed.
+         * \return "TPG_LIKELY", "TPG_UNLIKELY" or an empty string when no
+         * profile is set or when the outcome is not known.
+         */
+        std::string getComparisonHint(const TPG::TPGTeam& team,
+                                      const TPG::TPGEdge& edge) const;
+
+        /**
+         * \brief Get the identifier of the C function implementing a Program.
+         *
+         * The function is generated the first time the Program is
+         * encountered. Programs with an identical generated body share the
+         * same function.
+         *
+         * \param[in] program the Program whose function is needed.
+         * \return the identifier of the function in the generated code.
+         */
+        uint64_t findProgramFunctionID(const Program::Program& program);
+
+        /**
+         * \brief Method for generating the batch inference of the TPGGraph.
+         *
+         * This method generates the batched version of each Program reachable
+         * from the root of the TPGGraph, and the inferenceTPGBatch() function
+         * iterating through the TPGGraph for groups of samples.
+         *
+         * \throw std::runtime_error if the TPGGraph reachable from its root
+         * contains a cycle.
+         */
+        void generateBatchInference();
+
         /**
          * \brief Method for generating the code for an edge of the graph.
          *
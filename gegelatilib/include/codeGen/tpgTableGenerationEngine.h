@@ -0,0 +1,248 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifdef CODE_GENERATION
+
+#ifndef TPG_TABLE_GENERATION_ENGINE_H
+#define TPG_TABLE_GENERATION_ENGINE_H
+
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "codeGen/tpgGenerationEngine.h"
+#include "data/dataHandlerPrinter.h"
+
+namespace CodeGen {
+    /**
+     * \brief Class in charge of generating a compact, table-driven, C code of
+     * a TPGGraph.
+     *
+     * Instead of generating one C function per Program and per team, the
+     * TPGGraph is serialized into const arrays: the Lines of all Programs,
+     * packed with their opcode, destination and operand indexes, the
+     * Programs, the edges and the teams. A small generic interpreter executes
+     * these tables. Its opcode switch contains one case per Instruction used
+     * by the TPGGraph, built from the print template of the Instruction.
+     *
+     * The size of the generated code thus grows with the size of the tables,
+     * not with the amount of code generated for each Program, which favors
+     * footprint over speed compared to the TPGSwitchGenerationEngine and the
+     * TPGStackGenerationEngine. Integer types of the tables are the smallest
+     * ones holding their values.
+     *
+     * The generated inferenceTPG() function has the same prototype and
+     * behavior as with other engines.
+     */
+    class TPGTableGenerationEngine : public CodeGen::TPGGenerationEngine
+    {
+      protected:
+        /// Utility class used to print data accesses in generated code.
+        Data::DataHandlerPrinter dataPrinter;
+
+        /// Index of each team in the table of teams.
+        std::map<const TPG::TPGVertex*, uint64_t> teamIndexes;
+
+        /// Index of each Program in the table of Programs.
+        std::map<const Program::Program*, uint64_t> programIndexes;
+
+        /**
+         * \brief Index of Programs in the table of Programs, indexed by their
+         * rows in the tables of lines and constants.
+         *
+         * Identical Programs thus share their rows.
+         */
+        std::map<std::string, uint64_t> programRows;
+
+        /// Opcodes of the Instructions used by the TPGGraph.
+        std::set<uint64_t> usedOpcodes;
+
+        /// Rows of the table of lines.
+        std::ostringstream linesTable;
+
+        /// Rows of the table of Programs.
+        std::ostringstream programsTable;
+
+        /// Rows of the table of constants.
+        std::ostringstream constantsTable;
+
+        /// Rows of the table of edges.
+        std::ostringstream edgesTable;
+
+        /// Rows of the table of teams.
+        std::ostringstream teamsTable;
+
+        /// Number of rows of the table of lines.
+        uint64_t nbLines = 0;
+
+        /// Number of rows of the table of edges.
+        uint64_t nbEdges = 0;
+
+        /// Largest address read by an operand.
+        uint64_t maxAddress = 0;
+
+        /// Largest action identifier.
+        uint64_t maxActionID = 0;
+
+        /**
+         * \brief function printing generic code in the main file.
+         *
+         * This function prints the includes, the declaration of the data
+         * sources and the type definitions of the tables. It must be called
+         * once all tables are filled.
+         */
+        virtual void initTpgFile() override;
+
+        /**
+         * \brief function printing generic code declaration in the main file
+         * header.
+         *
+         * This function prints the prototype of inferenceTPG().
+         */
+        virtual void initHeaderFile() override;
+
+      public:
+        /**
+         * \brief Main constructor of the class.
+         *
+         * \param[in] filename : filename of the file holding the main function
+         *                of the generated program.
+         *
+         * \param[in] tpg Environment in which the Program of the TPGGraph will
+         *                be executed.
+         *
+         * \param[in] path to the folder in which the file are generated. If the
+         * folder does not exist.
+         */
+        TPGTableGenerationEngine(const std::string& filename,
+                                 const TPG::TPGGraph& tpg,
+                                 const std::string& path = "./")
+            : TPGGenerationEngine(filename, tpg, path){};
+
+        /**
+         * \brief function that creates the C files required to execute the TPG
+         * without gegelati.
+         *
+         * This function fills the tables by iterating through the TPGGraph,
+         * and then prints them with the interpreter.
+         *
+         * \throw std::runtime_error if an Instruction used by the TPGGraph is
+         * not printable, or if its operands can be read from data sources with
+         * different types or layouts.
+         */
+        virtual void generateTPGGraph() override;
+
+      protected:
+        /**
+         * \brief Method for generating the code for an edge of the graph.
+         *
+         * This function adds the edge to the table of edges, and its Program
+         * to the tables of Programs, lines and constants if needed.
+         *
+         * \param[in] edge that must be generated.
+         */
+        virtual void generateEdge(const TPG::TPGEdge& edge) override;
+
+        /**
+         * \brief Method for generating the code for a team of the graph.
+         *
+         * This function adds the team to the table of teams, and its edges to
+         * the table of edges.
+         *
+         * \param[in] team const reference of the TPGTeam that must be
+         * generated.
+         */
+        virtual void generateTeam(const TPG::TPGTeam& team) override;
+
+        /**
+         * \brief Method for generating a action of the graph.
+         *
+         * Actions have no table: they are encoded in the destination of edges
+         * as -(actionID + 1). This method only keeps track of the largest
+         * action identifier.
+         *
+         * \param[in] action const reference of the TPGAction that must be
+         * generated.
+         */
+        virtual void generateAction(const TPG::TPGAction& action) override;
+
+        /**
+         * \brief Get the index of a Program in the table of Programs.
+         *
+         * The Program is added to the tables the first time it is
+         * encountered, unless an identical Program was already added.
+         *
+         * \param[in] program the Program to look for.
+         * \return the index of the Program in the table of Programs.
+         */
+        uint64_t findProgramIndex(const Program::Program& program);
+
+        /**
+         * \brief Get the code of a vertex in the generated tables.
+         *
+         * \param[in] vertex the TPGVertex whose code is needed.
+         * \return the index of a team, or -(actionID + 1) for an action.
+         */
+        int64_t vertexCode(const TPG::TPGVertex& vertex) const;
+
+        /**
+         * \brief Print the interpreter executing the tables.
+         *
+         * This function prints the executeProgram() function, with its opcode
+         * switch, and the inferenceTPG() function.
+         */
+        void generateInterpreter();
+
+        /**
+         * \brief Print the case of the opcode switch of an Instruction.
+         *
+         * \param[in] opcode the index of the Instruction in the Set of the
+         * Environment.
+         */
+        void generateOpcodeCase(uint64_t opcode);
+
+        /**
+         * \brief Get the smallest C integer type holding a range of values.
+         *
+         * \param[in] min the smallest value of the range.
+         * \param[in] max the largest value of the range.
+         * \return the name of the C integer type.
+         */
+        static std::string integerType(int64_t min, uint64_t max);
+    };
+} // namespace CodeGen
+
+#endif // TPG_TABLE_GENERATION_ENGINE_H
+
+#endif // CODE_GENERATION
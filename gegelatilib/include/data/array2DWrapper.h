@@ -134,6 +134,24 @@ namespace Data {
          */
         virtual DataHandler* clone() const override;
 
+        /**
+         * \brief Set a read-only view of the Array2DWrapper on raw memory.
+         *
+         * Like ArrayWrapper::setView, with an additional distance between
+         * rows, so that the Array2DWrapper can view a region of a larger 2D
+         * array, or rows padded for alignment.
+         *
+         * \param[in] ptr pointer to the first element of the first row to
+         * view, or nullptr.
+         * \param[in] stride distance, in elements, between consecutive
+         * elements of a row.
+         * \param[in] rowStride distance, in elements, between the first
+         * elements of consecutive rows. If 0, rows are contiguous, and the
+         * row stride is width * stride.
+         * \throws std::invalid_argument if the stride is 0.
+         */
+        void setView(const T* ptr, size_t stride = 1, size_t rowStride = 0);
+
         /// Inherited from DataHandler
         virtual size_t getAddressSpace(
             const std::type_info& type) const override;
@@ -170,6 +188,19 @@ namespace Data {
         return result;
     }
 
+    template <class T>
+    inline void Array2DWrapper<T>::setView(const T* ptr, size_t stride,
+                                           size_t rowStride)
+    {
+        if (rowStride == 0 || rowStride == this->width * stride) {
+            // Contiguous rows are viewed as a single row.
+            this->setStridedView(ptr, stride, 0, 0);
+        }
+        else {
+            this->setStridedView(ptr, stride, this->width, rowStride);
+        }
+    }
+
     template <typename T>
     std::vector<size_t> Array2DWrapper<T>::getAddressesAccessed(
         const std::type_info& type, const size_t address) const
@@ -292,7 +323,7 @@ namespace Data {
 
         if (type == typeid(T)) {
             UntypedSharedPtr result(
-                &(this->containerPtr->at(address)),
+                this->getElementPtr(address),
                 UntypedSharedPtr::emptyDestructor<const T>());
             return result;
         }
@@ -318,7 +349,7 @@ namespace Data {
         for (size_t idxHeight = 0; idxHeight < arrayHeight; idxHeight++) {
             for (size_t idxWidth = 0; idxWidth < arrayWidth; idxWidth++) {
                 size_t idxSrc = (idxHeight * this->width) + idxWidth;
-                array[idxDst++] = this->containerPtr->at(addressSrc + idxSrc);
+                array[idxDst++] = this->getElement(addressSrc + idxSrc);
             }
         }
 
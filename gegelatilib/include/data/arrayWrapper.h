@@ -104,6 +104,91 @@ namespace Data {
          */
         std::vector<T>* containerPtr;
 
+        /**
+         * \brief Pointer to the first of nbElements elements of a read-only
+         * view, set with setView.
+         *
+         * When not null, the data is read from this view instead of the
+         * containerPtr vector.
+         */
+        const T* viewPtr = nullptr;
+
+        /// Distance, in elements, between consecutive elements of the view.
+        size_t viewStride = 1;
+
+        /**
+         * \brief Number of consecutive elements of the view separated by
+         * viewStride, or 0 if all elements are.
+         *
+         * Used by derived classes to view the rows of a larger 2D array.
+         */
+        size_t viewRowLength = 0;
+
+        /// Distance, in elements, between the first elements of consecutive
+        /// rows of the view. Only used if viewRowLength is not 0.
+        size_t viewRowStride = 0;
+
+        /**
+         * \brief Get a pointer to an element of the view.
+         *
+         * \param[in] idx the index of the element.
+         * \return a pointer to the element in the viewed memory.
+         */
+        const T* getViewElementPtr(size_t idx) const
+        {
+            if (this->viewRowLength == 0) {
+                return this->viewPtr + idx * this->viewStride;
+            }
+            return this->viewPtr +
+                   (idx / this->viewRowLength) * this->viewRowStride +
+                   (idx % this->viewRowLength) * this->viewStride;
+        };
+
+        /**
+         * \brief Get the value of an element of the ArrayWrapper.
+         *
+         * \param[in] idx the index of the element.
+         * \return the element from the view, if any, or from the vector.
+         */
+        T getElement(size_t idx) const
+        {
+            return (this->viewPtr != nullptr) ? *this->getViewElementPtr(idx)
+                                              : this->containerPtr->at(idx);
+        };
+
+        /**
+         * \brief Get a pointer to an element of the ArrayWrapper.
+         *
+         * The pointer has the same type for views and vectors, so that
+         * UntypedSharedPtr built from it are the same. Data of a view must
+         * never be written through this pointer.
+         *
+         * \param[in] idx the index of the element.
+         * \return a pointer to the element of the view, if any, or of the
+         * vector.
+         */
+        T* getElementPtr(size_t idx) const
+        {
+            return (this->viewPtr != nullptr)
+                       ? const_cast<T*>(this->getViewElementPtr(idx))
+                       : &(this->containerPtr->at(idx));
+        };
+
+        /**
+         * \brief Set a strided read-only view of the ArrayWrapper.
+         *
+         * \param[in] ptr pointer to the first element to view, or nullptr.
+         * \param[in] stride distance, in elements, between consecutive
+         * elements of a row.
+         * \param[in] rowLength number of elements per row, or 0 for a single
+         * row.
+         * \param[in] rowStride distance, in elements, between the first
+         * elements of consecutive rows.
+         * \throws std::invalid_argument if the stride is 0.
+         */
+        void setStridedView(const T* ptr, size_t stride, size_t rowLength,
+                            size_t rowStride);
+
         /**
          * Check whether the given type of data can be accessed at the given
          * address. Throws exception otherwise.
@@ -200,6 +285,29 @@ namespace Data {
          */
         void setPointer(std::vector<T>* ptr);
 
+        /**
+         * \brief Set a read-only view of the ArrayWrapper on raw memory.
+         *
+         * The ArrayWrapper reads its nbElements elements directly from the
+         * given memory, without copying them, until a new pointer or view is
+         * set. The memory must remain valid as long as the view is used.
+         * This method automatically invalidates the cachedHash, and
+         * invalidateCachedHash must be called each time the viewed data is
+         * modified.
+         *
+         * Since the hash only depends on the viewed values, views and
+         * vectors holding the same values have the same hash, and copies
+         * made by the clone method hold the values viewed when cloning.
+         *
+         * \param[in] ptr pointer to the first of the nbElements elements to
+         * view, or nullptr.
+         * \param[in] stride distance, in elements, between consecutive
+         * elements of the view. For example, a stride of 3 views a single
+         * channel of interleaved RGB pixels.
+         * \throws std::invalid_argument if the stride is 0.
+         */
+        void setView(const T* ptr, size_t stride = 1);
+
         /// Inherited from DataHandler
         virtual UntypedSharedPtr getDataAt(const std::type_info& type,
                                            const size_t address) const override;
@@ -208,6 +316,29 @@ namespace Data {
         virtual std::vector<size_t> getAddressesAccessed(
             const std::type_info& type, const size_t address) const override;
 
+        /**
+         * \brief Inherited from DataHandler.
+         *
+         * The number of elements is written, followed by the raw value of
+         * each element.
+         *
+         * \throw std::runtime_error if the pointer of the ArrayWrapper is
+         * null.
+         */
+        virtual void writeData(std::ostream& out) const override;
+
+        /**
+         * \brief Inherited from DataHandler.
+         *
+         * Data read from the stream is written in the vector pointed by the
+         * ArrayWrapper.
+         *
+         * \throw std::runtime_error if the pointer of the ArrayWrapper is
+         * null, if the number of elements read differs from the size of the
+         * ArrayWrapper, or if the stream ends prematurely.
+         */
+        virtual void readData(std::istream& in) override;
+
 #ifdef CODE_GENERATION
         /// Inherited from DataHandler
         virtual const std::type_info& getNativeType() const override;
@@ -331,7 +462,7 @@ namespace Data {
     inline UntypedSharedPtr ArrayWrapper<T>::getDataAt(
         const std::type_info& type, const size_t address) const
     {
-        if (this->containerPtr == nullptr) {
+        if (this->containerPtr == nullptr && this->viewPtr == nullptr) {
             throw std::runtime_error("Null pointer access.");
         }
 #ifndef NDEBUG
@@ -341,7 +472,7 @@ namespace Data {
 
         if (type == typeid(T)) {
             UntypedSharedPtr result(
-                &(this->containerPtr->at(address)),
+                this->getElementPtr(address),
                 UntypedSharedPtr::emptyDestructor<const T>());
             return result;
         }
@@ -354,7 +485,7 @@ namespace Data {
 
         // Copy its content
         for (size_t idx = 0; idx < arraySize; idx++) {
-            array[idx] = this->containerPtr->at(address + idx);
+            array[idx] = this->getElement(address + idx);
         }
 
         // Create the UntypedSharedPtr
@@ -379,9 +510,58 @@ namespace Data {
         // Does nothing;
     }
 
+    template <class T>
+    void ArrayWrapper<T>::writeData(std::ostream& out) const
+    {
+        if (this->containerPtr == nullptr && this->viewPtr == nullptr) {
+            throw std::runtime_error(
+                "Cannot write the data of an ArrayWrapper with a null pointer.");
+        }
+
+        uint64_t size = this->nbElements;
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        for (size_t i = 0; i < this->nbElements; i++) {
+            // Element-wise copy to support std::vector<bool>.
+            T value = this->getElement(i);
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+    }
+
+    template <class T> void ArrayWrapper<T>::readData(std::istream& in)
+    {
+        if (this->viewPtr != nullptr) {
+            throw std::runtime_error(
+                "Cannot read data into a read-only view of an ArrayWrapper.");
+        }
+        if (this->containerPtr == nullptr) {
+            throw std::runtime_error(
+                "Cannot read the data of an ArrayWrapper with a null pointer.");
+        }
+
+        uint64_t size;
+        in.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if (!in || size != this->nbElements) {
+            throw std::runtime_error(
+                "Data read does not match the size of the ArrayWrapper.");
+        }
+        for (size_t i = 0; i < this->nbElements; i++) {
+            T value;
+            in.read(reinterpret_cast<char*>(&value), sizeof(T));
+            (*this->containerPtr)[i] = value;
+        }
+        if (!in) {
+            throw std::runtime_error(
+                "Unexpected end of stream while reading ArrayWrapper data.");
+        }
+
+        this->invalidCachedHash = true;
+    }
+
     template <class T>
     inline void ArrayWrapper<T>::setPointer(std::vector<T>* ptr)
     {
+        this->viewPtr = nullptr;
+
         // Null ptr case
         if (ptr == nullptr) {
             this->containerPtr = ptr;
@@ -404,10 +584,33 @@ namespace Data {
         this->invalidCachedHash = true;
     }
 
+    template <class T>
+    inline void ArrayWrapper<T>::setStridedView(const T* ptr, size_t stride,
+                                                size_t rowLength,
+                                                size_t rowStride)
+    {
+        if (stride == 0) {
+            throw std::invalid_argument(
+                "Stride of an ArrayWrapper view must be greater than 0.");
+        }
+        this->containerPtr = nullptr;
+        this->viewPtr = ptr;
+        this->viewStride = stride;
+        this->viewRowLength = rowLength;
+        this->viewRowStride = rowStride;
+        this->invalidCachedHash = true;
+    }
+
+    template <class T>
+    inline void ArrayWrapper<T>::setView(const T* ptr, size_t stride)
+    {
+        this->setStridedView(ptr, stride, 0, 0);
+    }
+
     template <class T> inline size_t ArrayWrapper<T>::updateHash() const
     {
         // Null pointer case
-        if (this->containerPtr == nullptr) {
+        if (this->containerPtr == nullptr && this->viewPtr == nullptr) {
             return this->cachedHash = 0;
         }
 
@@ -417,11 +620,11 @@ namespace Data {
         // hasher
         Data::Hash<T> hasher;
 
-        for (T dataElement : *(this->containerPtr)) {
+        for (size_t i = 0; i < this->nbElements; i++) {
             // Rotate by 1 because otherwise, xor is comutative.
             this->cachedHash =
                 (this->cachedHash >> 1) | (this->cachedHash << 63);
-            this->cachedHash ^= hasher((T)dataElement);
+            this->cachedHash ^= hasher(this->getElement(i));
         }
 
         // Validate the cached hash value
@@ -39,6 +39,7 @@
 #define DATA_HANDLER_H
 
 #include <functional>
+#include <iostream>
 #include <memory>
 #include <typeinfo>
 #include <vector>
@@ -261,6 +262,33 @@ namespace Data {
         uint64_t scaleLocation(const uint64_t rawLocation,
                                const std::type_info& type) const;
 
+        /**
+         * \brief Write the raw content of the DataHandler in a binary stream.
+         *
+         * This method is used to save the DataHandler copies held by an
+         * Archive in a checkpoint. The default implementation throws an
+         * exception, DataHandler supporting checkpoints must override it
+         * together with readData().
+         *
+         * \param[in] out the binary stream where the data is written.
+         * \throw std::runtime_error if the DataHandler does not support it.
+         */
+        virtual void writeData(std::ostream& out) const;
+
+        /**
+         * \brief Overwrite the content of the DataHandler with data read from
+         * a binary stream.
+         *
+         * The data must have been written by the writeData() method of a
+         * DataHandler with the same characteristics. This method shall
+         * invalidate the cachedHash.
+         *
+         * \param[in] in the binary stream from which the data is read.
+         * \throw std::runtime_error if the DataHandler does not support it,
+         * or if the data read does not match the DataHandler.
+         */
+        virtual void readData(std::istream& in);
+
 #ifdef CODE_GENERATION
         /**
          * \brief Function returning the native type of the DataHandler.
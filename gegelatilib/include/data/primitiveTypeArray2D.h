@@ -161,12 +161,12 @@ namespace Data {
         const Array2DWrapper<T>& other)
         : Array2DWrapper<T>(other), data(this->nbElements)
     {
-        if (this->containerPtr != NULL) {
+        if (this->containerPtr != NULL || this->viewPtr != NULL) {
             // Copy the data from the given ArrayWrapper
             for (size_t i = 0; i < this->nbElements; i++) {
-                // exploit the fact that the container pointer still points to
-                // data from other.
-                this->data[i] = this->containerPtr->at(i);
+                // exploit the fact that the container or view pointer still
+                // points to data from other.
+                this->data[i] = this->getElement(i);
             }
         }
         else {
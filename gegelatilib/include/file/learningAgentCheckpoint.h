@@ -0,0 +1,216 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef LEARNING_AGENT_CHECKPOINT_H
+#define LEARNING_AGENT_CHECKPOINT_H
+
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "archive.h"
+#include "learn/evaluationResult.h"
+#include "learn/learningAgent.h"
+#include "mutator/rng.h"
+#include "program/program.h"
+#include "tpg/tpgGraph.h"
+
+namespace File {
+    /**
+     * \brief Class used to save and restore the complete training state of a
+     * Learn::LearningAgent in a compact binary format.
+     *
+     * Contrary to the TPGGraphDotExporter, a checkpoint contains everything
+     * needed to resume a training deterministically:
+     * - the TPGGraph, with the order of its vertices and edges, and its
+     * Program (lines and constants),
+     * - the Archive recordings and copies of DataHandler, and its RNG state,
+     * - the RNG state of the LearningAgent,
+     * - the EvaluationResult of roots, the best root, and the best score of
+     * the last generation,
+     * - the number of the next generation to train.
+     *
+     * The LearningParameters and the LearningEnvironment are not part of the
+     * checkpoint: the LearningAgent used to restore a checkpoint must be
+     * built with the same LearningEnvironment, Instructions::Set and
+     * LearningParameters as the one used to save it. The internal state of
+     * the LearningEnvironment is not saved either.
+     *
+     * Data is written with the native endianness and type sizes, so
+     * checkpoints are not meant to be exchanged between architectures.
+     *
+     * Checkpoints must be saved between two generations, when no thread
+     * modifies the LearningAgent.
+     */
+    class LearningAgentCheckpoint
+    {
+      protected:
+        /// Version of the binary format, incremented on incompatible changes.
+        static constexpr uint32_t FORMAT_VERSION = 2;
+
+        /// Write the RNG engine state.
+        static void writeRNG(const Mutator::RNG& rng, std::ostream& out);
+
+        /// Read the RNG engine state.
+        static void readRNG(Mutator::RNG& rng, std::istream& in);
+
+        /// Write a Program lines and constants.
+        static void writeProgram(const Program::Program& prog,
+                                 std::ostream& out);
+
+        /// Read a Program written with writeProgram.
+        static std::shared_ptr<Program::Program> readProgram(
+            const Environment& env, std::istream& in);
+
+        /// Write an EvaluationResult, or a ClassificationEvaluationResult, with
+        /// its inference cost.
+        static void writeEvaluationResult(const Learn::EvaluationResult& res,
+                                          std::ostream& out);
+
+        /// Read an EvaluationResult written with writeEvaluationResult.
+        static std::shared_ptr<Learn::EvaluationResult> readEvaluationResult(
+            std::istream& in);
+
+        /**
+         * \brief Write the Archive content.
+         *
+         * \param[in] archive the Archive to write.
+         * \param[in] programIdx index of the Program of the TPGGraph in the
+         * checkpoint, used to identify the Program of recordings.
+         * \param[in] out the binary stream where the Archive is written.
+         */
+        static void writeArchive(
+            const Archive& archive,
+            const std::map<const Program::Program*, uint64_t>& programIdx,
+            std::ostream& out);
+
+        /**
+         * \brief Read the Archive content.
+         *
+         * \param[in] env the Environment of the restored LearningAgent.
+         * \param[in] programs the Program restored in the TPGGraph.
+         * \param[in] in the binary stream from which the Archive is read.
+         * \param[out] archive an empty Archive filled with the content read.
+         * If an exception is thrown, the archive may be partially filled.
+         */
+        static void readArchive(
+            const Environment& env,
+            const std::vector<std::shared_ptr<Program::Program>>& programs,
+            std::istream& in, Archive& archive);
+
+      public:
+        /**
+         * \brief Write the training state of a LearningAgent in a binary
+         * stream.
+         *
+         * \param[in] la the LearningAgent to save.
+         * \param[in] generationNumber the number of the next generation to
+         * train when resuming from this checkpoint.
+         * \param[in] out the binary stream where the checkpoint is written.
+         * \throw std::runtime_error if a DataHandler of the Archive, or an
+         * EvaluationResult type, is not supported.
+         */
+        static void write(const Learn::LearningAgent& la,
+                          uint64_t generationNumber, std::ostream& out);
+
+        /**
+         * \brief Restore the training state of a LearningAgent from a binary
+         * stream.
+         *
+         * The previous TPGGraph, Archive and results of the LearningAgent
+         * are replaced with the content of the checkpoint.
+         *
+         * \param[in] la the LearningAgent to restore.
+         * \param[in] in the binary stream from which the checkpoint is read.
+         * \return the number of the next generation to train.
+         * \throw std::runtime_error if the stream is not a valid checkpoint,
+         * or if it was saved with an incompatible Environment.
+         */
+        static uint64_t read(Learn::LearningAgent& la, std::istream& in);
+
+        /**
+         * \brief Save the training state of a LearningAgent in a file.
+         *
+         * The checkpoint is first written in a temporary file which is then
+         * renamed, so that an interrupted save never corrupts a previous
+         * checkpoint with the same path.
+         *
+         * \param[in] la the LearningAgent to save.
+         * \param[in] generationNumber the number of the next generation to
+         * train when resuming from this checkpoint.
+         * \param[in] path the path of the checkpoint file.
+         * \throw std::runtime_error if the file cannot be written, or if the
+         * LearningAgent cannot be saved.
+         */
+        static void save(const Learn::LearningAgent& la,
+                         uint64_t generationNumber, const std::string& path);
+
+        /**
+         * \brief Save the training state of a LearningAgent in a file, without
+         * waiting for the file to be written.
+         *
+         * A snapshot of the LearningAgent is serialized in memory before the
+         * method returns, so the training can continue immediately. The file
+         * is written by another thread.
+         *
+         * \param[in] la the LearningAgent to save.
+         * \param[in] generationNumber the number of the next generation to
+         * train when resuming from this checkpoint.
+         * \param[in] path the path of the checkpoint file.
+         * \return a std::future that becomes ready when the file is written,
+         * and rethrows any error that occurred while writing it.
+         * \throw std::runtime_error if the LearningAgent cannot be saved.
+         */
+        static std::future<void> saveAsync(const Learn::LearningAgent& la,
+                                           uint64_t generationNumber,
+                                           const std::string& path);
+
+        /**
+         * \brief Restore the training state of a LearningAgent from a file.
+         *
+         * \param[in] la the LearningAgent to restore.
+         * \param[in] path the path of the checkpoint file.
+         * \return the number of the next generation to train.
+         * \throw std::runtime_error if the file cannot be read or is not a
+         * valid checkpoint.
+         */
+        static uint64_t load(Learn::LearningAgent& la, const std::string& path);
+    };
+} // namespace File
+
+#endif
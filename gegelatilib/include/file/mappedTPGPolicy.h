@@ -0,0 +1,119 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef MAPPED_TPG_POLICY_H
+#define MAPPED_TPG_POLICY_H
+
+#include <functional>
+#include <vector>
+
+#include "data/constantHandler.h"
+#include "data/dataHandler.h"
+#include "data/primitiveTypeArray.h"
+#include "environment.h"
+
+#include "file/tpgGraphBinaryFormat.h"
+
+namespace File {
+    /**
+     * \brief Class used to run inference directly from a memory-mapped
+     * binary TPG file.
+     *
+     * Contrary to the TPGGraphBinaryImporter, no TPGGraph or Program object
+     * is built: the vertex, edge and line tables of the file are browsed
+     * directly. The semantics of the execution are the same as those of the
+     * TPG::TPGExecutionEngine, without Archive.
+     */
+    class MappedTPGPolicy
+    {
+      protected:
+        /// Memory-mapped binary TPG file.
+        TPGGraphBinaryFormat::MappedFile file;
+
+        /// Environment in which the policy is executed.
+        const Environment& env;
+
+        /// Header of the binary TPG file.
+        const TPGGraphBinaryFormat::Header& header;
+
+        /// Registers used to execute Program lines.
+        Data::PrimitiveTypeArray<double> registers;
+
+        /// Constants of the currently executed Program.
+        Data::ConstantHandler constants;
+
+        /// Data sources accessed by operands: registers, constants (if any),
+        /// then the Environment data sources.
+        std::vector<std::reference_wrapper<const Data::DataHandler>>
+            dataSources;
+
+        /**
+         * \brief Execute a Program of the file.
+         *
+         * \param[in] programIdx index of the Program in the program table.
+         * \return the value of the first register after the execution, with
+         * NaN values replaced with -inf.
+         */
+        double executeProgram(uint64_t programIdx);
+
+      public:
+        /**
+         * \brief Constructor for the MappedTPGPolicy.
+         *
+         * \param[in] filePath path to the binary TPG file.
+         * \param[in] env the Environment in which the policy is executed. Its
+         * data sources are read when executing the policy.
+         * \throws std::runtime_error in case the file could not be mapped, is
+         * not a valid binary TPG file, or was exported with a different
+         * Environment.
+         */
+        MappedTPGPolicy(const char* filePath, const Environment& env);
+
+        /// Get the number of root vertices of the policy.
+        uint64_t getNbRoots() const;
+
+        /**
+         * \brief Execute the policy from one of its roots.
+         *
+         * \param[in] rootIdx index of the root, in the order of
+         * TPG::TPGGraph::getRootVertices() when the file was exported.
+         * \return the action identifier of the TPGAction reached.
+         * \throws std::out_of_range if the rootIdx is invalid.
+         * \throws std::runtime_error if a cycle is detected.
+         */
+        uint64_t executeFromRoot(uint64_t rootIdx = 0);
+    };
+}; // namespace File
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef TPG_GRAPH_BINARY_EXPORTER_H
+#define TPG_GRAPH_BINARY_EXPORTER_H
+
+#include <string>
+
+#include "tpg/tpgGraph.h"
+
+namespace File {
+    /**
+     * \brief Class used to export a TPGGraph into a file with the compact
+     * binary format described in the TPGGraphBinaryFormat namespace.
+     *
+     * Contrary to the dot format, the binary format can be loaded without
+     * any parsing, and can be used for inference directly from a
+     * memory-mapped file with a MappedTPGPolicy.
+     */
+    class TPGGraphBinaryExporter
+    {
+      protected:
+        /// Path of the file where the TPGGraph is exported.
+        std::string filePath;
+
+        /// TPGGraph exported by the TPGGraphBinaryExporter.
+        const TPG::TPGGraph& graph;
+
+      public:
+        /**
+         * \brief Constructor for the exporter.
+         *
+         * \param[in] filePath path to the file where the binary content
+         * will be written.
+         * \param[in] graph const reference to the graph whose content will
+         * be exported.
+         */
+        TPGGraphBinaryExporter(const char* filePath,
+                               const TPG::TPGGraph& graph)
+            : filePath{filePath}, graph{graph} {};
+
+        /**
+         * \brief Set a new file for the exporter.
+         *
+         * \param[in] newFilePath new path to the file where the binary
+         * content will be written.
+         */
+        void setNewFilePath(const char* newFilePath);
+
+        /**
+         * \brief Export the TPGGraph given when constructing the
+         * TPGGraphBinaryExporter into a binary file.
+         *
+         * \param[in] withIntronMask when true, the intron property of each
+         * Line is exported, so that it does not have to be computed again
+         * when importing the TPGGraph. Introns must have been identified
+         * before the export.
+         * \throws std::runtime_error in case the file could not be written.
+         */
+        void exportGraph(bool withIntronMask = true);
+    };
+}; // namespace File
+
+#endif
@@ -0,0 +1,295 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef TPG_GRAPH_BINARY_FORMAT_H
+#define TPG_GRAPH_BINARY_FORMAT_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "environment.h"
+#include "instructions/set.h"
+
+namespace File {
+    /**
+     * \brief Namespace containing the definition of the compact binary format
+     * used to store a TPGGraph.
+     *
+     * A binary TPG file is a Header followed by flat tables, each starting at
+     * an offset, aligned on 8 bytes, given in the Header:
+     * - the vertex table, with one VertexRecord per TPGVertex,
+     * - the edge table, with one EdgeRecord per TPGEdge, sorted by source
+     * vertex and following the order of the outgoing edges of each vertex,
+     * - the program table, with one ProgramRecord per Program,
+     * - the line table, with one LineRecord per Line of all Program,
+     * - the operand table, with Environment::getMaxNbOperands() OperandRecord
+     * per Line,
+     * - the constant table, with Environment::getNbConstant() int32_t per
+     * Program,
+     * - the root table, with the index of each root vertex,
+     * - optionally, the intron table, with one uint8_t per Line.
+     *
+     * Records are stored with the native endianness, so that the tables can
+     * be used directly from a memory-mapped file without any parsing.
+     */
+    namespace TPGGraphBinaryFormat {
+        /// Magic number at the beginning of binary TPG files.
+        inline constexpr char MAGIC[8] = {'G', 'E', 'G', 'E',
+                                          'L', 'T', 'P', 'G'};
+
+        /// Version of the format, incremented on incompatible changes.
+        inline constexpr uint32_t VERSION = 1;
+
+        /// Flag set in the Header when the intron table is present.
+        inline constexpr uint32_t FLAG_INTRON_MASK = 0x1;
+
+        /// Action identifier stored in the VertexRecord of teams.
+        inline constexpr uint64_t TEAM_VERTEX =
+            std::numeric_limits<uint64_t>::max();
+
+        /// Header of a binary TPG file.
+        struct Header
+        {
+            /// Magic number identifying binary TPG files.
+            char magic[8];
+
+            /// Version of the format.
+            uint32_t version;
+
+            /// Combination of flags (FLAG_INTRON_MASK).
+            uint32_t flags;
+
+            /// Fingerprint of the Environment of the exported TPGGraph.
+            uint64_t environmentFingerprint;
+
+            /// Signature of the Instructions::Set of the Environment.
+            uint64_t instructionSetSignature;
+
+            /// Number of registers of the Environment.
+            uint64_t nbRegisters;
+
+            /// Number of constants of the Environment.
+            uint64_t nbConstants;
+
+            /// Maximum number of operands of the Environment Instructions.
+            uint64_t maxNbOperands;
+
+            /// Number of records in each table.
+            uint64_t nbVertices;
+            uint64_t nbEdges;
+            uint64_t nbPrograms;
+            uint64_t nbLines;
+            uint64_t nbRoots;
+
+            /// Offset of each table from the beginning of the file.
+            uint64_t vertexTableOffset;
+            uint64_t edgeTableOffset;
+            uint64_t programTableOffset;
+            uint64_t lineTableOffset;
+            uint64_t operandTableOffset;
+            uint64_t constantTableOffset;
+            uint64_t rootTableOffset;
+            uint64_t intronTableOffset;
+
+            /// Total size of the file.
+            uint64_t fileSize;
+        };
+
+        /// Record of a TPGVertex.
+        struct VertexRecord
+        {
+            /// Action identifier of a TPGAction, or TEAM_VERTEX for a TPGTeam.
+            uint64_t actionID;
+
+            /// Index of the first outgoing edge in the edge table.
+            uint64_t firstEdge;
+
+            /// Number of outgoing edges.
+            uint64_t nbEdges;
+        };
+
+        /// Record of a TPGEdge. The source is implicit from the edge index.
+        struct EdgeRecord
+        {
+            /// Index of the destination vertex.
+            uint64_t destination;
+
+            /// Index of the Program.
+            uint64_t program;
+        };
+
+        /// Record of a Program.
+        struct ProgramRecord
+        {
+            /// Index of the first Line in the line table.
+            uint64_t firstLine;
+
+            /// Number of Lines of the Program.
+            uint64_t nbLines;
+        };
+
+        /// Record of a Line. Operands are stored in the operand table.
+        struct LineRecord
+        {
+            /// Index of the Instruction.
+            uint64_t instruction;
+
+            /// Index of the destination register.
+            uint64_t destination;
+        };
+
+        /// Record of a Line operand.
+        struct OperandRecord
+        {
+            /// Index of the data source.
+            uint64_t dataSource;
+
+            /// Raw location in the data source.
+            uint64_t location;
+        };
+
+        /**
+         * \brief Compute a fingerprint of an Environment.
+         *
+         * The fingerprint covers the number of registers, constants,
+         * instructions, operands and data sources, as well as the type and
+         * largest address space of each data source.
+         *
+         * \param[in] env the Environment.
+         * \return the fingerprint of the Environment.
+         */
+        uint64_t computeEnvironmentFingerprint(const Environment& env);
+
+        /**
+         * \brief Compute a signature of an Instructions::Set.
+         *
+         * The signature covers the type, number of operands and operand types
+         * of each Instruction, in order. Two Instruction of the same type
+         * performing different computations (e.g. two LambdaInstruction with
+         * the same operand types) can not be distinguished.
+         *
+         * \param[in] iSet the Instructions::Set.
+         * \return the signature of the Instructions::Set.
+         */
+        uint64_t computeInstructionSetSignature(const Instructions::Set& iSet);
+
+        /**
+         * \brief Check the Header and the tables bounds of a binary TPG file.
+         *
+         * \param[in] data pointer to the content of the file.
+         * \param[in] size size of the file.
+         * \param[in] env the Environment in which the TPGGraph will be used.
+         * \return a reference to the Header of the file.
+         * \throw std::runtime_error if the content is not a valid binary TPG
+         * file, or if it was exported with a different Environment.
+         */
+        const Header& checkFile(const char* data, size_t size,
+                                const Environment& env);
+
+        /**
+         * \brief Get a typed pointer on a table of a binary TPG file.
+         *
+         * \param[in] data pointer to the content of the file.
+         * \param[in] offset offset of the table, given in the Header.
+         * \return a pointer to the first record of the table.
+         */
+        template <class T> const T* getTable(const char* data, uint64_t offset)
+        {
+            return reinterpret_cast<const T*>(data + offset);
+        }
+
+        /**
+         * \brief Class giving a read-only view of the content of a file.
+         *
+         * On POSIX systems, the file is memory-mapped. On other systems, its
+         * content is read in memory.
+         */
+        class MappedFile
+        {
+          protected:
+            /// Pointer to the content of the file.
+            const char* data;
+
+            /// Size of the file.
+            size_t size;
+
+#ifdef _WIN32
+            /// Content of the file when memory mapping is not available.
+            std::vector<char> buffer;
+#endif
+
+          public:
+            /**
+             * \brief Map the file at the given path.
+             *
+             * \param[in] filePath path of the file.
+             * \throw std::runtime_error if the file can not be opened or
+             * mapped.
+             */
+            MappedFile(const char* filePath);
+
+            /// Unmap the file.
+            ~MappedFile();
+
+            /// Copy is disabled.
+            MappedFile(const MappedFile& other) = delete;
+
+            /// Assignment is disabled.
+            MappedFile& operator=(const MappedFile& other) = delete;
+
+            /// Get a pointer to the content of the file.
+            const char* getData() const;
+
+            /// Get the size of the file.
+            size_t getSize() const;
+
+            /**
+             * \brief Advise the system that a range of the file will be
+             * accessed soon.
+             *
+             * On POSIX systems, the pages of the range are read ahead
+             * asynchronously with madvise. On other systems, the content is
+             * already in memory and nothing is done.
+             *
+             * \param[in] offset offset of the range, in bytes.
+             * \param[in] length length of the range, in bytes. The range is
+             * clipped to the end of the file.
+             */
+            void prefetch(size_t offset, size_t length) const;
+        };
+    } // namespace TPGGraphBinaryFormat
+} // namespace File
+
+#endif
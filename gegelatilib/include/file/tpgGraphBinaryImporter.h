@@ -0,0 +1,99 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef TPG_GRAPH_BINARY_IMPORTER_H
+#define TPG_GRAPH_BINARY_IMPORTER_H
+
+#include <string>
+
+#include "tpg/tpgGraph.h"
+
+namespace File {
+    /**
+     * \brief Class used to import a TPGGraph from a file with the compact
+     * binary format described in the TPGGraphBinaryFormat namespace.
+     *
+     * The file is memory-mapped and its tables are used directly to build
+     * the TPGGraph, without any text parsing.
+     */
+    class TPGGraphBinaryImporter
+    {
+      protected:
+        /// Path of the file from which the TPGGraph is imported.
+        std::string filePath;
+
+        /// TPGGraph filled by the TPGGraphBinaryImporter.
+        TPG::TPGGraph& tpg;
+
+      public:
+        /**
+         * \brief Constructor for the importer.
+         *
+         * The TPGGraph is imported by the constructor.
+         *
+         * \param[in] filePath path to the binary file to import.
+         * \param[in] tpgref a reference to the TPGGraph to build from the
+         * binary file. Imported vertices are added to the existing ones.
+         * \throws std::runtime_error in case the file could not be opened, is
+         * not a valid binary TPG file, or was exported with an Environment
+         * different from the one of the TPGGraph.
+         */
+        TPGGraphBinaryImporter(const char* filePath, TPG::TPGGraph& tpgref)
+            : filePath{filePath}, tpg{tpgref}
+        {
+            importGraph();
+        };
+
+        /**
+         * \brief Set a new file for the importer.
+         *
+         * \param[in] newFilePath new path to the binary file to import.
+         */
+        void setNewFilePath(const char* newFilePath);
+
+        /**
+         * \brief Creates a TPGGraph from its description in a binary file.
+         *
+         * If the file contains the intron property of Lines, it is used
+         * instead of calling Program::identifyIntrons().
+         *
+         * \throws std::runtime_error in case the file could not be opened, is
+         * not a valid binary TPG file, or was exported with an Environment
+         * different from the one of the TPGGraph.
+         */
+        void importGraph();
+    };
+}; // namespace File
+
+#endif
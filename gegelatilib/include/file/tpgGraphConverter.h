@@ -0,0 +1,73 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef TPG_GRAPH_CONVERTER_H
+#define TPG_GRAPH_CONVERTER_H
+
+#include "environment.h"
+
+namespace File {
+    /**
+     * \brief Namespace containing functions to convert TPGGraph files between
+     * the dot format and the compact binary format.
+     */
+    namespace TPGGraphConverter {
+        /**
+         * \brief Convert a TPGGraph from the dot format to the binary format.
+         *
+         * \param[in] dotPath path of the dot file to convert.
+         * \param[in] binaryPath path of the binary file to write.
+         * \param[in] env the Environment of the TPGGraph.
+         * \param[in] withIntronMask whether the intron property of Lines is
+         * written in the binary file.
+         * \throws std::runtime_error if a file could not be read or written.
+         */
+        void dotToBinary(const char* dotPath, const char* binaryPath,
+                         const Environment& env, bool withIntronMask = true);
+
+        /**
+         * \brief Convert a TPGGraph from the binary format to the dot format.
+         *
+         * \param[in] binaryPath path of the binary file to convert.
+         * \param[in] dotPath path of the dot file to write.
+         * \param[in] env the Environment of the TPGGraph.
+         * \throws std::runtime_error if a file could not be read or written,
+         * or if the binary file was exported with a different Environment.
+         */
+        void binaryToDot(const char* binaryPath, const char* dotPath,
+                         const Environment& env);
+    } // namespace TPGGraphConverter
+} // namespace File
+
+#endif
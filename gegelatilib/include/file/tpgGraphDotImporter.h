@@ -43,9 +43,9 @@
 #include <inttypes.h>
 #include <map>
 #include <memory>
-#include <regex>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "learn/learningEnvironment.h"
 #include "tpg/tpgAction.h"
@@ -68,11 +68,32 @@ namespace File {
         std::ifstream pFile;
 
         /**
-         * \brief last Line read from file
+         * \brief Fixed-size buffer through which the file content is read.
          *
-         * helps to pass a line that didn't match any regex to another function
+         * The buffer is allocated once with MAX_READ_SIZE characters and
+         * refilled from pFile whenever all its characters were consumed.
          */
-        std::string lastLine;
+        std::vector<char> buffer;
+
+        /**
+         * \brief Index of the next character to read in buffer.
+         */
+        size_t bufferPos;
+
+        /**
+         * \brief Number of valid characters in buffer.
+         */
+        size_t bufferEnd;
+
+        /**
+         * \brief Line number of the next character to read (starting at 1).
+         */
+        uint64_t currentLine;
+
+        /**
+         * \brief Column number of the next character to read (starting at 1).
+         */
+        uint64_t currentColumn;
 
         /**
          * \brief The environment in which the TPGGRAPH will be built
@@ -119,6 +140,15 @@ namespace File {
          */
         std::map<uint64_t, uint64_t> actionLabel;
 
+        /**
+         * \brief Map associating program IDs to the destination of the first
+         * edge created with this program.
+         *
+         * This map is used to link a team to a program that was already
+         * declared with its destination, without searching through all edges.
+         */
+        std::map<uint64_t, const TPG::TPGVertex*> programDestination;
+
         /**
          * \brief string used to spot the end of a line in the program
          * description.
@@ -126,211 +156,105 @@ namespace File {
         static const std::string lineSeparator;
 
         /**
-         * \brief Contains the regex to identify a team declaration
+         * \brief Throws a std::runtime_error reporting the line and column of
+         * the next character to read.
          *
-         * this regex values "T([0-9]+)\\x20\\x5B.*\\x5D"
-         *
-         * Explanation :
-         *
-         * T([0-9]+)     looks for a T followed by a number. the number will be
-         * stored in a group
-         * \\x20\\x5B    looks for a succession of a whitespace and an opening
-         * bracket ('[')
-         * .*\\x5D		the following can be any sequence of character
-         * terminated by
-         * ]
-         *
-         * Example:
-         * T10 [fillcolor="#1199bb"]				Should pass
-         * P0 [fillcolor="#22cccc" shape=point]	Should not pass
+         * \param[in] message description of the error.
          */
-        static const std::string teamRegex;
+        [[noreturn]] void throwParseError(const std::string& message) const;
 
         /**
-         * \brief Contains the regex to identify a program declaration
-         *
-         * this regex values "P([0-9]+)\\x20\\x5B.*\\x5D"
+         * \brief Refills the buffer from the file.
          *
-         * Explanation :
-         *
-         * P([0-9]+)     looks for a P followed by a number. the number will be
-         * stored in a group
-         * \\x20\\x5B    looks for a succession of a whitespace and an opening
-         * bracket ('[')
-         * .*\\x5D		the following can be any sequence of character
-         * terminated by
-         * ]
-         *
-         * Example:
-         * P0 [fillcolor="#22cccc" shape=point]	Should pass
-         * T10 [fillcolor="#1199bb"]				Should not pass
+         * \return false if the end of file was reached and no character was
+         * read.
          */
-        static const std::string programRegex;
+        bool fillBuffer();
 
         /**
-         * \brief contains the regex to identify an instruction declaration
-         *
-         * this regex values "I([0-9]+)\\x20\\x5B.*label=\"(.*)\"\\x5D"
-         *
-         * Explanation :
+         * \brief Returns the next character of the file without consuming it.
          *
-         * I([0-9]+)     looks for a I followed by a number. the number will be
-         * stored in a group
-         * \\x20\\x5B    looks for a succession of a whitespace and an opening
-         * bracket ('[')
-         * .*			the following can be any sequence of character
-         * label=\"	    looks for the label declaration sequence.
-         * (.*)\"\\x5D	stores the content of the label in a group and  look for
-         * the ending sequence : "]
-         *
-         * Example:
-         * I0 [shape=box style=invis]			Should pass
-         * P0 [fillcolor="#22cccc" shape=point]	Should not pass
+         * \return the next character, or EOF at the end of the file.
          */
-        static const std::string instructionRegex;
+        int peekChar();
 
         /**
-         * \brief contains the regex to identify an action declaration
-         *
-         * this regex values "A([0-9]+)\\x20\\x5B.*=\"([0-9]+)\"\\x5D"
-         *
-         * Explanation :
-         *
-         * A([0-9]+)     looks for a A followed by a number. the number will be
-         * stored in a group
-         * \\x20\\x5B    looks for a succession of a whitespace and an opening
-         * bracket ('[')
-         * .*=\"	        the following can be any sequence of character
-         * ending with ="
-         * ([0-9]+)	    looks for a number and stores it into the next group
-         * \"\\x5D 		the end of the sequence is made of "]
+         * \brief Consumes and returns the next character of the file.
          *
-         * Example:
-         * A0 [shape=box style=invis]			Should pass
-         * P0 [fillcolor="#22cccc" shape=point]	Should not pass
+         * \return the consumed character, or EOF at the end of the file.
          */
-        static const std::string actionRegex;
+        int readChar();
 
         /**
-         * \brief contains the regex to identify a Program -> Instruction Link
-         *
-         * this regex values "P([0-9]+)\\x20->\\x20I([0-9]+).*"
-         *
-         * Explanation :
-         *
-         * P[0-9]+       looks for a P followed by a number. the number will be
-         * stored in a group
-         * \\x20	        looks for a whitespace
-         * ->			looxs for the sequence '->'
-         * \\x20 	    looks for a whitespace
-         * I[0-9]+       looks for a I followed by a number. the number will be
-         * stored in a group
-         * .*			the following can be any sequence of character
+         * \brief Consumes the given sequence of characters.
          *
-         * Example:
-         * P22 -> I22[style=invis]			Should pass
-         * T0 -> P22 -> A11					Should not pass
+         * \param[in] str the expected characters.
+         * \throws std::runtime_error if the next characters of the file
+         * differ from str.
          */
-        static const std::string linkProgramInstructionRegex;
+        void expect(const char* str);
 
         /**
-         * \brief contains the regex to identify a Team -> Program -> Action
-         * Link
-         *
-         * this regex values
-         * "T([0-9]+)\\x20->\\x20P([0-9]+)\\x20->\\x20A([0-9]+).*"
-         *
-         * Explanation :
-         *
-         * T[0-9]+       looks for a T followed by a number. the number will be
-         * stored in a group
-         * \\x20	        looks for a whitespace
-         * ->			looxs for the sequence '->'
-         * \\x20	        looks for a whitespace
-         * P[0-9]+       looks for a P followed by a number. the number will be
-         * stored in a group
-         * \\x20	        looks for a whitespace
-         * ->			looxs for the sequence '->'
-         * \\x20	        looks for a whitespace
-         * A[0-9]+       looks for a A followed by a number. the number will be
-         * stored in a group
-         * .*			the following can be any sequence of character
-         *
-         * Example:
-         * P22 -> I22[style=invis]			Should not pass
-         * T0 -> P22 -> A11					Should pass
+         * \brief Consumes spaces and tabulations.
          */
-        static const std::string linkProgramActionRegex;
+        void skipBlanks();
 
         /**
-         * \brief contains the regex to identify a Team -> Program -> Team Link
-         *
-         * this regex values
-         * "T([0-9]+)\\x20->\\x20P([0-9]+)\\x20->\\x20T([0-9]+).*"
-         *
-         * Explanation :
-         *
-         * T[0-9]+       looks for a T followed by a number. the number will be
-         * stored in a group
-         * \\x20	        looks for a whitespace
-         * ->			looxs for the sequence '->'
-         * \\x20	        looks for a whitespace
-         * P[0-9]+       looks for a P followed by a number. the number will be
-         * stored in a group
-         * \\x20	        looks for a whitespace
-         * ->			looxs for the sequence '->'
-         * \\x20	        looks for a whitespace
-         * T[0-9]+       looks for a T followed by a number. the number will be
-         * stored in a group *			    the following can be any sequence of
-         * character
-         *
-         * Example:
-         * P22 -> I22[style=invis]			Should not pass
-         * T0 -> P22 -> T11					Should pass
+         * \brief Consumes all characters up to and including the next end of
+         * line.
          */
-        static const std::string linkProgramTeamRegex;
+        void skipLine();
 
         /**
-         * \brief contains the regex to identify a Team -> Program Link
-         * the outgoing program vertex must already have been linked
-         *
-         * this regex values "T([0-9]+)\\x20->\\x20P([0-9]+)"
+         * \brief Reads an unsigned decimal integer.
          *
-         * Explanation :
+         * \throws std::runtime_error if the next character is not a digit.
+         */
+        uint64_t readUnsignedInteger();
+
+        /**
+         * \brief Reads a decimal integer with an optional minus sign.
          *
-         * T[0-9]+       looks for a T followed by a number. the number will be
-         * stored in a group
-         * \\x20	        looks for a whitespace
-         * ->			looxs for the sequence '->'
-         * \\x20	        looks for a whitespace
-         * P[0-9]+       looks for a P followed by a number. the number will be
-         * stored in a group
+         * \throws std::runtime_error if no digit follows the optional sign.
+         */
+        int64_t readSignedInteger();
+
+        /**
+         * \brief Consumes the attributes of a DOT attribute list, whose
+         * opening bracket was already consumed, up to its closing bracket.
          *
-         * Example:
-         * P22 -> I22[style=invis]			Should not pass
-         * T0 -> P22 -> T11					Should pass
+         * \param[in] key if not nullptr, the function stops after the opening
+         * quote of the value of this attribute and returns true.
+         * \return true if key was found, false otherwise.
          */
-        static const std::string addLinkProgramRegex;
+        bool skipAttributes(const char* key = nullptr);
 
         /**
          * \brief Reads the content of the operands and puts it in the line
          * passed in parameter
          *
-         * \param[in] str the string to parse
+         * Operands are stored with the format:
+         * op1_param1|op1_param2#...#opN_param1|opN_param2
+         *
          * \param[in] line the line to fill with the parsed informations
          */
-        void readOperands(std::string& str, Program::Line& line);
+        void readOperands(Program::Line& line);
 
         /**
-         * \brief Reads the content of a line and puts it in the line
-         * passed in parameter
+         * \brief Reads the lines of a program from the label of its
+         * instruction block.
+         *
+         * \param[in] progID the ID of the program read from the file.
          */
-        void readLine(std::smatch& matches);
+        void readLines(uint64_t progID);
 
         /**
-         * \brief Create a program from its dot content and import its constants
+         * \brief Create a program from its dot content and import its
+         * constants
+         *
+         * \param[in] progID the ID of the program read from the file.
          */
-        void readProgram(std::smatch& matches);
+        void readProgram(uint64_t progID);
 
         /**
          * \brief dumps the header of the dot file
@@ -342,35 +266,44 @@ namespace File {
 
         /**
          * \brief reads and creates a TPGTeam.
+         *
+         * \param[in] teamID the ID of the team read from the file.
          */
-        void readTeam(std::smatch& matches);
+        void readTeam(uint64_t teamID);
 
         /**
          * \brief reads and creates a TPGAction.
+         *
+         * \param[in] actionNumber the ID of the action read from the file.
          */
-        void readAction(std::smatch& matches);
-
-        /**
-         * \brief reads a link declaration and creates a team to action edge
-         */
-        void readLinkTeamProgramAction(std::smatch& matches);
+        void readAction(uint64_t actionNumber);
 
         /**
-         * \brief reads a link declaration and creates a team to team edge
+         * \brief reads a link declaration starting with a team and creates
+         * the corresponding edge.
+         *
+         * Supported declarations are T -> P -> A, T -> P -> T and T -> P, where
+         * the program P must already have been linked to its destination.
+         *
+         * \param[in] teamID the ID of the source team read from the file.
          */
-        void readLinkTeamProgramTeam(std::smatch& matches);
+        void readLink(uint64_t teamID);
 
         /**
-         * \brief reads a link declaration and creates a team to program's
-         * destination edge.
+         * \brief Creates an edge and remembers the destination of its
+         * program.
          */
-        void readLinkTeamProgram(std::smatch& matches);
+        void addEdge(const TPG::TPGVertex& src, const TPG::TPGVertex& dest,
+                     uint64_t progID);
 
         /**
-         *	\brief reads a single line of the file
+         *	\brief reads a single statement of the file
          *
-         *	\return true if the line read matched any of the line
-         *characteristics specified as regexs.
+         *	\return true if the statement read is one of the node or link
+         *	declarations produced by the TPGGraphDotExporter.
+         *	\throws std::ifstream::failure if the end of file is reached before
+         *	the end of the graph.
+         *	\throws std::runtime_error if a declaration is malformed.
          */
         bool readLineFromFile();
 
@@ -389,7 +322,8 @@ namespace File {
          */
         TPGGraphDotImporter(const char* filePath, Environment environment,
                             TPG::TPGGraph& tpgref)
-            : env{environment}, tpg{tpgref}
+            : buffer(MAX_READ_SIZE), bufferPos{0}, bufferEnd{0},
+              currentLine{1}, currentColumn{1}, env{environment}, tpg{tpgref}
         {
             pFile.open(filePath);
             if (!pFile.is_open()) {
@@ -400,8 +334,7 @@ namespace File {
         };
 
         /**
-         * \brief Maximum number of characters that can be read in a single
-         * line.
+         * \brief Size of the buffer used to read the file.
          */
         static const unsigned int MAX_READ_SIZE = 4096;
 
@@ -429,6 +362,13 @@ namespace File {
 
         /**
          * \brief Creates a TPG Graph from its description in a .dot file
+         *
+         * The file is parsed in a single pass through a fixed-size buffer.
+         *
+         * \throws std::ifstream::failure if the file ends before the end of
+         * the graph.
+         * \throws std::runtime_error with the line and column of the error if
+         * a declaration of the file is malformed.
          */
         void importGraph();
     };
@@ -46,6 +46,10 @@
 #ifndef GEGELATI_H
 #define GEGELATI_H
 
+#include <util/profiler.h>
+#include <util/cycleCounter.h>
+#include <util/shardedCounter.h>
+#include <util/threadAffinity.h>
 #include <util/timestamp.h>
 
 #include <data/array2DWrapper.h>
@@ -59,7 +63,13 @@
 #include <data/primitiveTypeArray2D.h>
 #include <data/untypedSharedPtr.h>
 
+#include <file/learningAgentCheckpoint.h>
+#include <file/mappedTPGPolicy.h>
 #include <file/parametersParser.h>
+#include <file/tpgGraphBinaryExporter.h>
+#include <file/tpgGraphBinaryFormat.h>
+#include <file/tpgGraphBinaryImporter.h>
+#include <file/tpgGraphConverter.h>
 #include <file/tpgGraphDotExporter.h>
 #include <file/tpgGraphDotImporter.h>
 
@@ -70,11 +80,18 @@
 #include <instructions/set.h>
 
 #include <learn/evaluationResult.h>
+#include <learn/inferenceCostModel.h>
+#include <learn/islandLearningAgent.h>
 #include <learn/job.h>
 #include <learn/learningAgent.h>
 #include <learn/learningEnvironment.h>
 #include <learn/learningParameters.h>
+#include <learn/multiProcessLearningAgent.h>
+#include <learn/observationCache.h>
 #include <learn/parallelLearningAgent.h>
+#include <learn/resultsTable.h>
+#include <learn/sharedMemoryChannel.h>
+#include <learn/sharedMemoryLearningEnvironment.h>
 
 #include <learn/adversarialEvaluationResult.h>
 #include <learn/adversarialJob.h>
@@ -84,11 +101,13 @@
 #include <learn/classificationEvaluationResult.h>
 #include <learn/classificationLearningAgent.h>
 #include <learn/classificationLearningEnvironment.h>
+#include <learn/mappedClassificationLearningEnvironment.h>
 
 #include <log/cycleDetectionLALogger.h>
 #include <log/laBasicLogger.h>
 #include <log/laLogger.h>
 #include <log/laPolicyStatsLogger.h>
+#include <log/laProfilerLogger.h>
 #include <log/logger.h>
 
 #include <mutator/lineMutator.h>
@@ -101,6 +120,7 @@
 #include <program/program.h>
 #include <program/programEngine.h>
 #include <program/programExecutionEngine.h>
+#include <program/programExecutionEngineInstrumented.h>
 
 #include <tpg/policyStats.h>
 #include <tpg/tpgAbstractEngine.h>
@@ -126,6 +146,7 @@
 #include <codeGen/tpgGenerationEngineFactory.h>
 #include <codeGen/tpgStackGenerationEngine.h>
 #include <codeGen/tpgSwitchGenerationEngine.h>
+#include <codeGen/tpgTableGenerationEngine.h>
 #endif
 
 #include <archive.h>
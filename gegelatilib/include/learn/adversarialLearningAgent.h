@@ -93,12 +93,13 @@ namespace Learn {
          * several roots in jobs for adversarial.
          *
          * This method gathers results in a map linking root to result, and
-         * then reverts the map to match the "results" argument.
+         * then fills the "results" ResultsTable in the order of the roots of
+         * the TPGGraph.
          * The archive will just be merged like in ParallelLearningAgent.
          *
          * Note that if there is a "posOfStudiedRoot" different from -1 in the
          * jobs, only the EvaluationResult of the posOfStudiedRoot will be
-         * written to the results map. And the results of the other roots within
+         * written to the results table. And the results of the other roots within
          * the Job will be discarded.
          * The reason is that when roots face champions, the champions
          * shouldn't have their scores updated, or as they encounter many
@@ -106,7 +107,8 @@ namespace Learn {
          *
          * @param[in] resultsPerJobMap map linking the job number with its
          * results and itself.
-         * @param[out] results map linking single results to their root vertex.
+         * @param[out] results ResultsTable linking single results to their
+         * root vertex.
          * @param[in,out] archiveMap map linking the job number with its
          * gathered archive. These archives will later be merged with the ones
          * of the other jobs.
@@ -115,8 +117,7 @@ namespace Learn {
             std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>,
                                          std::shared_ptr<Job>>>&
                 resultsPerJobMap,
-            std::multimap<std::shared_ptr<EvaluationResult>,
-                          const TPG::TPGVertex*>& results,
+            ResultsTable& results,
             std::map<uint64_t, Archive*>& archiveMap) override;
 
       public:
@@ -149,8 +150,8 @@ namespace Learn {
          * **Replaces the function from the base class ParallelLearningAgent.**
          *
          * This method calls the evaluateJob method for every root TPGVertex
-         * of the TPGGraph. The method returns a sorted map associating each
-         * root vertex to its average score, in ascending order of score.
+         * of the TPGGraph. The method returns a ResultsTable associating each
+         * root vertex to its average score, in the order of the TPGGraph roots.
          * Sequential or parallel, both situations should output the same
          * result.
          *
@@ -158,10 +159,8 @@ namespace Learn {
          * generation. \param[in] mode the LearningMode to use during the policy
          * evaluation.
          */
-        std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                      const TPG::TPGVertex*>
-        evaluateAllRoots(uint64_t generationNumber,
-                         Learn::LearningMode mode) override;
+        ResultsTable evaluateAllRoots(uint64_t generationNumber,
+                                      Learn::LearningMode mode) override;
 
         /**
          * \brief Evaluates policy starting from the given root, taking
@@ -239,6 +238,28 @@ namespace Learn {
         std::shared_ptr<Learn::Job> makeJob(const TPG::TPGVertex* vertex,
                                             Learn::LearningMode mode, int idx,
                                             TPG::TPGGraph* tpgGraph) override;
+
+        /**
+         * \brief Override of the LearningAgent::canPipelineValidation
+         * function.
+         *
+         * Adversarial jobs gather several roots and are evaluated with
+         * champions of the TPGGraph, so the validation is never pipelined.
+         *
+         * \return false.
+         */
+        bool canPipelineValidation() const override;
+
+        /**
+         * \brief Override of the LearningAgent::canInterleaveEpisodes
+         * function.
+         *
+         * Adversarial jobs gather several roots playing in the same
+         * episode, which are not supported by evaluateJobsInterleaved.
+         *
+         * \return false.
+         */
+        bool canInterleaveEpisodes() const override;
     };
 } // namespace Learn
 
@@ -40,6 +40,7 @@
 #include <numeric>
 #include <stdexcept>
 #include <type_traits>
+#include <unordered_set>
 #include <vector>
 
 #include "learn/classificationEvaluationResult.h"
@@ -47,6 +48,7 @@
 #include "learn/evaluationResult.h"
 #include "learn/learningAgent.h"
 #include "learn/parallelLearningAgent.h"
+#include "learn/resultsTable.h"
 #include <data/hash.h>
 
 namespace Learn {
@@ -93,6 +95,12 @@ namespace Learn {
             const TPG::TPGFactory& factory = TPG::TPGFactory())
             : BaseLearningAgent(le, iSet, p, factory){};
 
+        /// Destructor, waiting for the pending validation.
+        virtual ~ClassificationLearningAgent()
+        {
+            this->joinValidation();
+        };
+
         /**
          * \brief Specialization of the evaluateJob method for classification
          * purposes.
@@ -106,6 +114,18 @@ namespace Learn {
             uint64_t generationNumber, LearningMode mode,
             LearningEnvironment& le) const override;
 
+        /**
+         * \brief Episodes are never interleaved, since the evaluation of
+         * classification results needs the whole episode loop of
+         * evaluateJob.
+         *
+         * \return false.
+         */
+        bool canInterleaveEpisodes() const override
+        {
+            return false;
+        };
+
         /**
          * \brief Specialization of the decimateWorstRoots method for
          * classification purposes.
@@ -130,12 +150,10 @@ namespace Learn {
          * number of root is preserved during the decimation process, all roots
          * are preserved based on their general score.
          *
-         * The results map is updated by the method to keep only the results of
-         * non-decimated roots.
+         * The results table is updated by the method to keep only the results
+         * of non-decimated roots.
          */
-        void decimateWorstRoots(
-            std::multimap<std::shared_ptr<EvaluationResult>,
-                          const TPG::TPGVertex*>& results) override;
+        void decimateWorstRoots(ResultsTable& results) override;
     };
 
     template <class BaseLearningAgent>
@@ -153,39 +171,36 @@ namespace Learn {
         // Skip the root evaluation process if enough evaluations were already
         // performed. In the evaluation mode only.
         std::shared_ptr<Learn::EvaluationResult> previousEval;
-        if (mode == LearningMode::TRAINING &&
+        if (mode == LearningMode::TRAINING && !job.isPartial() &&
             this->isRootEvalSkipped(*root, previousEval)) {
             return previousEval;
         }
 
+        // Iterations done by the job
+        uint64_t firstIteration = job.getFirstIteration();
+        uint64_t nbIterations =
+            (job.isPartial()) ? job.getNbIterations()
+                              : this->params.nbIterationsPerPolicyEvaluation;
+
         // Init results
         std::vector<double> result(this->learningEnvironment.getNbActions(),
                                    0.0);
         std::vector<size_t> nbEvalPerClass(
             this->learningEnvironment.getNbActions(), 0);
+        double inferenceCost = 0.0;
+        InferenceCostModel::ProgramCostCache programCosts;
 
         // Evaluate nbIteration times
-        for (auto i = 0; i < this->params.nbIterationsPerPolicyEvaluation;
+        for (uint64_t i = firstIteration; i < firstIteration + nbIterations;
              i++) {
             // Compute a Hash
             Data::Hash<uint64_t> hasher;
             uint64_t hash = hasher(generationNumber) ^ hasher(i);
 
-            // Reset the learning Environment
-            le.reset(hash, mode);
-
-            uint64_t nbActions = 0;
-            while (!le.isTerminal() &&
-                   nbActions < this->params.maxNbActionsPerEval) {
-                // Get the action
-                uint64_t actionID =
-                    ((const TPG::TPGAction*)tee.executeFromRoot(*root).back())
-                        ->getActionID();
-                // Do it
-                le.doAction(actionID);
-                // Count actions
-                nbActions++;
-            }
+            // Evaluate the episode
+            inferenceCost +=
+                this->evaluateEpisode(tee, *job.getExecutedRoot(), le, hash,
+                                      mode, 0, 0, programCosts);
 
             // Update results
             const auto& classificationTable =
@@ -226,14 +241,16 @@ namespace Learn {
 
         // Before returning the EvaluationResult, divide the result per class by
         // the number of iteration
-        const LearningParameters& p = this->params;
-        std::for_each(result.begin(), result.end(), [p](double& val) {
-            val /= (double)p.nbIterationsPerPolicyEvaluation;
-        });
+        std::for_each(result.begin(), result.end(),
+                      [nbIterations](double& val) {
+                          val /= (double)nbIterations;
+                      });
 
         // Create the EvaluationResult
         auto evaluationResult = std::shared_ptr<EvaluationResult>(
             new ClassificationEvaluationResult(result, nbEvalPerClass));
+        evaluationResult->setInferenceCost(inferenceCost /
+                                           (double)nbIterations);
 
         // Combine it with previous one if any
         if (previousEval != nullptr) {
@@ -244,12 +261,12 @@ namespace Learn {
 
     template <class BaseLearningAgent>
     void ClassificationLearningAgent<BaseLearningAgent>::decimateWorstRoots(
-        std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>&
-            results)
+        ResultsTable& results)
     {
         // Check that results are ClassificationEvaluationResults.
         // (also throws on empty results)
-        const EvaluationResult* result = results.begin()->first.get();
+        const EvaluationResult* result =
+            results.getEvaluationResult(0).get();
         if (typeid(ClassificationEvaluationResult) != typeid(*result)) {
             throw std::runtime_error(
                 "ClassificationLearningAgent can not decimate worst roots for "
@@ -272,89 +289,93 @@ namespace Learn {
             nbRootsToKeep -
             this->learningEnvironment.getNbActions() * nbRootsKeptPerClass;
 
-        // Build a list of roots to keep
-        std::vector<const TPG::TPGVertex*> rootsToKeep;
+        // Rank rows once on their general score, penalized with their
+        // inference cost if needed. This rank is used to break ties between
+        // equal per-class scores.
+        std::vector<size_t> sortedRows =
+            this->getWorstRowsForSelection(results, results.size());
+        std::vector<size_t> generalRank(results.size());
+        for (size_t rank = 0; rank < sortedRows.size(); rank++) {
+            generalRank[sortedRows[rank]] = rank;
+        }
+
+        // Build a list of rows to keep
+        std::vector<bool> isRowKept(results.size(), false);
+        uint64_t nbRowsKept = 0;
 
         // Insert roots to keep per class
+        std::vector<size_t> rows(results.size());
         for (uint64_t classIdx = 0;
              classIdx < this->learningEnvironment.getNbActions(); classIdx++) {
-            // Fill a map with the roots and the score of the specific class as
-            // ID.
-            std::multimap<double, const TPG::TPGVertex*> sortedRoot;
-            std::for_each(
-                results.begin(), results.end(),
-                [&sortedRoot,
-                 &classIdx](const std::pair<std::shared_ptr<EvaluationResult>,
-                                            const TPG::TPGVertex*>& res) {
-                    sortedRoot.emplace(
-                        ((ClassificationEvaluationResult*)res.first.get())
-                            ->getScorePerClass()
-                            .at(classIdx),
-                        res.second);
+            // Partially sort the rows on the score of the specific class.
+            size_t nbRanked = std::min((size_t)nbRootsKeptPerClass, rows.size());
+            std::iota(rows.begin(), rows.end(), 0);
+            std::partial_sort(
+                rows.begin(), rows.begin() + nbRanked, rows.end(),
+                [&results, &generalRank, classIdx](size_t a, size_t b) {
+                    double scoreA = results.getScorePerClass(a, classIdx);
+                    double scoreB = results.getScorePerClass(b, classIdx);
+                    return (scoreA > scoreB) ||
+                           (!(scoreA < scoreB) &&
+                            generalRank[a] > generalRank[b]);
                 });
 
             // Keep the best nbRootsKeptPerClass (or less for reasons explained
             // in the loop)
-            auto iterator = sortedRoot.rbegin();
-            for (auto i = 0; i < nbRootsKeptPerClass; i++) {
+            for (auto i = 0; i < nbRanked; i++) {
                 // If the root is not already marked to be kept
-                if (std::find(rootsToKeep.begin(), rootsToKeep.end(),
-                              iterator->second) == rootsToKeep.end()) {
-                    rootsToKeep.push_back(iterator->second);
-                }
-                // Advance the iterator no matter what.
                 // This means that if a root scores well for several classes
                 // it is kept only once anyway, but additional roots will not
                 // be kept for any of the concerned class.
-                iterator++;
+                if (!isRowKept[rows[i]]) {
+                    isRowKept[rows[i]] = true;
+                    nbRowsKept++;
+                }
             }
         }
 
         // Insert remaining roots to keep
-        auto iterator = results.rbegin();
-        while (rootsToKeep.size() < nbRootsToKeep &&
-               iterator != results.rend()) {
+        auto iterator = sortedRows.rbegin();
+        while (nbRowsKept < nbRootsToKeep && iterator != sortedRows.rend()) {
             // If the root is not already marked to be kept
-            if (std::find(rootsToKeep.begin(), rootsToKeep.end(),
-                          iterator->second) == rootsToKeep.end()) {
-                rootsToKeep.push_back(iterator->second);
+            if (!isRowKept[*iterator]) {
+                isRowKept[*iterator] = true;
+                nbRowsKept++;
             }
             // Advance the iterator no matter what.
             iterator++;
         }
 
+        std::unordered_set<const TPG::TPGVertex*> rootsToKeep;
+        for (size_t row = 0; row < results.size(); row++) {
+            if (isRowKept[row]) {
+                rootsToKeep.insert(results.getRoot(row));
+            }
+        }
+
         // Do the removal.
         // Because of potential root actions, the preserved number of roots
         // may be higher than the given ratio.
+        std::unordered_set<const TPG::TPGVertex*> removedRoots;
         auto allRoots = this->tpg->getRootVertices();
-        auto& tpgRef = this->tpg;
-        auto& resultsPerRootRef = this->resultsPerRoot;
-        std::for_each(
-            allRoots.begin(), allRoots.end(),
-            [&rootsToKeep, &tpgRef, &resultsPerRootRef,
-             &results](const TPG::TPGVertex* vert) {
-                // Do not remove actions
-                if (dynamic_cast<const TPG::TPGAction*>(vert) == nullptr &&
-                    std::find(rootsToKeep.begin(), rootsToKeep.end(), vert) ==
-                        rootsToKeep.end()) {
-                    tpgRef->removeVertex(*vert);
-
-                    // Keep only results of non-decimated roots.
-                    resultsPerRootRef.erase(vert);
-
-                    // Update results also
-                    std::multimap<std::shared_ptr<EvaluationResult>,
-                                  const TPG::TPGVertex*>::iterator iter =
-                        results.begin();
-                    while (iter != results.end()) {
-                        if (iter->second == vert) {
-                            results.erase(iter);
-                            break;
-                        }
-                        iter++;
-                    }
-                }
-            });
+        for (const TPG::TPGVertex* vert : allRoots) {
+            // Do not remove actions
+            if (dynamic_cast<const TPG::TPGAction*>(vert) == nullptr &&
+                rootsToKeep.count(vert) == 0) {
+                this->tpg->removeVertex(*vert);
+                removedRoots.insert(vert);
+
+                // Keep only results of non-decimated roots.
+                this->resultsPerRoot.erase(vert);
+            }
+        }
+
+        // Update results also
+        std::vector<bool> removedRows(results.size());
+        for (size_t row = 0; row < results.size(); row++) {
+            removedRows[row] = removedRoots.count(results.getRoot(row)) != 0;
+        }
+        results.removeRows(removedRows);
     }
 }; // namespace Learn
 
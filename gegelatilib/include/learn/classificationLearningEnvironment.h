@@ -104,6 +104,31 @@ namespace Learn {
          */
         virtual double getScore() const override;
 
+        /**
+         * \brief Get the label of the current observation.
+         *
+         * Observations of a ClassificationLearningEnvironment are labelled
+         * with the currentClass attribute. Child classes whose samples do not
+         * depend on the guesses of the LearningAgent only need to override
+         * isActionIndependent to have their observations replayed.
+         *
+         * \return the currentClass attribute.
+         */
+        virtual uint64_t getObservationLabel() const override;
+
+        /**
+         * \brief Resets to zero the classificationTable.
+         */
+        virtual void resetReplay(size_t seed, LearningMode mode,
+                                 uint16_t iterationNumber,
+                                 uint64_t generationNumber) override;
+
+        /**
+         * \brief Increments the classificationTable for the given label and
+         * action.
+         */
+        virtual void replayAction(uint64_t label, uint64_t actionID) override;
+
         /**
          * \brief Default implementation of the reset.
          *
@@ -57,6 +57,9 @@ namespace Learn {
         /// Number of evaluation leading to this result.
         size_t nbEvaluation;
 
+        /// Average modeled cost of the inferences of the policy, per action.
+        double inferenceCost = 0.0;
+
       public:
         /**
          * \brief Deleted default constructor.
@@ -91,10 +94,30 @@ namespace Learn {
          */
         virtual size_t getNbEvaluation() const;
 
+        /**
+         * \brief Get the average modeled cost of the inferences of the
+         * evaluated policy, per action.
+         *
+         * The cost is 0.0 unless it was computed with an InferenceCostModel
+         * during the evaluation.
+         */
+        double getInferenceCost() const;
+
+        /**
+         * \brief Set the average modeled cost of the inferences of the
+         * evaluated policy, per action.
+         *
+         * \param[in] cost the new inference cost.
+         */
+        void setInferenceCost(double cost);
+
         /**
          * \brief Polymorphic addition assignement operator for
          * EvaluationResult.
          *
+         * Inference costs of the two EvaluationResult are averaged, weighted
+         * with their number of evaluations.
+         *
          * \throw std::runtime_error in case the other EvaluationResult and
          * this have a different typeid.
          */
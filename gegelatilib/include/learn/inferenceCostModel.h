@@ -0,0 +1,122 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef INFERENCE_COST_MODEL_H
+#define INFERENCE_COST_MODEL_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "program/program.h"
+#include "tpg/tpgVertex.h"
+
+namespace Learn {
+    /**
+     * \brief Model of the cost of TPGGraph inferences.
+     *
+     * The cost of an inference is the sum of a fixed cost for each team
+     * visited in its trace, and of the cost of the non-intron lines of all
+     * programs evaluated while visiting these teams, each line costing the
+     * cost of its instruction. Following the TPGExecutionEngine, the edges
+     * leading to a team already visited during the inference are not
+     * evaluated.
+     *
+     * Costs of instructions can be measured beforehand on the deployment
+     * target, for example with the average durations per instruction of the
+     * TPG::ExecutionStats of a timed execution.
+     *
+     * Since the same Program are evaluated by all inferences of a policy,
+     * their costs can be memoized in a ProgramCostCache, valid as long as the
+     * Program are not modified or deleted.
+     */
+    class InferenceCostModel
+    {
+      protected:
+        /// Cost of each visited team.
+        double teamCost;
+
+        /// Cost of the instructions, indexed by instruction index.
+        std::vector<double> instructionCosts;
+
+      public:
+        /// Costs of Program, memoized by getTraceCost().
+        typedef std::unordered_map<const Program::Program*, double>
+            ProgramCostCache;
+
+        /**
+         * \brief Constructor of the model.
+         *
+         * \param[in] teamCost the cost of each visited team.
+         * \param[in] instructionCosts the cost of each instruction of the
+         * Instructions::Set, indexed by instruction index. Instructions
+         * without cost in this vector cost 1.0.
+         */
+        explicit InferenceCostModel(
+            double teamCost = 1.0,
+            const std::vector<double>& instructionCosts = {});
+
+        /// Get the cost of an instruction.
+        double getInstructionCost(uint64_t instructionIndex) const;
+
+        /**
+         * \brief Get the cost of an execution of a Program.
+         *
+         * \param[in] program the Program whose non-intron lines are summed.
+         */
+        double getProgramCost(const Program::Program& program) const;
+
+        /**
+         * \brief Get the cost of an inference from its trace.
+         *
+         * \param[in] trace the vertices visited by the inference, as returned
+         * by TPG::TPGExecutionEngine::executeFromRoot(), from the root to the
+         * action.
+         */
+        double getTraceCost(
+            const std::vector<const TPG::TPGVertex*>& trace) const;
+
+        /**
+         * \brief Get the cost of an inference from its trace, memoizing the
+         * cost of evaluated Program.
+         *
+         * \param[in] trace the vertices visited by the inference.
+         * \param[in,out] programCosts the costs of Program already computed,
+         * where missing costs are added.
+         */
+        double getTraceCost(const std::vector<const TPG::TPGVertex*>& trace,
+                            ProgramCostCache& programCosts) const;
+    };
+} // namespace Learn
+
+#endif
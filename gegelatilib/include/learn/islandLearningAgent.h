@@ -0,0 +1,188 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef ISLAND_LEARNING_AGENT_H
+#define ISLAND_LEARNING_AGENT_H
+
+#include <memory>
+#include <vector>
+
+#include "instructions/set.h"
+#include "tpg/tpgFactory.h"
+#include "tpg/tpgVertex.h"
+
+#include "learn/evaluationResult.h"
+#include "learn/learningAgent.h"
+#include "learn/learningEnvironment.h"
+#include "learn/learningParameters.h"
+
+namespace Learn {
+    /**
+     * \brief Class used to train several independent TPGGraph populations,
+     * called islands, in parallel.
+     *
+     * Each island is a LearningAgent with its own TPGGraph, Archive, RNG and
+     * copy of the LearningEnvironment. At each generation, islands are
+     * trained concurrently by up to params.nbThreads threads, each island
+     * being trained sequentially by a single thread. Islands only
+     * synchronize at the end of each generation.
+     *
+     * Every params.migrationInterval generations, the params.nbMigrants best
+     * roots of each island, with all the TPGVertex reachable from them, are
+     * copied into the next island (following a ring topology). Migrants are
+     * evaluated in their new island at the next generation.
+     *
+     * Since islands are independent between migrations, the training is
+     * deterministic whatever the number of threads.
+     */
+    class IslandLearningAgent
+    {
+      protected:
+        /// LearningEnvironment given to the constructor, used by the first
+        /// island.
+        LearningEnvironment& learningEnvironment;
+
+        /// Parameters for the learning process.
+        LearningParameters params;
+
+        /// Copies of the LearningEnvironment used by the other islands.
+        std::vector<std::unique_ptr<LearningEnvironment>> islandEnvironments;
+
+        /// LearningAgent of each island.
+        std::vector<std::unique_ptr<LearningAgent>> islands;
+
+        /// Number of islands trained concurrently.
+        uint64_t maxNbThreads;
+
+      public:
+        /**
+         * \brief Constructor for IslandLearningAgent.
+         *
+         * If the LearningEnvironment is not copyable, all islands share it
+         * and are trained sequentially.
+         *
+         * \param[in] le The LearningEnvironment for the TPG.
+         * \param[in] iSet Set of Instruction used to compose Programs in the
+         *            learning process.
+         * \param[in] p The LearningParameters for the IslandLearningAgent.
+         * \param[in] factory The TPGFactory used to create the TPGGraph of
+         * each island. A default TPGFactory is used if none is provided.
+         * \throw std::runtime_error if p.nbIslands is 0.
+         */
+        IslandLearningAgent(LearningEnvironment& le,
+                            const Instructions::Set& iSet,
+                            const LearningParameters& p,
+                            const TPG::TPGFactory& factory = TPG::TPGFactory());
+
+        /// Default destructor for polymorphism
+        virtual ~IslandLearningAgent() = default;
+
+        /**
+         * \brief Get the number of islands.
+         * \return the number of LearningAgent managed by the
+         * IslandLearningAgent.
+         */
+        size_t getNbIslands() const;
+
+        /**
+         * \brief Get the LearningAgent of an island.
+         *
+         * The returned LearningAgent can be used to add LALogger, or to
+         * access the TPGGraph of the island.
+         *
+         * \param[in] idx the index of the island.
+         * \return a reference to the LearningAgent of the island.
+         * \throw std::out_of_range if idx is not a valid island index.
+         */
+        LearningAgent& getIsland(size_t idx);
+
+        /**
+         * \brief Initialize all islands.
+         *
+         * Island i is initialized with seed + i, so that each island has its
+         * own RNG stream.
+         *
+         * \param[in] seed the seed used to initialize the islands.
+         */
+        void init(uint64_t seed = 0);
+
+        /**
+         * \brief Train all islands for one generation.
+         *
+         * Islands are trained concurrently, then migrations are done if the
+         * generation number calls for it.
+         *
+         * \param[in] generationNumber the integer number of the current
+         * generation.
+         */
+        virtual void trainOneGeneration(uint64_t generationNumber);
+
+        /**
+         * \brief Train all islands for params.nbGenerations generations.
+         *
+         * \param[in] altTraining a reference to a boolean value that can be
+         * used to halt the training process before its completion.
+         * \return the number of completed generations.
+         */
+        uint64_t train(volatile bool& altTraining);
+
+        /**
+         * \brief Copy the best roots of each island into the next island.
+         *
+         * For each island, the params.nbMigrants root TPGTeam with the best
+         * EvaluationResult are copied, with their reachable subgraph, into
+         * the next island using TPG::TPGGraph::importSubGraph. Roots without
+         * EvaluationResult are not considered.
+         */
+        void migrate();
+
+        /**
+         * \brief Get the index of the island holding the best root.
+         * \return the index of the island whose best root has the highest
+         * EvaluationResult.
+         */
+        size_t getBestIsland() const;
+
+        /**
+         * \brief Get the best root TPG::Vertex encountered in all islands.
+         *
+         * \return the bestRoot of the island returned by getBestIsland().
+         */
+        const std::pair<const TPG::TPGVertex*,
+                        std::shared_ptr<EvaluationResult>>&
+        getBestRoot() const;
+    };
+} // namespace Learn
+
+#endif
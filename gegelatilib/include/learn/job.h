@@ -67,6 +67,24 @@ namespace Learn {
          */
         const uint64_t archiveSeed;
 
+        /**
+         * Index of the first iteration of the policy evaluation done by this
+         * job.
+         */
+        const uint64_t firstIteration;
+
+        /**
+         * Number of iterations of the policy evaluation done by this job, or
+         * 0 if the job does all iterations.
+         */
+        const uint64_t nbIterations;
+
+        /**
+         * Vertex executed to evaluate the root, when the job is evaluated
+         * with a replica of the TPGGraph, or nullptr.
+         */
+        const TPG::TPGVertex* executedRoot;
+
       public:
         /// Deleted default constructor.
         Job() = delete;
@@ -79,10 +97,17 @@ namespace Learn {
          * @param[in] archiveSeed The archive seed that will be used with this
          * job.
          * @param[in] idx The index of this job.
+         * @param[in] firstIteration The index of the first iteration of the
+         * policy evaluation done by this job.
+         * @param[in] nbIterations The number of iterations done by this job,
+         * or 0 if the job does all the iterations of the policy evaluation.
          */
         Job(const TPG::TPGVertex* root, uint64_t archiveSeed = 0,
-            uint64_t idx = 0)
-            : root(root), archiveSeed(archiveSeed), idx(idx)
+            uint64_t idx = 0, uint64_t firstIteration = 0,
+            uint64_t nbIterations = 0)
+            : root(root), archiveSeed(archiveSeed), idx(idx),
+              firstIteration(firstIteration), nbIterations(nbIterations),
+              executedRoot(nullptr)
         {
         }
 
@@ -109,6 +134,51 @@ namespace Learn {
          * @return The root embedded by the job.
          */
         virtual const TPG::TPGVertex* getRoot() const;
+
+        /**
+         * \brief Getter of the vertex executed to evaluate the root.
+         *
+         * Results of the evaluation are still associated to the root.
+         *
+         * @return The executed vertex, which is the root unless it was set
+         * with setExecutedRoot().
+         */
+        const TPG::TPGVertex* getExecutedRoot() const;
+
+        /**
+         * \brief Set the vertex executed to evaluate the root.
+         *
+         * @param[in] vertex The copy of the root in a replica of the TPGGraph
+         * holding the root.
+         */
+        void setExecutedRoot(const TPG::TPGVertex* vertex);
+
+        /**
+         * \brief Getter of firstIteration.
+         *
+         * @return The index of the first iteration done by the job.
+         */
+        uint64_t getFirstIteration() const;
+
+        /**
+         * \brief Getter of nbIterations.
+         *
+         * @return The number of iterations done by the job, or 0 if the job
+         * does all the iterations of the policy evaluation.
+         */
+        uint64_t getNbIterations() const;
+
+        /**
+         * \brief Check whether the job does only a part of the iterations of
+         * the policy evaluation.
+         *
+         * Results of partial jobs are not combined with previous results of
+         * their root, and must be folded with the results of the other
+         * partial jobs of the same root.
+         *
+         * @return true if nbIterations is not 0.
+         */
+        bool isPartial() const;
     };
 } // namespace Learn
 
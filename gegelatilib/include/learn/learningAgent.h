@@ -39,8 +39,13 @@
 #ifndef LEARNING_AGENT_H
 #define LEARNING_AGENT_H
 
+#include <chrono>
+#include <functional>
+#include <future>
 #include <map>
+#include <mutex>
 #include <queue>
+#include <unordered_map>
 
 #include "archive.h"
 #include "environment.h"
@@ -51,9 +56,12 @@
 #include "tpg/tpgGraph.h"
 
 #include "learn/evaluationResult.h"
+#include "learn/inferenceCostModel.h"
 #include "learn/job.h"
 #include "learn/learningEnvironment.h"
 #include "learn/learningParameters.h"
+#include "learn/observationCache.h"
+#include "learn/resultsTable.h"
 namespace Learn {
 
     /**
@@ -99,6 +107,19 @@ namespace Learn {
         std::map<const TPG::TPGVertex*, std::shared_ptr<EvaluationResult>>
             resultsPerRoot;
 
+        /**
+         * \brief Map associating each root created by the last call to
+         * TPGMutator::populateTPG() to the root it was cloned from.
+         *
+         * This map is used by derived classes to estimate the cost of
+         * evaluating new roots from the cost of their parent.
+         */
+        std::map<const TPG::TPGVertex*, const TPG::TPGVertex*> rootParents;
+
+        /// Mutex protecting the resultsPerRoot map when it is updated while
+        /// other threads evaluate roots (e.g. during steady-state training).
+        mutable std::mutex resultsPerRootMutex;
+
         /// Random Number Generator for this Learning Agent
         Mutator::RNG rng;
 
@@ -118,6 +139,46 @@ namespace Learn {
         /// generation
         double bestScoreLastGen = 0.0;
 
+        /**
+         * \brief Results of the validation of the last generation, evaluated
+         * in background when params.pipelineValidation is true.
+         *
+         * The future is valid from the end of trainOneGeneration() until the
+         * results are delivered to the loggers by waitForValidation().
+         */
+        std::future<ResultsTable> pendingValidation;
+
+        /**
+         * \brief Time at which the last validation was completed.
+         *
+         * With pipelined validation, the results are delivered to the
+         * loggers after the populating step of the next generation, so the
+         * loggers can not measure the validation duration themselves.
+         */
+        std::chrono::time_point<std::chrono::system_clock,
+                                std::chrono::nanoseconds>
+            validationEnd;
+
+        /**
+         * \brief Cache of the observations of action-independent
+         * LearningEnvironment, shared by all evaluations.
+         *
+         * The cache is enabled when params.observationCacheSize is greater
+         * than 0.
+         */
+        mutable ObservationCache observationCache;
+
+        /**
+         * \brief Model of the inference cost of roots, built from the
+         * params.teamInferenceCost and params.instructionInferenceCosts.
+         *
+         * Inference costs are only computed when isInferenceCostUsed().
+         */
+        InferenceCostModel inferenceCostModel;
+
+        // Friend relation needed to save and restore the training state.
+        friend class File::LearningAgentCheckpoint;
+
       public:
         /**
          * \brief Constructor for LearningAgent.
@@ -135,7 +196,10 @@ namespace Learn {
             : learningEnvironment{le}, env(iSet, le.getDataSources(),
                                            p.nbRegisters, p.nbProgramConstant),
               tpg(factory.createTPGGraph(env)), params{p},
-              archive(p.archiveSize, p.archivingProbability)
+              archive(p.archiveSize, p.archivingProbability),
+              observationCache(p.observationCacheSize * 1024 * 1024),
+              inferenceCostModel(p.teamInferenceCost,
+                                 p.instructionInferenceCosts)
         {
 
             // override the number of initial roots if set to 0
@@ -147,8 +211,16 @@ namespace Learn {
             }
         };
 
-        /// Default destructor for polymorphism
-        virtual ~LearningAgent() = default;
+        /**
+         * \brief Destructor for polymorphism.
+         *
+         * Waits for the completion of any pending validation, without
+         * delivering its results to the loggers.
+         *
+         * Since the validation calls virtual methods, classes deriving from
+         * LearningAgent must call joinValidation() in their own destructor.
+         */
+        virtual ~LearningAgent();
 
         /**
          * \brief Getter for the TPGGraph built by the LearningAgent.
@@ -164,6 +236,16 @@ namespace Learn {
          */
         const Archive& getArchive() const;
 
+        /**
+         * \brief Get the time at which the last validation was completed.
+         *
+         * This time is valid when the LALogger::logAfterValidate() method of
+         * loggers is called, including when the validation is pipelined.
+         */
+        const std::chrono::time_point<std::chrono::system_clock,
+                                      std::chrono::nanoseconds>&
+        getValidationEnd() const;
+
         /**
          * \brief Accessor to the Environment of the TPGGraph.
          *
@@ -171,6 +253,13 @@ namespace Learn {
          */
         const Environment& getEnvironment() const;
 
+        /**
+         * \brief Getter for the ObservationCache of the LearningAgent.
+         *
+         * \return a const reference to the observationCache attribute.
+         */
+        const ObservationCache& getObservationCache() const;
+
         /**
          * \brief Getter for the RNG used by the LearningAgent.
          *
@@ -223,6 +312,42 @@ namespace Learn {
             uint64_t generationNumber, LearningMode mode,
             LearningEnvironment& le) const;
 
+        /**
+         * \brief Evaluates one episode of the policy starting from the given
+         * root.
+         *
+         * The LearningEnvironment is reset with the given arguments, and
+         * actions are taken until it reaches a terminal state, or
+         * params.maxNbActionsPerEval actions. The score of the episode can
+         * then be read from the LearningEnvironment.
+         *
+         * If the observationCache is enabled, and the LearningEnvironment is
+         * action-independent, observations of the episode are replayed from
+         * the cache instead, and recorded in it if needed.
+         *
+         * If isInferenceCostUsed(), the cost of each inference is computed
+         * with the inferenceCostModel.
+         *
+         * \param[in] tee The TPGExecutionEngine to use.
+         * \param[in] root the root of the evaluated policy.
+         * \param[in] le Reference to the LearningEnvironment to use.
+         * \param[in] seed the seed given to the reset of the
+         * LearningEnvironment.
+         * \param[in] mode the LearningMode given to the reset.
+         * \param[in] iterationNumber the iteration number given to the reset.
+         * \param[in] generationNumber the generation number given to the
+         * reset.
+         * \param[in,out] programCosts the costs of Program memoized by the
+         * inferenceCostModel, shared by the episodes of a job.
+         * \return the average inference cost per action of the episode, or
+         * 0.0 if the inference cost is not used or no action was taken.
+         */
+        double evaluateEpisode(
+            TPG::TPGExecutionEngine& tee, const TPG::TPGVertex& root,
+            LearningEnvironment& le, size_t seed, LearningMode mode,
+            uint16_t iterationNumber, uint64_t generationNumber,
+            InferenceCostModel::ProgramCostCache& programCosts) const;
+
         /**
          * \brief Method detecting whether a root should be evaluated again.
          *
@@ -246,17 +371,17 @@ namespace Learn {
          * \brief Evaluate all root TPGVertex of the TPGGraph.
          *
          * This method calls the evaluateJob method for every root TPGVertex
-         * of the TPGGraph. The method returns a sorted map associating each
-         * root vertex to its average score, in ascending order or score.
+         * of the TPGGraph. The method returns a ResultsTable associating each
+         * root vertex to its EvaluationResult, with one row per root in the
+         * order of the TPGGraph roots.
          *
          * \param[in] generationNumber the integer number of the current
          * generation.
          * \param[in] mode the LearningMode to use during the policy
          * evaluation.
          */
-        virtual std::multimap<std::shared_ptr<EvaluationResult>,
-                              const TPG::TPGVertex*>
-        evaluateAllRoots(uint64_t generationNumber, LearningMode mode);
+        virtual ResultsTable evaluateAllRoots(uint64_t generationNumber,
+                                              LearningMode mode);
 
         /**
          * \brief Evaluate one root TPGVertex of the TPGGraph.
@@ -279,6 +404,142 @@ namespace Learn {
             uint64_t generationNumber, LearningMode mode,
             const TPG::TPGVertex* root);
 
+        /**
+         * \brief Evaluate in validation mode the roots of a copy of the
+         * TPGGraph.
+         *
+         * This method is called by a background thread when the validation is
+         * pipelined. It must not access the TPGGraph, the Archive or the
+         * LearningEnvironment of the LearningAgent, which are used
+         * concurrently by the training process, and uses a clone of the
+         * LearningEnvironment instead.
+         *
+         * \param[in] snapshot the copy of the TPGGraph to evaluate.
+         * \param[in] snapshotRoots the roots of the snapshot, in the order of
+         * the roots of the TPGGraph.
+         * \param[in] roots the roots of the TPGGraph, used in the returned
+         * ResultsTable in place of the corresponding snapshotRoots.
+         * \param[in] generationNumber the integer number of the generation.
+         * \return a ResultsTable with one row per root, in the order of roots.
+         */
+        virtual ResultsTable evaluateValidationSnapshot(
+            const TPG::TPGGraph& snapshot,
+            const std::vector<const TPG::TPGVertex*>& snapshotRoots,
+            const std::vector<const TPG::TPGVertex*>& roots,
+            uint64_t generationNumber) const;
+
+        /**
+         * \brief Check whether episodes of several jobs can be interleaved
+         * in a single thread.
+         *
+         * Interleaving is used when params.nbEpisodesInFlight is greater than
+         * 1 and the LearningEnvironment is copyable and asynchronous. It is
+         * only supported by LearningAgent whose evaluateJob follows the
+         * episode loop of LearningAgent::evaluateJob.
+         *
+         * \return true if episodes can be interleaved.
+         */
+        virtual bool canInterleaveEpisodes() const;
+
+        /**
+         * \brief Evaluate jobs by interleaving their episodes in the calling
+         * thread.
+         *
+         * Each LearningEnvironment of envs is a slot evaluating one job at a
+         * time, with the iterations of the job done in order, exactly as in
+         * evaluateJob. Once the TPGGraph has selected an action for a slot,
+         * it is submitted with LearningEnvironment::submitAction, and the
+         * thread moves to the next slot whose action is completed. When all
+         * slots wait for their environment, the thread awaits the first one.
+         *
+         * Since each job is evaluated in a single slot with its own Archive,
+         * results and archive recordings do not depend on the completion
+         * order of actions.
+         *
+         * \param[in] generationNumber the integer number of the current
+         * generation.
+         * \param[in] mode the LearningMode to use during the policy
+         * evaluation.
+         * \param[in] envs the LearningEnvironment used as slots.
+         * \param[in] nextJob function returning the next Job to evaluate, or
+         * nullptr when there is no job left.
+         * \param[in] archiveForJob function returning the Archive used for
+         * the evaluation of a Job, or NULL.
+         * \param[in] jobDone function called with each Job and its
+         * EvaluationResult once evaluated.
+         */
+        void evaluateJobsInterleaved(
+            uint64_t generationNumber, LearningMode mode,
+            const std::vector<LearningEnvironment*>& envs,
+            const std::function<std::shared_ptr<Job>()>& nextJob,
+            const std::function<Archive*(const Job&)>& archiveForJob,
+            const std::function<void(const std::shared_ptr<Job>&,
+                                     std::shared_ptr<EvaluationResult>)>&
+                jobDone) const;
+
+        /**
+         * \brief Copy the TPGGraph into a new TPGGraph.
+         *
+         * Edges are copied in the order of the outgoing edges of each
+         * vertex, which decides the winner of equal bids, so that the copy
+         * behaves as the TPGGraph.
+         *
+         * \param[out] vertexCopies map associating each vertex of the
+         * TPGGraph with its copy.
+         * \param[out] programOriginals if not NULL, Program are copied
+         * instead of being shared with the copy, and this map associates
+         * each copied Program with its original.
+         * \return the copy of the TPGGraph.
+         */
+        std::shared_ptr<TPG::TPGGraph> copyTPGGraph(
+            std::unordered_map<const TPG::TPGVertex*, const TPG::TPGVertex*>&
+                vertexCopies,
+            std::unordered_map<const Program::Program*,
+                               const Program::Program*>* programOriginals =
+                NULL) const;
+
+        /**
+         * \brief Check whether the validation can run in background.
+         *
+         * \return true if params.pipelineValidation is true and the
+         * LearningEnvironment is copyable.
+         */
+        virtual bool canPipelineValidation() const;
+
+        /**
+         * \brief Starts the validation of the surviving roots in a background
+         * thread.
+         *
+         * The roots, their subgraphs and their Program are copied into a new
+         * TPGGraph, so that the next generation can be populated while the
+         * copy is evaluated with evaluateValidationSnapshot().
+         *
+         * \param[in] generationNumber the integer number of the generation.
+         */
+        void startPipelinedValidation(uint64_t generationNumber);
+
+        /**
+         * \brief Waits for the pipelined validation of the last generation, if
+         * any, and delivers its results to the loggers.
+         *
+         * The LALogger::logAfterValidate() and LALogger::logEndOfTraining()
+         * methods of the loggers, postponed by trainOneGeneration(), are
+         * called once the validation is complete.
+         */
+        void waitForValidation();
+
+        /**
+         * \brief Waits for the pipelined validation of the last generation, if
+         * any, without delivering its results to the loggers.
+         *
+         * The background validation calls virtual methods of the
+         * LearningAgent, and may use members of derived classes. The
+         * destructor of each derived class must therefore call this method
+         * before its members are destroyed, and before the dynamic type of
+         * the object changes.
+         */
+        void joinValidation();
+
         /**
          * \brief Train the TPGGraph for one generation.
          *
@@ -286,6 +547,12 @@ namespace Learn {
          * - Populating the TPGGraph according to given MutationParameters.
          * - Evaluating all roots of the TPGGraph. (call to evaluateAllRoots)
          * - Removing from the TPGGraph the worst performing root TPGVertex.
+         * - Validating the surviving roots if params.doValidation is true.
+         *
+         * If params.pipelineValidation is true, the validation is started in
+         * background and its results are delivered to the loggers after the
+         * populating step of the next call to trainOneGeneration(), or by a
+         * call to waitForValidation().
          *
          * \param[in] generationNumber the integer number of the current
          * generation.
@@ -296,18 +563,41 @@ namespace Learn {
          * \brief Removes from the TPGGraph the root TPGVertex with the worst
          * results.
          *
-         * The given multimap is updated by removing entries corresponding to
+         * The given ResultsTable is updated by removing rows corresponding to
          * decimated vertices.
          *
          * The resultsPerRoot attribute is updated to remove results associated
          * to removed vertices.
          *
-         * \param[in,out] results a multimap containing root TPGVertex
+         * \param[in,out] results a ResultsTable containing root TPGVertex
          * associated to their score during an evaluation.
          */
-        virtual void decimateWorstRoots(
-            std::multimap<std::shared_ptr<EvaluationResult>,
-                          const TPG::TPGVertex*>& results);
+        virtual void decimateWorstRoots(ResultsTable& results);
+
+        /**
+         * \brief Check whether the inference cost of roots is used in the
+         * selection of roots.
+         *
+         * The inference cost is used if params.inferenceCostPenalty is
+         * greater than 0.0, or params.paretoCostSelection is true.
+         */
+        bool isInferenceCostUsed() const;
+
+        /**
+         * \brief Get the indexes of the nbRows worst rows of a ResultsTable
+         * for the selection of roots.
+         *
+         * Rows are ranked on their score only, unless isInferenceCostUsed().
+         * In this case, they are ranked with ResultsTable::getWorstRows() on
+         * their score penalized with params.inferenceCostPenalty, or with
+         * ResultsTable::getParetoWorstRows() if params.paretoCostSelection is
+         * true.
+         *
+         * \param[in] results the ResultsTable of the evaluated roots.
+         * \param[in] nbRows the number of rows to return.
+         */
+        std::vector<size_t> getWorstRowsForSelection(const ResultsTable& results,
+                                                     size_t nbRows) const;
 
         /**
          * \brief Train the TPGGraph for a given number of generation.
@@ -343,11 +633,9 @@ namespace Learn {
          * was removed from the graph in a following generation, beaten by root
          * vertex with lower scores than the current record.
          *
-         * \param[in] results Map from the evaluateAllRoots method.
+         * \param[in] results ResultsTable from the evaluateAllRoots method.
          */
-        void updateEvaluationRecords(
-            const std::multimap<std::shared_ptr<EvaluationResult>,
-                                const TPG::TPGVertex*>& results);
+        void updateEvaluationRecords(const ResultsTable& results);
 
         /**
          * \brief This method resets the previous registered scores per root.
@@ -363,11 +651,9 @@ namespace Learn {
          * \brief This method update the best score reached at the last
          * generation trained.
          *
-         * \param[in] results Map from the evaluateAllRoots method.
+         * \param[in] results ResultsTable from the evaluateAllRoots method.
          */
-        void updateBestScoreLastGen(
-            std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                          const TPG::TPGVertex*>& results);
+        void updateBestScoreLastGen(const ResultsTable& results);
 
         /**
          * \brief Get the best score reached at the last generation trained
@@ -388,6 +674,14 @@ namespace Learn {
                         std::shared_ptr<EvaluationResult>>&
         getBestRoot() const;
 
+        /**
+         * \brief Get the EvaluationResult recorded for the evaluated TPGVertex.
+         * \return a const reference to the resultsPerRoot attribute.
+         */
+        const std::map<const TPG::TPGVertex*,
+                       std::shared_ptr<EvaluationResult>>&
+        getResultsPerRoot() const;
+
         /**
          * \brief This method keeps only the bestRoot policy in the TPGGraph.
          *
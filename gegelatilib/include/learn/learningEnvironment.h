@@ -149,6 +149,125 @@ namespace Learn {
          */
         virtual void doAction(uint64_t actionID);
 
+        /**
+         * \brief Can the LearningEnvironment execute actions asynchronously.
+         *
+         * Asynchronous LearningEnvironment implement the submitAction,
+         * pollAction and awaitAction methods so that a single thread can keep
+         * several episodes in flight, each on its own copy of the
+         * LearningEnvironment, while actions are being processed.
+         *
+         * \return true if the submitAction method returns before the action
+         * is completed. Default implementation returns false.
+         */
+        virtual bool isAsynchronous() const;
+
+        /**
+         * \brief Submit an action to the LearningEnvironment without waiting
+         * for its completion.
+         *
+         * Once an action is submitted, the data sources, score and terminal
+         * state of the LearningEnvironment may only be accessed after
+         * pollAction has returned true, or awaitAction has returned. Only
+         * one action can be in flight at a time.
+         *
+         * Default implementation calls doAction.
+         *
+         * \param[in] actionID the integer number representing the action to
+         * execute.
+         * \throw std::runtime_error if the actionID exceeds nbActions - 1.
+         */
+        virtual void submitAction(uint64_t actionID);
+
+        /**
+         * \brief Check whether the last submitted action is completed.
+         *
+         * This method shall not block. Default implementation returns true.
+         *
+         * \return true if the last submitted action is completed, and the
+         * LearningEnvironment state is up to date.
+         */
+        virtual bool pollAction();
+
+        /**
+         * \brief Wait for the completion of the last submitted action.
+         *
+         * Default implementation returns immediately.
+         */
+        virtual void awaitAction();
+
+        /**
+         * \brief Are the observations of the LearningEnvironment independent
+         * of the actions taken.
+         *
+         * The data sources of an action-independent LearningEnvironment only
+         * depend on the arguments of the last reset and on the number of
+         * actions executed since, as in classification, where the samples
+         * presented do not depend on the guesses. Their observations can
+         * then be recorded once and replayed to all evaluated policies with
+         * an ObservationCache.
+         *
+         * Action-independent LearningEnvironment must implement the
+         * getObservationLabel, resetReplay and replayAction methods, and
+         * their DataHandler::clone() method must preserve the id of the
+         * copied data sources.
+         *
+         * \return true if the observations do not depend on the actions.
+         * Default implementation returns false.
+         */
+        virtual bool isActionIndependent() const;
+
+        /**
+         * \brief Get the label of the current observation.
+         *
+         * The label holds the state of the LearningEnvironment, which is not
+         * observed through its data sources, but is needed to score the
+         * action taken on the current observation, like the class of the
+         * presented sample in classification. The label is recorded with the
+         * observation, and given back to replayAction.
+         *
+         * \return the label of the current observation. Default
+         * implementation returns 0.
+         */
+        virtual uint64_t getObservationLabel() const;
+
+        /**
+         * \brief Reset the score of the LearningEnvironment before replaying
+         * recorded observations.
+         *
+         * Contrary to reset, this method shall not produce the first
+         * observation of the episode, which is replayed from a recording.
+         *
+         * \param[in] seed the integer value given to the reset method when
+         * recording the observations.
+         * \param[in] mode LearningMode given to the reset method.
+         * \param[in] iterationNumber iteration number given to the reset
+         * method.
+         * \param[in] generationNumber generation number given to the reset
+         * method.
+         * \throw std::runtime_error if the LearningEnvironment does not
+         * support replay, which is the case of the default implementation.
+         */
+        virtual void resetReplay(size_t seed, LearningMode mode,
+                                 uint16_t iterationNumber,
+                                 uint64_t generationNumber);
+
+        /**
+         * \brief Score an action taken on a replayed observation.
+         *
+         * Contrary to doAction, this method shall not produce the next
+         * observation of the episode, which is replayed from a recording.
+         *
+         * \param[in] label the label of the replayed observation, as returned
+         * by getObservationLabel when it was recorded.
+         * \param[in] actionID the integer number representing the action
+         * taken.
+         * \throw std::runtime_error if the actionID exceeds nbActions - 1,
+         * or if the LearningEnvironment does not support replay, which is
+         * the case of the default implementation.
+         */
+        virtual void replayAction(uint64_t label, uint64_t actionID);
+
         /**
          * \brief Reset the LearningEnvironment.
          *
@@ -40,6 +40,7 @@
 
 #include "mutator/mutationParameters.h"
 #include <thread>
+#include <vector>
 
 namespace Learn {
     /**
@@ -154,6 +155,28 @@ namespace Learn {
          */
         size_t nbIterationsPerJob = 1;
 
+        /// JSon comment
+        inline static const std::string maxNbIterationsPerJobComment =
+            "// [Only used in ParallelLearningAgent.]\n"
+            "// Maximum number of iterations of a policy evaluation done in a "
+            "single job.\n"
+            "// Smaller values split the evaluation of each root into several "
+            "jobs, which\n"
+            "// can be run in parallel when there are fewer roots than "
+            "threads.\n"
+            "// A value of 0 evaluates all iterations of a root in a single "
+            "job.\n"
+            "// \"maxNbIterationsPerJob\" : 0, // Default value";
+        /**
+         * \brief Maximum number of iterations of a policy evaluation done in
+         * a single job.
+         *
+         * If not 0, the nbIterationsPerPolicyEvaluation iterations of each
+         * root are split into jobs of at most maxNbIterationsPerJob
+         * iterations, whose results are folded in the order of iterations.
+         */
+        uint64_t maxNbIterationsPerJob = 0;
+
         /// JSon comment
         inline static const std::string nbRegistersComment =
             "// Number of registers for the Program execution.\n"
@@ -188,6 +211,124 @@ namespace Learn {
          */
         size_t nbThreads = std::thread::hardware_concurrency();
 
+        /// JSon comment
+        inline static const std::string threadAffinityComment =
+            "// [Only used in ParallelLearningAgent and child classes.]\n"
+            "// Policy used to pin evaluation threads to CPUs: \"none\", "
+            "\"compact\" (fill\n"
+            "// NUMA nodes one after the other), \"scatter\" (alternate "
+            "between NUMA nodes),\n"
+            "// or an explicit list of CPUs such as \"0,2,4-7\".\n"
+            "// \"threadAffinity\" : \"none\", // Default value";
+        /**
+         * \brief Policy used to pin evaluation threads to CPUs
+         * (ParallelLearningAgent only).
+         *
+         * See Util::ThreadAffinity for the possible values. Pinned threads
+         * clone the LearningEnvironment themselves, so that its memory is
+         * allocated on their NUMA node. When threads are pinned on several
+         * NUMA nodes, each node also evaluates its own replica of the
+         * TPGGraph and its Program.
+         */
+        std::string threadAffinity = "none";
+
+        /// JSon comment
+        inline static const std::string nbEpisodesInFlightComment =
+            "// [Only used in ParallelLearningAgent and child classes.]\n"
+            "// Number of episodes evaluated concurrently by each thread "
+            "when the\n"
+            "// LearningEnvironment is asynchronous. Each episode in flight "
+            "uses its own\n"
+            "// copy of the LearningEnvironment.\n"
+            "// \"nbEpisodesInFlight\" : 1, // Default value";
+        /**
+         * \brief Number of episodes evaluated concurrently by each thread
+         * (ParallelLearningAgent only).
+         *
+         * When greater than 1, and the LearningEnvironment is copyable and
+         * asynchronous, each thread interleaves the episodes of several jobs,
+         * so that the inference of the TPGGraph for an episode overlaps the
+         * processing of actions of the others.
+         */
+        size_t nbEpisodesInFlight = 1;
+
+        /// JSon comment
+        inline static const std::string observationCacheSizeComment =
+            "// Maximum memory, in MB, used to cache the observations of "
+            "LearningEnvironment\n"
+            "// whose observations do not depend on the actions taken. "
+            "Cached observations\n"
+            "// are replayed to all roots evaluated with the same seed. "
+            "Cache is disabled if 0.\n"
+            "// \"observationCacheSize\" : 0, // Default value";
+        /**
+         * \brief Maximum memory, in MB, used by the ObservationCache of the
+         * LearningAgent.
+         *
+         * When greater than 0, and the LearningEnvironment is
+         * action-independent, the observations of each episode are recorded
+         * once, and replayed to all roots and threads evaluating the same
+         * episode. Least recently used episodes are evicted when the cache
+         * exceeds this size.
+         */
+        size_t observationCacheSize = 0;
+
+        /// JSon comment
+        inline static const std::string inferenceCostPenaltyComment =
+            "// Weight of the average inference cost per action of roots, "
+            "subtracted from\n"
+            "// their score when selecting the roots deleted at each "
+            "generation. Scores\n"
+            "// reported by the LearningAgent are not penalized.\n"
+            "// \"inferenceCostPenalty\" : 0.0, // Default value";
+        /**
+         * \brief Weight of the inference cost in the selection of roots.
+         *
+         * When greater than 0.0, the average cost per action of the
+         * inferences of each root, given by an InferenceCostModel, is
+         * multiplied by this weight and subtracted from the score of the root
+         * when ranking roots in decimateWorstRoots(). Among roots with equal
+         * scores, the cheapest ones survive.
+         */
+        double inferenceCostPenalty = 0.0;
+
+        /// JSon comment
+        inline static const std::string paretoCostSelectionComment =
+            "// Boolean used to select the roots deleted at each generation "
+            "with their Pareto\n"
+            "// rank on score and inference cost, instead of their score "
+            "only.\n"
+            "// \"paretoCostSelection\" : false, // Default value";
+        /**
+         * \brief Boolean set to true to rank roots on the Pareto fronts of
+         * their score and inference cost.
+         *
+         * Roots of the worst fronts are deleted first. Within a front, roots
+         * are ranked on their score, penalized with the inferenceCostPenalty.
+         */
+        bool paretoCostSelection = false;
+
+        /// JSon comment
+        inline static const std::string teamInferenceCostComment =
+            "// Modeled cost of each team visited during an inference, when "
+            "the inference\n"
+            "// cost is used for selection.\n"
+            "// \"teamInferenceCost\" : 1.0, // Default value";
+        /// Modeled cost of each team visited during an inference.
+        double teamInferenceCost = 1.0;
+
+        /// JSon comment
+        inline static const std::string instructionInferenceCostsComment =
+            "// Modeled cost of the non-intron lines of each instruction, "
+            "indexed by\n"
+            "// instruction index, when the inference cost is used for "
+            "selection.\n"
+            "// Lines of instructions beyond the list cost 1.0.\n"
+            "// \"instructionInferenceCosts\" : [], // Default value";
+        /// Modeled cost of the instructions, indexed by instruction index.
+        /// Instructions without cost in this vector cost 1.0.
+        std::vector<double> instructionInferenceCosts;
+
         /// JSon comment
         inline static const std::string doValidationComment =
             "// Boolean used to activate an evaluation of the surviving roots "
@@ -197,6 +338,48 @@ namespace Learn {
         /// Boolean set to true if the user wants a validation after each
         /// training, and false otherwise
         bool doValidation = false;
+
+        /// JSon comment
+        inline static const std::string pipelineValidationComment =
+            "// Boolean used to evaluate the validation of each generation in "
+            "background,\n"
+            "// while the TPG of the next generation is populated. Only used "
+            "if doValidation\n"
+            "// is true and the LearningEnvironment is copyable.\n"
+            "// \"pipelineValidation\" : false, // Default value";
+        /// Boolean set to true to run the validation of surviving roots
+        /// concurrently with the populateTPG of the next generation.
+        bool pipelineValidation = false;
+
+        /// JSon comment
+        inline static const std::string nbIslandsComment =
+            "// [Only used in IslandLearningAgent.]\n"
+            "// Number of independent TPG populations evolving in parallel.\n"
+            "// \"nbIslands\" : 4, // Default value";
+        /// Number of independent populations (IslandLearningAgent only).
+        size_t nbIslands = 4;
+
+        /// JSon comment
+        inline static const std::string migrationIntervalComment =
+            "// [Only used in IslandLearningAgent.]\n"
+            "// Number of generations between two migrations of roots between "
+            "islands.\n"
+            "// A value of 0 disables migrations.\n"
+            "// \"migrationInterval\" : 10, // Default value";
+        /// Number of generations between two migrations (IslandLearningAgent
+        /// only). Migrations are disabled if 0.
+        uint64_t migrationInterval = 10;
+
+        /// JSon comment
+        inline static const std::string nbMigrantsComment =
+            "// [Only used in IslandLearningAgent.]\n"
+            "// Number of best roots copied, with their reachable subgraph, "
+            "from each island\n"
+            "// to the next one at each migration.\n"
+            "// \"nbMigrants\" : 1, // Default value";
+        /// Number of best roots migrating from each island to the next one
+        /// (IslandLearningAgent only).
+        size_t nbMigrants = 1;
     } LearningParameters;
 }; // namespace Learn
 
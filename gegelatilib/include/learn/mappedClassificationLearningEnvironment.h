@@ -0,0 +1,455 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef MAPPED_CLASSIFICATION_LEARNING_ENVIRONMENT_H
+#define MAPPED_CLASSIFICATION_LEARNING_ENVIRONMENT_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "data/array2DWrapper.h"
+#include "file/tpgGraphBinaryFormat.h"
+#include "learn/classificationLearningEnvironment.h"
+
+namespace Learn {
+
+    /**
+     * \brief Header of a binary dataset file, read by the
+     * MappedClassificationLearningEnvironment.
+     *
+     * The header is followed by a table of nbSamples uint64_t labels, starting
+     * at labelsOffset, and by the samples, starting at samplesOffset. Each
+     * sample is a height x width array of elements. Consecutive samples start
+     * sampleStride elements apart, and consecutive elements of a sample are
+     * elementStride elements apart, so that padded or interleaved data can be
+     * read without conversion. All values are stored in the native byte
+     * order.
+     */
+    struct MappedDatasetHeader
+    {
+        /// Magic number identifying the file format.
+        static constexpr char MAGIC[8] = {'G', 'G', 'D', 'A',
+                                          'T', 'A', '0', '1'};
+
+        /// Magic number of the file.
+        char magic[8];
+
+        /// Size of an element of the samples, in bytes.
+        uint64_t elementSize;
+
+        /// Number of samples.
+        uint64_t nbSamples;
+
+        /// Number of lines of a sample.
+        uint64_t height;
+
+        /// Number of columns of a sample.
+        uint64_t width;
+
+        /// Distance, in elements, between the first elements of consecutive
+        /// samples.
+        uint64_t sampleStride;
+
+        /// Distance, in elements, between consecutive elements of a sample.
+        uint64_t elementStride;
+
+        /// Offset of the labels table, in bytes.
+        uint64_t labelsOffset;
+
+        /// Offset of the first sample, in bytes.
+        uint64_t samplesOffset;
+    };
+
+    /**
+     * \brief ClassificationLearningEnvironment reading its samples from a
+     * memory-mapped binary dataset file.
+     *
+     * The dataset file, described by MappedDatasetHeader, is mapped once and
+     * shared by all copies of the LearningEnvironment. The single data
+     * source is an Array2DWrapper viewing the current sample in the mapped
+     * file: switching samples only repoints the view, and no sample is ever
+     * copied, so datasets larger than the memory can be used.
+     *
+     * The first samples of the file are used in TRAINING mode, and the
+     * remaining ones in VALIDATION and TESTING modes. After a reset, samples
+     * of the mode are presented sequentially, starting from a sample chosen
+     * with the seed, so that consecutive episodes read different parts of
+     * the dataset while keeping a sequential access pattern. When a
+     * prefetch size is given, the pages of the next prefetchSize samples are
+     * read ahead each time the first of them is reached.
+     *
+     * Presented samples only depend on the reset arguments, so the
+     * LearningEnvironment is action-independent, and its observations can be
+     * replayed by an ObservationCache.
+     *
+     * Child classes may change the order of samples by overriding the
+     * getSampleIndex method.
+     *
+     * \tparam T the type of sample elements.
+     */
+    template <class T> class MappedClassificationLearningEnvironment
+        : public ClassificationLearningEnvironment
+    {
+      protected:
+        /// Mapped dataset file, shared by copies.
+        std::shared_ptr<const File::TPGGraphBinaryFormat::MappedFile> file;
+
+        /// Header of the mapped file.
+        MappedDatasetHeader header;
+
+        /// Number of samples used in TRAINING mode.
+        uint64_t nbTrainingSamples;
+
+        /// Number of samples read ahead, or 0 to disable prefetching.
+        uint64_t prefetchSize;
+
+        /// View of the current sample.
+        Data::Array2DWrapper<T> sample;
+
+        /// LearningMode given to the last reset.
+        LearningMode currentMode;
+
+        /// Position of the first sample of the episode, within the mode.
+        uint64_t firstPosition;
+
+        /// Number of samples presented since the last reset.
+        uint64_t nbPresentedSamples;
+
+        /**
+         * \brief Get the first sample and number of samples of a mode.
+         *
+         * \param[in] mode the LearningMode.
+         * \param[out] first the index of the first sample of the mode.
+         * \param[out] count the number of samples of the mode.
+         */
+        void getModeRange(LearningMode mode, uint64_t& first,
+                          uint64_t& count) const
+        {
+            if (mode == LearningMode::TRAINING ||
+                this->nbTrainingSamples == this->header.nbSamples) {
+                // Without dedicated samples, all modes use training ones.
+                first = 0;
+                count = this->nbTrainingSamples;
+            }
+            else {
+                first = this->nbTrainingSamples;
+                count = this->header.nbSamples - this->nbTrainingSamples;
+            }
+        };
+
+        /**
+         * \brief Get the index of the sample presented after a number of
+         * actions since the last reset.
+         *
+         * Default implementation presents samples of the current mode
+         * sequentially, from firstPosition.
+         *
+         * \param[in] nbActions the number of actions since the last reset.
+         * \return the index of the sample in the dataset file.
+         */
+        virtual uint64_t getSampleIndex(uint64_t nbActions) const
+        {
+            uint64_t first, count;
+            this->getModeRange(this->currentMode, first, count);
+            return first + (this->firstPosition + nbActions) % count;
+        };
+
+        /**
+         * \brief Set the current sample, and read ahead the next ones when
+         * needed.
+         *
+         * \param[in] idx the index of the sample in the dataset file.
+         * \throw std::runtime_error if the label of the sample exceeds the
+         * number of classes.
+         */
+        void setSample(uint64_t idx)
+        {
+            const char* data = this->file->getData();
+            uint64_t label;
+            std::memcpy(&label,
+                        data + this->header.labelsOffset +
+                            idx * sizeof(uint64_t),
+                        sizeof(uint64_t));
+            if (label >= this->nbActions) {
+                throw std::runtime_error(
+                    "Label of a dataset sample exceeds the number of "
+                    "classes.");
+            }
+            this->currentClass = label;
+
+            const T* samples =
+                reinterpret_cast<const T*>(data + this->header.samplesOffset);
+            this->sample.setView(samples + idx * this->header.sampleStride,
+                                 this->header.elementStride);
+
+            // At the beginning of each minibatch of prefetchSize samples,
+            // read ahead the next one. The first minibatch of an episode is
+            // read ahead too.
+            if (this->prefetchSize > 0 &&
+                this->nbPresentedSamples % this->prefetchSize == 0) {
+                bool first = (this->nbPresentedSamples == 0);
+                uint64_t sampleSize = this->header.sampleStride * sizeof(T);
+                this->file->prefetch(
+                    this->header.samplesOffset +
+                        (idx + (first ? 0 : this->prefetchSize)) * sampleSize,
+                    (first ? 2 : 1) * this->prefetchSize * sampleSize);
+            }
+        };
+
+      public:
+        /**
+         * \brief Constructor of the MappedClassificationLearningEnvironment.
+         *
+         * \param[in] filePath path of the binary dataset file.
+         * \param[in] nbClasses number of classes, and thus of actions.
+         * \param[in] trainingRatio ratio of the samples, from the beginning
+         * of the file, used in TRAINING mode. Other samples are used in
+         * VALIDATION and TESTING modes. If all samples are used for
+         * training, they are also used in the other modes.
+         * \param[in] prefetchSize number of samples read ahead, or 0 to
+         * disable prefetching.
+         * \throw std::runtime_error if the file can not be mapped, or if its
+         * content is not a valid dataset of elements of type T.
+         */
+        MappedClassificationLearningEnvironment(const std::string& filePath,
+                                                uint64_t nbClasses,
+                                                double trainingRatio = 1.0,
+                                                uint64_t prefetchSize = 0)
+            : ClassificationLearningEnvironment(nbClasses),
+              file(std::make_shared<File::TPGGraphBinaryFormat::MappedFile>(
+                  filePath.c_str())),
+              header(readHeader(*file)), prefetchSize{prefetchSize},
+              sample(header.width, header.height),
+              currentMode{LearningMode::TRAINING}, firstPosition{0},
+              nbPresentedSamples{0}
+        {
+            this->nbTrainingSamples = std::max(
+                (uint64_t)1, std::min(this->header.nbSamples,
+                                      (uint64_t)std::ceil(
+                                          trainingRatio *
+                                          (double)this->header.nbSamples)));
+            this->setSample(0);
+        };
+
+        /**
+         * \brief Read and check the header of a mapped dataset file.
+         *
+         * \param[in] file the mapped file.
+         * \return a copy of the header.
+         * \throw std::runtime_error if the content of the file is not a valid
+         * dataset of elements of type T.
+         */
+        static MappedDatasetHeader readHeader(
+            const File::TPGGraphBinaryFormat::MappedFile& file)
+        {
+            MappedDatasetHeader header;
+            if (file.getSize() < sizeof(MappedDatasetHeader)) {
+                throw std::runtime_error("Dataset file is too small.");
+            }
+            std::memcpy(&header, file.getData(), sizeof(MappedDatasetHeader));
+            if (std::memcmp(header.magic, MappedDatasetHeader::MAGIC,
+                            sizeof(header.magic)) != 0) {
+                throw std::runtime_error("File is not a dataset file.");
+            }
+            if (header.elementSize != sizeof(T)) {
+                throw std::runtime_error(
+                    "Size of dataset elements differs from the environment.");
+            }
+            if (header.nbSamples == 0 || header.height == 0 ||
+                header.width == 0 || header.elementStride == 0) {
+                throw std::runtime_error("Dataset file has no samples.");
+            }
+            if (header.samplesOffset % alignof(T) != 0) {
+                throw std::runtime_error(
+                    "Samples of the dataset file are not aligned.");
+            }
+            uint64_t sampleExtent =
+                ((header.height * header.width - 1) * header.elementStride +
+                 1) *
+                sizeof(T);
+            if (header.labelsOffset + header.nbSamples * sizeof(uint64_t) >
+                    file.getSize() ||
+                header.samplesOffset +
+                        (header.nbSamples - 1) * header.sampleStride *
+                            sizeof(T) +
+                        sampleExtent >
+                    file.getSize()) {
+                throw std::runtime_error("Dataset file is truncated.");
+            }
+            return header;
+        };
+
+        /**
+         * \brief Write a binary dataset file.
+         *
+         * Samples are written contiguously, with a unit element stride.
+         *
+         * \param[in] filePath path of the written file.
+         * \param[in] samples the elements of all samples, one sample after
+         * the other.
+         * \param[in] labels the label of each sample.
+         * \param[in] height number of lines of a sample.
+         * \param[in] width number of columns of a sample.
+         * \throw std::runtime_error if the file can not be written, or if the
+         * number of elements does not match the number of labels.
+         */
+        static void writeDataset(const std::string& filePath,
+                                 const std::vector<T>& samples,
+                                 const std::vector<uint64_t>& labels,
+                                 uint64_t height, uint64_t width)
+        {
+            if (samples.size() != labels.size() * height * width) {
+                throw std::runtime_error(
+                    "Number of elements differs from the number of samples.");
+            }
+
+            MappedDatasetHeader header;
+            std::memcpy(header.magic, MappedDatasetHeader::MAGIC,
+                        sizeof(header.magic));
+            header.elementSize = sizeof(T);
+            header.nbSamples = labels.size();
+            header.height = height;
+            header.width = width;
+            header.sampleStride = height * width;
+            header.elementStride = 1;
+            header.labelsOffset = sizeof(MappedDatasetHeader);
+            // Align samples on a cache line.
+            uint64_t labelsEnd =
+                header.labelsOffset + labels.size() * sizeof(uint64_t);
+            header.samplesOffset = (labelsEnd + 63) / 64 * 64;
+
+            std::ofstream out(filePath, std::ios::binary);
+            if (!out.is_open()) {
+                throw std::runtime_error("Could not open file " + filePath);
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(labels.data()),
+                      labels.size() * sizeof(uint64_t));
+            std::vector<char> padding(header.samplesOffset - labelsEnd, 0);
+            out.write(padding.data(), padding.size());
+            out.write(reinterpret_cast<const char*>(samples.data()),
+                      samples.size() * sizeof(T));
+            if (!out.good()) {
+                throw std::runtime_error("Could not write file " + filePath);
+            }
+        };
+
+        /// Get the header of the dataset file.
+        const MappedDatasetHeader& getHeader() const
+        {
+            return this->header;
+        };
+
+        /**
+         * \brief Get the number of samples used in a LearningMode.
+         *
+         * \param[in] mode the LearningMode.
+         * \return the number of samples.
+         */
+        uint64_t getNbSamples(LearningMode mode) const
+        {
+            uint64_t first, count;
+            this->getModeRange(mode, first, count);
+            return count;
+        };
+
+        /// Copies share the mapped file.
+        bool isCopyable() const override
+        {
+            return true;
+        };
+
+        /// Inherited from LearningEnvironment
+        LearningEnvironment* clone() const override
+        {
+            return new MappedClassificationLearningEnvironment<T>(*this);
+        };
+
+        /// Samples only depend on the reset arguments.
+        bool isActionIndependent() const override
+        {
+            return true;
+        };
+
+        /// Inherited from LearningEnvironment
+        void doAction(uint64_t actionID) override
+        {
+            ClassificationLearningEnvironment::doAction(actionID);
+            this->nbPresentedSamples++;
+            this->setSample(this->getSampleIndex(this->nbPresentedSamples));
+        };
+
+        /**
+         * \brief Reset the LearningEnvironment.
+         *
+         * Resets the classificationTable, and presents the first sample of
+         * the episode, chosen with the seed among the samples of the mode.
+         */
+        void reset(size_t seed = 0, LearningMode mode = LearningMode::TRAINING,
+                   uint16_t iterationNumber = 0,
+                   uint64_t generationNumber = 0) override
+        {
+            ClassificationLearningEnvironment::reset(
+                seed, mode, iterationNumber, generationNumber);
+            uint64_t first, count;
+            this->getModeRange(mode, first, count);
+            this->currentMode = mode;
+            this->firstPosition = seed % count;
+            this->nbPresentedSamples = 0;
+            this->setSample(this->getSampleIndex(0));
+        };
+
+        /// Inherited from LearningEnvironment
+        std::vector<std::reference_wrapper<const Data::DataHandler>>
+        getDataSources() override
+        {
+            return {this->sample};
+        };
+
+        /// Classification never ends, episodes are bounded by the
+        /// LearningAgent.
+        bool isTerminal() const override
+        {
+            return false;
+        };
+    };
+} // namespace Learn
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef MULTI_PROCESS_LEARNING_AGENT_H
+#define MULTI_PROCESS_LEARNING_AGENT_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "instructions/set.h"
+#include "tpg/tpgFactory.h"
+
+#include "learn/evaluationResult.h"
+#include "learn/job.h"
+#include "learn/learningEnvironment.h"
+#include "learn/learningParameters.h"
+#include "learn/parallelLearningAgent.h"
+#include "learn/resultsTable.h"
+
+namespace Learn {
+    /**
+     * \brief Class used to control the learning steps of a TPGGraph within
+     * a LearningEnvironment that cannot be copied, by evaluating roots in
+     * parallel worker processes.
+     *
+     * When the LearningEnvironment is not copyable, the ParallelLearningAgent
+     * evaluates all roots sequentially. With this agent, each call to
+     * evaluateAllRoots instead forks up to params.nbThreads worker processes,
+     * which evaluate the jobs sent by the parent process through a pipe, one
+     * at a time, until no job remains.
+     *
+     * Forked workers share a copy-on-write snapshot of the TPGGraph and of
+     * the LearningAgent state, so the TPGGraph does not need to be
+     * serialized: only job indexes, EvaluationResult and Archive
+     * recordings are exchanged.
+     * Each worker uses its own private copy of the LearningEnvironment,
+     * inherited from the fork, so its DataHandler keep the identifiers
+     * expected by the Program. An optional initializer can be registered to
+     * prepare this copy in each worker (e.g. to reopen resources of a
+     * simulator that do not survive a fork).
+     *
+     * In training mode, each job fills its own Archive in the worker
+     * process. Its recordings are serialized with the writeData() method of
+     * DataHandler, and merged into the Archive of the agent in the order of
+     * job indexes, as done by the ParallelLearningAgent.
+     *
+     * If the LearningEnvironment is copyable, or if a single thread is
+     * requested, or on platforms without fork (i.e. Windows), this agent
+     * behaves exactly like the ParallelLearningAgent.
+     */
+    class MultiProcessLearningAgent : public ParallelLearningAgent
+    {
+      protected:
+        /// Function called in each worker process on its private copy of
+        /// the LearningEnvironment, before any evaluation.
+        std::function<void(LearningEnvironment&)> workerInitializer;
+
+        /**
+         * \brief Evaluate the given jobs in worker processes.
+         *
+         * \param[in] generationNumber the integer number of the current
+         * generation.
+         * \param[in] mode the LearningMode to use during the policy
+         * evaluation.
+         * \param[in] jobs the jobs to evaluate.
+         * \return the EvaluationResult of each job, in the order of jobs.
+         * \throw std::runtime_error if a worker process can not be created or
+         * fails during the evaluation.
+         */
+        std::vector<std::shared_ptr<EvaluationResult>> evaluateJobsInProcesses(
+            uint64_t generationNumber, LearningMode mode,
+            const std::vector<std::shared_ptr<Job>>& jobs);
+
+        /**
+         * \brief Function implementing the behavior of a worker process.
+         *
+         * The worker reads job indexes from the jobsFd file descriptor, and
+         * writes the corresponding EvaluationResult to the resultsFd file
+         * descriptor, until it reads an invalid index.
+         *
+         * \param[in] generationNumber the integer number of the current
+         * generation.
+         * \param[in] mode the LearningMode to use during the policy
+         * evaluation.
+         * \param[in] jobs the jobs that may be evaluated.
+         * \param[in] jobsFd file descriptor from which job indexes are read.
+         * \param[in] resultsFd file descriptor to which results are written.
+         * \throw std::runtime_error if the pipe with the parent process is
+         * broken, or if evaluateJob returns an unsupported EvaluationResult.
+         * Exceptions from the workerInitializer are forwarded.
+         */
+        void workerProcess(uint64_t generationNumber, LearningMode mode,
+                           const std::vector<std::shared_ptr<Job>>& jobs,
+                           int jobsFd, int resultsFd);
+
+      public:
+        /**
+         * \brief Constructor for MultiProcessLearningAgent.
+         *
+         * Based on default constructor of ParallelLearningAgent
+         *
+         * \param[in] le The LearningEnvironment for the TPG.
+         * \param[in] iSet Set of Instruction used to compose Programs in the
+         *            learning process.
+         * \param[in] p The LearningParameters for the LearningAgent.
+         * \param[in] factory The TPGFactory used to create the TPGGraph. A
+         * default TPGFactory is used if none is provided.
+         */
+        MultiProcessLearningAgent(
+            LearningEnvironment& le, const Instructions::Set& iSet,
+            const LearningParameters& p,
+            const TPG::TPGFactory& factory = TPG::TPGFactory())
+            : ParallelLearningAgent(le, iSet, p, factory){};
+
+        /// Destructor, waiting for the pending validation.
+        virtual ~MultiProcessLearningAgent()
+        {
+            this->joinValidation();
+        };
+
+        /**
+         * \brief Set the function called in each worker process before
+         * evaluations.
+         *
+         * \param[in] initializer Function receiving the private copy of the
+         * LearningEnvironment of the worker. Exceptions thrown by this
+         * function make the evaluation fail in the parent process.
+         */
+        void setWorkerInitializer(
+            const std::function<void(LearningEnvironment&)>& initializer);
+
+        /**
+         * \brief Evaluate all root TPGVertex of the TPGGraph.
+         *
+         * **Replaces the function from the base class
+         * ParallelLearningAgent.**
+         *
+         * If the LearningEnvironment is not copyable and several threads are
+         * requested, jobs are evaluated in worker processes. The returned
+         * ResultsTable contains one row per root in the order of the
+         * TPGGraph roots, with the same scores as a sequential evaluation.
+         *
+         * \param[in] generationNumber the integer number of the current
+         * generation.
+         * \param[in] mode the LearningMode to use during the policy
+         * evaluation.
+         */
+        ResultsTable evaluateAllRoots(uint64_t generationNumber,
+                                      LearningMode mode) override;
+    };
+} // namespace Learn
+
+#endif
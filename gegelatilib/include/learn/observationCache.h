@@ -0,0 +1,254 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef OBSERVATION_CACHE_H
+#define OBSERVATION_CACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "data/dataHandler.h"
+#include "instructions/set.h"
+#include "learn/learningEnvironment.h"
+
+namespace Learn {
+
+    /**
+     * \brief Observation of an action-independent LearningEnvironment at one
+     * step of an episode.
+     */
+    struct ObservationFrame
+    {
+        /// Read-only copies of the data sources of the LearningEnvironment.
+        std::vector<std::shared_ptr<const Data::DataHandler>> copies;
+
+        /// References to the copies, as expected by the TPGExecutionEngine.
+        std::vector<std::reference_wrapper<const Data::DataHandler>>
+            dataSources;
+
+        /// Label of the observation, given by
+        /// LearningEnvironment::getObservationLabel().
+        uint64_t label;
+    };
+
+    /**
+     * \brief Sequence of observations of a whole episode of an
+     * action-independent LearningEnvironment.
+     *
+     * The episode contains one ObservationFrame per action, until the
+     * LearningEnvironment reaches a terminal state or the maximum number of
+     * actions of the episode.
+     */
+    struct ObservationStream
+    {
+        /// Observation preceding each action of the episode.
+        std::vector<ObservationFrame> frames;
+
+        /**
+         * \brief Estimated memory footprint of the frames, in bytes.
+         *
+         * The footprint is estimated from the largest address space of the
+         * copied data sources, counting 8 bytes per address.
+         */
+        size_t memorySize = 0;
+    };
+
+    /**
+     * \brief Thread-safe cache of the observation streams of
+     * action-independent LearningEnvironment.
+     *
+     * When the observations of a LearningEnvironment do not depend on the
+     * actions taken, the observation stream of an episode only depends on
+     * the arguments of the LearningEnvironment::reset() call starting it.
+     * The ObservationCache stores these streams, so that they are produced
+     * once and replayed to all roots and threads evaluated with the same
+     * arguments.
+     *
+     * The memory footprint of the cache is capped. When a new stream exceeds
+     * the cap, the least recently used streams are evicted. Streams are
+     * shared read-only, and remain valid for their users after eviction.
+     */
+    class ObservationCache
+    {
+      public:
+        /// Arguments of the LearningEnvironment::reset() call of an episode.
+        struct Key
+        {
+            /// Seed given to the reset.
+            size_t seed;
+
+            /// LearningMode given to the reset.
+            LearningMode mode;
+
+            /// Iteration number given to the reset.
+            uint16_t iterationNumber;
+
+            /// Generation number given to the reset.
+            uint64_t generationNumber;
+
+            /// Equality of all reset arguments.
+            bool operator==(const Key& other) const;
+        };
+
+      protected:
+        /// Hash of a Key, for the unordered_map of entries.
+        struct KeyHash
+        {
+            /// Hash combining all reset arguments.
+            size_t operator()(const Key& key) const;
+        };
+
+        /// Stream stored in the cache.
+        struct Entry
+        {
+            /// Stream, possibly still being recorded by another thread.
+            std::shared_future<std::shared_ptr<const ObservationStream>>
+                stream;
+
+            /// Memory footprint of the stream once recorded, 0 before.
+            size_t memorySize;
+
+            /// Position of the Key in the lru list.
+            std::list<Key>::iterator lruPosition;
+        };
+
+        /// Maximum memory footprint of the cached streams, in bytes.
+        const size_t maxMemorySize;
+
+        /// Current memory footprint of the cached streams, in bytes.
+        size_t memorySize = 0;
+
+        /// Keys of the entries, from the most to the least recently used.
+        std::list<Key> lru;
+
+        /// Cached streams.
+        std::unordered_map<Key, Entry, KeyHash> entries;
+
+        /// Number of streams found in the cache.
+        uint64_t nbHits = 0;
+
+        /// Number of streams recorded because they were not in the cache.
+        uint64_t nbMisses = 0;
+
+        /// Mutex protecting all attributes.
+        mutable std::mutex mutex;
+
+        /**
+         * \brief Evict least recently used streams until the memory footprint
+         * fits within the cap.
+         *
+         * Streams still being recorded are never evicted. The mutex must be
+         * locked by the caller.
+         */
+        void evictLeastRecentlyUsed();
+
+      public:
+        /**
+         * \brief Constructor of the ObservationCache.
+         *
+         * \param[in] maxMemorySize maximum memory footprint of the cached
+         * streams, in bytes. The cache is disabled if 0.
+         */
+        ObservationCache(size_t maxMemorySize = 0)
+            : maxMemorySize{maxMemorySize} {};
+
+        /// Is the cache enabled.
+        bool isEnabled() const;
+
+        /**
+         * \brief Get the stream of an episode, recording it if needed.
+         *
+         * If the stream is not in the cache, the given function is called to
+         * record it, and the stream is inserted in the cache unless it
+         * exceeds the memory cap on its own. Concurrent calls for the same
+         * key wait for the stream recorded by the first one.
+         *
+         * \param[in] key the reset arguments of the episode.
+         * \param[in] record function recording the stream of the episode.
+         * \return the stream of the episode.
+         * \throw any exception thrown by the record function.
+         */
+        std::shared_ptr<const ObservationStream> getStream(
+            const Key& key,
+            const std::function<std::shared_ptr<const ObservationStream>()>&
+                record);
+
+        /// Remove all streams from the cache.
+        void clear();
+
+        /// Get the memory footprint of the cached streams, in bytes.
+        size_t getMemorySize() const;
+
+        /// Get the number of cached streams.
+        size_t getNbStreams() const;
+
+        /// Get the number of streams found in the cache by getStream().
+        uint64_t getNbHits() const;
+
+        /// Get the number of streams recorded by getStream().
+        uint64_t getNbMisses() const;
+
+        /**
+         * \brief Record the stream of an episode of an action-independent
+         * LearningEnvironment.
+         *
+         * The LearningEnvironment is reset with the given arguments, and
+         * actions 0 are executed until it reaches a terminal state, or
+         * maxNbActions. The data sources of the LearningEnvironment are
+         * copied before each action.
+         *
+         * The copies are prepared for concurrent reads by Program of the
+         * given Instructions::Set: their hash and address spaces are computed
+         * once during the recording.
+         *
+         * \param[in] le the action-independent LearningEnvironment.
+         * \param[in] iSet the Instructions::Set of the Program reading the
+         * copies.
+         * \param[in] key the reset arguments of the episode.
+         * \param[in] maxNbActions maximum number of actions of the episode.
+         * \return the recorded stream.
+         */
+        static std::shared_ptr<const ObservationStream> recordStream(
+            LearningEnvironment& le, const Instructions::Set& iSet,
+            const Key& key, uint64_t maxNbActions);
+    };
+} // namespace Learn
+
+#endif
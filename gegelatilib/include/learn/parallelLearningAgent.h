@@ -38,9 +38,14 @@
 #ifndef PARALLEL_LEARNING_AGENT
 #define PARALLEL_LEARNING_AGENT
 
+#include <condition_variable>
+#include <map>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #include "instructions/set.h"
 #include "tpg/tpgExecutionEngine.h"
@@ -50,6 +55,7 @@
 #include "learn/learningAgent.h"
 #include "learn/learningEnvironment.h"
 #include "learn/learningParameters.h"
+#include "util/threadAffinity.h"
 
 namespace Learn {
     /**
@@ -64,7 +70,109 @@ namespace Learn {
      */
     class ParallelLearningAgent : public LearningAgent
     {
+      public:
+        /// Number of jobs, iterations and time spent evaluating them.
+        struct NodeThroughput
+        {
+            /// Number of evaluated jobs.
+            uint64_t nbJobs = 0;
+
+            /// Number of evaluated iterations.
+            uint64_t nbIterations = 0;
+
+            /// Cumulated evaluation time of the jobs, in seconds.
+            double duration = 0.0;
+
+            /**
+             * Number of threads that could not be pinned to the CPU given by
+             * the affinity policy, and ran on a CPU of this node instead.
+             */
+            uint64_t nbPinningFailures = 0;
+
+            /// Number of replicas of the TPGGraph built on this node.
+            uint64_t nbReplicas = 0;
+        };
+
       protected:
+        /**
+         * \brief Copy of the TPGGraph evaluated by the threads of a NUMA
+         * node.
+         *
+         * The copy, including its Program, is built by the first thread of
+         * the node evaluating a job, so that its memory is allocated on the
+         * node. Jobs keep their root in the TPGGraph, for their results, and
+         * execute its copy.
+         */
+        struct GraphReplica
+        {
+            /// Ensures the replica is built by a single thread.
+            std::once_flag built;
+
+            /// Copy of the TPGGraph.
+            std::shared_ptr<TPG::TPGGraph> graph;
+
+            /// Copy of each vertex of the TPGGraph.
+            std::unordered_map<const TPG::TPGVertex*, const TPG::TPGVertex*>
+                vertices;
+
+            /// Original of each Program of the copy.
+            std::unordered_map<const Program::Program*,
+                               const Program::Program*>
+                programs;
+        };
+
+        /// Policy used to pin evaluation threads to CPUs.
+        Util::ThreadAffinity affinity;
+
+        /**
+         * \brief Throughput of evaluation threads, accumulated per NUMA node
+         * since the last call to resetNodeThroughput().
+         *
+         * Mutable, so that pinning failures of threads evaluating validation
+         * snapshots are also reported.
+         */
+        mutable std::map<int, NodeThroughput> nodeThroughput;
+
+        /// Mutex protecting the nodeThroughput map.
+        mutable std::mutex nodeThroughputMutex;
+
+        /**
+         * \brief Wall-clock duration, in seconds, of the last evaluation of
+         * each root in TRAINING mode.
+         *
+         * These durations are used to estimate the cost of jobs when
+         * scheduling them among threads. The map is pruned to the current
+         * roots at each parallel evaluation.
+         */
+        std::map<const TPG::TPGVertex*, double> rootCosts;
+
+        /// Mutex protecting the rootCosts map during parallel evaluations.
+        std::mutex rootCostsMutex;
+
+        /**
+         * \brief Estimate the cost of each job and group them into chunks
+         * dispatched longest first.
+         *
+         * The cost of a job is the measured duration of the last evaluation
+         * of its root. Roots created by the last populateTPG inherit the cost
+         * of the root they were cloned from, and roots without any estimate
+         * get the average of known costs.
+         *
+         * Consecutive jobs whose cumulated cost stays below a fraction of the
+         * average work per thread are grouped into a single chunk, to
+         * amortize the per-job overhead. Chunks are then sorted by decreasing
+         * cost (longest processing time first), with ties kept in job order.
+         *
+         * Since a chunk only contains consecutive jobs, and results and
+         * Archive are compiled with job indexes, the dispatch order has no
+         * influence on the training outcome.
+         *
+         * \param[in] jobs the jobs to schedule, in the order of their index.
+         * \return the chunks of jobs, in their dispatch order.
+         */
+        std::queue<std::vector<std::shared_ptr<Learn::Job>>>
+        scheduleJobs(std::queue<std::shared_ptr<Learn::Job>>& jobs);
+
         /**
          * \brief Method for evaluating all roots with parallelism.
          *
@@ -74,13 +182,12 @@ namespace Learn {
          *
          * \param[in] generationNumber the integer number of the current
          * generation. \param[in] mode the LearningMode to use during the policy
-         * evaluation. \param[in] results Map to store the resulting score of
-         * evaluated roots.
+         * evaluation. \param[in] results ResultsTable to store the resulting
+         * score of evaluated roots.
          */
-        virtual void evaluateAllRootsInParallel(
-            uint64_t generationNumber, LearningMode mode,
-            std::multimap<std::shared_ptr<EvaluationResult>,
-                          const TPG::TPGVertex*>& results);
+        virtual void evaluateAllRootsInParallel(uint64_t generationNumber,
+                                                LearningMode mode,
+                                                ResultsTable& results);
 
         /**
          * \brief Subfunction of evaluateAllRootsInParallel which handles the
@@ -103,17 +210,89 @@ namespace Learn {
                 resultsPerJobMap,
             std::map<uint64_t, Archive*>& archiveMap);
 
+        /**
+         * \brief Execute a queue of jobs with maxNbThreads threads.
+         *
+         * Jobs are dispatched with scheduleJobs, results are stored in the
+         * resultsPerJobMap and Archive of each chunk in the archiveMap.
+         *
+         * When the affinity policy pins the threads on several NUMA nodes,
+         * single-root jobs are evaluated with a GraphReplica of their node.
+         * Recordings of the Archive made with the Program of a replica are
+         * replaced with the original Program, so the training outcome is
+         * unchanged.
+         *
+         * \param[in] generationNumber the integer number of the current
+         * generation.
+         * \param[in] mode the LearningMode to use during the policy
+         * evaluation.
+         * \param[in,out] jobs the queue of jobs to execute.
+         * \param[out] resultsPerJobMap map linking the job number with its
+         * results and itself.
+         * \param[out] archiveMap map linking the job number with its
+         * gathered archive.
+         */
+        void executeJobsInParallel(
+            uint64_t generationNumber, LearningMode mode,
+            std::queue<std::shared_ptr<Learn::Job>>& jobs,
+            std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>,
+                                         std::shared_ptr<Job>>>&
+                resultsPerJobMap,
+            std::map<uint64_t, Archive*>& archiveMap);
+
+        /**
+         * \brief Split the iterations of root evaluations into several jobs.
+         *
+         * When params.maxNbIterationsPerJob is non zero and lower than
+         * params.nbIterationsPerPolicyEvaluation, each single-root Job is
+         * replaced with consecutive Job covering at most
+         * maxNbIterationsPerJob iterations each. The archive seed of each
+         * partial Job is offset by its first iteration. Jobs are renumbered
+         * consecutively. Jobs with several roots, and roots whose evaluation
+         * is skipped in TRAINING mode, are not split.
+         *
+         * \param[in,out] jobs the queue of jobs to split, emptied by the
+         * call.
+         * \param[in] mode the LearningMode of the evaluation.
+         * \return the queue of split jobs.
+         */
+        std::queue<std::shared_ptr<Learn::Job>> splitJobs(
+            std::queue<std::shared_ptr<Learn::Job>>& jobs,
+            LearningMode mode) const;
+
+        /**
+         * \brief Fold the results of partial jobs into a single result per
+         * root.
+         *
+         * Results of consecutive partial jobs of a root are accumulated, in
+         * the order of their iterations, into the result of the first one.
+         * The entries of the other partial jobs are removed from the map. In
+         * TRAINING mode, the folded result is then combined with the
+         * previous results of the root, as evaluateJob does for complete
+         * jobs.
+         *
+         * \param[in,out] resultsPerJobMap map linking the job number with
+         * its results and itself.
+         * \param[in] mode the LearningMode of the evaluation.
+         */
+        void foldPartialResults(
+            std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>,
+                                         std::shared_ptr<Job>>>&
+                resultsPerJobMap,
+            LearningMode mode) const;
+
         /**
          * \brief Subfunction of evaluateAllRootsInParallel which handles the
          * gathering of results and the merge of the archives.
          *
-         * This method just emplaces results from resultsPerJobMap, as each
-         * job only contains 1 root is is quite easy.
+         * This method just adds results from resultsPerJobMap to the
+         * ResultsTable, as each job only contains 1 root is is quite easy.
          * The archive is merged with the mergeArchiveMap method.
          *
          * @param[in] resultsPerJobMap map linking the job number with its
          * results and itself.
-         * @param[out] results map linking single results to their root vertex.
+         * @param[out] results ResultsTable linking single results to their
+         * root vertex.
          * @param[in,out] archiveMap map linking the job number with its
          * gathered archive. These archive swill later be merged with the ones
          * of the other jobs.
@@ -122,9 +301,7 @@ namespace Learn {
             std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>,
                                          std::shared_ptr<Job>>>&
                 resultsPerJobMap,
-            std::multimap<std::shared_ptr<EvaluationResult>,
-                          const TPG::TPGVertex*>& results,
-            std::map<uint64_t, Archive*>& archiveMap);
+            ResultsTable& results, std::map<uint64_t, Archive*>& archiveMap);
 
         /**
          * \brief Function implementing the behavior of slave threads during
@@ -132,10 +309,11 @@ namespace Learn {
          *
          * \param[in] generationNumber the integer number of the current
          * generation. \param[in] mode the LearningMode to use during the policy
-         * evaluation. \param[in,out] jobsToProcess Ordered list of jobs of
-         * TPGVertex to process, stored as a pair with an id filling the
-         * archiveMap. The jobs are groups of roots that shall be agents in the
-         * same simulation, there is only 1 root if there is no adversarial
+         * evaluation. \param[in,out] jobsToProcess Ordered list of chunks of
+         * consecutive jobs of TPGVertex to process. Each chunk is evaluated
+         * with a single Archive, stored in the archiveMap with the index of
+         * its first job. The jobs are groups of roots that shall be agents in
+         * the same simulation, there is only 1 root if there is no adversarial
          * (e.g. if the environmnent is not multiplayer).
          * \param[in] rootsToProcessMutex Mutex protecting the
          * rootsToProcess \param[in] resultsPerRootMap Map to store the
@@ -145,17 +323,25 @@ namespace Learn {
          * archiveMapMutex Mutex protecting the archiveMap.
          * \param[in] useMainEnvironment Boolean that is true if we use the
          * declared LearningEnvironment, otherwise the method will clone it.
+         * \param[in] cpu CPU to which the thread is pinned before cloning the
+         * LearningEnvironment, or -1 to leave the thread unpinned. The CPUs
+         * of the thread are restored when the method returns.
+         * \param[in,out] replicas GraphReplica of each NUMA node, or nullptr
+         * to evaluate the TPGGraph. The replica of the node of the thread is
+         * built if needed.
          */
         void slaveEvalJobThread(
             uint64_t generationNumber, LearningMode mode,
-            std::queue<std::shared_ptr<Learn::Job>>& jobsToProcess,
+            std::queue<std::vector<std::shared_ptr<Learn::Job>>>&
+                jobsToProcess,
             std::mutex& rootsToProcessMutex,
             std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>,
                                          std::shared_ptr<Job>>>&
                 resultsPerRootMap,
             std::mutex& resultsPerRootMapMutex,
             std::map<uint64_t, Archive*>& archiveMap,
-            std::mutex& archiveMapMutex, bool useMainEnvironment);
+            std::mutex& archiveMapMutex, bool useMainEnvironment,
+            int cpu = -1, std::map<int, GraphReplica>* replicas = nullptr);
 
         /**
          * \brief Method to merge several Archive created in parallel
@@ -170,6 +356,37 @@ namespace Learn {
          */
         void mergeArchiveMap(std::map<uint64_t, Archive*>& archiveMap);
 
+        /**
+         * \brief Function implementing the behavior of worker threads during
+         * steady-state training.
+         *
+         * Each worker evaluates jobs from the pendingJobs queue, with its own
+         * clone of the LearningEnvironment and a dedicated Archive per job,
+         * and stores the outcome in the completedJobs queue. Workers never
+         * wait for each other: they only block when no pending job is
+         * available.
+         *
+         * \param[in,out] pendingJobs Queue of jobs to evaluate, each paired
+         * with the generation number used to seed its evaluation.
+         * \param[in,out] completedJobs Queue of evaluated jobs, each stored
+         * with its EvaluationResult and the Archive filled during its
+         * evaluation.
+         * \param[in] jobsMutex Mutex protecting both queues and the stop
+         * boolean.
+         * \param[in] pendingCondition Condition notified when a job is pushed
+         * in pendingJobs, or when stop is set.
+         * \param[in] completedCondition Condition notified by the worker
+         * when a job is pushed in completedJobs.
+         * \param[in] stop Boolean set to true to terminate the worker.
+         */
+        void slaveSteadyStateThread(
+            std::queue<std::pair<std::shared_ptr<Job>, uint64_t>>& pendingJobs,
+            std::queue<std::tuple<std::shared_ptr<Job>,
+                                  std::shared_ptr<EvaluationResult>, Archive*>>&
+                completedJobs,
+            std::mutex& jobsMutex, std::condition_variable& pendingCondition,
+            std::condition_variable& completedCondition, const bool& stop);
+
       public:
         /**
          * \brief Constructor for ParallelLearningAgent.
@@ -187,12 +404,33 @@ namespace Learn {
             LearningEnvironment& le, const Instructions::Set& iSet,
             const LearningParameters& p,
             const TPG::TPGFactory& factory = TPG::TPGFactory())
-            : LearningAgent(le, iSet, p, factory)
+            : LearningAgent(le, iSet, p, factory), affinity(p.threadAffinity)
         {
             // overriding the maxNbThreads that basic LA defined to 1
             maxNbThreads = p.nbThreads;
         };
 
+        /// Destructor, waiting for the pending validation.
+        virtual ~ParallelLearningAgent()
+        {
+            this->joinValidation();
+        };
+
+        /**
+         * \brief Get the throughput of evaluation threads per NUMA node.
+         *
+         * Each thread evaluating jobs in parallel accumulates its jobs,
+         * iterations and evaluation time in the entry of the NUMA node of its
+         * CPU.
+         *
+         * \return a copy of the map associating each NUMA node with its
+         * NodeThroughput.
+         */
+        std::map<int, NodeThroughput> getNodeThroughput() const;
+
+        /// Reset the throughput of all NUMA nodes.
+        void resetNodeThroughput();
+
         /**
          * \brief Evaluate all root TPGVertex of the TPGGraph.
          *
@@ -203,15 +441,104 @@ namespace Learn {
          * exact same manner.
          *
          * This method calls the evaluateJob method for every root TPGVertex
-         * of the TPGGraph. The method returns a sorted map associating each
-         * root vertex to its average score, in ascending order or score.
+         * of the TPGGraph. The method returns a ResultsTable associating each
+         * root vertex to its EvaluationResult, with one row per root in the
+         * order of the TPGGraph roots.
          *
          * \param[in] generationNumber the integer number of the current
          * generation. \param[in] mode the LearningMode to use during the policy
          * evaluation.
          */
-        std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>
-        evaluateAllRoots(uint64_t generationNumber, LearningMode mode) override;
+        ResultsTable evaluateAllRoots(uint64_t generationNumber,
+                                      LearningMode mode) override;
+
+        /**
+         * \brief Evaluate one root TPGVertex of the TPGGraph.
+         *
+         * **Replaces the function from the base class LearningAgent.**
+         *
+         * When params.maxNbIterationsPerJob is non zero, the iterations of
+         * the root evaluation are split into several jobs executed by
+         * maxNbThreads threads. Otherwise, the sequential evaluation of the
+         * base class is used.
+         *
+         * \param[in] generationNumber the integer number of the current
+         * generation.
+         * \param[in] mode the LearningMode to use during the policy
+         * evaluation.
+         * \param[in] root the evaluated TPGVertex of the TPGGraph.
+         * \return the averaged EvaluationResult for the given TPGVertex.
+         * \throws std::runtime_error in case the given root does not exist
+         * in the TPGGraph.
+         */
+        std::shared_ptr<EvaluationResult> evaluateOneRoot(
+            uint64_t generationNumber, LearningMode mode,
+            const TPG::TPGVertex* root) override;
+
+        /**
+         * \brief Evaluate in validation mode the roots of a copy of the
+         * TPGGraph with several threads.
+         *
+         * **Replaces the function from the base class LearningAgent.**
+         *
+         * Roots are distributed dynamically to maxNbThreads worker threads,
+         * each using its own clone of the LearningEnvironment. Results are
+         * identical to the sequential evaluation.
+         */
+        ResultsTable evaluateValidationSnapshot(
+            const TPG::TPGGraph& snapshot,
+            const std::vector<const TPG::TPGVertex*>& snapshotRoots,
+            const std::vector<const TPG::TPGVertex*>& roots,
+            uint64_t generationNumber) const override;
+
+        /**
+         * \brief Train the TPGGraph in steady-state mode.
+         *
+         * Contrary to the train method, there is no generational barrier.
+         * Worker threads keep evaluating newly created roots while the
+         * calling thread, which is the only one modifying the TPGGraph,
+         * processes each result as soon as it arrives:
+         * - The result is recorded in resultsPerRoot and bestRoot.
+         * - When workers are about to run out of jobs, the worst evaluated
+         *   root TPGTeam is removed from the TPGGraph, and a new root
+         *   TPGTeam is created by mutation of a random root TPGTeam. Roots
+         *   uncovered by the removal are queued for evaluation with the new
+         *   root.
+         *
+         * Roots that are queued or being evaluated are never removed, and
+         * TPGGraph updates only touch vertices unreachable from them, so
+         * workers only synchronize when exchanging jobs.
+         *
+         * The training stops after params.nbGenerations times
+         * floor(params.ratioDeletedRoots * params.mutation.tpg.nbRoots) root
+         * replacements (i.e. the same number of new roots as the train
+         * method), or when altTraining becomes true.
+         *
+         * Every nbEvaluationsPerReport evaluations, the
+         * LALogger::logSteadyStateReport method of all loggers is called.
+         * Validation is not performed in this mode.
+         *
+         * If the LearningEnvironment is not copyable, or if the number of
+         * threads is lower than 2, evaluations are done sequentially in the
+         * calling thread, and the training is deterministic. Otherwise, the
+         * order of results depends on the duration of evaluations and the
+         * training is not deterministic.
+         *
+         * This training mode is not supported for AdversarialLearningAgent,
+         * whose jobs gather several roots.
+         *
+         * \param[in] altTraining a reference to a boolean value that can be
+         * used to halt the training process before its completion.
+         * \param[in] nbEvaluationsPerReport number of completed evaluations
+         * between two calls to the loggers. If 0, loggers are called every
+         * floor(params.ratioDeletedRoots * params.mutation.tpg.nbRoots)
+         * evaluations.
+         * \return the number of completed generation equivalents, i.e. the
+         * number of root replacements divided by the number of roots
+         * replaced per generation in the train method.
+         */
+        uint64_t trainSteadyState(volatile bool& altTraining,
+                                  uint64_t nbEvaluationsPerReport = 0);
     };
 } // namespace Learn
 #endif
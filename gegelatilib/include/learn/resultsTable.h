@@ -0,0 +1,266 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef RESULTS_TABLE_H
+#define RESULTS_TABLE_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "learn/evaluationResult.h"
+#include "tpg/tpgVertex.h"
+
+namespace Learn {
+    /**
+     * \brief Flat table storing the EvaluationResult of all roots evaluated
+     * during a generation.
+     *
+     * Each row of the table corresponds to one evaluated root. Rows are stored
+     * in the order in which they were added, which is the deterministic order
+     * of the jobs created by the LearningAgent. Results are stored in
+     * columns: evaluated root, EvaluationResult, score, number of evaluations,
+     * inference cost and, for ClassificationEvaluationResult only, score per
+     * class.
+     *
+     * Rows can be ranked by score. In this ranking, ties between equal scores
+     * are broken using the row index, a row added later being considered
+     * better than a row added earlier. Hence, ranking a ResultsTable is fully
+     * deterministic.
+     */
+    class ResultsTable
+    {
+      protected:
+        /// Column of evaluated roots.
+        std::vector<const TPG::TPGVertex*> roots;
+
+        /// Column of EvaluationResult of the roots.
+        std::vector<std::shared_ptr<EvaluationResult>> evaluationResults;
+
+        /// Column of scores, cached from evaluationResults.
+        std::vector<double> scores;
+
+        /// Column of number of evaluations, cached from evaluationResults.
+        std::vector<size_t> nbEvaluations;
+
+        /// Column of inference costs, cached from evaluationResults.
+        std::vector<double> inferenceCosts;
+
+        /**
+         * \brief Number of classes of the score per class columns.
+         *
+         * Value is 0 if the table contains no ClassificationEvaluationResult.
+         */
+        size_t nbClasses = 0;
+
+        /**
+         * \brief Row-major storage of the scores per class.
+         *
+         * Score of class c for row r is stored at index r * nbClasses + c.
+         */
+        std::vector<double> scoresPerClass;
+
+        /**
+         * \brief Strict total order used to rank rows in ascending order of
+         * score.
+         *
+         * \param[in] rowA index of the first row.
+         * \param[in] rowB index of the second row.
+         * \return true if rowA is ranked strictly before rowB.
+         */
+        bool isRowWorse(size_t rowA, size_t rowB) const;
+
+      public:
+        /// Default constructor building an empty table.
+        ResultsTable() = default;
+
+        /**
+         * \brief Reserve memory for the given number of rows.
+         *
+         * \param[in] nbRows the number of rows to reserve.
+         */
+        void reserve(size_t nbRows);
+
+        /**
+         * \brief Add a row at the end of the table.
+         *
+         * If the given EvaluationResult is a ClassificationEvaluationResult,
+         * its scores per class are copied in the table. All
+         * ClassificationEvaluationResult of a table must have the same number
+         * of classes.
+         *
+         * \param[in] root the evaluated root.
+         * \param[in] result the EvaluationResult of the root.
+         * \return the index of the added row.
+         * \throw std::runtime_error if the number of classes of a
+         * ClassificationEvaluationResult does not match the table.
+         */
+        size_t addRow(const TPG::TPGVertex* root,
+                      const std::shared_ptr<EvaluationResult>& result);
+
+        /// Get the number of rows in the table.
+        size_t size() const;
+
+        /// Check whether the table has no row.
+        bool empty() const;
+
+        /// Remove all rows from the table.
+        void clear();
+
+        /// Get the root of a row.
+        const TPG::TPGVertex* getRoot(size_t row) const;
+
+        /// Get the EvaluationResult of a row.
+        const std::shared_ptr<EvaluationResult>& getEvaluationResult(
+            size_t row) const;
+
+        /// Get the score of a row.
+        double getScore(size_t row) const;
+
+        /// Get the number of evaluations of a row.
+        size_t getNbEvaluation(size_t row) const;
+
+        /// Get the inference cost of a row.
+        double getInferenceCost(size_t row) const;
+
+        /// Get the number of classes of the score per class columns.
+        size_t getNbClasses() const;
+
+        /**
+         * \brief Get the score of a row for a given class.
+         *
+         * \throw std::out_of_range if the table has no score for this class.
+         */
+        double getScorePerClass(size_t row, size_t classIdx) const;
+
+        /// Get a const reference to the column of roots.
+        const std::vector<const TPG::TPGVertex*>& getRoots() const;
+
+        /// Get a const reference to the column of scores.
+        const std::vector<double>& getScores() const;
+
+        /**
+         * \brief Get the row index of the root, if any.
+         *
+         * \return the index of the first row of the given root, or size() if
+         * the root is not in the table.
+         */
+        size_t findRow(const TPG::TPGVertex* root) const;
+
+        /**
+         * \brief Get the index of the best row of the table.
+         *
+         * \throw std::runtime_error if the table is empty.
+         */
+        size_t getBestRow() const;
+
+        /// Get the minimum score of the table, 0.0 if the table is empty.
+        double getMinScore() const;
+
+        /// Get the maximum score of the table, 0.0 if the table is empty.
+        double getMaxScore() const;
+
+        /// Get the average score of the table, 0.0 if the table is empty.
+        double getAvgScore() const;
+
+        /**
+         * \brief Get the indexes of all rows, sorted in ascending order of
+         * score.
+         */
+        std::vector<size_t> getSortedRows() const;
+
+        /**
+         * \brief Get the indexes of the nbRows worst rows, in ascending order
+         * of score.
+         *
+         * Only the worst rows are sorted, using a partial sort.
+         *
+         * \param[in] nbRows the number of rows to return, clamped to size().
+         */
+        std::vector<size_t> getWorstRows(size_t nbRows) const;
+
+        /**
+         * \brief Get the indexes of the nbRows worst rows, in ascending order
+         * of score penalized with their inference cost.
+         *
+         * The penalized score of a row is its score minus costPenalty times
+         * its inference cost. Ties are broken with the score, then with the
+         * row index.
+         *
+         * \param[in] nbRows the number of rows to return, clamped to size().
+         * \param[in] costPenalty the weight of inference costs.
+         */
+        std::vector<size_t> getWorstRows(size_t nbRows,
+                                         double costPenalty) const;
+
+        /**
+         * \brief Get the indexes of the nbRows worst rows, ranked on the
+         * Pareto fronts of their score and inference cost.
+         *
+         * A row dominates another if its score is not lower, its cost is not
+         * higher, and one of them is strictly better. Rows of the first front
+         * are dominated by no row, rows of the second front only by rows of
+         * the first, and so on. Rows of the last front are returned first.
+         * Within a front, rows are ranked as in getWorstRows(nbRows,
+         * costPenalty).
+         *
+         * \param[in] nbRows the number of rows to return, clamped to size().
+         * \param[in] costPenalty the weight of inference costs within fronts.
+         */
+        std::vector<size_t> getParetoWorstRows(size_t nbRows,
+                                               double costPenalty) const;
+
+        /**
+         * \brief Get the indexes of the nbRows best rows, in descending order
+         * of score.
+         *
+         * Only the best rows are sorted, using a partial sort.
+         *
+         * \param[in] nbRows the number of rows to return, clamped to size().
+         */
+        std::vector<size_t> getBestRows(size_t nbRows) const;
+
+        /**
+         * \brief Remove a set of rows from the table.
+         *
+         * The relative order of remaining rows is preserved.
+         *
+         * \param[in] removedRows vector of size() booleans where true marks a
+         * row to remove.
+         * \throw std::runtime_error if removedRows size differs from size().
+         */
+        void removeRows(const std::vector<bool>& removedRows);
+    };
+} // namespace Learn
+
+#endif
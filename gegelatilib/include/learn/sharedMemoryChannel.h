@@ -0,0 +1,314 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef SHARED_MEMORY_CHANNEL_H
+#define SHARED_MEMORY_CHANNEL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace Learn {
+    /**
+     * \brief Channel between a LearningEnvironment and a simulator running
+     * in another local process, through a POSIX shared-memory region.
+     *
+     * The region contains a header, two lock-free single-producer
+     * single-consumer rings of Message, and an observation buffer. The
+     * requests ring carries reset and action requests from the learning
+     * process to the simulator, and the responses ring carries the score and
+     * terminal state of the simulator back once the observation buffer is
+     * updated.
+     *
+     * The process creating the region owns it, and unlinks it on destruction.
+     * Other processes attach to the region with its name. The pid of both
+     * processes is stored in the header, so that a process waiting for a
+     * Message can detect the termination of its peer.
+     *
+     * Waiting operations first spin for a short time, to keep the latency of
+     * the ping-pong between the two processes low, then block on a futex
+     * (on Linux) until the ring is updated by the peer.
+     *
+     * Shared memory is only supported on POSIX systems.
+     */
+    class SharedMemoryChannel
+    {
+      public:
+        /// Types of Message exchanged through the channel.
+        enum class MessageType : uint32_t
+        {
+            RESET = 1,
+            ACTION = 2,
+            RESULT = 3,
+            CLOSE = 4
+        };
+
+        /// Message exchanged through the rings of the channel.
+        struct Message
+        {
+            /// Type of the message.
+            MessageType type;
+
+            /// LearningMode of a RESET message.
+            uint32_t mode;
+
+            /// Action of an ACTION message.
+            uint64_t actionID;
+
+            /// Seed of a RESET message.
+            uint64_t seed;
+
+            /// Iteration number of a RESET message.
+            uint64_t iterationNumber;
+
+            /// Generation number of a RESET message.
+            uint64_t generationNumber;
+
+            /// Score of a RESULT message.
+            double score;
+
+            /// Terminal state of a RESULT message.
+            uint64_t terminal;
+        };
+
+        /// Number of Message in each ring.
+        static const size_t RING_SIZE = 64;
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                          std::atomic<uint32_t>::is_always_lock_free,
+                      "Shared-memory rings need lock-free atomics.");
+
+        /**
+         * \brief Create a new shared-memory region.
+         *
+         * \param[in] name the name of the region, starting with a '/'.
+         * \param[in] nbActions the number of actions of the simulator.
+         * \param[in] observationSize the size in bytes of the observation
+         * buffer.
+         * \throws std::runtime_error if the region cannot be created.
+         */
+        SharedMemoryChannel(const std::string& name, uint64_t nbActions,
+                            size_t observationSize);
+
+        /**
+         * \brief Attach to an existing shared-memory region.
+         *
+         * \param[in] name the name of the region.
+         * \throws std::runtime_error if the region cannot be opened or is not
+         * a SharedMemoryChannel region.
+         */
+        explicit SharedMemoryChannel(const std::string& name);
+
+        /// Copy is not allowed.
+        SharedMemoryChannel(const SharedMemoryChannel& other) = delete;
+
+        /// Unmap the region, and unlink it if it was created by this object.
+        ~SharedMemoryChannel();
+
+        /// Get the name of the region.
+        const std::string& getName() const;
+
+        /// Get the number of actions of the simulator.
+        uint64_t getNbActions() const;
+
+        /// Get the size in bytes of the observation buffer.
+        size_t getObservationSize() const;
+
+        /// Get a pointer to the observation buffer.
+        void* getObservation() const;
+
+        /**
+         * \brief Push a request, from the learning process.
+         *
+         * \return false if the requests ring is full.
+         */
+        bool pushRequest(const Message& message);
+
+        /**
+         * \brief Pop a request, from the simulator.
+         *
+         * \return false if the requests ring is empty.
+         */
+        bool popRequest(Message& message);
+
+        /**
+         * \brief Push a response, from the simulator.
+         *
+         * \return false if the responses ring is full.
+         */
+        bool pushResponse(const Message& message);
+
+        /**
+         * \brief Pop a response, from the learning process.
+         *
+         * \return false if the responses ring is empty.
+         */
+        bool popResponse(Message& message);
+
+        /**
+         * \brief Push a request, waiting for room in the requests ring.
+         *
+         * \param[in] message the Message to push.
+         * \param[in] timeout the maximum waiting time, or 0 to wait until the
+         * Message is pushed.
+         * \return false if the ring is still full after the timeout.
+         * \throws std::runtime_error if the peer process terminated.
+         */
+        bool pushRequest(const Message& message,
+                         std::chrono::milliseconds timeout);
+
+        /**
+         * \brief Pop a request, waiting for a request from the learning
+         * process.
+         *
+         * \param[out] message the popped Message.
+         * \param[in] timeout the maximum waiting time, or 0 to wait until a
+         * Message is popped.
+         * \return false if the ring is still empty after the timeout.
+         * \throws std::runtime_error if the peer process terminated.
+         */
+        bool popRequest(Message& message, std::chrono::milliseconds timeout);
+
+        /**
+         * \brief Push a response, waiting for room in the responses ring.
+         *
+         * \see pushRequest(const Message&, std::chrono::milliseconds)
+         */
+        bool pushResponse(const Message& message,
+                          std::chrono::milliseconds timeout);
+
+        /**
+         * \brief Pop a response, waiting for a response from the simulator.
+         *
+         * \see popRequest(Message&, std::chrono::milliseconds)
+         */
+        bool popResponse(Message& message, std::chrono::milliseconds timeout);
+
+        /**
+         * \brief Check whether the peer process is still running.
+         *
+         * The peer of the owner of the region is the last process attached
+         * to it. A peer that has not attached yet is considered alive.
+         * A terminated peer that was not reaped by its parent process is
+         * also considered alive, until the timeout of waiting operations.
+         */
+        bool isPeerAlive() const;
+
+      protected:
+        /// Single-producer single-consumer ring of Message.
+        struct Ring
+        {
+            /// Index of the next Message to pop.
+            alignas(64) std::atomic<uint64_t> head;
+
+            /// Index of the next Message to push.
+            alignas(64) std::atomic<uint64_t> tail;
+
+            /// Counter incremented on each push and pop, used as a futex.
+            alignas(64) std::atomic<uint32_t> event;
+
+            /// Number of processes blocked on the event futex.
+            std::atomic<uint32_t> nbWaiters;
+
+            /// Storage of the ring.
+            Message messages[RING_SIZE];
+        };
+
+        /// Header of the shared-memory region.
+        struct Header
+        {
+            /// Magic number identifying the region.
+            uint64_t magic;
+
+            /// Number of actions of the simulator.
+            uint64_t nbActions;
+
+            /// Size in bytes of the observation buffer.
+            uint64_t observationSize;
+
+            /// Pid of the process owning the region.
+            std::atomic<int64_t> ownerPid;
+
+            /// Pid of the last process attached to the region, or 0.
+            std::atomic<int64_t> peerPid;
+
+            /// Ring of requests, from the learning process to the simulator.
+            Ring requests;
+
+            /// Ring of responses, from the simulator to the learning process.
+            Ring responses;
+        };
+
+        /// Name of the region.
+        std::string name;
+
+        /// Mapped region.
+        Header* header;
+
+        /// Size in bytes of the mapped region.
+        size_t regionSize;
+
+        /// Whether the region was created by this object.
+        bool owner;
+
+        /// Offset of the observation buffer in the region.
+        static size_t getObservationOffset();
+
+        /// Push a Message in a ring.
+        static bool push(Ring& ring, const Message& message);
+
+        /// Pop a Message from a ring.
+        static bool pop(Ring& ring, Message& message);
+
+        /// Signal an update of a ring to a blocked peer.
+        static void notify(Ring& ring);
+
+        /**
+         * \brief Retry an operation on a ring until it succeeds.
+         *
+         * \param[in] ring the Ring updated by the peer process.
+         * \param[in] operation the push or pop operation to retry.
+         * \param[in] timeout the maximum waiting time, or 0 for no limit.
+         * \return false if the operation did not succeed before the timeout.
+         * \throws std::runtime_error if the peer process terminated.
+         */
+        bool waitFor(Ring& ring, const std::function<bool()>& operation,
+                     std::chrono::milliseconds timeout) const;
+    };
+} // namespace Learn
+
+#endif
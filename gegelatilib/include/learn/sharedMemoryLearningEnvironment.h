@@ -0,0 +1,394 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef SHARED_MEMORY_LEARNING_ENVIRONMENT_H
+#define SHARED_MEMORY_LEARNING_ENVIRONMENT_H
+
+#include <chrono>
+#include <stdexcept>
+
+#include "data/arrayWrapper.h"
+#include "learn/learningEnvironment.h"
+#include "learn/sharedMemoryChannel.h"
+
+namespace Learn {
+    /**
+     * \brief LearningEnvironment adapter for a simulator running in another
+     * local process.
+     *
+     * The adapter creates a SharedMemoryChannel, to which the simulator
+     * attaches, for example with a SharedMemoryEnvironmentServer. The single
+     * data source of the adapter is an ArrayWrapper viewing the observation
+     * buffer of the shared-memory region, so observations written by the
+     * simulator are never copied.
+     *
+     * Actions are submitted asynchronously: the observation buffer must not
+     * be read by the learning process while an action is in flight, which is
+     * guaranteed by the LearningEnvironment asynchronous interface.
+     *
+     * Waiting for the simulator throws an exception if the simulator process
+     * terminated, or if it does not answer within a configurable timeout.
+     *
+     * \tparam T the type of observation elements.
+     */
+    template <class T> class SharedMemoryLearningEnvironment
+        : public LearningEnvironment
+    {
+      protected:
+        /// Channel with the simulator.
+        SharedMemoryChannel channel;
+
+        /// View of the observation buffer of the channel.
+        Data::ArrayWrapper<T> observation;
+
+        /// Score received with the last response of the simulator.
+        double score;
+
+        /// Terminal state received with the last response of the simulator.
+        bool terminal;
+
+        /// Whether a request waits for the response of the simulator.
+        bool requestPending;
+
+        /// Maximum waiting time for the simulator, or 0 for no limit.
+        std::chrono::milliseconds timeout;
+
+        /**
+         * \brief Push a request to the simulator, waiting if the ring is
+         * full.
+         *
+         * \throws std::runtime_error if the simulator terminated or did not
+         * accept the request before the timeout.
+         */
+        void sendRequest(const SharedMemoryChannel::Message& message)
+        {
+            if (!this->channel.pushRequest(message, this->timeout)) {
+                throw std::runtime_error("Simulator of shared memory " +
+                                         this->channel.getName() +
+                                         " did not accept a request in time.");
+            }
+            this->requestPending = true;
+        }
+
+        /// Store the content of a response of the simulator.
+        void receiveResponse(const SharedMemoryChannel::Message& message)
+        {
+            this->score = message.score;
+            this->terminal = message.terminal != 0;
+            this->observation.invalidateCachedHash();
+            this->requestPending = false;
+        }
+
+      public:
+        /// Default maximum waiting time for the simulator.
+        static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT{60000};
+
+        /**
+         * \brief Constructor creating the shared-memory region.
+         *
+         * \param[in] name the name of the shared-memory region, starting with
+         * a '/'.
+         * \param[in] nbActions the number of actions of the simulator.
+         * \param[in] nbObservations the number of elements of the
+         * observation.
+         * \throws std::runtime_error if the region cannot be created.
+         */
+        SharedMemoryLearningEnvironment(const std::string& name,
+                                        uint64_t nbActions,
+                                        size_t nbObservations)
+            : LearningEnvironment(nbActions),
+              channel(name, nbActions, nbObservations * sizeof(T)),
+              observation(nbObservations), score{0.0}, terminal{false},
+              requestPending{false}, timeout{DEFAULT_TIMEOUT}
+        {
+            this->observation.setView(
+                static_cast<const T*>(this->channel.getObservation()));
+        };
+
+        /// Destructor, asking the simulator to stop.
+        ~SharedMemoryLearningEnvironment()
+        {
+            SharedMemoryChannel::Message message{};
+            message.type = SharedMemoryChannel::MessageType::CLOSE;
+            this->channel.pushRequest(message);
+        };
+
+        /// Get the channel with the simulator.
+        const SharedMemoryChannel& getChannel() const
+        {
+            return this->channel;
+        };
+
+        /// Get the maximum waiting time for the simulator.
+        std::chrono::milliseconds getTimeout() const
+        {
+            return this->timeout;
+        };
+
+        /**
+         * \brief Set the maximum waiting time for the simulator.
+         *
+         * \param[in] newTimeout the new timeout, or 0 for no limit.
+         */
+        void setTimeout(std::chrono::milliseconds newTimeout)
+        {
+            this->timeout = newTimeout;
+        };
+
+        /// Inherited from LearningEnvironment. Returns true.
+        bool isAsynchronous() const override
+        {
+            return true;
+        };
+
+        /// Inherited from LearningEnvironment.
+        void submitAction(uint64_t actionID) override
+        {
+            // Check the actionID
+            LearningEnvironment::doAction(actionID);
+            this->awaitAction();
+
+            SharedMemoryChannel::Message message{};
+            message.type = SharedMemoryChannel::MessageType::ACTION;
+            message.actionID = actionID;
+            this->sendRequest(message);
+        };
+
+        /// Inherited from LearningEnvironment.
+        bool pollAction() override
+        {
+            if (!this->requestPending) {
+                return true;
+            }
+            SharedMemoryChannel::Message message;
+            if (!this->channel.popResponse(message)) {
+                return false;
+            }
+            this->receiveResponse(message);
+            return true;
+        };
+
+        /**
+         * \brief Inherited from LearningEnvironment.
+         *
+         * \throws std::runtime_error if the simulator terminated or did not
+         * respond before the timeout.
+         */
+        void awaitAction() override
+        {
+            if (!this->requestPending) {
+                return;
+            }
+            SharedMemoryChannel::Message message;
+            if (!this->channel.popResponse(message, this->timeout)) {
+                throw std::runtime_error("Simulator of shared memory " +
+                                         this->channel.getName() +
+                                         " did not respond in time.");
+            }
+            this->receiveResponse(message);
+        };
+
+        /// Inherited from LearningEnvironment.
+        void doAction(uint64_t actionID) override
+        {
+            this->submitAction(actionID);
+            this->awaitAction();
+        };
+
+        /// Inherited from LearningEnvironment.
+        void reset(size_t seed = 0, LearningMode mode = LearningMode::TRAINING,
+                   uint16_t iterationNumber = 0,
+                   uint64_t generationNumber = 0) override
+        {
+            this->awaitAction();
+
+            SharedMemoryChannel::Message message{};
+            message.type = SharedMemoryChannel::MessageType::RESET;
+            message.mode = (uint32_t)mode;
+            message.seed = seed;
+            message.iterationNumber = iterationNumber;
+            message.generationNumber = generationNumber;
+            this->sendRequest(message);
+            this->awaitAction();
+        };
+
+        /// Inherited from LearningEnvironment.
+        std::vector<std::reference_wrapper<const Data::DataHandler>>
+        getDataSources() override
+        {
+            return {this->observation};
+        };
+
+        /// Inherited from LearningEnvironment.
+        double getScore() const override
+        {
+            return this->score;
+        };
+
+        /// Inherited from LearningEnvironment.
+        bool isTerminal() const override
+        {
+            return this->terminal;
+        };
+    };
+
+    /**
+     * \brief Simulator side of a SharedMemoryLearningEnvironment, serving a
+     * LearningEnvironment of the simulator process.
+     *
+     * The elements of type T of all data sources of the served
+     * LearningEnvironment are copied, in order, to the observation buffer of
+     * the SharedMemoryChannel after each request.
+     *
+     * \tparam T the type of observation elements.
+     */
+    template <class T> class SharedMemoryEnvironmentServer
+    {
+      protected:
+        /// Channel with the learning process.
+        SharedMemoryChannel channel;
+
+        /// Served LearningEnvironment.
+        LearningEnvironment& learningEnvironment;
+
+        /// Maximum waiting time for the learning process, or 0 for no limit.
+        std::chrono::milliseconds timeout;
+
+        /// Copy the observation of the LearningEnvironment in the channel.
+        void writeObservation()
+        {
+            T* dst = static_cast<T*>(this->channel.getObservation());
+            for (const Data::DataHandler& dataSource :
+                 this->learningEnvironment.getDataSources()) {
+                size_t size = dataSource.getAddressSpace(typeid(T));
+                for (size_t i = 0; i < size; i++) {
+                    *dst++ = *dataSource.getDataAt(typeid(T), i)
+                                  .template getSharedPointer<const T>();
+                }
+            }
+        }
+
+      public:
+        /**
+         * \brief Constructor attaching to the shared-memory region.
+         *
+         * \param[in] name the name of the shared-memory region.
+         * \param[in] le the LearningEnvironment to serve.
+         * \throws std::runtime_error if the region cannot be opened, or if its
+         * number of actions or observation size do not match the
+         * LearningEnvironment.
+         */
+        SharedMemoryEnvironmentServer(const std::string& name,
+                                      LearningEnvironment& le)
+            : channel(name), learningEnvironment(le),
+              timeout{std::chrono::milliseconds::zero()}
+        {
+            size_t nbObservations = 0;
+            for (const Data::DataHandler& dataSource : le.getDataSources()) {
+                nbObservations += dataSource.getAddressSpace(typeid(T));
+            }
+            if (le.getNbActions() != this->channel.getNbActions() ||
+                nbObservations * sizeof(T) !=
+                    this->channel.getObservationSize()) {
+                throw std::runtime_error(
+                    "LearningEnvironment does not match shared memory " +
+                    name + ".");
+            }
+        };
+
+        /**
+         * \brief Set the maximum waiting time for the learning process.
+         *
+         * By default, the server waits without limit, since the learning
+         * process may be busy between two requests (e.g. to mutate the
+         * TPGGraph). The termination of the learning process is always
+         * detected.
+         *
+         * \param[in] newTimeout the new timeout, or 0 for no limit.
+         */
+        void setTimeout(std::chrono::milliseconds newTimeout)
+        {
+            this->timeout = newTimeout;
+        };
+
+        /**
+         * \brief Serve requests until a CLOSE request is received.
+         *
+         * \throws std::runtime_error if the learning process terminated or
+         * did not communicate before the timeout.
+         */
+        void serve()
+        {
+            SharedMemoryChannel::Message request;
+            while (true) {
+                if (!this->channel.popRequest(request, this->timeout)) {
+                    throw std::runtime_error(
+                        "No request received from shared memory " +
+                        this->channel.getName() + " in time.");
+                }
+
+                switch (request.type) {
+                    case SharedMemoryChannel::MessageType::RESET:
+                        this->learningEnvironment.reset(
+                            request.seed, (LearningMode)request.mode,
+                            (uint16_t)request.iterationNumber,
+                            request.generationNumber);
+                        break;
+                    case SharedMemoryChannel::MessageType::ACTION:
+                        this->learningEnvironment.doAction(request.actionID);
+                        break;
+                    case SharedMemoryChannel::MessageType::CLOSE:
+                        return;
+                    default:
+                        throw std::runtime_error(
+                            "Unexpected request in shared memory.");
+                }
+
+                this->writeObservation();
+
+                SharedMemoryChannel::Message response{};
+                response.type = SharedMemoryChannel::MessageType::RESULT;
+                response.score = this->learningEnvironment.getScore();
+                response.terminal = this->learningEnvironment.isTerminal();
+                if (!this->channel.pushResponse(response, this->timeout)) {
+                    throw std::runtime_error(
+                        "Response could not be sent to shared memory " +
+                        this->channel.getName() + " in time.");
+                }
+            }
+        };
+    };
+} // namespace Learn
+
+#endif
@@ -97,8 +97,7 @@ namespace Log {
          * \param[in] results scores of the evaluation.
          */
         virtual void logAfterEvaluate(
-            std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                          const TPG::TPGVertex*>& results) override;
+            const Learn::ResultsTable& results) override;
 
         /**
          * Inherited via LaLogger.
@@ -118,8 +117,7 @@ namespace Log {
          * \param[in] results scores of the validation.
          */
         virtual void logAfterValidate(
-            std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                          const TPG::TPGVertex*>& results) override;
+            const Learn::ResultsTable& results) override;
         /**
          * Inherited via LaLogger
          *
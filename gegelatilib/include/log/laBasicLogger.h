@@ -58,6 +58,25 @@ namespace Log {
          */
         int colWidth = 9;
 
+        /// Time at which the last populating step started.
+        std::chrono::time_point<std::chrono::system_clock,
+                                std::chrono::nanoseconds>
+            populateStart;
+
+        /**
+         * \brief Time at which the validation of the current generation
+         * ended.
+         *
+         * The validation may be delivered after the populating step of the
+         * next generation, so the total duration is measured up to this time.
+         */
+        std::chrono::time_point<std::chrono::system_clock,
+                                std::chrono::nanoseconds>
+            validationEnd;
+
+        /// Whether validationEnd was set for the current generation.
+        bool validationDone = false;
+
         /**
          * \brief Logs the min, avg and max score of the generation.
          *
@@ -65,8 +84,7 @@ namespace Log {
          * they both have the same input and want to log the same elements
          * (min, avg max).
          */
-        void logResults(std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                                      const TPG::TPGVertex*>& results);
+        void logResults(const Learn::ResultsTable& results);
 
       public:
         /**
@@ -79,7 +97,7 @@ namespace Log {
          */
         explicit LABasicLogger(Learn::LearningAgent& la,
                                std::ostream& out = std::cout)
-            : LALogger(la, out)
+            : LALogger(la, out), populateStart(getTime())
         {
             // fixing float precision
             *this << std::setprecision(2) << std::fixed << std::right;
@@ -103,6 +121,13 @@ namespace Log {
          */
         virtual void logNewGeneration(uint64_t& generationNumber) override;
 
+        /**
+         * Inherited via LALogger.
+         *
+         * \brief Starts measuring the mutation time.
+         */
+        virtual void logBeforePopulateTPG() override;
+
         /**
          * Inherited via LALogger.
          *
@@ -122,8 +147,7 @@ namespace Log {
          * \param[in] results scores of the evaluation.
          */
         virtual void logAfterEvaluate(
-            std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                          const TPG::TPGVertex*>& results) override;
+            const Learn::ResultsTable& results) override;
 
         /**
          * Inherited via LaLogger.
@@ -145,8 +169,7 @@ namespace Log {
          * \param[in] results scores of the validation.
          */
         virtual void logAfterValidate(
-            std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                          const TPG::TPGVertex*>& results) override;
+            const Learn::ResultsTable& results) override;
 
         /**
          * Inherited via LaLogger
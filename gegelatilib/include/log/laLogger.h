@@ -42,6 +42,7 @@
 #include <ostream>
 
 #include "learn/evaluationResult.h"
+#include "learn/resultsTable.h"
 #include "log/logger.h"
 #include "tpg/tpgGraph.h"
 
@@ -159,6 +160,20 @@ namespace Log {
          */
         virtual void logNewGeneration(uint64_t& generationNumber) = 0;
 
+        /**
+         * \brief Method called by the LearningAgent right before PopulateTPG
+         * starts.
+         *
+         * When the validation of the previous generation is pipelined, this
+         * method is called before the validation logs of the previous
+         * generation and before logNewGeneration(), since these are only
+         * delivered after the populating step. Loggers measuring the
+         * duration of the populating step should start it here.
+         *
+         * The default implementation does nothing.
+         */
+        virtual void logBeforePopulateTPG(){};
+
         /**
          * \brief Method called by the Learning Agent right after
          * PopulateTPG is done.
@@ -173,9 +188,7 @@ namespace Log {
          * \param[in] results scores of the evaluation.
          */
 
-        virtual void logAfterEvaluate(
-            std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                          const TPG::TPGVertex*>& results) = 0;
+        virtual void logAfterEvaluate(const Learn::ResultsTable& results) = 0;
 
         /**
          * \brief Method called by the Learning Agent right after the decimation
@@ -189,14 +202,29 @@ namespace Log {
          *
          * \param[in] results scores of the validation.
          */
-        virtual void logAfterValidate(
-            std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                          const TPG::TPGVertex*>& results) = 0;
+        virtual void logAfterValidate(const Learn::ResultsTable& results) = 0;
 
         /**
          * \brief Method called by the Learning Agent when the training is done
          */
         virtual void logEndOfTraining() = 0;
+
+        /**
+         * \brief Method called periodically by the LearningAgent when
+         * training in steady-state mode.
+         *
+         * In steady-state mode, there are no generations: roots are evaluated
+         * and replaced continuously. This method is called after a given
+         * number of completed evaluations instead of the per-generation
+         * callbacks. Its default implementation maps each report onto the
+         * per-generation callbacks (without validation), so that existing
+         * LALogger produce one line per report.
+         *
+         * \param[in] reportNumber Index of the current report.
+         * \param[in] results scores of the roots currently in the population.
+         */
+        virtual void logSteadyStateReport(uint64_t reportNumber,
+                                          const Learn::ResultsTable& results);
     };
 } // namespace Log
 
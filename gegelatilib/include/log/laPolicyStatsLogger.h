@@ -92,9 +92,7 @@ namespace Log {
         void logAfterDecimate() override;
 
         /// Inherited from LALogger
-        void logAfterValidate(
-            std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                          const TPG::TPGVertex*>& results) override{
+        void logAfterValidate(const Learn::ResultsTable& results) override{
             // nothing to log
         };
 
@@ -104,9 +102,7 @@ namespace Log {
         };
 
         /// Inherited from LALogger
-        void logAfterEvaluate(
-            std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                          const TPG::TPGVertex*>& results) override{
+        void logAfterEvaluate(const Learn::ResultsTable& results) override{
             // nothing to log
         };
     };
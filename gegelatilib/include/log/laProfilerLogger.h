@@ -0,0 +1,146 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef LA_PROFILER_LOGGER_H
+#define LA_PROFILER_LOGGER_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "log/laLogger.h"
+#include "util/profiler.h"
+
+namespace Log {
+    /**
+     * \brief LALogger exporting the measurements of the Util::Profiler.
+     *
+     * At the end of each generation, this LALogger collects the events,
+     * statistics and counters recorded by the Util::Profiler, and writes a
+     * line of JSON to its output stream, with:
+     * - "generation": the generation number.
+     * - "phases": the tree of profiled scopes, with the number of executions
+     * and the total time in seconds of each scope.
+     * - "counters": the counters, summed for all threads.
+     * - "threads": the evaluation time of each thread, in seconds.
+     * - "evaluationIdleTime": the time, summed for all evaluating threads,
+     * spent waiting during the evaluation phase, in seconds.
+     *
+     * Optionally, the events are also appended to a file in the Chrome
+     * trace-event format, which can be opened in chrome://tracing or
+     * Perfetto.
+     *
+     * Phases are only recorded by the library when it is compiled with the
+     * PROFILING CMake option. Per-thread times rely on the events of the
+     * "evaluateJob" scopes, which are kept with the default maximum trace
+     * depth of the Util::Profiler.
+     */
+    class LAProfilerLogger : public LALogger
+    {
+      protected:
+        /// Number of the current generation.
+        uint64_t generationNumber = 0;
+
+        /// File receiving the trace events, if any.
+        std::ofstream traceFile;
+
+        /// Whether an event was already written in the trace file.
+        bool traceStarted = false;
+
+        /**
+         * \brief Append events and counters to the trace file.
+         *
+         * \param[in] events the events of the generation.
+         * \param[in] counters the counters of the generation.
+         */
+        void writeTrace(const std::vector<Util::Profiler::Event>& events,
+                        const std::map<std::string, uint64_t>& counters);
+
+      public:
+        /**
+         * \brief Main constructor for the LAProfilerLogger.
+         *
+         * Enables the Util::Profiler, and discards measurements done before.
+         *
+         * \param[in] la LearningAgent whose information will be logged by the
+         * LAProfilerLogger.
+         * \param[in] out ostream where the logger will write its output.
+         * \param[in] traceFilePath path of the trace-event file, or an empty
+         * string for no trace.
+         * \throws std::runtime_error if the trace file can not be opened.
+         */
+        LAProfilerLogger(Learn::LearningAgent& la,
+                         std::ostream& out = std::cout,
+                         const std::string& traceFilePath = "");
+
+        /// Closes the trace file.
+        virtual ~LAProfilerLogger();
+
+        /// Inherited from LALogger
+        void logHeader() override{
+            // nothing to log
+        };
+
+        /// Inherited from LALogger
+        void logNewGeneration(uint64_t& generationNumber) override;
+
+        /// Inherited from LALogger
+        void logAfterPopulateTPG() override{
+            // nothing to log
+        };
+
+        /// Inherited from LALogger
+        void logAfterEvaluate(const Learn::ResultsTable& results) override{
+            // nothing to log
+        };
+
+        /// Inherited from LALogger
+        void logAfterDecimate() override{
+            // nothing to log
+        };
+
+        /// Inherited from LALogger
+        void logAfterValidate(const Learn::ResultsTable& results) override{
+            // nothing to log
+        };
+
+        /**
+         * Inherited from LALogger
+         *
+         * \brief Logs the measurements of the generation.
+         */
+        void logEndOfTraining() override;
+    };
+}; // namespace Log
+
+#endif // !LA_PROFILER_LOGGER_H
@@ -39,6 +39,10 @@
 #include <memory>
 #include <random>
 
+namespace File {
+    class LearningAgentCheckpoint;
+}
+
 namespace Mutator {
 
     /**
@@ -54,6 +58,9 @@ namespace Mutator {
         /// Mersenne twister MT19937 engine used for Random Number generation.
         std::unique_ptr<std::mt19937_64> engine;
 
+        // Friend relation needed to save and restore the engine state.
+        friend class File::LearningAgentCheckpoint;
+
       public:
         /**
          * \brief Default seeding constructor for RNG.
@@ -36,6 +36,7 @@
 #ifndef TPG_MUTATOR_H
 #define TPG_MUTATOR_H
 
+#include <map>
 #include <thread>
 
 #include "archive.h"
@@ -271,12 +272,45 @@ namespace Mutator {
          *               std::thread::hardware_concurrency().
          *   - `0` and `1`: Do not use parallelism.
          *   - `n > 1`: Set the number of threads explicitly.
+         * \param[out] rootParents if not nullptr, each new root TPGTeam is
+         * inserted in this map, associated to the root TPGTeam it was cloned
+         * from.
          */
         void populateTPG(
             TPG::TPGGraph& graph, const Archive& archive,
             const Mutator::MutationParameters& params, Mutator::RNG& rng,
             uint64_t nbActions,
-            uint64_t maxNbThreads = std::thread::hardware_concurrency());
+            uint64_t maxNbThreads = std::thread::hardware_concurrency(),
+            std::map<const TPG::TPGVertex*, const TPG::TPGVertex*>*
+                rootParents = nullptr);
+
+        /**
+         * \brief Create a single new root TPGTeam within the TPGGraph.
+         *
+         * This function duplicates a randomly selected root TPGTeam of the
+         * TPGGraph and applies mutation operators to the duplicate, exactly
+         * as the populateTPG function does for each new root. Contrary to
+         * populateTPG, the number of roots of the TPGGraph is not checked,
+         * which makes this function suited for incremental (steady-state)
+         * updates of the TPGGraph.
+         *
+         * Only the new TPGTeam, its outgoing TPGEdge, and the incoming
+         * TPGEdge lists of its destinations are modified by this function.
+         *
+         * \param[in,out] graph the TPGGraph to mutate.
+         * \param[in] archive Archive used to assess the uniqueness of the
+         *            mutated Program behavior.
+         * \param[in] params Probability parameters for the mutation.
+         * \param[in] rng Random Number Generator used in the mutation process.
+         * \param[in] maxNbThreads Integer parameter controlling the number of
+         * threads used for mutating the behavior of new Program.
+         * \return a pointer to the new root TPGTeam, or nullptr if the
+         * TPGGraph has no root TPGTeam to duplicate.
+         */
+        const TPG::TPGTeam* addMutatedRootTeam(
+            TPG::TPGGraph& graph, const Archive& archive,
+            const Mutator::MutationParameters& params, Mutator::RNG& rng,
+            uint64_t maxNbThreads = 1);
     }; // namespace TPGMutator
 };     // namespace Mutator
 
@@ -227,6 +227,18 @@ namespace Program {
          */
         bool isIntron(uint64_t index) const;
 
+        /**
+         * \brief Set the intron property of a Line.
+         *
+         * This method is used when importing a Program whose introns were
+         * identified beforehand, to avoid calling identifyIntrons() again.
+         *
+         * \param[in] index The integer index of the Line within the Program.
+         * \param[in] intron the new intron property of the Line.
+         * \throw std::out_of_range if the index is too large.
+         */
+        void setIntron(uint64_t index, bool intron);
+
         /**
          * \brief Scan the Line of the Program to identify introns.
          *
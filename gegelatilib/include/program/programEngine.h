@@ -291,21 +291,20 @@ namespace Program {
         // Check that T is either convertible to a const DataHandler
         static_assert(std::is_convertible<T&, const Data::DataHandler&>::value);
 
-        // Replace the references in attributes
-        this->dataSources = dataSrc;
-        // we need this offset to push the constant at the first
+        // Registers, and constants if any, precede the data sources.
         size_t offset =
-            this->program->getEnvironment().getNbConstant() > 0 ? 2 : 1;
-        if (offset == 2) {
-            this->dataScsConstsAndRegs.at(1) =
-                this->program->cGetConstantHandler();
-        }
+            this->dataScsConstsAndRegs.size() - this->dataSources.size();
+
+        // Replace the references in attributes
+        this->dataSources.assign(dataSrc.begin(), dataSrc.end());
         for (size_t idx = 0; idx < this->dataSources.size(); idx++) {
             this->dataScsConstsAndRegs.at(idx + offset) = dataSrc.at(idx);
         }
 
         // Set program to check compatibility with new data source
-        this->setProgram(*this->program);
+        if (this->program != NULL) {
+            this->setProgram(*this->program);
+        }
     }
 } // namespace Program
 
@@ -0,0 +1,97 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef PROGRAM_EXECUTION_ENGINE_INSTRUMENTED_H
+#define PROGRAM_EXECUTION_ENGINE_INSTRUMENTED_H
+
+#include <cstdint>
+#include <vector>
+
+#include "program/programExecutionEngine.h"
+#include "util/cycleCounter.h"
+
+namespace Program {
+    /// Measured execution cost of an Instruction.
+    struct InstructionTiming
+    {
+        /// Number of executions of the Instruction.
+        uint64_t nbExecutions = 0;
+
+        /// Total duration of executions, in ticks of the Util::CycleCounter.
+        uint64_t nbTicks = 0;
+    };
+
+    /**
+     * \brief Specialization of the ProgramExecutionEngine measuring the
+     * duration of each executed Line.
+     *
+     * Durations are accumulated for each Instruction of the Environment,
+     * using a Util::CycleCounter. They include the fetching of operands and
+     * the storage of the result, and the overhead of reading the counter.
+     */
+    class ProgramExecutionEngineInstrumented : public ProgramExecutionEngine
+    {
+      protected:
+        /// Counter used for timing Lines.
+        const Util::CycleCounter& counter;
+
+        /// Timings of Instructions, indexed as in the Instructions::Set.
+        std::vector<InstructionTiming> instructionTimings;
+
+      public:
+        /**
+         * \brief Constructor of the class.
+         *
+         * \param[in] env The Environment in which the Program will be executed.
+         * \param[in] counter the counter used for timing Lines, which must
+         * remain valid during the lifetime of the engine.
+         */
+        ProgramExecutionEngineInstrumented(const Environment& env,
+                                           const Util::CycleCounter& counter)
+            : ProgramExecutionEngine(env), counter{counter},
+              instructionTimings(env.getInstructionSet().getNbInstructions())
+        {
+        }
+
+        /// Get the timings of Instructions, indexed as in the
+        /// Instructions::Set.
+        const std::vector<InstructionTiming>& getInstructionTimings() const;
+
+        /// Reset the timings of all Instructions.
+        void clearInstructionTimings();
+
+        /// Specialization timing the execution of the current Line.
+        virtual void processLine() override;
+    };
+}; // namespace Program
+#endif
@@ -37,6 +37,7 @@
 #define EXECUTION_STATS_H
 
 #include <map>
+#include <string>
 
 #include "tpg/instrumented/tpgExecutionEngineInstrumented.h"
 #include "tpg/tpgGraph.h"
@@ -129,6 +130,24 @@ namespace TPG {
          */
         std::map<size_t, double> avgNbExecutionPerInstruction;
 
+        /* Measured costs */
+
+        /// Name of the timing backend of the last analyzed execution, or an
+        /// empty string if its duration was not measured.
+        std::string timingBackend;
+
+        /// Average measured duration of edge evaluations per inference, in
+        /// ticks of the timing backend.
+        double avgTicksPerInference = 0.0;
+
+        /// Average measured duration of one execution of each instruction,
+        /// indexed by instruction index, in ticks of the timing backend.
+        std::map<size_t, double> avgTicksPerInstruction;
+
+        /// Average measured duration of one evaluation of each visited edge,
+        /// in ticks of the timing backend.
+        std::map<const TPG::TPGEdge*, double> avgTicksPerEdge;
+
         /* Analyzed Traces */
 
         /// Statistics of last analyzed traces.
@@ -207,7 +226,10 @@ namespace TPG {
          * \brief Analyze the average statistics of an instrumented TPGGraph
          * execution.
          *
-         * Results are stored in the average results class attributes.
+         * Results are stored in the average results class attributes. The
+         * average measured durations per inference and per edge are computed
+         * from the durations stored in instrumented edges, which are zero
+         * unless timing was enabled during the execution.
          *
          * \param[in] graph the analyzed TPGGraph*.
          * \throws std::bad_cast if graph contains at least one non instrumented
@@ -234,7 +256,9 @@ namespace TPG {
          * \brief Analyze the execution statistics of multiple inferences
          * done with a TPGExecutionEngineInstrumented.
          *
-         * Previous results will be erased.
+         * Previous results will be erased. If timing is enabled in the
+         * TPGExecutionEngineInstrumented, the measured durations of
+         * instructions are also analyzed.
          *
          * \param[in] tee the TPGExecutionEngineInstrumented.
          * \param[in] graph the TPGGraph executed with tee.
@@ -253,6 +277,22 @@ namespace TPG {
         /// Get the average number of executed lines per inference.
         double getAvgExecutedLines() const;
 
+        /// Get the name of the timing backend of the last analyzed execution,
+        /// or an empty string if its duration was not measured.
+        const std::string& getTimingBackend() const;
+
+        /// Get the average measured duration of edge evaluations per
+        /// inference.
+        double getAvgTicksPerInference() const;
+
+        /// Get the average measured duration of one execution of each
+        /// instruction, indexed by instruction index.
+        const std::map<size_t, double>& getAvgTicksPerInstruction() const;
+
+        /// Get the average measured duration of one evaluation of each
+        /// visited edge.
+        const std::map<const TPG::TPGEdge*, double>& getAvgTicksPerEdge() const;
+
         /// Get a reference to the map that associate each instruction to
         /// its average number of execution per inference.
         const std::map<size_t, double>& getAvgNbExecutionPerInstruction() const;
@@ -333,6 +373,25 @@ namespace TPG {
          *                  "VertexIndex" : count of inferences which visited
          * the vertex,
          *                  ...
+         *              },
+         *              "measuredCosts" : (only when timing was enabled)
+         *              {
+         *                  "timingBackend" : "tsc", "clock" or "perf_event",
+         *                  "avgTicksPerInference" : value,
+         *                  "avgTicksPerInstruction" :
+         *                  {
+         *                      "InstructionIndex" : avg ticks per execution,
+         *                      ...
+         *                  },
+         *                  "edges" :
+         *                  [
+         *                      {
+         *                          "source" : VertexIndex,
+         *                          "destination" : VertexIndex,
+         *                          "avgTicks" : avg ticks per evaluation
+         *                      },
+         *                      ...
+         *                  ]
          *              }
          *          },
          *
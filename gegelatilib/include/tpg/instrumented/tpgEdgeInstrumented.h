@@ -36,10 +36,11 @@
 #ifndef TPG_EDGE_INSTRUMENTED_H
 #define TPG_EDGE_INSTRUMENTED_H
 
-#include <atomic>
 #include <cstddef>
+#include <cstdint>
 
 #include "tpg/tpgEdge.h"
+#include "util/shardedCounter.h"
 
 namespace TPG {
 
@@ -53,7 +54,7 @@ namespace TPG {
         /// Default constructor
         TPGEdgeInstrumented(const TPGVertex* src, const TPGVertex* dest,
                             const std::shared_ptr<Program::Program> prog)
-            : TPGEdge(src, dest, prog), nbVisits{0}, nbTraversal{0}
+            : TPGEdge(src, dest, prog)
         {
         }
 
@@ -83,6 +84,22 @@ namespace TPG {
          */
         void incrementNbTraversal() const;
 
+        /**
+         * \brief Get the total duration of the executions of the program of
+         * this TPGEdge.
+         *
+         * Durations are only measured by a TPGExecutionEngineInstrumented
+         * with timing enabled, in ticks of its Util::CycleCounter.
+         */
+        uint64_t getNbTicks() const;
+
+        /**
+         * \brief Add a duration of execution of the program of this TPGEdge.
+         *
+         * \param[in] nbTicks the duration.
+         */
+        void addNbTicks(uint64_t nbTicks) const;
+
         /**
          *  \brief Reset the instrumentation attributes.
          */
@@ -91,15 +108,14 @@ namespace TPG {
       protected:
         /// Number of a time a TPGEdge has been visited
         /// That is the number of time it caused an execution of its program.
-        /// Attribute is mutable because all TPGEdge are seen as const outside
-        /// from their TPGGraph.
-        mutable std::atomic_uint64_t nbVisits;
+        Util::ShardedCounter nbVisits;
 
         /// Number of a time a TPGEdge has been traversed
         /// That is the number of time its program produced the winning bid.
-        /// Attribute is mutable because all TPGEdge are seen as const outside
-        /// from their TPGGraph.
-        mutable std::atomic_uint64_t nbTraversal;
+        Util::ShardedCounter nbTraversal;
+
+        /// Total duration of the executions of the program of the TPGEdge.
+        Util::ShardedCounter nbTicks;
     };
 } // namespace TPG
 
@@ -37,26 +37,69 @@
 #ifndef TPG_EXECUTION_ENGINE_INSTRUMENTED_H
 #define TPG_EXECUTION_ENGINE_INSTRUMENTED_H
 
+#include <memory>
 #include <set>
 #include <vector>
 
 #include "archive.h"
+#include "mutator/rng.h"
 #include "program/programExecutionEngine.h"
+#include "program/programExecutionEngineInstrumented.h"
 #include "tpg/tpgExecutionEngine.h"
+#include "util/cycleCounter.h"
 
 #include "tpg/tpgGraph.h"
 
 namespace TPG {
     /**
      * Specialization of the TPGExecutionEngine class.
+     *
+     * The executed TPGGraph must be built with a TPGInstrumentedFactory, so
+     * that its elements are instrumented.
+     *
+     * To keep the instrumentation on during long executions, only one
+     * execution from a root out of a given sampling period can be
+     * recorded, and the number of kept traces can be bounded. When bounded,
+     * the trace history is a uniform sample of all recorded traces.
+     *
+     * Optionally, the duration of recorded executions can be measured for
+     * each TPGEdge and each Instruction, see enableTiming().
      */
     class TPGExecutionEngineInstrumented : public TPGExecutionEngine
     {
       protected:
         /// History of all previous execution traces. New traces are pushed
-        /// back.
+        /// back, until the maximum number of traces is reached.
         std::vector<std::vector<const TPGVertex*>> traceHistory;
 
+        /// One execution from a root out of samplingPeriod is recorded.
+        uint64_t samplingPeriod = 1;
+
+        /// Maximum number of traces kept in the history, 0 for no limit.
+        size_t maxNbTraces = 0;
+
+        /// Number of executions from a root since the creation of the engine.
+        uint64_t nbExecutions = 0;
+
+        /// Number of recorded traces since the last clearTraceHistory().
+        uint64_t nbRecordedTraces = 0;
+
+        /// Whether the current execution is recorded.
+        bool recording = true;
+
+        /// Random number generator for the reservoir of traces.
+        Mutator::RNG rng;
+
+        /// Environment of the executed Programs.
+        const Environment& env;
+
+        /// Counter used for timing executions, if timing is enabled.
+        std::unique_ptr<Util::CycleCounter> cycleCounter;
+
+        /// ProgramExecutionEngine timing Instructions, if timing is enabled.
+        std::unique_ptr<Program::ProgramExecutionEngineInstrumented>
+            timedProgExecutionEngine;
+
       public:
         /**
          * \brief Main constructor of the class.
@@ -70,14 +113,22 @@ namespace TPG {
          */
         TPGExecutionEngineInstrumented(const Environment& env,
                                        Archive* arch = NULL)
-            : TPGExecutionEngine(env, arch){};
+            : TPGExecutionEngine(env, arch), env{env} {};
+
+        /// Specialization also updating the timed ProgramExecutionEngine.
+        void setDataSources(
+            const std::vector<std::reference_wrapper<const Data::DataHandler>>&
+                dataSrc) override;
 
         /**
          * \brief Specialization of the evaluateEdge function.
          *
          * In addition to calling the evaluateEdge method from
          * TPGExecutionEngine, this specialization increments the number of
-         * visits of the evaluated TPGEdge.
+         * visits of the evaluated TPGEdge. When timing is enabled, the
+         * duration of the execution, including its recording in the Archive
+         * if any, is added to the TPGEdge, and the durations of executed
+         * Instructions are accumulated.
          */
         double evaluateEdge(const TPGEdge& edge) override;
 
@@ -100,6 +151,77 @@ namespace TPG {
         const std::vector<const TPGVertex*> executeFromRoot(
             const TPGVertex& root) override;
 
+        /**
+         * \brief Set the sampling period of executions.
+         *
+         * Only the first execution from a root out of each period updates
+         * the counters of the TPGGraph and the trace history.
+         *
+         * \param[in] period the sampling period. Default value 1 records
+         * all executions.
+         * \throws std::invalid_argument if the period is 0.
+         */
+        void setSamplingPeriod(uint64_t period);
+
+        /// Get the sampling period of executions.
+        uint64_t getSamplingPeriod() const;
+
+        /**
+         * \brief Bound the number of traces kept in the history.
+         *
+         * Once the bound is reached, each new trace replaces a random trace
+         * of the history, with a probability such that the history is a
+         * uniform sample of all traces recorded since the last
+         * clearTraceHistory().
+         *
+         * \param[in] maxNbTraces the maximum number of traces, 0 for no
+         * limit.
+         * \param[in] seed the seed of the random selection of traces.
+         */
+        void setMaxNbTraces(size_t maxNbTraces, uint64_t seed = 0);
+
+        /// Get the maximum number of traces kept in the history.
+        size_t getMaxNbTraces() const;
+
+        /// Get the number of traces recorded since the last
+        /// clearTraceHistory(), including those not kept in the history.
+        uint64_t getNbRecordedTraces() const;
+
+        /**
+         * \brief Enable the timing of executions.
+         *
+         * The Util::CycleCounter measuring durations is created by this
+         * method. It must hence be called by the thread executing the
+         * TPGGraph when the PERF_EVENT backend is requested.
+         *
+         * \param[in] backend the requested backend of the Util::CycleCounter.
+         * If unavailable, another backend is used, as given by
+         * getCycleCounter().
+         */
+        void enableTiming(Util::CycleCounter::Backend backend =
+                              Util::CycleCounter::Backend::TSC);
+
+        /// Disable the timing of executions, and discard Instruction timings.
+        void disableTiming();
+
+        /// Whether the timing of executions is enabled.
+        bool isTimingEnabled() const;
+
+        /// Get the counter used for timing, or nullptr if timing is disabled.
+        const Util::CycleCounter* getCycleCounter() const;
+
+        /**
+         * \brief Get the timings of Instructions measured since timing was
+         * enabled or cleared.
+         *
+         * \return the timings, indexed as in the Instructions::Set, or an
+         * empty vector if timing is disabled.
+         */
+        std::vector<Program::InstructionTiming> getInstructionTimings() const;
+
+        /// Reset the timings of all Instructions.
+        void clearInstructionTimings();
+
         /// Get all previous execution traces.
         const std::vector<std::vector<const TPGVertex*>>& getTraceHistory()
             const;
@@ -49,7 +49,29 @@ namespace TPG {
     /// TPGGraph.
     class TPGInstrumentedFactory : public TPGFactory
     {
+      protected:
+        /// Sampling period of the created TPGExecutionEngineInstrumented.
+        uint64_t samplingPeriod;
+
+        /// Maximum number of traces of the created
+        /// TPGExecutionEngineInstrumented.
+        size_t maxNbTraces;
+
       public:
+        /**
+         * \brief Constructor of the factory.
+         *
+         * \param[in] samplingPeriod sampling period of the created
+         * TPGExecutionEngineInstrumented, see
+         * TPGExecutionEngineInstrumented::setSamplingPeriod().
+         * \param[in] maxNbTraces maximum number of traces kept by the created
+         * TPGExecutionEngineInstrumented, see
+         * TPGExecutionEngineInstrumented::setMaxNbTraces().
+         * \throws std::invalid_argument if the sampling period is 0.
+         */
+        TPGInstrumentedFactory(uint64_t samplingPeriod = 1,
+                               size_t maxNbTraces = 0);
+
         /// Specialization of the method returing the TPGGraph with a
         /// TPGInstrumentedFactory as an attribute.
         virtual std::shared_ptr<TPGGraph> createTPGGraph(
@@ -67,7 +89,8 @@ namespace TPG {
             const std::shared_ptr<Program::Program> prog) const override;
 
         ///  Specialization of the method returning a
-        ///  TPGExecutionEngineInstrumented
+        ///  TPGExecutionEngineInstrumented, with the sampling period and
+        ///  maximum number of traces of the factory.
         virtual std::unique_ptr<TPGExecutionEngine> createTPGExecutionEngine(
             const Environment& env, Archive* arch = NULL) const override;
         /**
@@ -36,13 +36,18 @@
 #ifndef TPG_VERTEX_INSTRUMENTATION_H
 #define TPG_VERTEX_INSTRUMENTATION_H
 
-#include <atomic>
 #include <cstddef>
+#include <cstdint>
+
+#include "util/shardedCounter.h"
 
 namespace TPG {
     /**
      * \brief Instrumentation code for TPGVertex class for instrumented
      * execution.
+     *
+     * Visits are counted in per-thread shards, so that several threads can
+     * execute the same TPGGraph without contending on the counters.
      */
     class TPGVertexInstrumentation
     {
@@ -69,14 +74,10 @@ namespace TPG {
          *
          * This constructor initializes the instrumentation attributes.
          */
-        TPGVertexInstrumentation() : nbVisits{0}
-        {
-        }
+        TPGVertexInstrumentation() = default;
 
         /// Number of a time a TPGVertex has been visited
-        /// Attribute is mutable because all TPGVertex are seen as const outside
-        /// from their TPGGraph.
-        mutable std::atomic_uint64_t nbVisits;
+        Util::ShardedCounter nbVisits;
     };
 } // namespace TPG
 
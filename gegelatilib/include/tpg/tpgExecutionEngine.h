@@ -68,6 +68,21 @@ namespace TPG {
          */
         Program::ProgramExecutionEngine progExecutionEngine;
 
+        /**
+         * \brief Execute the Program of an Edge with a given engine.
+         *
+         * Implementation of evaluateEdge(), which specializations can use
+         * with another ProgramExecutionEngine.
+         *
+         * \param[in] edge the const ref to the TPGEdge whose Program will be
+         * evaluated.
+         * \param[in] engine the ProgramExecutionEngine executing the Program,
+         * with the data sources of the TPGExecutionEngine.
+         * \return the double value returned by the Program of the TPGEdge.
+         */
+        double evaluateEdgeWith(const TPGEdge& edge,
+                                Program::ProgramExecutionEngine& engine);
+
       public:
         /**
          * \brief Main constructor of the class.
@@ -92,6 +107,20 @@ namespace TPG {
          */
         void setArchive(Archive* newArchive);
 
+        /**
+         * \brief Set the data sources on which the Program of the TPGGraph
+         * are executed.
+         *
+         * \param[in] dataSrc The vector of DataHandler references with which
+         * the Program will be executed. The DataHandler must be copies of the
+         * data sources of the Environment given to the constructor.
+         * \throws std::runtime_error if the given data sources are
+         * incompatible with the Environment of the executed Program.
+         */
+        virtual void setDataSources(
+            const std::vector<std::reference_wrapper<const Data::DataHandler>>&
+                dataSrc);
+
         /**
          * \brief Execute the Program associated to an Edge and returns the
          * obtained double.
@@ -301,6 +301,24 @@ namespace TPG {
          */
         void clearProgramIntrons();
 
+        /**
+         * \brief Copy a TPGVertex of another TPGGraph, with all the TPGVertex
+         * reachable from it, into this TPGGraph.
+         *
+         * Each TPGTeam of the copied subgraph is added as a new TPGTeam of
+         * this TPGGraph. Each TPGAction is replaced with a TPGAction of this
+         * TPGGraph with the same action ID, which is created only if needed.
+         * Program of the copied TPGEdge are deep-copied, once per Program,
+         * and bound to the Environment of this TPGGraph, which must have the
+         * same characteristics as the one of the source TPGGraph.
+         *
+         * \param[in] root the TPGVertex to copy, from another TPGGraph.
+         * \return a reference to the copy of root in this TPGGraph.
+         * \throw std::runtime_error if the given TPGVertex belongs to this
+         * TPGGraph.
+         */
+        const TPGVertex& importSubGraph(const TPGVertex& root);
+
       protected:
         /// Environment of the TPGGraph
         const Environment& env;
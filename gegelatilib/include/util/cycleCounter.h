@@ -0,0 +1,109 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <cstdint>
+
+namespace Util {
+    /**
+     * \brief Fine-grained counter of elapsed time, for timing short pieces
+     * of code.
+     *
+     * Several backends are supported, with different units:
+     * - TSC: the time-stamp counter of x86 processors, read with the rdtsc
+     * instruction, in reference cycles.
+     * - CLOCK: the monotonic clock of the system (clock_gettime with
+     * CLOCK_MONOTONIC on Linux), in nanoseconds.
+     * - PERF_EVENT: the task-clock software counter of the Linux
+     * perf_event_open interface, in nanoseconds during which the calling
+     * thread was running.
+     *
+     * When the requested backend is not available, such as the TSC on other
+     * processors or perf_event_open in containers forbidding it, the
+     * CLOCK backend is used instead.
+     *
+     * The PERF_EVENT backend counts the time of the thread constructing the
+     * CycleCounter, which must hence be used by this thread only.
+     */
+    class CycleCounter
+    {
+      public:
+        /// Available backends.
+        enum class Backend
+        {
+            CLOCK,
+            TSC,
+            PERF_EVENT
+        };
+
+        /**
+         * \brief Constructor with a requested backend.
+         *
+         * \param[in] backend the requested backend.
+         */
+        explicit CycleCounter(Backend backend = Backend::TSC);
+
+        /// Destructor, releasing the perf_event file descriptor, if any.
+        ~CycleCounter();
+
+        /// Deleted copy constructor.
+        CycleCounter(const CycleCounter&) = delete;
+
+        /// Deleted copy assignment.
+        CycleCounter& operator=(const CycleCounter&) = delete;
+
+        /// Get the backend actually used.
+        Backend getBackend() const;
+
+        /// Get a short name of a backend.
+        static const char* getBackendName(Backend backend);
+
+        /**
+         * \brief Read the current value of the counter.
+         *
+         * Only differences between two values are meaningful.
+         */
+        uint64_t read() const;
+
+      protected:
+        /// Backend actually used.
+        Backend backend;
+
+        /// File descriptor of the PERF_EVENT backend, or -1.
+        int perfFd;
+    };
+} // namespace Util
+
+#endif // !CYCLE_COUNTER_H
@@ -0,0 +1,239 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Util {
+    /**
+     * \brief Hierarchical profiler recording scoped timers and counters.
+     *
+     * Each thread records its timers and counters in its own buffer, so
+     * threads never contend with each other while profiling. The statistics
+     * of each (parent, name) pair of scopes are accumulated for all scopes,
+     * whereas individual events, used to build execution traces, are only
+     * kept for traced scopes whose nesting depth is lower than the maximum
+     * trace depth. Scopes executed for each action of an episode, or for
+     * each mutated Program, are not traced, since recording an event for
+     * each of them would cost more than the measured code.
+     *
+     * The default parent given to the first scope of a thread, such as a
+     * worker thread started by a scope of another thread, counts as an
+     * enclosing scope in the nesting depth.
+     *
+     * Names given to the profiler are not copied, and must have a static
+     * storage duration, such as string literals.
+     *
+     * The profiler does nothing until it is enabled. Within the library,
+     * scopes and counters are declared with the GEGELATI_PROFILE_SCOPE and
+     * GEGELATI_PROFILE_COUNT macros, which are compiled only when the
+     * PROFILING CMake option is set.
+     */
+    class Profiler
+    {
+      public:
+        /// Individual execution of a scope.
+        struct Event
+        {
+            /// Name of the scope.
+            const char* name;
+
+            /// Name of the enclosing scope, or nullptr.
+            const char* parent;
+
+            /// Index of the thread, in order of first use of the profiler.
+            size_t threadId;
+
+            /// Number of scopes opened around this one, counting the
+            /// default parent of the first scope of the thread.
+            size_t depth;
+
+            /// Start time in nanoseconds, see now().
+            uint64_t start;
+
+            /// Duration in nanoseconds.
+            uint64_t duration;
+        };
+
+        /// Accumulated statistics of a scope.
+        struct PhaseStats
+        {
+            /// Number of executions of the scope.
+            uint64_t count = 0;
+
+            /// Total duration of executions in nanoseconds.
+            uint64_t totalTime = 0;
+        };
+
+        /**
+         * \brief Timer measuring the duration of a scope.
+         *
+         * The timer is started by the constructor and stopped by the
+         * destructor. Nothing is measured if the profiler is disabled when
+         * the timer is created.
+         */
+        class ScopedTimer
+        {
+          public:
+            /**
+             * \brief Start a timer.
+             *
+             * \param[in] name the name of the scope.
+             * \param[in] defaultParent the parent name used when no other
+             * scope is opened in the calling thread, such as in the
+             * worker threads started by a scope of another thread.
+             * \param[in] traced whether an event is kept for the scope, if
+             * its depth is lower than the maximum trace depth. Statistics
+             * are accumulated in all cases.
+             */
+            explicit ScopedTimer(const char* name,
+                                 const char* defaultParent = nullptr,
+                                 bool traced = true);
+
+            /// Stop the timer and record its event.
+            ~ScopedTimer();
+
+            /// Deleted copy constructor.
+            ScopedTimer(const ScopedTimer&) = delete;
+
+            /// Deleted copy assignment.
+            ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+          private:
+            /// Whether the timer measures something.
+            bool active;
+
+            /// Start time of the timer.
+            uint64_t start;
+        };
+
+        /**
+         * \brief Enable or disable the profiler.
+         *
+         * Scopes opened while the profiler is enabled are recorded even if
+         * the profiler is disabled before they are closed.
+         */
+        static void enable(bool enabled = true);
+
+        /// Whether the profiler is enabled.
+        static bool isEnabled();
+
+        /**
+         * \brief Set the maximum depth of the scopes kept as events.
+         *
+         * Default value is 3, so that events are kept for scopes that are
+         * nested within at most two other scopes.
+         */
+        static void setMaxTraceDepth(size_t depth);
+
+        /// Get the maximum depth of the scopes kept as events.
+        static size_t getMaxTraceDepth();
+
+        /**
+         * \brief Add a value to a counter of the calling thread.
+         *
+         * \param[in] name the name of the counter.
+         * \param[in] value the value added to the counter.
+         */
+        static void count(const char* name, uint64_t value = 1);
+
+        /// Current time in nanoseconds, since the first use of the profiler.
+        static uint64_t now();
+
+        /**
+         * \brief Get and remove the events recorded by all threads.
+         *
+         * \return the events, sorted by start time.
+         */
+        static std::vector<Event> collectEvents();
+
+        /**
+         * \brief Get and remove the statistics recorded by all threads.
+         *
+         * \return the statistics of each scope, indexed by the names of the
+         * parent scope (empty for top-level scopes) and of the scope.
+         */
+        static std::map<std::pair<std::string, std::string>, PhaseStats>
+        collectPhases();
+
+        /**
+         * \brief Get and reset the counters of all threads.
+         *
+         * \return the sum of each counter for all threads.
+         */
+        static std::map<std::string, uint64_t> collectCounters();
+
+        /// Remove all events, statistics and counters.
+        static void clear();
+    };
+} // namespace Util
+
+#ifdef GEGELATI_PROFILING
+#define GEGELATI_PROFILE_CONCAT_INNER(a, b) a##b
+#define GEGELATI_PROFILE_CONCAT(a, b) GEGELATI_PROFILE_CONCAT_INNER(a, b)
+/// Time the rest of the enclosing scope.
+#define GEGELATI_PROFILE_SCOPE(name)                                           \
+    Util::Profiler::ScopedTimer GEGELATI_PROFILE_CONCAT(profilerScope,         \
+                                                        __LINE__)(name)
+/// Time the rest of the enclosing scope, with a default parent.
+#define GEGELATI_PROFILE_SCOPE_IN(name, parent)                                \
+    Util::Profiler::ScopedTimer GEGELATI_PROFILE_CONCAT(profilerScope,         \
+                                                        __LINE__)(name, parent)
+/// Time the rest of the enclosing scope, in statistics only.
+#define GEGELATI_PROFILE_STATS_SCOPE(name)                                     \
+    Util::Profiler::ScopedTimer GEGELATI_PROFILE_CONCAT(                       \
+        profilerScope, __LINE__)(name, nullptr, false)
+/// Time the rest of the enclosing scope, in statistics only, with a default
+/// parent.
+#define GEGELATI_PROFILE_STATS_SCOPE_IN(name, parent)                          \
+    Util::Profiler::ScopedTimer GEGELATI_PROFILE_CONCAT(                       \
+        profilerScope, __LINE__)(name, parent, false)
+/// Add a value to a counter.
+#define GEGELATI_PROFILE_COUNT(name, value)                                    \
+    Util::Profiler::count(name, value)
+#else
+#define GEGELATI_PROFILE_SCOPE(name)
+#define GEGELATI_PROFILE_SCOPE_IN(name, parent)
+#define GEGELATI_PROFILE_STATS_SCOPE(name)
+#define GEGELATI_PROFILE_STATS_SCOPE_IN(name, parent)
+#define GEGELATI_PROFILE_COUNT(name, value) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef SHARDED_COUNTER_H
+#define SHARDED_COUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Util {
+    /**
+     * \brief Counter whose increments are accumulated in per-thread shards.
+     *
+     * Each thread increments the counter in its own shard, without atomic
+     * read-modify-write instructions nor sharing cache lines with other
+     * threads. The value of the counter is the sum of all shards, including
+     * the shards of terminated threads, and is merged each time it is read.
+     *
+     * Increments are cheap, while reading or resetting the counter costs a
+     * lock and a visit of all shards. Hence, this class suits counters that
+     * are incremented in hot loops of several threads, but only read once in
+     * a while.
+     *
+     * Resetting the counter records the current sum of its shards, which is
+     * subtracted from later reads, instead of writing in the shards of other
+     * threads. Hence, increments concurrent with a reset are counted either
+     * before or after it, and the reset is never lost.
+     */
+    class ShardedCounter
+    {
+      public:
+        /// Constructor of a counter with a zero value.
+        ShardedCounter();
+
+        /// Destructor, releasing the index of the counter within shards.
+        ~ShardedCounter();
+
+        /// Deleted copy constructor.
+        ShardedCounter(const ShardedCounter&) = delete;
+
+        /// Deleted copy assignment.
+        ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+        /// Add one to the shard of the calling thread.
+        void increment() const;
+
+        /// Add a value to the shard of the calling thread.
+        void add(uint64_t value) const;
+
+        /// Get the sum of all shards.
+        uint64_t get() const;
+
+        /// Set the counter back to zero.
+        void reset() const;
+
+      private:
+        /// Index of the counter within each shard.
+        const size_t index;
+    };
+} // namespace Util
+
+#endif // !SHARDED_COUNTER_H
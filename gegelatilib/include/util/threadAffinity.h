@@ -0,0 +1,230 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef THREAD_AFFINITY_H
+#define THREAD_AFFINITY_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Util {
+    /**
+     * \brief Class describing how worker threads are pinned to CPUs.
+     *
+     * The policy is given by a string description:
+     * - "none": threads are not pinned (default).
+     * - "compact": consecutive workers are pinned to consecutive CPUs of a
+     * NUMA node, before moving to the next node.
+     * - "scatter": consecutive workers are pinned to CPUs of different NUMA
+     * nodes, in a round-robin manner.
+     * - an explicit list of CPUs, such as "0,2,4-7", used in the given order.
+     *
+     * When there are more workers than CPUs, the CPUs are reused in the same
+     * order. The NUMA topology is read from /sys/devices/system/node on Linux,
+     * and restricted to the CPUs the process is allowed to run on. On other
+     * systems, or if this directory is not available, all allowed CPUs are
+     * considered to belong to a single node.
+     */
+    class ThreadAffinity
+    {
+      public:
+        /// Pinning policies.
+        enum class Policy
+        {
+            NONE,
+            COMPACT,
+            SCATTER,
+            EXPLICIT
+        };
+
+        /// Default constructor, with the NONE policy.
+        ThreadAffinity();
+
+        /**
+         * \brief Constructor from a string description of the policy.
+         *
+         * \param[in] description the policy description.
+         * \throws std::runtime_error if the description is invalid.
+         */
+        explicit ThreadAffinity(const std::string& description);
+
+        /**
+         * \brief Constructor with a given NUMA topology.
+         *
+         * \param[in] description the policy description.
+         * \param[in] nodeCPUs map associating each NUMA node with its CPUs.
+         * \throws std::runtime_error if the description is invalid.
+         */
+        ThreadAffinity(const std::string& description,
+                       const std::map<int, std::vector<int>>& nodeCPUs);
+
+        /// Get the pinning policy.
+        Policy getPolicy() const;
+
+        /// Get the number of NUMA nodes of the topology.
+        size_t getNbNodes() const;
+
+        /**
+         * \brief Get the CPU assigned to a worker.
+         *
+         * \param[in] workerIdx the index of the worker.
+         * \return the CPU of the worker, or -1 if threads are not pinned.
+         */
+        int getCPU(size_t workerIdx) const;
+
+        /**
+         * \brief Get the NUMA node of a CPU.
+         *
+         * \param[in] cpu the CPU index.
+         * \return the node of the CPU, or 0 if the CPU is unknown.
+         */
+        int getNode(int cpu) const;
+
+        /**
+         * \brief Get the NUMA node of the CPU running the calling thread.
+         *
+         * \return the node of the current CPU, or 0 if it is unknown.
+         */
+        int getCurrentNode() const;
+
+        /**
+         * \brief Pin the calling thread to a CPU.
+         *
+         * \param[in] cpu the CPU index.
+         * \return true if the thread was pinned, false otherwise.
+         */
+        static bool pinCurrentThread(int cpu);
+
+        /**
+         * \brief Pin the calling thread to a CPU for the lifetime of the
+         * object.
+         *
+         * The CPUs the thread was allowed to run on are restored by the
+         * destructor, so that a thread pinned for a part of its execution,
+         * such as the main thread working with the workers of an
+         * evaluation, is not left pinned.
+         */
+        class ScopedPin
+        {
+          public:
+            /**
+             * \brief Pin the calling thread.
+             *
+             * \param[in] cpu the CPU index, or -1 to leave the thread
+             * unpinned.
+             */
+            explicit ScopedPin(int cpu);
+
+            /// Restore the CPUs of the thread, if it was pinned.
+            ~ScopedPin();
+
+            /// Deleted copy constructor.
+            ScopedPin(const ScopedPin&) = delete;
+
+            /// Deleted copy assignment.
+            ScopedPin& operator=(const ScopedPin&) = delete;
+
+            /// Whether the thread was pinned.
+            bool isPinned() const;
+
+          private:
+            /// Whether the thread was pinned.
+            bool pinned;
+
+            /// CPUs the thread was allowed to run on before being pinned.
+            std::vector<int> previousCPUs;
+        };
+
+        /**
+         * \brief Get the CPUs the calling thread is allowed to run on.
+         *
+         * \return the allowed CPUs, or an empty vector if they are unknown.
+         */
+        static std::vector<int> getCurrentThreadCPUs();
+
+        /**
+         * \brief Allow the calling thread to run on the given CPUs.
+         *
+         * \param[in] cpus the CPU indexes.
+         * \return true if the CPUs of the thread were set, false otherwise.
+         */
+        static bool setCurrentThreadCPUs(const std::vector<int>& cpus);
+
+        /**
+         * \brief Parse a list of CPUs, such as "0,2,4-7".
+         *
+         * \param[in] list the list of CPUs.
+         * \return the CPUs in the order of the list.
+         * \throws std::runtime_error if the list is invalid.
+         */
+        static std::vector<int> parseCPUList(const std::string& list);
+
+      protected:
+        /// Pinning policy.
+        Policy policy;
+
+        /// CPUs assigned to consecutive workers.
+        std::vector<int> cpus;
+
+        /// NUMA node of each known CPU.
+        std::map<int, int> cpuNodes;
+
+        /// Number of NUMA nodes.
+        size_t nbNodes;
+
+        /**
+         * \brief Read the NUMA topology of the machine.
+         *
+         * All node directories are listed, since node numbers may have gaps.
+         * CPUs outside the affinity mask of the process are ignored, and
+         * nodes without any allowed CPU are skipped.
+         *
+         * \return map associating each NUMA node with its allowed CPUs.
+         */
+        static std::map<int, std::vector<int>> readTopology();
+
+        /**
+         * \brief Initialize the policy and the CPU order.
+         *
+         * \param[in] description the policy description.
+         * \param[in] nodeCPUs map associating each NUMA node with its CPUs.
+         */
+        void init(const std::string& description,
+                  const std::map<int, std::vector<int>>& nodeCPUs);
+    };
+} // namespace Util
+
+#endif
@@ -36,6 +36,7 @@
 #include <math.h>
 
 #include "archive.h"
+#include "util/profiler.h"
 
 Archive::~Archive()
 {
@@ -78,6 +79,8 @@ void Archive::addRecording(
     // Archive according to probability
     if (forced || this->archivingProbability == 1.0 ||
         this->rng.getDouble(0.0, 1.0) <= this->archivingProbability) {
+        GEGELATI_PROFILE_STATS_SCOPE("archiveAddRecording");
+        GEGELATI_PROFILE_COUNT("archiveRecordings", 1);
         // get the combined hash
         size_t hash = getCombinedHash(dHandler);
 
@@ -213,6 +216,23 @@ Archive::getDataHandlers() const
     return this->dataHandlers;
 }
 
+void Archive::replacePrograms(
+    const std::unordered_map<const Program::Program*, const Program::Program*>&
+        replacements)
+{
+    std::deque<ArchiveRecording> replacedRecordings;
+    this->recordingsPerProgram.clear();
+    for (const ArchiveRecording& recording : this->recordings) {
+        auto iter = replacements.find(recording.prog);
+        ArchiveRecording replaced{
+            (iter != replacements.end()) ? iter->second : recording.prog,
+            recording.dataHash, recording.result};
+        replacedRecordings.push_back(replaced);
+        this->recordingsPerProgram[replaced.prog].push_back(replaced);
+    }
+    this->recordings = std::move(replacedRecordings);
+}
+
 void Archive::clear()
 {
     for (auto dHandlerAndHash : this->dataHandlers) {
@@ -225,4 +245,5 @@ void Archive::clear()
     this->dataHandlers.clear();
     this->recordings.clear();
     this->recordingsPerProgram.clear();
+    this->placeholderPrograms.clear();
 }
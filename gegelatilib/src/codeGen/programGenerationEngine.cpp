@@ -35,6 +35,10 @@
  */
 
 #ifdef CODE_GENERATION
+#include <algorithm>
+#include <set>
+#include <sstream>
+
 #include "codeGen/programGenerationEngine.h"
 #include "util/timestamp.h"
 
@@ -50,12 +54,23 @@ void CodeGen::ProgramGenerationEngine::generateCurrentLine()
         this->getCurrentInstruction();
 
     if (instruction.isPrintable()) {
-        fileC << "\t{" << std::endl;
+        uint64_t destination = this->getCurrentLine().getDestinationIndex();
+        if (optimization) {
+            // Each write in a register defines a new scalar local variable.
+            *code << indent << "double " << nameRegVariable << destination
+                  << "_" << registerVersions.at(destination) + 1 << ";"
+                  << std::endl;
+        }
+        *code << indent << "{" << std::endl;
         initOperandCurrentLine();
         std::string codeLine = completeFormat(instruction);
+        if (optimization) {
+            registerVersions.at(destination)++;
+            codeLine = renameVariables(codeLine);
+        }
         // init
-        fileC << "\t\t" << codeLine << "\n"
-              << "\t}" << std::endl;
+        *code << indent << "\t" << codeLine << "\n"
+              << indent << "}" << std::endl;
     }
     else {
         throw std::runtime_error("The instruction is not printable, stop the "
@@ -63,43 +78,292 @@ void CodeGen::ProgramGenerationEngine::generateCurrentLine()
     }
 }
 
-void CodeGen::ProgramGenerationEngine::generateProgram(
+uint64_t CodeGen::ProgramGenerationEngine::generateProgram(
+    uint64_t progID, const bool ignoreException, const std::string& attribute)
+{
+    // The body of the function is its canonical form: it is generated before
+    // the function so that Programs with the same body share one function.
+    std::ostringstream body;
+    std::ostream* file = code;
+    code = &body;
+    std::string result;
+    try {
+        if (!optimization) {
+            initRegisters();
+            initConstants();
+        }
+        result = generateLines(ignoreException);
+    }
+    catch (...) {
+        code = file;
+        throw;
+    }
+    code = file;
+
+    auto [function, isNew] =
+        generatedPrograms.emplace(body.str() + result, progID);
+    if (!isNew) {
+        // The shared function is hot if any of its Programs is.
+        auto attributed = attributedPrograms.find(function->second);
+        if (attributed != attributedPrograms.end() &&
+            attribute == "TPG_HOT ") {
+            attributed->second.first = attribute;
+        }
+        return function->second;
+    }
+
+    std::ostringstream functionCode;
+    functionCode << body.str();
+#ifdef DEBUG
+    functionCode << "#ifdef DEBUG" << std::endl;
+    functionCode << "\tprintf(\"P" << progID << " : reg[0] = %lf \\n\", "
+                 << result << ");" << std::endl;
+    functionCode << "#endif" << std::endl;
+#endif
+    functionCode << "\treturn " << result << ";\n}" << std::endl;
+    if (attribute.empty()) {
+        printProgram(progID, attribute, functionCode.str());
+    }
+    else {
+        attributedPrograms[progID] = {attribute, functionCode.str()};
+    }
+    return progID;
+}
+
+void CodeGen::ProgramGenerationEngine::printProgram(
+    uint64_t progID, const std::string& attribute,
+    const std::string& functionCode)
+{
+    fileC << "\n" << attribute << "double P" << progID << "(){" << std::endl;
+    fileH << attribute << "double P" << progID << "();" << std::endl;
+    fileC << functionCode;
+}
+
+void CodeGen::ProgramGenerationEngine::printAttributedPrograms()
+{
+    for (const auto& [progID, function] : attributedPrograms) {
+        printProgram(progID, function.first, function.second);
+    }
+    attributedPrograms.clear();
+}
+
+void CodeGen::ProgramGenerationEngine::initProfileMacros()
+{
+    fileH << "#if defined(__GNUC__) || defined(__clang__)\n"
+          << "#define TPG_HOT __attribute__((hot))\n"
+          << "#define TPG_COLD __attribute__((cold))\n"
+          << "#define TPG_LIKELY(x) __builtin_expect(!!(x), 1)\n"
+          << "#define TPG_UNLIKELY(x) __builtin_expect(!!(x), 0)\n"
+          << "#else\n"
+          << "#define TPG_HOT\n"
+          << "#define TPG_COLD\n"
+          << "#define TPG_LIKELY(x) (x)\n"
+          << "#define TPG_UNLIKELY(x) (x)\n"
+          << "#endif\n"
+          << std::endl;
+}
+
+void CodeGen::ProgramGenerationEngine::generateProgramBatch(
     uint64_t progID, const bool ignoreException)
 {
-    fileC << "\ndouble P" << progID << "(){" << std::endl;
-    fileH << "double P" << progID << "();" << std::endl;
+    const std::string prototype =
+        "void P" + std::to_string(progID) +
+        "_batch(int n, const int* restrict samples, "
+        "double* restrict results, " +
+        getBatchDataParameters() + ")";
+    fileC << "\n" << prototype << "{" << std::endl;
+    fileH << prototype << ";" << std::endl;
 
-    // instantiate register
-    fileC << "\tdouble " << nameRegVariable << "["
+    // Constants are shared by all samples of the batch.
+    if (!optimization) {
+        initConstants();
+    }
+
+    fileC << "\tfor (int b = 0; b < n; b++) {" << std::endl;
+    // Local pointers shadow the global variables so that lines are printed
+    // exactly as in non-batched programs.
+    for (size_t cpt = 1; cpt <= this->dataSources.size(); ++cpt) {
+        const Data::DataHandler& d = this->dataSources.at(cpt - 1);
+        fileC << "\t\tconst " << dataPrinter.getDemangleTemplateType(d)
+              << "* " << nameDataVariable << cpt << " = " << nameDataVariable
+              << cpt << "Batch + samples[b] * "
+              << d.getAddressSpace(d.getNativeType()) << ";" << std::endl;
+    }
+
+    indent = "\t\t";
+    std::string result;
+    try {
+        if (!optimization) {
+            initRegisters();
+        }
+        result = generateLines(ignoreException);
+    }
+    catch (...) {
+        indent = "\t";
+        throw;
+    }
+    indent = "\t";
+
+    fileC << "\t\tresults[b] = " << result << ";" << std::endl;
+    fileC << "\t}\n}" << std::endl;
+}
+
+void CodeGen::ProgramGenerationEngine::setOptimization(bool enable)
+{
+    this->optimization = enable;
+    registerVersions.assign(registers.getLargestAddressSpace(), 0);
+}
+
+bool CodeGen::ProgramGenerationEngine::isOptimization() const
+{
+    return this->optimization;
+}
+
+std::string CodeGen::ProgramGenerationEngine::generateLines(
+    const bool ignoreException)
+{
+    if (!optimization) {
+        iterateThroughtProgram(ignoreException);
+        return nameRegVariable + "[0]";
+    }
+
+    registerVersions.assign(registers.getLargestAddressSpace(), 0);
+    for (uint64_t line : findLiveLines(ignoreException)) {
+        this->programCounter = line;
+        generateCurrentLine();
+    }
+    return renameVariables(nameRegVariable + "[0]");
+}
+
+std::vector<uint64_t> CodeGen::ProgramGenerationEngine::findLiveLines(
+    const bool ignoreException)
+{
+    std::vector<uint64_t> liveLines;
+    std::set<uint64_t> liveRegisters{0};
+
+    // Backward pass: a line is live if it writes a register read later.
+    for (uint64_t i = program->getNbLines(); i-- > 0;) {
+        if (program->isIntron(i)) {
+            continue;
+        }
+        this->programCounter = i;
+        try {
+            const Program::Line& line = getCurrentLine();
+            const Instructions::Instruction& instruction =
+                getCurrentInstruction();
+            std::vector<size_t> readRegisters;
+            for (uint64_t op = 0; op < instruction.getNbOperands(); ++op) {
+                if (line.getOperand(op).first == 0) {
+                    auto addresses = registers.getAddressesAccessed(
+                        instruction.getOperandTypes().at(op).get(),
+                        getOperandLocation(op));
+                    readRegisters.insert(readRegisters.end(),
+                                         addresses.begin(), addresses.end());
+                }
+            }
+            if (liveRegisters.erase(line.getDestinationIndex()) == 0) {
+                continue;
+            }
+            liveRegisters.insert(readRegisters.begin(), readRegisters.end());
+            liveLines.push_back(i);
+        }
+        catch (std::out_of_range&) {
+            if (!ignoreException) {
+                throw;
+            }
+        }
+    }
+
+    std::reverse(liveLines.begin(), liveLines.end());
+    return liveLines;
+}
+
+std::string CodeGen::ProgramGenerationEngine::renameVariables(
+    const std::string& codeLine) const
+{
+    static const std::regex variable_regex("\\b(" + nameRegVariable + "|" +
+                                           nameConstantVariable +
+                                           ")\\[([0-9]+)\\]");
+    std::string renamed;
+    auto last = codeLine.cbegin();
+    for (auto itr = std::sregex_iterator(codeLine.begin(), codeLine.end(),
+                                         variable_regex);
+         itr != std::sregex_iterator(); ++itr) {
+        renamed.append(last, (*itr)[0].first);
+        last = (*itr)[0].second;
+        size_t idx = std::stoul((*itr)[2].str());
+        if ((*itr)[1].str() == nameConstantVariable) {
+            // Constant folding
+            renamed += std::to_string(program->getConstantAt(idx).value);
+        }
+        else if (registerVersions.at(idx) == 0) {
+            // Registers are initialized to zero.
+            renamed += "0";
+        }
+        else {
+            renamed += nameRegVariable + std::to_string(idx) + "_" +
+                       std::to_string(registerVersions.at(idx));
+        }
+    }
+    renamed.append(last, codeLine.cend());
+    return renamed;
+}
+
+std::string CodeGen::ProgramGenerationEngine::getBatchDataParameters() const
+{
+    std::ostringstream parameters;
+    for (size_t cpt = 1; cpt <= this->dataSources.size(); ++cpt) {
+        const Data::DataHandler& d = this->dataSources.at(cpt - 1);
+        parameters << ((cpt > 1) ? ", " : "") << "const "
+                   << dataPrinter.getDemangleTemplateType(d)
+                   << "* restrict " << nameDataVariable << cpt << "Batch";
+    }
+    return parameters.str();
+}
+
+std::string CodeGen::ProgramGenerationEngine::getBatchDataArguments(
+    const std::string& firstSample) const
+{
+    std::ostringstream arguments;
+    for (size_t cpt = 1; cpt <= this->dataSources.size(); ++cpt) {
+        const Data::DataHandler& d = this->dataSources.at(cpt - 1);
+        arguments << ((cpt > 1) ? ", " : "") << nameDataVariable << cpt
+                  << "Batch";
+        if (!firstSample.empty()) {
+            arguments << " + " << firstSample << " * "
+                      << d.getAddressSpace(d.getNativeType());
+        }
+    }
+    return arguments.str();
+}
+
+void CodeGen::ProgramGenerationEngine::initRegisters()
+{
+    *code << indent << "double " << nameRegVariable << "["
           << program->getEnvironment().getNbRegisters() << "] = {";
     for (int i = 0; i < program->getEnvironment().getNbRegisters(); ++i) {
-        fileC << "0";
+        *code << "0";
         if (i < program->getEnvironment().getNbRegisters() - 1) {
-            fileC << ", ";
+            *code << ", ";
         }
     }
-    fileC << "};" << std::endl;
+    *code << "};" << std::endl;
+}
+
+void CodeGen::ProgramGenerationEngine::initConstants()
+{
     if (program->getEnvironment().getNbConstant() > 0) {
         size_t nbCst = program->getEnvironment().getNbConstant();
-        fileC << "\tint32_t " << nameConstantVariable << "[" << nbCst
+        *code << indent << "int32_t " << nameConstantVariable << "[" << nbCst
               << "] = {";
         for (int i = 0; i < nbCst; ++i) {
-            fileC << program->getConstantAt(i).value;
+            *code << program->getConstantAt(i).value;
             if (i < nbCst - 1) {
-                fileC << ", ";
+                *code << ", ";
             }
         }
-        fileC << "};" << std::endl;
+        *code << "};" << std::endl;
     }
-
-    iterateThroughtProgram(ignoreException);
-#ifdef DEBUG
-    fileC << "#ifdef DEBUG" << std::endl;
-    fileC << "\tprintf(\"P" << progID << " : reg[0] = %lf \\n\", reg[0]);"
-          << std::endl;
-    fileC << "#endif" << std::endl;
-#endif
-    fileC << "\treturn reg[0];\n}" << std::endl;
 }
 
 std::string CodeGen::ProgramGenerationEngine::completeFormat(
@@ -207,11 +471,15 @@ void CodeGen::ProgramGenerationEngine::initOperandCurrentLine()
         const Data::DataHandler& dataSource = this->dataScsConstsAndRegs.at(
             sourceIdx); // Throws std::out_of_range
 
-        fileC << "\t\t" << instruction.getPrintablePrimitiveOperandType(i)
-              << " " << nameOperandVariable << i
-              << dataPrinter.printDataAt(dataSource, operandType, opIdx,
-                                         getNameSourceData(sourceIdx))
-              << std::endl;
+        std::string operandValue = dataPrinter.printDataAt(
+            dataSource, operandType, opIdx, getNameSourceData(sourceIdx));
+        if (optimization) {
+            operandValue = renameVariables(operandValue);
+        }
+
+        *code << indent << "\t"
+              << instruction.getPrintablePrimitiveOperandType(i) << " "
+              << nameOperandVariable << i << operandValue << std::endl;
     }
 }
 
@@ -37,8 +37,14 @@
 
 #ifdef CODE_GENERATION
 
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
 #include "codeGen/tpgGenerationEngine.h"
 #include "data/demangle.h"
+#include "tpg/tpgAction.h"
 #include "util/timestamp.h"
 
 CodeGen::TPGGenerationEngine::TPGGenerationEngine(const std::string& filename,
@@ -84,4 +90,277 @@ CodeGen::TPGGenerationEngine::~TPGGenerationEngine()
     fileMainH.close();
 }
 
+void CodeGen::TPGGenerationEngine::setBatchInference(bool enable)
+{
+    this->batchInference = enable;
+}
+
+bool CodeGen::TPGGenerationEngine::isBatchInference() const
+{
+    return this->batchInference;
+}
+
+void CodeGen::TPGGenerationEngine::setProgramOptimization(bool enable)
+{
+    progGenerationEngine.setOptimization(enable);
+}
+
+bool CodeGen::TPGGenerationEngine::isProgramOptimization() const
+{
+    return progGenerationEngine.isOptimization();
+}
+
+void CodeGen::TPGGenerationEngine::setProfile(const TPG::ExecutionStats& stats)
+{
+    if (!profileGuided) {
+        progGenerationEngine.initProfileMacros();
+    }
+    profileGuided = true;
+    vertexVisits.clear();
+    programEvaluations.clear();
+    edgeTraversals.clear();
+
+    for (const auto& [vertex, nbVisits] : stats.getDistribUsedVertices()) {
+        vertexVisits[vertex] = nbVisits;
+    }
+    for (const TPG::TraceStats& traceStats : stats.getInferenceTracesStats()) {
+        const auto& trace = traceStats.trace;
+        for (auto it = trace.begin(); it + 1 < trace.end(); it++) {
+            bool followed = false;
+            for (const TPG::TPGEdge* edge : (*it)->getOutgoingEdges()) {
+                // As in ExecutionStats, edges leading to a previously
+                // visited team are not evaluated.
+                auto end = it + 1;
+                if (std::find(trace.begin(), end, edge->getDestination()) !=
+                    end) {
+                    continue;
+                }
+                programEvaluations[&edge->getProgram()]++;
+                // With several edges towards the next vertex, the first one
+                // is credited.
+                if (!followed && edge->getDestination() == *(it + 1)) {
+                    edgeTraversals[edge]++;
+                    followed = true;
+                }
+            }
+        }
+    }
+}
+
+bool CodeGen::TPGGenerationEngine::isProfileGuided() const
+{
+    return this->profileGuided;
+}
+
+std::vector<const TPG::TPGVertex*> CodeGen::TPGGenerationEngine::
+    getVerticesInLayoutOrder() const
+{
+    std::vector<const TPG::TPGVertex*> vertices = tpg.getVertices();
+    if (profileGuided) {
+        auto visits = [this](const TPG::TPGVertex* vertex) {
+            auto count = vertexVisits.find(vertex);
+            return (count != vertexVisits.end()) ? count->second : 0;
+        };
+        std::stable_sort(vertices.begin(), vertices.end(),
+                         [&visits](const TPG::TPGVertex* a,
+                                   const TPG::TPGVertex* b) {
+                             return visits(a) > visits(b);
+                         });
+    }
+    return vertices;
+}
+
+std::string CodeGen::TPGGenerationEngine::getComparisonHint(
+    const TPG::TPGTeam& team, const TPG::TPGEdge& edge) const
+{
+    auto teamCount = vertexVisits.find(&team);
+    if (!profileGuided || teamCount == vertexVisits.end() ||
+        teamCount->second == 0) {
+        return "";
+    }
+    auto edgeCount = edgeTraversals.find(&edge);
+    uint64_t nbTraversals =
+        (edgeCount != edgeTraversals.end()) ? edgeCount->second : 0;
+    if (2 * nbTraversals > teamCount->second) {
+        return "TPG_LIKELY";
+    }
+    if (2 * nbTraversals < teamCount->second &&
+        team.getOutgoingEdges().back() == &edge) {
+        return "TPG_UNLIKELY";
+    }
+    return "";
+}
+
+uint64_t CodeGen::TPGGenerationEngine::findProgramFunctionID(
+    const Program::Program& program)
+{
+    uint64_t progID;
+    if (findProgramID(program, progID)) {
+        std::string attribute;
+        if (profileGuided) {
+            attribute = (programEvaluations.count(&program) > 0) ? "TPG_HOT "
+                                                                  : "TPG_COLD ";
+        }
+        progGenerationEngine.setProgram(program);
+        programFunctionIDs[progID] =
+            progGenerationEngine.generateProgram(progID, false, attribute);
+    }
+    return programFunctionIDs.at(progID);
+}
+
+void CodeGen::TPGGenerationEngine::generateBatchInference()
+{
+    const TPG::TPGVertex* root = tpg.getRootVertices().at(0);
+
+    // Sort the teams reachable from the root in topological order with an
+    // iterative depth-first search. A vertex is mapped to false while it is
+    // on the search stack, and to true once all its successors are sorted.
+    std::vector<const TPG::TPGTeam*> teams;
+    std::map<const TPG::TPGVertex*, bool> sorted;
+    std::vector<std::pair<const TPG::TPGVertex*,
+                          std::list<TPG::TPGEdge*>::const_iterator>>
+        stack;
+    stack.emplace_back(root, root->getOutgoingEdges().cbegin());
+    sorted[root] = false;
+    while (!stack.empty()) {
+        auto& [vertex, edge] = stack.back();
+        if (edge == vertex->getOutgoingEdges().cend()) {
+            sorted[vertex] = true;
+            if (dynamic_cast<const TPG::TPGTeam*>(vertex) != nullptr) {
+                teams.push_back((const TPG::TPGTeam*)vertex);
+            }
+            stack.pop_back();
+            continue;
+        }
+        const TPG::TPGVertex* destination = (*edge)->getDestination();
+        ++edge;
+        auto status = sorted.find(destination);
+        if (status == sorted.end()) {
+            sorted[destination] = false;
+            stack.emplace_back(destination,
+                               destination->getOutgoingEdges().cbegin());
+        }
+        else if (!status->second) {
+            throw std::runtime_error("Batch inference cannot be generated for "
+                                     "a TPGGraph with cycles.");
+        }
+    }
+    std::reverse(teams.begin(), teams.end());
+
+    // In the generated code, the current vertex of a sample is the index of
+    // a team in the topological order, or -(actionID + 1) for an action.
+    std::map<const TPG::TPGVertex*, int64_t> vertexCodes;
+    for (size_t i = 0; i < teams.size(); i++) {
+        vertexCodes[teams.at(i)] = (int64_t)i;
+    }
+    auto vertexCode = [&vertexCodes](const TPG::TPGVertex* vertex) {
+        auto action = dynamic_cast<const TPG::TPGAction*>(vertex);
+        return (action != nullptr) ? -(int64_t)action->getActionID() - 1
+                                   : vertexCodes.at(vertex);
+    };
+
+    // Batched programs, for teams with a choice to make.
+    std::map<const TPG::TPGEdge*, uint64_t> programIDs;
+    std::set<uint64_t> batchPrograms;
+    for (const TPG::TPGTeam* team : teams) {
+        if (team->getOutgoingEdges().size() < 2) {
+            continue;
+        }
+        for (const TPG::TPGEdge* edge : team->getOutgoingEdges()) {
+            uint64_t progID = findProgramFunctionID(edge->getProgram());
+            programIDs[edge] = progID;
+            if (batchPrograms.insert(progID).second) {
+                progGenerationEngine.setProgram(edge->getProgram());
+                progGenerationEngine.generateProgramBatch(progID);
+            }
+        }
+    }
+
+    std::string parameters = progGenerationEngine.getBatchDataParameters();
+    std::string arguments = progGenerationEngine.getBatchDataArguments();
+    std::string chunkArguments =
+        progGenerationEngine.getBatchDataArguments("first");
+    if (!parameters.empty()) {
+        parameters += ", ";
+        chunkArguments += ", ";
+    }
+
+    fileMainH << "\n#ifndef TPG_BATCH_SIZE\n"
+              << "#define TPG_BATCH_SIZE 64\n"
+              << "#endif\n\n"
+              << "void inferenceTPGBatch(int n, " << parameters
+              << "int* actions);\n";
+
+    fileMain
+        << "\nstatic void tpgBatchSelect(int n, const double* scores, "
+           "double* bestScores, int* next, int first, int destination) {\n"
+        << "\tfor (int b = 0; b < n; b++) {\n"
+        << "\t\tdouble score = (isnan(scores[b]))? -INFINITY : scores[b];\n"
+        << "\t\tif (first || score >= bestScores[b]) {\n"
+        << "\t\t\tbestScores[b] = score;\n"
+        << "\t\t\tnext[b] = destination;\n"
+        << "\t\t}\n"
+        << "\t}\n"
+        << "}\n\n"
+
+        << "static void inferenceTPGBatchChunk(int n, " << parameters
+        << "int* actions) {\n"
+        << "\tint vertex[TPG_BATCH_SIZE];\n"
+        << "\tint group[TPG_BATCH_SIZE];\n"
+        << "\tint next[TPG_BATCH_SIZE];\n"
+        << "\tdouble scores[TPG_BATCH_SIZE];\n"
+        << "\tdouble bestScores[TPG_BATCH_SIZE];\n"
+        << "\tint nb;\n\n"
+        << "\tfor (int i = 0; i < n; i++) {\n"
+        << "\t\tvertex[i] = " << vertexCode(root) << ";\n"
+        << "\t}\n";
+
+    for (const TPG::TPGTeam* team : teams) {
+        const auto& edges = team->getOutgoingEdges();
+        fileMain << "\n\t// T" << findVertexID(*team) << "\n"
+                 << "\tnb = 0;\n"
+                 << "\tfor (int i = 0; i < n; i++) {\n"
+                 << "\t\tif (vertex[i] == " << vertexCodes.at(team) << ") {\n"
+                 << "\t\t\tgroup[nb++] = i;\n"
+                 << "\t\t}\n"
+                 << "\t}\n";
+        if (edges.size() == 1) {
+            fileMain << "\tfor (int b = 0; b < nb; b++) {\n"
+                     << "\t\tvertex[group[b]] = "
+                     << vertexCode(edges.front()->getDestination()) << ";\n"
+                     << "\t}\n";
+            continue;
+        }
+        bool first = true;
+        for (const TPG::TPGEdge* edge : edges) {
+            fileMain << "\tP" << programIDs.at(edge)
+                     << "_batch(nb, group, scores, " << arguments
+                     << ");\n"
+                     << "\ttpgBatchSelect(nb, scores, bestScores, next, "
+                     << first << ", " << vertexCode(edge->getDestination())
+                     << ");\n";
+            first = false;
+        }
+        fileMain << "\tfor (int b = 0; b < nb; b++) {\n"
+                 << "\t\tvertex[group[b]] = next[b];\n"
+                 << "\t}\n";
+    }
+
+    fileMain << "\n\tfor (int i = 0; i < n; i++) {\n"
+             << "\t\tactions[i] = -vertex[i] - 1;\n"
+             << "\t}\n"
+             << "}\n\n"
+
+             << "void inferenceTPGBatch(int n, " << parameters
+             << "int* actions) {\n"
+             << "\tfor (int first = 0; first < n; first += TPG_BATCH_SIZE) "
+                "{\n"
+             << "\t\tint size = (n - first < TPG_BATCH_SIZE) ? n - first : "
+                "TPG_BATCH_SIZE;\n"
+             << "\t\tinferenceTPGBatchChunk(size, " << chunkArguments
+             << "actions + first);\n"
+             << "\t}\n"
+             << "}\n";
+}
+
 #endif // CODE_GENERATION
@@ -40,6 +40,7 @@
 #include "codeGen/tpgGenerationEngineFactory.h"
 #include "codeGen/tpgStackGenerationEngine.h"
 #include "codeGen/tpgSwitchGenerationEngine.h"
+#include "codeGen/tpgTableGenerationEngine.h"
 
 CodeGen::TPGGenerationEngineFactory::TPGGenerationEngineFactory()
     : TPGGenerationEngineFactory(switchMode){};
@@ -61,6 +62,9 @@ std::unique_ptr<CodeGen::TPGGenerationEngine> CodeGen::
     else if (this->mode == switchMode) {
         return std::make_unique<TPGSwitchGenerationEngine>(filename, tpg, path);
     }
+    else if (this->mode == tableMode) {
+        return std::make_unique<TPGTableGenerationEngine>(filename, tpg, path);
+    }
     else {
         return nullptr;
     }
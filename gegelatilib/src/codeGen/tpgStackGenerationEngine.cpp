@@ -56,14 +56,7 @@ CodeGen::TPGStackGenerationEngine::~TPGStackGenerationEngine()
 
 void CodeGen::TPGStackGenerationEngine::generateEdge(const TPG::TPGEdge& edge)
 {
-    const Program::Program& p = edge.getProgram();
-    uint64_t progID;
-
-    progGenerationEngine.setProgram(p);
-
-    if (findProgramID(p, progID)) {
-        progGenerationEngine.generateProgram(progID);
-    }
+    uint64_t progID = findProgramFunctionID(edge.getProgram());
 
     std::string destinationName;
     const TPG::TPGVertex* destination = edge.getDestination();
@@ -83,8 +76,12 @@ void CodeGen::TPGStackGenerationEngine::generateEdge(const TPG::TPGEdge& edge)
 void CodeGen::TPGStackGenerationEngine::generateTeam(const TPG::TPGTeam& team)
 {
     uint64_t id = findVertexID(team);
+    std::string attribute;
+    if (profileGuided) {
+        attribute = (vertexVisits.count(&team) > 0) ? "TPG_HOT " : "TPG_COLD ";
+    }
     // print prototype and declaration of the function
-    fileMain << "void* T" << id << "(int* action){" << std::endl;
+    fileMain << attribute << "void* T" << id << "(int* action){" << std::endl;
     fileMainH << "void* T" << id << "(int* action);" << std::endl;
     // generate static array
     fileMain << "\tstatic Edge e[] = {" << std::endl;
@@ -132,7 +129,7 @@ void CodeGen::TPGStackGenerationEngine::generateTPGGraph()
     initHeaderFile();
 
     std::map<const TPG::TPGTeam*, std::list<TPG::TPGEdge*>> graph;
-    auto vertices = this->tpg.getVertices();
+    auto vertices = getVerticesInLayoutOrder();
     // give an id for each team of the graph
     for (auto vertex : vertices) {
         if (dynamic_cast<const TPG::TPGTeam*>(vertex) != nullptr) {
@@ -143,6 +140,10 @@ void CodeGen::TPGStackGenerationEngine::generateTPGGraph()
         }
     }
     setRoot(*tpg.getRootVertices().at(0));
+
+    if (batchInference) {
+        generateBatchInference();
+    }
 }
 
 void CodeGen::TPGStackGenerationEngine::initTpgFile()
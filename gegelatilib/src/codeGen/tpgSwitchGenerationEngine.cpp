@@ -41,15 +41,7 @@
 
 void CodeGen::TPGSwitchGenerationEngine::generateEdge(const TPG::TPGEdge& edge)
 {
-    const Program::Program& p = edge.getProgram();
-    uint64_t progID;
-
-    progGenerationEngine.setProgram(p);
-
-    if (findProgramID(p, progID)) {
-        progGenerationEngine.generateProgram(progID);
-    }
-    fileMain << "P" << progID << "()";
+    fileMain << "P" << findProgramFunctionID(edge.getProgram()) << "()";
 }
 
 void CodeGen::TPGSwitchGenerationEngine::generateTeam(const TPG::TPGTeam& team)
@@ -83,8 +75,39 @@ void CodeGen::TPGSwitchGenerationEngine::generateTeam(const TPG::TPGTeam& team)
     }
     fileMain << std::endl;
 
-    fileMain << "\t\t\tint best = bestProgram(" << teamName << "Scores, "
-             << edges.size() << ");" << std::endl;
+    if (profileGuided) {
+        // Inline the selection of the best edge to hint each comparison.
+        fileMain << "\t\t\tint best = 0;" << std::endl;
+        if (edges.size() > 1) {
+            fileMain << "\t\t\tdouble bestScore = (isnan(" << teamName
+                     << "Scores[0]))? -INFINITY : " << teamName << "Scores[0];"
+                     << std::endl;
+        }
+        i = 0;
+        for (const auto* edge : edges) {
+            if (i > 0) {
+                std::string condition = "challengerScore" +
+                                        std::to_string(i) + " >= bestScore";
+                std::string hint = getComparisonHint(team, *edge);
+                if (!hint.empty()) {
+                    condition = hint + "(" + condition + ")";
+                }
+                fileMain << "\t\t\tdouble challengerScore" << i << " = (isnan("
+                         << teamName << "Scores[" << i << "]))? -INFINITY : "
+                         << teamName << "Scores[" << i << "];" << std::endl;
+                fileMain << "\t\t\tif (" << condition << ") {" << std::endl;
+                fileMain << "\t\t\t\tbest = " << i << ";" << std::endl;
+                fileMain << "\t\t\t\tbestScore = challengerScore" << i << ";"
+                         << std::endl;
+                fileMain << "\t\t\t}" << std::endl;
+            }
+            ++i;
+        }
+    }
+    else {
+        fileMain << "\t\t\tint best = bestProgram(" << teamName << "Scores, "
+                 << edges.size() << ");" << std::endl;
+    }
     fileMain << "\t\t\tcurrentVertex = next[best];" << std::endl;
 }
 
@@ -120,7 +143,7 @@ void CodeGen::TPGSwitchGenerationEngine::generateTPGGraph()
     // generate switch case to navigate the graph
     fileMain << "\twhile(1) {" << std::endl;
     fileMain << "\t\tswitch (currentVertex) {" << std::endl;
-    for (auto vertex : vertices) {
+    for (auto vertex : getVerticesInLayoutOrder()) {
         fileMain << "\t\tcase " << vertexName(*vertex) << ": {" << std::endl;
         if (dynamic_cast<const TPG::TPGTeam*>(vertex) != nullptr) {
             generateTeam(*(const TPG::TPGTeam*)vertex);
@@ -134,6 +157,10 @@ void CodeGen::TPGSwitchGenerationEngine::generateTPGGraph()
     fileMain << "\t\t}" << std::endl;
     fileMain << "\t}" << std::endl;
     fileMain << "}" << std::endl;
+
+    if (batchInference) {
+        generateBatchInference();
+    }
 }
 
 void CodeGen::TPGSwitchGenerationEngine::initTpgFile()
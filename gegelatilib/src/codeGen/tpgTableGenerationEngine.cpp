@@ -0,0 +1,503 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifdef CODE_GENERATION
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <regex>
+#include <stdexcept>
+
+#include "codeGen/tpgTableGenerationEngine.h"
+#include "tpg/tpgAction.h"
+
+/**
+ * \brief Get the name of a data source in the generated code.
+ *
+ * \param[in] env the Environment of the TPGGraph.
+ * \param[in] idx the index of the data source, registers and constants
+ * included.
+ * \return "reg", "cst" or "in<k>".
+ */
+static std::string sourceName(const Environment& env, uint64_t idx)
+{
+    if (idx == 0) {
+        return "reg";
+    }
+    if (env.getNbConstant() > 0) {
+        return (idx == 1) ? "cst" : "in" + std::to_string(idx - 1);
+    }
+    return "in" + std::to_string(idx);
+}
+
+/**
+ * \brief Relocate the accesses to a data source printed for address 0.
+ *
+ * \param[in] init the initialization of an operand printed by a
+ * DataHandlerPrinter for address 0.
+ * \param[in] name the name of the data source in init.
+ * \param[in] pointer the name replacing the data source.
+ * \param[in] address the expression of the address of the operand.
+ * \return a copy of init where each name[k] is replaced with
+ * pointer[address + k].
+ */
+static std::string relocate(const std::string& init, const std::string& name,
+                            const std::string& pointer,
+                            const std::string& address)
+{
+    const std::regex access_regex("\\b" + name + "\\[([0-9]+)\\]");
+    std::string relocated;
+    auto last = init.cbegin();
+    for (auto itr = std::sregex_iterator(init.begin(), init.end(),
+                                         access_regex);
+         itr != std::sregex_iterator(); ++itr) {
+        relocated.append(last, (*itr)[0].first);
+        last = (*itr)[0].second;
+        const std::string offset = (*itr)[1].str();
+        relocated += pointer + "[" + address +
+                     ((offset == "0") ? "" : " + " + offset) + "]";
+    }
+    relocated.append(last, init.cend());
+    return relocated;
+}
+
+void CodeGen::TPGTableGenerationEngine::generateTPGGraph()
+{
+    // Index teams first so that edges can refer to any of them. With a
+    // profile, hot teams and their edges are contiguous in the tables.
+    auto vertices = getVerticesInLayoutOrder();
+    for (const TPG::TPGVertex* vertex : vertices) {
+        if (dynamic_cast<const TPG::TPGTeam*>(vertex) != nullptr) {
+            uint64_t index = teamIndexes.size();
+            teamIndexes[vertex] = index;
+        }
+        else if (dynamic_cast<const TPG::TPGAction*>(vertex) != nullptr) {
+            generateAction(*(const TPG::TPGAction*)vertex);
+        }
+    }
+    for (const TPG::TPGVertex* vertex : vertices) {
+        if (dynamic_cast<const TPG::TPGTeam*>(vertex) != nullptr) {
+            generateTeam(*(const TPG::TPGTeam*)vertex);
+        }
+    }
+
+    initTpgFile();
+    initHeaderFile();
+
+    auto printTable = [this](const std::string& declaration,
+                             const std::ostringstream& rows,
+                             const std::string& emptyRow) {
+        fileMain << "static const " << declaration << "[] = {\n"
+                 << (rows.str().empty() ? "\t" + emptyRow + ",\n" : rows.str())
+                 << "};\n\n";
+    };
+    printTable("TPGLine tpgLines", linesTable, "{0}");
+    printTable("TPGProgram tpgPrograms", programsTable, "{0}");
+    if (tpg.getEnvironment().getNbConstant() > 0) {
+        printTable("int32_t tpgConstants", constantsTable, "0");
+    }
+    printTable("TPGEdge tpgEdges", edgesTable, "{0}");
+    printTable("TPGTeam tpgTeams", teamsTable, "{0}");
+
+    generateInterpreter();
+
+    if (batchInference) {
+        generateBatchInference();
+    }
+}
+
+void CodeGen::TPGTableGenerationEngine::generateEdge(const TPG::TPGEdge& edge)
+{
+    edgesTable << "\t{" << findProgramIndex(edge.getProgram()) << ", "
+               << vertexCode(*edge.getDestination()) << "}," << std::endl;
+    nbEdges++;
+}
+
+void CodeGen::TPGTableGenerationEngine::generateTeam(const TPG::TPGTeam& team)
+{
+    const auto& edges = team.getOutgoingEdges();
+    teamsTable << "\t{" << nbEdges << ", " << edges.size() << "}, // T"
+               << findVertexID(team) << std::endl;
+    for (const TPG::TPGEdge* edge : edges) {
+        generateEdge(*edge);
+    }
+}
+
+void CodeGen::TPGTableGenerationEngine::generateAction(
+    const TPG::TPGAction& action)
+{
+    maxActionID = std::max(maxActionID, action.getActionID());
+}
+
+uint64_t CodeGen::TPGTableGenerationEngine::findProgramIndex(
+    const Program::Program& program)
+{
+    auto known = programIndexes.find(&program);
+    if (known != programIndexes.end()) {
+        return known->second;
+    }
+
+    const Environment& env = tpg.getEnvironment();
+    const auto& sources = env.getFakeDataSources();
+
+    std::vector<uint64_t> lineIndexes;
+    if (isProgramOptimization()) {
+        progGenerationEngine.setProgram(program);
+        lineIndexes = progGenerationEngine.findLiveLines();
+    }
+    else {
+        for (uint64_t i = 0; i < program.getNbLines(); i++) {
+            if (!program.isIntron(i)) {
+                lineIndexes.push_back(i);
+            }
+        }
+    }
+
+    std::ostringstream rows;
+    for (uint64_t i : lineIndexes) {
+        const Program::Line& line = program.getLine(i);
+        const Instructions::Instruction& instruction =
+            env.getInstructionSet().getInstruction(line.getInstructionIndex());
+        if (!instruction.isPrintable()) {
+            throw std::runtime_error("The instruction is not printable, stop "
+                                     "the generation of the program.");
+        }
+        usedOpcodes.insert(line.getInstructionIndex());
+
+        std::ostringstream lineSources;
+        std::ostringstream lineAddresses;
+        for (uint64_t op = 0; op < std::max<uint64_t>(env.getMaxNbOperands(), 1);
+             op++) {
+            uint64_t sourceIdx = 0;
+            uint64_t address = 0;
+            if (op < instruction.getNbOperands()) {
+                sourceIdx = line.getOperand(op).first;
+                const Data::DataHandler& source = sources.at(sourceIdx);
+                const std::type_info& type =
+                    instruction.getOperandTypes().at(op).get();
+                address =
+                    source
+                        .getAddressesAccessed(
+                            type,
+                            source.scaleLocation(line.getOperand(op).second,
+                                                 type))
+                        .at(0);
+                maxAddress = std::max(maxAddress, address);
+            }
+            lineSources << ((op > 0) ? ", " : "") << sourceIdx;
+            lineAddresses << ((op > 0) ? ", " : "") << address;
+        }
+        rows << "\t{" << line.getInstructionIndex() << ", "
+             << line.getDestinationIndex() << ", {" << lineSources.str()
+             << "}, {" << lineAddresses.str() << "}}," << std::endl;
+    }
+
+    std::ostringstream constants;
+    for (size_t i = 0; i < env.getNbConstant(); i++) {
+        constants << program.getConstantAt(i).value << ", ";
+    }
+
+    // Identical Programs share their rows.
+    auto [row, isNew] = programRows.emplace(rows.str() + constants.str(),
+                                            programRows.size());
+    if (isNew) {
+        programsTable << "\t{" << nbLines << ", " << lineIndexes.size()
+                      << "}," << std::endl;
+        linesTable << rows.str();
+        nbLines += lineIndexes.size();
+        if (env.getNbConstant() > 0) {
+            constantsTable << "\t" << constants.str() << std::endl;
+        }
+    }
+    programIndexes[&program] = row->second;
+    return row->second;
+}
+
+int64_t CodeGen::TPGTableGenerationEngine::vertexCode(
+    const TPG::TPGVertex& vertex) const
+{
+    auto action = dynamic_cast<const TPG::TPGAction*>(&vertex);
+    if (action != nullptr) {
+        return -(int64_t)action->getActionID() - 1;
+    }
+    return (int64_t)teamIndexes.at(&vertex);
+}
+
+void CodeGen::TPGTableGenerationEngine::initTpgFile()
+{
+    const Environment& env = tpg.getEnvironment();
+
+    fileMain << "#include <math.h>\n"
+             << "#include <stdint.h>\n\n"
+             << "#include \"externHeader.h\"\n\n";
+
+    const auto& dataSources = env.getDataSources();
+    for (size_t i = 0; i < dataSources.size(); i++) {
+        fileMain << "extern "
+                 << dataPrinter.getDemangleTemplateType(dataSources.at(i))
+                 << "* in" << i + 1 << ";" << std::endl;
+    }
+
+    fileMain << "\n#define TPG_NB_REGISTERS " << env.getNbRegisters()
+             << std::endl;
+    if (env.getNbConstant() > 0) {
+        fileMain << "#define TPG_NB_CONSTANTS " << env.getNbConstant()
+                 << std::endl;
+    }
+    uint64_t maxOpcode =
+        usedOpcodes.empty() ? 0 : *usedOpcodes.rbegin();
+    size_t nbOperands = std::max<uint64_t>(env.getMaxNbOperands(), 1);
+
+    fileMain << "\ntypedef " << integerType(0, maxOpcode)
+             << " tpg_opcode_t;\n"
+             << "typedef " << integerType(0, env.getNbRegisters())
+             << " tpg_register_t;\n"
+             << "typedef " << integerType(0, env.getNbDataSources())
+             << " tpg_source_t;\n"
+             << "typedef " << integerType(0, maxAddress)
+             << " tpg_address_t;\n"
+             << "typedef " << integerType(0, nbLines) << " tpg_line_t;\n"
+             << "typedef " << integerType(0, programRows.size())
+             << " tpg_program_t;\n"
+             << "typedef " << integerType(0, nbEdges) << " tpg_edge_t;\n"
+             << "typedef "
+             << integerType(-(int64_t)maxActionID - 1, teamIndexes.size())
+             << " tpg_vertex_t;\n\n"
+
+             << "typedef struct TPGLine {\n"
+             << "\ttpg_opcode_t opcode;\n"
+             << "\ttpg_register_t destination;\n"
+             << "\ttpg_source_t sources[" << nbOperands << "];\n"
+             << "\ttpg_address_t addresses[" << nbOperands << "];\n"
+             << "} TPGLine;\n\n"
+
+             << "typedef struct TPGProgram {\n"
+             << "\ttpg_line_t firstLine;\n"
+             << "\ttpg_line_t nbLines;\n"
+             << "} TPGProgram;\n\n"
+
+             << "typedef struct TPGEdge {\n"
+             << "\ttpg_program_t program;\n"
+             << "\ttpg_vertex_t destination;\n"
+             << "} TPGEdge;\n\n"
+
+             << "typedef struct TPGTeam {\n"
+             << "\ttpg_edge_t firstEdge;\n"
+             << "\ttpg_edge_t nbEdges;\n"
+             << "} TPGTeam;\n\n";
+}
+
+void CodeGen::TPGTableGenerationEngine::initHeaderFile()
+{
+    fileMainH << "#include <stdlib.h>\n\n"
+              << "int inferenceTPG();\n";
+}
+
+void CodeGen::TPGTableGenerationEngine::generateInterpreter()
+{
+    const Environment& env = tpg.getEnvironment();
+
+    fileMain << "static double executeProgram(int program) {\n"
+             << "\tdouble reg[TPG_NB_REGISTERS] = {0};\n";
+    if (env.getNbConstant() > 0) {
+        fileMain << "\tconst int32_t* cst = tpgConstants + program * "
+                    "TPG_NB_CONSTANTS;\n";
+    }
+    fileMain << "\tconst TPGLine* line = tpgLines + "
+                "tpgPrograms[program].firstLine;\n"
+             << "\tconst TPGLine* end = line + tpgPrograms[program].nbLines;\n"
+             << "\tfor (; line < end; line++) {\n"
+             << "\t\tswitch (line->opcode) {\n";
+    for (uint64_t opcode : usedOpcodes) {
+        generateOpcodeCase(opcode);
+    }
+    fileMain << "\t\tdefault:\n"
+             << "\t\t\tbreak;\n"
+             << "\t\t}\n"
+             << "\t}\n"
+             << "\treturn reg[0];\n"
+             << "}\n\n";
+
+    fileMain
+        << "int inferenceTPG() {\n"
+        << "\tint vertex = " << vertexCode(*tpg.getRootVertices().at(0))
+        << ";\n"
+        << "\twhile (vertex >= 0) {\n"
+        << "\t\tconst TPGTeam* team = &tpgTeams[vertex];\n"
+        << "\t\tint best = team->firstEdge;\n"
+        << "\t\tif (team->nbEdges > 1) {\n"
+        << "\t\t\tdouble bestScore = executeProgram(tpgEdges[best].program);\n"
+        << "\t\t\tbestScore = (isnan(bestScore)) ? -INFINITY : bestScore;\n"
+        << "\t\t\tfor (int e = best + 1; e < team->firstEdge + team->nbEdges; "
+           "e++) {\n"
+        << "\t\t\t\tdouble score = executeProgram(tpgEdges[e].program);\n"
+        << "\t\t\t\tscore = (isnan(score)) ? -INFINITY : score;\n"
+        << "\t\t\t\tif (score >= bestScore) {\n"
+        << "\t\t\t\t\tbestScore = score;\n"
+        << "\t\t\t\t\tbest = e;\n"
+        << "\t\t\t\t}\n"
+        << "\t\t\t}\n"
+        << "\t\t}\n"
+        << "\t\tvertex = tpgEdges[best].destination;\n"
+        << "\t}\n"
+        << "\treturn -vertex - 1;\n"
+        << "}\n";
+}
+
+void CodeGen::TPGTableGenerationEngine::generateOpcodeCase(uint64_t opcode)
+{
+    const Environment& env = tpg.getEnvironment();
+    const Instructions::Instruction& instruction =
+        env.getInstructionSet().getInstruction(opcode);
+    const auto& sources = env.getFakeDataSources();
+
+    fileMain << "\t\tcase " << opcode << ": {" << std::endl;
+    for (uint64_t op = 0; op < instruction.getNbOperands(); op++) {
+        const std::type_info& type = instruction.getOperandTypes().at(op).get();
+        const std::string address =
+            "line->addresses[" + std::to_string(op) + "]";
+
+        // Sources that can provide the operand must share the type and the
+        // layout of their accesses, so that they can be read through a
+        // single pointer.
+        std::vector<uint64_t> candidates;
+        std::string layout;
+        std::string pointerType;
+        std::string firstInit;
+        std::string firstName;
+        for (uint64_t idx = 0; idx < sources.size(); idx++) {
+            const Data::DataHandler& source = sources.at(idx);
+            if (!source.canHandle(type)) {
+                continue;
+            }
+            const std::string name = sourceName(env, idx);
+            const std::string init =
+                dataPrinter.printDataAt(source, type, 0, name);
+            std::string sourceLayout = relocate(init, name, "src", "a");
+            std::string sourceType =
+                (idx == 0) ? "double"
+                : (name == "cst")
+                    ? "int32_t"
+                    : dataPrinter.getDemangleTemplateType(source);
+            if (candidates.empty()) {
+                layout = sourceLayout;
+                pointerType = sourceType;
+                firstInit = init;
+                firstName = name;
+            }
+            else if (layout != sourceLayout || pointerType != sourceType) {
+                throw std::runtime_error(
+                    "Operand " + std::to_string(op) + " of instruction " +
+                    std::to_string(opcode) +
+                    " can be read from data sources with different types or "
+                    "layouts, which is not supported by the table generation "
+                    "engine.");
+            }
+            candidates.push_back(idx);
+        }
+        if (candidates.empty()) {
+            throw std::runtime_error("No data source can provide operand " +
+                                     std::to_string(op) + " of instruction " +
+                                     std::to_string(opcode) + ".");
+        }
+
+        std::string pointer;
+        if (candidates.size() == 1) {
+            pointer = sourceName(env, candidates.front());
+        }
+        else {
+            pointer = "src" + std::to_string(op);
+            fileMain << "\t\t\tconst " << pointerType << "* " << pointer
+                     << " = ";
+            for (size_t i = 0; i + 1 < candidates.size(); i++) {
+                fileMain << "(line->sources[" << op
+                         << "] == " << candidates.at(i) << ") ? "
+                         << sourceName(env, candidates.at(i)) << " : ";
+            }
+            fileMain << sourceName(env, candidates.back()) << ";" << std::endl;
+        }
+        fileMain << "\t\t\t" << instruction.getPrintablePrimitiveOperandType(op)
+                 << " op" << op << relocate(firstInit, firstName, pointer, address)
+                 << std::endl;
+    }
+
+    // $0 is the destination register, $k the operand k - 1.
+    static const std::regex operand_regex("\\$([0-9]+)");
+    const std::string& printTemplate = instruction.getPrintTemplate();
+    std::string codeLine;
+    auto last = printTemplate.cbegin();
+    for (auto itr = std::sregex_iterator(printTemplate.begin(),
+                                         printTemplate.end(), operand_regex);
+         itr != std::sregex_iterator(); ++itr) {
+        codeLine.append(last, (*itr)[0].first);
+        last = (*itr)[0].second;
+        int idx = std::stoi((*itr)[1].str());
+        codeLine += (idx == 0) ? std::string("reg[line->destination]")
+                               : "op" + std::to_string(idx - 1);
+    }
+    codeLine.append(last, printTemplate.cend());
+
+    fileMain << "\t\t\t" << codeLine << std::endl
+             << "\t\t\tbreak;" << std::endl
+             << "\t\t}" << std::endl;
+}
+
+std::string CodeGen::TPGTableGenerationEngine::integerType(int64_t min,
+                                                           uint64_t max)
+{
+    if (min < 0) {
+        if (min >= INT8_MIN && max <= INT8_MAX) {
+            return "int8_t";
+        }
+        if (min >= INT16_MIN && max <= INT16_MAX) {
+            return "int16_t";
+        }
+        if (min >= INT32_MIN && max <= INT32_MAX) {
+            return "int32_t";
+        }
+        return "int64_t";
+    }
+    if (max <= UINT8_MAX) {
+        return "uint8_t";
+    }
+    if (max <= UINT16_MAX) {
+        return "uint16_t";
+    }
+    if (max <= UINT32_MAX) {
+        return "uint32_t";
+    }
+    return "uint64_t";
+}
+
+#endif // CODE_GENERATION
@@ -36,6 +36,7 @@
  */
 
 #include <algorithm>
+#include <stdexcept>
 
 #include "data/dataHandler.h"
 
@@ -63,3 +64,15 @@ uint64_t Data::DataHandler::scaleLocation(const uint64_t rawLocation,
 {
     return rawLocation % this->getAddressSpace(type);
 }
+
+void Data::DataHandler::writeData(std::ostream& out) const
+{
+    throw std::runtime_error(
+        "DataHandler does not support writing its data in a binary stream.");
+}
+
+void Data::DataHandler::readData(std::istream& in)
+{
+    throw std::runtime_error(
+        "DataHandler does not support reading its data from a binary stream.");
+}
@@ -0,0 +1,607 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
+#include <utility>
+
+#include "data/constant.h"
+#include "learn/classificationEvaluationResult.h"
+#include "program/line.h"
+#include "tpg/tpgAction.h"
+#include "tpg/tpgEdge.h"
+#include "tpg/tpgTeam.h"
+#include "tpg/tpgVertex.h"
+
+#include "file/learningAgentCheckpoint.h"
+
+namespace {
+    /// Magic number at the beginning of all checkpoints.
+    const char MAGIC[8] = {'G', 'E', 'G', 'E', 'C', 'K', 'P', 'T'};
+
+    /// Index used for absent vertices and results.
+    const uint64_t NO_INDEX = std::numeric_limits<uint64_t>::max();
+
+    /// Type tags of EvaluationResult.
+    enum ResultType : uint8_t
+    {
+        EVALUATION_RESULT = 0,
+        CLASSIFICATION_EVALUATION_RESULT = 1
+    };
+
+    /// Type tags of TPGVertex.
+    enum VertexType : uint8_t
+    {
+        TEAM = 0,
+        ACTION = 1
+    };
+
+    template <typename T> void writeValue(std::ostream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T> T readValue(std::istream& in)
+    {
+        T value;
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        if (!in) {
+            throw std::runtime_error("Unexpected end of checkpoint.");
+        }
+        return value;
+    }
+
+    /// Check that an index read from a checkpoint is valid.
+    uint64_t checkIndex(uint64_t idx, size_t size)
+    {
+        if (idx >= size) {
+            throw std::runtime_error("Invalid index in checkpoint.");
+        }
+        return idx;
+    }
+} // namespace
+
+void File::LearningAgentCheckpoint::writeRNG(const Mutator::RNG& rng,
+                                             std::ostream& out)
+{
+    // The standard only defines a textual serialization of the engine.
+    std::ostringstream state;
+    state << *rng.engine;
+    std::string str = state.str();
+    writeValue<uint64_t>(out, str.size());
+    out.write(str.data(), str.size());
+}
+
+void File::LearningAgentCheckpoint::readRNG(Mutator::RNG& rng,
+                                            std::istream& in)
+{
+    std::string str(readValue<uint64_t>(in), '\0');
+    in.read(&str[0], str.size());
+    std::istringstream state(str);
+    state >> *rng.engine;
+    if (!in || state.fail()) {
+        throw std::runtime_error("Invalid RNG state in checkpoint.");
+    }
+}
+
+void File::LearningAgentCheckpoint::writeProgram(const Program::Program& prog,
+                                                 std::ostream& out)
+{
+    const Environment& env = prog.getEnvironment();
+    writeValue<uint64_t>(out, prog.getNbLines());
+    for (uint64_t i = 0; i < prog.getNbLines(); i++) {
+        const Program::Line& line = prog.getLine(i);
+        writeValue<uint64_t>(out, line.getInstructionIndex());
+        writeValue<uint64_t>(out, line.getDestinationIndex());
+        for (uint64_t op = 0; op < env.getMaxNbOperands(); op++) {
+            writeValue<uint64_t>(out, line.getOperand(op).first);
+            writeValue<uint64_t>(out, line.getOperand(op).second);
+        }
+    }
+    for (size_t i = 0; i < env.getNbConstant(); i++) {
+        writeValue<int32_t>(out, prog.getConstantAt(i).value);
+    }
+}
+
+std::shared_ptr<Program::Program> File::LearningAgentCheckpoint::readProgram(
+    const Environment& env, std::istream& in)
+{
+    auto prog = std::make_shared<Program::Program>(env);
+    uint64_t nbLines = readValue<uint64_t>(in);
+    for (uint64_t i = 0; i < nbLines; i++) {
+        Program::Line& line = prog->addNewLine();
+        bool valid = line.setInstructionIndex(readValue<uint64_t>(in));
+        valid &= line.setDestinationIndex(readValue<uint64_t>(in));
+        for (uint64_t op = 0; op < env.getMaxNbOperands(); op++) {
+            uint64_t dataIndex = readValue<uint64_t>(in);
+            uint64_t location = readValue<uint64_t>(in);
+            valid &= line.setOperand(op, dataIndex, location);
+        }
+        if (!valid) {
+            throw std::runtime_error("Invalid Program Line in checkpoint.");
+        }
+    }
+    for (size_t i = 0; i < env.getNbConstant(); i++) {
+        prog->getConstantHandler().setDataAt(
+            typeid(Data::Constant), i, {readValue<int32_t>(in)});
+    }
+    prog->identifyIntrons();
+    return prog;
+}
+
+void File::LearningAgentCheckpoint::writeEvaluationResult(
+    const Learn::EvaluationResult& res, std::ostream& out)
+{
+    if (typeid(res) == typeid(Learn::EvaluationResult)) {
+        writeValue<uint8_t>(out, EVALUATION_RESULT);
+        writeValue<double>(out, res.getResult());
+        writeValue<uint64_t>(out, res.getNbEvaluation());
+    }
+    else if (typeid(res) == typeid(Learn::ClassificationEvaluationResult)) {
+        const auto& classRes =
+            static_cast<const Learn::ClassificationEvaluationResult&>(res);
+        writeValue<uint8_t>(out, CLASSIFICATION_EVALUATION_RESULT);
+        writeValue<uint64_t>(out, classRes.getScorePerClass().size());
+        for (size_t i = 0; i < classRes.getScorePerClass().size(); i++) {
+            writeValue<double>(out, classRes.getScorePerClass().at(i));
+            writeValue<uint64_t>(out,
+                                 classRes.getNbEvaluationPerClass().at(i));
+        }
+    }
+    else {
+        throw std::runtime_error(
+            std::string("Unsupported EvaluationResult type in checkpoint: ") +
+            typeid(res).name());
+    }
+    writeValue<double>(out, res.getInferenceCost());
+}
+
+std::shared_ptr<Learn::EvaluationResult> File::LearningAgentCheckpoint::
+    readEvaluationResult(std::istream& in)
+{
+    std::shared_ptr<Learn::EvaluationResult> res;
+    switch (readValue<uint8_t>(in)) {
+    case EVALUATION_RESULT: {
+        double result = readValue<double>(in);
+        size_t nbEval = readValue<uint64_t>(in);
+        res = std::make_shared<Learn::EvaluationResult>(result, nbEval);
+        break;
+    }
+    case CLASSIFICATION_EVALUATION_RESULT: {
+        std::vector<double> scores(readValue<uint64_t>(in));
+        std::vector<size_t> nbEvals(scores.size());
+        for (size_t i = 0; i < scores.size(); i++) {
+            scores.at(i) = readValue<double>(in);
+            nbEvals.at(i) = readValue<uint64_t>(in);
+        }
+        res = std::make_shared<Learn::ClassificationEvaluationResult>(
+            scores, nbEvals);
+        break;
+    }
+    default:
+        throw std::runtime_error(
+            "Unknown EvaluationResult type in checkpoint.");
+    }
+    res->setInferenceCost(readValue<double>(in));
+    return res;
+}
+
+void File::LearningAgentCheckpoint::writeArchive(
+    const Archive& archive,
+    const std::map<const Program::Program*, uint64_t>& programIdx,
+    std::ostream& out)
+{
+    writeRNG(archive.rng, out);
+
+    writeValue<uint64_t>(out, archive.dataHandlers.size());
+    for (const auto& hashAndHandlers : archive.dataHandlers) {
+        writeValue<uint64_t>(out, hashAndHandlers.first);
+        writeValue<uint64_t>(out, hashAndHandlers.second.size());
+        for (const auto& dHandler : hashAndHandlers.second) {
+            dHandler.get().writeData(out);
+        }
+    }
+
+    // Programs no longer in the graph are identified by indices following
+    // those of the graph Programs.
+    std::map<const Program::Program*, uint64_t> freedProgramIdx;
+    writeValue<uint64_t>(out, archive.recordings.size());
+    for (const ArchiveRecording& recording : archive.recordings) {
+        auto iter = programIdx.find(recording.prog);
+        if (iter == programIdx.end()) {
+            iter = freedProgramIdx
+                       .emplace(recording.prog,
+                                programIdx.size() + freedProgramIdx.size())
+                       .first;
+        }
+        writeValue<uint64_t>(out, iter->second);
+        writeValue<uint64_t>(out, recording.dataHash);
+        writeValue<double>(out, recording.result);
+    }
+}
+
+void File::LearningAgentCheckpoint::readArchive(
+    const Environment& env,
+    const std::vector<std::shared_ptr<Program::Program>>& programs,
+    std::istream& in, Archive& archive)
+{
+    readRNG(archive.rng, in);
+
+    // Copies of the DataHandler are restored from clones of the
+    // LearningEnvironment data sources.
+    const auto& dataSources = env.getDataSources();
+    uint64_t nbHandlerSets = readValue<uint64_t>(in);
+    for (uint64_t i = 0; i < nbHandlerSets; i++) {
+        size_t hash = readValue<uint64_t>(in);
+        uint64_t nbHandlers = readValue<uint64_t>(in);
+        if (nbHandlers != dataSources.size()) {
+            throw std::runtime_error("Archived data sources in checkpoint do "
+                                     "not match the LearningEnvironment.");
+        }
+        std::vector<std::unique_ptr<Data::DataHandler>> copies;
+        for (uint64_t h = 0; h < nbHandlers; h++) {
+            copies.emplace_back(dataSources.at(h).get().clone());
+            copies.back()->readData(in);
+        }
+        // The Archive frees its DataHandler once the whole set is read.
+        auto& handlers = archive.dataHandlers[hash];
+        for (auto& copy : copies) {
+            handlers.push_back(*copy.release());
+        }
+    }
+
+    std::map<uint64_t, const Program::Program*> freedPrograms;
+    uint64_t nbRecordings = readValue<uint64_t>(in);
+    for (uint64_t i = 0; i < nbRecordings; i++) {
+        uint64_t progIdx = readValue<uint64_t>(in);
+        size_t hash = readValue<uint64_t>(in);
+        double result = readValue<double>(in);
+
+        const Program::Program* prog;
+        if (progIdx < programs.size()) {
+            prog = programs.at(progIdx).get();
+        }
+        else {
+            auto iter = freedPrograms.find(progIdx);
+            if (iter == freedPrograms.end()) {
+                archive.placeholderPrograms.emplace_back(
+                    new Program::Program(env));
+                iter = freedPrograms
+                           .emplace(progIdx,
+                                    archive.placeholderPrograms.back().get())
+                           .first;
+            }
+            prog = iter->second;
+        }
+
+        if (archive.dataHandlers.count(hash) == 0) {
+            throw std::runtime_error(
+                "Archive recording in checkpoint references unknown data.");
+        }
+        ArchiveRecording recording{prog, hash, result};
+        archive.recordings.push_back(recording);
+        archive.recordingsPerProgram[prog].push_back(recording);
+    }
+}
+
+void File::LearningAgentCheckpoint::write(const Learn::LearningAgent& la,
+                                          uint64_t generationNumber,
+                                          std::ostream& out)
+{
+    const Environment& env = la.env;
+    const TPG::TPGGraph& graph = *la.tpg;
+
+    // Header
+    out.write(MAGIC, sizeof(MAGIC));
+    writeValue<uint32_t>(out, FORMAT_VERSION);
+    writeValue<uint64_t>(out, generationNumber);
+
+    // Environment characteristics, checked when reading.
+    writeValue<uint64_t>(out, env.getNbRegisters());
+    writeValue<uint64_t>(out, env.getNbConstant());
+    writeValue<uint64_t>(out, env.getNbInstructions());
+    writeValue<uint64_t>(out, env.getMaxNbOperands());
+    writeValue<uint64_t>(out, env.getNbDataSources());
+
+    writeRNG(la.rng, out);
+    writeValue<double>(out, la.bestScoreLastGen);
+
+    // Programs, in order of first use by edges.
+    std::map<const Program::Program*, uint64_t> programIdx;
+    std::vector<const Program::Program*> programs;
+    for (const auto& edge : graph.getEdges()) {
+        const Program::Program* prog = &edge->getProgram();
+        if (programIdx.emplace(prog, programs.size()).second) {
+            programs.push_back(prog);
+        }
+    }
+    writeValue<uint64_t>(out, programs.size());
+    for (const Program::Program* prog : programs) {
+        writeProgram(*prog, out);
+    }
+
+    // Vertices
+    std::map<const TPG::TPGVertex*, uint64_t> vertexIdx;
+    const std::vector<const TPG::TPGVertex*> vertices = graph.getVertices();
+    writeValue<uint64_t>(out, vertices.size());
+    for (const TPG::TPGVertex* vertex : vertices) {
+        vertexIdx.emplace(vertex, vertexIdx.size());
+        const TPG::TPGAction* action =
+            dynamic_cast<const TPG::TPGAction*>(vertex);
+        if (action != nullptr) {
+            writeValue<uint8_t>(out, ACTION);
+            writeValue<uint64_t>(out, action->getActionID());
+        }
+        else {
+            writeValue<uint8_t>(out, TEAM);
+        }
+    }
+
+    // Edges
+    writeValue<uint64_t>(out, graph.getEdges().size());
+    for (const auto& edge : graph.getEdges()) {
+        writeValue<uint64_t>(out, vertexIdx.at(edge->getSource()));
+        writeValue<uint64_t>(out, vertexIdx.at(edge->getDestination()));
+        writeValue<uint64_t>(out, programIdx.at(&edge->getProgram()));
+    }
+
+    // EvaluationResult, written once even when shared between the
+    // resultsPerRoot map and the bestRoot.
+    std::map<const Learn::EvaluationResult*, uint64_t> resultIdx;
+    std::vector<const Learn::EvaluationResult*> results;
+    auto registerResult = [&](const Learn::EvaluationResult* res) {
+        if (res != nullptr && resultIdx.emplace(res, results.size()).second) {
+            results.push_back(res);
+        }
+    };
+    for (const auto& rootAndResult : la.resultsPerRoot) {
+        registerResult(rootAndResult.second.get());
+    }
+    registerResult(la.bestRoot.second.get());
+    writeValue<uint64_t>(out, results.size());
+    for (const Learn::EvaluationResult* res : results) {
+        writeEvaluationResult(*res, out);
+    }
+
+    // Results of roots still in the graph, in the graph order.
+    std::vector<std::pair<uint64_t, uint64_t>> rootResults;
+    for (const TPG::TPGVertex* vertex : vertices) {
+        auto iter = la.resultsPerRoot.find(vertex);
+        if (iter != la.resultsPerRoot.end()) {
+            rootResults.emplace_back(vertexIdx.at(vertex),
+                                     resultIdx.at(iter->second.get()));
+        }
+    }
+    writeValue<uint64_t>(out, rootResults.size());
+    for (const auto& rootResult : rootResults) {
+        writeValue<uint64_t>(out, rootResult.first);
+        writeValue<uint64_t>(out, rootResult.second);
+    }
+
+    // Best root. The vertex may no longer be in the graph.
+    auto bestVertex = vertexIdx.find(la.bestRoot.first);
+    writeValue<uint64_t>(out, (bestVertex != vertexIdx.end())
+                                  ? bestVertex->second
+                                  : NO_INDEX);
+    writeValue<uint64_t>(out, (la.bestRoot.second != nullptr)
+                                  ? resultIdx.at(la.bestRoot.second.get())
+                                  : NO_INDEX);
+
+    writeArchive(la.archive, programIdx, out);
+
+    if (!out) {
+        throw std::runtime_error("Error while writing checkpoint.");
+    }
+}
+
+uint64_t File::LearningAgentCheckpoint::read(Learn::LearningAgent& la,
+                                             std::istream& in)
+{
+    const Environment& env = la.env;
+
+    // Header
+    char magic[sizeof(MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Stream does not contain a checkpoint.");
+    }
+    if (readValue<uint32_t>(in) != FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported checkpoint format version.");
+    }
+    uint64_t generationNumber = readValue<uint64_t>(in);
+
+    if (readValue<uint64_t>(in) != env.getNbRegisters() ||
+        readValue<uint64_t>(in) != env.getNbConstant() ||
+        readValue<uint64_t>(in) != env.getNbInstructions() ||
+        readValue<uint64_t>(in) != env.getMaxNbOperands() ||
+        readValue<uint64_t>(in) != env.getNbDataSources()) {
+        throw std::runtime_error("Checkpoint was saved with an Environment "
+                                 "different from the LearningAgent one.");
+    }
+
+    // Parse everything before modifying the LearningAgent.
+    Mutator::RNG rng;
+    readRNG(rng, in);
+    double bestScoreLastGen = readValue<double>(in);
+
+    std::vector<std::shared_ptr<Program::Program>> programs(
+        readValue<uint64_t>(in));
+    for (auto& prog : programs) {
+        prog = readProgram(env, in);
+    }
+
+    std::vector<std::pair<uint8_t, uint64_t>> vertices(
+        readValue<uint64_t>(in));
+    for (auto& vertex : vertices) {
+        vertex.first = readValue<uint8_t>(in);
+        if (vertex.first == ACTION) {
+            vertex.second = readValue<uint64_t>(in);
+        }
+        else if (vertex.first != TEAM) {
+            throw std::runtime_error("Unknown vertex type in checkpoint.");
+        }
+    }
+
+    struct EdgeRecord
+    {
+        uint64_t src;
+        uint64_t dest;
+        uint64_t prog;
+    };
+    std::vector<EdgeRecord> edges(readValue<uint64_t>(in));
+    for (auto& edge : edges) {
+        edge.src = checkIndex(readValue<uint64_t>(in), vertices.size());
+        edge.dest = checkIndex(readValue<uint64_t>(in), vertices.size());
+        edge.prog = checkIndex(readValue<uint64_t>(in), programs.size());
+    }
+
+    std::vector<std::shared_ptr<Learn::EvaluationResult>> results(
+        readValue<uint64_t>(in));
+    for (auto& res : results) {
+        res = readEvaluationResult(in);
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> rootResults(
+        readValue<uint64_t>(in));
+    for (auto& rootResult : rootResults) {
+        rootResult.first =
+            checkIndex(readValue<uint64_t>(in), vertices.size());
+        rootResult.second =
+            checkIndex(readValue<uint64_t>(in), results.size());
+    }
+
+    uint64_t bestVertex = readValue<uint64_t>(in);
+    uint64_t bestResult = readValue<uint64_t>(in);
+    if (bestVertex != NO_INDEX) {
+        checkIndex(bestVertex, vertices.size());
+    }
+    if (bestResult != NO_INDEX) {
+        checkIndex(bestResult, results.size());
+    }
+
+    // Handlers of the temporary Archive are freed with it, as well as those
+    // of the LearningAgent Archive once swapped.
+    Archive archive;
+    readArchive(env, programs, in, archive);
+
+    // Restore the TPGGraph
+    TPG::TPGGraph& graph = *la.tpg;
+    graph.clear();
+    std::vector<const TPG::TPGVertex*> newVertices;
+    for (const auto& vertex : vertices) {
+        if (vertex.first == ACTION) {
+            newVertices.push_back(&graph.addNewAction(vertex.second));
+        }
+        else {
+            newVertices.push_back(&graph.addNewTeam());
+        }
+    }
+    for (const auto& edge : edges) {
+        graph.addNewEdge(*newVertices.at(edge.src),
+                         *newVertices.at(edge.dest), programs.at(edge.prog));
+    }
+
+    // Restore the training state
+    *la.rng.engine = *rng.engine;
+    la.bestScoreLastGen = bestScoreLastGen;
+    la.resultsPerRoot.clear();
+    for (const auto& rootResult : rootResults) {
+        la.resultsPerRoot.emplace(newVertices.at(rootResult.first),
+                                  results.at(rootResult.second));
+    }
+    la.bestRoot = {
+        (bestVertex != NO_INDEX) ? newVertices.at(bestVertex) : nullptr,
+        (bestResult != NO_INDEX) ? results.at(bestResult) : nullptr};
+
+    *la.archive.rng.engine = *archive.rng.engine;
+    std::swap(la.archive.dataHandlers, archive.dataHandlers);
+    std::swap(la.archive.recordings, archive.recordings);
+    std::swap(la.archive.recordingsPerProgram, archive.recordingsPerProgram);
+    std::swap(la.archive.placeholderPrograms, archive.placeholderPrograms);
+
+    return generationNumber;
+}
+
+void File::LearningAgentCheckpoint::save(const Learn::LearningAgent& la,
+                                         uint64_t generationNumber,
+                                         const std::string& path)
+{
+    saveAsync(la, generationNumber, path).get();
+}
+
+std::future<void> File::LearningAgentCheckpoint::saveAsync(
+    const Learn::LearningAgent& la, uint64_t generationNumber,
+    const std::string& path)
+{
+    // Serialize the snapshot synchronously, only the file IO is deferred.
+    auto snapshot = std::make_shared<std::string>();
+    {
+        std::ostringstream out(std::ios::binary);
+        write(la, generationNumber, out);
+        *snapshot = out.str();
+    }
+
+    return std::async(std::launch::async, [snapshot, path]() {
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                throw std::runtime_error("Could not open file " + tmpPath);
+            }
+            file.write(snapshot->data(), snapshot->size());
+            if (!file) {
+                throw std::runtime_error("Error while writing " + tmpPath);
+            }
+        }
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Could not rename " + tmpPath + " to " +
+                                     path);
+        }
+    });
+}
+
+uint64_t File::LearningAgentCheckpoint::load(Learn::LearningAgent& la,
+                                             const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file " + path);
+    }
+    return read(la, file);
+}
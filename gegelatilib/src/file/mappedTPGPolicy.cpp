@@ -0,0 +1,158 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <typeinfo>
+
+#include "data/constant.h"
+#include "instructions/instruction.h"
+
+#include "file/mappedTPGPolicy.h"
+
+File::MappedTPGPolicy::MappedTPGPolicy(const char* filePath,
+                                       const Environment& env)
+    : file(filePath), env{env},
+      header{TPGGraphBinaryFormat::checkFile(file.getData(), file.getSize(),
+                                             env)},
+      registers(env.getNbRegisters()), constants(env.getNbConstant())
+{
+    this->dataSources.push_back(this->registers);
+    if (env.getNbConstant() > 0) {
+        this->dataSources.push_back(this->constants);
+    }
+    for (const auto& dataSource : env.getDataSources()) {
+        this->dataSources.push_back(dataSource);
+    }
+}
+
+uint64_t File::MappedTPGPolicy::getNbRoots() const
+{
+    return this->header.nbRoots;
+}
+
+double File::MappedTPGPolicy::executeProgram(uint64_t programIdx)
+{
+    using namespace TPGGraphBinaryFormat;
+    const char* data = this->file.getData();
+    const ProgramRecord& program = getTable<ProgramRecord>(
+        data, this->header.programTableOffset)[programIdx];
+    const LineRecord* lines =
+        getTable<LineRecord>(data, this->header.lineTableOffset);
+    const OperandRecord* operands =
+        getTable<OperandRecord>(data, this->header.operandTableOffset);
+    const int32_t* constantValues =
+        getTable<int32_t>(data, this->header.constantTableOffset) +
+        programIdx * this->header.nbConstants;
+    const uint8_t* introns =
+        (this->header.flags & FLAG_INTRON_MASK)
+            ? getTable<uint8_t>(data, this->header.intronTableOffset)
+            : nullptr;
+
+    this->registers.resetData();
+    for (uint64_t c = 0; c < this->header.nbConstants; c++) {
+        this->constants.setDataAt(typeid(Data::Constant), c,
+                                  {constantValues[c]});
+    }
+
+    const Instructions::Set& iSet = this->env.getInstructionSet();
+    std::vector<Data::UntypedSharedPtr> args;
+    for (uint64_t lineIdx = program.firstLine;
+         lineIdx < program.firstLine + program.nbLines; lineIdx++) {
+        if (introns != nullptr && introns[lineIdx] != 0) {
+            continue;
+        }
+
+        const Instructions::Instruction& instruction =
+            iSet.getInstruction(lines[lineIdx].instruction);
+        args.clear();
+        for (uint64_t op = 0; op < instruction.getNbOperands(); op++) {
+            const OperandRecord& operand =
+                operands[lineIdx * this->header.maxNbOperands + op];
+            const Data::DataHandler& dataSource =
+                this->dataSources.at(operand.dataSource).get();
+            const std::type_info& operandType =
+                instruction.getOperandTypes().at(op).get();
+            args.push_back(dataSource.getDataAt(
+                operandType,
+                dataSource.scaleLocation(operand.location, operandType)));
+        }
+        this->registers.setDataAt(typeid(double), lines[lineIdx].destination,
+                                  instruction.execute(args));
+    }
+
+    double result = *(this->registers.getDataAt(typeid(double), 0)
+                          .getSharedPointer<const double>());
+    return (std::isnan(result)) ? -std::numeric_limits<double>::infinity()
+                                : result;
+}
+
+uint64_t File::MappedTPGPolicy::executeFromRoot(uint64_t rootIdx)
+{
+    using namespace TPGGraphBinaryFormat;
+    if (rootIdx >= this->header.nbRoots) {
+        throw std::out_of_range("Invalid root index for the policy.");
+    }
+    const char* data = this->file.getData();
+    const VertexRecord* vertices =
+        getTable<VertexRecord>(data, this->header.vertexTableOffset);
+    const EdgeRecord* edges =
+        getTable<EdgeRecord>(data, this->header.edgeTableOffset);
+
+    uint64_t vertexIdx =
+        getTable<uint64_t>(data, this->header.rootTableOffset)[rootIdx];
+    uint64_t nbVisited = 0;
+    while (vertices[vertexIdx].actionID == TEAM_VERTEX) {
+        if (++nbVisited > this->header.nbVertices) {
+            throw std::runtime_error("Cycle detected in the policy.");
+        }
+
+        // Same rule as TPGExecutionEngine: the last best bid wins.
+        const VertexRecord& team = vertices[vertexIdx];
+        uint64_t bestEdge = team.firstEdge;
+        double bestBid = this->executeProgram(edges[bestEdge].program);
+        for (uint64_t e = team.firstEdge + 1;
+             e < team.firstEdge + team.nbEdges; e++) {
+            double bid = this->executeProgram(edges[e].program);
+            if (bid >= bestBid) {
+                bestEdge = e;
+                bestBid = bid;
+            }
+        }
+        vertexIdx = edges[bestEdge].destination;
+    }
+
+    return vertices[vertexIdx].actionID;
+}
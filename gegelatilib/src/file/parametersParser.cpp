@@ -89,8 +89,8 @@ void File::ParametersParser::setAllParamsFrom(const Json::Value& root,
             }
             continue;
         }
-        if (root[key].size() == 0) {
-            // we have a parameter without subtree (as a leaf)
+        if (root[key].size() == 0 || root[key].isArray()) {
+            // we have a parameter without subtree (as a leaf), or a list
             Json::Value value = root[key];
             setParameterFromString(params, key, value);
         }
@@ -222,10 +222,61 @@ void File::ParametersParser::setParameterFromString(
         params.nbThreads = (size_t)value.asUInt();
         return;
     }
+    if (param == "threadAffinity") {
+        params.threadAffinity = value.asString();
+        return;
+    }
+    if (param == "nbEpisodesInFlight") {
+        params.nbEpisodesInFlight = (size_t)value.asUInt64();
+        return;
+    }
+    if (param == "observationCacheSize") {
+        params.observationCacheSize = (size_t)value.asUInt64();
+        return;
+    }
+    if (param == "inferenceCostPenalty") {
+        params.inferenceCostPenalty = value.asDouble();
+        return;
+    }
+    if (param == "paretoCostSelection") {
+        params.paretoCostSelection = value.asBool();
+        return;
+    }
+    if (param == "teamInferenceCost") {
+        params.teamInferenceCost = value.asDouble();
+        return;
+    }
+    if (param == "instructionInferenceCosts") {
+        params.instructionInferenceCosts.clear();
+        for (const Json::Value& cost : value) {
+            params.instructionInferenceCosts.push_back(cost.asDouble());
+        }
+        return;
+    }
     if (param == "doValidation") {
         params.doValidation = value.asBool();
         return;
     }
+    if (param == "maxNbIterationsPerJob") {
+        params.maxNbIterationsPerJob = value.asUInt64();
+        return;
+    }
+    if (param == "pipelineValidation") {
+        params.pipelineValidation = value.asBool();
+        return;
+    }
+    if (param == "nbIslands") {
+        params.nbIslands = (size_t)value.asUInt64();
+        return;
+    }
+    if (param == "migrationInterval") {
+        params.migrationInterval = value.asUInt64();
+        return;
+    }
+    if (param == "nbMigrants") {
+        params.nbMigrants = (size_t)value.asUInt64();
+        return;
+    }
     // we didn't recognize the symbol
     std::cerr << "Ignoring unknown parameter " << param << std::endl;
 }
@@ -271,10 +322,29 @@ void File::ParametersParser::writeParametersToJson(
         Learn::LearningParameters::maxNbEvaluationPerPolicyComment,
         Json::commentBefore);
 
+    root["maxNbIterationsPerJob"] = params.maxNbIterationsPerJob;
+    root["maxNbIterationsPerJob"].setComment(
+        Learn::LearningParameters::maxNbIterationsPerJobComment,
+        Json::commentBefore);
+
+    root["migrationInterval"] = params.migrationInterval;
+    root["migrationInterval"].setComment(
+        Learn::LearningParameters::migrationIntervalComment,
+        Json::commentBefore);
+
+    root["nbEpisodesInFlight"] = params.nbEpisodesInFlight;
+    root["nbEpisodesInFlight"].setComment(
+        Learn::LearningParameters::nbEpisodesInFlightComment,
+        Json::commentBefore);
+
     root["nbGenerations"] = params.nbGenerations;
     root["nbGenerations"].setComment(
         Learn::LearningParameters::nbGenerationsComment, Json::commentBefore);
 
+    root["nbIslands"] = params.nbIslands;
+    root["nbIslands"].setComment(Learn::LearningParameters::nbIslandsComment,
+                                 Json::commentBefore);
+
     root["nbIterationsPerJob"] = params.nbIterationsPerJob;
     root["nbIterationsPerJob"].setComment(
         Learn::LearningParameters::nbIterationsPerJobComment,
@@ -286,6 +356,10 @@ void File::ParametersParser::writeParametersToJson(
         Learn::LearningParameters::nbIterationsPerPolicyEvaluationComment,
         Json::commentBefore);
 
+    root["nbMigrants"] = params.nbMigrants;
+    root["nbMigrants"].setComment(Learn::LearningParameters::nbMigrantsComment,
+                                  Json::commentBefore);
+
     root["nbProgramConstant"] = params.nbProgramConstant;
     root["nbProgramConstant"].setComment(
         Learn::LearningParameters::nbProgramConstantComment,
@@ -299,11 +373,48 @@ void File::ParametersParser::writeParametersToJson(
     root["nbThreads"].setComment(Learn::LearningParameters::nbThreadsComment,
                                  Json::commentBefore);
 
+    root["threadAffinity"] = params.threadAffinity;
+    root["threadAffinity"].setComment(
+        Learn::LearningParameters::threadAffinityComment, Json::commentBefore);
+
+    root["observationCacheSize"] = params.observationCacheSize;
+    root["observationCacheSize"].setComment(
+        Learn::LearningParameters::observationCacheSizeComment,
+        Json::commentBefore);
+
+    root["pipelineValidation"] = params.pipelineValidation;
+    root["pipelineValidation"].setComment(
+        Learn::LearningParameters::pipelineValidationComment,
+        Json::commentBefore);
+
     root["ratioDeletedRoots"] = params.ratioDeletedRoots;
     root["ratioDeletedRoots"].setComment(
         Learn::LearningParameters::ratioDeletedRootsComment,
         Json::commentBefore);
 
+    root["inferenceCostPenalty"] = params.inferenceCostPenalty;
+    root["inferenceCostPenalty"].setComment(
+        Learn::LearningParameters::inferenceCostPenaltyComment,
+        Json::commentBefore);
+
+    root["paretoCostSelection"] = params.paretoCostSelection;
+    root["paretoCostSelection"].setComment(
+        Learn::LearningParameters::paretoCostSelectionComment,
+        Json::commentBefore);
+
+    root["teamInferenceCost"] = params.teamInferenceCost;
+    root["teamInferenceCost"].setComment(
+        Learn::LearningParameters::teamInferenceCostComment,
+        Json::commentBefore);
+
+    root["instructionInferenceCosts"] = Json::Value(Json::arrayValue);
+    for (double cost : params.instructionInferenceCosts) {
+        root["instructionInferenceCosts"].append(cost);
+    }
+    root["instructionInferenceCosts"].setComment(
+        Learn::LearningParameters::instructionInferenceCostsComment,
+        Json::commentBefore);
+
     // Mutation.tpg parameters
     root["mutation"]["tpg"]["forceProgramBehaviorChangeOnMutation"] =
         params.mutation.tpg.forceProgramBehaviorChangeOnMutation;
@@ -0,0 +1,193 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include "program/line.h"
+#include "program/program.h"
+#include "tpg/tpgAction.h"
+#include "tpg/tpgEdge.h"
+#include "tpg/tpgVertex.h"
+
+#include "file/tpgGraphBinaryFormat.h"
+
+#include "file/tpgGraphBinaryExporter.h"
+
+namespace {
+    /// Size of a table rounded up to keep tables aligned on 8 bytes.
+    uint64_t alignedSize(uint64_t size)
+    {
+        return (size + 7) & ~uint64_t(7);
+    }
+
+    /// Write a table followed by padding bytes.
+    template <class T>
+    void writeTable(std::ofstream& file, const std::vector<T>& table)
+    {
+        uint64_t size = table.size() * sizeof(T);
+        file.write(reinterpret_cast<const char*>(table.data()), size);
+        static const char padding[8] = {0};
+        file.write(padding, alignedSize(size) - size);
+    }
+} // namespace
+
+void File::TPGGraphBinaryExporter::setNewFilePath(const char* newFilePath)
+{
+    this->filePath = newFilePath;
+}
+
+void File::TPGGraphBinaryExporter::exportGraph(bool withIntronMask)
+{
+    using namespace TPGGraphBinaryFormat;
+    const Environment& env = this->graph.getEnvironment();
+    const uint64_t maxNbOperands = env.getMaxNbOperands();
+    const uint64_t nbConstants = env.getNbConstant();
+
+    const std::vector<const TPG::TPGVertex*> graphVertices =
+        this->graph.getVertices();
+    std::map<const TPG::TPGVertex*, uint64_t> vertexIdx;
+    for (const TPG::TPGVertex* vertex : graphVertices) {
+        vertexIdx.emplace(vertex, vertexIdx.size());
+    }
+
+    // Build the tables
+    std::vector<VertexRecord> vertices;
+    std::vector<EdgeRecord> edges;
+    std::vector<ProgramRecord> programs;
+    std::vector<LineRecord> lines;
+    std::vector<OperandRecord> operands;
+    std::vector<int32_t> constants;
+    std::vector<uint64_t> roots;
+    std::vector<uint8_t> introns;
+    std::map<const Program::Program*, uint64_t> programIdx;
+
+    for (const TPG::TPGVertex* vertex : graphVertices) {
+        const TPG::TPGAction* action =
+            dynamic_cast<const TPG::TPGAction*>(vertex);
+        vertices.push_back({(action != nullptr) ? action->getActionID()
+                                                : TEAM_VERTEX,
+                            edges.size(), vertex->getOutgoingEdges().size()});
+        if (vertex->getIncomingEdges().empty()) {
+            roots.push_back(vertexIdx.at(vertex));
+        }
+
+        for (const TPG::TPGEdge* edge : vertex->getOutgoingEdges()) {
+            const Program::Program& prog = edge->getProgram();
+            auto iter = programIdx.find(&prog);
+            if (iter == programIdx.end()) {
+                iter = programIdx.emplace(&prog, programs.size()).first;
+                programs.push_back({lines.size(), prog.getNbLines()});
+                for (uint64_t i = 0; i < prog.getNbLines(); i++) {
+                    const Program::Line& line = prog.getLine(i);
+                    lines.push_back({line.getInstructionIndex(),
+                                     line.getDestinationIndex()});
+                    for (uint64_t op = 0; op < maxNbOperands; op++) {
+                        operands.push_back({line.getOperand(op).first,
+                                            line.getOperand(op).second});
+                    }
+                    introns.push_back(prog.isIntron(i) ? 1 : 0);
+                }
+                for (size_t i = 0; i < nbConstants; i++) {
+                    constants.push_back(prog.getConstantAt(i).value);
+                }
+            }
+            edges.push_back(
+                {vertexIdx.at(edge->getDestination()), iter->second});
+        }
+    }
+
+    // Build the header
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.flags = withIntronMask ? FLAG_INTRON_MASK : 0;
+    header.environmentFingerprint = computeEnvironmentFingerprint(env);
+    header.instructionSetSignature =
+        computeInstructionSetSignature(env.getInstructionSet());
+    header.nbRegisters = env.getNbRegisters();
+    header.nbConstants = nbConstants;
+    header.maxNbOperands = maxNbOperands;
+    header.nbVertices = vertices.size();
+    header.nbEdges = edges.size();
+    header.nbPrograms = programs.size();
+    header.nbLines = lines.size();
+    header.nbRoots = roots.size();
+
+    uint64_t offset = alignedSize(sizeof(Header));
+    auto placeTable = [&offset](uint64_t& tableOffset, uint64_t size) {
+        tableOffset = offset;
+        offset += alignedSize(size);
+    };
+    placeTable(header.vertexTableOffset,
+               vertices.size() * sizeof(VertexRecord));
+    placeTable(header.edgeTableOffset, edges.size() * sizeof(EdgeRecord));
+    placeTable(header.programTableOffset,
+               programs.size() * sizeof(ProgramRecord));
+    placeTable(header.lineTableOffset, lines.size() * sizeof(LineRecord));
+    placeTable(header.operandTableOffset,
+               operands.size() * sizeof(OperandRecord));
+    placeTable(header.constantTableOffset,
+               constants.size() * sizeof(int32_t));
+    placeTable(header.rootTableOffset, roots.size() * sizeof(uint64_t));
+    if (withIntronMask) {
+        placeTable(header.intronTableOffset, introns.size());
+    }
+    header.fileSize = offset;
+
+    // Write the file
+    std::ofstream file(this->filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file " + this->filePath);
+    }
+    writeTable(file, std::vector<Header>{header});
+    writeTable(file, vertices);
+    writeTable(file, edges);
+    writeTable(file, programs);
+    writeTable(file, lines);
+    writeTable(file, operands);
+    writeTable(file, constants);
+    writeTable(file, roots);
+    if (withIntronMask) {
+        writeTable(file, introns);
+    }
+    if (!file) {
+        throw std::runtime_error("Error while writing file " +
+                                 this->filePath);
+    }
+}
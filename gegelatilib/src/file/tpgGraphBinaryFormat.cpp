@@ -0,0 +1,298 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "data/demangle.h"
+#include "data/hash.h"
+
+#include "file/tpgGraphBinaryFormat.h"
+
+namespace {
+    /// Append a string to a FNV-1a hash.
+    size_t appendString(size_t hash, const std::string& str)
+    {
+        return Data::_Fnv1a_append_bytes(
+            hash, reinterpret_cast<const unsigned char*>(str.c_str()),
+            str.size() + 1);
+    }
+
+    /// Check that a table lies within the file and is aligned.
+    void checkTable(const File::TPGGraphBinaryFormat::Header& header,
+                    uint64_t offset, uint64_t nbElements, size_t elementSize)
+    {
+        if (offset % 8 != 0 || offset > header.fileSize ||
+            nbElements > (header.fileSize - offset) / elementSize) {
+            throw std::runtime_error("Invalid table in binary TPG file.");
+        }
+    }
+} // namespace
+
+uint64_t File::TPGGraphBinaryFormat::computeEnvironmentFingerprint(
+    const Environment& env)
+{
+    size_t hash = Data::_FNV_offset_basis;
+    hash = Data::_Fnv1a_append_value(hash, (uint64_t)env.getNbRegisters());
+    hash = Data::_Fnv1a_append_value(hash, (uint64_t)env.getNbConstant());
+    hash = Data::_Fnv1a_append_value(hash, (uint64_t)env.getNbInstructions());
+    hash = Data::_Fnv1a_append_value(hash, (uint64_t)env.getMaxNbOperands());
+    hash = Data::_Fnv1a_append_value(hash, (uint64_t)env.getNbDataSources());
+    for (const auto& dataSource : env.getDataSources()) {
+        hash = appendString(
+            hash, DEMANGLE_TYPEID_NAME(typeid(dataSource.get()).name()));
+        hash = Data::_Fnv1a_append_value(
+            hash, (uint64_t)dataSource.get().getLargestAddressSpace());
+    }
+    return hash;
+}
+
+uint64_t File::TPGGraphBinaryFormat::computeInstructionSetSignature(
+    const Instructions::Set& iSet)
+{
+    size_t hash = Data::_FNV_offset_basis;
+    for (uint64_t i = 0; i < iSet.getNbInstructions(); i++) {
+        const Instructions::Instruction& instruction = iSet.getInstruction(i);
+        hash = appendString(hash,
+                            DEMANGLE_TYPEID_NAME(typeid(instruction).name()));
+        hash = Data::_Fnv1a_append_value(
+            hash, (uint64_t)instruction.getNbOperands());
+        for (const auto& operandType : instruction.getOperandTypes()) {
+            hash = appendString(hash,
+                                DEMANGLE_TYPEID_NAME(operandType.get().name()));
+        }
+    }
+    return hash;
+}
+
+const File::TPGGraphBinaryFormat::Header& File::TPGGraphBinaryFormat::
+    checkFile(const char* data, size_t size, const Environment& env)
+{
+    if (size < sizeof(Header)) {
+        throw std::runtime_error("File is too small to be a binary TPG file.");
+    }
+    const Header& header = *reinterpret_cast<const Header*>(data);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("File is not a binary TPG file.");
+    }
+    if (header.version != VERSION) {
+        throw std::runtime_error("Unsupported binary TPG file version.");
+    }
+    if (header.fileSize != size) {
+        throw std::runtime_error("Binary TPG file is truncated.");
+    }
+    if (header.environmentFingerprint != computeEnvironmentFingerprint(env) ||
+        header.instructionSetSignature !=
+            computeInstructionSetSignature(env.getInstructionSet()) ||
+        header.nbRegisters != env.getNbRegisters() ||
+        header.nbConstants != env.getNbConstant() ||
+        header.maxNbOperands != env.getMaxNbOperands()) {
+        throw std::runtime_error("Binary TPG file was exported with a "
+                                 "different Environment.");
+    }
+
+    checkTable(header, header.vertexTableOffset, header.nbVertices,
+               sizeof(VertexRecord));
+    checkTable(header, header.edgeTableOffset, header.nbEdges,
+               sizeof(EdgeRecord));
+    checkTable(header, header.programTableOffset, header.nbPrograms,
+               sizeof(ProgramRecord));
+    checkTable(header, header.lineTableOffset, header.nbLines,
+               sizeof(LineRecord));
+    checkTable(header, header.operandTableOffset,
+               header.nbLines * header.maxNbOperands, sizeof(OperandRecord));
+    checkTable(header, header.constantTableOffset,
+               header.nbPrograms * header.nbConstants, sizeof(int32_t));
+    checkTable(header, header.rootTableOffset, header.nbRoots,
+               sizeof(uint64_t));
+    if (header.flags & FLAG_INTRON_MASK) {
+        checkTable(header, header.intronTableOffset, header.nbLines,
+                   sizeof(uint8_t));
+    }
+
+    // Check indexes, so that users of the tables do not need to.
+    const VertexRecord* vertices =
+        getTable<VertexRecord>(data, header.vertexTableOffset);
+    for (uint64_t i = 0; i < header.nbVertices; i++) {
+        if (vertices[i].firstEdge > header.nbEdges ||
+            vertices[i].nbEdges > header.nbEdges - vertices[i].firstEdge ||
+            (vertices[i].actionID == TEAM_VERTEX && vertices[i].nbEdges == 0)) {
+            throw std::runtime_error("Invalid vertex in binary TPG file.");
+        }
+    }
+    const EdgeRecord* edges =
+        getTable<EdgeRecord>(data, header.edgeTableOffset);
+    for (uint64_t i = 0; i < header.nbEdges; i++) {
+        if (edges[i].destination >= header.nbVertices ||
+            edges[i].program >= header.nbPrograms) {
+            throw std::runtime_error("Invalid edge in binary TPG file.");
+        }
+    }
+    const ProgramRecord* programs =
+        getTable<ProgramRecord>(data, header.programTableOffset);
+    for (uint64_t i = 0; i < header.nbPrograms; i++) {
+        if (programs[i].firstLine > header.nbLines ||
+            programs[i].nbLines > header.nbLines - programs[i].firstLine) {
+            throw std::runtime_error("Invalid program in binary TPG file.");
+        }
+    }
+    const LineRecord* lines =
+        getTable<LineRecord>(data, header.lineTableOffset);
+    const OperandRecord* operands =
+        getTable<OperandRecord>(data, header.operandTableOffset);
+    const std::vector<std::reference_wrapper<const Data::DataHandler>>&
+        dataSources = env.getFakeDataSources();
+    for (uint64_t i = 0; i < header.nbLines; i++) {
+        if (lines[i].instruction >= env.getNbInstructions() ||
+            lines[i].destination >= env.getNbRegisters()) {
+            throw std::runtime_error("Invalid line in binary TPG file.");
+        }
+        const Instructions::Instruction& instruction =
+            env.getInstructionSet().getInstruction(lines[i].instruction);
+        for (uint64_t op = 0; op < header.maxNbOperands; op++) {
+            const OperandRecord& operand =
+                operands[i * header.maxNbOperands + op];
+            // Same check as Line::setOperand(), and the data source of used
+            // operands must provide their type for scaleLocation().
+            if (operand.dataSource >= env.getNbDataSources() ||
+                operand.location >= env.getLargestAddressSpace() ||
+                (op < instruction.getNbOperands() &&
+                 dataSources.at(operand.dataSource)
+                         .get()
+                         .getAddressSpace(
+                             instruction.getOperandTypes().at(op).get()) ==
+                     0)) {
+                throw std::runtime_error(
+                    "Invalid operand in binary TPG file.");
+            }
+        }
+    }
+    const uint64_t* roots = getTable<uint64_t>(data, header.rootTableOffset);
+    for (uint64_t i = 0; i < header.nbRoots; i++) {
+        if (roots[i] >= header.nbVertices) {
+            throw std::runtime_error("Invalid root in binary TPG file.");
+        }
+    }
+
+    return header;
+}
+
+File::TPGGraphBinaryFormat::MappedFile::MappedFile(const char* filePath)
+    : data{nullptr}, size{0}
+{
+#ifndef _WIN32
+    int fd = open(filePath, O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file " +
+                                 std::string(filePath));
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        throw std::runtime_error("Could not read size of file " +
+                                 std::string(filePath));
+    }
+    this->size = fileStat.st_size;
+    if (this->size > 0) {
+        void* mapping =
+            mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Could not map file " +
+                                     std::string(filePath));
+        }
+        this->data = static_cast<const char*>(mapping);
+    }
+    // The mapping stays valid after closing the file descriptor.
+    close(fd);
+#else
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file " +
+                                 std::string(filePath));
+    }
+    this->size = file.tellg();
+    this->buffer.resize(this->size);
+    file.seekg(0);
+    file.read(this->buffer.data(), this->size);
+    this->data = this->buffer.data();
+#endif
+}
+
+File::TPGGraphBinaryFormat::MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if (this->data != nullptr) {
+        munmap(const_cast<char*>(this->data), this->size);
+    }
+#endif
+}
+
+const char* File::TPGGraphBinaryFormat::MappedFile::getData() const
+{
+    return this->data;
+}
+
+size_t File::TPGGraphBinaryFormat::MappedFile::getSize() const
+{
+    return this->size;
+}
+
+void File::TPGGraphBinaryFormat::MappedFile::prefetch(size_t offset,
+                                                      size_t length) const
+{
+#ifndef _WIN32
+    if (this->data == nullptr || offset >= this->size) {
+        return;
+    }
+    length = std::min(length, this->size - offset);
+
+    // madvise requires an address aligned on a page.
+    static const size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t alignedOffset = offset - (offset % pageSize);
+    madvise(const_cast<char*>(this->data) + alignedOffset,
+            length + (offset - alignedOffset), MADV_WILLNEED);
+#endif
+}
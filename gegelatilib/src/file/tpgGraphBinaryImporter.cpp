@@ -0,0 +1,137 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <memory>
+#include <typeinfo>
+#include <vector>
+
+#include "data/constant.h"
+#include "program/line.h"
+#include "program/program.h"
+#include "tpg/tpgVertex.h"
+
+#include "file/tpgGraphBinaryFormat.h"
+
+#include "file/tpgGraphBinaryImporter.h"
+
+void File::TPGGraphBinaryImporter::setNewFilePath(const char* newFilePath)
+{
+    this->filePath = newFilePath;
+}
+
+void File::TPGGraphBinaryImporter::importGraph()
+{
+    using namespace TPGGraphBinaryFormat;
+    const Environment& env = this->tpg.getEnvironment();
+
+    MappedFile file(this->filePath.c_str());
+    const char* data = file.getData();
+    const Header& header = checkFile(data, file.getSize(), env);
+
+    const VertexRecord* vertexTable =
+        getTable<VertexRecord>(data, header.vertexTableOffset);
+    const EdgeRecord* edgeTable =
+        getTable<EdgeRecord>(data, header.edgeTableOffset);
+    const ProgramRecord* programTable =
+        getTable<ProgramRecord>(data, header.programTableOffset);
+    const LineRecord* lineTable =
+        getTable<LineRecord>(data, header.lineTableOffset);
+    const OperandRecord* operandTable =
+        getTable<OperandRecord>(data, header.operandTableOffset);
+    const int32_t* constantTable =
+        getTable<int32_t>(data, header.constantTableOffset);
+    const uint8_t* intronTable =
+        (header.flags & FLAG_INTRON_MASK)
+            ? getTable<uint8_t>(data, header.intronTableOffset)
+            : nullptr;
+
+    // Programs
+    std::vector<std::shared_ptr<Program::Program>> programs;
+    programs.reserve(header.nbPrograms);
+    for (uint64_t p = 0; p < header.nbPrograms; p++) {
+        const ProgramRecord& record = programTable[p];
+        auto prog = std::make_shared<Program::Program>(env);
+        for (uint64_t l = 0; l < record.nbLines; l++) {
+            const uint64_t lineIdx = record.firstLine + l;
+            Program::Line& line = prog->addNewLine();
+            // Indexes were checked with the file.
+            line.setInstructionIndex(lineTable[lineIdx].instruction, false);
+            line.setDestinationIndex(lineTable[lineIdx].destination, false);
+            for (uint64_t op = 0; op < header.maxNbOperands; op++) {
+                const OperandRecord& operand =
+                    operandTable[lineIdx * header.maxNbOperands + op];
+                line.setOperand(op, operand.dataSource, operand.location,
+                                false);
+            }
+        }
+        for (uint64_t c = 0; c < header.nbConstants; c++) {
+            prog->getConstantHandler().setDataAt(
+                typeid(Data::Constant), c,
+                {constantTable[p * header.nbConstants + c]});
+        }
+        if (intronTable != nullptr) {
+            for (uint64_t l = 0; l < record.nbLines; l++) {
+                prog->setIntron(l, intronTable[record.firstLine + l] != 0);
+            }
+        }
+        else {
+            prog->identifyIntrons();
+        }
+        programs.push_back(prog);
+    }
+
+    // Vertices
+    std::vector<const TPG::TPGVertex*> vertices;
+    vertices.reserve(header.nbVertices);
+    for (uint64_t v = 0; v < header.nbVertices; v++) {
+        if (vertexTable[v].actionID == TEAM_VERTEX) {
+            vertices.push_back(&this->tpg.addNewTeam());
+        }
+        else {
+            vertices.push_back(
+                &this->tpg.addNewAction(vertexTable[v].actionID));
+        }
+    }
+
+    // Edges
+    for (uint64_t v = 0; v < header.nbVertices; v++) {
+        const VertexRecord& record = vertexTable[v];
+        for (uint64_t e = record.firstEdge;
+             e < record.firstEdge + record.nbEdges; e++) {
+            this->tpg.addNewEdge(*vertices.at(v),
+                                 *vertices.at(edgeTable[e].destination),
+                                 programs.at(edgeTable[e].program));
+        }
+    }
+}
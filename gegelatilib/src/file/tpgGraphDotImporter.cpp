@@ -34,290 +34,386 @@
  * knowledge of the CeCILL-C license and that you accept its terms.
  */
 
+#include <cstdio>
+#include <sstream>
+
 #include "file/tpgGraphDotImporter.h"
 
 const std::string File::TPGGraphDotImporter::lineSeparator("&#92;n");
-const std::string File::TPGGraphDotImporter::teamRegex(
-    "T([0-9]+)\\x20\\x5B.*\\x5D");
-const std::string File::TPGGraphDotImporter::programRegex(
-    "P([0-9]+)\\x20\\x5B.*\\x5D");
-const std::string File::TPGGraphDotImporter::instructionRegex(
-    "I([0-9]+)\\x20\\x5B.*label=\"(.*)\"\\x5D");
-const std::string File::TPGGraphDotImporter::actionRegex(
-    "A([0-9]+)\\x20\\x5B.*=\"([0-9]+)\"\\x5D");
-const std::string File::TPGGraphDotImporter::linkProgramInstructionRegex(
-    "P([0-9]+)\\x20->\\x20I([0-9]+).*");
-const std::string File::TPGGraphDotImporter::linkProgramActionRegex(
-    "T([0-9]+)\\x20->\\x20P([0-9]+)\\x20->\\x20A([0-9]+).*");
-const std::string File::TPGGraphDotImporter::linkProgramTeamRegex(
-    "T([0-9]+)\\x20->\\x20P([0-9]+)\\x20->\\x20T([0-9]+).*");
-const std::string File::TPGGraphDotImporter::addLinkProgramRegex(
-    "T([0-9]+)\\x20->\\x20P([0-9]+)");
-
-void File::TPGGraphDotImporter::readOperands(std::string& str, Program::Line& l)
+
+void File::TPGGraphDotImporter::throwParseError(
+    const std::string& message) const
+{
+    std::stringstream ss;
+    ss << "Error while importing dot file at line " << this->currentLine
+       << ", column " << this->currentColumn << ": " << message;
+    throw std::runtime_error(ss.str());
+}
+
+bool File::TPGGraphDotImporter::fillBuffer()
+{
+    this->pFile.read(this->buffer.data(), this->buffer.size());
+    this->bufferPos = 0;
+    this->bufferEnd = static_cast<size_t>(this->pFile.gcount());
+    return this->bufferEnd != 0;
+}
+
+int File::TPGGraphDotImporter::peekChar()
 {
-    std::string::size_type pos = 0;
-    std::string::size_type pos2;
-    std::string::size_type pos3;
-
-    uint64_t o_idx = 0;
-    uint64_t dataIndex = 0;
-    uint64_t location = 0;
-
-    // operands are stored in str with the following format :
-    // op1_param1|op1_param2#...|param_N
-
-    for (int i = 0; i < this->tpg.getEnvironment().getMaxNbOperands(); ++i) {
-        pos2 = str.find("|");
-        dataIndex = std::stoi(str.substr(pos, pos2));
-        pos2++; // skip the '|'
-        pos3 = str.find("#");
-        location = std::stoi(str.substr(pos2, pos3 - pos2));
-        str = str.substr(pos3 + 1,
-                         str.size() -
-                             pos3); // store the rest of the string and iterate
-
-        l.setOperand(o_idx, dataIndex, location, true);
-        o_idx++;
+    if (this->bufferPos == this->bufferEnd && !this->fillBuffer()) {
+        return EOF;
     }
+    return static_cast<unsigned char>(this->buffer[this->bufferPos]);
 }
 
-void File::TPGGraphDotImporter::readLine(std::smatch& matches)
+int File::TPGGraphDotImporter::readChar()
 {
-    // a line is stored in the .dot file with the following format
-    // inst_idx|dest_idx&op1_param1|op1_param2#...#opN_param1|opN_param2
-    if (!this->lastLine.empty() && !matches.empty()) {
-        uint64_t prog_label = std::stoi(matches[1]);
-        std::string label = matches[2];
-
-        auto p_it = programID.find(prog_label);
-        if (p_it != programID.end() && !label.empty()) {
-            std::shared_ptr<Program::Program> p = p_it->second;
-            // stores the whole program
-            std::string instruction;
-
-            // used to seek delimiters in the variable "instruction"
-            std::string::size_type pos;
-            std::string::size_type pos1;
-            std::string::size_type pos2;
-
-            // instruction index of a line
-            uint64_t instructionIdx;
-            // destination index of a line
-            uint64_t destinationIdx;
-            // store operands in a new string
-            std::string operands;
-
-            // as long as there are lines in the program, parse those lines
-            bool cont = true;
-            while (cont) {
-                Program::Line& l = p.get()->addNewLine();
-                pos = label.find(this->lineSeparator);
-                instruction = label.substr(0, pos);
-                label = label.substr(pos + this->lineSeparator.size(),
-                                     label.size());
-
-                // extract everything before pos (ie |)
-                // corresponds to instruction index
-                pos1 = instruction.find("|");
-                instructionIdx = std::stoi(instruction.substr(0, pos1));
-
-                // extract destination index;
-                pos2 = instruction.find("&");
-                pos1++; // skip the '|'
-                destinationIdx = std::stoi(instruction.substr(
-                    pos1, pos2 - pos1)); // extract and convert to int
-
-                // extract operands as a string
-                pos2++; // skip the '$'
-                operands = instruction.substr(pos2, instruction.size());
-
-                // add indexes to line
-                l.setInstructionIndex(instructionIdx);
-                l.setDestinationIndex(destinationIdx);
-
-                // parse operands
-                readOperands(operands, l);
-
-                if (label.size() <= 3) {
-                    cont = false;
-                }
-            }
-            p->identifyIntrons();
+    int c = this->peekChar();
+    if (c != EOF) {
+        this->bufferPos++;
+        if (c == '\n') {
+            this->currentLine++;
+            this->currentColumn = 1;
+        }
+        else {
+            this->currentColumn++;
         }
     }
+    return c;
 }
 
-void File::TPGGraphDotImporter::readProgram(std::smatch& matches)
+void File::TPGGraphDotImporter::expect(const char* str)
 {
-    if (!this->lastLine.empty() && !matches.empty()) {
-        // Program definition :
-        // P0 [fillcolor="#cccccc" shape=point] //const0|const1|...|constn|
-        std::string::size_type pos;
-        std::string::size_type pos1;
-        // read constants
-        std::vector<Data::Constant> v_constant;
-        pos = this->lastLine.find("//") + 2;
-        pos1 = this->lastLine.find("|", pos);
-        for (;;) {
-            if (pos1 != std::string::npos) {
-                v_constant.push_back(
-                    {std::stoi(this->lastLine.substr(pos, pos1 - pos))});
+    for (const char* c = str; *c != '\0'; c++) {
+        if (this->peekChar() != static_cast<unsigned char>(*c)) {
+            this->throwParseError("expected \"" + std::string(str) + "\".");
+        }
+        this->readChar();
+    }
+}
+
+void File::TPGGraphDotImporter::skipBlanks()
+{
+    int c = this->peekChar();
+    while (c == ' ' || c == '\t' || c == '\r') {
+        this->readChar();
+        c = this->peekChar();
+    }
+}
+
+void File::TPGGraphDotImporter::skipLine()
+{
+    int c;
+    do {
+        c = this->readChar();
+    } while (c != '\n' && c != EOF);
+}
+
+uint64_t File::TPGGraphDotImporter::readUnsignedInteger()
+{
+    int c = this->peekChar();
+    if (c < '0' || c > '9') {
+        this->throwParseError("expected a number.");
+    }
+    uint64_t value = 0;
+    while (c >= '0' && c <= '9') {
+        value = value * 10 + (c - '0');
+        this->readChar();
+        c = this->peekChar();
+    }
+    return value;
+}
+
+int64_t File::TPGGraphDotImporter::readSignedInteger()
+{
+    bool negative = false;
+    if (this->peekChar() == '-') {
+        this->readChar();
+        negative = true;
+    }
+    int64_t value = static_cast<int64_t>(this->readUnsignedInteger());
+    return (negative) ? -value : value;
+}
+
+bool File::TPGGraphDotImporter::skipAttributes(const char* key)
+{
+    // Attributes have the format: name=value or name="value", and are
+    // separated with blanks. Names are compared with key while being read.
+    for (;;) {
+        this->skipBlanks();
+        int c = this->peekChar();
+        if (c == ']') {
+            this->readChar();
+            return false;
+        }
+        if (c == '\n' || c == EOF) {
+            this->throwParseError("unterminated attribute list.");
+        }
+
+        // Read the attribute name
+        const char* k = key;
+        bool match = (key != nullptr);
+        while (c != '=' && c != ' ' && c != '\t' && c != ']' && c != '\n' &&
+               c != EOF) {
+            match = match && (*k == c);
+            k += (match) ? 1 : 0;
+            this->readChar();
+            c = this->peekChar();
+        }
+        match = match && (*k == '\0');
+
+        this->skipBlanks();
+        if (this->peekChar() != '=') {
+            // Attribute without value
+            continue;
+        }
+        this->readChar();
+        this->skipBlanks();
+
+        // Read the value
+        if (this->peekChar() == '"') {
+            this->readChar();
+            if (match) {
+                return true;
             }
-            else {
-                break;
+            c = this->readChar();
+            while (c != '"') {
+                if (c == '\n' || c == EOF) {
+                    this->throwParseError("unterminated string.");
+                }
+                if (c == '\\') {
+                    this->readChar();
+                }
+                c = this->readChar();
             }
-            pos = pos1 + 1;
-            pos1 = this->lastLine.find("|", pos);
         }
-        // create new program with the correct amount of constants
-        Program::Program* p = new Program::Program(this->tpg.getEnvironment());
-        // set the previously read constants
-        for (int i = 0; i < v_constant.size(); i++) {
-            p->getConstantHandler().setDataAt(typeid(Data::Constant), i,
-                                              v_constant.at(i));
+        else {
+            c = this->peekChar();
+            while (c != ' ' && c != '\t' && c != ']' && c != '\n' &&
+                   c != EOF) {
+                this->readChar();
+                c = this->peekChar();
+            }
         }
-        this->programID.insert(
-            std::pair<uint64_t, std::shared_ptr<Program::Program>>(
-                std::stoi(matches[1]), p));
     }
 }
 
-void File::TPGGraphDotImporter::dumpTPGGraphHeader()
+void File::TPGGraphDotImporter::readOperands(Program::Line& l)
 {
+    // operands are stored with the following format :
+    // op1_param1|op1_param2#...#opN_param1|opN_param2
+    for (uint64_t i = 0; i < this->tpg.getEnvironment().getMaxNbOperands();
+         ++i) {
+        if (i != 0) {
+            this->expect("#");
+        }
+        uint64_t dataIndex = this->readUnsignedInteger();
+        this->expect("|");
+        uint64_t location = this->readUnsignedInteger();
 
-    char buffer[MAX_READ_SIZE];
+        l.setOperand(i, dataIndex, location, true);
+    }
+}
 
-    // skips the comment lines of header (if any)
-    do {
-        pFile.getline(buffer, MAX_READ_SIZE);
-    } while (buffer[0] == '/');
+void File::TPGGraphDotImporter::readLines(uint64_t progID)
+{
+    // Instruction definition:
+    // I0 [shape=box style=invis label="line0&#92;nline1&#92;n"]
+    this->skipBlanks();
+    this->expect("[");
+    if (!this->skipAttributes("label")) {
+        return;
+    }
 
-    // Skip the header (should be 3 lines, including one covered by previous
-    // while loop)
-    for (int i = 0; i < 2; i++) {
-        pFile.getline(buffer, MAX_READ_SIZE);
+    auto p_it = programID.find(progID);
+    if (p_it == programID.end()) {
+        this->throwParseError("instructions of undeclared program P" +
+                              std::to_string(progID) + ".");
     }
+    Program::Program& p = *p_it->second;
+
+    // a line is stored in the .dot file with the following format
+    // inst_idx|dest_idx&op1_param1|op1_param2#...#opN_param1|opN_param2
+    while (this->peekChar() != '"') {
+        Program::Line& l = p.addNewLine();
+        uint64_t instructionIdx = this->readUnsignedInteger();
+        this->expect("|");
+        uint64_t destinationIdx = this->readUnsignedInteger();
+        this->expect("&");
+
+        // add indexes to line
+        l.setInstructionIndex(instructionIdx);
+        l.setDestinationIndex(destinationIdx);
+
+        // parse operands
+        readOperands(l);
+
+        this->expect(lineSeparator.c_str());
+    }
+    this->readChar();
+
+    if (p.getNbLines() > 0) {
+        p.identifyIntrons();
+    }
+    this->skipAttributes();
 }
 
-void File::TPGGraphDotImporter::readTeam(std::smatch& matches)
+void File::TPGGraphDotImporter::readProgram(uint64_t progID)
 {
-    if (!this->lastLine.empty() && !matches.empty()) {
-        this->vertexID.insert(std::pair<uint64_t, const TPG::TPGVertex*>(
-            std::stoi(matches[1]), &this->tpg.addNewTeam()));
+    // Program definition :
+    // P0 [fillcolor="#cccccc" shape=point] //const0|const1|...|constn|
+    this->skipBlanks();
+    this->expect("[");
+    this->skipAttributes();
+    this->skipBlanks();
+    this->expect("//");
+
+    // create new program with the correct amount of constants
+    std::shared_ptr<Program::Program> p =
+        std::make_shared<Program::Program>(this->tpg.getEnvironment());
+
+    // read constants
+    size_t i = 0;
+    int c = this->peekChar();
+    while (c != '\n' && c != '\r' && c != EOF) {
+        Data::Constant constant{
+            static_cast<int32_t>(this->readSignedInteger())};
+        this->expect("|");
+        p->getConstantHandler().setDataAt(typeid(Data::Constant), i++,
+                                          constant);
+        c = this->peekChar();
+    }
+
+    if (!this->programID.emplace(progID, p).second) {
+        this->throwParseError("program P" + std::to_string(progID) +
+                              " is declared twice.");
     }
 }
 
-void File::TPGGraphDotImporter::readAction(std::smatch& matches)
+void File::TPGGraphDotImporter::dumpTPGGraphHeader()
 {
-    if (!this->lastLine.empty() && !matches.empty()) {
-        // the regex matches two groups (action number and action label)
-        uint64_t action_label = std::stoi(matches[2]);
-        uint64_t action_number = std::stoi(matches[1]);
-
-        // elmt points to the action with the same label as the action we are
-        // parsing
-        auto elmt = actionID.find(action_label);
-        if (elmt == actionID.end()) {
-            // create a new action and insert it if none was previously found
-            this->actionID.insert(std::pair<uint64_t, const TPG::TPGVertex*>(
-                action_label, &this->tpg.addNewAction(action_label)));
-        }
-        this->actionLabel.insert(
-            std::pair<uint64_t, uint64_t>(action_number, action_label));
+    // skips the comment lines of header (if any)
+    while (this->peekChar() == '/') {
+        this->skipLine();
+    }
+
+    // Skip the header (should be 3 lines, including the one following the
+    // comments)
+    for (int i = 0; i < 3; i++) {
+        this->skipLine();
     }
 }
 
-void File::TPGGraphDotImporter::readLinkTeamProgramAction(std::smatch& matches)
+void File::TPGGraphDotImporter::readTeam(uint64_t teamID)
 {
-    // Creating a edge from a team to an action
-    if (!this->lastLine.empty() && !matches.empty()) {
-        uint64_t team_in = std::stoi(matches[1]);
-        uint64_t program = std::stoi(matches[2]);
-        uint64_t act_out = std::stoi(matches[3]);
-
-        // get the action depending on its label
-        auto action_lab = this->actionLabel.find(act_out);
-        if (action_lab != this->actionLabel.end()) {
-            auto team_it = this->vertexID.find(team_in);
-            auto action_it = this->actionID.find(action_lab->second);
-            // find the program to add to the edge
-            auto p_it = programID.find(program);
-            if (team_it != vertexID.end() &&
-                action_it != this->actionID.end() && p_it != programID.end()) {
-                const TPG::TPGVertex* team = team_it->second;
-                const TPG::TPGVertex* action = action_it->second;
-                std::shared_ptr<Program::Program> p = p_it->second;
-                this->tpg.addNewEdge(*team, *action, p);
-            }
-        }
+    // Team definition:
+    // T0 [fillcolor="#1199bb"]
+    this->skipAttributes();
+    this->vertexID.emplace(teamID, &this->tpg.addNewTeam());
+}
+
+void File::TPGGraphDotImporter::readAction(uint64_t actionNumber)
+{
+    // Action definition (the label is the action ID):
+    // A0 [fillcolor="#ff3366" shape=box margin=0.03 width=0 height=0 label="0"]
+    this->skipBlanks();
+    this->expect("[");
+    if (!this->skipAttributes("label")) {
+        this->throwParseError("missing label of action A" +
+                              std::to_string(actionNumber) + ".");
     }
+    uint64_t action_label = this->readUnsignedInteger();
+    this->expect("\"");
+    this->skipAttributes();
+
+    // create a new action only if none was previously created with the same
+    // label.
+    if (this->actionID.find(action_label) == this->actionID.end()) {
+        this->actionID.emplace(action_label,
+                               &this->tpg.addNewAction(action_label));
+    }
+    this->actionLabel.emplace(actionNumber, action_label);
 }
 
-void File::TPGGraphDotImporter::readLinkTeamProgramTeam(std::smatch& matches)
+void File::TPGGraphDotImporter::addEdge(const TPG::TPGVertex& src,
+                                        const TPG::TPGVertex& dest,
+                                        uint64_t progID)
 {
-    // creating a edge between two teams
-    if (!this->lastLine.empty() && !matches.empty()) {
-        uint64_t team_in = std::stoi(matches[1]);
-        uint64_t program = std::stoi(matches[2]);
-        uint64_t team_out = std::stoi(matches[3]);
-
-        // get the source and destination teams
-        auto t1_it = this->vertexID.find(team_in);
-        auto t2_it = this->vertexID.find(team_out);
-
-        // find the program
-        auto p_it = programID.find(program);
-        if (p_it != programID.end()) {
-            std::shared_ptr<Program::Program> p = p_it->second;
-            if (t1_it != this->vertexID.end() &&
-                t2_it != this->vertexID.end()) {
-                const TPG::TPGVertex* team_i = t1_it->second;
-                const TPG::TPGVertex* team_o = t2_it->second;
-                this->tpg.addNewEdge(*team_i, *team_o, p);
-            }
-        }
+    auto p_it = this->programID.find(progID);
+    if (p_it == this->programID.end()) {
+        this->throwParseError("link through undeclared program P" +
+                              std::to_string(progID) + ".");
     }
+    this->tpg.addNewEdge(src, dest, p_it->second);
+    this->programDestination.emplace(progID, &dest);
 }
 
-void File::TPGGraphDotImporter::readLinkTeamProgram(std::smatch& matches)
+void File::TPGGraphDotImporter::readLink(uint64_t teamID)
 {
-    if (!this->lastLine.empty() && !matches.empty()) {
-        uint64_t team_in = std::stoi(matches[1]);
-        uint64_t program = std::stoi(matches[2]);
-
-        // find edge
-        const std::list<std::unique_ptr<TPG::TPGEdge>>& edges =
-            this->tpg.getEdges();
-
-        // find one of the selected program edges :
-        auto p_it = programID.find(program);
-        if (p_it != programID.end()) {
-            std::shared_ptr<Program::Program> p = p_it->second;
-
-            auto edge_it =
-                std::find_if(edges.begin(), edges.end(),
-                             [p](const std::unique_ptr<TPG::TPGEdge>& other) {
-                                 return (&(other->getProgram()) == p.get());
-                             });
-            if (edge_it != edges.end()) // we got the corresponding edge :
-            {
-                // then get the team :
-                auto team_it = this->vertexID.find(team_in);
-                if (team_it != this->vertexID.end()) {
-                    const TPG::TPGVertex* team = team_it->second;
-                    this->tpg.addNewEdge(
-                        *team, *(edge_it->get()->getDestination()), p);
-                }
-            }
+    // Link definitions:
+    // T0 -> P0 -> A0
+    // T0 -> P1 -> T1
+    // T1 -> P0
+    auto team_it = this->vertexID.find(teamID);
+    if (team_it == this->vertexID.end()) {
+        this->throwParseError("link from undeclared team T" +
+                              std::to_string(teamID) + ".");
+    }
+    const TPG::TPGVertex& team = *team_it->second;
+
+    this->expect("->");
+    this->skipBlanks();
+    this->expect("P");
+    uint64_t progID = this->readUnsignedInteger();
+    this->skipBlanks();
+
+    if (this->peekChar() != '-') {
+        // Team -> Program link, with a program already linked to its
+        // destination
+        auto dest_it = this->programDestination.find(progID);
+        if (dest_it == this->programDestination.end()) {
+            this->throwParseError("program P" + std::to_string(progID) +
+                                  " has no known destination.");
         }
+        this->addEdge(team, *dest_it->second, progID);
+        return;
+    }
+
+    this->expect("->");
+    this->skipBlanks();
+    int destType = this->readChar();
+    if (destType == 'A') {
+        uint64_t actionNumber = this->readUnsignedInteger();
+        auto action_lab = this->actionLabel.find(actionNumber);
+        if (action_lab == this->actionLabel.end()) {
+            this->throwParseError("link to undeclared action A" +
+                                  std::to_string(actionNumber) + ".");
+        }
+        this->addEdge(team, *this->actionID.at(action_lab->second), progID);
+    }
+    else if (destType == 'T') {
+        uint64_t destID = this->readUnsignedInteger();
+        auto dest_it = this->vertexID.find(destID);
+        if (dest_it == this->vertexID.end()) {
+            this->throwParseError("link to undeclared team T" +
+                                  std::to_string(destID) + ".");
+        }
+        this->addEdge(team, *dest_it->second, progID);
+    }
+    else {
+        this->throwParseError("expected an action or a team.");
     }
 }
 
 void File::TPGGraphDotImporter::importGraph()
 {
     // force seek at the beginning of file.
+    pFile.clear();
     pFile.seekg(0);
+    this->bufferPos = 0;
+    this->bufferEnd = 0;
+    this->currentLine = 1;
+    this->currentColumn = 1;
 
     // clear every storing objects
     this->tpg.clear();
@@ -325,6 +421,7 @@ void File::TPGGraphDotImporter::importGraph()
     this->actionID.clear();
     this->actionLabel.clear();
     this->programID.clear();
+    this->programDestination.clear();
 
     // skip header
     this->dumpTPGGraphHeader();
@@ -336,57 +433,55 @@ void File::TPGGraphDotImporter::importGraph()
 
 bool File::TPGGraphDotImporter::readLineFromFile()
 {
-    char buffer[MAX_READ_SIZE];
-
-    std::regex testActionDeclare(this->actionRegex);
-    std::regex testTeamDeclare(this->teamRegex);
-    std::regex testProgramDeclare(this->programRegex);
-    std::regex testInstructionDeclare(this->instructionRegex);
-    std::regex testLinkPI(this->linkProgramInstructionRegex);
-    std::regex testLinkTPA(this->linkProgramActionRegex);
-    std::regex testLinkTPT(this->linkProgramTeamRegex);
-    std::regex testLinkTP(this->addLinkProgramRegex);
-
-    std::smatch matches;
-
-    if (!pFile.getline(buffer, MAX_READ_SIZE))
-        throw std::ifstream::failure("Couldn't read in the given file");
-    else {
-        this->lastLine = buffer;
+    this->skipBlanks();
+
+    int c = this->peekChar();
+    if (c == EOF) {
+        std::stringstream ss;
+        ss << "Unexpected end of dot file at line " << this->currentLine
+           << ".";
+        throw std::ifstream::failure(ss.str());
     }
 
-    // check the line shape and parse it
-    if (std::regex_search(this->lastLine, matches, testTeamDeclare)) {
-        readTeam(matches);
-    }
-    else if (std::regex_search(this->lastLine, matches, testActionDeclare)) {
-        readAction(matches);
-    }
-    else if (std::regex_search(this->lastLine, matches, testProgramDeclare)) {
-        readProgram(matches);
-    }
-    else if (std::regex_search(this->lastLine, matches,
-                               testInstructionDeclare)) {
-        readLine(matches);
-    }
-    else if (std::regex_search(this->lastLine, matches, testLinkPI)) {
-        // by definition, a program is linked to its instruction from its
-        // declaration. the link is used vor visualisation but doesn't require
-        // to be parsed
-        return true;
-    }
-    else if (std::regex_search(this->lastLine, matches, testLinkTPA)) {
-        readLinkTeamProgramAction(matches);
-    }
-    else if (std::regex_search(this->lastLine, matches, testLinkTPT)) {
-        readLinkTeamProgramTeam(matches);
-    }
-    else if (std::regex_search(this->lastLine, matches, testLinkTP)) {
-        readLinkTeamProgram(matches);
-    }
-    else {
+    // Only statements starting with a vertex name are part of the graph
+    // description, the first other statement ends the import.
+    if (c != 'T' && c != 'A' && c != 'P' && c != 'I') {
         return false;
     }
+    this->readChar();
+    uint64_t id = this->readUnsignedInteger();
+    this->skipBlanks();
+
+    switch (c) {
+    case 'T':
+        if (this->peekChar() == '[') {
+            this->readChar();
+            readTeam(id);
+        }
+        else {
+            readLink(id);
+        }
+        break;
+    case 'A':
+        readAction(id);
+        break;
+    case 'P':
+        if (this->peekChar() == '-') {
+            // by definition, a program is linked to its instruction from its
+            // declaration. the link is used for visualisation but doesn't
+            // require to be parsed
+            this->expect("->");
+        }
+        else {
+            readProgram(id);
+        }
+        break;
+    case 'I':
+        readLines(id);
+        break;
+    }
+
+    this->skipLine();
     return true;
 }
 
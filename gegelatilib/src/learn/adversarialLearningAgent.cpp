@@ -39,17 +39,15 @@
 
 #include "learn/adversarialLearningAgent.h"
 
-std::multimap<std::shared_ptr<Learn::EvaluationResult>, const TPG::TPGVertex*>
-Learn::AdversarialLearningAgent::evaluateAllRoots(uint64_t generationNumber,
-                                                  Learn::LearningMode mode)
+Learn::ResultsTable Learn::AdversarialLearningAgent::evaluateAllRoots(
+    uint64_t generationNumber, Learn::LearningMode mode)
 {
     // exception if LE is not cloneable and if there are several threads to use
     if (!this->learningEnvironment.isCopyable() && this->maxNbThreads > 1) {
         throw std::runtime_error(
             "Max number of threads for a non copyable environment is 1.");
     }
-    std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>
-        results;
+    ResultsTable results;
     evaluateAllRootsInParallel(generationNumber, mode, results);
     return results;
 }
@@ -57,9 +55,7 @@ Learn::AdversarialLearningAgent::evaluateAllRoots(uint64_t generationNumber,
 void Learn::AdversarialLearningAgent::evaluateAllRootsInParallelCompileResults(
     std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>,
                                  std::shared_ptr<Job>>>& resultsPerJobMap,
-    std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>&
-        results,
-    std::map<uint64_t, Archive*>& archiveMap)
+    ResultsTable& results, std::map<uint64_t, Archive*>& archiveMap)
 {
     // Create temporary map to gather results per root
     std::map<const TPG::TPGVertex*, std::shared_ptr<EvaluationResult>>
@@ -101,22 +97,22 @@ void Learn::AdversarialLearningAgent::evaluateAllRootsInParallelCompileResults(
         }
     }
 
-    // Swaps the results for the final map
+    // Fill the final results table
     // It is important to iterate on tpg.getRootVertices : it ensures
     // the order of the roots iteration remains the same no matter
     // the order of resultsPerRootMap which depends on addresses.
-    for (auto root : tpg->getRootVertices()) {
+    auto roots = tpg->getRootVertices();
+    results.reserve(roots.size());
+    for (auto root : roots) {
         auto& resultPerRoot = *resultsPerRootMap.find(root);
-        results.emplace(resultPerRoot.second, resultPerRoot.first);
+        results.addRow(resultPerRoot.first, resultPerRoot.second);
     }
 
     champions.clear();
-    auto iterator = results.end();
-    for (int i = 0; i <= (1.0 - params.ratioDeletedRoots) *
-                                 (double)tpg->getNbRootVertices() -
-                             1.0;
-         i++) {
-        champions.emplace_back((--iterator)->second);
+    size_t nbChampions = (size_t)floor((1.0 - params.ratioDeletedRoots) *
+                                       (double)tpg->getNbRootVertices());
+    for (size_t row : results.getBestRows(nbChampions)) {
+        champions.emplace_back(results.getRoot(row));
     }
     // Merge the archives
     this->mergeArchiveMap(archiveMap);
@@ -260,3 +256,13 @@ std::shared_ptr<Learn::Job> Learn::AdversarialLearningAgent::makeJob(
     throw std::runtime_error(
         "Method not supported in AdversarialLearningAgent.");
 }
+
+bool Learn::AdversarialLearningAgent::canPipelineValidation() const
+{
+    return false;
+}
+
+bool Learn::AdversarialLearningAgent::canInterleaveEpisodes() const
+{
+    return false;
+}
@@ -47,6 +47,26 @@ void Learn::ClassificationLearningEnvironment::doAction(uint64_t actionID)
     this->classificationTable.at(this->currentClass).at(actionID)++;
 }
 
+uint64_t Learn::ClassificationLearningEnvironment::getObservationLabel() const
+{
+    return this->currentClass;
+}
+
+void Learn::ClassificationLearningEnvironment::resetReplay(
+    size_t seed, LearningMode mode, uint16_t iterationNumber,
+    uint64_t generationNumber)
+{
+    ClassificationLearningEnvironment::reset(seed, mode, iterationNumber,
+                                             generationNumber);
+}
+
+void Learn::ClassificationLearningEnvironment::replayAction(uint64_t label,
+                                                            uint64_t actionID)
+{
+    this->currentClass = label;
+    ClassificationLearningEnvironment::doAction(actionID);
+}
+
 const std::vector<std::vector<uint64_t>>& Learn::
     ClassificationLearningEnvironment::getClassificationTable() const
 {
@@ -46,6 +46,16 @@ size_t Learn::EvaluationResult::getNbEvaluation() const
     return this->nbEvaluation;
 }
 
+double Learn::EvaluationResult::getInferenceCost() const
+{
+    return this->inferenceCost;
+}
+
+void Learn::EvaluationResult::setInferenceCost(double cost)
+{
+    this->inferenceCost = cost;
+}
+
 Learn::EvaluationResult& Learn::EvaluationResult::operator+=(
     const Learn::EvaluationResult& other)
 {
@@ -56,6 +66,17 @@ Learn::EvaluationResult& Learn::EvaluationResult::operator+=(
         throw std::runtime_error("Type mismatch between EvaluationResults.");
     }
 
+    // Weighted addition of inference costs, for all types, before the
+    // nbEvaluation are updated.
+    double totalNbEvaluation =
+        (double)this->nbEvaluation + (double)other.nbEvaluation;
+    if (totalNbEvaluation > 0.0) {
+        this->inferenceCost =
+            (this->inferenceCost * (double)this->nbEvaluation +
+             other.inferenceCost * (double)other.nbEvaluation) /
+            totalNbEvaluation;
+    }
+
     // If the added type is Learn::EvaluationResult
     if (thisType == typeid(Learn::EvaluationResult)) {
         // Weighted addition of results
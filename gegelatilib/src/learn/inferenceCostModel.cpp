@@ -0,0 +1,105 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <algorithm>
+
+#include "tpg/tpgEdge.h"
+
+#include "learn/inferenceCostModel.h"
+
+Learn::InferenceCostModel::InferenceCostModel(
+    double teamCost, const std::vector<double>& instructionCosts)
+    : teamCost{teamCost}, instructionCosts(instructionCosts)
+{
+}
+
+double Learn::InferenceCostModel::getInstructionCost(
+    uint64_t instructionIndex) const
+{
+    return (instructionIndex < this->instructionCosts.size())
+               ? this->instructionCosts[instructionIndex]
+               : 1.0;
+}
+
+double Learn::InferenceCostModel::getProgramCost(
+    const Program::Program& program) const
+{
+    double cost = 0.0;
+    for (uint64_t i = 0; i < program.getNbLines(); i++) {
+        if (!program.isIntron(i)) {
+            cost += this->getInstructionCost(
+                program.getLine(i).getInstructionIndex());
+        }
+    }
+    return cost;
+}
+
+double Learn::InferenceCostModel::getTraceCost(
+    const std::vector<const TPG::TPGVertex*>& trace) const
+{
+    ProgramCostCache programCosts;
+    return this->getTraceCost(trace, programCosts);
+}
+
+double Learn::InferenceCostModel::getTraceCost(
+    const std::vector<const TPG::TPGVertex*>& trace,
+    ProgramCostCache& programCosts) const
+{
+    if (trace.empty()) {
+        return 0.0;
+    }
+
+    // The action at the end of the trace is not evaluated.
+    double cost = 0.0;
+    for (auto it = trace.begin(); it != trace.end() - 1; it++) {
+        cost += this->teamCost;
+        for (const TPG::TPGEdge* edge : (*it)->getOutgoingEdges()) {
+            // Edges leading to a previously visited team (including the
+            // current team) are not evaluated
+            auto endSearchIt = it + 1;
+            if (std::find(trace.begin(), endSearchIt,
+                          edge->getDestination()) != endSearchIt) {
+                continue;
+            }
+            const Program::Program* program = &edge->getProgram();
+            auto costIt = programCosts.find(program);
+            if (costIt == programCosts.end()) {
+                costIt = programCosts
+                             .emplace(program, this->getProgramCost(*program))
+                             .first;
+            }
+            cost += costIt->second;
+        }
+    }
+    return cost;
+}
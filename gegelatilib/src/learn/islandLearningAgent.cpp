@@ -0,0 +1,211 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#include "tpg/tpgGraph.h"
+#include "tpg/tpgTeam.h"
+
+#include "learn/islandLearningAgent.h"
+
+Learn::IslandLearningAgent::IslandLearningAgent(
+    LearningEnvironment& le, const Instructions::Set& iSet,
+    const LearningParameters& p, const TPG::TPGFactory& factory)
+    : learningEnvironment{le}, params{p}, maxNbThreads{1}
+{
+    if (p.nbIslands == 0) {
+        throw std::runtime_error(
+            "An IslandLearningAgent needs at least one island.");
+    }
+
+    // Islands are trained sequentially by a single thread each.
+    LearningParameters islandParams = p;
+    islandParams.nbThreads = 1;
+
+    bool copyable = le.isCopyable();
+    if (copyable) {
+        this->maxNbThreads =
+            std::max<uint64_t>(1, std::min<uint64_t>(p.nbThreads, p.nbIslands));
+    }
+
+    for (size_t i = 0; i < p.nbIslands; i++) {
+        LearningEnvironment* islandLE = &le;
+        if (i > 0 && copyable) {
+            this->islandEnvironments.emplace_back(le.clone());
+            islandLE = this->islandEnvironments.back().get();
+        }
+        this->islands.emplace_back(
+            new LearningAgent(*islandLE, iSet, islandParams, factory));
+    }
+}
+
+size_t Learn::IslandLearningAgent::getNbIslands() const
+{
+    return this->islands.size();
+}
+
+Learn::LearningAgent& Learn::IslandLearningAgent::getIsland(size_t idx)
+{
+    return *this->islands.at(idx);
+}
+
+void Learn::IslandLearningAgent::init(uint64_t seed)
+{
+    for (size_t i = 0; i < this->islands.size(); i++) {
+        this->islands.at(i)->init(seed + i);
+    }
+}
+
+void Learn::IslandLearningAgent::trainOneGeneration(uint64_t generationNumber)
+{
+    std::atomic<size_t> nextIsland{0};
+    std::vector<std::exception_ptr> errors(this->islands.size());
+
+    auto trainIslands = [&]() {
+        size_t idx;
+        while ((idx = nextIsland++) < this->islands.size()) {
+            try {
+                this->islands.at(idx)->trainOneGeneration(generationNumber);
+            }
+            catch (...) {
+                errors.at(idx) = std::current_exception();
+            }
+        }
+    };
+
+    // The calling thread also trains islands.
+    std::vector<std::thread> threads;
+    for (uint64_t i = 1; i < this->maxNbThreads; i++) {
+        threads.emplace_back(trainIslands);
+    }
+    trainIslands();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    if (this->params.migrationInterval > 0 &&
+        (generationNumber + 1) % this->params.migrationInterval == 0) {
+        this->migrate();
+    }
+}
+
+uint64_t Learn::IslandLearningAgent::train(volatile bool& altTraining)
+{
+    uint64_t generationNumber = 0;
+    while (!altTraining && generationNumber < this->params.nbGenerations) {
+        this->trainOneGeneration(generationNumber);
+        generationNumber++;
+    }
+    for (auto& island : this->islands) {
+        island->waitForValidation();
+    }
+    return generationNumber;
+}
+
+void Learn::IslandLearningAgent::migrate()
+{
+    const size_t nbIslands = this->islands.size();
+    if (nbIslands < 2 || this->params.nbMigrants == 0) {
+        return;
+    }
+
+    // Select all migrants before importing any of them, so that a migrant
+    // never travels more than one island per migration.
+    std::vector<std::vector<const TPG::TPGVertex*>> migrants(nbIslands);
+    for (size_t i = 0; i < nbIslands; i++) {
+        const auto& results = this->islands.at(i)->getResultsPerRoot();
+        std::vector<std::pair<double, const TPG::TPGVertex*>> candidates;
+        for (const TPG::TPGVertex* root :
+             this->islands.at(i)->getTPGGraph()->getRootVertices()) {
+            auto result = results.find(root);
+            if (dynamic_cast<const TPG::TPGTeam*>(root) != nullptr &&
+                result != results.end()) {
+                candidates.emplace_back(result->second->getResult(), root);
+            }
+        }
+
+        // Stable sort keeps the graph order between roots with equal
+        // results, for determinism.
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const auto& a, const auto& b) {
+                             return a.first > b.first;
+                         });
+        size_t nbMigrants =
+            std::min<size_t>(this->params.nbMigrants, candidates.size());
+        for (size_t m = 0; m < nbMigrants; m++) {
+            migrants.at(i).push_back(candidates.at(m).second);
+        }
+    }
+
+    for (size_t i = 0; i < nbIslands; i++) {
+        TPG::TPGGraph& destination =
+            *this->islands.at((i + 1) % nbIslands)->getTPGGraph();
+        for (const TPG::TPGVertex* migrant : migrants.at(i)) {
+            destination.importSubGraph(*migrant);
+        }
+    }
+}
+
+size_t Learn::IslandLearningAgent::getBestIsland() const
+{
+    size_t bestIsland = 0;
+    double bestScore = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < this->islands.size(); i++) {
+        const auto& bestRoot = this->islands.at(i)->getBestRoot();
+        if (bestRoot.second != nullptr &&
+            bestRoot.second->getResult() > bestScore) {
+            bestScore = bestRoot.second->getResult();
+            bestIsland = i;
+        }
+    }
+    return bestIsland;
+}
+
+const std::pair<const TPG::TPGVertex*,
+                std::shared_ptr<Learn::EvaluationResult>>&
+Learn::IslandLearningAgent::getBestRoot() const
+{
+    return this->islands.at(this->getBestIsland())->getBestRoot();
+}
@@ -50,3 +50,28 @@ const TPG::TPGVertex* Learn::Job::getRoot() const
 {
     return root;
 }
+
+const TPG::TPGVertex* Learn::Job::getExecutedRoot() const
+{
+    return (executedRoot != nullptr) ? executedRoot : this->getRoot();
+}
+
+void Learn::Job::setExecutedRoot(const TPG::TPGVertex* vertex)
+{
+    executedRoot = vertex;
+}
+
+uint64_t Learn::Job::getFirstIteration() const
+{
+    return firstIteration;
+}
+
+uint64_t Learn::Job::getNbIterations() const
+{
+    return nbIterations;
+}
+
+bool Learn::Job::isPartial() const
+{
+    return nbIterations != 0;
+}
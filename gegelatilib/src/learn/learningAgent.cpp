@@ -38,15 +38,22 @@
 
 #include <inttypes.h>
 #include <queue>
+#include <unordered_map>
 
 #include "data/hash.h"
 #include "learn/evaluationResult.h"
 #include "mutator/rng.h"
 #include "mutator/tpgMutator.h"
 #include "tpg/tpgExecutionEngine.h"
+#include "util/profiler.h"
 
 #include "learn/learningAgent.h"
 
+Learn::LearningAgent::~LearningAgent()
+{
+    this->joinValidation();
+}
+
 std::shared_ptr<TPG::TPGGraph> Learn::LearningAgent::getTPGGraph()
 {
     return this->tpg;
@@ -57,11 +64,24 @@ const Archive& Learn::LearningAgent::getArchive() const
     return this->archive;
 }
 
+const std::chrono::time_point<std::chrono::system_clock,
+                              std::chrono::nanoseconds>&
+Learn::LearningAgent::getValidationEnd() const
+{
+    return this->validationEnd;
+}
+
 const Environment& Learn::LearningAgent::getEnvironment() const
 {
     return this->env;
 }
 
+const Learn::ObservationCache& Learn::LearningAgent::getObservationCache()
+    const
+{
+    return this->observationCache;
+}
+
 Mutator::RNG& Learn::LearningAgent::getRNG()
 {
     return this->rng;
@@ -97,6 +117,7 @@ bool Learn::LearningAgent::isRootEvalSkipped(
 {
     // Has the root already been evaluated more times than
     // params.maxNbEvaluationPerPolicy
+    std::lock_guard<std::mutex> lock(this->resultsPerRootMutex);
     const auto& iter = this->resultsPerRoot.find(&root);
     if (iter != this->resultsPerRoot.end()) {
         // The root has already been evaluated
@@ -118,63 +139,131 @@ std::shared_ptr<Learn::EvaluationResult> Learn::LearningAgent::evaluateJob(
     const TPG::TPGVertex* root = job.getRoot();
 
     // Skip the root evaluation process if enough evaluations were already
-    // performed. In the evaluation mode only.
+    // performed. In the evaluation mode only. Partial jobs are never skipped
+    // nor combined with previous results.
     std::shared_ptr<Learn::EvaluationResult> previousEval;
-    if (mode == LearningMode::TRAINING &&
+    if (mode == LearningMode::TRAINING && !job.isPartial() &&
         this->isRootEvalSkipped(*root, previousEval)) {
         return previousEval;
     }
 
     // Init results
     double result = 0.0;
+    double inferenceCost = 0.0;
+    InferenceCostModel::ProgramCostCache programCosts;
+    uint64_t firstIteration = job.getFirstIteration();
+    uint64_t nbIterations = (job.isPartial())
+                                ? job.getNbIterations()
+                                : this->params.nbIterationsPerPolicyEvaluation;
 
     // Evaluate nbIteration times
-    for (auto iterationNumber = 0;
-         iterationNumber < this->params.nbIterationsPerPolicyEvaluation;
-         iterationNumber++) {
+    for (uint64_t iterationNumber = firstIteration;
+         iterationNumber < firstIteration + nbIterations; iterationNumber++) {
         // Compute a Hash
         Data::Hash<uint64_t> hasher;
         uint64_t hash = hasher(generationNumber) ^ hasher(iterationNumber);
 
+        // Evaluate the episode
+        inferenceCost += this->evaluateEpisode(
+            tee, *job.getExecutedRoot(), le, hash, mode, iterationNumber,
+            generationNumber, programCosts);
+
+        // Update results
+        result += le.getScore();
+    }
+
+    // Create the EvaluationResult
+    auto evaluationResult = std::shared_ptr<EvaluationResult>(
+        new EvaluationResult(result / (double)nbIterations, nbIterations));
+    evaluationResult->setInferenceCost(inferenceCost / (double)nbIterations);
+
+    // Combine it with previous one if any
+    if (previousEval != nullptr) {
+        *evaluationResult += *previousEval;
+    }
+    return evaluationResult;
+}
+
+double Learn::LearningAgent::evaluateEpisode(
+    TPG::TPGExecutionEngine& tee, const TPG::TPGVertex& root,
+    LearningEnvironment& le, size_t seed, Learn::LearningMode mode,
+    uint16_t iterationNumber, uint64_t generationNumber,
+    InferenceCostModel::ProgramCostCache& programCosts) const
+{
+    GEGELATI_PROFILE_COUNT("episodes", 1);
+    bool isCostUsed = this->isInferenceCostUsed();
+    double inferenceCost = 0.0;
+    if (!this->observationCache.isEnabled() || !le.isActionIndependent()) {
         // Reset the learning Environment
-        le.reset(hash, mode, iterationNumber, generationNumber);
+        {
+            GEGELATI_PROFILE_STATS_SCOPE("reset");
+            le.reset(seed, mode, iterationNumber, generationNumber);
+        }
 
         uint64_t nbActions = 0;
         while (!le.isTerminal() &&
                nbActions < this->params.maxNbActionsPerEval) {
             // Get the action
-            uint64_t actionID =
-                ((const TPG::TPGAction*)tee.executeFromRoot(*root).back())
-                    ->getActionID();
+            uint64_t actionID;
+            {
+                GEGELATI_PROFILE_STATS_SCOPE("executeFromRoot");
+                const std::vector<const TPG::TPGVertex*> trace =
+                    tee.executeFromRoot(root);
+                actionID = ((const TPG::TPGAction*)trace.back())->getActionID();
+                if (isCostUsed) {
+                    inferenceCost += this->inferenceCostModel.getTraceCost(
+                        trace, programCosts);
+                }
+            }
             // Do it
-            le.doAction(actionID);
+            {
+                GEGELATI_PROFILE_STATS_SCOPE("doAction");
+                le.doAction(actionID);
+            }
             // Count actions
             nbActions++;
         }
+        GEGELATI_PROFILE_COUNT("actions", nbActions);
+        return (nbActions > 0) ? inferenceCost / (double)nbActions : 0.0;
+    }
 
-        // Update results
-        result += le.getScore();
+    // Get the observations of the episode, recording them if needed
+    ObservationCache::Key key{seed, mode, iterationNumber, generationNumber};
+    std::shared_ptr<const ObservationStream> stream =
+        this->observationCache.getStream(key, [&]() {
+            return ObservationCache::recordStream(
+                le, this->env.getInstructionSet(), key,
+                this->params.maxNbActionsPerEval);
+        });
+
+    // Replay them
+    GEGELATI_PROFILE_STATS_SCOPE("replay");
+    le.resetReplay(seed, mode, iterationNumber, generationNumber);
+    for (const ObservationFrame& frame : stream->frames) {
+        tee.setDataSources(frame.dataSources);
+        const std::vector<const TPG::TPGVertex*> trace =
+            tee.executeFromRoot(root);
+        uint64_t actionID = ((const TPG::TPGAction*)trace.back())->getActionID();
+        if (isCostUsed) {
+            inferenceCost +=
+                this->inferenceCostModel.getTraceCost(trace, programCosts);
+        }
+        le.replayAction(frame.label, actionID);
     }
+    GEGELATI_PROFILE_COUNT("actions", stream->frames.size());
 
-    // Create the EvaluationResult
-    auto evaluationResult =
-        std::shared_ptr<EvaluationResult>(new EvaluationResult(
-            result / (double)params.nbIterationsPerPolicyEvaluation,
-            params.nbIterationsPerPolicyEvaluation));
+    // Restore the data sources of the learning Environment
+    tee.setDataSources(le.getDataSources());
 
-    // Combine it with previous one if any
-    if (previousEval != nullptr) {
-        *evaluationResult += *previousEval;
-    }
-    return evaluationResult;
+    return (!stream->frames.empty())
+               ? inferenceCost / (double)stream->frames.size()
+               : 0.0;
 }
 
-std::multimap<std::shared_ptr<Learn::EvaluationResult>, const TPG::TPGVertex*>
-Learn::LearningAgent::evaluateAllRoots(uint64_t generationNumber,
-                                       Learn::LearningMode mode)
+Learn::ResultsTable Learn::LearningAgent::evaluateAllRoots(
+    uint64_t generationNumber, Learn::LearningMode mode)
 {
-    std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>
-        result;
+    ResultsTable result;
 
     // Create the TPGExecutionEngine for this evaluation.
     // The engine uses the Archive only in training mode.
@@ -184,12 +273,14 @@ Learn::LearningAgent::evaluateAllRoots(uint64_t generationNumber,
             (mode == LearningMode::TRAINING) ? &this->archive : NULL);
 
     auto roots = tpg->getRootVertices();
+    result.reserve(roots.size());
     for (int i = 0; i < roots.size(); i++) {
         auto job = makeJob(roots.at(i), mode);
         this->archive.setRandomSeed(job->getArchiveSeed());
+        GEGELATI_PROFILE_SCOPE("evaluateJob");
         std::shared_ptr<EvaluationResult> avgScore = this->evaluateJob(
             *tee, *job, generationNumber, mode, this->learningEnvironment);
-        result.emplace(avgScore, (*job).getRoot());
+        result.addRow((*job).getRoot(), avgScore);
     }
 
     return result;
@@ -225,23 +316,339 @@ std::shared_ptr<Learn::EvaluationResult> Learn::LearningAgent::evaluateOneRoot(
     return avgScore;
 }
 
+Learn::ResultsTable Learn::LearningAgent::evaluateValidationSnapshot(
+    const TPG::TPGGraph& snapshot,
+    const std::vector<const TPG::TPGVertex*>& snapshotRoots,
+    const std::vector<const TPG::TPGVertex*>& roots,
+    uint64_t generationNumber) const
+{
+    GEGELATI_PROFILE_SCOPE("validate");
+    ResultsTable result;
+
+    // The LearningEnvironment of the agent is used concurrently by the
+    // training process.
+    std::unique_ptr<LearningEnvironment> le(this->learningEnvironment.clone());
+    Environment privateEnv(this->env.getInstructionSet(),
+                           le->getDataSources(), this->env.getNbRegisters(),
+                           this->env.getNbConstant());
+    std::unique_ptr<TPG::TPGExecutionEngine> tee =
+        snapshot.getFactory().createTPGExecutionEngine(privateEnv, NULL);
+
+    result.reserve(roots.size());
+    for (size_t i = 0; i < roots.size(); i++) {
+        Job job(snapshotRoots.at(i), 0, i);
+        GEGELATI_PROFILE_SCOPE("evaluateJob");
+        result.addRow(roots.at(i),
+                      this->evaluateJob(*tee, job, generationNumber,
+                                        LearningMode::VALIDATION, *le));
+    }
+
+    return result;
+}
+
+bool Learn::LearningAgent::canInterleaveEpisodes() const
+{
+    return this->params.nbEpisodesInFlight > 1 &&
+           this->learningEnvironment.isCopyable() &&
+           this->learningEnvironment.isAsynchronous();
+}
+
+void Learn::LearningAgent::evaluateJobsInterleaved(
+    uint64_t generationNumber, Learn::LearningMode mode,
+    const std::vector<LearningEnvironment*>& envs,
+    const std::function<std::shared_ptr<Job>()>& nextJob,
+    const std::function<Archive*(const Job&)>& archiveForJob,
+    const std::function<void(const std::shared_ptr<Job>&,
+                             std::shared_ptr<EvaluationResult>)>& jobDone)
+    const
+{
+    // State of the episode in flight in each slot
+    struct Slot
+    {
+        LearningEnvironment* le;
+        std::unique_ptr<Environment> env;
+        std::unique_ptr<TPG::TPGExecutionEngine> tee;
+        std::shared_ptr<Job> job;
+        std::shared_ptr<EvaluationResult> previousEval;
+        uint64_t iterationNumber;
+        uint64_t lastIteration;
+        uint64_t nbActions;
+        double result;
+        double episodeInferenceCost;
+        double inferenceCost;
+        InferenceCostModel::ProgramCostCache programCosts;
+    };
+
+    bool isCostUsed = this->isInferenceCostUsed();
+
+    auto resetEpisode = [&](Slot& slot) {
+        Data::Hash<uint64_t> hasher;
+        uint64_t hash =
+            hasher(generationNumber) ^ hasher(slot.iterationNumber);
+        slot.le->reset(hash, mode, slot.iterationNumber, generationNumber);
+        slot.nbActions = 0;
+        slot.episodeInferenceCost = 0.0;
+    };
+
+    // Give the next job to a slot. Returns false if no job is left.
+    auto startJob = [&](Slot& slot) {
+        while ((slot.job = nextJob()) != nullptr) {
+            // Skip the root evaluation as in evaluateJob
+            slot.previousEval = nullptr;
+            if (mode == LearningMode::TRAINING && !slot.job->isPartial() &&
+                this->isRootEvalSkipped(*slot.job->getRoot(),
+                                        slot.previousEval)) {
+                jobDone(slot.job, slot.previousEval);
+                continue;
+            }
+
+            slot.tee->setArchive(archiveForJob(*slot.job));
+            slot.iterationNumber = slot.job->getFirstIteration();
+            slot.lastIteration =
+                slot.iterationNumber +
+                ((slot.job->isPartial())
+                     ? slot.job->getNbIterations()
+                     : this->params.nbIterationsPerPolicyEvaluation);
+            slot.result = 0.0;
+            slot.inferenceCost = 0.0;
+            slot.programCosts.clear();
+            resetEpisode(slot);
+            return true;
+        }
+        return false;
+    };
+
+    // Run the slot until an action is submitted or no job is left.
+    // Returns false if the slot has no more job.
+    auto advance = [&](Slot& slot) {
+        while (true) {
+            if (!slot.le->isTerminal() &&
+                slot.nbActions < this->params.maxNbActionsPerEval) {
+                const std::vector<const TPG::TPGVertex*> trace =
+                    slot.tee->executeFromRoot(*slot.job->getRoot());
+                uint64_t actionID =
+                    ((const TPG::TPGAction*)trace.back())->getActionID();
+                if (isCostUsed) {
+                    slot.episodeInferenceCost +=
+                        this->inferenceCostModel.getTraceCost(
+                            trace, slot.programCosts);
+                }
+                slot.le->submitAction(actionID);
+                return true;
+            }
+
+            // End of the episode
+            slot.result += slot.le->getScore();
+            if (slot.nbActions > 0) {
+                slot.inferenceCost +=
+                    slot.episodeInferenceCost / (double)slot.nbActions;
+            }
+            slot.iterationNumber++;
+            if (slot.iterationNumber < slot.lastIteration) {
+                resetEpisode(slot);
+                continue;
+            }
+
+            // End of the job
+            uint64_t nbIterations =
+                slot.lastIteration - slot.job->getFirstIteration();
+            auto evaluationResult = std::make_shared<EvaluationResult>(
+                slot.result / (double)nbIterations, nbIterations);
+            evaluationResult->setInferenceCost(slot.inferenceCost /
+                                               (double)nbIterations);
+            if (slot.previousEval != nullptr) {
+                *evaluationResult += *slot.previousEval;
+            }
+            jobDone(slot.job, evaluationResult);
+
+            if (!startJob(slot)) {
+                return false;
+            }
+        }
+    };
+
+    // Init slots
+    std::vector<Slot> slots(envs.size());
+    std::vector<size_t> activeSlots;
+    for (size_t i = 0; i < envs.size(); i++) {
+        Slot& slot = slots.at(i);
+        slot.le = envs.at(i);
+        slot.env = std::make_unique<Environment>(
+            this->env.getInstructionSet(), slot.le->getDataSources(),
+            this->env.getNbRegisters(), this->env.getNbConstant());
+        slot.tee =
+            this->tpg->getFactory().createTPGExecutionEngine(*slot.env, NULL);
+        if (startJob(slot) && advance(slot)) {
+            activeSlots.push_back(i);
+        }
+    }
+
+    // Process slots whose action is completed, in slot order
+    while (!activeSlots.empty()) {
+        bool progress = false;
+        for (auto iter = activeSlots.begin(); iter != activeSlots.end();) {
+            Slot& slot = slots.at(*iter);
+            if (!slot.le->pollAction()) {
+                iter++;
+                continue;
+            }
+            progress = true;
+            slot.nbActions++;
+            iter = (advance(slot)) ? std::next(iter) : activeSlots.erase(iter);
+        }
+
+        // All slots are waiting for their environment
+        if (!progress && !activeSlots.empty()) {
+            slots.at(activeSlots.front()).le->awaitAction();
+        }
+    }
+}
+
+bool Learn::LearningAgent::canPipelineValidation() const
+{
+    return this->params.pipelineValidation &&
+           this->learningEnvironment.isCopyable();
+}
+
+std::shared_ptr<TPG::TPGGraph> Learn::LearningAgent::copyTPGGraph(
+    std::unordered_map<const TPG::TPGVertex*, const TPG::TPGVertex*>&
+        vertexCopies,
+    std::unordered_map<const Program::Program*, const Program::Program*>*
+        programOriginals) const
+{
+    std::shared_ptr<TPG::TPGGraph> copy =
+        this->tpg->getFactory().createTPGGraph(this->env);
+    const std::vector<const TPG::TPGVertex*> vertices =
+        this->tpg->getVertices();
+    for (const TPG::TPGVertex* vertex : vertices) {
+        const TPG::TPGAction* action =
+            dynamic_cast<const TPG::TPGAction*>(vertex);
+        vertexCopies[vertex] =
+            (action != nullptr)
+                ? (const TPG::TPGVertex*)&copy->addNewAction(
+                      action->getActionID())
+                : &copy->addNewTeam();
+    }
+
+    // Copies of the Program shared by several edges are shared likewise.
+    std::unordered_map<const Program::Program*,
+                       std::shared_ptr<Program::Program>>
+        programCopies;
+    for (const TPG::TPGVertex* vertex : vertices) {
+        for (TPG::TPGEdge* edge : vertex->getOutgoingEdges()) {
+            std::shared_ptr<Program::Program> program =
+                edge->getProgramSharedPointer();
+            if (programOriginals != NULL) {
+                std::shared_ptr<Program::Program>& programCopy =
+                    programCopies[program.get()];
+                if (programCopy == nullptr) {
+                    programCopy = std::make_shared<Program::Program>(*program);
+                    programOriginals->emplace(programCopy.get(),
+                                              program.get());
+                }
+                program = programCopy;
+            }
+            copy->addNewEdge(*vertexCopies.at(vertex),
+                             *vertexCopies.at(edge->getDestination()),
+                             program);
+        }
+    }
+
+    return copy;
+}
+
+void Learn::LearningAgent::startPipelinedValidation(uint64_t generationNumber)
+{
+    // Copy the TPGGraph. Programs are shared with the copy since Program of
+    // the TPGGraph are never modified once created: mutations are applied to
+    // new copies of Program.
+    std::unordered_map<const TPG::TPGVertex*, const TPG::TPGVertex*> copies;
+    std::shared_ptr<TPG::TPGGraph> snapshot = this->copyTPGGraph(copies);
+
+    std::vector<const TPG::TPGVertex*> roots = this->tpg->getRootVertices();
+    std::vector<const TPG::TPGVertex*> snapshotRoots;
+    snapshotRoots.reserve(roots.size());
+    for (const TPG::TPGVertex* root : roots) {
+        snapshotRoots.push_back(copies.at(root));
+    }
+
+    this->pendingValidation =
+        std::async(std::launch::async, [this, snapshot, snapshotRoots, roots,
+                                        generationNumber]() {
+            ResultsTable results = this->evaluateValidationSnapshot(
+                *snapshot, snapshotRoots, roots, generationNumber);
+            // Read by the loggers once the future is ready.
+            this->validationEnd = std::chrono::system_clock::now();
+            return results;
+        });
+}
+
+void Learn::LearningAgent::waitForValidation()
+{
+    if (!this->pendingValidation.valid()) {
+        return;
+    }
+
+    // Rethrows any exception raised during the validation
+    ResultsTable validationResults = this->pendingValidation.get();
+    for (auto logger : loggers) {
+        logger.get().logAfterValidate(validationResults);
+    }
+    for (auto logger : loggers) {
+        logger.get().logEndOfTraining();
+    }
+}
+
+void Learn::LearningAgent::joinValidation()
+{
+    if (this->pendingValidation.valid()) {
+        // Exceptions raised during the validation are discarded.
+        this->pendingValidation.wait();
+        this->pendingValidation = std::future<ResultsTable>();
+    }
+}
+
 void Learn::LearningAgent::trainOneGeneration(uint64_t generationNumber)
 {
+    // When the validation of the previous generation is still running, the
+    // loggers are notified of the new generation only once it is delivered.
+    bool validationPending = this->pendingValidation.valid();
+    if (!validationPending) {
+        for (auto logger : loggers) {
+            logger.get().logNewGeneration(generationNumber);
+        }
+    }
     for (auto logger : loggers) {
-        logger.get().logNewGeneration(generationNumber);
+        logger.get().logBeforePopulateTPG();
     }
 
     // Populate Sequentially
-    Mutator::TPGMutator::populateTPG(
-        *this->tpg, this->archive, this->params.mutation, this->rng,
-        this->learningEnvironment.getNbActions(), maxNbThreads);
+    this->rootParents.clear();
+    {
+        GEGELATI_PROFILE_SCOPE("populate");
+        Mutator::TPGMutator::populateTPG(
+            *this->tpg, this->archive, this->params.mutation, this->rng,
+            this->learningEnvironment.getNbActions(), maxNbThreads,
+            &this->rootParents);
+    }
+
+    if (validationPending) {
+        this->waitForValidation();
+        for (auto logger : loggers) {
+            logger.get().logNewGeneration(generationNumber);
+        }
+    }
     for (auto logger : loggers) {
         logger.get().logAfterPopulateTPG();
     }
 
     // Evaluate
-    auto results =
-        this->evaluateAllRoots(generationNumber, LearningMode::TRAINING);
+    ResultsTable results;
+    {
+        GEGELATI_PROFILE_SCOPE("evaluate");
+        results =
+            this->evaluateAllRoots(generationNumber, LearningMode::TRAINING);
+    }
     for (auto logger : loggers) {
         logger.get().logAfterEvaluate(results);
     }
@@ -250,9 +657,12 @@ void Learn::LearningAgent::trainOneGeneration(uint64_t generationNumber)
     this->updateBestScoreLastGen(results);
 
     // Remove worst performing roots
-    decimateWorstRoots(results);
-    // Update the best
-    this->updateEvaluationRecords(results);
+    {
+        GEGELATI_PROFILE_SCOPE("decimate");
+        decimateWorstRoots(results);
+        // Update the best
+        this->updateEvaluationRecords(results);
+    }
 
     for (auto logger : loggers) {
         logger.get().logAfterDecimate();
@@ -260,8 +670,19 @@ void Learn::LearningAgent::trainOneGeneration(uint64_t generationNumber)
 
     // Does a validation or not according to the parameter doValidation
     if (params.doValidation) {
-        auto validationResults =
-            evaluateAllRoots(generationNumber, Learn::LearningMode::VALIDATION);
+        if (this->canPipelineValidation()) {
+            // Remaining logs are delivered by waitForValidation()
+            this->startPipelinedValidation(generationNumber);
+            return;
+        }
+
+        ResultsTable validationResults;
+        {
+            GEGELATI_PROFILE_SCOPE("validate");
+            validationResults = evaluateAllRoots(
+                generationNumber, Learn::LearningMode::VALIDATION);
+        }
+        this->validationEnd = std::chrono::system_clock::now();
         for (auto logger : loggers) {
             logger.get().logAfterValidate(validationResults);
         }
@@ -272,39 +693,59 @@ void Learn::LearningAgent::trainOneGeneration(uint64_t generationNumber)
     }
 }
 
-void Learn::LearningAgent::decimateWorstRoots(
-    std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>&
-        results)
+void Learn::LearningAgent::decimateWorstRoots(ResultsTable& results)
 {
-    // Some actions may be encountered but not removed while scanning the
-    // results map they should be re-inserted to the list before leaving the
-    // method.
-    std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>
-        preservedActionRoots;
+    // Root actions are never removed, and are not counted as removed roots.
+    // Rank enough rows to be sure the requested number of non-action roots is
+    // found among them.
+    uint64_t nbRootsToDelete = (uint64_t)floor(
+        this->params.ratioDeletedRoots * (double)params.mutation.tpg.nbRoots);
+    std::vector<bool> isAction(results.size());
+    uint64_t nbActionRoots = 0;
+    for (size_t row = 0; row < results.size(); row++) {
+        isAction[row] = dynamic_cast<const TPG::TPGAction*>(
+                            results.getRoot(row)) != nullptr;
+        nbActionRoots += (isAction[row]) ? 1 : 0;
+    }
+    std::vector<size_t> worstRows = this->getWorstRowsForSelection(
+        results, nbRootsToDelete + nbActionRoots);
 
-    auto i = 0;
-    while (i < floor(this->params.ratioDeletedRoots *
-                     (double)params.mutation.tpg.nbRoots) &&
-           results.size() > 0) {
+    std::vector<bool> removedRows(results.size(), false);
+    uint64_t i = 0;
+    auto iter = worstRows.begin();
+    while (i < nbRootsToDelete && iter != worstRows.end()) {
         // If the root is an action, do not remove it!
-        const TPG::TPGVertex* root = results.begin()->second;
-        if (dynamic_cast<const TPG::TPGAction*>(root) == nullptr) {
-            tpg->removeVertex(*results.begin()->second);
+        if (!isAction[*iter]) {
+            const TPG::TPGVertex* root = results.getRoot(*iter);
+            tpg->removeVertex(*root);
             // Removed stored result (if any)
-            this->resultsPerRoot.erase(results.begin()->second);
+            this->resultsPerRoot.erase(root);
+            removedRows[*iter] = true;
+            i++;
         }
-        else {
-            preservedActionRoots.insert(*results.begin());
-            i--; // no vertex was actually removed
-        }
-        results.erase(results.begin());
-
-        // Increment loop counter
-        i++;
+        iter++;
     }
 
-    // Restore root actions
-    results.insert(preservedActionRoots.begin(), preservedActionRoots.end());
+    results.removeRows(removedRows);
+}
+
+bool Learn::LearningAgent::isInferenceCostUsed() const
+{
+    return this->params.inferenceCostPenalty > 0.0 ||
+           this->params.paretoCostSelection;
+}
+
+std::vector<size_t> Learn::LearningAgent::getWorstRowsForSelection(
+    const ResultsTable& results, size_t nbRows) const
+{
+    if (!this->isInferenceCostUsed()) {
+        return results.getWorstRows(nbRows);
+    }
+    if (this->params.paretoCostSelection) {
+        return results.getParetoWorstRows(nbRows,
+                                          this->params.inferenceCostPenalty);
+    }
+    return results.getWorstRows(nbRows, this->params.inferenceCostPenalty);
 }
 
 uint64_t Learn::LearningAgent::train(volatile bool& altTraining,
@@ -339,6 +780,9 @@ uint64_t Learn::LearningAgent::train(volatile bool& altTraining,
         }
     }
 
+    // Deliver the validation of the last generation
+    this->waitForValidation();
+
     if (printProgressBar) {
         if (!altTraining) {
             printf("\nTraining completed\n");
@@ -351,37 +795,39 @@ uint64_t Learn::LearningAgent::train(volatile bool& altTraining,
     return generationNumber;
 }
 
-void Learn::LearningAgent::updateEvaluationRecords(
-    const std::multimap<std::shared_ptr<EvaluationResult>,
-                        const TPG::TPGVertex*>& results)
+void Learn::LearningAgent::updateEvaluationRecords(const ResultsTable& results)
 {
     { // Update resultsPerRoot
-        for (auto result : results) {
-            auto mapIterator = this->resultsPerRoot.find(result.second);
+        for (size_t row = 0; row < results.size(); row++) {
+            const TPG::TPGVertex* root = results.getRoot(row);
+            const std::shared_ptr<EvaluationResult>& evaluation =
+                results.getEvaluationResult(row);
+            auto mapIterator = this->resultsPerRoot.find(root);
             if (mapIterator == this->resultsPerRoot.end()) {
                 // First time this root is evaluated
-                this->resultsPerRoot.emplace(result.second, result.first);
+                this->resultsPerRoot.emplace(root, evaluation);
             }
-            else if (result.first != mapIterator->second) {
+            else if (evaluation != mapIterator->second) {
                 // This root has already been evaluated.
                 // If the received result pointer is different from the one
                 // stored in the map, update the one in the map by replacing it
                 // with the new one (which was combined with the pre-existing
                 // one in evalRoot)
-                mapIterator->second = result.first;
+                mapIterator->second = evaluation;
                 // If the received result is associated to the current bestRoot,
                 // update it.
-                if (result.second == this->bestRoot.first) {
-                    this->bestRoot.second = result.first;
+                if (root == this->bestRoot.first) {
+                    this->bestRoot.second = evaluation;
                 }
             }
         }
     }
 
     { // Update bestRoot
-        auto iterator = --results.end();
-        const std::shared_ptr<EvaluationResult> evaluation = iterator->first;
-        const TPG::TPGVertex* candidate = iterator->second;
+        size_t bestRow = results.getBestRow();
+        const std::shared_ptr<EvaluationResult>& evaluation =
+            results.getEvaluationResult(bestRow);
+        const TPG::TPGVertex* candidate = results.getRoot(bestRow);
         // Test the three replacement cases
         // from the simpler to the most complex to test
         if (this->bestRoot.first == nullptr         // NULL case
@@ -404,12 +850,15 @@ Learn::LearningAgent::getBestRoot() const
     return this->bestRoot;
 }
 
-void Learn::LearningAgent::updateBestScoreLastGen(
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>& results)
+const std::map<const TPG::TPGVertex*, std::shared_ptr<Learn::EvaluationResult>>&
+Learn::LearningAgent::getResultsPerRoot() const
+{
+    return this->resultsPerRoot;
+}
+
+void Learn::LearningAgent::updateBestScoreLastGen(const ResultsTable& results)
 {
-    auto iterator = --results.end();
-    bestScoreLastGen = iterator->first->getResult();
+    bestScoreLastGen = results.getMaxScore();
 }
 
 double Learn::LearningAgent::getBestScoreLastGen() const
@@ -54,3 +54,47 @@ void Learn::LearningEnvironment::doAction(uint64_t actionID)
                                  "actions for this learning environment.");
     }
 }
+
+bool Learn::LearningEnvironment::isAsynchronous() const
+{
+    return false;
+}
+
+void Learn::LearningEnvironment::submitAction(uint64_t actionID)
+{
+    this->doAction(actionID);
+}
+
+bool Learn::LearningEnvironment::pollAction()
+{
+    return true;
+}
+
+void Learn::LearningEnvironment::awaitAction()
+{
+}
+
+bool Learn::LearningEnvironment::isActionIndependent() const
+{
+    return false;
+}
+
+uint64_t Learn::LearningEnvironment::getObservationLabel() const
+{
+    return 0;
+}
+
+void Learn::LearningEnvironment::resetReplay(size_t seed, LearningMode mode,
+                                             uint16_t iterationNumber,
+                                             uint64_t generationNumber)
+{
+    throw std::runtime_error(
+        "LearningEnvironment does not support the replay of observations.");
+}
+
+void Learn::LearningEnvironment::replayAction(uint64_t label,
+                                              uint64_t actionID)
+{
+    throw std::runtime_error(
+        "LearningEnvironment does not support the replay of observations.");
+}
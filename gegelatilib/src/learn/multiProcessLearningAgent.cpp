@@ -0,0 +1,555 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "tpg/tpgExecutionEngine.h"
+
+#include "learn/multiProcessLearningAgent.h"
+
+#ifndef _WIN32
+/// Job index sent to a worker process to terminate it.
+static const uint64_t END_OF_JOBS = UINT64_MAX;
+
+/// Message tag for a result already stored in resultsPerRoot.
+static const uint8_t RESULT_SKIPPED = 0;
+
+/// Message tag for a new EvaluationResult.
+static const uint8_t RESULT_EVALUATED = 1;
+
+/**
+ * \brief Write all given bytes to a file descriptor.
+ *
+ * \return false if the file descriptor was closed or an error occurred.
+ */
+static bool writeBytes(int fd, const void* data, size_t size)
+{
+    const char* bytes = (const char*)data;
+    while (size > 0) {
+        ssize_t nbWritten = write(fd, bytes, size);
+        if (nbWritten < 0 && errno == EINTR) {
+            continue;
+        }
+        if (nbWritten <= 0) {
+            return false;
+        }
+        bytes += nbWritten;
+        size -= nbWritten;
+    }
+    return true;
+}
+
+/**
+ * \brief Read exactly the given number of bytes from a file descriptor.
+ *
+ * \return false if the file descriptor was closed or an error occurred.
+ */
+static bool readBytes(int fd, void* data, size_t size)
+{
+    char* bytes = (char*)data;
+    while (size > 0) {
+        ssize_t nbRead = read(fd, bytes, size);
+        if (nbRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (nbRead <= 0) {
+            return false;
+        }
+        bytes += nbRead;
+        size -= nbRead;
+    }
+    return true;
+}
+
+template <typename T> static void writeValue(std::ostream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T> static T readValue(std::istream& in)
+{
+    T value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!in) {
+        throw std::runtime_error("Unexpected end of Archive message.");
+    }
+    return value;
+}
+
+/**
+ * \brief Serialize the content of an Archive filled by a worker process.
+ *
+ * DataHandler are written with their writeData() method. Program pointers
+ * are written as raw values, which remain valid in the parent process since
+ * the worker was forked from it.
+ *
+ * \param[in] out the stream where the Archive content is written.
+ * \param[in] archive the Archive to serialize.
+ */
+static void writeArchive(std::ostream& out, const Archive& archive)
+{
+    const auto& dataHandlers = archive.getDataHandlers();
+    writeValue<uint64_t>(out, dataHandlers.size());
+    for (const auto& pair : dataHandlers) {
+        writeValue<uint64_t>(out, pair.first);
+        writeValue<uint64_t>(out, pair.second.size());
+        for (const auto& dHandler : pair.second) {
+            dHandler.get().writeData(out);
+        }
+    }
+
+    writeValue<uint64_t>(out, archive.getNbRecordings());
+    for (size_t i = 0; i < archive.getNbRecordings(); i++) {
+        const ArchiveRecording& recording = archive.at(i);
+        writeValue<uint64_t>(out, (uintptr_t)recording.prog);
+        writeValue<uint64_t>(out, recording.dataHash);
+        writeValue<double>(out, recording.result);
+    }
+}
+
+/**
+ * \brief Fill an Archive with the content serialized by writeArchive().
+ *
+ * DataHandler are rebuilt by cloning the data sources of the Environment and
+ * reading their data from the stream. Recordings are inserted in their
+ * original order.
+ *
+ * \param[in] in the stream from which the Archive content is read.
+ * \param[in] env the Environment whose data sources are cloned.
+ * \param[in,out] archive the Archive where recordings are inserted.
+ * \throw std::runtime_error if the stream content is invalid.
+ */
+static void readArchive(std::istream& in, const Environment& env,
+                        Archive& archive)
+{
+    const auto& dataSources = env.getDataSources();
+    std::map<size_t, std::vector<std::unique_ptr<Data::DataHandler>>>
+        dataHandlers;
+    uint64_t nbDataHandlers = readValue<uint64_t>(in);
+    for (uint64_t i = 0; i < nbDataHandlers; i++) {
+        auto& dHandlers = dataHandlers[readValue<uint64_t>(in)];
+        if (readValue<uint64_t>(in) != dataSources.size()) {
+            throw std::runtime_error("Number of DataHandler in an Archive "
+                                     "message does not match the "
+                                     "Environment.");
+        }
+        for (const auto& dataSource : dataSources) {
+            dHandlers.emplace_back(dataSource.get().clone());
+            dHandlers.back()->readData(in);
+        }
+    }
+
+    uint64_t nbRecordings = readValue<uint64_t>(in);
+    for (uint64_t i = 0; i < nbRecordings; i++) {
+        auto prog =
+            (const Program::Program*)(uintptr_t)readValue<uint64_t>(in);
+        auto dataHash = readValue<uint64_t>(in);
+        double result = readValue<double>(in);
+        auto iter = dataHandlers.find(dataHash);
+        if (iter == dataHandlers.end()) {
+            throw std::runtime_error("Unknown DataHandler in an Archive "
+                                     "message.");
+        }
+        std::vector<std::reference_wrapper<const Data::DataHandler>>
+            dHandlers;
+        for (const auto& dHandler : iter->second) {
+            dHandlers.push_back(*dHandler);
+        }
+        archive.addRecording(prog, dHandlers, result, true);
+    }
+}
+#endif
+
+void Learn::MultiProcessLearningAgent::setWorkerInitializer(
+    const std::function<void(LearningEnvironment&)>& initializer)
+{
+    this->workerInitializer = initializer;
+}
+
+Learn::ResultsTable Learn::MultiProcessLearningAgent::evaluateAllRoots(
+    uint64_t generationNumber, Learn::LearningMode mode)
+{
+#ifdef _WIN32
+    return ParallelLearningAgent::evaluateAllRoots(generationNumber, mode);
+#else
+    if (this->maxNbThreads <= 1 || this->learningEnvironment.isCopyable()) {
+        return ParallelLearningAgent::evaluateAllRoots(generationNumber, mode);
+    }
+
+    // Create the jobs in the parent process to keep the RNG in sync.
+    auto jobsQueue = this->makeJobs(mode);
+    std::vector<std::shared_ptr<Job>> jobs;
+    jobs.reserve(jobsQueue.size());
+    while (!jobsQueue.empty()) {
+        jobs.push_back(jobsQueue.front());
+        jobsQueue.pop();
+    }
+
+    auto evaluations =
+        this->evaluateJobsInProcesses(generationNumber, mode, jobs);
+
+    // Merge the results, in the order of job indexes
+    ResultsTable results;
+    results.reserve(jobs.size());
+    for (size_t i = 0; i < jobs.size(); i++) {
+        results.addRow(jobs.at(i)->getRoot(), evaluations.at(i));
+    }
+
+    return results;
+#endif
+}
+
+std::vector<std::shared_ptr<Learn::EvaluationResult>> Learn::
+    MultiProcessLearningAgent::evaluateJobsInProcesses(
+        uint64_t generationNumber, LearningMode mode,
+        const std::vector<std::shared_ptr<Job>>& jobs)
+{
+    std::vector<std::shared_ptr<EvaluationResult>> evaluations(jobs.size());
+#ifdef _WIN32
+    throw std::runtime_error(
+        "Multi-process evaluation is not supported on this platform.");
+#else
+    size_t nbWorkers = std::min((size_t)this->maxNbThreads, jobs.size());
+
+    // File descriptors used by the parent, and worker pids
+    std::vector<int> jobsFds;
+    std::vector<int> resultsFds;
+    std::vector<pid_t> pids;
+
+    // Archives filled by workers, merged in the order of job indexes
+    std::map<uint64_t, Archive*> archiveMap;
+
+    // A worker dying while a job is sent must not kill the parent process.
+    struct sigaction ignoreAction = {};
+    struct sigaction previousAction;
+    ignoreAction.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &ignoreAction, &previousAction);
+
+    auto killWorkers = [&]() {
+        for (auto fd : jobsFds) {
+            close(fd);
+        }
+        for (auto fd : resultsFds) {
+            close(fd);
+        }
+        for (auto pid : pids) {
+            kill(pid, SIGKILL);
+            waitpid(pid, nullptr, 0);
+        }
+        for (auto& pair : archiveMap) {
+            delete pair.second;
+        }
+        sigaction(SIGPIPE, &previousAction, nullptr);
+    };
+
+    // Fork the workers
+    for (size_t i = 0; i < nbWorkers; i++) {
+        int jobsPipe[2];
+        int resultsPipe[2];
+        if (pipe(jobsPipe) != 0) {
+            killWorkers();
+            throw std::runtime_error("Could not create a pipe for a worker "
+                                     "process: " +
+                                     std::string(strerror(errno)));
+        }
+        if (pipe(resultsPipe) != 0) {
+            close(jobsPipe[0]);
+            close(jobsPipe[1]);
+            killWorkers();
+            throw std::runtime_error("Could not create a pipe for a worker "
+                                     "process: " +
+                                     std::string(strerror(errno)));
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(jobsPipe[0]);
+            close(jobsPipe[1]);
+            close(resultsPipe[0]);
+            close(resultsPipe[1]);
+            killWorkers();
+            throw std::runtime_error("Could not fork a worker process: " +
+                                     std::string(strerror(errno)));
+        }
+
+        if (pid == 0) {
+            // Worker process: close the file descriptors of the parent.
+            for (auto fd : jobsFds) {
+                close(fd);
+            }
+            for (auto fd : resultsFds) {
+                close(fd);
+            }
+            close(jobsPipe[1]);
+            close(resultsPipe[0]);
+
+            int status = 0;
+            try {
+                this->workerProcess(generationNumber, mode, jobs, jobsPipe[0],
+                                    resultsPipe[1]);
+            }
+            catch (...) {
+                status = 1;
+            }
+            // Skip destructors and atexit handlers of the parent process.
+            _exit(status);
+        }
+
+        // Parent process
+        close(jobsPipe[0]);
+        close(resultsPipe[1]);
+        jobsFds.push_back(jobsPipe[1]);
+        resultsFds.push_back(resultsPipe[0]);
+        pids.push_back(pid);
+    }
+
+    // Send a first job to each worker
+    uint64_t nextJob = 0;
+    std::vector<pollfd> pollFds(nbWorkers);
+    for (size_t i = 0; i < nbWorkers; i++) {
+        pollFds.at(i) = {resultsFds.at(i), POLLIN, 0};
+        if (!writeBytes(jobsFds.at(i), &nextJob, sizeof(nextJob))) {
+            killWorkers();
+            throw std::runtime_error(
+                "A worker process failed during the evaluation.");
+        }
+        nextJob++;
+    }
+
+    // Collect results and distribute remaining jobs
+    size_t nbActiveWorkers = nbWorkers;
+    while (nbActiveWorkers > 0) {
+        if (poll(pollFds.data(), pollFds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            killWorkers();
+            throw std::runtime_error("Error while waiting for worker "
+                                     "processes: " +
+                                     std::string(strerror(errno)));
+        }
+
+        for (size_t i = 0; i < nbWorkers; i++) {
+            if (pollFds.at(i).fd < 0 || pollFds.at(i).revents == 0) {
+                continue;
+            }
+
+            // Read the result message
+            uint64_t jobIdx;
+            uint8_t tag;
+            bool success =
+                readBytes(resultsFds.at(i), &jobIdx, sizeof(jobIdx)) &&
+                readBytes(resultsFds.at(i), &tag, sizeof(tag)) &&
+                jobIdx < jobs.size();
+            if (success && tag == RESULT_SKIPPED) {
+                this->isRootEvalSkipped(*jobs.at(jobIdx)->getRoot(),
+                                        evaluations.at(jobIdx));
+                success = evaluations.at(jobIdx) != nullptr;
+            }
+            else if (success && tag == RESULT_EVALUATED) {
+                double result;
+                uint64_t nbEvaluation;
+                double inferenceCost;
+                success =
+                    readBytes(resultsFds.at(i), &result, sizeof(result)) &&
+                    readBytes(resultsFds.at(i), &nbEvaluation,
+                              sizeof(nbEvaluation)) &&
+                    readBytes(resultsFds.at(i), &inferenceCost,
+                              sizeof(inferenceCost));
+                evaluations.at(jobIdx) =
+                    std::make_shared<EvaluationResult>(result, nbEvaluation);
+                evaluations.at(jobIdx)->setInferenceCost(inferenceCost);
+            }
+            else {
+                success = false;
+            }
+
+            // Read the Archive filled during the job
+            uint64_t archiveSize;
+            success = success && readBytes(resultsFds.at(i), &archiveSize,
+                                           sizeof(archiveSize));
+            if (success && archiveSize > 0) {
+                std::string buffer(archiveSize, '\0');
+                success = readBytes(resultsFds.at(i), &buffer[0], archiveSize);
+                Archive* archive =
+                    new Archive(params.archiveSize, params.archivingProbability,
+                                jobs.at(jobIdx)->getArchiveSeed());
+                archiveMap.insert({jobIdx, archive});
+                try {
+                    std::istringstream in(buffer);
+                    if (success) {
+                        readArchive(in, this->env, *archive);
+                    }
+                }
+                catch (const std::runtime_error&) {
+                    success = false;
+                }
+            }
+
+            if (!success) {
+                killWorkers();
+                throw std::runtime_error(
+                    "A worker process failed during the evaluation.");
+            }
+
+            // Send the next job, or terminate the worker
+            uint64_t job = (nextJob < jobs.size()) ? nextJob++ : END_OF_JOBS;
+            if (!writeBytes(jobsFds.at(i), &job, sizeof(job)) &&
+                job != END_OF_JOBS) {
+                killWorkers();
+                throw std::runtime_error(
+                    "A worker process failed during the evaluation.");
+            }
+            if (job == END_OF_JOBS) {
+                pollFds.at(i).fd = -1;
+                nbActiveWorkers--;
+            }
+        }
+    }
+
+    // Wait for the termination of workers
+    bool success = true;
+    for (size_t i = 0; i < nbWorkers; i++) {
+        close(jobsFds.at(i));
+        close(resultsFds.at(i));
+        int status;
+        success &= waitpid(pids.at(i), &status, 0) == pids.at(i) &&
+                   WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    sigaction(SIGPIPE, &previousAction, nullptr);
+    if (!success) {
+        for (auto& pair : archiveMap) {
+            delete pair.second;
+        }
+        throw std::runtime_error("A worker process failed during the "
+                                 "evaluation.");
+    }
+
+    this->mergeArchiveMap(archiveMap);
+#endif
+
+    return evaluations;
+}
+
+void Learn::MultiProcessLearningAgent::workerProcess(
+    uint64_t generationNumber, LearningMode mode,
+    const std::vector<std::shared_ptr<Job>>& jobs, int jobsFd, int resultsFd)
+{
+#ifndef _WIN32
+    // The learningEnvironment of the forked process is a private copy.
+    if (this->workerInitializer) {
+        this->workerInitializer(this->learningEnvironment);
+    }
+
+    // Create a TPGExecutionEngine
+    std::unique_ptr<TPG::TPGExecutionEngine> tee =
+        this->tpg->getFactory().createTPGExecutionEngine(this->env, NULL);
+
+    uint64_t jobIdx;
+    while (readBytes(jobsFd, &jobIdx, sizeof(jobIdx)) &&
+           jobIdx != END_OF_JOBS) {
+        const Job& job = *jobs.at(jobIdx);
+
+        // Each job has its own Archive, sent back to the parent process.
+        std::unique_ptr<Archive> archive;
+        if (mode == LearningMode::TRAINING) {
+            archive = std::make_unique<Archive>(params.archiveSize,
+                                                params.archivingProbability,
+                                                job.getArchiveSeed());
+        }
+        tee->setArchive(archive.get());
+
+        std::shared_ptr<EvaluationResult> evaluation =
+            this->evaluateJob(*tee, job, generationNumber, mode,
+                              this->learningEnvironment);
+
+        bool success = writeBytes(resultsFd, &jobIdx, sizeof(jobIdx));
+        auto iter = this->resultsPerRoot.find(job.getRoot());
+        if (iter != this->resultsPerRoot.end() && iter->second == evaluation) {
+            // The parent already knows this result.
+            success = success && writeBytes(resultsFd, &RESULT_SKIPPED,
+                                            sizeof(RESULT_SKIPPED));
+        }
+        else if (typeid(*evaluation) == typeid(EvaluationResult)) {
+            double result = evaluation->getResult();
+            uint64_t nbEvaluation = evaluation->getNbEvaluation();
+            double inferenceCost = evaluation->getInferenceCost();
+            success = success &&
+                      writeBytes(resultsFd, &RESULT_EVALUATED,
+                                 sizeof(RESULT_EVALUATED)) &&
+                      writeBytes(resultsFd, &result, sizeof(result)) &&
+                      writeBytes(resultsFd, &nbEvaluation,
+                                 sizeof(nbEvaluation)) &&
+                      writeBytes(resultsFd, &inferenceCost,
+                                 sizeof(inferenceCost));
+        }
+        else {
+            throw std::runtime_error("Only EvaluationResult can be sent by "
+                                     "worker processes.");
+        }
+
+        std::string buffer;
+        if (archive != nullptr && archive->getNbRecordings() > 0) {
+            std::ostringstream out;
+            writeArchive(out, *archive);
+            buffer = out.str();
+        }
+        uint64_t archiveSize = buffer.size();
+        success = success &&
+                  writeBytes(resultsFd, &archiveSize, sizeof(archiveSize)) &&
+                  writeBytes(resultsFd, buffer.data(), buffer.size());
+
+        if (!success) {
+            throw std::runtime_error("Connection with the parent process of "
+                                     "a worker was lost.");
+        }
+    }
+#endif
+}
@@ -0,0 +1,217 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <algorithm>
+
+#include "data/hash.h"
+
+#include "learn/observationCache.h"
+
+bool Learn::ObservationCache::Key::operator==(const Key& other) const
+{
+    return this->seed == other.seed && this->mode == other.mode &&
+           this->iterationNumber == other.iterationNumber &&
+           this->generationNumber == other.generationNumber;
+}
+
+size_t Learn::ObservationCache::KeyHash::operator()(const Key& key) const
+{
+    Data::Hash<uint64_t> hasher;
+    size_t hash = hasher(key.seed);
+    hash = hash * 31 + hasher((uint64_t)key.mode);
+    hash = hash * 31 + hasher(key.iterationNumber);
+    hash = hash * 31 + hasher(key.generationNumber);
+    return hash;
+}
+
+bool Learn::ObservationCache::isEnabled() const
+{
+    return this->maxMemorySize > 0;
+}
+
+void Learn::ObservationCache::evictLeastRecentlyUsed()
+{
+    auto iter = this->lru.end();
+    while (this->memorySize > this->maxMemorySize &&
+           iter != this->lru.begin()) {
+        iter--;
+        auto entry = this->entries.find(*iter);
+        // Streams being recorded have no footprint yet, and are kept.
+        if (entry->second.memorySize == 0) {
+            continue;
+        }
+        this->memorySize -= entry->second.memorySize;
+        this->entries.erase(entry);
+        iter = this->lru.erase(iter);
+    }
+}
+
+std::shared_ptr<const Learn::ObservationStream> Learn::ObservationCache::
+    getStream(const Key& key,
+              const std::function<std::shared_ptr<const ObservationStream>()>&
+                  record)
+{
+    std::promise<std::shared_ptr<const ObservationStream>> promise;
+    std::shared_future<std::shared_ptr<const ObservationStream>> cached;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto iter = this->entries.find(key);
+        if (iter != this->entries.end()) {
+            this->nbHits++;
+            // Move the key at the front of the lru list.
+            this->lru.splice(this->lru.begin(), this->lru,
+                             iter->second.lruPosition);
+            cached = iter->second.stream;
+        }
+        else {
+            // Insert an entry so that concurrent calls wait for this
+            // recording.
+            this->nbMisses++;
+            this->lru.push_front(key);
+            this->entries.emplace(key, Entry{promise.get_future().share(), 0,
+                                             this->lru.begin()});
+        }
+    }
+
+    // Wait outside of the lock if the stream is being recorded.
+    if (cached.valid()) {
+        return cached.get();
+    }
+
+    std::shared_ptr<const ObservationStream> stream;
+    try {
+        stream = record();
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto iter = this->entries.find(key);
+        if (iter != this->entries.end()) {
+            this->lru.erase(iter->second.lruPosition);
+            this->entries.erase(iter);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+    promise.set_value(stream);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto iter = this->entries.find(key);
+    // The entry may have been removed by clear() during the recording.
+    if (iter != this->entries.end()) {
+        if (stream->memorySize > this->maxMemorySize) {
+            // Too large to be cached, even alone.
+            this->lru.erase(iter->second.lruPosition);
+            this->entries.erase(iter);
+        }
+        else {
+            // Non-empty streams are accounted for at least 1 byte, so that
+            // they are distinguished from the ones being recorded.
+            iter->second.memorySize = std::max(stream->memorySize, (size_t)1);
+            this->memorySize += iter->second.memorySize;
+            this->evictLeastRecentlyUsed();
+        }
+    }
+
+    return stream;
+}
+
+void Learn::ObservationCache::clear()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->entries.clear();
+    this->lru.clear();
+    this->memorySize = 0;
+}
+
+size_t Learn::ObservationCache::getMemorySize() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->memorySize;
+}
+
+size_t Learn::ObservationCache::getNbStreams() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->entries.size();
+}
+
+uint64_t Learn::ObservationCache::getNbHits() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->nbHits;
+}
+
+uint64_t Learn::ObservationCache::getNbMisses() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->nbMisses;
+}
+
+std::shared_ptr<const Learn::ObservationStream> Learn::ObservationCache::
+    recordStream(LearningEnvironment& le, const Instructions::Set& iSet,
+                 const Key& key, uint64_t maxNbActions)
+{
+    auto stream = std::make_shared<ObservationStream>();
+
+    le.reset(key.seed, key.mode, key.iterationNumber, key.generationNumber);
+    uint64_t nbActions = 0;
+    while (!le.isTerminal() && nbActions < maxNbActions) {
+        ObservationFrame frame;
+        frame.label = le.getObservationLabel();
+        for (const Data::DataHandler& dataSource : le.getDataSources()) {
+            std::shared_ptr<const Data::DataHandler> copy(dataSource.clone());
+
+            // Fill the lazily computed attributes of the copy, which are not
+            // protected against concurrent reads.
+            copy->getHash();
+            for (uint64_t i = 0; i < iSet.getNbInstructions(); i++) {
+                for (const std::type_info& type :
+                     iSet.getInstruction(i).getOperandTypes()) {
+                    copy->getAddressSpace(type);
+                }
+            }
+
+            stream->memorySize += copy->getLargestAddressSpace() * 8;
+            frame.dataSources.push_back(*copy);
+            frame.copies.push_back(copy);
+        }
+        stream->frames.push_back(std::move(frame));
+
+        // Observations do not depend on the action.
+        le.doAction(0);
+        nbActions++;
+    }
+
+    return stream;
+}
@@ -36,26 +36,37 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
 #include <iterator>
+#include <map>
+#include <numeric>
 #include <mutex>
 #include <queue>
+#include <set>
 #include <thread>
+#include <typeinfo>
 
 #include "mutator/rng.h"
 #include "mutator/tpgMutator.h"
+#include "tpg/tpgAction.h"
+#include "tpg/tpgEdge.h"
 #include "tpg/tpgExecutionEngine.h"
+#include "tpg/tpgFactory.h"
+#include "util/profiler.h"
 
 #include "learn/evaluationResult.h"
 #include "learn/parallelLearningAgent.h"
 
-std::multimap<std::shared_ptr<Learn::EvaluationResult>, const TPG::TPGVertex*>
-Learn::ParallelLearningAgent::evaluateAllRoots(uint64_t generationNumber,
-                                               Learn::LearningMode mode)
+Learn::ResultsTable Learn::ParallelLearningAgent::evaluateAllRoots(
+    uint64_t generationNumber, Learn::LearningMode mode)
 {
-    std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>
-        results;
+    ResultsTable results;
 
-    if (this->maxNbThreads <= 1 || !this->learningEnvironment.isCopyable()) {
+    if ((this->maxNbThreads <= 1 && !this->canInterleaveEpisodes()) ||
+        !this->learningEnvironment.isCopyable()) {
         // Sequential mode
 
         // Create the TPGExecutionEngine
@@ -64,16 +75,30 @@ Learn::ParallelLearningAgent::evaluateAllRoots(uint64_t generationNumber,
                 this->env,
                 (mode == LearningMode::TRAINING) ? &this->archive : NULL);
 
-        // Execute for all root
-        auto roots = this->tpg->getRootVertices();
-        for (int i = 0; i < roots.size(); i++) {
-            auto job = makeJob(roots.at(i), mode);
+        // Execute all jobs, split as in parallel mode for determinism
+        auto rootJobs = makeJobs(mode);
+        auto jobs = splitJobs(rootJobs, mode);
+        std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>,
+                                     std::shared_ptr<Job>>>
+            resultsPerJobMap;
+        while (!jobs.empty()) {
+            std::shared_ptr<Job> job = jobs.front();
+            jobs.pop();
 
             this->archive.setRandomSeed(job->getArchiveSeed());
 
+            GEGELATI_PROFILE_SCOPE("evaluateJob");
             std::shared_ptr<EvaluationResult> avgScore = this->evaluateJob(
                 *tee, *job, generationNumber, mode, this->learningEnvironment);
-            results.emplace(avgScore, (*job).getRoot());
+            resultsPerJobMap.emplace(job->getIdx(),
+                                     std::make_pair(avgScore, job));
+        }
+        foldPartialResults(resultsPerJobMap, mode);
+
+        results.reserve(resultsPerJobMap.size());
+        for (const auto& resultPerJob : resultsPerJobMap) {
+            results.addRow(resultPerJob.second.second->getRoot(),
+                           resultPerJob.second.first);
         }
     }
     else {
@@ -84,78 +109,371 @@ Learn::ParallelLearningAgent::evaluateAllRoots(uint64_t generationNumber,
     return results;
 }
 
+Learn::ResultsTable Learn::ParallelLearningAgent::evaluateValidationSnapshot(
+    const TPG::TPGGraph& snapshot,
+    const std::vector<const TPG::TPGVertex*>& snapshotRoots,
+    const std::vector<const TPG::TPGVertex*>& roots,
+    uint64_t generationNumber) const
+{
+    size_t nbThreads =
+        std::min((size_t)this->maxNbThreads, (size_t)roots.size());
+    if (nbThreads <= 1) {
+        return LearningAgent::evaluateValidationSnapshot(
+            snapshot, snapshotRoots, roots, generationNumber);
+    }
+
+    std::vector<std::shared_ptr<EvaluationResult>> evaluations(roots.size());
+    std::vector<std::exception_ptr> errors(nbThreads);
+    std::atomic<size_t> nextRoot{0};
+
+    auto evaluateRoots = [&](size_t threadIdx) {
+        try {
+            int cpu = this->affinity.getCPU(threadIdx);
+            if (cpu >= 0 && !Util::ThreadAffinity::pinCurrentThread(cpu)) {
+                std::lock_guard<std::mutex> lock(this->nodeThroughputMutex);
+                this->nodeThroughput[this->affinity.getCurrentNode()]
+                    .nbPinningFailures++;
+            }
+            std::unique_ptr<LearningEnvironment> le(
+                this->learningEnvironment.clone());
+            Environment privateEnv(this->env.getInstructionSet(),
+                                   le->getDataSources(),
+                                   this->env.getNbRegisters(),
+                                   this->env.getNbConstant());
+            std::unique_ptr<TPG::TPGExecutionEngine> tee =
+                snapshot.getFactory().createTPGExecutionEngine(privateEnv,
+                                                               NULL);
+            size_t idx;
+            while ((idx = nextRoot++) < roots.size()) {
+                Job job(snapshotRoots.at(idx), 0, idx);
+                evaluations.at(idx) =
+                    this->evaluateJob(*tee, job, generationNumber,
+                                      LearningMode::VALIDATION, *le);
+            }
+        }
+        catch (...) {
+            errors.at(threadIdx) = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nbThreads; i++) {
+        threads.emplace_back(evaluateRoots, i);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    ResultsTable results;
+    results.reserve(roots.size());
+    for (size_t i = 0; i < roots.size(); i++) {
+        results.addRow(roots.at(i), evaluations.at(i));
+    }
+    return results;
+}
+
+std::queue<std::vector<std::shared_ptr<Learn::Job>>> Learn::
+    ParallelLearningAgent::scheduleJobs(
+        std::queue<std::shared_ptr<Learn::Job>>& jobs)
+{
+    // Estimate the cost of jobs, and keep only costs of current roots
+    std::map<const TPG::TPGVertex*, double> currentCosts;
+    double knownCost = 0.0;
+    for (const auto& cost : this->rootCosts) {
+        knownCost += cost.second;
+    }
+    double defaultCost = (this->rootCosts.empty())
+                             ? 1.0
+                             : knownCost / (double)this->rootCosts.size();
+
+    std::vector<std::shared_ptr<Learn::Job>> orderedJobs;
+    std::vector<double> costs;
+    while (!jobs.empty()) {
+        const TPG::TPGVertex* root = jobs.front()->getRoot();
+        // Roots created by populateTPG may reuse the address of a removed
+        // root, so their parent is checked first.
+        auto parent = this->rootParents.find(root);
+        auto cost = this->rootCosts.find(
+            (parent != this->rootParents.end()) ? parent->second : root);
+        double rootCost =
+            (cost != this->rootCosts.end()) ? cost->second : defaultCost;
+        currentCosts[root] = rootCost;
+
+        // Partial jobs only cost their share of the iterations
+        double jobCost = rootCost;
+        if (jobs.front()->isPartial()) {
+            jobCost *= (double)jobs.front()->getNbIterations() /
+                       (double)this->params.nbIterationsPerPolicyEvaluation;
+        }
+
+        orderedJobs.push_back(jobs.front());
+        costs.push_back(jobCost);
+        jobs.pop();
+    }
+    this->rootCosts = std::move(currentCosts);
+
+    // Group consecutive cheap jobs so that a chunk does not exceed a fraction
+    // of the average work per thread.
+    double totalCost = std::accumulate(costs.begin(), costs.end(), 0.0);
+    double maxChunkCost =
+        totalCost / (double)(4 * std::max((uint64_t)1, this->maxNbThreads));
+
+    std::vector<std::vector<std::shared_ptr<Learn::Job>>> chunks;
+    std::vector<double> chunkCosts;
+    for (size_t i = 0; i < orderedJobs.size(); i++) {
+        if (chunks.empty() ||
+            chunkCosts.back() + costs.at(i) > maxChunkCost) {
+            chunks.emplace_back();
+            chunkCosts.push_back(0.0);
+        }
+        chunks.back().push_back(orderedJobs.at(i));
+        chunkCosts.back() += costs.at(i);
+    }
+
+    // Longest processing time first
+    std::vector<size_t> order(chunks.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return chunkCosts.at(a) > chunkCosts.at(b);
+    });
+
+    std::queue<std::vector<std::shared_ptr<Learn::Job>>> scheduledJobs;
+    for (size_t idx : order) {
+        scheduledJobs.push(std::move(chunks.at(idx)));
+    }
+    return scheduledJobs;
+}
+
 void Learn::ParallelLearningAgent::slaveEvalJobThread(
     uint64_t generationNumber, Learn::LearningMode mode,
-    std::queue<std::shared_ptr<Learn::Job>>& jobsToProcess,
+    std::queue<std::vector<std::shared_ptr<Learn::Job>>>& jobsToProcess,
     std::mutex& rootsToProcessMutex,
     std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>,
                                  std::shared_ptr<Job>>>& resultsPerRootMap,
     std::mutex& resultsPerRootMapMutex,
     std::map<uint64_t, Archive*>& archiveMap, std::mutex& archiveMapMutex,
-    bool useMainEnvironment)
+    bool useMainEnvironment, int cpu, std::map<int, GraphReplica>* replicas)
 {
+    // Pin the thread before cloning, so that the clone is allocated on the
+    // NUMA node of the thread. The main thread gets its CPUs back once its
+    // jobs are done.
+    Util::ThreadAffinity::ScopedPin pin(cpu);
+    bool pinned = pin.isPinned();
+    // Node where the thread actually runs if it could not be pinned.
+    int node = pinned ? this->affinity.getNode(cpu)
+                      : this->affinity.getCurrentNode();
+    GEGELATI_PROFILE_SCOPE_IN(
+        "evaluationThread",
+        (mode == LearningMode::TRAINING) ? "evaluate" : "validate");
 
     // Clone learningEnvironment
     LearningEnvironment* privateLearningEnvironment =
         useMainEnvironment ? &this->learningEnvironment
                            : this->learningEnvironment.clone();
 
-    // Create a TPGExecutionEngine
-    Environment privateEnv(this->env.getInstructionSet(),
-                           privateLearningEnvironment->getDataSources(),
-                           this->env.getNbRegisters(),
-                           this->env.getNbConstant());
-    std::unique_ptr<TPG::TPGExecutionEngine> tee =
-        this->tpg->getFactory().createTPGExecutionEngine(privateEnv, NULL);
+    // Durations of evaluations done by this thread
+    std::vector<std::pair<const TPG::TPGVertex*, double>> durations;
+    NodeThroughput throughput;
+
+    // Store the result of an evaluated job
+    auto storeResult = [&](const std::shared_ptr<Learn::Job>& job,
+                           std::shared_ptr<EvaluationResult> result,
+                           double duration) {
+        throughput.nbJobs++;
+        throughput.nbIterations +=
+            job->isPartial() ? job->getNbIterations()
+                             : this->params.nbIterationsPerPolicyEvaluation;
+        throughput.duration += duration;
 
-    int i = 0;
-    // Pop a job
-    while (!jobsToProcess.empty()) { // Thread safe access to size
-        i++;
-        bool doProcess = false;
-        std::shared_ptr<Learn::Job> jobToProcess;
-        { // Mutuel exclusion zone
-            std::lock_guard<std::mutex> lock(rootsToProcessMutex);
-            if (!jobsToProcess.empty()) { // Additional verification after lock
-                jobToProcess = jobsToProcess.front();
-                jobsToProcess.pop();
-                doProcess = true;
+        // Costs are stored for a complete evaluation of the root
+        if (job->isPartial()) {
+            duration *= (double)this->params.nbIterationsPerPolicyEvaluation /
+                        (double)job->getNbIterations();
+        }
+        durations.emplace_back(job->getRoot(), duration);
+
+        { // Store result Mutual exclusion zone
+            std::lock_guard<std::mutex> lock(resultsPerRootMapMutex);
+            resultsPerRootMap.emplace(job->getIdx(),
+                                      std::make_pair(result, job));
+        }
+    };
+
+    if (this->canInterleaveEpisodes()) {
+        // Each episode in flight uses its own LearningEnvironment
+        std::vector<std::unique_ptr<LearningEnvironment>> clones;
+        std::vector<LearningEnvironment*> envs{privateLearningEnvironment};
+        for (size_t i = 1; i < this->params.nbEpisodesInFlight; i++) {
+            clones.emplace_back(this->learningEnvironment.clone());
+            envs.push_back(clones.back().get());
+        }
+
+        // Jobs of popped chunks, not yet started
+        std::queue<std::shared_ptr<Learn::Job>> pendingJobs;
+        std::map<const Learn::Job*, std::chrono::steady_clock::time_point>
+            startTimes;
+
+        auto nextJob = [&]() -> std::shared_ptr<Learn::Job> {
+            if (pendingJobs.empty()) {
+                std::lock_guard<std::mutex> lock(rootsToProcessMutex);
+                if (!jobsToProcess.empty()) {
+                    for (auto& job : jobsToProcess.front()) {
+                        pendingJobs.push(job);
+                    }
+                    jobsToProcess.pop();
+                }
             }
-        } // End of mutual exclusion zone
-
-        // Processing to do?
-        if (doProcess) {
-            doProcess = false;
-            // Dedicated archive for the root
-            Archive* temporaryArchive = NULL;
-            if (mode == LearningMode::TRAINING) {
-                temporaryArchive =
-                    new Archive(params.archiveSize, params.archivingProbability,
-                                jobToProcess->getArchiveSeed());
+            if (pendingJobs.empty()) {
+                return nullptr;
             }
-            tee->setArchive(temporaryArchive);
+            std::shared_ptr<Learn::Job> job = pendingJobs.front();
+            pendingJobs.pop();
+            startTimes[job.get()] = std::chrono::steady_clock::now();
+            return job;
+        };
 
-            std::shared_ptr<EvaluationResult> avgScore =
-                this->evaluateJob(*tee, *jobToProcess, generationNumber, mode,
-                                  *privateLearningEnvironment);
-
-            { // Store result Mutual exclusion zone
-                std::lock_guard<std::mutex> lock(resultsPerRootMapMutex);
-                resultsPerRootMap.emplace(
-                    jobToProcess->getIdx(),
-                    std::make_pair(avgScore, jobToProcess));
+        // Jobs are interleaved, so each job has its own Archive
+        auto archiveForJob = [&](const Learn::Job& job) -> Archive* {
+            if (mode != LearningMode::TRAINING) {
+                return NULL;
             }
+            Archive* archive =
+                new Archive(params.archiveSize, params.archivingProbability,
+                            job.getArchiveSeed());
+            std::lock_guard<std::mutex> lock(archiveMapMutex);
+            archiveMap.insert({job.getIdx(), archive});
+            return archive;
+        };
+
+        auto jobDone = [&](const std::shared_ptr<Learn::Job>& job,
+                           std::shared_ptr<EvaluationResult> result) {
+            auto startTime = startTimes.find(job.get());
+            storeResult(job, result,
+                        std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() -
+                            startTime->second)
+                            .count());
+            startTimes.erase(startTime);
+        };
+
+        GEGELATI_PROFILE_SCOPE("evaluateJobsInterleaved");
+        this->evaluateJobsInterleaved(generationNumber, mode, envs, nextJob,
+                                      archiveForJob, jobDone);
+    }
+    else {
+        // Create a TPGExecutionEngine
+        Environment privateEnv(this->env.getInstructionSet(),
+                               privateLearningEnvironment->getDataSources(),
+                               this->env.getNbRegisters(),
+                               this->env.getNbConstant());
+        std::unique_ptr<TPG::TPGExecutionEngine> tee =
+            this->tpg->getFactory().createTPGExecutionEngine(privateEnv, NULL);
+
+        // Replica of the TPGGraph of the node, built by its first thread.
+        GraphReplica* replica = nullptr;
+        if (replicas != nullptr && replicas->count(node) != 0) {
+            replica = &replicas->at(node);
+            std::call_once(replica->built, [&]() {
+                replica->graph =
+                    this->copyTPGGraph(replica->vertices, &replica->programs);
+                throughput.nbReplicas++;
+            });
+        }
+
+        // Pop a chunk of jobs
+        while (!jobsToProcess.empty()) { // Thread safe access to size
+            bool doProcess = false;
+            std::vector<std::shared_ptr<Learn::Job>> chunkToProcess;
+            { // Mutuel exclusion zone
+                std::lock_guard<std::mutex> lock(rootsToProcessMutex);
+                // Additional verification after lock
+                if (!jobsToProcess.empty()) {
+                    chunkToProcess = std::move(jobsToProcess.front());
+                    jobsToProcess.pop();
+                    doProcess = true;
+                }
+            } // End of mutual exclusion zone
+
+            // Processing to do?
+            if (doProcess) {
+                doProcess = false;
+                // Dedicated archive for the chunk. Jobs of a chunk are
+                // consecutive, so reseeding a single Archive for each job
+                // gives the same recordings as one Archive per job.
+                Archive* temporaryArchive = NULL;
+                if (mode == LearningMode::TRAINING) {
+                    temporaryArchive = new Archive(
+                        params.archiveSize, params.archivingProbability,
+                        chunkToProcess.front()->getArchiveSeed());
+                }
+                tee->setArchive(temporaryArchive);
+
+                for (const std::shared_ptr<Learn::Job>& jobToProcess :
+                     chunkToProcess) {
+                    if (temporaryArchive != NULL) {
+                        temporaryArchive->setRandomSeed(
+                            jobToProcess->getArchiveSeed());
+                    }
+
+                    // Results of the copy stay associated to the root.
+                    Learn::Job& job = *jobToProcess;
+                    if (replica != nullptr && typeid(job) == typeid(Job)) {
+                        job.setExecutedRoot(
+                            replica->vertices.at(job.getRoot()));
+                    }
 
-            if (mode == LearningMode::TRAINING) {
-                { // Insertion archiveMap update mutual exclusion zone
-                    std::lock_guard<std::mutex> lock(archiveMapMutex);
-                    archiveMap.insert(
-                        {jobToProcess->getIdx(), temporaryArchive});
+                    auto startTime = std::chrono::steady_clock::now();
+                    GEGELATI_PROFILE_SCOPE("evaluateJob");
+                    std::shared_ptr<EvaluationResult> avgScore =
+                        this->evaluateJob(*tee, job, generationNumber, mode,
+                                          *privateLearningEnvironment);
+                    storeResult(jobToProcess, avgScore,
+                                std::chrono::duration<double>(
+                                    std::chrono::steady_clock::now() -
+                                    startTime)
+                                    .count());
+                }
+
+                if (mode == LearningMode::TRAINING) {
+                    if (replica != nullptr) {
+                        temporaryArchive->replacePrograms(replica->programs);
+                    }
+                    { // Insertion archiveMap update mutual exclusion zone
+                        std::lock_guard<std::mutex> lock(archiveMapMutex);
+                        archiveMap.insert({chunkToProcess.front()->getIdx(),
+                                           temporaryArchive});
+                    }
                 }
             }
         }
     }
 
+    // Store the throughput of the thread
+    {
+        std::lock_guard<std::mutex> lock(this->nodeThroughputMutex);
+        NodeThroughput& nodeTotal = this->nodeThroughput[node];
+        nodeTotal.nbJobs += throughput.nbJobs;
+        nodeTotal.nbIterations += throughput.nbIterations;
+        nodeTotal.duration += throughput.duration;
+        nodeTotal.nbReplicas += throughput.nbReplicas;
+        if (cpu >= 0 && !pinned) {
+            nodeTotal.nbPinningFailures++;
+        }
+    }
+
+    // Store measured costs
+    if (mode == LearningMode::TRAINING) {
+        std::lock_guard<std::mutex> lock(this->rootCostsMutex);
+        for (const auto& duration : durations) {
+            this->rootCosts[duration.first] = duration.second;
+        }
+    }
+
     // Clean up
     if (!useMainEnvironment) {
         delete privateLearningEnvironment;
@@ -213,9 +531,7 @@ void Learn::ParallelLearningAgent::mergeArchiveMap(
 }
 
 void Learn::ParallelLearningAgent::evaluateAllRootsInParallel(
-    uint64_t generationNumber, LearningMode mode,
-    std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>&
-        results)
+    uint64_t generationNumber, LearningMode mode, ResultsTable& results)
 {
     // Create Archive Map
     std::map<uint64_t, Archive*> archiveMap;
@@ -239,48 +555,500 @@ void Learn::ParallelLearningAgent::evaluateAllRootsInParallelExecute(
     // Create and fill the queue for distributing work among threads
     // each root is associated to its number in the list for enabling the
     // determinism of stochastic archive storage.
-    auto jobsToProcess = makeJobs(mode);
+    auto rootJobs = makeJobs(mode);
+    auto jobs = splitJobs(rootJobs, mode);
+
+    executeJobsInParallel(generationNumber, mode, jobs, resultsPerJobMap,
+                          archiveMap);
+
+    foldPartialResults(resultsPerJobMap, mode);
+}
+
+void Learn::ParallelLearningAgent::executeJobsInParallel(
+    uint64_t generationNumber, LearningMode mode,
+    std::queue<std::shared_ptr<Learn::Job>>& jobs,
+    std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>,
+                                 std::shared_ptr<Job>>>& resultsPerJobMap,
+    std::map<uint64_t, Archive*>& archiveMap)
+{
+    auto jobsToProcess = this->scheduleJobs(jobs);
 
     // Create mutexes
     std::mutex rootsToProcessMutex;
     std::mutex resultsPerRootMutex;
     std::mutex archiveMapMutex;
 
-    // Create the threads
+    // A replica of the TPGGraph for each NUMA node of the threads, if there
+    // are several. Graphs built by other factories may record their
+    // executions in their vertices and edges, and are never replicated.
+    std::map<int, GraphReplica> replicas;
+    if (this->affinity.getPolicy() != Util::ThreadAffinity::Policy::NONE &&
+        typeid(this->tpg->getFactory()) == typeid(TPG::TPGFactory)) {
+        for (uint64_t i = 0; i < this->maxNbThreads; i++) {
+            replicas[this->affinity.getNode(this->affinity.getCPU(i))];
+        }
+    }
+    std::map<int, GraphReplica>* usedReplicas =
+        (replicas.size() > 1) ? &replicas : nullptr;
+
+    // Create the threads. The main thread is the worker of index 0.
     std::vector<std::thread> threads;
-    for (auto i = 0; i < (this->maxNbThreads - 1); i++) {
+    for (uint64_t i = 1; i < this->maxNbThreads; i++) {
         threads.emplace_back(std::thread(
             &ParallelLearningAgent::slaveEvalJobThread, this, generationNumber,
             mode, std::ref(jobsToProcess), std::ref(rootsToProcessMutex),
             std::ref(resultsPerJobMap), std::ref(resultsPerRootMutex),
-            std::ref(archiveMap), std::ref(archiveMapMutex), false));
+            std::ref(archiveMap), std::ref(archiveMapMutex), false,
+            this->affinity.getCPU(i), usedReplicas));
     }
 
     // Work in the main thread also, using the main environment
     this->slaveEvalJobThread(generationNumber, mode, jobsToProcess,
                              rootsToProcessMutex, resultsPerJobMap,
                              resultsPerRootMutex, archiveMap, archiveMapMutex,
-                             true);
+                             true, this->affinity.getCPU(0), usedReplicas);
 
     // Join the threads
+    GEGELATI_PROFILE_SCOPE("joinWorkers");
     for (auto& thread : threads) {
         thread.join();
     }
 }
 
+std::queue<std::shared_ptr<Learn::Job>> Learn::ParallelLearningAgent::
+    splitJobs(std::queue<std::shared_ptr<Learn::Job>>& jobs,
+              Learn::LearningMode mode) const
+{
+    const uint64_t nbIterations = this->params.nbIterationsPerPolicyEvaluation;
+    const uint64_t maxNbIterationsPerJob = this->params.maxNbIterationsPerJob;
+    if (maxNbIterationsPerJob == 0 || maxNbIterationsPerJob >= nbIterations) {
+        return std::move(jobs);
+    }
+
+    std::queue<std::shared_ptr<Learn::Job>> splitJobs;
+    uint64_t idx = 0;
+    while (!jobs.empty()) {
+        std::shared_ptr<Learn::Job> job = jobs.front();
+        jobs.pop();
+
+        // Only single-root jobs are split
+        if (typeid(*job) != typeid(Learn::Job)) {
+            splitJobs.push(job);
+            continue;
+        }
+
+        // Roots whose evaluation is skipped are kept in a single job
+        std::shared_ptr<EvaluationResult> previousResult;
+        if (mode == LearningMode::TRAINING &&
+            this->isRootEvalSkipped(*job->getRoot(), previousResult)) {
+            splitJobs.push(std::make_shared<Learn::Job>(
+                job->getRoot(), job->getArchiveSeed(), idx++));
+            continue;
+        }
+
+        for (uint64_t first = 0; first < nbIterations;
+             first += maxNbIterationsPerJob) {
+            splitJobs.push(std::make_shared<Learn::Job>(
+                job->getRoot(), job->getArchiveSeed() + first, idx++, first,
+                std::min(maxNbIterationsPerJob, nbIterations - first)));
+        }
+    }
+
+    return splitJobs;
+}
+
+void Learn::ParallelLearningAgent::foldPartialResults(
+    std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>,
+                                 std::shared_ptr<Job>>>& resultsPerJobMap,
+    Learn::LearningMode mode) const
+{
+    auto iter = resultsPerJobMap.begin();
+    while (iter != resultsPerJobMap.end()) {
+        const std::shared_ptr<Job>& job = iter->second.second;
+        if (!job->isPartial()) {
+            iter++;
+            continue;
+        }
+
+        // Partial results are folded into the first one, in the order of
+        // iterations.
+        std::shared_ptr<EvaluationResult> foldedResult = iter->second.first;
+        auto next = std::next(iter);
+        while (next != resultsPerJobMap.end() &&
+               next->second.second->isPartial() &&
+               next->second.second->getFirstIteration() != 0 &&
+               next->second.second->getRoot() == job->getRoot()) {
+            *foldedResult += *next->second.first;
+            next = resultsPerJobMap.erase(next);
+        }
+
+        // Combine with previous results of the root, as done by evaluateJob
+        // for complete jobs.
+        std::shared_ptr<EvaluationResult> previousResult;
+        if (mode == LearningMode::TRAINING) {
+            this->isRootEvalSkipped(*job->getRoot(), previousResult);
+            if (previousResult != nullptr) {
+                *foldedResult += *previousResult;
+            }
+        }
+
+        iter = next;
+    }
+}
+
+std::map<int, Learn::ParallelLearningAgent::NodeThroughput> Learn::
+    ParallelLearningAgent::getNodeThroughput() const
+{
+    std::lock_guard<std::mutex> lock(this->nodeThroughputMutex);
+    return this->nodeThroughput;
+}
+
+void Learn::ParallelLearningAgent::resetNodeThroughput()
+{
+    std::lock_guard<std::mutex> lock(this->nodeThroughputMutex);
+    this->nodeThroughput.clear();
+}
+
+std::shared_ptr<Learn::EvaluationResult> Learn::ParallelLearningAgent::
+    evaluateOneRoot(uint64_t generationNumber, Learn::LearningMode mode,
+                    const TPG::TPGVertex* root)
+{
+    if (this->maxNbThreads <= 1 || !this->learningEnvironment.isCopyable() ||
+        this->params.maxNbIterationsPerJob == 0) {
+        return LearningAgent::evaluateOneRoot(generationNumber, mode, root);
+    }
+
+    // Check the existence of the root TPGVertex
+    const std::vector<const TPG::TPGVertex*> vertices = tpg->getVertices();
+    if (std::find(vertices.begin(), vertices.end(), root) == vertices.end()) {
+        throw std::runtime_error("The vertex to evaluate does not exist in the "
+                                 "TPGGraph of the LearningAgent.");
+    }
+
+    // Split the iterations of the root among threads
+    std::queue<std::shared_ptr<Learn::Job>> rootJob;
+    rootJob.push(makeJob(root, mode));
+    auto jobs = splitJobs(rootJob, mode);
+
+    std::map<uint64_t, Archive*> archiveMap;
+    std::map<uint64_t,
+             std::pair<std::shared_ptr<EvaluationResult>, std::shared_ptr<Job>>>
+        resultsPerJobMap;
+    executeJobsInParallel(generationNumber, mode, jobs, resultsPerJobMap,
+                          archiveMap);
+    foldPartialResults(resultsPerJobMap, mode);
+
+    if (mode == LearningMode::TRAINING) {
+        mergeArchiveMap(archiveMap);
+    }
+
+    return resultsPerJobMap.begin()->second.first;
+}
+
 void Learn::ParallelLearningAgent::evaluateAllRootsInParallelCompileResults(
     std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>,
                                  std::shared_ptr<Job>>>& resultsPerJobMap,
-    std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>&
-        results,
-    std::map<uint64_t, Archive*>& archiveMap)
+    ResultsTable& results, std::map<uint64_t, Archive*>& archiveMap)
 {
-    // Merge the results
-    for (auto& resultPerRoot : resultsPerJobMap) {
-        results.emplace(resultPerRoot.second.first,
-                        (*resultPerRoot.second.second).getRoot());
+    // Merge the results, in the order of job indexes
+    {
+        GEGELATI_PROFILE_SCOPE("mergeResults");
+        results.reserve(resultsPerJobMap.size());
+        for (auto& resultPerRoot : resultsPerJobMap) {
+            results.addRow((*resultPerRoot.second.second).getRoot(),
+                           resultPerRoot.second.first);
+        }
     }
 
     // Merge the archives
+    GEGELATI_PROFILE_SCOPE("mergeArchives");
     this->mergeArchiveMap(archiveMap);
 }
+
+void Learn::ParallelLearningAgent::slaveSteadyStateThread(
+    std::queue<std::pair<std::shared_ptr<Job>, uint64_t>>& pendingJobs,
+    std::queue<std::tuple<std::shared_ptr<Job>,
+                          std::shared_ptr<EvaluationResult>, Archive*>>&
+        completedJobs,
+    std::mutex& jobsMutex, std::condition_variable& pendingCondition,
+    std::condition_variable& completedCondition, const bool& stop)
+{
+    // Clone learningEnvironment
+    LearningEnvironment* privateLearningEnvironment =
+        this->learningEnvironment.clone();
+
+    // Create a TPGExecutionEngine
+    Environment privateEnv(this->env.getInstructionSet(),
+                           privateLearningEnvironment->getDataSources(),
+                           this->env.getNbRegisters(),
+                           this->env.getNbConstant());
+    std::unique_ptr<TPG::TPGExecutionEngine> tee =
+        this->tpg->getFactory().createTPGExecutionEngine(privateEnv, NULL);
+
+    while (true) {
+        std::pair<std::shared_ptr<Job>, uint64_t> pendingJob;
+        { // Wait for a job, or for the end of the training
+            std::unique_lock<std::mutex> lock(jobsMutex);
+            pendingCondition.wait(
+                lock, [&]() { return stop || !pendingJobs.empty(); });
+            if (stop) {
+                break;
+            }
+            pendingJob = pendingJobs.front();
+            pendingJobs.pop();
+        }
+
+        // Dedicated archive for the job
+        Archive* temporaryArchive =
+            new Archive(params.archiveSize, params.archivingProbability,
+                        pendingJob.first->getArchiveSeed());
+        tee->setArchive(temporaryArchive);
+
+        std::shared_ptr<EvaluationResult> avgScore = this->evaluateJob(
+            *tee, *pendingJob.first, pendingJob.second, LearningMode::TRAINING,
+            *privateLearningEnvironment);
+
+        { // Store result
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            completedJobs.emplace(pendingJob.first, avgScore,
+                                  temporaryArchive);
+        }
+        completedCondition.notify_one();
+    }
+
+    // Clean up
+    delete privateLearningEnvironment;
+}
+
+uint64_t Learn::ParallelLearningAgent::trainSteadyState(
+    volatile bool& altTraining, uint64_t nbEvaluationsPerReport)
+{
+    // Number of root replacements equivalent to one generation
+    const uint64_t nbRootsPerGeneration = std::max(
+        (uint64_t)1, (uint64_t)floor(this->params.ratioDeletedRoots *
+                                     (double)params.mutation.tpg.nbRoots));
+    const uint64_t nbReplacementsMax =
+        this->params.nbGenerations * nbRootsPerGeneration;
+    if (nbEvaluationsPerReport == 0) {
+        nbEvaluationsPerReport = nbRootsPerGeneration;
+    }
+
+    // Parallel mode is only possible with a copyable environment.
+    const bool isParallel =
+        this->maxNbThreads > 1 && this->learningEnvironment.isCopyable();
+    const uint64_t nbWorkers = (isParallel) ? this->maxNbThreads : 1;
+
+    // Fill the initial population
+    Mutator::TPGMutator::populateTPG(
+        *this->tpg, this->archive, this->params.mutation, this->rng,
+        this->learningEnvironment.getNbActions(), this->maxNbThreads);
+
+    // Shared job queues
+    std::queue<std::pair<std::shared_ptr<Job>, uint64_t>> pendingJobs;
+    std::queue<std::tuple<std::shared_ptr<Job>,
+                          std::shared_ptr<EvaluationResult>, Archive*>>
+        completedJobs;
+    std::mutex jobsMutex;
+    std::condition_variable pendingCondition;
+    std::condition_variable completedCondition;
+    bool stop = false;
+
+    // Evaluated roots of the TPGGraph, candidates for replacement.
+    ResultsTable population;
+    // Roots whose evaluation is pending or ongoing.
+    std::set<const TPG::TPGVertex*> queuedRoots;
+
+    uint64_t nbEvaluations = 0;
+    uint64_t nbReplacements = 0;
+    uint64_t reportNumber = 0;
+    int jobIdx = 0;
+
+    auto queueJob = [&](const TPG::TPGVertex* root) {
+        if (queuedRoots.insert(root).second) {
+            auto job = this->makeJob(root, LearningMode::TRAINING, jobIdx++);
+            {
+                std::lock_guard<std::mutex> lock(jobsMutex);
+                pendingJobs.emplace(job, nbReplacements / nbRootsPerGeneration);
+            }
+            pendingCondition.notify_one();
+        }
+    };
+
+    auto recordResult =
+        [&](std::tuple<std::shared_ptr<Job>, std::shared_ptr<EvaluationResult>,
+                       Archive*>& completedJob) {
+            const TPG::TPGVertex* root = std::get<0>(completedJob)->getRoot();
+            queuedRoots.erase(root);
+
+            // Merge the archive of the job
+            std::map<uint64_t, Archive*> archiveMap{
+                {0, std::get<2>(completedJob)}};
+            this->mergeArchiveMap(archiveMap);
+
+            // Update the records
+            ResultsTable result;
+            result.addRow(root, std::get<1>(completedJob));
+            {
+                std::lock_guard<std::mutex> lock(this->resultsPerRootMutex);
+                this->updateEvaluationRecords(result);
+            }
+
+            // The root may have been subsumed by a new root in the meantime.
+            if (root->getIncomingEdges().empty()) {
+                population.addRow(root, std::get<1>(completedJob));
+            }
+        };
+
+    for (auto root : this->tpg->getRootVertices()) {
+        queueJob(root);
+    }
+
+    // Start the workers
+    std::vector<std::thread> threads;
+    if (isParallel) {
+        for (size_t i = 0; i < this->maxNbThreads; i++) {
+            threads.emplace_back(std::thread(
+                &ParallelLearningAgent::slaveSteadyStateThread, this,
+                std::ref(pendingJobs), std::ref(completedJobs),
+                std::ref(jobsMutex), std::ref(pendingCondition),
+                std::ref(completedCondition), std::cref(stop)));
+        }
+    }
+
+    // Sequential evaluation engine
+    std::unique_ptr<TPG::TPGExecutionEngine> tee;
+    if (!isParallel) {
+        tee = this->tpg->getFactory().createTPGExecutionEngine(this->env, NULL);
+    }
+
+    while (!altTraining && nbReplacements < nbReplacementsMax &&
+           !queuedRoots.empty()) {
+        // Get the next result
+        std::tuple<std::shared_ptr<Job>, std::shared_ptr<EvaluationResult>,
+                   Archive*>
+            completedJob;
+        if (isParallel) {
+            std::unique_lock<std::mutex> lock(jobsMutex);
+            completedCondition.wait(lock,
+                                    [&]() { return !completedJobs.empty(); });
+            completedJob = completedJobs.front();
+            completedJobs.pop();
+        }
+        else {
+            auto pendingJob = pendingJobs.front();
+            pendingJobs.pop();
+            Archive* temporaryArchive = new Archive(
+                params.archiveSize, params.archivingProbability,
+                pendingJob.first->getArchiveSeed());
+            tee->setArchive(temporaryArchive);
+            std::shared_ptr<EvaluationResult> avgScore = this->evaluateJob(
+                *tee, *pendingJob.first, pendingJob.second,
+                LearningMode::TRAINING, this->learningEnvironment);
+            completedJob =
+                std::make_tuple(pendingJob.first, avgScore, temporaryArchive);
+        }
+        recordResult(completedJob);
+        nbEvaluations++;
+
+        // Replace roots until enough jobs are pending to keep workers busy.
+        size_t nbPendingJobs;
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            nbPendingJobs = pendingJobs.size();
+        }
+        while (nbPendingJobs < nbWorkers &&
+               nbReplacements < nbReplacementsMax) {
+            // Remove the worst evaluated root team, if the population is full.
+            if (this->tpg->getNbRootVertices() >=
+                this->params.mutation.tpg.nbRoots) {
+                std::vector<size_t> sortedRows =
+                    this->getWorstRowsForSelection(population,
+                                                   population.size());
+                auto worstRow = std::find_if(
+                    sortedRows.begin(), sortedRows.end(), [&](size_t row) {
+                        return dynamic_cast<const TPG::TPGAction*>(
+                                   population.getRoot(row)) == nullptr;
+                    });
+                if (worstRow != sortedRows.end()) {
+                    const TPG::TPGVertex* root = population.getRoot(*worstRow);
+                    std::vector<const TPG::TPGVertex*> destinations;
+                    for (auto edge : root->getOutgoingEdges()) {
+                        destinations.push_back(edge->getDestination());
+                    }
+                    this->tpg->removeVertex(*root);
+                    {
+                        std::lock_guard<std::mutex> lock(
+                            this->resultsPerRootMutex);
+                        this->resultsPerRoot.erase(root);
+                    }
+                    std::vector<bool> removedRows(population.size(), false);
+                    removedRows.at(*worstRow) = true;
+                    population.removeRows(removedRows);
+
+                    // Evaluate vertices that became roots
+                    for (auto destination : destinations) {
+                        if (destination->getIncomingEdges().empty()) {
+                            queueJob(destination);
+                        }
+                    }
+                }
+            }
+
+            // Create a new root
+            const TPG::TPGTeam* newRoot =
+                Mutator::TPGMutator::addMutatedRootTeam(
+                    *this->tpg, this->archive, this->params.mutation,
+                    this->rng);
+            if (newRoot == nullptr) {
+                break;
+            }
+            queueJob(newRoot);
+            nbReplacements++;
+
+            // Forget evaluated roots subsumed by the new root
+            std::vector<bool> subsumedRows(population.size());
+            for (size_t row = 0; row < population.size(); row++) {
+                subsumedRows[row] =
+                    !population.getRoot(row)->getIncomingEdges().empty();
+            }
+            population.removeRows(subsumedRows);
+
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            nbPendingJobs = pendingJobs.size();
+        }
+
+        // Periodic report
+        if (nbEvaluations % nbEvaluationsPerReport == 0) {
+            this->updateBestScoreLastGen(population);
+            for (auto logger : loggers) {
+                logger.get().logSteadyStateReport(reportNumber, population);
+            }
+            reportNumber++;
+        }
+    }
+
+    // Stop the workers
+    if (isParallel) {
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            stop = true;
+        }
+        pendingCondition.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        // Record evaluations completed in the meantime
+        while (!completedJobs.empty()) {
+            recordResult(completedJobs.front());
+            completedJobs.pop();
+        }
+    }
+
+    // Make sure the bestRoot was not removed by the last replacements
+    if (!population.empty()) {
+        this->updateEvaluationRecords(population);
+    }
+
+    return nbReplacements / nbRootsPerGeneration;
+}
@@ -0,0 +1,350 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "learn/classificationEvaluationResult.h"
+
+#include "learn/resultsTable.h"
+
+bool Learn::ResultsTable::isRowWorse(size_t rowA, size_t rowB) const
+{
+    // Ties are broken with the row index to obtain a strict total order.
+    return (this->scores[rowA] < this->scores[rowB]) ||
+           (!(this->scores[rowB] < this->scores[rowA]) && rowA < rowB);
+}
+
+void Learn::ResultsTable::reserve(size_t nbRows)
+{
+    this->roots.reserve(nbRows);
+    this->evaluationResults.reserve(nbRows);
+    this->scores.reserve(nbRows);
+    this->nbEvaluations.reserve(nbRows);
+    this->inferenceCosts.reserve(nbRows);
+}
+
+size_t Learn::ResultsTable::addRow(
+    const TPG::TPGVertex* root, const std::shared_ptr<EvaluationResult>& result)
+{
+    // Copy scores per class, if any.
+    const ClassificationEvaluationResult* classifResult =
+        dynamic_cast<const ClassificationEvaluationResult*>(result.get());
+    if (classifResult != nullptr) {
+        const std::vector<double>& classScores =
+            classifResult->getScorePerClass();
+        if (this->nbClasses == 0) {
+            // First row with scores per class: pad previous rows.
+            this->nbClasses = classScores.size();
+            this->scoresPerClass.reserve(this->roots.capacity() *
+                                         this->nbClasses);
+            this->scoresPerClass.resize(this->roots.size() * this->nbClasses,
+                                        0.0);
+        }
+        if (classScores.size() != this->nbClasses) {
+            throw std::runtime_error("Number of classes of the "
+                                     "ClassificationEvaluationResult does not "
+                                     "match the ResultsTable.");
+        }
+        this->scoresPerClass.insert(this->scoresPerClass.end(),
+                                    classScores.begin(), classScores.end());
+    }
+    else {
+        this->scoresPerClass.resize(
+            (this->roots.size() + 1) * this->nbClasses, 0.0);
+    }
+
+    this->roots.push_back(root);
+    this->evaluationResults.push_back(result);
+    this->scores.push_back(result->getResult());
+    this->nbEvaluations.push_back(result->getNbEvaluation());
+    this->inferenceCosts.push_back(result->getInferenceCost());
+
+    return this->roots.size() - 1;
+}
+
+size_t Learn::ResultsTable::size() const
+{
+    return this->roots.size();
+}
+
+bool Learn::ResultsTable::empty() const
+{
+    return this->roots.empty();
+}
+
+void Learn::ResultsTable::clear()
+{
+    this->roots.clear();
+    this->evaluationResults.clear();
+    this->scores.clear();
+    this->nbEvaluations.clear();
+    this->inferenceCosts.clear();
+    this->scoresPerClass.clear();
+    this->nbClasses = 0;
+}
+
+const TPG::TPGVertex* Learn::ResultsTable::getRoot(size_t row) const
+{
+    return this->roots.at(row);
+}
+
+const std::shared_ptr<Learn::EvaluationResult>& Learn::ResultsTable::
+    getEvaluationResult(size_t row) const
+{
+    return this->evaluationResults.at(row);
+}
+
+double Learn::ResultsTable::getScore(size_t row) const
+{
+    return this->scores.at(row);
+}
+
+size_t Learn::ResultsTable::getNbEvaluation(size_t row) const
+{
+    return this->nbEvaluations.at(row);
+}
+
+double Learn::ResultsTable::getInferenceCost(size_t row) const
+{
+    return this->inferenceCosts.at(row);
+}
+
+size_t Learn::ResultsTable::getNbClasses() const
+{
+    return this->nbClasses;
+}
+
+double Learn::ResultsTable::getScorePerClass(size_t row, size_t classIdx) const
+{
+    if (classIdx >= this->nbClasses) {
+        throw std::out_of_range("Class index exceeds the number of classes "
+                                "of the ResultsTable.");
+    }
+    return this->scoresPerClass.at(row * this->nbClasses + classIdx);
+}
+
+const std::vector<const TPG::TPGVertex*>& Learn::ResultsTable::getRoots() const
+{
+    return this->roots;
+}
+
+const std::vector<double>& Learn::ResultsTable::getScores() const
+{
+    return this->scores;
+}
+
+size_t Learn::ResultsTable::findRow(const TPG::TPGVertex* root) const
+{
+    return std::distance(
+        this->roots.begin(),
+        std::find(this->roots.begin(), this->roots.end(), root));
+}
+
+size_t Learn::ResultsTable::getBestRow() const
+{
+    if (this->empty()) {
+        throw std::runtime_error("Cannot get the best row of an empty "
+                                 "ResultsTable.");
+    }
+
+    size_t best = 0;
+    for (size_t row = 1; row < this->size(); row++) {
+        if (this->isRowWorse(best, row)) {
+            best = row;
+        }
+    }
+    return best;
+}
+
+double Learn::ResultsTable::getMinScore() const
+{
+    return (this->empty())
+               ? 0.0
+               : *std::min_element(this->scores.begin(), this->scores.end());
+}
+
+double Learn::ResultsTable::getMaxScore() const
+{
+    return (this->empty())
+               ? 0.0
+               : *std::max_element(this->scores.begin(), this->scores.end());
+}
+
+double Learn::ResultsTable::getAvgScore() const
+{
+    return (this->empty()) ? 0.0
+                           : std::accumulate(this->scores.begin(),
+                                             this->scores.end(), 0.0) /
+                                 (double)this->size();
+}
+
+std::vector<size_t> Learn::ResultsTable::getSortedRows() const
+{
+    return this->getWorstRows(this->size());
+}
+
+std::vector<size_t> Learn::ResultsTable::getWorstRows(size_t nbRows) const
+{
+    std::vector<size_t> rows(this->size());
+    std::iota(rows.begin(), rows.end(), 0);
+    nbRows = std::min(nbRows, rows.size());
+
+    std::partial_sort(rows.begin(), rows.begin() + nbRows, rows.end(),
+                      [this](size_t a, size_t b) { return isRowWorse(a, b); });
+    rows.resize(nbRows);
+    return rows;
+}
+
+std::vector<size_t> Learn::ResultsTable::getWorstRows(size_t nbRows,
+                                                     double costPenalty) const
+{
+    std::vector<double> penalizedScores(this->size());
+    for (size_t row = 0; row < this->size(); row++) {
+        penalizedScores[row] =
+            this->scores[row] - costPenalty * this->inferenceCosts[row];
+    }
+
+    std::vector<size_t> rows(this->size());
+    std::iota(rows.begin(), rows.end(), 0);
+    nbRows = std::min(nbRows, rows.size());
+
+    std::partial_sort(rows.begin(), rows.begin() + nbRows, rows.end(),
+                      [this, &penalizedScores](size_t a, size_t b) {
+                          return (penalizedScores[a] < penalizedScores[b]) ||
+                                 (!(penalizedScores[b] < penalizedScores[a]) &&
+                                  isRowWorse(a, b));
+                      });
+    rows.resize(nbRows);
+    return rows;
+}
+
+std::vector<size_t> Learn::ResultsTable::getParetoWorstRows(
+    size_t nbRows, double costPenalty) const
+{
+    // Visit rows in descending order of score, and ascending order of cost
+    // for equal scores, so that a row can only be dominated by previously
+    // visited rows.
+    std::vector<size_t> visitOrder(this->size());
+    std::iota(visitOrder.begin(), visitOrder.end(), 0);
+    std::sort(visitOrder.begin(), visitOrder.end(), [this](size_t a, size_t b) {
+        return (this->scores[a] > this->scores[b]) ||
+               (!(this->scores[a] < this->scores[b]) &&
+                this->inferenceCosts[a] < this->inferenceCosts[b]);
+    });
+
+    // Assign each row to the first front with no row dominating it. The
+    // cheapest row of a front is its last visited row, and is the only one
+    // that needs to be checked.
+    std::vector<size_t> front(this->size());
+    std::vector<size_t> lastRowOfFront;
+    for (size_t row : visitOrder) {
+        size_t frontIdx = 0;
+        while (frontIdx < lastRowOfFront.size()) {
+            size_t last = lastRowOfFront[frontIdx];
+            bool isDominated =
+                (this->inferenceCosts[last] < this->inferenceCosts[row]) ||
+                (!(this->inferenceCosts[row] < this->inferenceCosts[last]) &&
+                 this->scores[last] > this->scores[row]);
+            if (!isDominated) {
+                break;
+            }
+            frontIdx++;
+        }
+        if (frontIdx == lastRowOfFront.size()) {
+            lastRowOfFront.push_back(row);
+        }
+        else {
+            lastRowOfFront[frontIdx] = row;
+        }
+        front[row] = frontIdx;
+    }
+
+    // Sort rows from the worst front, keeping the penalized score order
+    // within fronts.
+    std::vector<size_t> rows = this->getWorstRows(this->size(), costPenalty);
+    std::stable_sort(rows.begin(), rows.end(), [&front](size_t a, size_t b) {
+        return front[a] > front[b];
+    });
+    rows.resize(std::min(nbRows, rows.size()));
+    return rows;
+}
+
+std::vector<size_t> Learn::ResultsTable::getBestRows(size_t nbRows) const
+{
+    std::vector<size_t> rows(this->size());
+    std::iota(rows.begin(), rows.end(), 0);
+    nbRows = std::min(nbRows, rows.size());
+
+    std::partial_sort(rows.begin(), rows.begin() + nbRows, rows.end(),
+                      [this](size_t a, size_t b) { return isRowWorse(b, a); });
+    rows.resize(nbRows);
+    return rows;
+}
+
+void Learn::ResultsTable::removeRows(const std::vector<bool>& removedRows)
+{
+    if (removedRows.size() != this->size()) {
+        throw std::runtime_error("Size of the removed rows mask does not "
+                                 "match the ResultsTable.");
+    }
+
+    // Compact all columns in place, preserving the order of remaining rows.
+    size_t nextRow = 0;
+    for (size_t row = 0; row < this->size(); row++) {
+        if (removedRows[row]) {
+            continue;
+        }
+        if (nextRow != row) {
+            this->roots[nextRow] = this->roots[row];
+            this->evaluationResults[nextRow] =
+                std::move(this->evaluationResults[row]);
+            this->scores[nextRow] = this->scores[row];
+            this->nbEvaluations[nextRow] = this->nbEvaluations[row];
+            this->inferenceCosts[nextRow] = this->inferenceCosts[row];
+            for (size_t classIdx = 0; classIdx < this->nbClasses; classIdx++) {
+                this->scoresPerClass[nextRow * this->nbClasses + classIdx] =
+                    this->scoresPerClass[row * this->nbClasses + classIdx];
+            }
+        }
+        nextRow++;
+    }
+
+    this->roots.resize(nextRow);
+    this->evaluationResults.resize(nextRow);
+    this->scores.resize(nextRow);
+    this->nbEvaluations.resize(nextRow);
+    this->inferenceCosts.resize(nextRow);
+    this->scoresPerClass.resize(nextRow * this->nbClasses);
+}
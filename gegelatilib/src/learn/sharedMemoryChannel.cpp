@@ -0,0 +1,362 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <algorithm>
+#include <climits>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "learn/sharedMemoryChannel.h"
+
+/// Magic number of shared-memory regions ("GGLTSHM2").
+static const uint64_t SHARED_MEMORY_MAGIC = 0x324D48535454474CULL;
+
+/// Number of yields of a waiting process before it blocks.
+static const uint32_t NB_SPINS_BEFORE_BLOCKING = 1000;
+
+/// Maximum duration of a blocking wait between two liveness checks.
+static const std::chrono::nanoseconds LIVENESS_CHECK_PERIOD =
+    std::chrono::milliseconds(100);
+
+/**
+ * \brief Block until the value of an event differs from the expected one.
+ *
+ * The function may return early, for example on signals, so the caller
+ * must check the state of the ring again.
+ */
+static void waitEvent(std::atomic<uint32_t>& event, uint32_t expected,
+                      std::chrono::nanoseconds timeout)
+{
+#ifdef __linux__
+    struct timespec duration;
+    duration.tv_sec = timeout.count() / 1000000000;
+    duration.tv_nsec = timeout.count() % 1000000000;
+    // Not a private futex: the event is shared between processes.
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&event), FUTEX_WAIT,
+            expected, &duration, nullptr, 0);
+#else
+    // Without futex, poll the event with short sleeps.
+    if (event.load() == expected) {
+        std::this_thread::sleep_for(
+            std::min(timeout, std::chrono::nanoseconds(50000)));
+    }
+#endif
+}
+
+/// Wake all processes blocked on an event.
+static void wakeEvent(std::atomic<uint32_t>& event)
+{
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&event), FUTEX_WAKE,
+            INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+size_t Learn::SharedMemoryChannel::getObservationOffset()
+{
+    // Align the observation buffer on a cache line.
+    return (sizeof(Header) + 63) / 64 * 64;
+}
+
+Learn::SharedMemoryChannel::SharedMemoryChannel(const std::string& name,
+                                                uint64_t nbActions,
+                                                size_t observationSize)
+    : name{name}, header{nullptr}, regionSize{0}, owner{true}
+{
+#ifndef _WIN32
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::runtime_error("Could not create shared memory " + name);
+    }
+    this->regionSize = getObservationOffset() + observationSize;
+    if (ftruncate(fd, this->regionSize) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        throw std::runtime_error("Could not resize shared memory " + name);
+    }
+    void* mapping = mmap(nullptr, this->regionSize, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fd, 0);
+    // The mapping stays valid after closing the file descriptor.
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        throw std::runtime_error("Could not map shared memory " + name);
+    }
+
+    this->header = new (mapping) Header();
+    this->header->nbActions = nbActions;
+    this->header->observationSize = observationSize;
+    this->header->ownerPid = getpid();
+    this->header->peerPid = 0;
+    for (Ring* ring : {&this->header->requests, &this->header->responses}) {
+        ring->head = 0;
+        ring->tail = 0;
+        ring->event = 0;
+        ring->nbWaiters = 0;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    this->header->magic = SHARED_MEMORY_MAGIC;
+#else
+    throw std::runtime_error(
+        "Shared memory channels are not supported on this system.");
+#endif
+}
+
+Learn::SharedMemoryChannel::SharedMemoryChannel(const std::string& name)
+    : name{name}, header{nullptr}, regionSize{0}, owner{false}
+{
+#ifndef _WIN32
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open shared memory " + name);
+    }
+    struct stat regionStat;
+    if (fstat(fd, &regionStat) != 0 ||
+        (size_t)regionStat.st_size < getObservationOffset()) {
+        close(fd);
+        throw std::runtime_error("Invalid shared memory " + name);
+    }
+    this->regionSize = regionStat.st_size;
+    void* mapping = mmap(nullptr, this->regionSize, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Could not map shared memory " + name);
+    }
+
+    this->header = static_cast<Header*>(mapping);
+    if (this->header->magic != SHARED_MEMORY_MAGIC ||
+        getObservationOffset() + this->header->observationSize >
+            this->regionSize) {
+        munmap(mapping, this->regionSize);
+        this->header = nullptr;
+        throw std::runtime_error("Invalid shared memory " + name);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    this->header->peerPid = getpid();
+#else
+    throw std::runtime_error(
+        "Shared memory channels are not supported on this system.");
+#endif
+}
+
+Learn::SharedMemoryChannel::~SharedMemoryChannel()
+{
+#ifndef _WIN32
+    if (this->header != nullptr) {
+        munmap(this->header, this->regionSize);
+    }
+    if (this->owner) {
+        shm_unlink(this->name.c_str());
+    }
+#endif
+}
+
+const std::string& Learn::SharedMemoryChannel::getName() const
+{
+    return this->name;
+}
+
+uint64_t Learn::SharedMemoryChannel::getNbActions() const
+{
+    return this->header->nbActions;
+}
+
+size_t Learn::SharedMemoryChannel::getObservationSize() const
+{
+    return this->header->observationSize;
+}
+
+void* Learn::SharedMemoryChannel::getObservation() const
+{
+    return reinterpret_cast<char*>(this->header) + getObservationOffset();
+}
+
+bool Learn::SharedMemoryChannel::push(Ring& ring, const Message& message)
+{
+    uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+    if (tail - ring.head.load(std::memory_order_acquire) == RING_SIZE) {
+        return false;
+    }
+    ring.messages[tail % RING_SIZE] = message;
+    ring.tail.store(tail + 1, std::memory_order_release);
+    notify(ring);
+    return true;
+}
+
+bool Learn::SharedMemoryChannel::pop(Ring& ring, Message& message)
+{
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head == ring.tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    message = ring.messages[head % RING_SIZE];
+    ring.head.store(head + 1, std::memory_order_release);
+    notify(ring);
+    return true;
+}
+
+void Learn::SharedMemoryChannel::notify(Ring& ring)
+{
+    // Sequentially consistent operations: either the waiter sees the new
+    // event value, or this process sees the waiter.
+    ring.event.fetch_add(1);
+    if (ring.nbWaiters.load() > 0) {
+        wakeEvent(ring.event);
+    }
+}
+
+bool Learn::SharedMemoryChannel::waitFor(
+    Ring& ring, const std::function<bool()>& operation,
+    std::chrono::milliseconds timeout) const
+{
+    auto start = std::chrono::steady_clock::now();
+    uint32_t nbSpins = 0;
+    while (true) {
+        uint32_t event = ring.event.load();
+        if (operation()) {
+            return true;
+        }
+
+        // Spin first, as the peer usually answers quickly.
+        if (nbSpins < NB_SPINS_BEFORE_BLOCKING) {
+            nbSpins++;
+            std::this_thread::yield();
+            continue;
+        }
+
+        if (!this->isPeerAlive()) {
+            throw std::runtime_error("Peer process of shared memory " +
+                                     this->name + " terminated.");
+        }
+
+        std::chrono::nanoseconds waitDuration = LIVENESS_CHECK_PERIOD;
+        if (timeout.count() > 0) {
+            auto remaining =
+                timeout - (std::chrono::steady_clock::now() - start);
+            if (remaining.count() <= 0) {
+                return false;
+            }
+            waitDuration = std::min(
+                waitDuration,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    remaining));
+        }
+
+        ring.nbWaiters.fetch_add(1);
+        waitEvent(ring.event, event, waitDuration);
+        ring.nbWaiters.fetch_sub(1);
+    }
+}
+
+bool Learn::SharedMemoryChannel::isPeerAlive() const
+{
+#ifndef _WIN32
+    int64_t pid = this->owner ? this->header->peerPid.load()
+                              : this->header->ownerPid.load();
+    if (pid == 0) {
+        return true;
+    }
+    return kill((pid_t)pid, 0) == 0 || errno == EPERM;
+#else
+    return false;
+#endif
+}
+
+bool Learn::SharedMemoryChannel::pushRequest(const Message& message)
+{
+    return push(this->header->requests, message);
+}
+
+bool Learn::SharedMemoryChannel::popRequest(Message& message)
+{
+    return pop(this->header->requests, message);
+}
+
+bool Learn::SharedMemoryChannel::pushResponse(const Message& message)
+{
+    return push(this->header->responses, message);
+}
+
+bool Learn::SharedMemoryChannel::popResponse(Message& message)
+{
+    return pop(this->header->responses, message);
+}
+
+bool Learn::SharedMemoryChannel::pushRequest(const Message& message,
+                                             std::chrono::milliseconds timeout)
+{
+    return this->waitFor(
+        this->header->requests,
+        [&]() { return push(this->header->requests, message); }, timeout);
+}
+
+bool Learn::SharedMemoryChannel::popRequest(Message& message,
+                                            std::chrono::milliseconds timeout)
+{
+    return this->waitFor(
+        this->header->requests,
+        [&]() { return pop(this->header->requests, message); }, timeout);
+}
+
+bool Learn::SharedMemoryChannel::pushResponse(const Message& message,
+                                              std::chrono::milliseconds timeout)
+{
+    return this->waitFor(
+        this->header->responses,
+        [&]() { return push(this->header->responses, message); }, timeout);
+}
+
+bool Learn::SharedMemoryChannel::popResponse(Message& message,
+                                             std::chrono::milliseconds timeout)
+{
+    return this->waitFor(
+        this->header->responses,
+        [&]() { return pop(this->header->responses, message); }, timeout);
+}
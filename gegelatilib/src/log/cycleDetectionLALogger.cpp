@@ -121,8 +121,7 @@ void Log::CycleDetectionLALogger::logAfterPopulateTPG()
 }
 
 void Log::CycleDetectionLALogger::logAfterEvaluate(
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>& results)
+    const Learn::ResultsTable& results)
 {
     // nothing to log
 }
@@ -133,8 +132,7 @@ void Log::CycleDetectionLALogger::logAfterDecimate()
 }
 
 void Log::CycleDetectionLALogger::logAfterValidate(
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>& results)
+    const Learn::ResultsTable& results)
 {
     // nothing to log
 }
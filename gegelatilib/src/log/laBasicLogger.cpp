@@ -35,27 +35,16 @@
  */
 
 #include <iomanip>
-#include <numeric>
 
 #include "learn/learningAgent.h"
 
 #include "log/laBasicLogger.h"
 
-void Log::LABasicLogger::logResults(
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>& results)
+void Log::LABasicLogger::logResults(const Learn::ResultsTable& results)
 {
-    auto iter = results.begin();
-    double min = iter->first->getResult();
-    std::advance(iter, results.size() - 1);
-    double max = iter->first->getResult();
-    double avg = std::accumulate(
-        results.begin(), results.end(), 0.0,
-        [](double acc,
-           std::pair<std::shared_ptr<Learn::EvaluationResult>,
-                     const TPG::TPGVertex*>
-               pair) -> double { return acc + pair.first->getResult(); });
-    avg /= (double)results.size();
+    double min = results.getMinScore();
+    double max = results.getMaxScore();
+    double avg = results.getAvgScore();
     *this << std::setw(colWidth) << min << std::setw(colWidth) << avg
           << std::setw(colWidth) << max;
 }
@@ -95,9 +84,14 @@ void Log::LABasicLogger::logNewGeneration(uint64_t& generationNumber)
     chronoFromNow();
 }
 
+void Log::LABasicLogger::logBeforePopulateTPG()
+{
+    this->populateStart = getTime();
+}
+
 void Log::LABasicLogger::logAfterPopulateTPG()
 {
-    this->mutationTime = getDurationFrom(*checkpoint);
+    this->mutationTime = getDurationFrom(this->populateStart);
 
     *this << std::setw(colWidth)
           << this->learningAgent.getTPGGraph()->getNbVertices();
@@ -105,9 +99,7 @@ void Log::LABasicLogger::logAfterPopulateTPG()
     chronoFromNow();
 }
 
-void Log::LABasicLogger::logAfterEvaluate(
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>& results)
+void Log::LABasicLogger::logAfterEvaluate(const Learn::ResultsTable& results)
 {
     evalTime = getDurationFrom(*checkpoint);
 
@@ -117,11 +109,20 @@ void Log::LABasicLogger::logAfterEvaluate(
     chronoFromNow();
 }
 
-void Log::LABasicLogger::logAfterValidate(
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>& results)
+void Log::LABasicLogger::logAfterValidate(const Learn::ResultsTable& results)
 {
-    validTime = getDurationFrom(*checkpoint);
+    // The validation may have been delivered after the populating step of
+    // the next generation.
+    // An end time older than the evaluation does not belong to this
+    // generation.
+    this->validationEnd = this->learningAgent.getValidationEnd();
+    if (this->validationEnd < *checkpoint) {
+        this->validationEnd = getTime();
+    }
+    validTime = ((std::chrono::duration<double>)(this->validationEnd -
+                                                 *checkpoint))
+                    .count();
+    validationDone = true;
 
     // being in this method means validation is active, and so we are sure we
     // can log results
@@ -135,5 +136,11 @@ void Log::LABasicLogger::logEndOfTraining()
     if (doValidation) {
         *this << std::setw(colWidth) << validTime;
     }
-    *this << std::setw(colWidth) << getDurationFrom(*start) << std::endl;
+    double totalTime =
+        validationDone
+            ? ((std::chrono::duration<double>)(this->validationEnd - *start))
+                  .count()
+            : getDurationFrom(*start);
+    validationDone = false;
+    *this << std::setw(colWidth) << totalTime << std::endl;
 }
@@ -65,3 +65,14 @@ void Log::LALogger::chronoFromNow()
     checkpoint = std::make_shared<std::chrono::time_point<
         std::chrono::system_clock, std::chrono::nanoseconds>>(getTime());
 }
+
+void Log::LALogger::logSteadyStateReport(uint64_t reportNumber,
+                                         const Learn::ResultsTable& results)
+{
+    this->logNewGeneration(reportNumber);
+    this->logBeforePopulateTPG();
+    this->logAfterPopulateTPG();
+    this->logAfterEvaluate(results);
+    this->logAfterDecimate();
+    this->logEndOfTraining();
+}
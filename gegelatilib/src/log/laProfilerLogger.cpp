@@ -0,0 +1,233 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <json.h>
+#include <memory>
+#include <set>
+#include <stdexcept>
+
+#include "learn/learningAgent.h"
+
+#include "log/laProfilerLogger.h"
+
+namespace {
+    /// Name of the scopes during which evaluation threads are busy.
+    bool isEvaluationWork(const char* name)
+    {
+        return std::string(name) == "evaluateJob" ||
+               std::string(name) == "evaluateJobsInterleaved";
+    }
+
+    /// Convert a duration in nanoseconds to seconds.
+    double toSeconds(uint64_t duration)
+    {
+        return (double)duration / 1e9;
+    }
+
+    /// Build the JSON tree of the phases whose parent is given.
+    Json::Value buildPhaseTree(
+        const std::map<std::pair<std::string, std::string>,
+                       Util::Profiler::PhaseStats>& phases,
+        const std::set<std::string>& parents, std::set<std::string>& path)
+    {
+        Json::Value children(Json::arrayValue);
+        for (const auto& phase : phases) {
+            const std::string& name = phase.first.second;
+            if (parents.count(phase.first.first) == 0 || path.count(name)) {
+                continue;
+            }
+            Json::Value node;
+            node["name"] = name;
+            node["count"] = Json::UInt64(phase.second.count);
+            node["time"] = toSeconds(phase.second.totalTime);
+
+            // Recursively nested scopes are not expanded again
+            path.insert(name);
+            Json::Value grandChildren = buildPhaseTree(phases, {name}, path);
+            path.erase(name);
+            if (!grandChildren.empty()) {
+                node["children"] = grandChildren;
+            }
+            children.append(node);
+        }
+        return children;
+    }
+} // namespace
+
+Log::LAProfilerLogger::LAProfilerLogger(Learn::LearningAgent& la,
+                                        std::ostream& out,
+                                        const std::string& traceFilePath)
+    : LALogger(la, out)
+{
+    if (!traceFilePath.empty()) {
+        this->traceFile.open(traceFilePath, std::ios::out | std::ios::trunc);
+        if (!this->traceFile.is_open()) {
+            throw std::runtime_error("Could not open trace file " +
+                                     traceFilePath + ".");
+        }
+        this->traceFile << "[";
+    }
+
+    Util::Profiler::clear();
+    Util::Profiler::enable();
+}
+
+Log::LAProfilerLogger::~LAProfilerLogger()
+{
+    if (this->traceFile.is_open()) {
+        this->traceFile << "\n]\n";
+        this->traceFile.close();
+    }
+}
+
+void Log::LAProfilerLogger::logNewGeneration(uint64_t& generationNumber)
+{
+    this->generationNumber = generationNumber;
+}
+
+void Log::LAProfilerLogger::writeTrace(
+    const std::vector<Util::Profiler::Event>& events,
+    const std::map<std::string, uint64_t>& counters)
+{
+    Json::StreamWriterBuilder writerFactory;
+    writerFactory.settings_["indentation"] = "";
+    std::unique_ptr<Json::StreamWriter> writer(
+        writerFactory.newStreamWriter());
+
+    auto writeEvent = [&](const Json::Value& event) {
+        this->traceFile << (this->traceStarted ? ",\n" : "\n");
+        writer->write(event, &this->traceFile);
+        this->traceStarted = true;
+    };
+
+    // Complete events, with timestamps in microseconds
+    for (const Util::Profiler::Event& event : events) {
+        Json::Value traceEvent;
+        traceEvent["name"] = event.name;
+        traceEvent["cat"] = (event.parent != nullptr) ? event.parent : "";
+        traceEvent["ph"] = "X";
+        traceEvent["ts"] = (double)event.start / 1e3;
+        traceEvent["dur"] = (double)event.duration / 1e3;
+        traceEvent["pid"] = 0;
+        traceEvent["tid"] = Json::UInt64(event.threadId);
+        traceEvent["args"]["generation"] = Json::UInt64(this->generationNumber);
+        writeEvent(traceEvent);
+    }
+
+    // Counter event at the end of the generation
+    if (!counters.empty()) {
+        Json::Value counterEvent;
+        counterEvent["name"] = "counters";
+        counterEvent["ph"] = "C";
+        counterEvent["ts"] = (double)Util::Profiler::now() / 1e3;
+        counterEvent["pid"] = 0;
+        for (const auto& counter : counters) {
+            counterEvent["args"][counter.first] = Json::UInt64(counter.second);
+        }
+        writeEvent(counterEvent);
+    }
+    this->traceFile.flush();
+}
+
+void Log::LAProfilerLogger::logEndOfTraining()
+{
+    std::vector<Util::Profiler::Event> events =
+        Util::Profiler::collectEvents();
+    auto phases = Util::Profiler::collectPhases();
+    std::map<std::string, uint64_t> counters =
+        Util::Profiler::collectCounters();
+
+    Json::Value root;
+    root["generation"] = Json::UInt64(this->generationNumber);
+
+    // Phases whose parent is unknown are kept at the top level
+    std::set<std::string> topLevelParents{""};
+    std::set<std::string> names;
+    for (const auto& phase : phases) {
+        names.insert(phase.first.second);
+    }
+    for (const auto& phase : phases) {
+        if (names.count(phase.first.first) == 0) {
+            topLevelParents.insert(phase.first.first);
+        }
+    }
+    std::set<std::string> path;
+    root["phases"] = buildPhaseTree(phases, topLevelParents, path);
+
+    root["counters"] = Json::Value(Json::objectValue);
+    for (const auto& counter : counters) {
+        root["counters"][counter.first] = Json::UInt64(counter.second);
+    }
+
+    // Evaluation time of each thread
+    std::map<size_t, uint64_t> busyTimes;
+    for (const Util::Profiler::Event& event : events) {
+        if (isEvaluationWork(event.name)) {
+            busyTimes[event.threadId] += event.duration;
+        }
+    }
+    root["threads"] = Json::Value(Json::objectValue);
+    for (const auto& busyTime : busyTimes) {
+        root["threads"][std::to_string(busyTime.first)] =
+            toSeconds(busyTime.second);
+    }
+
+    // Idle time of the threads evaluating jobs within each evaluation phase
+    double idleTime = 0.0;
+    for (const Util::Profiler::Event& phase : events) {
+        if (phase.depth != 0 || std::string(phase.name) != "evaluate") {
+            continue;
+        }
+        std::map<size_t, uint64_t> phaseBusyTimes;
+        for (const Util::Profiler::Event& event : events) {
+            if (isEvaluationWork(event.name) && event.start >= phase.start &&
+                event.start < phase.start + phase.duration) {
+                phaseBusyTimes[event.threadId] += event.duration;
+            }
+        }
+        for (const auto& busyTime : phaseBusyTimes) {
+            if (busyTime.second < phase.duration) {
+                idleTime += toSeconds(phase.duration - busyTime.second);
+            }
+        }
+    }
+    root["evaluationIdleTime"] = idleTime;
+
+    Json::StreamWriterBuilder writerFactory;
+    writerFactory.settings_["indentation"] = "";
+    *this << Json::writeString(writerFactory, root) << std::endl;
+
+    if (this->traceFile.is_open()) {
+        this->writeTrace(events, counters);
+    }
+}
@@ -49,6 +49,7 @@
 #include "tpg/tpgEdge.h"
 #include "tpg/tpgGraph.h"
 #include "tpg/tpgTeam.h"
+#include "util/profiler.h"
 
 #include "mutator/mutationParameters.h"
 #include "mutator/programMutator.h"
@@ -342,6 +343,7 @@ void Mutator::TPGMutator::mutateProgramBehaviorAgainstArchive(
     bool allUnique;
     // Mutate behavior until it changes (against the archive).
     do {
+        GEGELATI_PROFILE_COUNT("programMutationAttempts", 1);
 
         // If a new program is created
         if (rng.getDouble(0.0, 1.0) < params.prog.pNewProgram) {
@@ -350,6 +352,7 @@ void Mutator::TPGMutator::mutateProgramBehaviorAgainstArchive(
         else {
             // Mutate until something is mutated (i.e. the function returns
             // true) And until the program behavior is changed
+            GEGELATI_PROFILE_STATS_SCOPE_IN("mutateProgram", "mutatePrograms");
             while (!(
                 Mutator::ProgramMutator::mutateProgram(*newProg, params, rng) &&
                 !(newProgCopy != nullptr &&
@@ -357,6 +360,8 @@ void Mutator::TPGMutator::mutateProgramBehaviorAgainstArchive(
                 ;
         }
         // Check for uniqueness in archive
+        GEGELATI_PROFILE_STATS_SCOPE_IN("archiveUniquenessCheck",
+                                        "mutatePrograms");
         auto archivedDataHandlers = archive.getDataHandlers();
         std::map<size_t, double> hashesAndResults;
         Program::ProgramExecutionEngine pee(*newProg);
@@ -450,7 +455,10 @@ void Mutator::TPGMutator::populateTPG(TPG::TPGGraph& graph,
                                       const Archive& archive,
                                       const Mutator::MutationParameters& params,
                                       Mutator::RNG& rng, uint64_t nbActions,
-                                      uint64_t maxNbThreads)
+                                      uint64_t maxNbThreads,
+                                      std::map<const TPG::TPGVertex*,
+                                               const TPG::TPGVertex*>*
+                                          rootParents)
 {
     // Get current vertex set (copy)
     auto vertices(graph.getVertices());
@@ -509,13 +517,18 @@ void Mutator::TPGMutator::populateTPG(TPG::TPGGraph& graph,
     // While the target is not reached, add new teams
     uint64_t currentNumberOfRoot = rootVertices.size();
     while (params.tpg.nbRoots > currentNumberOfRoot) {
+        GEGELATI_PROFILE_SCOPE("cloneRoot");
         // Select a random existing root
         uint64_t clonedRootIndex =
             rng.getUnsignedInt64(0, rootTeams.size() - 1);
         // clone it (the vertex and all its outgoing edges)
         const TPG::TPGTeam& newRoot = (const TPG::TPGTeam&)graph.cloneVertex(
             *rootTeams.at(clonedRootIndex));
+        if (rootParents != nullptr) {
+            rootParents->emplace(&newRoot, rootTeams.at(clonedRootIndex));
+        }
         // Apply mutations to the root
+        GEGELATI_PROFILE_SCOPE("mutateTeam");
         mutateTPGTeam(graph, archive, newRoot, preExistingTeams,
                       preExistingActions, preExistingEdges, newPrograms, params,
                       rng);
@@ -525,5 +538,61 @@ void Mutator::TPGMutator::populateTPG(TPG::TPGGraph& graph,
     }
 
     // Mutate the new Programs
+    GEGELATI_PROFILE_SCOPE("mutatePrograms");
     mutateNewProgramBehaviors(maxNbThreads, newPrograms, rng, params, archive);
 }
+
+const TPG::TPGTeam* Mutator::TPGMutator::addMutatedRootTeam(
+    TPG::TPGGraph& graph, const Archive& archive,
+    const Mutator::MutationParameters& params, Mutator::RNG& rng,
+    uint64_t maxNbThreads)
+{
+    // Get current vertex set (copy)
+    auto vertices(graph.getVertices());
+
+    // Pre compute liste of available root TPGTeam, TPGTeam and TPGActions
+    std::vector<const TPG::TPGTeam*> rootTeams;
+    std::vector<const TPG::TPGTeam*> preExistingTeams;
+    std::vector<const TPG::TPGAction*> preExistingActions;
+    std::for_each(vertices.begin(), vertices.end(),
+                  [&rootTeams, &preExistingActions,
+                   &preExistingTeams](const TPG::TPGVertex* target) {
+                      if (dynamic_cast<const TPG::TPGAction*>(target) !=
+                          nullptr) {
+                          preExistingActions.push_back(
+                              (const TPG::TPGAction*)target);
+                      }
+                      else {
+                          preExistingTeams.push_back(
+                              (const TPG::TPGTeam*)target);
+                          if (target->getIncomingEdges().empty()) {
+                              rootTeams.push_back((const TPG::TPGTeam*)target);
+                          }
+                      }
+                  });
+
+    if (rootTeams.empty()) {
+        return nullptr;
+    }
+
+    // Get a list of pre existing edges before mutations (copy)
+    std::list<const TPG::TPGEdge*> preExistingEdges;
+    std::for_each(
+        graph.getEdges().begin(), graph.getEdges().end(),
+        [&preExistingEdges](const std::unique_ptr<TPG::TPGEdge>& edge) {
+            preExistingEdges.push_back(edge.get());
+        });
+
+    // Select a random existing root and clone it
+    uint64_t clonedRootIndex = rng.getUnsignedInt64(0, rootTeams.size() - 1);
+    const TPG::TPGTeam& newRoot =
+        (const TPG::TPGTeam&)graph.cloneVertex(*rootTeams.at(clonedRootIndex));
+
+    // Apply mutations to the root and to its new Programs
+    std::list<std::shared_ptr<Program::Program>> newPrograms;
+    mutateTPGTeam(graph, archive, newRoot, preExistingTeams, preExistingActions,
+                  preExistingEdges, newPrograms, params, rng);
+    mutateNewProgramBehaviors(maxNbThreads, newPrograms, rng, params, archive);
+
+    return &newRoot;
+}
@@ -135,6 +135,12 @@ bool Program::Program::isIntron(uint64_t index) const
         .second; // throws std::out_of_range on bad index.
 }
 
+void Program::Program::setIntron(uint64_t index, bool intron)
+{
+    this->lines.at(index).second =
+        intron; // throws std::out_of_range on bad index.
+}
+
 uint64_t Program::Program::identifyIntrons()
 {
     // Create fake registers to identify accessed addresses.
@@ -39,6 +39,7 @@
 #include <fstream>
 #include <json.h>
 #include <numeric>
+#include <tuple>
 #include <vector>
 
 #include "program/program.h"
@@ -60,6 +61,7 @@ void TPG::ExecutionStats::analyzeProgram(
 void TPG::ExecutionStats::analyzeInstrumentedGraph(const TPGGraph* graph)
 {
     this->avgNbExecutionPerInstruction.clear();
+    this->avgTicksPerEdge.clear();
 
     const auto roots = graph->getRootVertices();
     uint64_t nbInferences = std::accumulate(
@@ -74,6 +76,7 @@ void TPG::ExecutionStats::analyzeInstrumentedGraph(const TPGGraph* graph)
     uint64_t nbEvaluatedTeams = 0;
     uint64_t nbEvaluatedPrograms = 0;
     uint64_t nbExecutedLines = 0;
+    uint64_t nbTicks = 0;
     std::map<size_t, uint64_t> totalExecutionsPerInstruction;
 
     auto vertices = graph->getVertices();
@@ -108,6 +111,13 @@ void TPG::ExecutionStats::analyzeInstrumentedGraph(const TPGGraph* graph)
                     totalExecutionsPerInstruction[pair.first] +=
                         nbEdgeEval * pair.second;
                 }
+
+                uint64_t nbEdgeTicks = instruEdge.getNbTicks();
+                if (nbEdgeTicks > 0) {
+                    nbTicks += nbEdgeTicks;
+                    this->avgTicksPerEdge[edge] =
+                        (double)nbEdgeTicks / (double)nbEdgeEval;
+                }
             }
         }
     }
@@ -116,6 +126,7 @@ void TPG::ExecutionStats::analyzeInstrumentedGraph(const TPGGraph* graph)
     this->avgEvaluatedPrograms =
         (double)nbEvaluatedPrograms / (double)nbInferences;
     this->avgExecutedLines = (double)nbExecutedLines / (double)nbInferences;
+    this->avgTicksPerInference = (double)nbTicks / (double)nbInferences;
 
     for (const auto& p : totalExecutionsPerInstruction) {
         avgNbExecutionPerInstruction[p.first] =
@@ -174,6 +185,22 @@ void TPG::ExecutionStats::analyzeExecution(
 
     analyzeInstrumentedGraph(graph);
 
+    // Measured costs of instructions
+    this->avgTicksPerInstruction.clear();
+    this->timingBackend.clear();
+    if (tee.isTimingEnabled()) {
+        this->timingBackend = Util::CycleCounter::getBackendName(
+            tee.getCycleCounter()->getBackend());
+        auto timings = tee.getInstructionTimings();
+        for (size_t i = 0; i < timings.size(); i++) {
+            if (timings[i].nbExecutions > 0) {
+                this->avgTicksPerInstruction[i] =
+                    (double)timings[i].nbTicks /
+                    (double)timings[i].nbExecutions;
+            }
+        }
+    }
+
     for (const auto& trace : tee.getTraceHistory())
         analyzeInferenceTrace(trace);
 }
@@ -190,6 +217,28 @@ double TPG::ExecutionStats::getAvgExecutedLines() const
 {
     return this->avgExecutedLines;
 }
+const std::string& TPG::ExecutionStats::getTimingBackend() const
+{
+    return this->timingBackend;
+}
+
+double TPG::ExecutionStats::getAvgTicksPerInference() const
+{
+    return this->avgTicksPerInference;
+}
+
+const std::map<size_t, double>& TPG::ExecutionStats::getAvgTicksPerInstruction()
+    const
+{
+    return this->avgTicksPerInstruction;
+}
+
+const std::map<const TPG::TPGEdge*, double>& TPG::ExecutionStats::
+    getAvgTicksPerEdge() const
+{
+    return this->avgTicksPerEdge;
+}
+
 const std::map<size_t, double>& TPG::ExecutionStats::
     getAvgNbExecutionPerInstruction() const
 {
@@ -291,6 +340,32 @@ void TPG::ExecutionStats::writeStatsToJson(const char* filePath,
             [std::to_string(idxVertex)] = p.second;
     }
 
+    // Measured costs
+    if (!this->timingBackend.empty()) {
+        Json::Value& costs = root["ExecutionStats"]["measuredCosts"];
+        costs["timingBackend"] = this->timingBackend;
+        costs["avgTicksPerInference"] = this->avgTicksPerInference;
+        for (const auto& p : this->avgTicksPerInstruction)
+            costs["avgTicksPerInstruction"][std::to_string(p.first)] =
+                p.second;
+        // Edges are sorted by vertex indexes, for reproducible files
+        std::vector<std::tuple<unsigned int, unsigned int, double>> edges;
+        for (const auto& p : this->avgTicksPerEdge) {
+            edges.emplace_back(vertexIndexes[p.first->getSource()],
+                               vertexIndexes[p.first->getDestination()],
+                               p.second);
+        }
+        std::sort(edges.begin(), edges.end());
+        costs["edges"] = Json::Value(Json::arrayValue);
+        for (const auto& e : edges) {
+            Json::Value edge;
+            edge["source"] = std::get<0>(e);
+            edge["destination"] = std::get<1>(e);
+            edge["avgTicks"] = std::get<2>(e);
+            costs["edges"].append(edge);
+        }
+    }
+
     // Trace statistics
     int i = 0;
     for (auto& stats : this->getInferenceTracesStats()) {
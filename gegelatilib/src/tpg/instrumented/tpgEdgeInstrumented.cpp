@@ -37,26 +37,37 @@
 
 uint64_t TPG::TPGEdgeInstrumented::getNbVisits() const
 {
-    return this->nbVisits;
+    return this->nbVisits.get();
 }
 
 void TPG::TPGEdgeInstrumented::incrementNbVisits() const
 {
-    this->nbVisits++;
+    this->nbVisits.increment();
 }
 
 uint64_t TPG::TPGEdgeInstrumented::getNbTraversal() const
 {
-    return this->nbTraversal;
+    return this->nbTraversal.get();
 }
 
 void TPG::TPGEdgeInstrumented::incrementNbTraversal() const
 {
-    this->nbTraversal++;
+    this->nbTraversal.increment();
+}
+
+uint64_t TPG::TPGEdgeInstrumented::getNbTicks() const
+{
+    return this->nbTicks.get();
+}
+
+void TPG::TPGEdgeInstrumented::addNbTicks(uint64_t nbTicks) const
+{
+    this->nbTicks.add(nbTicks);
 }
 
 void TPG::TPGEdgeInstrumented::reset() const
 {
-    this->nbTraversal = 0;
-    this->nbVisits = 0;
+    this->nbTicks.reset();
+    this->nbTraversal.reset();
+    this->nbVisits.reset();
 }
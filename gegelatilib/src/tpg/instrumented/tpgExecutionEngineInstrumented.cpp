@@ -34,43 +34,176 @@
  * knowledge of the CeCILL-C license and that you accept its terms.
  */
 
+#include <stdexcept>
+
 #include "tpg/instrumented/tpgExecutionEngineInstrumented.h"
 #include "tpg/instrumented/tpgActionInstrumented.h"
 #include "tpg/instrumented/tpgEdgeInstrumented.h"
 #include "tpg/instrumented/tpgTeamInstrumented.h"
 
+// Elements are known to be instrumented, as the TPGGraph is built with a
+// TPGInstrumentedFactory, so static casts avoid the cost of dynamic ones.
+
+void TPG::TPGExecutionEngineInstrumented::setDataSources(
+    const std::vector<std::reference_wrapper<const Data::DataHandler>>&
+        dataSrc)
+{
+    TPGExecutionEngine::setDataSources(dataSrc);
+    if (this->timedProgExecutionEngine != nullptr) {
+        this->timedProgExecutionEngine->setDataSources(dataSrc);
+    }
+}
+
 double TPG::TPGExecutionEngineInstrumented::evaluateEdge(const TPGEdge& edge)
 {
-    dynamic_cast<const TPGEdgeInstrumented&>(edge).incrementNbVisits();
-    return TPGExecutionEngine::evaluateEdge(edge);
+    if (!this->recording) {
+        return TPGExecutionEngine::evaluateEdge(edge);
+    }
+
+    const TPGEdgeInstrumented& edgeI =
+        static_cast<const TPGEdgeInstrumented&>(edge);
+    edgeI.incrementNbVisits();
+    if (this->timedProgExecutionEngine == nullptr) {
+        return TPGExecutionEngine::evaluateEdge(edge);
+    }
+
+    uint64_t start = this->cycleCounter->read();
+    double result =
+        this->evaluateEdgeWith(edge, *this->timedProgExecutionEngine);
+    uint64_t end = this->cycleCounter->read();
+    edgeI.addNbTicks((end > start) ? end - start : 0);
+    return result;
 }
 
 const TPG::TPGEdge& TPG::TPGExecutionEngineInstrumented::evaluateTeam(
     const TPGTeam& team)
 {
-    dynamic_cast<const TPGTeamInstrumented&>(team).incrementNbVisits();
+    if (this->recording) {
+        static_cast<const TPGTeamInstrumented&>(team).incrementNbVisits();
+    }
 
     const TPGEdge& winningEdge = TPGExecutionEngine::evaluateTeam(team);
-    dynamic_cast<const TPGEdgeInstrumented&>(winningEdge)
-        .incrementNbTraversal();
+    if (this->recording) {
+        static_cast<const TPGEdgeInstrumented&>(winningEdge)
+            .incrementNbTraversal();
+    }
     return winningEdge;
 }
 
 const std::vector<const TPG::TPGVertex*> TPG::TPGExecutionEngineInstrumented::
     executeFromRoot(const TPG::TPGVertex& root)
 {
+    // Record only one execution per sampling period
+    this->recording = (this->nbExecutions % this->samplingPeriod) == 0;
+    this->nbExecutions++;
+
     const std::vector<const TPG::TPGVertex*> result =
         TPGExecutionEngine::executeFromRoot(root);
 
-    // Increment action visit
-    dynamic_cast<const TPGActionInstrumented*>(result.back())
-        ->incrementNbVisits();
+    if (this->recording) {
+        // Increment action visit
+        static_cast<const TPGActionInstrumented*>(result.back())
+            ->incrementNbVisits();
 
-    this->traceHistory.push_back(result);
+        // Keep the trace, within the reservoir if bounded
+        this->nbRecordedTraces++;
+        if (this->maxNbTraces == 0 ||
+            this->traceHistory.size() < this->maxNbTraces) {
+            this->traceHistory.push_back(result);
+        }
+        else {
+            uint64_t idx =
+                this->rng.getUnsignedInt64(0, this->nbRecordedTraces - 1);
+            if (idx < this->maxNbTraces) {
+                this->traceHistory.at(idx) = result;
+            }
+        }
+    }
+
+    // Direct calls to evaluateTeam() and evaluateEdge() are recorded
+    this->recording = true;
 
     return result;
 }
 
+void TPG::TPGExecutionEngineInstrumented::setSamplingPeriod(uint64_t period)
+{
+    if (period == 0) {
+        throw std::invalid_argument("Sampling period must be at least 1.");
+    }
+    this->samplingPeriod = period;
+}
+
+uint64_t TPG::TPGExecutionEngineInstrumented::getSamplingPeriod() const
+{
+    return this->samplingPeriod;
+}
+
+void TPG::TPGExecutionEngineInstrumented::setMaxNbTraces(size_t maxNbTraces,
+                                                         uint64_t seed)
+{
+    this->maxNbTraces = maxNbTraces;
+    this->rng.setSeed(seed);
+    if (maxNbTraces != 0 && this->traceHistory.size() > maxNbTraces) {
+        this->traceHistory.resize(maxNbTraces);
+    }
+}
+
+size_t TPG::TPGExecutionEngineInstrumented::getMaxNbTraces() const
+{
+    return this->maxNbTraces;
+}
+
+uint64_t TPG::TPGExecutionEngineInstrumented::getNbRecordedTraces() const
+{
+    return this->nbRecordedTraces;
+}
+
+void TPG::TPGExecutionEngineInstrumented::enableTiming(
+    Util::CycleCounter::Backend backend)
+{
+    this->timedProgExecutionEngine.reset();
+    this->cycleCounter = std::make_unique<Util::CycleCounter>(backend);
+    this->timedProgExecutionEngine =
+        std::make_unique<Program::ProgramExecutionEngineInstrumented>(
+            this->env, *this->cycleCounter);
+    this->timedProgExecutionEngine->setDataSources(
+        this->progExecutionEngine.getDataSources());
+}
+
+void TPG::TPGExecutionEngineInstrumented::disableTiming()
+{
+    this->timedProgExecutionEngine.reset();
+    this->cycleCounter.reset();
+}
+
+bool TPG::TPGExecutionEngineInstrumented::isTimingEnabled() const
+{
+    return this->timedProgExecutionEngine != nullptr;
+}
+
+const Util::CycleCounter* TPG::TPGExecutionEngineInstrumented::
+    getCycleCounter() const
+{
+    return this->cycleCounter.get();
+}
+
+std::vector<Program::InstructionTiming> TPG::TPGExecutionEngineInstrumented::
+    getInstructionTimings() const
+{
+    if (this->timedProgExecutionEngine == nullptr) {
+        return {};
+    }
+    return this->timedProgExecutionEngine->getInstructionTimings();
+}
+
+void TPG::TPGExecutionEngineInstrumented::clearInstructionTimings()
+{
+    if (this->timedProgExecutionEngine != nullptr) {
+        this->timedProgExecutionEngine->clearInstructionTimings();
+    }
+}
+
 const std::vector<std::vector<const TPG::TPGVertex*>>& TPG::
     TPGExecutionEngineInstrumented::getTraceHistory() const
 {
@@ -80,4 +213,5 @@ const std::vector<std::vector<const TPG::TPGVertex*>>& TPG::
 void TPG::TPGExecutionEngineInstrumented::clearTraceHistory()
 {
     this->traceHistory.clear();
+    this->nbRecordedTraces = 0;
 }
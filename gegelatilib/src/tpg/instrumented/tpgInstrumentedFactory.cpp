@@ -33,17 +33,28 @@
  * knowledge of the CeCILL-C license and that you accept its terms.
  */
 
+#include <stdexcept>
+
 #include "tpg/instrumented/tpgInstrumentedFactory.h"
 #include "tpg/instrumented/tpgActionInstrumented.h"
 #include "tpg/instrumented/tpgEdgeInstrumented.h"
 #include "tpg/instrumented/tpgExecutionEngineInstrumented.h"
 #include "tpg/instrumented/tpgTeamInstrumented.h"
 
+TPG::TPGInstrumentedFactory::TPGInstrumentedFactory(uint64_t samplingPeriod,
+                                                    size_t maxNbTraces)
+    : samplingPeriod{samplingPeriod}, maxNbTraces{maxNbTraces}
+{
+    if (samplingPeriod == 0) {
+        throw std::invalid_argument("Sampling period must be at least 1.");
+    }
+}
+
 std::shared_ptr<TPG::TPGGraph> TPG::TPGInstrumentedFactory::createTPGGraph(
     const Environment& env) const
 {
     return std::make_shared<TPG::TPGGraph>(
-        env, std::make_unique<TPGInstrumentedFactory>());
+        env, std::make_unique<TPGInstrumentedFactory>(*this));
 }
 
 TPG::TPGTeam* TPG::TPGInstrumentedFactory::createTPGTeam() const
@@ -68,7 +79,10 @@ std::unique_ptr<TPG::TPGEdge> TPG::TPGInstrumentedFactory::createTPGEdge(
 std::unique_ptr<TPG::TPGExecutionEngine> TPG::TPGInstrumentedFactory::
     createTPGExecutionEngine(const Environment& env, Archive* arch) const
 {
-    return std::make_unique<TPGExecutionEngineInstrumented>(env, arch);
+    auto tee = std::make_unique<TPGExecutionEngineInstrumented>(env, arch);
+    tee->setSamplingPeriod(this->samplingPeriod);
+    tee->setMaxNbTraces(this->maxNbTraces);
+    return tee;
 }
 
 void TPG::TPGInstrumentedFactory::resetTPGGraphCounters(
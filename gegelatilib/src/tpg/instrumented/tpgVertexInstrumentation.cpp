@@ -37,15 +37,15 @@
 
 uint64_t TPG::TPGVertexInstrumentation::getNbVisits() const
 {
-    return this->nbVisits;
+    return this->nbVisits.get();
 }
 
 void TPG::TPGVertexInstrumentation::incrementNbVisits() const
 {
-    this->nbVisits++;
+    this->nbVisits.increment();
 }
 
 void TPG::TPGVertexInstrumentation::reset() const
 {
-    this->nbVisits = 0;
+    this->nbVisits.reset();
 }
@@ -48,16 +48,29 @@ void TPG::TPGExecutionEngine::setArchive(Archive* newArchive)
     this->archive = newArchive;
 }
 
+void TPG::TPGExecutionEngine::setDataSources(
+    const std::vector<std::reference_wrapper<const Data::DataHandler>>&
+        dataSrc)
+{
+    this->progExecutionEngine.setDataSources(dataSrc);
+}
+
 double TPG::TPGExecutionEngine::evaluateEdge(const TPGEdge& edge)
+{
+    return this->evaluateEdgeWith(edge, this->progExecutionEngine);
+}
+
+double TPG::TPGExecutionEngine::evaluateEdgeWith(
+    const TPGEdge& edge, Program::ProgramExecutionEngine& engine)
 {
     // Get the program
     Program::Program& prog = edge.getProgram();
 
-    // Set the progExecutionEngine to the program
-    this->progExecutionEngine.setProgram(prog);
+    // Set the engine to the program
+    engine.setProgram(prog);
 
     // Execute the program.
-    double result = this->progExecutionEngine.executeProgram();
+    double result = engine.executeProgram();
 
     // Filter NaN results: replace with -inf
     result = (std::isnan(result)) ? -std::numeric_limits<double>::infinity()
@@ -65,8 +78,7 @@ double TPG::TPGExecutionEngine::evaluateEdge(const TPGEdge& edge)
 
     // Put the result in the archive before returning it.
     if (this->archive != NULL) {
-        this->archive->addRecording(&prog, progExecutionEngine.getDataSources(),
-                                    result);
+        this->archive->addRecording(&prog, engine.getDataSources(), result);
     }
 
     return result;
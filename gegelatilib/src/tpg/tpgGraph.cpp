@@ -35,8 +35,15 @@
  */
 
 #include <algorithm>
+#include <map>
+#include <queue>
 #include <stdexcept>
 #include <type_traits>
+#include <typeinfo>
+
+#include "data/constant.h"
+#include "program/line.h"
+#include "program/program.h"
 
 #include "tpg/tpgGraph.h"
 
@@ -325,3 +332,89 @@ void TPG::TPGGraph::clearProgramIntrons()
         edge.get()->getProgram().clearIntrons();
     }
 }
+
+const TPG::TPGVertex& TPG::TPGGraph::importSubGraph(const TPGVertex& root)
+{
+    if (this->hasVertex(root)) {
+        throw std::runtime_error(
+            "The vertex to import already belongs to the TPGGraph.");
+    }
+
+    // Existing actions of the graph, indexed by action ID
+    std::map<uint64_t, const TPGVertex*> actions;
+    for (auto vertex : this->vertices) {
+        const TPGAction* action = dynamic_cast<const TPGAction*>(vertex);
+        if (action != nullptr) {
+            actions.emplace(action->getActionID(), action);
+        }
+    }
+
+    // Copy vertices reachable from the root (breadth first)
+    std::map<const TPGVertex*, const TPGVertex*> copiedVertices;
+    std::vector<const TPGVertex*> copiedTeams;
+    std::queue<const TPGVertex*> toVisit;
+    toVisit.push(&root);
+    while (!toVisit.empty()) {
+        const TPGVertex* vertex = toVisit.front();
+        toVisit.pop();
+        if (copiedVertices.count(vertex) != 0) {
+            continue;
+        }
+
+        const TPGAction* action = dynamic_cast<const TPGAction*>(vertex);
+        if (action != nullptr) {
+            auto iter = actions.find(action->getActionID());
+            if (iter == actions.end()) {
+                iter = actions
+                           .emplace(action->getActionID(),
+                                    &this->addNewAction(action->getActionID()))
+                           .first;
+            }
+            copiedVertices.emplace(vertex, iter->second);
+        }
+        else {
+            copiedVertices.emplace(vertex, &this->addNewTeam());
+            copiedTeams.push_back(vertex);
+            for (auto edge : vertex->getOutgoingEdges()) {
+                toVisit.push(edge->getDestination());
+            }
+        }
+    }
+
+    // Copy edges, with a copy of each Program bound to this environment
+    std::map<const Program::Program*, std::shared_ptr<Program::Program>>
+        copiedPrograms;
+    for (auto team : copiedTeams) {
+        for (auto edge : team->getOutgoingEdges()) {
+            const Program::Program& prog = edge->getProgram();
+            auto iter = copiedPrograms.find(&prog);
+            if (iter == copiedPrograms.end()) {
+                auto copy = std::make_shared<Program::Program>(this->env);
+                for (uint64_t i = 0; i < prog.getNbLines(); i++) {
+                    const Program::Line& line = prog.getLine(i);
+                    Program::Line& newLine = copy->addNewLine();
+                    newLine.setInstructionIndex(line.getInstructionIndex(),
+                                                false);
+                    newLine.setDestinationIndex(line.getDestinationIndex(),
+                                                false);
+                    for (uint64_t op = 0; op < this->env.getMaxNbOperands();
+                         op++) {
+                        newLine.setOperand(op, line.getOperand(op).first,
+                                           line.getOperand(op).second, false);
+                    }
+                }
+                for (size_t i = 0; i < this->env.getNbConstant(); i++) {
+                    copy->getConstantHandler().setDataAt(
+                        typeid(Data::Constant), i, prog.getConstantAt(i));
+                }
+                copy->identifyIntrons();
+                iter = copiedPrograms.emplace(&prog, copy).first;
+            }
+            this->addNewEdge(*copiedVertices.at(team),
+                             *copiedVertices.at(edge->getDestination()),
+                             iter->second);
+        }
+    }
+
+    return *copiedVertices.at(&root);
+}
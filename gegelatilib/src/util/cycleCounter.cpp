@@ -0,0 +1,128 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define GEGELATI_HAS_TSC
+#endif
+
+#include <chrono>
+#include <cstring>
+
+#include "util/cycleCounter.h"
+
+Util::CycleCounter::CycleCounter(Backend backend)
+    : backend{Backend::CLOCK}, perfFd{-1}
+{
+    switch (backend) {
+    case Backend::TSC:
+#ifdef GEGELATI_HAS_TSC
+        this->backend = Backend::TSC;
+#endif
+        break;
+    case Backend::PERF_EVENT: {
+#ifdef __linux__
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_SOFTWARE;
+        attr.config = PERF_COUNT_SW_TASK_CLOCK;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // Count the calling thread, on any CPU.
+        long fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd >= 0) {
+            this->perfFd = (int)fd;
+            this->backend = Backend::PERF_EVENT;
+        }
+#endif
+        break;
+    }
+    case Backend::CLOCK:
+        break;
+    }
+}
+
+Util::CycleCounter::~CycleCounter()
+{
+#ifdef __linux__
+    if (this->perfFd >= 0) {
+        close(this->perfFd);
+    }
+#endif
+}
+
+Util::CycleCounter::Backend Util::CycleCounter::getBackend() const
+{
+    return this->backend;
+}
+
+const char* Util::CycleCounter::getBackendName(Backend backend)
+{
+    switch (backend) {
+    case Backend::TSC:
+        return "tsc";
+    case Backend::PERF_EVENT:
+        return "perf_event";
+    case Backend::CLOCK:
+    default:
+        return "clock";
+    }
+}
+
+uint64_t Util::CycleCounter::read() const
+{
+#ifdef GEGELATI_HAS_TSC
+    if (this->backend == Backend::TSC) {
+        return __rdtsc();
+    }
+#endif
+#ifdef __linux__
+    if (this->backend == Backend::PERF_EVENT) {
+        uint64_t value = 0;
+        if (::read(this->perfFd, &value, sizeof(value)) == sizeof(value)) {
+            return value;
+        }
+        return 0;
+    }
+#endif
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
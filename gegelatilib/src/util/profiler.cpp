@@ -0,0 +1,286 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+
+#include "util/profiler.h"
+
+namespace {
+    /// Scope opened in a thread.
+    struct OpenScope
+    {
+        const char* name;
+        const char* parent;
+        size_t depth;
+        bool traced;
+    };
+
+    /// Key of accumulated statistics, before names are compared by value.
+    using RawPhaseKey = std::pair<const char*, const char*>;
+
+    /// Key of accumulated statistics, compared by value.
+    using PhaseKey = std::pair<std::string, std::string>;
+
+    struct ThreadBuffer;
+
+    /// Buffers of all threads, and data left by terminated threads.
+    struct Registry
+    {
+        std::mutex mutex;
+        std::set<ThreadBuffer*> buffers;
+        size_t nextThreadId = 0;
+        std::vector<Util::Profiler::Event> retiredEvents;
+        std::map<PhaseKey, Util::Profiler::PhaseStats> retiredPhases;
+        std::map<std::string, uint64_t> retiredCounters;
+    };
+
+    /// Registry is never destroyed, as threads may end after static
+    /// destructors.
+    Registry& getRegistry()
+    {
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    std::atomic<bool> profilerEnabled{false};
+
+    std::atomic<size_t> maxTraceDepth{3};
+
+    /// Move accumulated statistics, indexed by value.
+    void movePhases(
+        std::map<RawPhaseKey, Util::Profiler::PhaseStats>& phases,
+        std::map<PhaseKey, Util::Profiler::PhaseStats>& result)
+    {
+        for (const auto& phase : phases) {
+            auto& stats = result[{(phase.first.first != nullptr)
+                                      ? phase.first.first
+                                      : "",
+                                  phase.first.second}];
+            stats.count += phase.second.count;
+            stats.totalTime += phase.second.totalTime;
+        }
+        phases.clear();
+    }
+
+    /// Move counters, indexed by value.
+    void moveCounters(std::map<const char*, uint64_t>& counters,
+                      std::map<std::string, uint64_t>& result)
+    {
+        for (const auto& counter : counters) {
+            result[counter.first] += counter.second;
+        }
+        counters.clear();
+    }
+
+    /// Data recorded by a thread.
+    struct ThreadBuffer
+    {
+        /// Protects the recorded data, which is collected by other threads.
+        std::mutex mutex;
+        size_t threadId;
+        /// Only accessed by the owning thread.
+        std::vector<OpenScope> stack;
+        std::vector<Util::Profiler::Event> events;
+        std::map<RawPhaseKey, Util::Profiler::PhaseStats> phases;
+        std::map<const char*, uint64_t> counters;
+
+        ThreadBuffer()
+        {
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            this->threadId = registry.nextThreadId++;
+            registry.buffers.insert(this);
+        }
+
+        ~ThreadBuffer()
+        {
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            std::lock_guard<std::mutex> lockBuffer(this->mutex);
+            registry.retiredEvents.insert(registry.retiredEvents.end(),
+                                          this->events.begin(),
+                                          this->events.end());
+            movePhases(this->phases, registry.retiredPhases);
+            moveCounters(this->counters, registry.retiredCounters);
+            registry.buffers.erase(this);
+        }
+    };
+
+    ThreadBuffer& getThreadBuffer()
+    {
+        thread_local ThreadBuffer buffer;
+        return buffer;
+    }
+} // namespace
+
+Util::Profiler::ScopedTimer::ScopedTimer(const char* name,
+                                         const char* defaultParent,
+                                         bool traced)
+    : active{profilerEnabled.load(std::memory_order_relaxed)}, start{0}
+{
+    if (this->active) {
+        ThreadBuffer& buffer = getThreadBuffer();
+        if (buffer.stack.empty()) {
+            // The default parent is opened in another thread.
+            buffer.stack.push_back({name, defaultParent,
+                                    (defaultParent != nullptr) ? 1u : 0u,
+                                    traced});
+        }
+        else {
+            const OpenScope& parent = buffer.stack.back();
+            buffer.stack.push_back(
+                {name, parent.name, parent.depth + 1, traced});
+        }
+        this->start = Profiler::now();
+    }
+}
+
+Util::Profiler::ScopedTimer::~ScopedTimer()
+{
+    if (this->active) {
+        uint64_t duration = Profiler::now() - this->start;
+        ThreadBuffer& buffer = getThreadBuffer();
+        OpenScope scope = buffer.stack.back();
+        buffer.stack.pop_back();
+
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        PhaseStats& stats = buffer.phases[{scope.parent, scope.name}];
+        stats.count++;
+        stats.totalTime += duration;
+        if (scope.traced && scope.depth < maxTraceDepth.load()) {
+            buffer.events.push_back({scope.name, scope.parent,
+                                     buffer.threadId, scope.depth,
+                                     this->start, duration});
+        }
+    }
+}
+
+void Util::Profiler::enable(bool enabled)
+{
+    // Initialize the time origin
+    now();
+    profilerEnabled = enabled;
+}
+
+bool Util::Profiler::isEnabled()
+{
+    return profilerEnabled;
+}
+
+void Util::Profiler::setMaxTraceDepth(size_t depth)
+{
+    maxTraceDepth = depth;
+}
+
+size_t Util::Profiler::getMaxTraceDepth()
+{
+    return maxTraceDepth;
+}
+
+void Util::Profiler::count(const char* name, uint64_t value)
+{
+    if (profilerEnabled.load(std::memory_order_relaxed)) {
+        ThreadBuffer& buffer = getThreadBuffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.counters[name] += value;
+    }
+}
+
+uint64_t Util::Profiler::now()
+{
+    static const std::chrono::steady_clock::time_point origin =
+        std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - origin)
+        .count();
+}
+
+std::vector<Util::Profiler::Event> Util::Profiler::collectEvents()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<Event> events = std::move(registry.retiredEvents);
+    registry.retiredEvents.clear();
+    for (ThreadBuffer* buffer : registry.buffers) {
+        std::lock_guard<std::mutex> lockBuffer(buffer->mutex);
+        events.insert(events.end(), buffer->events.begin(),
+                      buffer->events.end());
+        buffer->events.clear();
+    }
+
+    std::sort(events.begin(), events.end(),
+              [](const Event& a, const Event& b) {
+                  return (a.start != b.start) ? a.start < b.start
+                                              : a.threadId < b.threadId;
+              });
+    return events;
+}
+
+std::map<std::pair<std::string, std::string>, Util::Profiler::PhaseStats>
+Util::Profiler::collectPhases()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::map<PhaseKey, PhaseStats> phases = std::move(registry.retiredPhases);
+    registry.retiredPhases.clear();
+    for (ThreadBuffer* buffer : registry.buffers) {
+        std::lock_guard<std::mutex> lockBuffer(buffer->mutex);
+        movePhases(buffer->phases, phases);
+    }
+    return phases;
+}
+
+std::map<std::string, uint64_t> Util::Profiler::collectCounters()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::map<std::string, uint64_t> counters =
+        std::move(registry.retiredCounters);
+    registry.retiredCounters.clear();
+    for (ThreadBuffer* buffer : registry.buffers) {
+        std::lock_guard<std::mutex> lockBuffer(buffer->mutex);
+        moveCounters(buffer->counters, counters);
+    }
+    return counters;
+}
+
+void Util::Profiler::clear()
+{
+    collectEvents();
+    collectPhases();
+    collectCounters();
+}
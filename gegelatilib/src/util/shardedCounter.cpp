@@ -0,0 +1,222 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "util/shardedCounter.h"
+
+namespace {
+    /// Number of counters in a chunk of a shard.
+    constexpr size_t CHUNK_SIZE = 1024;
+
+    /// Values of all counters for a thread.
+    struct Shard
+    {
+        using Chunk = std::array<std::atomic<uint64_t>, CHUNK_SIZE>;
+
+        /// Protects the list of chunks, which only grows.
+        std::mutex mutex;
+
+        /// Values are only written by the owning thread, or under the lock
+        /// of the Registry once the thread terminated, but read by other
+        /// threads.
+        std::vector<std::unique_ptr<Chunk>> chunks;
+
+        /// Get a value, or nullptr if its chunk was not allocated.
+        std::atomic<uint64_t>* find(size_t index)
+        {
+            size_t chunkIdx = index / CHUNK_SIZE;
+            return (chunkIdx < this->chunks.size())
+                       ? &(*this->chunks[chunkIdx])[index % CHUNK_SIZE]
+                       : nullptr;
+        }
+
+        /// Get a value, allocating its chunk if needed.
+        std::atomic<uint64_t>& at(size_t index)
+        {
+            size_t chunkIdx = index / CHUNK_SIZE;
+            if (chunkIdx >= this->chunks.size()) {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                while (chunkIdx >= this->chunks.size()) {
+                    auto chunk = std::make_unique<Chunk>();
+                    for (auto& value : *chunk) {
+                        value.store(0, std::memory_order_relaxed);
+                    }
+                    this->chunks.push_back(std::move(chunk));
+                }
+            }
+            return (*this->chunks[chunkIdx])[index % CHUNK_SIZE];
+        }
+
+        /// Get a value from another thread.
+        uint64_t read(size_t index)
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            std::atomic<uint64_t>* value = this->find(index);
+            return (value != nullptr) ? value->load(std::memory_order_relaxed)
+                                      : 0;
+        }
+    };
+
+    /// Shards of all threads, and values left by terminated threads.
+    struct Registry
+    {
+        std::mutex mutex;
+        std::set<Shard*> shards;
+        Shard retired;
+        std::vector<size_t> freeIndexes;
+        size_t nextIndex = 0;
+
+        /// Sum of the shards of each counter when it was last reset. Shards
+        /// are never written by other threads, so that an increment racing
+        /// with a reset can not overwrite it.
+        std::vector<uint64_t> bases;
+
+        /// Sum of the shards of a counter. The lock must be held.
+        uint64_t sum(size_t index)
+        {
+            uint64_t total = this->retired.read(index);
+            for (Shard* shard : this->shards) {
+                total += shard->read(index);
+            }
+            return total;
+        }
+    };
+
+    /// Registry is never destroyed, as threads may end after static
+    /// destructors.
+    Registry& getRegistry()
+    {
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    /// Shard of a thread, registered during its lifetime.
+    struct ThreadShard : public Shard
+    {
+        ThreadShard()
+        {
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.shards.insert(this);
+        }
+
+        ~ThreadShard()
+        {
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.shards.erase(this);
+            for (size_t chunkIdx = 0; chunkIdx < this->chunks.size();
+                 chunkIdx++) {
+                for (size_t i = 0; i < CHUNK_SIZE; i++) {
+                    uint64_t value = (*this->chunks[chunkIdx])[i];
+                    if (value != 0) {
+                        registry.retired.at(chunkIdx * CHUNK_SIZE + i) +=
+                            value;
+                    }
+                }
+            }
+        }
+    };
+
+    Shard& getThreadShard()
+    {
+        thread_local ThreadShard shard;
+        return shard;
+    }
+
+    size_t allocateIndex()
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        size_t index;
+        if (!registry.freeIndexes.empty()) {
+            index = registry.freeIndexes.back();
+            registry.freeIndexes.pop_back();
+        }
+        else {
+            index = registry.nextIndex++;
+            registry.bases.push_back(0);
+        }
+        // Start from zero, whatever the previous counter with this index
+        // left in the shards.
+        registry.bases[index] = registry.sum(index);
+        return index;
+    }
+} // namespace
+
+Util::ShardedCounter::ShardedCounter() : index{allocateIndex()}
+{
+}
+
+Util::ShardedCounter::~ShardedCounter()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.freeIndexes.push_back(this->index);
+}
+
+void Util::ShardedCounter::increment() const
+{
+    this->add(1);
+}
+
+void Util::ShardedCounter::add(uint64_t value) const
+{
+    std::atomic<uint64_t>& shardValue = getThreadShard().at(this->index);
+    // Only the owning thread writes in its shard, so no read-modify-write
+    // instruction is needed.
+    shardValue.store(shardValue.load(std::memory_order_relaxed) + value,
+                     std::memory_order_relaxed);
+}
+
+uint64_t Util::ShardedCounter::get() const
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    // Unsigned arithmetic gives the right value even if the sum wrapped
+    // around since the reset.
+    return registry.sum(this->index) - registry.bases[this->index];
+}
+
+void Util::ShardedCounter::reset() const
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.bases[this->index] = registry.sum(this->index);
+}
@@ -0,0 +1,331 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#include "util/threadAffinity.h"
+
+Util::ThreadAffinity::ThreadAffinity() : policy{Policy::NONE}, nbNodes{1}
+{
+}
+
+Util::ThreadAffinity::ThreadAffinity(const std::string& description)
+    : policy{Policy::NONE}, nbNodes{1}
+{
+    this->init(description, readTopology());
+}
+
+Util::ThreadAffinity::ThreadAffinity(
+    const std::string& description,
+    const std::map<int, std::vector<int>>& nodeCPUs)
+    : policy{Policy::NONE}, nbNodes{1}
+{
+    this->init(description, nodeCPUs);
+}
+
+void Util::ThreadAffinity::init(
+    const std::string& description,
+    const std::map<int, std::vector<int>>& nodeCPUs)
+{
+    this->nbNodes = std::max((size_t)1, nodeCPUs.size());
+    for (const auto& node : nodeCPUs) {
+        for (int cpu : node.second) {
+            this->cpuNodes[cpu] = node.first;
+        }
+    }
+
+    if (description == "none" || description.empty()) {
+        this->policy = Policy::NONE;
+    }
+    else if (description == "compact") {
+        this->policy = Policy::COMPACT;
+        for (const auto& node : nodeCPUs) {
+            this->cpus.insert(this->cpus.end(), node.second.begin(),
+                              node.second.end());
+        }
+    }
+    else if (description == "scatter") {
+        this->policy = Policy::SCATTER;
+        bool added = true;
+        for (size_t i = 0; added; i++) {
+            added = false;
+            for (const auto& node : nodeCPUs) {
+                if (i < node.second.size()) {
+                    this->cpus.push_back(node.second.at(i));
+                    added = true;
+                }
+            }
+        }
+    }
+    else {
+        this->policy = Policy::EXPLICIT;
+        this->cpus = parseCPUList(description);
+    }
+
+    if (this->policy != Policy::NONE && this->cpus.empty()) {
+        throw std::runtime_error("No CPU available for the \"" + description +
+                                 "\" thread affinity policy.");
+    }
+}
+
+Util::ThreadAffinity::Policy Util::ThreadAffinity::getPolicy() const
+{
+    return this->policy;
+}
+
+size_t Util::ThreadAffinity::getNbNodes() const
+{
+    return this->nbNodes;
+}
+
+int Util::ThreadAffinity::getCPU(size_t workerIdx) const
+{
+    if (this->policy == Policy::NONE) {
+        return -1;
+    }
+    return this->cpus.at(workerIdx % this->cpus.size());
+}
+
+int Util::ThreadAffinity::getNode(int cpu) const
+{
+    auto node = this->cpuNodes.find(cpu);
+    return (node != this->cpuNodes.end()) ? node->second : 0;
+}
+
+int Util::ThreadAffinity::getCurrentNode() const
+{
+#ifdef __linux__
+    return this->getNode(sched_getcpu());
+#else
+    return 0;
+#endif
+}
+
+bool Util::ThreadAffinity::pinCurrentThread(int cpu)
+{
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                                  &cpuSet) == 0;
+#else
+    return false;
+#endif
+}
+
+std::vector<int> Util::ThreadAffinity::getCurrentThreadCPUs()
+{
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) ==
+        0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &cpuSet)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+bool Util::ThreadAffinity::setCurrentThreadCPUs(const std::vector<int>& cpus)
+{
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        CPU_SET(cpu, &cpuSet);
+    }
+    return !cpus.empty() &&
+           pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                                  &cpuSet) == 0;
+#else
+    return false;
+#endif
+}
+
+Util::ThreadAffinity::ScopedPin::ScopedPin(int cpu) : pinned{false}
+{
+    if (cpu >= 0) {
+        this->previousCPUs = getCurrentThreadCPUs();
+        this->pinned = pinCurrentThread(cpu);
+    }
+}
+
+Util::ThreadAffinity::ScopedPin::~ScopedPin()
+{
+    if (this->pinned) {
+        setCurrentThreadCPUs(this->previousCPUs);
+    }
+}
+
+bool Util::ThreadAffinity::ScopedPin::isPinned() const
+{
+    return this->pinned;
+}
+
+std::vector<int> Util::ThreadAffinity::parseCPUList(const std::string& list)
+{
+    std::vector<int> result;
+    size_t pos = 0;
+    auto readNumber = [&]() {
+        size_t start = pos;
+        while (pos < list.size() && std::isdigit((unsigned char)list[pos])) {
+            pos++;
+        }
+        if (pos == start) {
+            throw std::runtime_error("Invalid CPU list \"" + list + "\".");
+        }
+        return std::stoi(list.substr(start, pos - start));
+    };
+
+    while (pos < list.size()) {
+        int first = readNumber();
+        int last = first;
+        if (pos < list.size() && list[pos] == '-') {
+            pos++;
+            last = readNumber();
+            if (last < first) {
+                throw std::runtime_error("Invalid CPU range in list \"" +
+                                         list + "\".");
+            }
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            result.push_back(cpu);
+        }
+        if (pos < list.size()) {
+            if (list[pos] != ',' || pos + 1 == list.size()) {
+                throw std::runtime_error("Invalid CPU list \"" + list + "\".");
+            }
+            pos++;
+        }
+    }
+
+    return result;
+}
+
+std::map<int, std::vector<int>> Util::ThreadAffinity::readTopology()
+{
+    std::map<int, std::vector<int>> nodeCPUs;
+    std::vector<int> allowedCPUs;
+
+#ifdef __linux__
+    // CPUs the process is allowed to run on (e.g. restricted by taskset or a
+    // cgroup cpuset).
+    cpu_set_t allowedSet;
+    CPU_ZERO(&allowedSet);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &allowedSet) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowedSet)) {
+                allowedCPUs.push_back(cpu);
+            }
+        }
+    }
+
+    // Node numbers may have gaps (e.g. offline or memory-less nodes).
+    DIR* dir = opendir("/sys/devices/system/node");
+    if (dir != nullptr) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            std::string name(entry->d_name);
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+                !std::all_of(name.begin() + 4, name.end(), [](char c) {
+                    return std::isdigit((unsigned char)c);
+                })) {
+                continue;
+            }
+            std::ifstream file("/sys/devices/system/node/" + name +
+                               "/cpulist");
+            std::string list;
+            if (!file.is_open() || !std::getline(file, list) || list.empty()) {
+                continue;
+            }
+            std::vector<int> cpus;
+            try {
+                cpus = parseCPUList(list);
+            }
+            catch (std::runtime_error&) {
+                continue;
+            }
+
+            // Keep only the CPUs allowed for the process
+            std::vector<int> usableCPUs;
+            for (int cpu : cpus) {
+                if (allowedCPUs.empty() ||
+                    std::binary_search(allowedCPUs.begin(), allowedCPUs.end(),
+                                       cpu)) {
+                    usableCPUs.push_back(cpu);
+                }
+            }
+            if (!usableCPUs.empty()) {
+                nodeCPUs[std::stoi(name.substr(4))] = usableCPUs;
+            }
+        }
+        closedir(dir);
+    }
+#endif
+
+    // Default to a single node with all CPUs
+    if (nodeCPUs.empty() && !allowedCPUs.empty()) {
+        nodeCPUs[0] = allowedCPUs;
+    }
+    else if (nodeCPUs.empty()) {
+        unsigned int nbCPUs = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int cpu = 0; cpu < nbCPUs; cpu++) {
+            nodeCPUs[0].push_back((int)cpu);
+        }
+    }
+
+    return nodeCPUs;
+}
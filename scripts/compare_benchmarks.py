@@ -0,0 +1,58 @@
+# This script compares the JSON results of gegelati-bench with a baseline.
+#
+# Usage: python3 compare_benchmarks.py baseline.json current.json [--threshold 0.05]
+#
+# The median time per iteration of each benchmark present in both files is
+# compared. The script exits with status 1 if any benchmark is slower than the
+# baseline by more than the threshold (relative).
+#
+# License: CeCILL-C
+
+import argparse
+import json
+import sys
+
+parser = argparse.ArgumentParser(description="Compare gegelati-bench results with a baseline.")
+parser.add_argument("baseline", help="JSON file of the baseline results.")
+parser.add_argument("current", help="JSON file of the current results.")
+parser.add_argument("--threshold", type=float, default=0.05,
+                    help="Relative slowdown above which a benchmark is a regression (default: 0.05).")
+args = parser.parse_args()
+
+def loadResults(path):
+    with open(path, "r") as jsonFile:
+        content = json.load(jsonFile)
+    return content["context"], {b["name"]: b for b in content["benchmarks"]}
+
+baselineContext, baseline = loadResults(args.baseline)
+currentContext, current = loadResults(args.current)
+
+# Warn when results were not produced in comparable conditions.
+for key in ["compiler", "buildType", "hardwareConcurrency"]:
+    if baselineContext.get(key) != currentContext.get(key):
+        print("Warning: {} differs: {} (baseline) vs {} (current)".format(
+            key, baselineContext.get(key), currentContext.get(key)))
+
+print("{:<48} {:>14} {:>14} {:>9}".format("Benchmark", "Baseline (ns)", "Current (ns)", "Change"))
+regressions = []
+for name, result in current.items():
+    if name not in baseline:
+        print("{:<48} {:>14} {:>14.1f} {:>9}".format(name, "-", result["medianNs"], "new"))
+        continue
+    baselineNs = baseline[name]["medianNs"]
+    currentNs = result["medianNs"]
+    change = (currentNs - baselineNs) / baselineNs if baselineNs > 0 else 0.0
+    flag = ""
+    if change > args.threshold:
+        flag = " <-- regression"
+        regressions.append(name)
+    print("{:<48} {:>14.1f} {:>14.1f} {:>+8.1f}%{}".format(name, baselineNs, currentNs, 100 * change, flag))
+
+for name in baseline:
+    if name not in current:
+        print("{:<48} {:>14.1f} {:>14} {:>9}".format(name, baseline[name]["medianNs"], "-", "missing"))
+
+if regressions:
+    print("{} benchmark(s) regressed by more than {:.1f}%.".format(len(regressions), 100 * args.threshold))
+    sys.exit(1)
+print("No regression above {:.1f}%.".format(100 * args.threshold))
@@ -0,0 +1,55 @@
+#!/bin/bash
+
+#########
+##
+## Compares the footprint and the speed of the C code generated by each code
+## generation engine for a same TPG, with and without a profile of the
+## benchmarked inputs.
+##
+## Usage: compare_codegen_backends.sh <path/to/gegelati-bench> [nbInferences]
+##
+## The code is generated with gegelati-bench --codegen in a temporary folder,
+## and compiled with $CC (default: cc) and $CFLAGS (default: -O2). For each
+## engine, the script prints the size of the text and data sections of the
+## generated code, and the mean duration of an inference. The script exits
+## with an error if the engines do not return the same actions.
+##
+#########
+
+if [ $# -lt 1 ]; then
+	echo "Usage: $0 <path/to/gegelati-bench> [nbInferences]"
+	exit 1
+fi
+
+SCRIPT_FOLDER=$(dirname "$0")
+BENCH=$1
+NB_INFERENCES=${2:-1000000}
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+"$BENCH" --codegen "$WORK" > /dev/null || exit $?
+
+printf "%-16s %10s %10s %14s\n" "engine" "text" "data" "ns/inference"
+CHECKSUM=""
+for ENGINE in switch switch-profiled stack stack-profiled table table-profiled; do
+	DIR="$WORK/$ENGINE"
+	for FILE in policy policy_program; do
+		$CC $CFLAGS -I"$WORK" -I"$DIR" -c "$DIR/$FILE.c" -o "$DIR/$FILE.o" || exit $?
+	done
+	$CC $CFLAGS -I"$WORK" -I"$DIR" "$SCRIPT_FOLDER/../bench/codeGen/codeGenBench.c" \
+		"$DIR/policy.o" "$DIR/policy_program.o" -lm -o "$DIR/codeGenBench" || exit $?
+
+	SIZES=$(size "$DIR/policy.o" "$DIR/policy_program.o" | awk 'NR > 1 { text += $1; data += $2 + $3 } END { print text, data }')
+	read -r NS SUM <<< "$("$DIR/codeGenBench" "$NB_INFERENCES")"
+	read -r TEXT DATA <<< "$SIZES"
+	printf "%-16s %10s %10s %14s\n" "$ENGINE" "$TEXT" "$DATA" "$NS"
+
+	if [ -n "$CHECKSUM" ] && [ "$CHECKSUM" != "$SUM" ]; then
+		echo "Engine $ENGINE returned different actions."
+		exit 1
+	fi
+	CHECKSUM=$SUM
+done
@@ -1,6 +1,6 @@
 #!/bin/bash
 
-SRC_FOLDERS="./gegelatilib/ ./test/"
+SRC_FOLDERS="./gegelatilib/ ./test/ ./bench/"
 EXTENSION_REGEX=".*\.\(cpp\|c\|h\)"
 COMMIT_AUTHOR="Vaader Bot <vaader-bot@insa-rennes.fr>"
 
@@ -0,0 +1,43 @@
+# This script prints the strong- and weak-scaling curves of the training
+# benchmarks from the JSON results of gegelati-bench.
+#
+# Usage: python3 print_scaling.py results.json
+#
+# Benchmarks whose name ends with "/t<n>" are grouped by their name prefix.
+# For strong scaling, the speedup is the time with 1 thread divided by the time
+# with n threads. For weak scaling, where the workload grows with n, the
+# efficiency is the time with 1 thread divided by the time with n threads.
+#
+# License: CeCILL-C
+
+import json
+import re
+import sys
+
+if len(sys.argv) != 2:
+    print("Usage: python3 {} results.json".format(sys.argv[0]))
+    sys.exit(1)
+
+with open(sys.argv[1], "r") as jsonFile:
+    benchmarks = json.load(jsonFile)["benchmarks"]
+
+# Group benchmarks by prefix
+groups = {}
+for benchmark in benchmarks:
+    match = re.match(r'(.*)/t([0-9]+)$', benchmark["name"])
+    if match:
+        groups.setdefault(match.group(1), []).append((int(match.group(2)), benchmark))
+
+for prefix, points in groups.items():
+    points.sort(key=lambda point: point[0])
+    isWeak = "/weak" in prefix
+    print(prefix)
+    print("  {:>8} {:>14} {:>12} {:>14} {:>14}".format(
+        "Threads", "Time (ms)", "Efficiency" if isWeak else "Speedup", "Generations/s", "Actions/s"))
+    reference = points[0][1]["medianNs"] if points[0][0] == 1 else None
+    for nbThreads, benchmark in points:
+        ratio = reference / benchmark["medianNs"] if reference else float("nan")
+        print("  {:>8} {:>14.1f} {:>12.2f} {:>14.2f} {:>14.0f}".format(
+            nbThreads, benchmark["medianNs"] / 1e6, ratio,
+            benchmark.get("generationsPerSecond", float("nan")),
+            benchmark.get("actionsPerSecond", float("nan"))))
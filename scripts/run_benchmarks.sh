@@ -0,0 +1,40 @@
+#!/bin/bash
+
+#########
+##
+## Runs the gegelati-bench executable and compares its results with a
+## baseline, to tell whether a new build is faster on the current machine.
+##
+## Usage: run_benchmarks.sh <path/to/gegelati-bench> [baseline.json] [gegelati-bench options]
+##
+## Results are written in gegelati-bench-<date>.json, in the current folder.
+## Without baseline, the script only runs the benchmarks and prints the
+## scaling of training benchmarks. With a baseline, the script exits with an
+## error if any benchmark is slower than the baseline by more than 5%.
+##
+#########
+
+if [ $# -lt 1 ]; then
+	echo "Usage: $0 <path/to/gegelati-bench> [baseline.json] [gegelati-bench options]"
+	exit 1
+fi
+
+SCRIPT_FOLDER=$(dirname "$0")
+BENCH=$1
+shift
+
+BASELINE=""
+if [ $# -ge 1 ] && [[ "$1" != --* ]]; then
+	BASELINE=$1
+	shift
+fi
+
+RESULTS="gegelati-bench-$(date +%Y%m%d-%H%M%S).json"
+"$BENCH" --json "$RESULTS" "$@" || exit $?
+
+python3 "$SCRIPT_FOLDER/print_scaling.py" "$RESULTS"
+
+if [ -n "$BASELINE" ]; then
+	python3 "$SCRIPT_FOLDER/compare_benchmarks.py" "$BASELINE" "$RESULTS"
+	exit $?
+fi
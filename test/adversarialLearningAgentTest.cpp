@@ -270,9 +270,7 @@ TEST_F(adversarialLearningAgentTest, EvalAllRootsSequential)
     Learn::AdversarialLearningAgent la(le, set, params);
 
     la.init();
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        result;
+    Learn::ResultsTable result;
     ASSERT_NO_THROW(result =
                         la.evaluateAllRoots(0, Learn::LearningMode::TRAINING))
         << "Evaluation from a root failed.";
@@ -298,9 +296,7 @@ TEST_F(adversarialLearningAgentTest, EvalAllRootsParallel)
     Learn::AdversarialLearningAgent la(le, set, params);
 
     la.init();
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        result;
+    Learn::ResultsTable result;
     ASSERT_NO_THROW(result =
                         la.evaluateAllRoots(0, Learn::LearningMode::TRAINING))
         << "Evaluation from a root failed.";
@@ -336,9 +332,7 @@ TEST_F(adversarialLearningAgentTest, EvalAllRootsGoodResults)
     auto secondRoot = roots[1];
     auto thirdRoot = roots[2];
 
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        result;
+    Learn::ResultsTable result;
 
     // this evaluation is custom, see AdversarialLearningAgentWithCustomMakeJobs
     // and FakeAdversarialLearningEnvironment.
@@ -347,15 +341,17 @@ TEST_F(adversarialLearningAgentTest, EvalAllRootsGoodResults)
                         la.evaluateAllRoots(0, Learn::LearningMode::TRAINING))
         << "Evaluation from a root failed.";
 
-    auto iter = result.begin();
-    ASSERT_EQ(firstRoot, iter->second) << "Wrong root has 1st place.";
-    ASSERT_EQ(-0.5, iter++->first->getResult())
+    auto sortedRows = result.getSortedRows();
+    auto iter = sortedRows.begin();
+    ASSERT_EQ(firstRoot, result.getRoot(*iter)) << "Wrong root has 1st place.";
+    ASSERT_EQ(-0.5, result.getScore(*iter++))
         << "Wrong score for 1st root after an eval.";
-    ASSERT_EQ(secondRoot, iter->second) << "Wrong root has 2nd place.";
-    ASSERT_EQ(0.75, iter++->first->getResult())
+    ASSERT_EQ(secondRoot, result.getRoot(*iter))
+        << "Wrong root has 2nd place.";
+    ASSERT_EQ(0.75, result.getScore(*iter++))
         << "Wrong score for 2nd root after an eval.";
-    ASSERT_EQ(thirdRoot, iter->second) << "Wrong root has 3rd place.";
-    ASSERT_EQ(1.75, iter->first->getResult())
+    ASSERT_EQ(thirdRoot, result.getRoot(*iter)) << "Wrong root has 3rd place.";
+    ASSERT_EQ(1.75, result.getScore(*iter))
         << "Wrong score for 3rd root after an eval.";
 }
 
@@ -395,14 +391,10 @@ TEST_F(adversarialLearningAgentTest, EvalAllRootsParallelTrainingDeterminism)
     // Check equality between LearningAgent and ParallelLearningAgent
     ASSERT_EQ(results.size(), resultsSequential.size())
         << "Result maps have a different size.";
-    auto iter = results.begin();
-    auto iterSequential = resultsSequential.begin();
-    while (iter != results.end()) {
-        ASSERT_EQ(iter->first->getResult(), iterSequential->first->getResult())
+    for (size_t row = 0; row < results.size(); row++) {
+        ASSERT_EQ(results.getScore(row), resultsSequential.getScore(row))
             << "Average score between sequential and parallel executions are "
                "differents.";
-        iter++;
-        iterSequential++;
     }
 
     // Check determinism of bestRoot score
@@ -433,15 +425,11 @@ TEST_F(adversarialLearningAgentTest, EvalAllRootsParallelTrainingDeterminism)
     // mode
     ASSERT_EQ(resultsParallel.size(), resultsParallel.size())
         << "Result maps have a different size.";
-    iterSequential = resultsSequential.begin();
-    auto iterParallel = resultsParallel.begin();
-    while (iterSequential != resultsSequential.end()) {
-        ASSERT_EQ(iterSequential->first->getResult(),
-                  iterParallel->first->getResult())
+    for (size_t row = 0; row < resultsSequential.size(); row++) {
+        ASSERT_EQ(resultsSequential.getScore(row),
+                  resultsParallel.getScore(row))
             << "Average score between sequential and parallel executions are "
                "differents.";
-        iterSequential++;
-        iterParallel++;
     }
 
     // Check determinism of bestRoot score
@@ -503,14 +491,10 @@ TEST_F(adversarialLearningAgentTest, EvalAllRootsParallelValidationDeterminism)
     // Check equality between LearningAgent and ParallelLearningAgent
     ASSERT_EQ(results.size(), resultsSequential.size())
         << "Result maps have a different size.";
-    auto iter = results.begin();
-    auto iterSequential = resultsSequential.begin();
-    while (iter != results.end()) {
-        ASSERT_EQ(iter->first->getResult(), iterSequential->first->getResult())
+    for (size_t row = 0; row < results.size(); row++) {
+        ASSERT_EQ(results.getScore(row), resultsSequential.getScore(row))
             << "Average score between sequential and parallel executions are "
                "differents.";
-        iter++;
-        iterSequential++;
     }
 
     // Check determinism of the number of RNG calls.
@@ -528,15 +512,11 @@ TEST_F(adversarialLearningAgentTest, EvalAllRootsParallelValidationDeterminism)
     // mode
     ASSERT_EQ(resultsParallel.size(), resultsParallel.size())
         << "Result maps have a different size.";
-    iterSequential = resultsSequential.begin();
-    auto iterParallel = resultsParallel.begin();
-    while (iterSequential != resultsSequential.end()) {
-        ASSERT_EQ(iterSequential->first->getResult(),
-                  iterParallel->first->getResult())
+    for (size_t row = 0; row < resultsSequential.size(); row++) {
+        ASSERT_EQ(resultsSequential.getScore(row),
+                  resultsParallel.getScore(row))
             << "Average score between sequential and parallel executions are "
                "differents.";
-        iterSequential++;
-        iterParallel++;
     }
 
     // Check determinism of the number of RNG calls.
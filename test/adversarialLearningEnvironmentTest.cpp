@@ -89,9 +89,7 @@ TEST(AdversarialLearningEnvironmentTest, compatibilityLearningAgent)
 
     la.init();
 
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        result;
+    Learn::ResultsTable result;
     ASSERT_NO_THROW(result =
                         la.evaluateAllRoots(0, Learn::LearningMode::TRAINING))
         << "Evaluation from a root failed.";
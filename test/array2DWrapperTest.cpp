@@ -243,6 +243,47 @@ TEST(Array2DWrapperTest, getDataAt)
 #endif
 }
 
+TEST(Array2DWrapperTest, SetView)
+{
+    // 4x6 image, of which the 2x3 region starting at line 1, column 2 is
+    // viewed.
+    const size_t imageH = 4;
+    const size_t imageW = 6;
+    int image[imageH * imageW];
+    for (int idx = 0; idx < imageH * imageW; idx++) {
+        image[idx] = idx;
+    }
+    std::vector<int> regionValues{8, 9, 10, 14, 15, 16};
+    Data::Array2DWrapper<int> a(3, 2, &regionValues);
+    size_t hash = a.getHash();
+
+    ASSERT_NO_THROW(a.setView(image + imageW + 2, 1, imageW))
+        << "Setting a view on a region of a larger array failed.";
+    ASSERT_EQ(a.getHash(), hash)
+        << "Hash of a view should be the same as for a vector with the same "
+           "content.";
+    for (size_t idx = 0; idx < regionValues.size(); idx++) {
+        ASSERT_EQ(
+            *a.getDataAt(typeid(int), idx).getSharedPointer<const int>(),
+            regionValues.at(idx))
+            << "Value read through the view is incorrect.";
+    }
+    std::shared_ptr<const int> array =
+        a.getDataAt(typeid(int[2][2]), 1).getSharedPointer<const int[]>();
+    ASSERT_EQ(array.get()[0], 9);
+    ASSERT_EQ(array.get()[3], 16)
+        << "2D array read through the view is incorrect.";
+
+    // Clone copies the viewed region
+    Data::DataHandler* aClone = a.clone();
+    ASSERT_EQ(aClone->getHash(), hash);
+    delete aClone;
+
+    // Contiguous rows with a stride: every other element of the image
+    ASSERT_NO_THROW(a.setView(image, 2));
+    ASSERT_EQ(*a.getDataAt(typeid(int), 4).getSharedPointer<const int>(), 8);
+}
+
 #ifdef CODE_GENERATION
 TEST(Array2DWrapperTest, getNativeType)
 {
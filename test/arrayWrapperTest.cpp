@@ -35,6 +35,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <sstream>
 
 #include "data/arrayWrapper.h"
 #include "data/dataHandler.h"
@@ -378,6 +379,133 @@ TEST(ArrayWrapperTest, Clone)
     delete dClone;
 }
 
+TEST(ArrayWrapperTest, WriteReadData)
+{
+    std::vector<double> values{1.5, -2.0, 3.25, 0.0};
+    Data::ArrayWrapper<double> d(values.size(), &values);
+
+    std::stringstream stream;
+    ASSERT_NO_THROW(d.writeData(stream))
+        << "Writing the data of an ArrayWrapper failed.";
+
+    std::vector<double> otherValues(values.size());
+    Data::ArrayWrapper<double> other(values.size(), &otherValues);
+    size_t hash = other.getHash();
+    ASSERT_NO_THROW(other.readData(stream))
+        << "Reading the data of an ArrayWrapper failed.";
+    ASSERT_EQ(otherValues, values) << "Data read differs from data written.";
+    ASSERT_NE(other.getHash(), hash)
+        << "Reading data should invalidate the cached hash.";
+
+    // Size mismatch
+    stream.clear();
+    stream.seekg(0);
+    Data::PrimitiveTypeArray<double> smaller(2);
+    ASSERT_THROW(smaller.readData(stream), std::runtime_error)
+        << "Reading data with a different size should fail.";
+
+    // Truncated stream
+    std::stringstream truncated(stream.str().substr(0, 20));
+    ASSERT_THROW(other.readData(truncated), std::runtime_error)
+        << "Reading data from a truncated stream should fail.";
+
+    // Null pointer
+    Data::ArrayWrapper<double> nullWrapper(4);
+    ASSERT_THROW(nullWrapper.writeData(stream), std::runtime_error)
+        << "Writing the data of an ArrayWrapper with a null pointer should "
+           "fail.";
+}
+
+TEST(ArrayWrapperTest, SetView)
+{
+    double values[4] = {1.0, 2.0, 3.0, 4.0};
+    std::vector<double> vectorValues{1.0, 2.0, 3.0, 4.0};
+    Data::ArrayWrapper<double> d(4, &vectorValues);
+    size_t hash = d.getHash();
+
+    ASSERT_NO_THROW(d.setView(values))
+        << "Setting a view on raw memory failed.";
+    ASSERT_EQ(d.getHash(), hash)
+        << "Hash of a view should be the same as for a vector with the same "
+           "content.";
+    ASSERT_EQ(*d.getDataAt(typeid(double), 2).getSharedPointer<const double>(),
+              3.0)
+        << "Data read through the view is incorrect.";
+    ASSERT_EQ(d.getDataAt(typeid(double), 2).getSharedPointer<const double>()
+                  .get(),
+              &values[2])
+        << "Data of a view should not be copied.";
+    std::shared_ptr<const double> array =
+        d.getDataAt(typeid(double[2]), 1).getSharedPointer<const double[]>();
+    ASSERT_EQ(array.get()[1], 3.0)
+        << "Array read through the view is incorrect.";
+
+    // Modification of the viewed memory
+    values[0] = 5.0;
+    d.invalidateCachedHash();
+    ASSERT_NE(d.getHash(), hash)
+        << "Hash should change with the content of the view.";
+
+    // Clone copies the viewed data
+    Data::DataHandler* dClone = d.clone();
+    ASSERT_EQ(dClone->getHash(), d.getHash());
+    values[1] = 6.0;
+    d.invalidateCachedHash();
+    ASSERT_NE(dClone->getHash(), d.getHash())
+        << "Clone of a view should not share its data.";
+    delete dClone;
+
+    // Views are read-only
+    std::stringstream stream;
+    ASSERT_NO_THROW(d.writeData(stream));
+    ASSERT_THROW(d.readData(stream), std::runtime_error)
+        << "Reading data into a view should fail.";
+
+    // Back to a vector
+    d.setPointer(&vectorValues);
+    ASSERT_EQ(d.getHash(), hash);
+    d.setView(nullptr);
+    ASSERT_EQ(d.getHash(), 0);
+}
+
+TEST(ArrayWrapperTest, SetStridedView)
+{
+    // Interleaved values, the second of each pair being viewed.
+    double values[8] = {0.0, 1.0, 0.0, 2.0, 0.0, 3.0, 0.0, 4.0};
+    std::vector<double> vectorValues{1.0, 2.0, 3.0, 4.0};
+    Data::ArrayWrapper<double> d(4, &vectorValues);
+    size_t hash = d.getHash();
+
+    ASSERT_THROW(d.setView(values, 0), std::invalid_argument)
+        << "A view with a null stride should not be accepted.";
+    ASSERT_NO_THROW(d.setView(values + 1, 2))
+        << "Setting a strided view on raw memory failed.";
+    ASSERT_EQ(d.getHash(), hash)
+        << "Hash of a strided view should be the same as for a vector with "
+           "the same content.";
+    ASSERT_EQ(d.getDataAt(typeid(double), 2).getSharedPointer<const double>()
+                  .get(),
+              &values[5])
+        << "Data of a strided view is not read at the right address.";
+    std::shared_ptr<const double> array =
+        d.getDataAt(typeid(double[3]), 1).getSharedPointer<const double[]>();
+    ASSERT_EQ(array.get()[0], 2.0);
+    ASSERT_EQ(array.get()[2], 4.0)
+        << "Array read through the strided view is incorrect.";
+
+    // Clone copies the viewed data contiguously
+    Data::DataHandler* dClone = d.clone();
+    ASSERT_EQ(dClone->getHash(), hash);
+    ASSERT_EQ(*dClone->getDataAt(typeid(double), 3)
+                   .getSharedPointer<const double>(),
+              4.0);
+    delete dClone;
+
+    // Repointing the view invalidates the hash
+    ASSERT_NO_THROW(d.setView(values, 2));
+    ASSERT_NE(d.getHash(), hash);
+}
+
 #ifdef CODE_GENERATION
 TEST(ArrayWrapperTest, getNativeType)
 {
@@ -50,6 +50,7 @@
 #include "learn/classificationLearningAgent.h"
 
 #include "learn/fakeClassificationLearningEnvironment.h"
+#include "learn/replayableClassificationLearningEnvironment.h"
 
 class ClassificationLearningAgentTest : public ::testing::Test
 {
@@ -140,8 +141,9 @@ TEST_F(ClassificationLearningAgentTest, EvaluateRoot)
         << "Average score should not exceed the score of a perfect player.";
 
     // Record this result
-    cla.updateEvaluationRecords(
-        {{result1, cla.getTPGGraph()->getRootVertices().at(0)}});
+    Learn::ResultsTable results1;
+    results1.addRow(cla.getTPGGraph()->getRootVertices().at(0), result1);
+    cla.updateEvaluationRecords(results1);
 
     // Reevaluate to check that the previous result1 is not returned.
     std::shared_ptr<Learn::EvaluationResult> result2;
@@ -154,8 +156,9 @@ TEST_F(ClassificationLearningAgentTest, EvaluateRoot)
     ASSERT_NE(result1, result2);
 
     // Record this result
-    cla.updateEvaluationRecords(
-        {{result2, cla.getTPGGraph()->getRootVertices().at(0)}});
+    Learn::ResultsTable results2;
+    results2.addRow(cla.getTPGGraph()->getRootVertices().at(0), result2);
+    cla.updateEvaluationRecords(results2);
 
     // Reevaluate to check that the previous result2 is returned.
     std::shared_ptr<Learn::EvaluationResult> result3;
@@ -193,12 +196,11 @@ TEST_F(ClassificationLearningAgentTest, DecimateWorstRoots)
 
     // Create and fill results for each "root" artificially with
     // EvaluationResults
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        results;
+    Learn::ResultsTable results;
     double result = 0.0;
     for (const TPG::TPGVertex* root : roots) {
-        results.emplace(new Learn::EvaluationResult(result++, 1), root);
+        results.addRow(root,
+                       std::make_shared<Learn::EvaluationResult>(result++, 1));
     }
 
     // Do the decimation (must fail)
@@ -208,24 +210,6 @@ TEST_F(ClassificationLearningAgentTest, DecimateWorstRoots)
 
     // Create and fill results for each "root" artificially with
     // ClassificationEvaluationResults
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        classifResults;
-    result = 0.0;
-    for (const TPG::TPGVertex* root : roots) {
-        // Init all scores to the same value
-        // Their general score will be 0.33.
-        // With score for 1st class to 0.0
-        std::vector<double> scores(fle.getNbActions(),
-                                   0.33 / (fle.getNbActions() - 1) *
-                                       fle.getNbActions());
-        scores.at(0) = 0.0;
-        std::vector<size_t> nbEval(fle.getNbActions(), 1);
-
-        classifResults.emplace(
-            new Learn::ClassificationEvaluationResult(scores, nbEval), root);
-    }
-
     // Change score for 4 roots, so that
     // the first three have worse than average general score, but good score for
     // 1st class the last has better than average general score, and good score
@@ -233,24 +217,32 @@ TEST_F(ClassificationLearningAgentTest, DecimateWorstRoots)
     // constant)
     ASSERT_EQ(fle.getNbActions(), 3);
     std::vector<const TPG::TPGVertex*> savedRoots;
-    for (auto idx = 0; idx < 4; idx++) {
-        // Select a root results to erase-replace
-        auto iterClassifResults = classifResults.begin();
-        std::advance(iterClassifResults, 3 * idx);
-
-        // get the root
-        const TPG::TPGVertex* root = iterClassifResults->second;
-        savedRoots.push_back(root);
-
-        // Remove from map
-        classifResults.erase(iterClassifResults);
-
-        // Add custom result1
-        std::vector<double> scores(fle.getNbActions(), 0.0);
-        scores.at(0) = 0.25 * (idx + 1.0);
-        std::vector<size_t> nbEvals(fle.getNbActions(), 10);
-        classifResults.emplace(
-            new Learn::ClassificationEvaluationResult(scores, nbEvals), root);
+    Learn::ResultsTable classifResults;
+    for (auto idx = 0; idx < roots.size(); idx++) {
+        const TPG::TPGVertex* root = roots.at(idx);
+        if (idx % 3 == 0 && idx / 3 < 4) {
+            // Add custom result1
+            savedRoots.push_back(root);
+            std::vector<double> scores(fle.getNbActions(), 0.0);
+            scores.at(0) = 0.25 * (idx / 3 + 1.0);
+            std::vector<size_t> nbEvals(fle.getNbActions(), 10);
+            classifResults.addRow(
+                root, std::make_shared<Learn::ClassificationEvaluationResult>(
+                          scores, nbEvals));
+        }
+        else {
+            // Init all scores to the same value
+            // Their general score will be 0.33.
+            // With score for 1st class to 0.0
+            std::vector<double> scores(fle.getNbActions(),
+                                       0.33 / (fle.getNbActions() - 1) *
+                                           fle.getNbActions());
+            scores.at(0) = 0.0;
+            std::vector<size_t> nbEval(fle.getNbActions(), 1);
+            classifResults.addRow(
+                root, std::make_shared<Learn::ClassificationEvaluationResult>(
+                          scores, nbEval));
+        }
     }
 
     // Add an additional
@@ -262,16 +254,14 @@ TEST_F(ClassificationLearningAgentTest, DecimateWorstRoots)
     uint64_t originalNbVertices = graph.getNbVertices();
 
     // Create a poor score for the action and team root
-    classifResults.emplace(
-        new Learn::ClassificationEvaluationResult(
-            std::vector<double>(fle.getNbActions(), 0.0),
-            std::vector<size_t>(fle.getNbActions(), size_t(10))),
-        &actionRoot);
-    classifResults.emplace(
-        new Learn::ClassificationEvaluationResult(
-            std::vector<double>(fle.getNbActions(), 0.0),
-            std::vector<size_t>(fle.getNbActions(), size_t(10))),
-        &teamRoot);
+    classifResults.addRow(
+        &actionRoot, std::make_shared<Learn::ClassificationEvaluationResult>(
+                         std::vector<double>(fle.getNbActions(), 0.0),
+                         std::vector<size_t>(fle.getNbActions(), size_t(10))));
+    classifResults.addRow(
+        &teamRoot, std::make_shared<Learn::ClassificationEvaluationResult>(
+                       std::vector<double>(fle.getNbActions(), 0.0),
+                       std::vector<size_t>(fle.getNbActions(), size_t(10))));
 
     // Do the decimation
     ASSERT_NO_THROW(cla.decimateWorstRoots(classifResults))
@@ -303,3 +293,56 @@ TEST_F(ClassificationLearningAgentTest, DecimateWorstRoots)
                           &teamRoot) == remainingRoots.end())
         << "Action roots with poor score were not preserved during decimation.";
 }
+
+TEST_F(ClassificationLearningAgentTest, ObservationCache)
+{
+    params.archiveSize = 50;
+    params.archivingProbability = 0.5;
+    params.maxNbActionsPerEval = 11;
+    params.nbIterationsPerPolicyEvaluation = 3;
+    params.nbThreads = 2;
+
+    // Reference, without cache
+    ReplayableClassificationLearningEnvironment le1;
+    Learn::ClassificationLearningAgent<Learn::LearningAgent> cla1(le1, set,
+                                                                  params);
+
+    // Sequential and parallel agents with cache
+    params.observationCacheSize = 1;
+    ReplayableClassificationLearningEnvironment le2;
+    Learn::ClassificationLearningAgent<Learn::LearningAgent> cla2(le2, set,
+                                                                  params);
+    ReplayableClassificationLearningEnvironment le3;
+    Learn::ClassificationLearningAgent<Learn::ParallelLearningAgent> cla3(
+        le3, set, params);
+
+    ASSERT_FALSE(cla1.getObservationCache().isEnabled());
+    ASSERT_TRUE(cla2.getObservationCache().isEnabled());
+
+    cla1.init();
+    cla2.init();
+    cla3.init();
+    for (uint64_t i = 0; i < 3; i++) {
+        ASSERT_NO_THROW(cla1.trainOneGeneration(i));
+        ASSERT_NO_THROW(cla2.trainOneGeneration(i))
+            << "Training with observation cache failed.";
+        ASSERT_NO_THROW(cla3.trainOneGeneration(i))
+            << "Parallel training with observation cache failed.";
+        ASSERT_EQ(cla1.getBestScoreLastGen(), cla2.getBestScoreLastGen())
+            << "Replayed observations should give the same results.";
+        ASSERT_EQ(cla1.getBestScoreLastGen(), cla3.getBestScoreLastGen())
+            << "Replayed observations should give the same results.";
+    }
+
+    // Samples are only produced when recording episodes.
+    for (auto cla : std::vector<Learn::LearningAgent*>{&cla2, &cla3}) {
+        const Learn::ObservationCache& cache = cla->getObservationCache();
+        ASSERT_GT(cache.getNbHits(), 0);
+        ASSERT_GT(cache.getNbMisses(), 0);
+    }
+    ASSERT_EQ(le2.getNbSamples(), cla2.getObservationCache().getNbMisses() *
+                                      (params.maxNbActionsPerEval + 1));
+    ASSERT_EQ(le3.getNbSamples(), cla3.getObservationCache().getNbMisses() *
+                                      (params.maxNbActionsPerEval + 1));
+    ASSERT_LT(le2.getNbSamples(), le1.getNbSamples());
+}
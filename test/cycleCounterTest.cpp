@@ -0,0 +1,93 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+#include "util/cycleCounter.h"
+
+TEST(CycleCounterTest, Backends)
+{
+    const Util::CycleCounter clock(Util::CycleCounter::Backend::CLOCK);
+    ASSERT_EQ(clock.getBackend(), Util::CycleCounter::Backend::CLOCK)
+        << "The clock backend should always be available.";
+
+    // Other backends may be unavailable and fall back to the clock.
+    const Util::CycleCounter tsc(Util::CycleCounter::Backend::TSC);
+    ASSERT_TRUE(tsc.getBackend() == Util::CycleCounter::Backend::TSC ||
+                tsc.getBackend() == Util::CycleCounter::Backend::CLOCK);
+#if !defined(__x86_64__) && !defined(__i386__) && !defined(_M_X64)
+    ASSERT_EQ(tsc.getBackend(), Util::CycleCounter::Backend::CLOCK);
+#endif
+
+    const Util::CycleCounter perf(Util::CycleCounter::Backend::PERF_EVENT);
+    ASSERT_TRUE(perf.getBackend() == Util::CycleCounter::Backend::PERF_EVENT ||
+                perf.getBackend() == Util::CycleCounter::Backend::CLOCK);
+}
+
+TEST(CycleCounterTest, BackendNames)
+{
+    ASSERT_EQ(std::string(Util::CycleCounter::getBackendName(
+                  Util::CycleCounter::Backend::CLOCK)),
+              "clock");
+    ASSERT_EQ(std::string(Util::CycleCounter::getBackendName(
+                  Util::CycleCounter::Backend::TSC)),
+              "tsc");
+    ASSERT_EQ(std::string(Util::CycleCounter::getBackendName(
+                  Util::CycleCounter::Backend::PERF_EVENT)),
+              "perf_event");
+}
+
+TEST(CycleCounterTest, Read)
+{
+    for (auto backend : {Util::CycleCounter::Backend::CLOCK,
+                         Util::CycleCounter::Backend::TSC,
+                         Util::CycleCounter::Backend::PERF_EVENT}) {
+        const Util::CycleCounter counter(backend);
+        const uint64_t start = counter.read();
+
+        // Busy wait so that thread time also elapses.
+        volatile uint64_t sum = 0;
+        for (uint64_t i = 0; i < 1000000; i++) {
+            sum = sum + i;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        const uint64_t end = counter.read();
+        ASSERT_GT(end, start)
+            << "Counter " << Util::CycleCounter::getBackendName(
+                                 counter.getBackend())
+            << " should increase over time.";
+    }
+}
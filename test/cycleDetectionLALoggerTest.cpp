@@ -47,9 +47,7 @@ class CycleDetectionLoggerTest : public ::testing::Test
   protected:
     Instructions::Set set;
 
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        results;
+    Learn::ResultsTable results;
 
     StickGameWithOpponent le;
     Learn::LearningParameters params;
@@ -91,10 +89,8 @@ class CycleDetectionLoggerTest : public ::testing::Test
         auto res2 = new Learn::EvaluationResult(10, 2);
         auto v1(new TPG::TPGAction(0));
         auto v2(new TPG::TPGAction(0));
-        results.insert(std::pair<std::shared_ptr<Learn::EvaluationResult>,
-                                 const TPG::TPGVertex*>(res1, v1));
-        results.insert(std::pair<std::shared_ptr<Learn::EvaluationResult>,
-                                 const TPG::TPGVertex*>(res2, v2));
+        results.addRow(v1, std::shared_ptr<Learn::EvaluationResult>(res1));
+        results.addRow(v2, std::shared_ptr<Learn::EvaluationResult>(res2));
 
         la = new Learn::LearningAgent(le, set, params);
     }
@@ -103,10 +99,8 @@ class CycleDetectionLoggerTest : public ::testing::Test
     {
         delete (&set.getInstruction(0));
         delete (&set.getInstruction(1));
-        auto it = results.begin();
-        delete it->second;
-        it++;
-        delete it->second;
+        delete results.getRoot(0);
+        delete results.getRoot(1);
         delete la;
     }
 };
@@ -129,9 +123,7 @@ TEST_F(CycleDetectionLoggerTest, EmptyMethods)
 
     // Call to all empty methods
     l.logAfterDecimate();
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        results;
+    Learn::ResultsTable results;
     l.logAfterEvaluate(results);
     l.logAfterValidate(results);
     l.logEndOfTraining();
@@ -0,0 +1,78 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+/// doc in ../README.md
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ThreeTeamsBatch.h"
+
+#define NB_SAMPLES 1000
+#define NB_INPUTS 8
+
+double* in1;
+
+int main(int argc, char* argv[])
+{
+    static double inputs[NB_SAMPLES * NB_INPUTS];
+    static int actions[NB_SAMPLES];
+    unsigned int seed = 42;
+
+    // Small integer values produce ties between the bids of programs and a
+    // few NaN are inserted to check that batch inference resolves both as
+    // the inference of a single sample does.
+    for (int i = 0; i < NB_SAMPLES * NB_INPUTS; i++) {
+        seed = seed * 1103515245u + 12345u;
+        inputs[i] = (double)((seed >> 16) % 7) - 3.0;
+        if ((seed >> 8) % 23 == 0) {
+            inputs[i] = NAN;
+        }
+    }
+
+    // NB_SAMPLES is not a multiple of TPG_BATCH_SIZE, so that the last chunk
+    // of the batch is partial.
+    inferenceTPGBatch(NB_SAMPLES, inputs, actions);
+
+    for (int i = 0; i < NB_SAMPLES; i++) {
+        in1 = inputs + i * NB_INPUTS;
+        int expected = inferenceTPG();
+        if (actions[i] != expected) {
+            fprintf(stderr, "Sample %d: batch action %d, expected %d.\n", i,
+                    actions[i], expected);
+            return 1;
+        }
+    }
+
+    return 0;
+}
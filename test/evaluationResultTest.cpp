@@ -87,6 +87,33 @@ TEST(EvaluationResultTest, AssignmentAdditionOperator)
            "EvaluationResult classes.";
 }
 
+TEST(EvaluationResultTest, InferenceCost)
+{
+    Learn::EvaluationResult eval1(1.0, 10);
+    Learn::EvaluationResult eval2(2.0, 30);
+    ASSERT_EQ(eval1.getInferenceCost(), 0.0)
+        << "Default inference cost should be 0.";
+
+    eval1.setInferenceCost(4.0);
+    eval2.setInferenceCost(8.0);
+    ASSERT_EQ(eval1.getInferenceCost(), 4.0)
+        << "Getter returned an unexpected value.";
+
+    eval1 += eval2;
+    ASSERT_EQ(eval1.getInferenceCost(), (10 * 4.0 + 30 * 8.0) / (10.0 + 30.0))
+        << "Inference costs should be averaged with the number of "
+           "evaluations.";
+
+    Learn::ClassificationEvaluationResult eval3({3.0, 4.0}, {2, 3});
+    Learn::ClassificationEvaluationResult eval4({1.0, 2.0}, {3, 2});
+    eval3.setInferenceCost(1.0);
+    eval4.setInferenceCost(6.0);
+    eval3 += eval4;
+    ASSERT_EQ(eval3.getInferenceCost(), (5 * 1.0 + 5 * 6.0) / (5.0 + 5.0))
+        << "Inference costs should be averaged with the number of "
+           "evaluations.";
+}
+
 TEST(ClassificationEvaluationResultTest, Constructor)
 {
     Learn::EvaluationResult* eval;
@@ -34,9 +34,12 @@
  * knowledge of the CeCILL-C license and that you accept its terms.
  */
 
+#include <fstream>
 #include <gtest/gtest.h>
 #include <vector>
 
+#include "../lib/JsonCpp/json.h"
+
 #include "data/dataHandler.h"
 #include "data/primitiveTypeArray.h"
 #include "environment.h"
@@ -506,3 +509,50 @@ TEST_F(ExecutionStatsTest, WriteStatsToJson)
                               TESTS_DAT_PATH "execution_stats_ref.json"))
         << "Generated json file is different from the reference file.";
 }
+
+TEST_F(ExecutionStatsTest, MeasuredCosts)
+{
+    TPG::ExecutionStats executionStats;
+    executionStats.analyzeExecution(*execEngine, tpg);
+    ASSERT_EQ(executionStats.getTimingBackend(), "")
+        << "No timing backend should be reported without timing.";
+    ASSERT_EQ(executionStats.getAvgTicksPerInference(), 0.0);
+    ASSERT_TRUE(executionStats.getAvgTicksPerInstruction().empty());
+    ASSERT_TRUE(executionStats.getAvgTicksPerEdge().empty());
+
+    // Execute again with timing
+    dynamic_cast<const TPG::TPGInstrumentedFactory&>(tpg->getFactory())
+        .resetTPGGraphCounters(*tpg);
+    execEngine->clearTraceHistory();
+    execEngine->enableTiming(Util::CycleCounter::Backend::CLOCK);
+    for (int i = 0; i < 10; i++) {
+        execEngine->executeFromRoot(*tpg->getVertices().at(0));
+    }
+
+    executionStats.analyzeExecution(*execEngine, tpg);
+    ASSERT_EQ(executionStats.getTimingBackend(), "clock");
+    ASSERT_GT(executionStats.getAvgTicksPerInference(), 0.0)
+        << "Measured duration of inferences should not be zero.";
+    ASSERT_FALSE(executionStats.getAvgTicksPerInstruction().empty());
+    for (const auto& p : executionStats.getAvgTicksPerInstruction()) {
+        ASSERT_EQ(executionStats.getAvgNbExecutionPerInstruction().count(
+                      p.first),
+                  1)
+            << "Only executed instructions should have a measured cost.";
+    }
+    ASSERT_FALSE(executionStats.getAvgTicksPerEdge().empty());
+
+    ASSERT_NO_THROW(
+        executionStats.writeStatsToJson("execution_stats_costs.json"));
+    Json::Value root;
+    std::ifstream file("execution_stats_costs.json");
+    file >> root;
+    const Json::Value& costs = root["ExecutionStats"]["measuredCosts"];
+    ASSERT_EQ(costs["timingBackend"].asString(), "clock");
+    ASSERT_EQ(costs["edges"].size(),
+              executionStats.getAvgTicksPerEdge().size());
+    ASSERT_EQ(costs["avgTicksPerInstruction"].size(),
+              executionStats.getAvgTicksPerInstruction().size());
+    file.close();
+    std::remove("execution_stats_costs.json");
+}
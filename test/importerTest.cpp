@@ -353,3 +353,42 @@ TEST_F(ImporterTest, setNewFilePath)
                  std::runtime_error)
         << "Changing the input file with an invalid path should not work.";
 }
+
+TEST_F(ImporterTest, parseError)
+{
+    // Copy the valid file, and corrupt the constants of a program.
+    std::ifstream validFile("exported_tpg.dot");
+    std::ofstream wrongFile("malformed_tpg.dot");
+    std::string line;
+    uint64_t lineNumber = 0;
+    uint64_t wrongLine = 0;
+    uint64_t wrongColumn = 0;
+    while (std::getline(validFile, line)) {
+        lineNumber++;
+        size_t pos = line.find("//-2|");
+        if (wrongLine == 0 && pos != std::string::npos &&
+            line.find("P") != std::string::npos) {
+            line.replace(pos + 2, 1, "x");
+            wrongLine = lineNumber;
+            wrongColumn = pos + 3;
+        }
+        wrongFile << line << std::endl;
+    }
+    validFile.close();
+    wrongFile.close();
+    ASSERT_NE(wrongLine, 0) << "Corrupted line not found in exported file.";
+
+    try {
+        File::TPGGraphDotImporter dotImporter("malformed_tpg.dot", *e,
+                                              *tpg_copy);
+        FAIL() << "Importing a malformed file should fail.";
+    }
+    catch (std::runtime_error& error) {
+        std::string expected =
+            "line " + std::to_string(wrongLine) + ", column " +
+            std::to_string(wrongColumn) + ":";
+        ASSERT_NE(std::string(error.what()).find(expected), std::string::npos)
+            << "The error message should give the position of the error: "
+            << error.what();
+    }
+}
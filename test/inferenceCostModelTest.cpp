@@ -0,0 +1,164 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "data/dataHandler.h"
+#include "data/primitiveTypeArray.h"
+#include "environment.h"
+#include "instructions/addPrimitiveType.h"
+#include "instructions/multByConstant.h"
+#include "instructions/set.h"
+#include "program/program.h"
+#include "tpg/tpgGraph.h"
+
+#include "learn/inferenceCostModel.h"
+
+class InferenceCostModelTest : public ::testing::Test
+{
+  protected:
+    std::vector<std::reference_wrapper<const Data::DataHandler>> vect;
+    Instructions::Set set;
+    Environment* e = NULL;
+    TPG::TPGGraph* tpg;
+    std::vector<std::shared_ptr<Program::Program>> progPointers;
+
+    // Add nbLines lines using the given instruction to a Program.
+    void addLines(Program::Program& prog, uint64_t instructionIndex,
+                  uint64_t nbLines)
+    {
+        for (uint64_t i = 0; i < nbLines; i++) {
+            prog.addNewLine().setInstructionIndex(instructionIndex);
+        }
+    }
+
+    void SetUp() override
+    {
+        vect.push_back(*(new Data::PrimitiveTypeArray<double>(4)));
+        set.add(*(new Instructions::AddPrimitiveType<double>()));
+        set.add(*(new Instructions::MultByConstant<double>()));
+        e = new Environment(set, vect, 4, 1);
+        tpg = new TPG::TPGGraph(*e);
+
+        for (int i = 0; i < 4; i++) {
+            progPointers.push_back(std::make_shared<Program::Program>(*e));
+        }
+        addLines(*progPointers.at(0), 0, 2);
+        addLines(*progPointers.at(1), 1, 1);
+        addLines(*progPointers.at(2), 0, 1);
+        addLines(*progPointers.at(3), 1, 3);
+
+        // T0 -> A0, T0 -> T1, T1 -> A1, T1 -> A0, T1 -> T0
+        const TPG::TPGVertex& t0 = tpg->addNewTeam();
+        const TPG::TPGVertex& t1 = tpg->addNewTeam();
+        const TPG::TPGVertex& a0 = tpg->addNewAction(0);
+        const TPG::TPGVertex& a1 = tpg->addNewAction(1);
+        tpg->addNewEdge(t0, a0, progPointers.at(0));
+        tpg->addNewEdge(t0, t1, progPointers.at(1));
+        tpg->addNewEdge(t1, a1, progPointers.at(2));
+        tpg->addNewEdge(t1, a0, progPointers.at(0));
+        tpg->addNewEdge(t1, t0, progPointers.at(3));
+    }
+
+    void TearDown() override
+    {
+        delete tpg;
+        delete e;
+        delete (&(vect.at(0).get()));
+        delete (&set.getInstruction(0));
+        delete (&set.getInstruction(1));
+    }
+};
+
+TEST_F(InferenceCostModelTest, InstructionCost)
+{
+    Learn::InferenceCostModel model(2.0, {1.0, 4.0});
+    ASSERT_EQ(model.getInstructionCost(1), 4.0)
+        << "Cost of an instruction is incorrect.";
+    ASSERT_EQ(model.getInstructionCost(2), 1.0)
+        << "Instructions without cost should cost 1.0.";
+}
+
+TEST_F(InferenceCostModelTest, ProgramCost)
+{
+    Learn::InferenceCostModel model(2.0, {1.5, 4.0});
+    ASSERT_EQ(model.getProgramCost(*progPointers.at(0)), 3.0);
+    ASSERT_EQ(model.getProgramCost(*progPointers.at(3)), 12.0);
+
+    progPointers.at(3)->setIntron(1, true);
+    ASSERT_EQ(model.getProgramCost(*progPointers.at(3)), 8.0)
+        << "Intron lines should not be counted.";
+}
+
+TEST_F(InferenceCostModelTest, TraceCost)
+{
+    const auto vertices = tpg->getVertices();
+    const Learn::InferenceCostModel defaultModel;
+    ASSERT_EQ(defaultModel.getTraceCost({}), 0.0)
+        << "Empty trace should cost nothing.";
+    ASSERT_EQ(defaultModel.getTraceCost({vertices.at(0), vertices.at(2)}),
+              1.0 + 2.0 + 1.0)
+        << "Cost of the trace is incorrect.";
+
+    // Edge from T1 to T0 is not evaluated when reaching T1 from T0.
+    const Learn::InferenceCostModel model(2.0, {1.0, 4.0});
+    ASSERT_EQ(model.getTraceCost(
+                  {vertices.at(0), vertices.at(1), vertices.at(3)}),
+              (2.0 + 2.0 + 4.0) + (2.0 + 1.0 + 2.0))
+        << "Cost of the trace is incorrect.";
+}
+
+TEST_F(InferenceCostModelTest, TraceCostCache)
+{
+    const auto vertices = tpg->getVertices();
+    const Learn::InferenceCostModel model(2.0, {1.0, 4.0});
+    Learn::InferenceCostModel::ProgramCostCache programCosts;
+
+    const std::vector<const TPG::TPGVertex*> trace{
+        vertices.at(0), vertices.at(1), vertices.at(3)};
+    ASSERT_EQ(model.getTraceCost(trace, programCosts),
+              model.getTraceCost(trace))
+        << "Cost of the trace should not depend on the cache.";
+    ASSERT_EQ(programCosts.size(), 3)
+        << "Costs of the evaluated Program should be memoized.";
+    ASSERT_EQ(programCosts.at(progPointers.at(1).get()), 4.0)
+        << "Memoized cost of a Program is incorrect.";
+
+    // Memoized costs are used, even if the Program changed.
+    programCosts.at(progPointers.at(1).get()) = 10.0;
+    ASSERT_EQ(model.getTraceCost(trace, programCosts),
+              model.getTraceCost(trace) + 6.0)
+        << "Memoized costs of Program should be used.";
+}
@@ -0,0 +1,205 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "instructions/addPrimitiveType.h"
+#include "instructions/set.h"
+#include "tpg/tpgGraph.h"
+
+#include "learn/islandLearningAgent.h"
+#include "learn/learningParameters.h"
+#include "learn/stickGameWithOpponent.h"
+
+class IslandLearningAgentTest : public ::testing::Test
+{
+  protected:
+    Instructions::Set set;
+    StickGameWithOpponent le;
+    Learn::LearningParameters params;
+
+    void SetUp() override
+    {
+        set.add(*(new Instructions::AddPrimitiveType<int>()));
+        set.add(*(new Instructions::AddPrimitiveType<double>()));
+
+        params.archiveSize = 50;
+        params.archivingProbability = 0.5;
+        params.maxNbActionsPerEval = 11;
+        params.nbIterationsPerPolicyEvaluation = 3;
+        params.ratioDeletedRoots = 0.2;
+        params.nbGenerations = 4;
+        params.maxNbEvaluationPerPolicy =
+            params.nbIterationsPerPolicyEvaluation * 2;
+        params.mutation.tpg.maxInitOutgoingEdges = 3;
+        params.mutation.prog.maxProgramSize = 96;
+        params.mutation.tpg.nbRoots = 10;
+        params.mutation.tpg.pEdgeDeletion = 0.7;
+        params.mutation.tpg.pEdgeAddition = 0.7;
+        params.mutation.tpg.pProgramMutation = 0.2;
+        params.mutation.tpg.pEdgeDestinationChange = 0.1;
+        params.mutation.tpg.pEdgeDestinationIsAction = 0.5;
+        params.mutation.tpg.maxOutgoingEdges = 4;
+        params.mutation.prog.pAdd = 0.5;
+        params.mutation.prog.pDelete = 0.5;
+        params.mutation.prog.pMutate = 1.0;
+        params.mutation.prog.pSwap = 1.0;
+        params.nbIslands = 3;
+        params.migrationInterval = 2;
+        params.nbMigrants = 2;
+    }
+
+    void TearDown() override
+    {
+        delete (&set.getInstruction(0));
+        delete (&set.getInstruction(1));
+    }
+};
+
+TEST_F(IslandLearningAgentTest, Constructor)
+{
+    Learn::IslandLearningAgent* ila;
+
+    ASSERT_NO_THROW(ila = new Learn::IslandLearningAgent(le, set, params))
+        << "Construction of the IslandLearningAgent failed.";
+    ASSERT_EQ(ila->getNbIslands(), 3)
+        << "Number of islands is incorrect.";
+    ASSERT_NO_THROW(delete ila)
+        << "Destruction of the IslandLearningAgent failed.";
+
+    params.nbIslands = 0;
+    ASSERT_THROW(Learn::IslandLearningAgent(le, set, params),
+                 std::runtime_error)
+        << "Construction of an IslandLearningAgent without island should "
+           "fail.";
+}
+
+TEST_F(IslandLearningAgentTest, Init)
+{
+    Learn::IslandLearningAgent ila(le, set, params);
+
+    ASSERT_NO_THROW(ila.init(3)) << "Initialization of islands failed.";
+
+    // Island i is initialized as a LearningAgent with seed 3 + i.
+    for (size_t i = 0; i < ila.getNbIslands(); i++) {
+        Learn::LearningAgent la(le, set, params);
+        la.init(3 + i);
+        ASSERT_EQ(ila.getIsland(i).getTPGGraph()->getNbVertices(),
+                  la.getTPGGraph()->getNbVertices())
+            << "Island " << i << " was not initialized with its own seed.";
+        ASSERT_EQ(ila.getIsland(i).getTPGGraph()->getEdges().size(),
+                  la.getTPGGraph()->getEdges().size())
+            << "Island " << i << " was not initialized with its own seed.";
+    }
+    ASSERT_THROW(ila.getIsland(3), std::out_of_range)
+        << "Access to a non-existing island should fail.";
+}
+
+TEST_F(IslandLearningAgentTest, Migrate)
+{
+    params.migrationInterval = 0;
+    Learn::IslandLearningAgent ila(le, set, params);
+    ila.init();
+
+    // No result yet: nothing migrates.
+    size_t nbVertices = ila.getIsland(1).getTPGGraph()->getNbVertices();
+    ASSERT_NO_THROW(ila.migrate()) << "Migration failed.";
+    ASSERT_EQ(ila.getIsland(1).getTPGGraph()->getNbVertices(), nbVertices)
+        << "Roots without results should not migrate.";
+
+    ASSERT_NO_THROW(ila.trainOneGeneration(0))
+        << "Training islands for one generation failed.";
+
+    std::vector<size_t> nbRoots;
+    for (size_t i = 0; i < ila.getNbIslands(); i++) {
+        nbRoots.push_back(
+            ila.getIsland(i).getTPGGraph()->getNbRootVertices());
+    }
+    ASSERT_NO_THROW(ila.migrate()) << "Migration failed.";
+    for (size_t i = 0; i < ila.getNbIslands(); i++) {
+        ASSERT_EQ(ila.getIsland(i).getTPGGraph()->getNbRootVertices(),
+                  nbRoots.at(i) + params.nbMigrants)
+            << "Island " << i << " did not receive the expected migrants.";
+    }
+
+    // Migrants are evaluated in their new island.
+    ASSERT_NO_THROW(ila.trainOneGeneration(1))
+        << "Training islands after a migration failed.";
+}
+
+TEST_F(IslandLearningAgentTest, Train)
+{
+    params.nbThreads = 2;
+    Learn::IslandLearningAgent ila(le, set, params);
+    ila.init();
+
+    bool alt = false;
+    ASSERT_EQ(ila.train(alt), params.nbGenerations)
+        << "Training did not complete all generations.";
+    ASSERT_NE(ila.getBestRoot().first, nullptr)
+        << "No best root was found after training.";
+    ASSERT_LT(ila.getBestIsland(), ila.getNbIslands())
+        << "Best island index is incorrect.";
+
+    alt = true;
+    ASSERT_EQ(ila.train(alt), 0)
+        << "Training should not start when altTraining is set.";
+}
+
+TEST_F(IslandLearningAgentTest, TrainDeterminism)
+{
+    params.nbThreads = 1;
+    Learn::IslandLearningAgent ila1(le, set, params);
+    params.nbThreads = 3;
+    Learn::IslandLearningAgent ila3(le, set, params);
+    ila1.init(7);
+    ila3.init(7);
+
+    bool alt = false;
+    ila1.train(alt);
+    ila3.train(alt);
+
+    for (size_t i = 0; i < ila1.getNbIslands(); i++) {
+        const TPG::TPGGraph& g1 = *ila1.getIsland(i).getTPGGraph();
+        const TPG::TPGGraph& g3 = *ila3.getIsland(i).getTPGGraph();
+        ASSERT_EQ(g1.getNbVertices(), g3.getNbVertices())
+            << "Island " << i << " differs with the number of threads.";
+        ASSERT_EQ(g1.getEdges().size(), g3.getEdges().size())
+            << "Island " << i << " differs with the number of threads.";
+        ASSERT_EQ(ila1.getIsland(i).getBestScoreLastGen(),
+                  ila3.getIsland(i).getBestScoreLastGen())
+            << "Island " << i << " differs with the number of threads.";
+    }
+}
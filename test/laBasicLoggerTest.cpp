@@ -50,9 +50,7 @@ class LABasicLoggerTest : public ::testing::Test
   protected:
     Instructions::Set set;
 
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        results;
+    Learn::ResultsTable results;
 
     StickGameWithOpponent le;
     Learn::LearningParameters params;
@@ -90,14 +88,12 @@ class LABasicLoggerTest : public ::testing::Test
         set.add(*(new Instructions::AddPrimitiveType<double>()));
         set.add(*(new Instructions::MultByConstant<double>()));
 
-        auto res1 = new Learn::EvaluationResult(5, 2);
-        auto res2 = new Learn::EvaluationResult(10, 2);
+        auto res1 = std::make_shared<Learn::EvaluationResult>(5, 2);
+        auto res2 = std::make_shared<Learn::EvaluationResult>(10, 2);
         auto v1(new TPG::TPGAction(0));
         auto v2(new TPG::TPGAction(0));
-        results.insert(std::pair<std::shared_ptr<Learn::EvaluationResult>,
-                                 const TPG::TPGVertex*>(res1, v1));
-        results.insert(std::pair<std::shared_ptr<Learn::EvaluationResult>,
-                                 const TPG::TPGVertex*>(res2, v2));
+        results.addRow(v1, res1);
+        results.addRow(v2, res2);
 
         la = new Learn::LearningAgent(le, set, params);
     }
@@ -106,10 +102,8 @@ class LABasicLoggerTest : public ::testing::Test
     {
         delete (&set.getInstruction(0));
         delete (&set.getInstruction(1));
-        auto it = results.begin();
-        delete it->second;
-        it++;
-        delete it->second;
+        delete results.getRoot(0);
+        delete results.getRoot(1);
         delete la;
     }
 };
@@ -291,3 +285,62 @@ TEST_F(LABasicLoggerTest, logEndOfTraining)
     ASSERT_EQ(result.size(), 9 + 10)
         << "logEndOfTraining with and without valid should have 4+3=7 elements";
 }
+
+/// LABasicLogger slowing down the populating step and recording durations.
+class SlowPopulateLogger : public Log::LABasicLogger
+{
+  public:
+    std::vector<double> mutationTimes;
+    std::vector<double> validTimes;
+
+    SlowPopulateLogger(Learn::LearningAgent& la, std::ostream& out)
+        : Log::LABasicLogger(la, out)
+    {
+    }
+
+    void logBeforePopulateTPG() override
+    {
+        Log::LABasicLogger::logBeforePopulateTPG();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    void logEndOfTraining() override
+    {
+        Log::LABasicLogger::logEndOfTraining();
+        this->mutationTimes.push_back(this->mutationTime);
+        this->validTimes.push_back(this->validTime);
+    }
+};
+
+TEST_F(LABasicLoggerTest, PipelinedValidationTimes)
+{
+    // With a pipelined validation, the logs of a generation are delivered
+    // after the populating step of the next one. The populating step shall
+    // still be counted in the mutation time, and not in the validation time.
+    // Programs of the fixture Instructions::Set cannot read the int data of
+    // the environment, and would never get a new behavior when mutated.
+    Instructions::AddPrimitiveType<int> addInt;
+    Instructions::AddPrimitiveType<double> addDouble;
+    Instructions::Set intSet;
+    intSet.add(addInt);
+    intSet.add(addDouble);
+    params.doValidation = true;
+    params.pipelineValidation = true;
+    Learn::LearningAgent agent(le, intSet, params);
+    agent.init();
+
+    std::stringstream strStr;
+    SlowPopulateLogger l(agent, strStr);
+
+    agent.trainOneGeneration(0);
+    agent.trainOneGeneration(1);
+    agent.waitForValidation();
+
+    ASSERT_EQ(l.mutationTimes.size(), 2);
+    for (size_t i = 0; i < 2; i++) {
+        ASSERT_GE(l.mutationTimes.at(i), 0.1)
+            << "Populating step missing from the mutation time.";
+        ASSERT_LT(l.validTimes.at(i), 0.1)
+            << "Populating step counted in the validation time.";
+    }
+}
@@ -113,9 +113,7 @@ TEST_F(LAPolicyStatsLoggerTest, LogAfterEvaluate)
     ASSERT_NO_THROW(log.logNewGeneration(genNumber))
         << "This call should not throw any exception.";
     // No need to give anything as a parameter.
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        emptyMap;
+    Learn::ResultsTable emptyResults;
     ASSERT_NO_THROW(log.logAfterDecimate())
         << "Logging after an evaluation failed unexpectedly.";
 
@@ -148,16 +146,14 @@ TEST_F(LAPolicyStatsLoggerTest, EmptyMethods)
 
     // Explicit calls to empty method to force code coverage.
     // These methods are called during la.trainOneGeneration
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        emptyMap;
+    Learn::ResultsTable emptyResults;
     log.logAfterPopulateTPG();
     log.logEndOfTraining();
-    log.logAfterEvaluate(emptyMap);
+    log.logAfterEvaluate(emptyResults);
 
     // These methods are not called otherwise
     log.logHeader();
-    log.logAfterValidate(emptyMap);
+    log.logAfterValidate(emptyResults);
 
     ASSERT_EQ(strStr.str().size(), 0)
         << "Empty method should not generate any log.";
@@ -0,0 +1,269 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "../lib/JsonCpp/json.h"
+#include "instructions/addPrimitiveType.h"
+#include "learn/learningAgent.h"
+#include "learn/parallelLearningAgent.h"
+#include "learn/stickGameWithOpponent.h"
+
+#include "log/laProfilerLogger.h"
+#include "util/profiler.h"
+
+class LAProfilerLoggerTest : public ::testing::Test
+{
+  protected:
+    Instructions::Set set;
+    StickGameWithOpponent le;
+    Learn::LearningParameters params;
+    Learn::LearningAgent* la;
+
+    void SetUp() override
+    {
+        params.mutation.tpg.maxInitOutgoingEdges = 3;
+        params.mutation.prog.maxProgramSize = 96;
+        params.mutation.tpg.nbRoots = 15;
+        params.mutation.tpg.pEdgeDeletion = 0.7;
+        params.mutation.tpg.pEdgeAddition = 0.7;
+        params.mutation.tpg.pProgramMutation = 0.2;
+        params.mutation.tpg.pEdgeDestinationChange = 0.1;
+        params.mutation.tpg.pEdgeDestinationIsAction = 0.5;
+        params.mutation.tpg.maxOutgoingEdges = 4;
+        params.mutation.prog.pAdd = 0.5;
+        params.mutation.prog.pDelete = 0.5;
+        params.mutation.prog.pMutate = 1.0;
+        params.mutation.prog.pSwap = 1.0;
+        params.nbProgramConstant = 0;
+
+        params.archiveSize = 50;
+        params.archivingProbability = 0.5;
+        params.maxNbActionsPerEval = 11;
+        params.nbIterationsPerPolicyEvaluation = 3;
+        params.ratioDeletedRoots = 0.5;
+        params.nbThreads = 1;
+
+        set.add(*(new Instructions::AddPrimitiveType<int>()));
+        set.add(*(new Instructions::AddPrimitiveType<double>()));
+
+        la = new Learn::LearningAgent(le, set, params);
+    }
+
+    void TearDown() override
+    {
+        Util::Profiler::enable(false);
+        Util::Profiler::clear();
+        delete la;
+        delete (&set.getInstruction(0));
+        delete (&set.getInstruction(1));
+    }
+
+    /// Parse a line of JSON.
+    static Json::Value parse(const std::string& line)
+    {
+        Json::Value root;
+        std::istringstream stream(line);
+        stream >> root;
+        return root;
+    }
+};
+
+TEST_F(LAProfilerLoggerTest, Constructor)
+{
+    Log::LAProfilerLogger* log = nullptr;
+    Util::Profiler::enable(false);
+    ASSERT_NO_THROW(log = new Log::LAProfilerLogger(*la));
+    ASSERT_TRUE(Util::Profiler::isEnabled())
+        << "The logger should enable the Profiler.";
+    delete log;
+
+    ASSERT_THROW(Log::LAProfilerLogger(*la, std::cout,
+                                       "/non_existing_dir/trace.json"),
+                 std::runtime_error)
+        << "Opening a trace file in a non existing directory should fail.";
+}
+
+TEST_F(LAProfilerLoggerTest, LogEndOfTraining)
+{
+    std::stringstream strStr;
+    Log::LAProfilerLogger log(*la, strStr);
+
+    // Simulate a generation evaluated by two threads
+    uint64_t generation = 7;
+    log.logNewGeneration(generation);
+    {
+        Util::Profiler::ScopedTimer populate("populate");
+    }
+    {
+        Util::Profiler::ScopedTimer evaluate("evaluate");
+        std::thread worker([]() {
+            Util::Profiler::ScopedTimer thread("evaluationThread", "evaluate");
+            Util::Profiler::ScopedTimer job("evaluateJob");
+            Util::Profiler::count("episodes", 2);
+        });
+        {
+            Util::Profiler::ScopedTimer job("evaluateJob");
+            Util::Profiler::count("episodes", 1);
+        }
+        worker.join();
+    }
+    log.logEndOfTraining();
+
+    std::string line;
+    std::getline(strStr, line);
+    Json::Value root = parse(line);
+    ASSERT_EQ(root["generation"].asUInt64(), 7);
+
+    const Json::Value& phases = root["phases"];
+    ASSERT_EQ(phases.size(), 2);
+    ASSERT_EQ(phases[0]["name"].asString(), "evaluate");
+    ASSERT_EQ(phases[0]["count"].asUInt64(), 1);
+    ASSERT_EQ(phases[1]["name"].asString(), "populate");
+    ASSERT_FALSE(phases[1].isMember("children"));
+
+    // evaluate > evaluateJob, evaluate > evaluationThread > evaluateJob
+    const Json::Value& children = phases[0]["children"];
+    ASSERT_EQ(children.size(), 2);
+    ASSERT_EQ(children[0]["name"].asString(), "evaluateJob");
+    ASSERT_EQ(children[1]["name"].asString(), "evaluationThread");
+    ASSERT_EQ(children[1]["children"][0]["name"].asString(), "evaluateJob");
+    ASSERT_LE(children[0]["time"].asDouble(), phases[0]["time"].asDouble());
+
+    ASSERT_EQ(root["counters"]["episodes"].asUInt64(), 3);
+    ASSERT_EQ(root["threads"].size(), 2);
+    ASSERT_GE(root["evaluationIdleTime"].asDouble(), 0.0);
+
+    // Data is collected once per generation
+    log.logEndOfTraining();
+    std::getline(strStr, line);
+    root = parse(line);
+    ASSERT_EQ(root["phases"].size(), 0);
+    ASSERT_EQ(root["counters"].size(), 0);
+}
+
+TEST_F(LAProfilerLoggerTest, TraceFile)
+{
+    std::string path = "profilerTrace.json";
+    std::stringstream strStr;
+    {
+        Log::LAProfilerLogger log(*la, strStr, path);
+        for (uint64_t generation = 0; generation < 2; generation++) {
+            log.logNewGeneration(generation);
+            {
+                Util::Profiler::ScopedTimer evaluate("evaluate");
+                Util::Profiler::ScopedTimer job("evaluateJob");
+                Util::Profiler::count("episodes", 1);
+            }
+            log.logEndOfTraining();
+        }
+    }
+
+    // The trace file is a valid JSON array of events
+    Json::Value trace;
+    std::ifstream traceFile(path);
+    ASSERT_TRUE(traceFile.is_open());
+    ASSERT_NO_THROW(traceFile >> trace);
+    ASSERT_TRUE(trace.isArray());
+    ASSERT_EQ(trace.size(), 6);
+    ASSERT_EQ(trace[0]["name"].asString(), "evaluate");
+    ASSERT_EQ(trace[0]["ph"].asString(), "X");
+    ASSERT_EQ(trace[0]["args"]["generation"].asUInt64(), 0);
+    ASSERT_EQ(trace[1]["name"].asString(), "evaluateJob");
+    ASSERT_EQ(trace[1]["cat"].asString(), "evaluate");
+    ASSERT_EQ(trace[2]["ph"].asString(), "C");
+    ASSERT_EQ(trace[2]["args"]["episodes"].asUInt64(), 1);
+    ASSERT_EQ(trace[3]["args"]["generation"].asUInt64(), 1);
+    ASSERT_GE(trace[3]["ts"].asDouble(), trace[0]["ts"].asDouble());
+    traceFile.close();
+    std::remove(path.c_str());
+}
+
+#ifdef GEGELATI_PROFILING
+TEST_F(LAProfilerLoggerTest, TrainOneGeneration)
+{
+    std::stringstream strStr;
+    Log::LAProfilerLogger log(*la, strStr);
+    la->addLogger(log);
+    la->init();
+    la->trainOneGeneration(0);
+
+    std::string line;
+    std::getline(strStr, line);
+    Json::Value root = parse(line);
+
+    std::set<std::string> phaseNames;
+    for (const Json::Value& phase : root["phases"]) {
+        phaseNames.insert(phase["name"].asString());
+    }
+    ASSERT_EQ(phaseNames,
+              (std::set<std::string>{"populate", "evaluate", "decimate"}));
+    ASSERT_GT(root["counters"]["episodes"].asUInt64(), 0);
+    ASSERT_GT(root["counters"]["actions"].asUInt64(), 0);
+    ASSERT_EQ(root["threads"].size(), 1);
+}
+
+TEST_F(LAProfilerLoggerTest, NbEventsPerGeneration)
+{
+    // Events are kept for phases and jobs, whereas scopes executed for each
+    // action or mutated Program are only accumulated in statistics.
+    params.nbThreads = 2;
+    Learn::ParallelLearningAgent pla(le, set, params);
+    pla.init();
+    Util::Profiler::clear();
+    Util::Profiler::enable();
+    pla.trainOneGeneration(0);
+    Util::Profiler::enable(false);
+    std::vector<Util::Profiler::Event> events =
+        Util::Profiler::collectEvents();
+    std::map<std::pair<std::string, std::string>, Util::Profiler::PhaseStats>
+        phases = Util::Profiler::collectPhases();
+
+    for (const Util::Profiler::Event& event : events) {
+        ASSERT_NE(std::string(event.name), "executeFromRoot");
+        ASSERT_NE(std::string(event.name), "doAction");
+        ASSERT_NE(std::string(event.name), "mutateProgram");
+        ASSERT_LT(event.depth, Util::Profiler::getMaxTraceDepth());
+    }
+    // At most a cloneRoot, mutateTeam and mutatePrograms per new root, and
+    // an evaluateJob per root, plus a few phases and thread scopes.
+    ASSERT_LE(events.size(), 4 * params.mutation.tpg.nbRoots + 16);
+    ASSERT_GT((phases.at({"evaluateJob", "doAction"}).count), events.size())
+        << "Statistics should be kept for each action.";
+}
+#endif
@@ -0,0 +1,105 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef REPLAYABLE_CLASSIFICATION_LEARNING_ENVIRONMENT_H
+#define REPLAYABLE_CLASSIFICATION_LEARNING_ENVIRONMENT_H
+
+#include <atomic>
+#include <memory>
+
+#include "fakeClassificationLearningEnvironment.h"
+
+/**
+ * \brief Action-independent and copyable classification learning environment
+ * for testing purposes.
+ *
+ * Each sample presented to the LearningAgent depends only on the seed given
+ * to the reset and on the number of actions executed since. The number of
+ * samples produced is counted, and shared with all copies.
+ */
+class ReplayableClassificationLearningEnvironment
+    : public FakeClassificationLearningEnvironment
+{
+  protected:
+    std::shared_ptr<std::atomic<uint64_t>> nbSamples;
+
+    void setSample(int newValue)
+    {
+        this->value = newValue;
+        this->currentClass = value % 3;
+        this->data.setDataAt(typeid(int), 0, value);
+        (*this->nbSamples)++;
+    }
+
+  public:
+    ReplayableClassificationLearningEnvironment()
+        : FakeClassificationLearningEnvironment(),
+          nbSamples(std::make_shared<std::atomic<uint64_t>>(0)){};
+
+    uint64_t getNbSamples() const
+    {
+        return *this->nbSamples;
+    }
+
+    bool isActionIndependent() const override
+    {
+        return true;
+    }
+
+    bool isCopyable() const override
+    {
+        return true;
+    }
+
+    Learn::LearningEnvironment* clone() const override
+    {
+        return new ReplayableClassificationLearningEnvironment(*this);
+    }
+
+    void doAction(uint64_t actionId) override
+    {
+        ClassificationLearningEnvironment::doAction(actionId);
+        this->setSample(this->value + 7);
+    }
+
+    void reset(size_t seed, Learn::LearningMode mode,
+               uint16_t iterationNumber = 0,
+               uint64_t generationNumber = 0) override
+    {
+        ClassificationLearningEnvironment::reset(seed, mode);
+        this->setSample((int)(seed % 1000));
+    };
+};
+
+#endif // !REPLAYABLE_CLASSIFICATION_LEARNING_ENVIRONMENT_H
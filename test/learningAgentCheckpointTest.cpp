@@ -0,0 +1,317 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+#include "instructions/addPrimitiveType.h"
+#include "instructions/set.h"
+#include "tpg/tpgGraph.h"
+
+#include "learn/learningAgent.h"
+#include "learn/learningParameters.h"
+#include "learn/stickGameWithOpponent.h"
+
+#include "file/learningAgentCheckpoint.h"
+
+class LearningAgentCheckpointTest : public ::testing::Test
+{
+  protected:
+    Instructions::Set set;
+    StickGameWithOpponent le;
+    Learn::LearningParameters params;
+
+    void SetUp() override
+    {
+        set.add(*(new Instructions::AddPrimitiveType<int>()));
+        set.add(*(new Instructions::AddPrimitiveType<double>()));
+
+        params.archiveSize = 50;
+        params.archivingProbability = 0.5;
+        params.maxNbActionsPerEval = 11;
+        params.nbIterationsPerPolicyEvaluation = 3;
+        params.ratioDeletedRoots = 0.2;
+        params.nbGenerations = 4;
+        params.maxNbEvaluationPerPolicy =
+            params.nbIterationsPerPolicyEvaluation * 2;
+        params.nbProgramConstant = 5;
+        params.mutation.tpg.maxInitOutgoingEdges = 3;
+        params.mutation.prog.maxProgramSize = 96;
+        params.mutation.tpg.nbRoots = 15;
+        params.mutation.tpg.pEdgeDeletion = 0.7;
+        params.mutation.tpg.pEdgeAddition = 0.7;
+        params.mutation.tpg.pProgramMutation = 0.2;
+        params.mutation.tpg.pEdgeDestinationChange = 0.1;
+        params.mutation.tpg.pEdgeDestinationIsAction = 0.5;
+        params.mutation.tpg.maxOutgoingEdges = 4;
+        params.mutation.prog.pAdd = 0.5;
+        params.mutation.prog.pDelete = 0.5;
+        params.mutation.prog.pMutate = 1.0;
+        params.mutation.prog.pSwap = 1.0;
+        params.mutation.prog.pConstantMutation = 0.5;
+        params.mutation.prog.minConstValue = -10;
+        params.mutation.prog.maxConstValue = 10;
+    }
+
+    void TearDown() override
+    {
+        delete (&set.getInstruction(0));
+        delete (&set.getInstruction(1));
+    }
+
+    /// Check that two LearningAgent have identical TPGGraph and results.
+    void checkSameState(Learn::LearningAgent& la1, Learn::LearningAgent& la2)
+    {
+        const TPG::TPGGraph& g1 = *la1.getTPGGraph();
+        const TPG::TPGGraph& g2 = *la2.getTPGGraph();
+        ASSERT_EQ(g1.getNbVertices(), g2.getNbVertices())
+            << "Number of vertices differs.";
+        ASSERT_EQ(g1.getNbRootVertices(), g2.getNbRootVertices())
+            << "Number of roots differs.";
+        ASSERT_EQ(g1.getEdges().size(), g2.getEdges().size())
+            << "Number of edges differs.";
+        auto edge2 = g2.getEdges().begin();
+        for (const auto& edge1 : g1.getEdges()) {
+            const Program::Program& p1 = edge1->getProgram();
+            const Program::Program& p2 = (*edge2)->getProgram();
+            ASSERT_EQ(p1.getNbLines(), p2.getNbLines())
+                << "Program of edges differs.";
+            for (uint64_t i = 0; i < p1.getNbLines(); i++) {
+                ASSERT_EQ(p1.getLine(i), p2.getLine(i))
+                    << "Program lines differ.";
+            }
+            for (size_t i = 0; i < params.nbProgramConstant; i++) {
+                ASSERT_EQ(p1.getConstantAt(i), p2.getConstantAt(i))
+                    << "Program constants differ.";
+            }
+            edge2++;
+        }
+        ASSERT_EQ(la1.getResultsPerRoot().size(),
+                  la2.getResultsPerRoot().size())
+            << "Number of root results differs.";
+        ASSERT_EQ(la1.getBestScoreLastGen(), la2.getBestScoreLastGen())
+            << "Best score of last generation differs.";
+        ASSERT_EQ(la1.getBestRoot().second->getResult(),
+                  la2.getBestRoot().second->getResult())
+            << "Best root result differs.";
+        ASSERT_EQ(la1.getBestRoot().second->getInferenceCost(),
+                  la2.getBestRoot().second->getInferenceCost())
+            << "Best root inference cost differs.";
+        ASSERT_EQ(la1.getArchive().getNbRecordings(),
+                  la2.getArchive().getNbRecordings())
+            << "Number of archive recordings differs.";
+        ASSERT_EQ(la1.getArchive().getNbDataHandlers(),
+                  la2.getArchive().getNbDataHandlers())
+            << "Number of archive data handlers differs.";
+        for (size_t i = 0; i < la1.getArchive().getNbRecordings(); i++) {
+            ASSERT_EQ(la1.getArchive().at(i).dataHash,
+                      la2.getArchive().at(i).dataHash)
+                << "Archive recordings differ.";
+            ASSERT_EQ(la1.getArchive().at(i).result,
+                      la2.getArchive().at(i).result)
+                << "Archive recordings differ.";
+        }
+    }
+};
+
+TEST_F(LearningAgentCheckpointTest, WriteRead)
+{
+    Learn::LearningAgent la(le, set, params);
+    la.init(42);
+    la.trainOneGeneration(0);
+    la.trainOneGeneration(1);
+
+    std::stringstream stream;
+    ASSERT_NO_THROW(File::LearningAgentCheckpoint::write(la, 2, stream))
+        << "Writing a checkpoint failed.";
+
+    Learn::LearningAgent la2(le, set, params);
+    la2.init(0);
+    uint64_t generation;
+    ASSERT_NO_THROW(generation =
+                        File::LearningAgentCheckpoint::read(la2, stream))
+        << "Reading a checkpoint failed.";
+    ASSERT_EQ(generation, 2) << "Generation number read is incorrect.";
+    checkSameState(la, la2);
+
+    // Archived data handlers hold the same data
+    for (const auto& hashAndHandlers : la.getArchive().getDataHandlers()) {
+        const auto& restored =
+            la2.getArchive().getDataHandlers().at(hashAndHandlers.first);
+        ASSERT_EQ(restored.size(), hashAndHandlers.second.size());
+        for (size_t i = 0; i < restored.size(); i++) {
+            ASSERT_EQ(restored.at(i).get().getHash(),
+                      hashAndHandlers.second.at(i).get().getHash())
+                << "Archived DataHandler content differs.";
+        }
+    }
+}
+
+TEST_F(LearningAgentCheckpointTest, DeterministicResume)
+{
+    Learn::LearningAgent la(le, set, params);
+    la.init(7);
+    la.trainOneGeneration(0);
+    la.trainOneGeneration(1);
+
+    std::stringstream stream;
+    File::LearningAgentCheckpoint::write(la, 2, stream);
+
+    la.trainOneGeneration(2);
+    la.trainOneGeneration(3);
+
+    Learn::LearningAgent la2(le, set, params);
+    uint64_t generation = File::LearningAgentCheckpoint::read(la2, stream);
+    for (; generation < 4; generation++) {
+        la2.trainOneGeneration(generation);
+    }
+
+    checkSameState(la, la2);
+}
+
+TEST_F(LearningAgentCheckpointTest, DeterministicResumeInferenceCost)
+{
+    params.inferenceCostPenalty = 0.01;
+
+    Learn::LearningAgent la(le, set, params);
+    la.init(7);
+    la.trainOneGeneration(0);
+    la.trainOneGeneration(1);
+    ASSERT_GT(la.getBestRoot().second->getInferenceCost(), 0.0)
+        << "Inference cost of roots should be computed.";
+
+    std::stringstream stream;
+    File::LearningAgentCheckpoint::write(la, 2, stream);
+
+    la.trainOneGeneration(2);
+    la.trainOneGeneration(3);
+
+    Learn::LearningAgent la2(le, set, params);
+    uint64_t generation = File::LearningAgentCheckpoint::read(la2, stream);
+    for (; generation < 4; generation++) {
+        la2.trainOneGeneration(generation);
+    }
+
+    checkSameState(la, la2);
+}
+
+TEST_F(LearningAgentCheckpointTest, SaveLoadFile)
+{
+    Learn::LearningAgent la(le, set, params);
+    la.init();
+    la.trainOneGeneration(0);
+
+    std::future<void> saved;
+    ASSERT_NO_THROW(saved = File::LearningAgentCheckpoint::saveAsync(
+                        la, 1, "checkpointForTest.bin"))
+        << "Asynchronous save of a checkpoint failed.";
+    // Training can continue while the file is written
+    la.trainOneGeneration(1);
+    ASSERT_NO_THROW(saved.get()) << "Writing the checkpoint file failed.";
+
+    Learn::LearningAgent la2(le, set, params);
+    ASSERT_EQ(File::LearningAgentCheckpoint::load(la2, "checkpointForTest.bin"),
+              1)
+        << "Loading a checkpoint file failed.";
+
+    ASSERT_NO_THROW(
+        File::LearningAgentCheckpoint::save(la2, 1, "checkpointForTest.bin"))
+        << "Synchronous save of a checkpoint failed.";
+    Learn::LearningAgent la3(le, set, params);
+    File::LearningAgentCheckpoint::load(la3, "checkpointForTest.bin");
+    checkSameState(la2, la3);
+
+    remove("checkpointForTest.bin");
+
+    ASSERT_THROW(
+        File::LearningAgentCheckpoint::load(la3, "nonExistingCheckpoint.bin"),
+        std::runtime_error)
+        << "Loading a non existing checkpoint should fail.";
+}
+
+TEST_F(LearningAgentCheckpointTest, InvalidCheckpoint)
+{
+    Learn::LearningAgent la(le, set, params);
+    la.init();
+    la.trainOneGeneration(0);
+
+    std::stringstream garbage("This is not a checkpoint.");
+    ASSERT_THROW(File::LearningAgentCheckpoint::read(la, garbage),
+                 std::runtime_error)
+        << "Reading an invalid stream should fail.";
+
+    std::stringstream stream;
+    File::LearningAgentCheckpoint::write(la, 1, stream);
+
+    // Truncated checkpoint leaves the LearningAgent untouched
+    size_t nbVertices = la.getTPGGraph()->getNbVertices();
+    std::string content = stream.str();
+    std::stringstream truncated(content.substr(0, content.size() / 4));
+    ASSERT_THROW(File::LearningAgentCheckpoint::read(la, truncated),
+                 std::runtime_error)
+        << "Reading a truncated checkpoint should fail.";
+    ASSERT_EQ(la.getTPGGraph()->getNbVertices(), nbVertices)
+        << "A truncated checkpoint should not modify the LearningAgent.";
+
+    // Checkpoint truncated in its Archive, the last section of the file.
+    Learn::LearningAgent other(le, set, params);
+    other.init(42);
+    other.trainOneGeneration(0);
+    other.trainOneGeneration(1);
+    ASSERT_GT(other.getArchive().getNbRecordings(), 0)
+        << "Test requires archive recordings.";
+    std::stringstream otherStream;
+    File::LearningAgentCheckpoint::write(other, 2, otherStream);
+    std::string otherContent = otherStream.str();
+    std::stringstream truncatedArchive(
+        otherContent.substr(0, otherContent.size() - 1));
+    ASSERT_THROW(File::LearningAgentCheckpoint::read(la, truncatedArchive),
+                 std::runtime_error)
+        << "Reading a checkpoint truncated in its Archive should fail.";
+    Learn::LearningAgent reference(le, set, params);
+    reference.init();
+    File::LearningAgentCheckpoint::read(reference, stream);
+    checkSameState(reference, la);
+
+    // Incompatible Environment
+    stream.clear();
+    stream.seekg(0);
+    params.nbRegisters = 4;
+    Learn::LearningAgent la2(le, set, params);
+    ASSERT_THROW(File::LearningAgentCheckpoint::read(la2, stream),
+                 std::runtime_error)
+        << "Reading a checkpoint with a different Environment should fail.";
+}
@@ -38,9 +38,15 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <future>
 #include <gtest/gtest.h>
 #include <numeric>
+#include <set>
+#include <sstream>
+#include <thread>
 
 #include "log/laBasicLogger.h"
 
@@ -62,6 +68,16 @@
 #include "learn/parallelLearningAgent.h"
 #include "learn/stickGameWithOpponent.h"
 
+// Build a ResultsTable containing a single row.
+static Learn::ResultsTable makeResultsTable(
+    const std::shared_ptr<Learn::EvaluationResult>& result,
+    const TPG::TPGVertex* root)
+{
+    Learn::ResultsTable results;
+    results.addRow(root, result);
+    return results;
+}
+
 class LearningAgentTest : public ::testing::Test
 {
   protected:
@@ -104,6 +120,115 @@ class ParallelLearningAgentTest : public LearningAgentTest
 {
 };
 
+/// StickGameWithOpponent processing its actions in another thread.
+class AsyncStickGameWithOpponent : public StickGameWithOpponent
+{
+  protected:
+    std::future<void> pendingAction;
+
+  public:
+    AsyncStickGameWithOpponent() = default;
+
+    AsyncStickGameWithOpponent(const AsyncStickGameWithOpponent& other)
+        : StickGameWithOpponent(other)
+    {
+    }
+
+    LearningEnvironment* clone() const override
+    {
+        return new AsyncStickGameWithOpponent(*this);
+    }
+
+    bool isAsynchronous() const override
+    {
+        return true;
+    }
+
+    void submitAction(uint64_t actionID) override
+    {
+        pendingAction = std::async(std::launch::async, [this, actionID]() {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+            this->doAction(actionID);
+        });
+    }
+
+    bool pollAction() override
+    {
+        if (pendingAction.valid() &&
+            pendingAction.wait_for(std::chrono::seconds(0)) !=
+                std::future_status::ready) {
+            return false;
+        }
+        awaitAction();
+        return true;
+    }
+
+    void awaitAction() override
+    {
+        if (pendingAction.valid()) {
+            pendingAction.get();
+        }
+    }
+};
+
+/// ParallelLearningAgent exposing its job scheduling.
+class SchedulingParallelLearningAgent : public Learn::ParallelLearningAgent
+{
+  public:
+    using Learn::ParallelLearningAgent::ParallelLearningAgent;
+    using Learn::ParallelLearningAgent::rootCosts;
+    using Learn::ParallelLearningAgent::scheduleJobs;
+    using Learn::ParallelLearningAgent::splitJobs;
+};
+
+/// LALogger recording the sequence of calls, with validation scores.
+class RecordingLALogger : public Log::LALogger
+{
+  public:
+    std::vector<std::string> events;
+
+    explicit RecordingLALogger(Learn::LearningAgent& la) : LALogger(la)
+    {
+    }
+
+    void logHeader() override
+    {
+    }
+
+    void logNewGeneration(uint64_t& generationNumber) override
+    {
+        events.push_back("gen " + std::to_string(generationNumber));
+    }
+
+    void logAfterPopulateTPG() override
+    {
+        events.push_back("populate");
+    }
+
+    void logAfterEvaluate(const Learn::ResultsTable& results) override
+    {
+        events.push_back("eval");
+    }
+
+    void logAfterDecimate() override
+    {
+        events.push_back("decimate");
+    }
+
+    void logAfterValidate(const Learn::ResultsTable& results) override
+    {
+        std::stringstream ss;
+        ss << "valid " << results.size() << " " << results.getMinScore()
+           << " " << results.getAvgScore() << " " << results.getMaxScore();
+        events.push_back(ss.str());
+    }
+
+    void logEndOfTraining() override
+    {
+        events.push_back("end");
+    }
+};
+
 TEST_F(LearningAgentTest, Constructor)
 {
     Learn::LearningAgent* la;
@@ -170,7 +295,7 @@ TEST_F(LearningAgentTest, IsRootEvalSkipped)
     // Add an EvaluationResult artificially
     result1 = std::make_shared<Learn::EvaluationResult>(1.0, 1);
     la.updateEvaluationRecords(
-        {{result1, la.getTPGGraph()->getRootVertices().at(0)}});
+        makeResultsTable(result1, la.getTPGGraph()->getRootVertices().at(0)));
 
     // Test the root again
     std::shared_ptr<Learn::EvaluationResult> result2;
@@ -185,7 +310,7 @@ TEST_F(LearningAgentTest, IsRootEvalSkipped)
     // Update the EvaluationResult artificially
     result2 = std::make_shared<Learn::EvaluationResult>(1.0, 2);
     la.updateEvaluationRecords(
-        {{result2, la.getTPGGraph()->getRootVertices().at(0)}});
+        makeResultsTable(result2, la.getTPGGraph()->getRootVertices().at(0)));
 
     // Test the root again.
     std::shared_ptr<Learn::EvaluationResult> result3;
@@ -287,9 +412,7 @@ TEST_F(LearningAgentTest, EvalAllRoots)
     Learn::LearningAgent la(le, set, params);
 
     la.init();
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        result;
+    Learn::ResultsTable result;
     ASSERT_NO_THROW(result =
                         la.evaluateAllRoots(0, Learn::LearningMode::TRAINING))
         << "Evaluation from a root failed.";
@@ -346,8 +469,8 @@ TEST_F(LearningAgentTest, UpdateEvaluationRecords)
     // Update with a fake result for a root of the graph
     auto rootVertices = la.getTPGGraph()->getRootVertices();
     const TPG::TPGVertex* root = *rootVertices.begin();
-    ASSERT_NO_THROW(la.updateEvaluationRecords(
-        {{std::make_shared<Learn::EvaluationResult>(1.0, 10), root}}));
+    ASSERT_NO_THROW(la.updateEvaluationRecords(makeResultsTable(
+        std::make_shared<Learn::EvaluationResult>(1.0, 10), root)));
     ASSERT_EQ(la.getBestRoot().first, root)
         << "Best root not updated properly.";
     ASSERT_EQ(la.getBestRoot().second->getResult(), 1.0)
@@ -356,8 +479,8 @@ TEST_F(LearningAgentTest, UpdateEvaluationRecords)
     // Update with a fake better result for another root of the graph
     const TPG::TPGVertex* root2 =
         *(la.getTPGGraph()->getRootVertices().begin() + 1);
-    ASSERT_NO_THROW(la.updateEvaluationRecords(
-        {{std::make_shared<Learn::EvaluationResult>(2.0, 10), root2}}));
+    ASSERT_NO_THROW(la.updateEvaluationRecords(makeResultsTable(
+        std::make_shared<Learn::EvaluationResult>(2.0, 10), root2)));
     ASSERT_EQ(la.getBestRoot().first, root2)
         << "Best root not updated properly.";
     ASSERT_EQ(la.getBestRoot().second->getResult(), 2.0)
@@ -366,8 +489,8 @@ TEST_F(LearningAgentTest, UpdateEvaluationRecords)
     // Update with a fake worse result for another root of the graph
     const TPG::TPGVertex* root3 =
         *(la.getTPGGraph()->getRootVertices().begin() + 2);
-    ASSERT_NO_THROW(la.updateEvaluationRecords(
-        {{std::make_shared<Learn::EvaluationResult>(1.5, 10), root3}}));
+    ASSERT_NO_THROW(la.updateEvaluationRecords(makeResultsTable(
+        std::make_shared<Learn::EvaluationResult>(1.5, 10), root3)));
     ASSERT_EQ(la.getBestRoot().first, root2)
         << "Best root not updated properly.";
     ASSERT_EQ(la.getBestRoot().second->getResult(), 2.0)
@@ -375,8 +498,8 @@ TEST_F(LearningAgentTest, UpdateEvaluationRecords)
 
     // Update with a root not from the graph
     TPG::TPGTeam fakeRoot;
-    ASSERT_NO_THROW(la.updateEvaluationRecords(
-        {{std::make_shared<Learn::EvaluationResult>(3.0, 10), &fakeRoot}}));
+    ASSERT_NO_THROW(la.updateEvaluationRecords(makeResultsTable(
+        std::make_shared<Learn::EvaluationResult>(3.0, 10), &fakeRoot)));
     ASSERT_EQ(la.getBestRoot().first, &fakeRoot)
         << "Best root not updated properly.";
     ASSERT_EQ(la.getBestRoot().second->getResult(), 3.0)
@@ -385,7 +508,8 @@ TEST_F(LearningAgentTest, UpdateEvaluationRecords)
     // Update with a worse EvaluationResult (but still updated because previous
     // Root is not in the TPGGraph
     auto sharedPtr = std::make_shared<Learn::EvaluationResult>(1.5, 10);
-    ASSERT_NO_THROW(la.updateEvaluationRecords({{sharedPtr, root3}}));
+    ASSERT_NO_THROW(
+        la.updateEvaluationRecords(makeResultsTable(sharedPtr, root3)));
     ASSERT_EQ(la.getBestRoot().first, root3)
         << "Best root not updated properly.";
     ASSERT_EQ(la.getBestRoot().second->getResult(), 1.5)
@@ -393,7 +517,8 @@ TEST_F(LearningAgentTest, UpdateEvaluationRecords)
 
     // Update with the EvaluationResult already registered in the resultsPerRoot
     // map (for code coverage)
-    ASSERT_NO_THROW(la.updateEvaluationRecords({{sharedPtr, root3}}));
+    ASSERT_NO_THROW(
+        la.updateEvaluationRecords(makeResultsTable(sharedPtr, root3)));
 }
 
 TEST_F(LearningAgentTest, forgetPreviousResults)
@@ -413,8 +538,8 @@ TEST_F(LearningAgentTest, forgetPreviousResults)
     // Update with a fake result for a root of the graph
     auto rootVertices = la.getTPGGraph()->getRootVertices();
     const TPG::TPGVertex* root = *rootVertices.begin();
-    ASSERT_NO_THROW(la.updateEvaluationRecords(
-        {{std::make_shared<Learn::EvaluationResult>(1.0, 10), root}}));
+    ASSERT_NO_THROW(la.updateEvaluationRecords(makeResultsTable(
+        std::make_shared<Learn::EvaluationResult>(1.0, 10), root)));
     ASSERT_EQ(la.getBestRoot().second->getResult(), 1.0)
         << "Best root not updated properly.";
     ASSERT_NO_THROW(*la.getBestRoot().second +=
@@ -478,12 +603,11 @@ TEST_F(LearningAgentTest, DecimateWorstRoots)
         << "An action should have become a root of the TPGGraph.";
 
     // Create and fill results for each "root" artificially
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        results;
+    Learn::ResultsTable results;
     double result = 0.0;
     for (const TPG::TPGVertex* root : roots) {
-        results.emplace(new Learn::EvaluationResult(result++, 5), root);
+        results.addRow(root,
+                       std::make_shared<Learn::EvaluationResult>(result++, 5));
     }
 
     // Do the decimation
@@ -497,6 +621,93 @@ TEST_F(LearningAgentTest, DecimateWorstRoots)
                   params.ratioDeletedRoots * ((le.getNbActions() - 1)));
 }
 
+TEST_F(LearningAgentTest, EvalRootInferenceCost)
+{
+    params.archiveSize = 50;
+    params.archivingProbability = 1.0;
+    params.maxNbActionsPerEval = 11;
+    params.nbIterationsPerPolicyEvaluation = 10;
+
+    Learn::LearningAgent la(le, set, params);
+    la.init();
+    TPG::TPGExecutionEngine tee(la.getTPGGraph()->getEnvironment());
+    auto job = *la.makeJob(la.getTPGGraph()->getRootVertices().at(0),
+                           Learn::LearningMode::TRAINING);
+
+    ASSERT_FALSE(la.isInferenceCostUsed());
+    auto result = la.evaluateJob(tee, job, 0, Learn::LearningMode::TRAINING, le);
+    ASSERT_EQ(result->getInferenceCost(), 0.0)
+        << "Inference cost should not be computed when unused.";
+
+    params.inferenceCostPenalty = 0.1;
+    params.teamInferenceCost = 1000.0;
+    Learn::LearningAgent laCost(le, set, params);
+    laCost.init();
+    TPG::TPGExecutionEngine teeCost(laCost.getTPGGraph()->getEnvironment());
+    auto jobCost =
+        *laCost.makeJob(laCost.getTPGGraph()->getRootVertices().at(0),
+                        Learn::LearningMode::TRAINING);
+
+    ASSERT_TRUE(laCost.isInferenceCostUsed());
+    result = laCost.evaluateJob(teeCost, jobCost, 0,
+                                Learn::LearningMode::TRAINING, le);
+    ASSERT_GE(result->getInferenceCost(), 1000.0)
+        << "Each inference should at least visit the root team.";
+}
+
+TEST_F(LearningAgentTest, DecimateWorstRootsInferenceCost)
+{
+    params.ratioDeletedRoots = 0.5;
+    params.mutation.tpg.initNbRoots = 10;
+    params.inferenceCostPenalty = 0.1;
+
+    Learn::LearningAgent la(le, set, params);
+    la.init();
+
+    // All roots have the same score, and decreasing costs.
+    TPG::TPGGraph& graph = *la.getTPGGraph();
+    auto roots = graph.getRootVertices();
+    ASSERT_EQ(roots.size(), 10);
+    Learn::ResultsTable results;
+    for (size_t i = 0; i < roots.size(); i++) {
+        auto result = std::make_shared<Learn::EvaluationResult>(1.0, 5);
+        result->setInferenceCost((double)(roots.size() - i));
+        results.addRow(roots.at(i), result);
+    }
+
+    ASSERT_NO_THROW(la.decimateWorstRoots(results))
+        << "Decimating worst roots failed.";
+
+    uint64_t nbDeletedRoots = (uint64_t)floor(
+        params.ratioDeletedRoots * (double)params.mutation.tpg.nbRoots);
+    for (size_t i = 0; i < roots.size(); i++) {
+        ASSERT_EQ(graph.hasVertex(*roots.at(i)), i >= nbDeletedRoots)
+            << "Only the most costly roots should have been removed.";
+    }
+
+    // With Pareto selection, the costly roots with the best score are kept.
+    params.paretoCostSelection = true;
+    params.inferenceCostPenalty = 0.0;
+    Learn::LearningAgent laPareto(le, set, params);
+    laPareto.init();
+    TPG::TPGGraph& graphPareto = *laPareto.getTPGGraph();
+    roots = graphPareto.getRootVertices();
+    results.clear();
+    for (size_t i = 0; i < roots.size(); i++) {
+        auto result =
+            std::make_shared<Learn::EvaluationResult>((i == 0) ? 2.0 : 1.0, 5);
+        result->setInferenceCost((double)(roots.size() - i));
+        results.addRow(roots.at(i), result);
+    }
+    laPareto.decimateWorstRoots(results);
+    ASSERT_TRUE(graphPareto.hasVertex(*roots.at(0)))
+        << "Root of the first Pareto front should not have been removed.";
+    ASSERT_TRUE(graphPareto.hasVertex(*roots.back()))
+        << "Root of the first Pareto front should not have been removed.";
+    ASSERT_FALSE(graphPareto.hasVertex(*roots.at(1)))
+        << "Dominated root should have been removed.";
+}
+
 TEST_F(LearningAgentTest, TrainOnegeneration)
 {
     params.archiveSize = 50;
@@ -555,6 +766,46 @@ TEST_F(LearningAgentTest, TrainOnegeneration)
     remove("tempFileForTest");
 }
 
+TEST_F(LearningAgentTest, TrainPipelinedValidation)
+{
+    params.archiveSize = 50;
+    params.archivingProbability = 0.5;
+    params.maxNbActionsPerEval = 11;
+    params.nbIterationsPerPolicyEvaluation = 3;
+    params.ratioDeletedRoots = 0.5;
+    params.nbGenerations = 5;
+    params.doValidation = true;
+
+    Learn::LearningAgent la(le, set, params);
+    RecordingLALogger logger(la);
+    la.init();
+    bool alt = false;
+    la.train(alt, false);
+
+    params.pipelineValidation = true;
+    Learn::LearningAgent pla(le, set, params);
+    RecordingLALogger pipelinedLogger(pla);
+    pla.init();
+
+    ASSERT_NO_THROW(pla.train(alt, false));
+
+    ASSERT_EQ(logger.events.size(), 6 * params.nbGenerations);
+    ASSERT_EQ(logger.events, pipelinedLogger.events)
+        << "Pipelined validation should deliver the same logs, in the same "
+           "order, as the synchronous validation.";
+    ASSERT_EQ(la.getTPGGraph()->getNbVertices(),
+              pla.getTPGGraph()->getNbVertices())
+        << "Pipelined validation should not change the training.";
+
+    // A single generation leaves the validation pending.
+    pla.trainOneGeneration(params.nbGenerations);
+    ASSERT_EQ(pipelinedLogger.events.back(), "decimate")
+        << "Validation should still be pending after trainOneGeneration.";
+    ASSERT_NO_THROW(pla.waitForValidation());
+    ASSERT_EQ(pipelinedLogger.events.back(), "end")
+        << "Validation results should be delivered by waitForValidation.";
+}
+
 TEST_F(LearningAgentTest, Train)
 {
     params.archiveSize = 50;
@@ -850,9 +1101,7 @@ TEST_F(ParallelLearningAgentTest, EvalAllRootsSequential)
     Learn::ParallelLearningAgent pla(le, set, params);
 
     pla.init();
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        result;
+    Learn::ResultsTable result;
     ASSERT_NO_THROW(result =
                         pla.evaluateAllRoots(0, Learn::LearningMode::TRAINING))
         << "Evaluation from a root failed.";
@@ -872,9 +1121,7 @@ TEST_F(ParallelLearningAgentTest, EvalAllRootsParallel)
     Learn::ParallelLearningAgent pla(le, set, params);
 
     pla.init();
-    std::multimap<std::shared_ptr<Learn::EvaluationResult>,
-                  const TPG::TPGVertex*>
-        result;
+    Learn::ResultsTable result;
     ASSERT_NO_THROW(result =
                         pla.evaluateAllRoots(0, Learn::LearningMode::TRAINING))
         << "Evaluation from a root failed.";
@@ -919,14 +1166,10 @@ TEST_F(ParallelLearningAgentTest, EvalAllRootsParallelTrainingDeterminism)
     // Check equality between LearningAgent and ParallelLearningAgent
     ASSERT_EQ(results.size(), resultsSequential.size())
         << "Result maps have a different size.";
-    auto iter = results.begin();
-    auto iterSequential = resultsSequential.begin();
-    while (iter != results.end()) {
-        ASSERT_EQ(iter->first->getResult(), iterSequential->first->getResult())
+    for (size_t row = 0; row < results.size(); row++) {
+        ASSERT_EQ(results.getScore(row), resultsSequential.getScore(row))
             << "Average score between sequential and parallel executions are "
                "differents.";
-        iter++;
-        iterSequential++;
     }
 
     // Check determinism of bestScoreLastGen
@@ -960,15 +1203,11 @@ TEST_F(ParallelLearningAgentTest, EvalAllRootsParallelTrainingDeterminism)
     // mode
     ASSERT_EQ(resultsParallel.size(), resultsParallel.size())
         << "Result maps have a different size.";
-    iterSequential = resultsSequential.begin();
-    auto iterParallel = resultsParallel.begin();
-    while (iterSequential != resultsSequential.end()) {
-        ASSERT_EQ(iterSequential->first->getResult(),
-                  iterParallel->first->getResult())
+    for (size_t row = 0; row < resultsSequential.size(); row++) {
+        ASSERT_EQ(resultsSequential.getScore(row),
+                  resultsParallel.getScore(row))
             << "Average score between sequential and parallel executions are "
                "differents.";
-        iterSequential++;
-        iterParallel++;
     }
 
     // Check determinism of bestScoreLastGen
@@ -1034,14 +1273,10 @@ TEST_F(ParallelLearningAgentTest, EvalAllRootsParallelValidationDeterminism)
     // Check equality between LearningAgent and ParallelLearningAgent
     ASSERT_EQ(results.size(), resultsSequential.size())
         << "Result maps have a different size.";
-    auto iter = results.begin();
-    auto iterSequential = resultsSequential.begin();
-    while (iter != results.end()) {
-        ASSERT_EQ(iter->first->getResult(), iterSequential->first->getResult())
+    for (size_t row = 0; row < results.size(); row++) {
+        ASSERT_EQ(results.getScore(row), resultsSequential.getScore(row))
             << "Average score between sequential and parallel executions are "
                "differents.";
-        iter++;
-        iterSequential++;
     }
 
     // Check determinism of the number of RNG calls.
@@ -1059,15 +1294,11 @@ TEST_F(ParallelLearningAgentTest, EvalAllRootsParallelValidationDeterminism)
     // mode
     ASSERT_EQ(resultsParallel.size(), resultsParallel.size())
         << "Result maps have a different size.";
-    iterSequential = resultsSequential.begin();
-    auto iterParallel = resultsParallel.begin();
-    while (iterSequential != resultsSequential.end()) {
-        ASSERT_EQ(iterSequential->first->getResult(),
-                  iterParallel->first->getResult())
+    for (size_t row = 0; row < resultsSequential.size(); row++) {
+        ASSERT_EQ(resultsSequential.getScore(row),
+                  resultsParallel.getScore(row))
             << "Average score between sequential and parallel executions are "
                "differents.";
-        iterSequential++;
-        iterParallel++;
     }
 
     // Check determinism of the number of RNG calls.
@@ -1236,6 +1467,551 @@ TEST_F(ParallelLearningAgentTest, TrainParallelDeterminism)
            "TPGGraphs.";
 }
 
+TEST_F(ParallelLearningAgentTest, ScheduleJobs)
+{
+    params.nbThreads = 2;
+    params.mutation.tpg.nbRoots = 30;
+    SchedulingParallelLearningAgent pla(le, set, params);
+    pla.init();
+
+    // Give an increasing cost to roots, and a large one to a single root.
+    auto roots = pla.getTPGGraph()->getRootVertices();
+    ASSERT_GT(roots.size(), 4);
+    for (size_t i = 0; i < roots.size(); i++) {
+        pla.rootCosts[roots.at(i)] = 0.001 * (double)i;
+    }
+    pla.rootCosts[roots.at(2)] = 10.0;
+
+    auto jobs = pla.makeJobs(Learn::LearningMode::TRAINING);
+    size_t nbJobs = jobs.size();
+    std::queue<std::vector<std::shared_ptr<Learn::Job>>> chunks;
+    ASSERT_NO_THROW(chunks = pla.scheduleJobs(jobs));
+
+    ASSERT_EQ(chunks.front().size(), 1)
+        << "The most expensive job should be scheduled alone.";
+    ASSERT_EQ(chunks.front().front()->getRoot(), roots.at(2))
+        << "The most expensive job should be scheduled first.";
+    ASSERT_LT(chunks.size(), nbJobs) << "Cheap jobs should be grouped.";
+
+    std::vector<bool> scheduled(nbJobs, false);
+    double previousCost = INFINITY;
+    while (!chunks.empty()) {
+        double cost = 0.0;
+        for (size_t i = 0; i < chunks.front().size(); i++) {
+            const auto& job = chunks.front().at(i);
+            ASSERT_EQ(job->getIdx(), chunks.front().front()->getIdx() + i)
+                << "Jobs of a chunk should be consecutive.";
+            ASSERT_FALSE(scheduled.at(job->getIdx()));
+            scheduled.at(job->getIdx()) = true;
+            cost += pla.rootCosts.at(job->getRoot());
+        }
+        ASSERT_LE(cost, previousCost)
+            << "Chunks should be scheduled by decreasing cost.";
+        previousCost = cost;
+        chunks.pop();
+    }
+    ASSERT_TRUE(std::all_of(scheduled.begin(), scheduled.end(),
+                            [](bool b) { return b; }))
+        << "All jobs should be scheduled.";
+}
+
+TEST_F(ParallelLearningAgentTest, SplitJobsDeterminism)
+{
+    // Check that splitting iterations of roots in several jobs leads to the
+    // same results in sequential and parallel executions.
+    params.archiveSize = 50;
+    params.archivingProbability = 0.1;
+    params.maxNbActionsPerEval = 11;
+    params.nbIterationsPerPolicyEvaluation = 10;
+    params.maxNbIterationsPerJob = 3;
+
+    Learn::LearningParameters paramsSequential = params;
+    paramsSequential.nbThreads = 1;
+    SchedulingParallelLearningAgent plaSequential(le, set, paramsSequential);
+    plaSequential.init(0);
+
+    auto jobs = plaSequential.makeJobs(Learn::LearningMode::TRAINING);
+    size_t nbRoots = jobs.size();
+    auto splitJobs =
+        plaSequential.splitJobs(jobs, Learn::LearningMode::TRAINING);
+    ASSERT_EQ(splitJobs.size(), 4 * nbRoots)
+        << "Each root should be evaluated in 4 jobs of at most 3 iterations.";
+    for (size_t i = 0; i < splitJobs.size(); i++) {
+        ASSERT_EQ(splitJobs.front()->getIdx(), i);
+        ASSERT_EQ(splitJobs.front()->getFirstIteration(), (i % 4) * 3);
+        ASSERT_EQ(splitJobs.front()->getNbIterations(), (i % 4 == 3) ? 1 : 3);
+        splitJobs.pop();
+    }
+
+    plaSequential.init(0);
+    auto resultsSequential =
+        plaSequential.evaluateAllRoots(0, Learn::LearningMode::TRAINING);
+    auto nextIntSequential =
+        plaSequential.getRNG().getUnsignedInt64(0, UINT64_MAX);
+
+    Learn::LearningParameters paramsParallel = params;
+    paramsParallel.nbThreads = 4;
+    Learn::ParallelLearningAgent plaParallel(le, set, paramsParallel);
+    plaParallel.init(0);
+    auto resultsParallel =
+        plaParallel.evaluateAllRoots(0, Learn::LearningMode::TRAINING);
+    auto nextIntParallel = plaParallel.getRNG().getUnsignedInt64(0, UINT64_MAX);
+
+    ASSERT_EQ(resultsSequential.size(), nbRoots);
+    ASSERT_EQ(resultsSequential.size(), resultsParallel.size())
+        << "Result maps have a different size.";
+    for (size_t row = 0; row < resultsSequential.size(); row++) {
+        ASSERT_EQ(resultsSequential.getNbEvaluation(row),
+                  params.nbIterationsPerPolicyEvaluation)
+            << "Partial results should be folded into a single result.";
+        ASSERT_EQ(resultsSequential.getScore(row),
+                  resultsParallel.getScore(row))
+            << "Average score between sequential and parallel executions are "
+               "differents.";
+    }
+    ASSERT_EQ(nextIntSequential, nextIntParallel)
+        << "Mutator::RNG was called a different number of time in parallel and "
+           "sequential execution.";
+
+    ASSERT_GT(plaSequential.getArchive().getNbRecordings(), 0);
+    ASSERT_EQ(plaSequential.getArchive().getNbRecordings(),
+              plaParallel.getArchive().getNbRecordings())
+        << "Archives have different sizes.";
+    for (auto i = 0; i < plaSequential.getArchive().getNbRecordings(); i++) {
+        ASSERT_EQ(plaSequential.getArchive().at(i).dataHash,
+                  plaParallel.getArchive().at(i).dataHash)
+            << "Archives have different content.";
+        ASSERT_EQ(plaSequential.getArchive().at(i).result,
+                  plaParallel.getArchive().at(i).result)
+            << "Archives have different content.";
+    }
+}
+
+TEST_F(ParallelLearningAgentTest, EvalRootSplitParallel)
+{
+    params.nbIterationsPerPolicyEvaluation = 10;
+    params.maxNbIterationsPerJob = 4;
+    params.nbThreads = 4;
+    Learn::ParallelLearningAgent pla(le, set, params);
+    pla.init();
+
+    const TPG::TPGVertex* root = pla.getTPGGraph()->getRootVertices().at(0);
+    std::shared_ptr<Learn::EvaluationResult> result;
+    ASSERT_NO_THROW(
+        result = pla.evaluateOneRoot(0, Learn::LearningMode::VALIDATION, root))
+        << "Evaluation of a root with split jobs failed.";
+    ASSERT_EQ(result->getNbEvaluation(), params.nbIterationsPerPolicyEvaluation)
+        << "Partial results should be folded into a single result.";
+
+    TPG::TPGAction action(0);
+    ASSERT_THROW(
+        pla.evaluateOneRoot(0, Learn::LearningMode::VALIDATION, &action),
+        std::runtime_error)
+        << "Evaluation of a vertex absent from the graph should fail.";
+}
+
+TEST_F(ParallelLearningAgentTest, ThreadAffinity)
+{
+    params.nbThreads = 2;
+    params.threadAffinity = "compact";
+    Learn::ParallelLearningAgent pla(le, set, params);
+    pla.init();
+    ASSERT_TRUE(pla.getNodeThroughput().empty());
+
+    ASSERT_NO_THROW(pla.trainOneGeneration(0))
+        << "Training with pinned threads failed.";
+
+    auto throughput = pla.getNodeThroughput();
+    ASSERT_FALSE(throughput.empty());
+    uint64_t nbJobs = 0;
+    uint64_t nbIterations = 0;
+    for (const auto& node : throughput) {
+        nbJobs += node.second.nbJobs;
+        nbIterations += node.second.nbIterations;
+        ASSERT_GE(node.second.duration, 0.0);
+#ifdef __linux__
+        ASSERT_EQ(node.second.nbPinningFailures, 0)
+            << "Threads should be pinned to the CPUs of the process.";
+#endif
+    }
+    ASSERT_EQ(nbJobs, params.mutation.tpg.nbRoots)
+        << "Each root should be evaluated in a single job.";
+    ASSERT_EQ(nbIterations,
+              nbJobs * params.nbIterationsPerPolicyEvaluation);
+
+    pla.resetNodeThroughput();
+    ASSERT_TRUE(pla.getNodeThroughput().empty());
+
+    // A CPU that does not exist can not be used for pinning.
+    params.threadAffinity = "100000";
+    Learn::ParallelLearningAgent unpinnedPla(le, set, params);
+    unpinnedPla.init();
+    ASSERT_NO_THROW(unpinnedPla.trainOneGeneration(0))
+        << "Training should not fail when threads can not be pinned.";
+    uint64_t nbPinningFailures = 0;
+    for (const auto& node : unpinnedPla.getNodeThroughput()) {
+        nbPinningFailures += node.second.nbPinningFailures;
+    }
+    ASSERT_EQ(nbPinningFailures, params.nbThreads)
+        << "Pinning failures of the main and worker threads should be "
+           "reported.";
+
+    params.threadAffinity = "0-";
+    ASSERT_THROW(Learn::ParallelLearningAgent(le, set, params),
+                 std::runtime_error)
+        << "An invalid thread affinity should be rejected.";
+}
+
+/// ParallelLearningAgent with threads pinned on two NUMA nodes.
+class TwoNodesParallelLearningAgent : public Learn::ParallelLearningAgent
+{
+  public:
+    TwoNodesParallelLearningAgent(Learn::LearningEnvironment& le,
+                                  const Instructions::Set& iSet,
+                                  const Learn::LearningParameters& p)
+        : Learn::ParallelLearningAgent(le, iSet, p)
+    {
+        // CPUs that do not exist make the pinning fail, in which case
+        // workers use the replica of the node they run on.
+        this->affinity = Util::ThreadAffinity("scatter", {{0, {0}}, {1, {1}}});
+    }
+};
+
+TEST_F(ParallelLearningAgentTest, GraphReplicas)
+{
+    params.archiveSize = 50;
+    params.archivingProbability = 0.5;
+    params.nbGenerations = 5;
+    params.nbThreads = 2;
+
+    Learn::ParallelLearningAgent pla(le, set, params);
+    TwoNodesParallelLearningAgent replicatedPla(le, set, params);
+    pla.init();
+    replicatedPla.init();
+
+    bool alt = false;
+    pla.train(alt, false);
+    replicatedPla.train(alt, false);
+
+    uint64_t nbReplicas = 0;
+    for (const auto& node : replicatedPla.getNodeThroughput()) {
+        nbReplicas += node.second.nbReplicas;
+    }
+    ASSERT_GT(nbReplicas, 0)
+        << "Jobs should be evaluated with a replica of the TPGGraph.";
+
+    // Replicas do not change the outcome of the training.
+    ASSERT_EQ(pla.getTPGGraph()->getNbVertices(),
+              replicatedPla.getTPGGraph()->getNbVertices())
+        << "Evaluating replicas of the TPGGraph changed the training.";
+    ASSERT_EQ(pla.getBestRoot().second->getResult(),
+              replicatedPla.getBestRoot().second->getResult())
+        << "Evaluating replicas of the TPGGraph changed the scores.";
+
+    // Recordings reference the Program of the original TPGGraph.
+    std::set<const Program::Program*> programs;
+    for (const auto& edge : replicatedPla.getTPGGraph()->getEdges()) {
+        programs.insert(&edge->getProgram());
+    }
+    const Archive& archive = pla.getArchive();
+    const Archive& replicatedArchive = replicatedPla.getArchive();
+    ASSERT_EQ(archive.getNbRecordings(), replicatedArchive.getNbRecordings());
+    for (uint64_t i = 0; i < archive.getNbRecordings(); i++) {
+        ASSERT_EQ(archive.at(i).dataHash, replicatedArchive.at(i).dataHash);
+        ASSERT_EQ(archive.at(i).result, replicatedArchive.at(i).result);
+    }
+    bool hasCurrentProgram = false;
+    for (uint64_t i = 0; i < replicatedArchive.getNbRecordings(); i++) {
+        hasCurrentProgram |= programs.count(replicatedArchive.at(i).prog) > 0;
+    }
+    ASSERT_TRUE(hasCurrentProgram)
+        << "Recordings should reference Program of the TPGGraph.";
+}
+
+TEST_F(ParallelLearningAgentTest, EvalAllRootsInterleavedDeterminism)
+{
+    // Check that interleaving episodes leads to the same results as a
+    // synchronous evaluation.
+    AsyncStickGameWithOpponent asyncLe;
+    params.archiveSize = 50;
+    params.archivingProbability = 0.1;
+    params.maxNbActionsPerEval = 11;
+    params.nbIterationsPerPolicyEvaluation = 3;
+    params.nbThreads = 1;
+
+    Learn::ParallelLearningAgent plaSync(asyncLe, set, params);
+    plaSync.init(0);
+    auto resultsSync =
+        plaSync.evaluateAllRoots(0, Learn::LearningMode::TRAINING);
+
+    for (size_t nbThreads : {1, 2}) {
+        Learn::LearningParameters paramsInterleaved = params;
+        paramsInterleaved.nbEpisodesInFlight = 4;
+        paramsInterleaved.nbThreads = nbThreads;
+        Learn::ParallelLearningAgent plaInterleaved(asyncLe, set,
+                                                    paramsInterleaved);
+        plaInterleaved.init(0);
+        Learn::ResultsTable resultsInterleaved;
+        ASSERT_NO_THROW(resultsInterleaved = plaInterleaved.evaluateAllRoots(
+                            0, Learn::LearningMode::TRAINING))
+            << "Interleaved evaluation failed with " << nbThreads
+            << " threads.";
+
+        ASSERT_EQ(resultsSync.size(), resultsInterleaved.size())
+            << "Result maps have a different size.";
+        for (size_t row = 0; row < resultsSync.size(); row++) {
+            ASSERT_EQ(resultsSync.getScore(row),
+                      resultsInterleaved.getScore(row))
+                << "Interleaved evaluation gives a different score.";
+            ASSERT_EQ(resultsSync.getNbEvaluation(row),
+                      resultsInterleaved.getNbEvaluation(row));
+        }
+
+        ASSERT_GT(plaSync.getArchive().getNbRecordings(), 0);
+        ASSERT_EQ(plaSync.getArchive().getNbRecordings(),
+                  plaInterleaved.getArchive().getNbRecordings())
+            << "Archives have different sizes.";
+        for (auto i = 0; i < plaSync.getArchive().getNbRecordings(); i++) {
+            ASSERT_EQ(plaSync.getArchive().at(i).dataHash,
+                      plaInterleaved.getArchive().at(i).dataHash)
+                << "Archives have different content.";
+            ASSERT_EQ(plaSync.getArchive().at(i).result,
+                      plaInterleaved.getArchive().at(i).result)
+                << "Archives have different content.";
+        }
+    }
+}
+
+TEST_F(ParallelLearningAgentTest, EvalAllRootsInferenceCostDeterminism)
+{
+    // Check that inference costs do not depend on the parallelism or on the
+    // interleaving of episodes.
+    AsyncStickGameWithOpponent asyncLe;
+    params.archiveSize = 50;
+    params.archivingProbability = 0.1;
+    params.maxNbActionsPerEval = 11;
+    params.nbIterationsPerPolicyEvaluation = 3;
+    params.nbThreads = 1;
+    params.inferenceCostPenalty = 0.01;
+    params.instructionInferenceCosts = {2.0, 3.0};
+
+    Learn::ParallelLearningAgent plaSync(asyncLe, set, params);
+    plaSync.init(0);
+    auto resultsSync =
+        plaSync.evaluateAllRoots(0, Learn::LearningMode::TRAINING);
+
+    for (size_t nbEpisodesInFlight : {1, 4}) {
+        Learn::LearningParameters paramsParallel = params;
+        paramsParallel.nbEpisodesInFlight = nbEpisodesInFlight;
+        paramsParallel.nbThreads = 2;
+        Learn::ParallelLearningAgent plaParallel(asyncLe, set, paramsParallel);
+        plaParallel.init(0);
+        auto resultsParallel =
+            plaParallel.evaluateAllRoots(0, Learn::LearningMode::TRAINING);
+
+        ASSERT_EQ(resultsSync.size(), resultsParallel.size());
+        for (size_t row = 0; row < resultsSync.size(); row++) {
+            ASSERT_GT(resultsSync.getInferenceCost(row), 0.0)
+                << "Inference cost should be computed.";
+            ASSERT_DOUBLE_EQ(resultsSync.getInferenceCost(row),
+                             resultsParallel.getInferenceCost(row))
+                << "Parallel evaluation gives a different inference cost with "
+                << nbEpisodesInFlight << " episodes in flight.";
+        }
+    }
+}
+
+TEST_F(ParallelLearningAgentTest, TrainPipelinedValidationParallel)
+{
+    params.archiveSize = 50;
+    params.archivingProbability = 0.5;
+    params.maxNbActionsPerEval = 11;
+    params.nbIterationsPerPolicyEvaluation = 3;
+    params.ratioDeletedRoots = 0.5;
+    params.nbGenerations = 5;
+    params.doValidation = true;
+
+    Learn::LearningAgent la(le, set, params);
+    RecordingLALogger logger(la);
+    la.init();
+    bool alt = false;
+    la.train(alt, false);
+
+    params.pipelineValidation = true;
+    params.nbThreads = 4;
+    Learn::ParallelLearningAgent pla(le, set, params);
+    RecordingLALogger pipelinedLogger(pla);
+    pla.init();
+    ASSERT_NO_THROW(pla.train(alt, false));
+
+    ASSERT_EQ(logger.events, pipelinedLogger.events)
+        << "Parallel pipelined validation should deliver the same logs, in "
+           "the same order, as the sequential synchronous validation.";
+}
+
+/// ParallelLearningAgent whose validation uses a member of the derived class.
+class SlowValidationAgent : public Learn::ParallelLearningAgent
+{
+  protected:
+    std::vector<size_t> validationSizes;
+
+    std::atomic<size_t>& nbValidations;
+
+  public:
+    SlowValidationAgent(Learn::LearningEnvironment& le,
+                        const Instructions::Set& iSet,
+                        const Learn::LearningParameters& p,
+                        std::atomic<size_t>& nbValidations)
+        : ParallelLearningAgent(le, iSet, p), nbValidations{nbValidations}
+    {
+    }
+
+    ~SlowValidationAgent()
+    {
+        this->joinValidation();
+    }
+
+    Learn::ResultsTable evaluateValidationSnapshot(
+        const TPG::TPGGraph& snapshot,
+        const std::vector<const TPG::TPGVertex*>& snapshotRoots,
+        const std::vector<const TPG::TPGVertex*>& roots,
+        uint64_t generationNumber) const override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        auto results = ParallelLearningAgent::evaluateValidationSnapshot(
+            snapshot, snapshotRoots, roots, generationNumber);
+        // Members of the derived class must still be alive.
+        const_cast<std::vector<size_t>&>(this->validationSizes)
+            .push_back(results.size());
+        this->nbValidations++;
+        return results;
+    }
+};
+
+TEST_F(ParallelLearningAgentTest, DestructionWithPendingValidation)
+{
+    params.maxNbActionsPerEval = 11;
+    params.nbIterationsPerPolicyEvaluation = 3;
+    params.doValidation = true;
+    params.pipelineValidation = true;
+    params.nbThreads = 2;
+
+    std::atomic<size_t> nbValidations{0};
+    {
+        SlowValidationAgent pla(le, set, params, nbValidations);
+        RecordingLALogger logger(pla);
+        pla.init();
+        pla.trainOneGeneration(0);
+        ASSERT_EQ(logger.events.back(), "decimate")
+            << "Validation should still be pending after trainOneGeneration.";
+        // The agent is destroyed without calling waitForValidation().
+    }
+    ASSERT_EQ(nbValidations, 1)
+        << "Destruction of the agent should wait for the pending validation.";
+
+    // Same for the library agents, whose validation is not delayed.
+    Learn::ParallelLearningAgent* pla =
+        new Learn::ParallelLearningAgent(le, set, params);
+    pla->init();
+    pla->trainOneGeneration(0);
+    ASSERT_NO_THROW(delete pla);
+}
+
+TEST_F(ParallelLearningAgentTest, TrainSteadyStateSequential)
+{
+    params.archiveSize = 50;
+    params.archivingProbability = 0.5;
+    params.maxNbActionsPerEval = 11;
+    params.nbIterationsPerPolicyEvaluation = 5;
+    params.ratioDeletedRoots = 0.2;
+    params.nbGenerations = 3;
+    params.maxNbEvaluationPerPolicy =
+        params.nbIterationsPerPolicyEvaluation * 2;
+    params.nbThreads = 1;
+
+    Learn::ParallelLearningAgent pla(le, set, params);
+    std::stringstream strStr;
+    Log::LABasicLogger logger(pla, strStr);
+
+    pla.init();
+    bool alt = false;
+
+    uint64_t nbGenerations;
+    ASSERT_NO_THROW(nbGenerations = pla.trainSteadyState(alt))
+        << "Training a TPG in steady-state mode should not fail.";
+    ASSERT_EQ(nbGenerations, params.nbGenerations)
+        << "Number of generation equivalents of the training is incorrect.";
+    ASSERT_NE(pla.getBestRoot().first, nullptr)
+        << "A best root should have been found during the training.";
+    ASSERT_TRUE(pla.getTPGGraph()->hasVertex(*pla.getBestRoot().first))
+        << "Best root should still be in the TPGGraph.";
+    ASSERT_FALSE(strStr.str().empty())
+        << "Loggers should be called during steady-state training.";
+
+    alt = true;
+    ASSERT_EQ(pla.trainSteadyState(alt), 0)
+        << "Using the boolean reference to stop the training should not fail.";
+}
+
+TEST_F(ParallelLearningAgentTest, TrainSteadyStateParallel)
+{
+    params.archiveSize = 50;
+    params.archivingProbability = 0.5;
+    params.maxNbActionsPerEval = 11;
+    params.nbIterationsPerPolicyEvaluation = 5;
+    params.ratioDeletedRoots = 0.2;
+    params.nbGenerations = 3;
+    params.maxNbEvaluationPerPolicy =
+        params.nbIterationsPerPolicyEvaluation * 2;
+    params.nbThreads = 4;
+
+    Learn::ParallelLearningAgent pla(le, set, params);
+
+    pla.init();
+    bool alt = false;
+
+    uint64_t nbGenerations;
+    ASSERT_NO_THROW(nbGenerations = pla.trainSteadyState(alt, 1))
+        << "Training a TPG in parallel steady-state mode should not fail.";
+    ASSERT_EQ(nbGenerations, params.nbGenerations)
+        << "Number of generation equivalents of the training is incorrect.";
+    ASSERT_NE(pla.getBestRoot().first, nullptr)
+        << "A best root should have been found during the training.";
+    ASSERT_TRUE(pla.getTPGGraph()->hasVertex(*pla.getBestRoot().first))
+        << "Best root should still be in the TPGGraph.";
+}
+
+TEST_F(ParallelLearningAgentTest, TrainSteadyStateSequentialDeterminism)
+{
+    params.archiveSize = 50;
+    params.archivingProbability = 0.5;
+    params.maxNbActionsPerEval = 11;
+    params.nbIterationsPerPolicyEvaluation = 5;
+    params.ratioDeletedRoots = 0.2;
+    params.nbGenerations = 5;
+    params.maxNbEvaluationPerPolicy =
+        params.nbIterationsPerPolicyEvaluation * 5;
+    params.nbThreads = 1;
+
+    Learn::ParallelLearningAgent pla1(le, set, params);
+    Learn::ParallelLearningAgent pla2(le, set, params);
+    bool alt = false;
+
+    pla1.init();
+    pla1.trainSteadyState(alt);
+    pla2.init();
+    pla2.trainSteadyState(alt);
+
+    ASSERT_GT(pla1.getTPGGraph()->getNbVertices(), 0)
+        << "Number of vertex in the trained graph should not be 0.";
+    ASSERT_EQ(pla1.getTPGGraph()->getNbVertices(),
+              pla2.getTPGGraph()->getNbVertices())
+        << "Sequential steady-state training is not deterministic.";
+    ASSERT_EQ(pla1.getBestRoot().second->getResult(),
+              pla2.getBestRoot().second->getResult())
+        << "Sequential steady-state training is not deterministic.";
+}
+
 TEST_F(ParallelLearningAgentTest, KeepBestPolicy)
 {
     params.archiveSize = 50;
@@ -0,0 +1,199 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <cstdio>
+#include <gtest/gtest.h>
+
+#include "instructions/addPrimitiveType.h"
+#include "instructions/set.h"
+#include "learn/classificationLearningAgent.h"
+#include "learn/parallelLearningAgent.h"
+
+#include "learn/mappedClassificationLearningEnvironment.h"
+
+class MappedClassificationLearningEnvironmentTest : public ::testing::Test
+{
+  protected:
+    const std::string filePath = "mappedDatasetForTest.bin";
+    const uint64_t nbSamples = 10;
+    const uint64_t height = 2;
+    const uint64_t width = 3;
+    std::vector<uint64_t> labels;
+    std::vector<float> samples;
+
+    virtual void SetUp()
+    {
+        // Element j of sample i is worth 10 * i + j, sample i is of class
+        // i % 3.
+        for (uint64_t i = 0; i < nbSamples; i++) {
+            labels.push_back(i % 3);
+            for (uint64_t j = 0; j < height * width; j++) {
+                samples.push_back(10.0f * i + j);
+            }
+        }
+        Learn::MappedClassificationLearningEnvironment<float>::writeDataset(
+            filePath, samples, labels, height, width);
+    }
+
+    virtual void TearDown()
+    {
+        remove(filePath.c_str());
+    }
+
+    // Value of the first element of the current sample.
+    float getFirstElement(Learn::LearningEnvironment& le)
+    {
+        return *le.getDataSources()
+                    .at(0)
+                    .get()
+                    .getDataAt(typeid(float), 0)
+                    .getSharedPointer<const float>();
+    }
+};
+
+TEST_F(MappedClassificationLearningEnvironmentTest, Constructor)
+{
+    Learn::MappedClassificationLearningEnvironment<float>* le = nullptr;
+    ASSERT_NO_THROW(
+        le = new Learn::MappedClassificationLearningEnvironment<float>(
+            filePath, 3))
+        << "Construction from a dataset file failed.";
+    ASSERT_EQ(le->getHeader().nbSamples, nbSamples);
+    ASSERT_EQ(le->getDataSources().size(), 1);
+    ASSERT_EQ(le->getDataSources().at(0).get().getLargestAddressSpace(),
+              height * width);
+    ASSERT_TRUE(le->isCopyable());
+    ASSERT_TRUE(le->isActionIndependent());
+    delete le;
+
+    ASSERT_THROW(Learn::MappedClassificationLearningEnvironment<double>(
+                     filePath, 3),
+                 std::runtime_error)
+        << "Mismatching element types should not be accepted.";
+    Learn::MappedClassificationLearningEnvironment<float> le2(filePath, 2);
+    ASSERT_THROW(le2.reset(2), std::runtime_error)
+        << "Labels exceeding the number of classes should not be accepted.";
+    ASSERT_THROW(Learn::MappedClassificationLearningEnvironment<float>(
+                     "nonExistingFile.bin", 3),
+                 std::runtime_error);
+
+    // Truncated file
+    std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+    out.write("GGDATA01", 8);
+    out.close();
+    ASSERT_THROW(
+        Learn::MappedClassificationLearningEnvironment<float>(filePath, 3),
+        std::runtime_error);
+}
+
+TEST_F(MappedClassificationLearningEnvironmentTest, ResetAndDoAction)
+{
+    Learn::MappedClassificationLearningEnvironment<float> le(filePath, 3,
+                                                             1.0, 4);
+
+    le.reset(7);
+    ASSERT_EQ(getFirstElement(le), 70.0f)
+        << "Seed should select the first sample of the episode.";
+    size_t hash = le.getDataSources().at(0).get().getHash();
+
+    for (uint64_t i = 1; i < 6; i++) {
+        le.doAction(((7 + i - 1) % nbSamples) % 3);
+        ASSERT_EQ(getFirstElement(le), 10.0f * ((7 + i) % nbSamples))
+            << "Samples should be presented sequentially.";
+        ASSERT_NE(le.getDataSources().at(0).get().getHash(), hash)
+            << "Hash should be updated when the sample changes.";
+    }
+    ASSERT_EQ(le.getScore(), 1.0) << "All guesses were correct.";
+
+    // Same reset arguments give the same samples
+    le.reset(7);
+    ASSERT_EQ(getFirstElement(le), 70.0f);
+    ASSERT_EQ(le.getDataSources().at(0).get().getHash(), hash);
+
+    // Clone shares the mapped file, but not the current sample
+    Learn::LearningEnvironment* clone = le.clone();
+    clone->doAction(0);
+    ASSERT_EQ(getFirstElement(*clone), 80.0f);
+    ASSERT_EQ(getFirstElement(le), 70.0f);
+    ASSERT_EQ(clone->getDataSources().at(0).get().getId(),
+              le.getDataSources().at(0).get().getId())
+        << "Data sources of clones should have the same id.";
+    delete clone;
+}
+
+TEST_F(MappedClassificationLearningEnvironmentTest, LearningModes)
+{
+    Learn::MappedClassificationLearningEnvironment<float> le(filePath, 3,
+                                                             0.8);
+    ASSERT_EQ(le.getNbSamples(Learn::LearningMode::TRAINING), 8);
+    ASSERT_EQ(le.getNbSamples(Learn::LearningMode::VALIDATION), 2);
+
+    le.reset(9, Learn::LearningMode::TRAINING);
+    ASSERT_EQ(getFirstElement(le), 10.0f);
+    le.reset(3, Learn::LearningMode::VALIDATION);
+    ASSERT_EQ(getFirstElement(le), 90.0f);
+    le.doAction(0);
+    ASSERT_EQ(getFirstElement(le), 80.0f)
+        << "Validation samples should wrap around.";
+}
+
+TEST_F(MappedClassificationLearningEnvironmentTest, Train)
+{
+    Instructions::Set set;
+    set.add(*(new Instructions::AddPrimitiveType<float>()));
+    set.add(*(new Instructions::AddPrimitiveType<double>()));
+    Learn::LearningParameters params;
+    params.mutation.tpg.nbRoots = 10;
+    params.mutation.tpg.maxInitOutgoingEdges = 3;
+    params.mutation.prog.maxProgramSize = 20;
+    params.maxNbActionsPerEval = 10;
+    params.nbIterationsPerPolicyEvaluation = 2;
+    params.nbThreads = 2;
+    params.observationCacheSize = 1;
+
+    Learn::MappedClassificationLearningEnvironment<float> le(filePath, 3,
+                                                             0.8, 4);
+    Learn::ClassificationLearningAgent<Learn::ParallelLearningAgent> la(
+        le, set, params);
+    la.init();
+    for (uint64_t i = 0; i < 3; i++) {
+        ASSERT_NO_THROW(la.trainOneGeneration(i))
+            << "Training on a mapped dataset failed.";
+    }
+    ASSERT_GT(la.getObservationCache().getNbHits(), 0)
+        << "Samples of the mapped dataset should be replayed.";
+
+    delete &set.getInstruction(0);
+    delete &set.getInstruction(1);
+}
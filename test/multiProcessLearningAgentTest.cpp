@@ -0,0 +1,250 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "instructions/addPrimitiveType.h"
+#include "instructions/set.h"
+
+#include "learn/learningParameters.h"
+#include "learn/multiProcessLearningAgent.h"
+#include "learn/parallelLearningAgent.h"
+#include "learn/stickGameWithOpponent.h"
+
+/// StickGameWithOpponent declared as non copyable.
+class NonCopyableStickGame : public StickGameWithOpponent
+{
+  public:
+    bool isCopyable() const override
+    {
+        return false;
+    }
+};
+
+class MultiProcessLearningAgentTest : public ::testing::Test
+{
+  protected:
+    Instructions::Set set;
+    NonCopyableStickGame le;
+    Learn::LearningParameters params;
+
+    void SetUp() override
+    {
+        set.add(*(new Instructions::AddPrimitiveType<int>()));
+        set.add(*(new Instructions::AddPrimitiveType<double>()));
+
+        params.archiveSize = 50;
+        params.archivingProbability = 0.5;
+        params.maxNbActionsPerEval = 11;
+        params.nbIterationsPerPolicyEvaluation = 5;
+        params.ratioDeletedRoots = 0.2;
+        params.nbGenerations = 3;
+        params.maxNbEvaluationPerPolicy =
+            params.nbIterationsPerPolicyEvaluation * 2;
+        params.mutation.tpg.maxInitOutgoingEdges = 3;
+        params.mutation.prog.maxProgramSize = 96;
+        params.mutation.tpg.nbRoots = 15;
+        params.mutation.tpg.pEdgeDeletion = 0.7;
+        params.mutation.tpg.pEdgeAddition = 0.7;
+        params.mutation.tpg.pProgramMutation = 0.2;
+        params.mutation.tpg.pEdgeDestinationChange = 0.1;
+        params.mutation.tpg.pEdgeDestinationIsAction = 0.5;
+        params.mutation.tpg.maxOutgoingEdges = 4;
+        params.mutation.prog.pAdd = 0.5;
+        params.mutation.prog.pDelete = 0.5;
+        params.mutation.prog.pMutate = 1.0;
+        params.mutation.prog.pSwap = 1.0;
+        params.nbThreads = 4;
+    }
+
+    void TearDown() override
+    {
+        delete (&set.getInstruction(0));
+        delete (&set.getInstruction(1));
+    }
+};
+
+TEST_F(MultiProcessLearningAgentTest, Constructor)
+{
+    Learn::MultiProcessLearningAgent* mpla;
+
+    ASSERT_NO_THROW(mpla =
+                        new Learn::MultiProcessLearningAgent(le, set, params))
+        << "Construction of the MultiProcessLearningAgent failed.";
+
+    ASSERT_NO_THROW(delete mpla)
+        << "Destruction of the MultiProcessLearningAgent failed.";
+}
+
+TEST_F(MultiProcessLearningAgentTest, EvalAllRoots)
+{
+    Learn::MultiProcessLearningAgent mpla(le, set, params);
+    params.nbThreads = 1;
+    Learn::ParallelLearningAgent pla(le, set, params);
+
+    mpla.init();
+    pla.init();
+
+    Learn::ResultsTable results;
+    ASSERT_NO_THROW(
+        results = mpla.evaluateAllRoots(0, Learn::LearningMode::TRAINING))
+        << "Evaluation of roots in worker processes failed.";
+    Learn::ResultsTable sequentialResults =
+        pla.evaluateAllRoots(0, Learn::LearningMode::TRAINING);
+
+    ASSERT_EQ(results.size(), mpla.getTPGGraph()->getNbRootVertices())
+        << "Number of evaluated roots is incorrect.";
+    ASSERT_EQ(results.size(), sequentialResults.size())
+        << "Number of evaluated roots differs from the sequential evaluation.";
+    for (size_t row = 0; row < results.size(); row++) {
+        ASSERT_EQ(results.getScore(row), sequentialResults.getScore(row))
+            << "Score of a root differs from the sequential evaluation.";
+        ASSERT_EQ(results.getNbEvaluation(row),
+                  params.nbIterationsPerPolicyEvaluation)
+            << "Number of evaluations of a root is incorrect.";
+    }
+}
+
+TEST_F(MultiProcessLearningAgentTest, EvalAllRootsInferenceCost)
+{
+    params.inferenceCostPenalty = 0.1;
+    Learn::MultiProcessLearningAgent mpla(le, set, params);
+    Learn::ParallelLearningAgent pla(le, set, params);
+
+    mpla.init();
+    pla.init();
+
+    Learn::ResultsTable results =
+        mpla.evaluateAllRoots(0, Learn::LearningMode::TRAINING);
+    Learn::ResultsTable parallelResults =
+        pla.evaluateAllRoots(0, Learn::LearningMode::TRAINING);
+
+    ASSERT_EQ(results.size(), parallelResults.size())
+        << "Number of evaluated roots differs from the parallel evaluation.";
+    bool nonZeroCost = false;
+    for (size_t row = 0; row < results.size(); row++) {
+        ASSERT_EQ(results.getInferenceCost(row),
+                  parallelResults.getInferenceCost(row))
+            << "Inference cost of a root differs from the parallel "
+               "evaluation.";
+        nonZeroCost |= results.getInferenceCost(row) > 0.0;
+    }
+    ASSERT_TRUE(nonZeroCost)
+        << "Inference costs measured in worker processes were lost.";
+}
+
+TEST_F(MultiProcessLearningAgentTest, EvalAllRootsArchive)
+{
+    Learn::MultiProcessLearningAgent mpla(le, set, params);
+    Learn::ParallelLearningAgent pla(le, set, params);
+
+    mpla.init();
+    pla.init();
+
+    mpla.evaluateAllRoots(0, Learn::LearningMode::TRAINING);
+    pla.evaluateAllRoots(0, Learn::LearningMode::TRAINING);
+
+    const Archive& archive = mpla.getArchive();
+    const Archive& parallelArchive = pla.getArchive();
+    ASSERT_GT(archive.getNbRecordings(), 0)
+        << "Recordings of worker processes should fill the Archive.";
+    ASSERT_EQ(archive.getNbRecordings(), parallelArchive.getNbRecordings())
+        << "Number of recordings differs from the parallel evaluation.";
+    ASSERT_EQ(archive.getNbDataHandlers(), parallelArchive.getNbDataHandlers())
+        << "Number of DataHandler differs from the parallel evaluation.";
+    for (size_t i = 0; i < archive.getNbRecordings(); i++) {
+        ASSERT_EQ(archive.at(i).dataHash, parallelArchive.at(i).dataHash)
+            << "DataHandler of a recording differs from the parallel "
+               "evaluation.";
+        ASSERT_EQ(archive.at(i).result, parallelArchive.at(i).result)
+            << "Result of a recording differs from the parallel evaluation.";
+    }
+}
+
+TEST_F(MultiProcessLearningAgentTest, EvalAllRootsSkipped)
+{
+    params.maxNbEvaluationPerPolicy = params.nbIterationsPerPolicyEvaluation;
+    Learn::MultiProcessLearningAgent mpla(le, set, params);
+    mpla.init();
+
+    Learn::ResultsTable results =
+        mpla.evaluateAllRoots(0, Learn::LearningMode::TRAINING);
+    mpla.updateEvaluationRecords(results);
+
+    // Roots were evaluated enough: previous results must be returned.
+    Learn::ResultsTable skippedResults =
+        mpla.evaluateAllRoots(1, Learn::LearningMode::TRAINING);
+    ASSERT_EQ(results.size(), skippedResults.size())
+        << "Number of evaluated roots is incorrect.";
+    for (size_t row = 0; row < results.size(); row++) {
+        ASSERT_EQ(results.getEvaluationResult(row),
+                  skippedResults.getEvaluationResult(row))
+            << "Recorded EvaluationResult should be returned for roots whose "
+               "evaluation is skipped.";
+    }
+}
+
+TEST_F(MultiProcessLearningAgentTest, Train)
+{
+    Learn::MultiProcessLearningAgent mpla(le, set, params);
+    mpla.init();
+    bool alt = false;
+
+    ASSERT_NO_THROW(mpla.train(alt, false))
+        << "Training a TPG with worker processes should not fail.";
+    ASSERT_NE(mpla.getBestRoot().first, nullptr)
+        << "A best root should have been found during the training.";
+}
+
+TEST_F(MultiProcessLearningAgentTest, WorkerInitializer)
+{
+    Learn::MultiProcessLearningAgent mpla(le, set, params);
+    mpla.init();
+
+    ASSERT_NO_THROW(mpla.setWorkerInitializer(
+        [](Learn::LearningEnvironment& workerLE) { workerLE.reset(); }))
+        << "Setting the worker initializer failed unexpectedly.";
+    ASSERT_NO_THROW(mpla.evaluateAllRoots(0, Learn::LearningMode::TRAINING))
+        << "Evaluation with a worker initializer failed unexpectedly.";
+
+#ifndef _WIN32
+    mpla.setWorkerInitializer([](Learn::LearningEnvironment&) {
+        throw std::runtime_error("Environment can not be initialized.");
+    });
+    ASSERT_THROW(mpla.evaluateAllRoots(0, Learn::LearningMode::TRAINING),
+                 std::runtime_error)
+        << "Failure of worker processes should be reported.";
+#endif
+}
@@ -0,0 +1,216 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+
+#include "instructions/addPrimitiveType.h"
+#include "instructions/set.h"
+#include "learn/observationCache.h"
+
+#include "learn/replayableClassificationLearningEnvironment.h"
+
+// Stream of the given footprint, without frames.
+static std::shared_ptr<const Learn::ObservationStream> makeStream(
+    size_t memorySize)
+{
+    auto stream = std::make_shared<Learn::ObservationStream>();
+    stream->memorySize = memorySize;
+    return stream;
+}
+
+TEST(ObservationCacheTest, Disabled)
+{
+    Learn::ObservationCache cache;
+    ASSERT_FALSE(cache.isEnabled()) << "Cache should be disabled by default.";
+
+    Learn::ObservationCache cache2(1024);
+    ASSERT_TRUE(cache2.isEnabled());
+}
+
+TEST(ObservationCacheTest, HitsAndMisses)
+{
+    Learn::ObservationCache cache(1024);
+    Learn::ObservationCache::Key key{12, Learn::LearningMode::TRAINING, 1, 2};
+
+    uint64_t nbRecords = 0;
+    auto record = [&nbRecords]() {
+        nbRecords++;
+        return makeStream(100);
+    };
+
+    std::shared_ptr<const Learn::ObservationStream> stream1, stream2;
+    ASSERT_NO_THROW(stream1 = cache.getStream(key, record));
+    ASSERT_NO_THROW(stream2 = cache.getStream(key, record));
+    ASSERT_EQ(stream1, stream2) << "Cached stream should be returned.";
+    ASSERT_EQ(nbRecords, 1);
+    ASSERT_EQ(cache.getNbMisses(), 1);
+    ASSERT_EQ(cache.getNbHits(), 1);
+    ASSERT_EQ(cache.getNbStreams(), 1);
+    ASSERT_EQ(cache.getMemorySize(), 100);
+
+    // Any difference in the reset arguments is a different episode.
+    Learn::ObservationCache::Key key2 = key;
+    key2.mode = Learn::LearningMode::VALIDATION;
+    ASSERT_NE(cache.getStream(key2, record), stream1);
+    ASSERT_EQ(nbRecords, 2);
+
+    cache.clear();
+    ASSERT_EQ(cache.getNbStreams(), 0);
+    ASSERT_EQ(cache.getMemorySize(), 0);
+    ASSERT_NO_THROW(cache.getStream(key, record));
+    ASSERT_EQ(nbRecords, 3);
+}
+
+TEST(ObservationCacheTest, LeastRecentlyUsedEviction)
+{
+    Learn::ObservationCache cache(250);
+    auto record = []() { return makeStream(100); };
+    Learn::ObservationCache::Key key0{0, Learn::LearningMode::TRAINING, 0, 0};
+    Learn::ObservationCache::Key key1{1, Learn::LearningMode::TRAINING, 0, 0};
+    Learn::ObservationCache::Key key2{2, Learn::LearningMode::TRAINING, 0, 0};
+
+    cache.getStream(key0, record);
+    cache.getStream(key1, record);
+    // Use key0 again so that key1 becomes the least recently used.
+    cache.getStream(key0, record);
+    cache.getStream(key2, record);
+
+    ASSERT_EQ(cache.getNbStreams(), 2) << "Memory cap was not enforced.";
+    ASSERT_EQ(cache.getMemorySize(), 200);
+
+    uint64_t nbHits = cache.getNbHits();
+    cache.getStream(key0, record);
+    cache.getStream(key2, record);
+    ASSERT_EQ(cache.getNbHits(), nbHits + 2)
+        << "Most recently used streams should have been kept.";
+    cache.getStream(key1, record);
+    ASSERT_EQ(cache.getNbHits(), nbHits + 2)
+        << "Least recently used stream should have been evicted.";
+
+    // A stream exceeding the cap on its own is not cached.
+    Learn::ObservationCache::Key key3{3, Learn::LearningMode::TRAINING, 0, 0};
+    auto stream = cache.getStream(key3, []() { return makeStream(300); });
+    ASSERT_EQ(stream->memorySize, 300);
+    ASSERT_EQ(cache.getNbStreams(), 2);
+    ASSERT_LE(cache.getMemorySize(), 250);
+}
+
+TEST(ObservationCacheTest, RecordingFailure)
+{
+    Learn::ObservationCache cache(1024);
+    Learn::ObservationCache::Key key{0, Learn::LearningMode::TRAINING, 0, 0};
+
+    ASSERT_THROW(cache.getStream(key,
+                                 []() -> std::shared_ptr<
+                                          const Learn::ObservationStream> {
+                                     throw std::runtime_error("Failure");
+                                 }),
+                 std::runtime_error);
+    ASSERT_EQ(cache.getNbStreams(), 0)
+        << "Failed recordings should not be cached.";
+    ASSERT_NO_THROW(cache.getStream(key, []() { return makeStream(1); }));
+    ASSERT_EQ(cache.getNbStreams(), 1);
+}
+
+TEST(ObservationCacheTest, ConcurrentRecording)
+{
+    Learn::ObservationCache cache(1024);
+    Learn::ObservationCache::Key key{0, Learn::LearningMode::TRAINING, 0, 0};
+
+    std::atomic<uint64_t> nbRecords(0);
+    auto record = [&nbRecords]() {
+        nbRecords++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return makeStream(10);
+    };
+
+    std::vector<std::shared_ptr<const Learn::ObservationStream>> streams(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < streams.size(); i++) {
+        threads.emplace_back(
+            [&, i]() { streams[i] = cache.getStream(key, record); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(nbRecords, 1)
+        << "Concurrent getStream should wait for the first recording.";
+    for (auto& stream : streams) {
+        ASSERT_EQ(stream, streams.at(0));
+    }
+}
+
+TEST(ObservationCacheTest, RecordStream)
+{
+    Instructions::Set set;
+    set.add(*(new Instructions::AddPrimitiveType<int>()));
+    ReplayableClassificationLearningEnvironment le;
+
+    Learn::ObservationCache::Key key{42, Learn::LearningMode::TRAINING, 0, 0};
+    std::shared_ptr<const Learn::ObservationStream> stream;
+    ASSERT_NO_THROW(stream = Learn::ObservationCache::recordStream(
+                        le, set, key, 5));
+
+    ASSERT_EQ(stream->frames.size(), 5);
+    ASSERT_EQ(stream->memorySize, 5 * 8);
+    ASSERT_EQ(le.getNbSamples(), 6) << "Reset and 5 actions should produce "
+                                       "6 samples.";
+    for (size_t i = 0; i < stream->frames.size(); i++) {
+        const Learn::ObservationFrame& frame = stream->frames.at(i);
+        int expected = 42 + 7 * (int)i;
+        ASSERT_EQ(frame.label, expected % 3);
+        ASSERT_EQ(frame.dataSources.size(), 1);
+        ASSERT_EQ(frame.dataSources.at(0).get().getId(),
+                  le.getDataSources().at(0).get().getId())
+            << "Copies should keep the id of the data sources.";
+        ASSERT_EQ(*frame.dataSources.at(0)
+                       .get()
+                       .getDataAt(typeid(int), 0)
+                       .getSharedPointer<const int>(),
+                  expected);
+    }
+
+    // Replay resets and scores without producing samples.
+    le.resetReplay(42, Learn::LearningMode::TRAINING, 0, 0);
+    for (const auto& frame : stream->frames) {
+        le.replayAction(frame.label, frame.label);
+    }
+    ASSERT_EQ(le.getNbSamples(), 6);
+    ASSERT_EQ(le.getScore(), 1.0) << "All replayed guesses were correct.";
+
+    delete &set.getInstruction(0);
+}
@@ -60,7 +60,7 @@ TEST(LearningParametersTest, readConfigFile)
         << "Ill-formed parameters file should result in no root filling";
 
     File::ParametersParser::readConfigFile(TESTS_DAT_PATH "params.json", root);
-    ASSERT_EQ(13, root.size())
+    ASSERT_EQ(25, root.size())
         << "Wrong number of elements in parsed json file";
     ASSERT_EQ(10, root["mutation"]["tpg"].size())
         << "Wrong number of elements in parsed json file";
@@ -98,6 +98,19 @@ TEST(LearningParametersTest, setAllParamsFrom)
     ASSERT_EQ(2.0, params.nbThreads);
     ASSERT_EQ(200, params.nbGenerations);
     ASSERT_EQ(true, params.doValidation);
+    ASSERT_EQ(true, params.pipelineValidation);
+    ASSERT_EQ(2, params.maxNbIterationsPerJob);
+    ASSERT_EQ("scatter", params.threadAffinity);
+    ASSERT_EQ(4, params.nbEpisodesInFlight);
+    ASSERT_EQ(16, params.observationCacheSize);
+    ASSERT_EQ(3, params.nbIslands);
+    ASSERT_EQ(7, params.migrationInterval);
+    ASSERT_EQ(2, params.nbMigrants);
+    ASSERT_EQ(0.25, params.inferenceCostPenalty);
+    ASSERT_TRUE(params.paretoCostSelection);
+    ASSERT_EQ(2.0, params.teamInferenceCost);
+    ASSERT_EQ(std::vector<double>({1.0, 4.0, 0.5}),
+              params.instructionInferenceCosts);
     ASSERT_EQ(100, params.mutation.tpg.nbRoots);
     ASSERT_EQ(5, params.mutation.tpg.initNbRoots);
     ASSERT_EQ(3, params.mutation.tpg.maxInitOutgoingEdges);
@@ -170,11 +183,24 @@ TEST(LearningParametersTest, writeParametersToJson)
     ASSERT_EQ(params.archiveSize, params2.archiveSize);
     ASSERT_EQ(params.archivingProbability, params2.archivingProbability);
     ASSERT_EQ(params.doValidation, params2.doValidation);
+    ASSERT_EQ(params.pipelineValidation, params2.pipelineValidation);
+    ASSERT_EQ(params.maxNbIterationsPerJob, params2.maxNbIterationsPerJob);
+    ASSERT_EQ(params.threadAffinity, params2.threadAffinity);
+    ASSERT_EQ(params.nbEpisodesInFlight, params2.nbEpisodesInFlight);
+    ASSERT_EQ(params.observationCacheSize, params2.observationCacheSize);
     ASSERT_EQ(params.maxNbActionsPerEval, params2.maxNbActionsPerEval);
     ASSERT_EQ(params.maxNbEvaluationPerPolicy,
               params2.maxNbEvaluationPerPolicy);
     ASSERT_EQ(params.nbGenerations, params2.nbGenerations);
     ASSERT_EQ(params.nbIterationsPerJob, params2.nbIterationsPerJob);
+    ASSERT_EQ(params.nbIslands, params2.nbIslands);
+    ASSERT_EQ(params.migrationInterval, params2.migrationInterval);
+    ASSERT_EQ(params.nbMigrants, params2.nbMigrants);
+    ASSERT_EQ(params.inferenceCostPenalty, params2.inferenceCostPenalty);
+    ASSERT_EQ(params.paretoCostSelection, params2.paretoCostSelection);
+    ASSERT_EQ(params.teamInferenceCost, params2.teamInferenceCost);
+    ASSERT_EQ(params.instructionInferenceCosts,
+              params2.instructionInferenceCosts);
     ASSERT_EQ(params.nbIterationsPerPolicyEvaluation,
               params2.nbIterationsPerPolicyEvaluation);
     ASSERT_EQ(params.nbProgramConstant, params2.nbProgramConstant);
@@ -0,0 +1,203 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "util/profiler.h"
+
+class ProfilerTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        Util::Profiler::clear();
+        Util::Profiler::enable();
+    }
+
+    void TearDown() override
+    {
+        Util::Profiler::enable(false);
+        Util::Profiler::setMaxTraceDepth(3);
+        Util::Profiler::clear();
+    }
+};
+
+TEST_F(ProfilerTest, EnableDisable)
+{
+    ASSERT_TRUE(Util::Profiler::isEnabled());
+    Util::Profiler::enable(false);
+    ASSERT_FALSE(Util::Profiler::isEnabled());
+
+    {
+        Util::Profiler::ScopedTimer timer("disabled");
+        Util::Profiler::count("disabledCounter", 3);
+    }
+    ASSERT_TRUE(Util::Profiler::collectEvents().empty())
+        << "No event should be recorded by a disabled Profiler.";
+    ASSERT_TRUE(Util::Profiler::collectPhases().empty());
+    ASSERT_TRUE(Util::Profiler::collectCounters().empty());
+}
+
+TEST_F(ProfilerTest, NestedScopes)
+{
+    uint64_t before = Util::Profiler::now();
+    {
+        Util::Profiler::ScopedTimer outer("outer");
+        for (int i = 0; i < 3; i++) {
+            Util::Profiler::ScopedTimer inner("inner");
+        }
+    }
+    uint64_t after = Util::Profiler::now();
+
+    auto events = Util::Profiler::collectEvents();
+    ASSERT_EQ(events.size(), 4);
+    // Sorted by start time
+    ASSERT_STREQ(events.at(0).name, "outer");
+    ASSERT_EQ(events.at(0).parent, nullptr);
+    ASSERT_EQ(events.at(0).depth, 0);
+    ASSERT_GE(events.at(0).start, before);
+    ASSERT_LE(events.at(0).start + events.at(0).duration, after);
+    for (size_t i = 1; i < 4; i++) {
+        ASSERT_STREQ(events.at(i).name, "inner");
+        ASSERT_STREQ(events.at(i).parent, "outer");
+        ASSERT_EQ(events.at(i).depth, 1);
+        ASSERT_EQ(events.at(i).threadId, events.at(0).threadId);
+        ASSERT_GE(events.at(i).start, events.at(i - 1).start);
+        ASSERT_LE(events.at(i).start + events.at(i).duration,
+                  events.at(0).start + events.at(0).duration);
+    }
+
+    auto phases = Util::Profiler::collectPhases();
+    ASSERT_EQ(phases.size(), 2);
+    ASSERT_EQ((phases.at({"", "outer"}).count), 1);
+    ASSERT_EQ((phases.at({"outer", "inner"}).count), 3);
+    ASSERT_LE((phases.at({"outer", "inner"}).totalTime),
+              (phases.at({"", "outer"}).totalTime));
+
+    // Collecting removes recorded data
+    ASSERT_TRUE(Util::Profiler::collectEvents().empty());
+    ASSERT_TRUE(Util::Profiler::collectPhases().empty());
+}
+
+TEST_F(ProfilerTest, MaxTraceDepth)
+{
+    Util::Profiler::setMaxTraceDepth(1);
+    ASSERT_EQ(Util::Profiler::getMaxTraceDepth(), 1);
+    {
+        Util::Profiler::ScopedTimer outer("outer");
+        Util::Profiler::ScopedTimer inner("inner");
+    }
+
+    auto events = Util::Profiler::collectEvents();
+    ASSERT_EQ(events.size(), 1) << "Nested events should not be kept.";
+    ASSERT_STREQ(events.at(0).name, "outer");
+    ASSERT_EQ(Util::Profiler::collectPhases().size(), 2)
+        << "Statistics should be kept for all scopes.";
+}
+
+TEST_F(ProfilerTest, UntracedScopes)
+{
+    {
+        Util::Profiler::ScopedTimer outer("outer");
+        for (int i = 0; i < 3; i++) {
+            Util::Profiler::ScopedTimer inner("inner", nullptr, false);
+        }
+    }
+
+    auto events = Util::Profiler::collectEvents();
+    ASSERT_EQ(events.size(), 1) << "Untraced scopes should not be kept.";
+    ASSERT_STREQ(events.at(0).name, "outer");
+    ASSERT_EQ((Util::Profiler::collectPhases().at({"outer", "inner"}).count),
+              3)
+        << "Statistics should be kept for untraced scopes.";
+}
+
+TEST_F(ProfilerTest, Threads)
+{
+    {
+        Util::Profiler::ScopedTimer outer("outer");
+        Util::Profiler::count("counter", 2);
+        std::thread thread([]() {
+            Util::Profiler::ScopedTimer worker("worker", "outer");
+            Util::Profiler::ScopedTimer inner("inner", "unused");
+            Util::Profiler::count("counter", 3);
+        });
+        thread.join();
+    }
+
+    // Events of the terminated thread are kept
+    auto events = Util::Profiler::collectEvents();
+    ASSERT_EQ(events.size(), 3);
+    ASSERT_STREQ(events.at(1).name, "worker");
+    ASSERT_STREQ(events.at(1).parent, "outer")
+        << "The default parent should be used by the first scope of a thread.";
+    ASSERT_EQ(events.at(1).depth, 1)
+        << "The default parent should count in the depth of the scope.";
+    ASSERT_NE(events.at(1).threadId, events.at(0).threadId);
+    ASSERT_STREQ(events.at(2).parent, "worker")
+        << "The default parent should be ignored within another scope.";
+    ASSERT_EQ(events.at(2).depth, 2);
+
+    auto phases = Util::Profiler::collectPhases();
+    ASSERT_EQ(phases.size(), 3);
+    ASSERT_EQ(phases.count({"outer", "worker"}), 1);
+    ASSERT_EQ(phases.count({"worker", "inner"}), 1);
+
+    auto counters = Util::Profiler::collectCounters();
+    ASSERT_EQ(counters.size(), 1);
+    ASSERT_EQ(counters.at("counter"), 5)
+        << "Counters of all threads should be summed.";
+    ASSERT_TRUE(Util::Profiler::collectCounters().empty());
+}
+
+TEST_F(ProfilerTest, Macros)
+{
+    {
+        GEGELATI_PROFILE_SCOPE("macroScope");
+        GEGELATI_PROFILE_SCOPE_IN("macroScopeIn", "unused");
+        GEGELATI_PROFILE_STATS_SCOPE("macroStatsScope");
+        GEGELATI_PROFILE_STATS_SCOPE_IN("macroStatsScopeIn", "unused");
+        GEGELATI_PROFILE_COUNT("macroCounter", 1);
+    }
+
+#ifdef GEGELATI_PROFILING
+    ASSERT_EQ(Util::Profiler::collectEvents().size(), 2);
+    ASSERT_EQ(Util::Profiler::collectPhases().size(), 4);
+    ASSERT_EQ(Util::Profiler::collectCounters().at("macroCounter"), 1);
+#else
+    ASSERT_TRUE(Util::Profiler::collectEvents().empty())
+        << "Macros should do nothing without the PROFILING option.";
+    ASSERT_TRUE(Util::Profiler::collectCounters().empty());
+#endif
+}
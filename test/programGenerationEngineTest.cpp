@@ -35,7 +35,9 @@
  */
 
 #ifdef CODE_GENERATION
+#include <fstream>
 #include <gtest/gtest.h>
+#include <sstream>
 
 #if defined(_MSC_VER) || (__MINGW32__)
 // C++17 not available in gcc7 or clang7
@@ -250,6 +252,106 @@ TEST_F(ProgramGenerationEngineTest, generateProgram)
         << "Fail to generate a program with constant";
 }
 
+TEST_F(ProgramGenerationEngineTest, generateProgramDeduplication)
+{
+    CodeGen::ProgramGenerationEngine engine("genDeduplication", *p);
+    Program::Program copy(*p);
+    Program::Program other(*p);
+    // Reg[0] = reg[0] - in1[6];
+    other.getLine(4).setOperand(1, 1, 6);
+
+    ASSERT_EQ(engine.generateProgram(1), 1)
+        << "A new program should be generated with its own identifier.";
+    engine.setProgram(copy);
+    ASSERT_EQ(engine.generateProgram(2), 1)
+        << "An identical program should reuse the generated function.";
+    engine.setProgram(other);
+    ASSERT_EQ(engine.generateProgram(3), 3)
+        << "A different program should be generated with its own identifier.";
+}
+
+TEST_F(ProgramGenerationEngineTest, generateProgramDeduplicationAttribute)
+{
+    CodeGen::ProgramGenerationEngine* engine =
+        new CodeGen::ProgramGenerationEngine("genDeduplicationAttribute", *p);
+    Program::Program copy(*p);
+    Program::Program other(*p);
+    // Reg[0] = reg[0] - in1[6];
+    other.getLine(4).setOperand(1, 1, 6);
+
+    engine->initProfileMacros();
+    ASSERT_EQ(engine->generateProgram(1, false, "TPG_COLD "), 1)
+        << "A new program should be generated with its own identifier.";
+    engine->setProgram(copy);
+    ASSERT_EQ(engine->generateProgram(2, false, "TPG_HOT "), 1)
+        << "An identical program should reuse the generated function.";
+    engine->setProgram(other);
+    ASSERT_EQ(engine->generateProgram(3, false, "TPG_COLD "), 3)
+        << "A different program should be generated with its own identifier.";
+    delete engine; // call the destructor to close the file.
+
+    std::ifstream header("genDeduplicationAttribute.h");
+    std::stringstream content;
+    content << header.rdbuf();
+    ASSERT_NE(content.str().find("TPG_HOT double P1();"), std::string::npos)
+        << "A function shared with a hot program should be hot.";
+    ASSERT_EQ(content.str().find("TPG_COLD double P1();"), std::string::npos)
+        << "A function shared with a hot program should not be cold.";
+    ASSERT_NE(content.str().find("TPG_COLD double P3();"), std::string::npos)
+        << "A function of cold programs only should be cold.";
+}
+
+TEST_F(ProgramGenerationEngineTest, generateOptimizedProgram)
+{
+    Program::Program copy(*p);
+    // Dead store, not marked as an intron: Reg[3] = in1[2] + in1[3];
+    Program::Line& l5 = copy.addNewLine();
+    l5.setInstructionIndex(0);
+    l5.setOperand(0, 1, 2);
+    l5.setOperand(1, 1, 3);
+    l5.setDestinationIndex(3);
+
+    Program::Program withConstant(*envWithConstant);
+    withConstant.getConstantHandler().setDataAt(typeid(Data::Constant), 1,
+                                                Data::Constant{7});
+    // Reg[0] = (double)(cst[1]) - in1[1];
+    Program::Line& l0 = withConstant.addNewLine();
+    l0.setInstructionIndex(3);
+    l0.setOperand(0, 1, 1);
+    l0.setOperand(1, 2, 1);
+    l0.setDestinationIndex(0);
+
+    CodeGen::ProgramGenerationEngine* engine =
+        new CodeGen::ProgramGenerationEngine("genOptimized", copy);
+    ASSERT_FALSE(engine->isOptimization())
+        << "Optimization should be disabled by default.";
+    engine->setOptimization(true);
+    ASSERT_TRUE(engine->isOptimization()) << "Optimization was not enabled.";
+    ASSERT_NO_THROW(engine->generateProgram(1))
+        << "Fail to generate an optimized program.";
+    delete engine; // call the destructor to close the file.
+
+    engine = new CodeGen::ProgramGenerationEngine("genOptimizedConstant",
+                                                  withConstant);
+    engine->setOptimization(true);
+    ASSERT_NO_THROW(engine->generateProgram(2))
+        << "Fail to generate an optimized program with constant.";
+    delete engine;
+
+    ASSERT_TRUE(compare_files(
+        "genOptimized.c",
+        TESTS_DAT_PATH "codeGen/ProgramGenerationEngineTest.generateOptimized"
+                       "Program/goldenReference.c_ref"))
+        << "Error the source file generated is different from the golden "
+           "reference.";
+    ASSERT_TRUE(compare_files(
+        "genOptimizedConstant.c",
+        TESTS_DAT_PATH "codeGen/ProgramGenerationEngineTest.generateOptimized"
+                       "Program/goldenReferenceConstant.c_ref"))
+        << "Error the source file generated is different from the golden "
+           "reference.";
+}
+
 TEST_F(ProgramGenerationEngineTest, initOperandCurrentLine)
 {
 
@@ -333,6 +333,23 @@ TEST_F(ProgramTest, identifyIntronsAndIsIntron)
     delete (&set.getInstruction(2));
 }
 
+TEST_F(ProgramTest, setIntron)
+{
+    Program::Program p(*e);
+    p.addNewLine();
+    p.addNewLine();
+
+    ASSERT_FALSE(p.isIntron(1)) << "New lines should not be introns.";
+    ASSERT_NO_THROW(p.setIntron(1, true))
+        << "Setting the intron property of a line failed.";
+    ASSERT_TRUE(p.isIntron(1)) << "Intron property was not set.";
+    ASSERT_FALSE(p.isIntron(0)) << "Other lines should not be modified.";
+    ASSERT_NO_THROW(p.setIntron(1, false));
+    ASSERT_FALSE(p.isIntron(1)) << "Intron property was not reset.";
+    ASSERT_THROW(p.setIntron(2, true), std::out_of_range)
+        << "Setting the intron property of a non-existing line should fail.";
+}
+
 TEST_F(ProgramTest, clearIntrons)
 {
     // Create a new environment with instruction accessing arrays
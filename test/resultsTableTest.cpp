@@ -0,0 +1,236 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "learn/classificationEvaluationResult.h"
+#include "learn/evaluationResult.h"
+#include "learn/resultsTable.h"
+#include "tpg/tpgAction.h"
+
+class ResultsTableTest : public ::testing::Test
+{
+  protected:
+    std::vector<TPG::TPGAction*> vertices;
+
+    void SetUp() override
+    {
+        for (uint64_t i = 0; i < 4; i++) {
+            vertices.push_back(new TPG::TPGAction(i));
+        }
+    }
+
+    void TearDown() override
+    {
+        for (auto vertex : vertices) {
+            delete vertex;
+        }
+    }
+};
+
+TEST_F(ResultsTableTest, AddRowAndGetters)
+{
+    Learn::ResultsTable results;
+
+    ASSERT_TRUE(results.empty()) << "A new ResultsTable should be empty.";
+
+    size_t row;
+    ASSERT_NO_THROW(
+        row = results.addRow(
+            vertices.at(0), std::make_shared<Learn::EvaluationResult>(2.0, 5)))
+        << "Adding a row to a ResultsTable failed unexpectedly.";
+    ASSERT_EQ(row, 0) << "Index of the first added row is incorrect.";
+    results.addRow(vertices.at(1),
+                   std::make_shared<Learn::EvaluationResult>(1.0, 3));
+
+    ASSERT_EQ(results.size(), 2) << "Number of rows is incorrect.";
+    ASSERT_EQ(results.getRoot(1), vertices.at(1))
+        << "Getter returned an unexpected value.";
+    ASSERT_EQ(results.getScore(0), 2.0)
+        << "Getter returned an unexpected value.";
+    ASSERT_EQ(results.getNbEvaluation(1), 3)
+        << "Getter returned an unexpected value.";
+    ASSERT_EQ(results.getEvaluationResult(0)->getResult(), 2.0)
+        << "Getter returned an unexpected value.";
+    ASSERT_EQ(results.findRow(vertices.at(1)), 1)
+        << "Row of an existing root was not found.";
+    ASSERT_EQ(results.findRow(vertices.at(3)), results.size())
+        << "Row of an absent root should be equal to the table size.";
+
+    results.clear();
+    ASSERT_TRUE(results.empty()) << "Cleared ResultsTable should be empty.";
+}
+
+TEST_F(ResultsTableTest, ScoreStatistics)
+{
+    Learn::ResultsTable results;
+
+    ASSERT_THROW(results.getBestRow(), std::runtime_error)
+        << "Getting the best row of an empty table should fail.";
+    ASSERT_EQ(results.getMaxScore(), 0.0)
+        << "Max score of an empty table should be 0.";
+
+    results.addRow(vertices.at(0),
+                   std::make_shared<Learn::EvaluationResult>(1.0, 1));
+    results.addRow(vertices.at(1),
+                   std::make_shared<Learn::EvaluationResult>(3.0, 1));
+    results.addRow(vertices.at(2),
+                   std::make_shared<Learn::EvaluationResult>(2.0, 1));
+
+    ASSERT_EQ(results.getBestRow(), 1) << "Best row is incorrect.";
+    ASSERT_EQ(results.getMinScore(), 1.0) << "Min score is incorrect.";
+    ASSERT_EQ(results.getMaxScore(), 3.0) << "Max score is incorrect.";
+    ASSERT_EQ(results.getAvgScore(), 2.0) << "Average score is incorrect.";
+}
+
+TEST_F(ResultsTableTest, RowOrdering)
+{
+    Learn::ResultsTable results;
+
+    // Rows 1 and 2 have equal scores: the last added one ranks better.
+    results.addRow(vertices.at(0),
+                   std::make_shared<Learn::EvaluationResult>(3.0, 1));
+    results.addRow(vertices.at(1),
+                   std::make_shared<Learn::EvaluationResult>(1.0, 1));
+    results.addRow(vertices.at(2),
+                   std::make_shared<Learn::EvaluationResult>(1.0, 1));
+    results.addRow(vertices.at(3),
+                   std::make_shared<Learn::EvaluationResult>(2.0, 1));
+
+    ASSERT_EQ(results.getSortedRows(), std::vector<size_t>({1, 2, 3, 0}))
+        << "Rows were not sorted as expected.";
+    ASSERT_EQ(results.getWorstRows(2), std::vector<size_t>({1, 2}))
+        << "Worst rows are incorrect.";
+    ASSERT_EQ(results.getBestRows(3), std::vector<size_t>({0, 3, 2}))
+        << "Best rows are incorrect.";
+    ASSERT_EQ(results.getBestRows(10).size(), 4)
+        << "Number of returned rows should be capped by the table size.";
+    ASSERT_EQ(results.getBestRow(), 0) << "Best row is incorrect.";
+}
+
+TEST_F(ResultsTableTest, InferenceCostOrdering)
+{
+    Learn::ResultsTable results;
+    const std::vector<double> scores = {3.0, 2.0, 1.0, 2.0};
+    const std::vector<double> costs = {10.0, 1.0, 5.0, 1.0};
+    for (size_t i = 0; i < 4; i++) {
+        auto result = std::make_shared<Learn::EvaluationResult>(scores[i], 1);
+        result->setInferenceCost(costs[i]);
+        results.addRow(vertices.at(i), result);
+    }
+
+    ASSERT_EQ(results.getInferenceCost(2), 5.0)
+        << "Getter returned an unexpected value.";
+    ASSERT_EQ(results.getWorstRows(4, 0.0), results.getSortedRows())
+        << "Rows without penalty should be sorted on their score.";
+    ASSERT_EQ(results.getWorstRows(4, 0.5), std::vector<size_t>({0, 2, 1, 3}))
+        << "Rows were not sorted on their penalized score.";
+    ASSERT_EQ(results.getWorstRows(1, 0.5), std::vector<size_t>({0}))
+        << "Worst rows are incorrect.";
+
+    // Row 2 is dominated by rows 1 and 3, which are equal.
+    ASSERT_EQ(results.getParetoWorstRows(4, 0.0),
+              std::vector<size_t>({2, 1, 3, 0}))
+        << "Rows were not sorted on their Pareto front.";
+    ASSERT_EQ(results.getParetoWorstRows(4, 0.5),
+              std::vector<size_t>({2, 0, 1, 3}))
+        << "Rows of a Pareto front were not sorted on their penalized score.";
+    ASSERT_EQ(results.getParetoWorstRows(2, 0.0), std::vector<size_t>({2, 1}))
+        << "Worst rows are incorrect.";
+
+    results.removeRows({false, false, true, false});
+    ASSERT_EQ(results.getInferenceCost(2), 1.0)
+        << "Inference costs were not compacted with the other columns.";
+}
+
+TEST_F(ResultsTableTest, RemoveRows)
+{
+    Learn::ResultsTable results;
+    for (size_t i = 0; i < 4; i++) {
+        results.addRow(vertices.at(i),
+                       std::make_shared<Learn::EvaluationResult>(i, 1));
+    }
+
+    ASSERT_THROW(results.removeRows({true, false}), std::runtime_error)
+        << "Removing rows with an incorrectly sized mask should fail.";
+
+    ASSERT_NO_THROW(results.removeRows({true, false, true, false}))
+        << "Removing rows failed unexpectedly.";
+    ASSERT_EQ(results.size(), 2) << "Number of remaining rows is incorrect.";
+    ASSERT_EQ(results.getRoot(0), vertices.at(1))
+        << "Remaining rows are not in their original order.";
+    ASSERT_EQ(results.getScore(1), 3.0)
+        << "Remaining rows are not in their original order.";
+}
+
+TEST_F(ResultsTableTest, ScoresPerClass)
+{
+    Learn::ResultsTable results;
+
+    // A non-classification row before the first classification row is
+    // padded with null class scores.
+    results.addRow(vertices.at(0),
+                   std::make_shared<Learn::EvaluationResult>(1.0, 1));
+    ASSERT_EQ(results.getNbClasses(), 0)
+        << "Number of classes should be 0 without classification results.";
+
+    results.addRow(vertices.at(1),
+                   std::make_shared<Learn::ClassificationEvaluationResult>(
+                       std::vector<double>({0.5, 0.25}),
+                       std::vector<size_t>({2, 4})));
+    ASSERT_EQ(results.getNbClasses(), 2) << "Number of classes is incorrect.";
+    ASSERT_EQ(results.getScorePerClass(0, 1), 0.0)
+        << "Row without classification result should have null class scores.";
+    ASSERT_EQ(results.getScorePerClass(1, 0), 0.5)
+        << "Getter returned an unexpected value.";
+    ASSERT_EQ(results.getScorePerClass(1, 1), 0.25)
+        << "Getter returned an unexpected value.";
+    ASSERT_THROW(results.getScorePerClass(1, 2), std::out_of_range)
+        << "Accessing an out of range class should fail.";
+
+    ASSERT_THROW(
+        results.addRow(vertices.at(2),
+                       std::make_shared<Learn::ClassificationEvaluationResult>(
+                           std::vector<double>({0.5, 0.25, 0.0}),
+                           std::vector<size_t>({2, 4, 1}))),
+        std::runtime_error)
+        << "Adding a row with a different number of classes should fail.";
+
+    results.removeRows({true, false});
+    ASSERT_EQ(results.getScorePerClass(0, 0), 0.5)
+        << "Class scores were not moved with their row.";
+}
@@ -0,0 +1,129 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "util/shardedCounter.h"
+
+TEST(ShardedCounterTest, IncrementAndReset)
+{
+    Util::ShardedCounter counter;
+    ASSERT_EQ(counter.get(), 0) << "New counter should be zero.";
+
+    for (int i = 0; i < 10; i++) {
+        counter.increment();
+    }
+    ASSERT_EQ(counter.get(), 10);
+
+    counter.reset();
+    ASSERT_EQ(counter.get(), 0) << "Reset counter should be zero.";
+    counter.increment();
+    ASSERT_EQ(counter.get(), 1);
+}
+
+TEST(ShardedCounterTest, Threads)
+{
+    Util::ShardedCounter counter;
+    counter.increment();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&counter]() {
+            for (int j = 0; j < 1000; j++) {
+                counter.increment();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(counter.get(), 4001)
+        << "Increments of terminated threads should be kept.";
+    counter.reset();
+    ASSERT_EQ(counter.get(), 0)
+        << "Reset should clear increments of terminated threads.";
+}
+
+TEST(ShardedCounterTest, ConcurrentReset)
+{
+    for (int round = 0; round < 20; round++) {
+        Util::ShardedCounter counter;
+        std::atomic<bool> resetStarted{false};
+        std::atomic<uint64_t> nbBeforeReset{0};
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++) {
+            threads.emplace_back([&]() {
+                for (int j = 0; j < 10000; j++) {
+                    counter.increment();
+                    // This increment completed before the reset started.
+                    if (!resetStarted.load()) {
+                        nbBeforeReset++;
+                    }
+                }
+            });
+        }
+        std::this_thread::yield();
+        resetStarted.store(true);
+        counter.reset();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        ASSERT_LE(counter.get(), 4 * 10000 - nbBeforeReset.load())
+            << "Increments made before the reset should not be counted.";
+    }
+}
+
+TEST(ShardedCounterTest, ManyCounters)
+{
+    // More counters than a chunk of shard, and index reuse
+    std::vector<std::unique_ptr<Util::ShardedCounter>> counters;
+    for (int i = 0; i < 3000; i++) {
+        counters.push_back(std::make_unique<Util::ShardedCounter>());
+        counters.back()->increment();
+    }
+    ASSERT_EQ(counters.back()->get(), 1);
+
+    counters.erase(counters.begin(), counters.begin() + 1000);
+    for (int i = 0; i < 1000; i++) {
+        counters.push_back(std::make_unique<Util::ShardedCounter>());
+        ASSERT_EQ(counters.back()->get(), 0)
+            << "A counter reusing an index should start at zero.";
+    }
+}
@@ -0,0 +1,238 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#ifndef _WIN32
+
+#include <chrono>
+#include <csignal>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "instructions/addPrimitiveType.h"
+#include "instructions/set.h"
+#include "learn/learningAgent.h"
+#include "learn/learningParameters.h"
+#include "learn/sharedMemoryLearningEnvironment.h"
+
+#include "learn/stickGameWithOpponent.h"
+
+class SharedMemoryLearningEnvironmentTest : public ::testing::Test
+{
+  protected:
+    std::string name;
+
+    // Stand-in simulator, serving a StickGameWithOpponent in a child process.
+    pid_t startSimulator()
+    {
+        pid_t pid = fork();
+        if (pid == 0) {
+            int status = 0;
+            try {
+                StickGameWithOpponent simulator;
+                Learn::SharedMemoryEnvironmentServer<int> server(this->name,
+                                                                 simulator);
+                server.serve();
+            }
+            catch (...) {
+                status = 1;
+            }
+            _exit(status);
+        }
+        return pid;
+    }
+
+    // Wait for the end of the simulator, and return its exit status.
+    int waitSimulator(pid_t pid)
+    {
+        int status;
+        waitpid(pid, &status, 0);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+
+    virtual void SetUp()
+    {
+        name = "/gegelati_test_" + std::to_string(getpid());
+    }
+};
+
+TEST_F(SharedMemoryLearningEnvironmentTest, Channel)
+{
+    Learn::SharedMemoryChannel channel(name, 3, 16);
+    ASSERT_THROW(Learn::SharedMemoryChannel(name, 3, 16), std::runtime_error)
+        << "Creating an existing region should fail.";
+
+    Learn::SharedMemoryChannel attached(name);
+    ASSERT_EQ(attached.getNbActions(), 3);
+    ASSERT_EQ(attached.getObservationSize(), 16);
+
+    Learn::SharedMemoryChannel::Message message{};
+    message.type = Learn::SharedMemoryChannel::MessageType::ACTION;
+    for (uint64_t i = 0; i < Learn::SharedMemoryChannel::RING_SIZE; i++) {
+        message.actionID = i;
+        ASSERT_TRUE(channel.pushRequest(message));
+    }
+    ASSERT_FALSE(channel.pushRequest(message)) << "Ring should be full.";
+    for (uint64_t i = 0; i < Learn::SharedMemoryChannel::RING_SIZE; i++) {
+        ASSERT_TRUE(attached.popRequest(message));
+        ASSERT_EQ(message.actionID, i) << "Messages should be FIFO.";
+    }
+    ASSERT_FALSE(attached.popRequest(message)) << "Ring should be empty.";
+
+    ASSERT_THROW(Learn::SharedMemoryChannel("/gegelati_missing_region"),
+                 std::runtime_error);
+}
+
+TEST_F(SharedMemoryLearningEnvironmentTest, PlayAgainstInProcess)
+{
+    // 1 remaining sticks counter and 3 hints
+    Learn::SharedMemoryLearningEnvironment<int> le(name, 3, 4);
+    pid_t pid = startSimulator();
+    ASSERT_GT(pid, 0);
+
+    StickGameWithOpponent reference;
+    for (size_t seed = 0; seed < 5; seed++) {
+        le.reset(seed);
+        reference.reset(seed);
+        uint64_t step = 0;
+        while (!reference.isTerminal()) {
+            const Data::DataHandler& obs = le.getDataSources().at(0);
+            const Data::DataHandler& sticks =
+                reference.getDataSources().at(0);
+            ASSERT_EQ(*obs.getDataAt(typeid(int), 0)
+                           .getSharedPointer<const int>(),
+                      *sticks.getDataAt(typeid(int), 0)
+                           .getSharedPointer<const int>())
+                << "Observation differs from the in-process environment.";
+            ASSERT_FALSE(le.isTerminal());
+
+            le.submitAction(step % 3);
+            reference.doAction(step % 3);
+            le.awaitAction();
+            step++;
+        }
+        ASSERT_TRUE(le.isTerminal());
+        ASSERT_EQ(le.getScore(), reference.getScore());
+    }
+
+    ASSERT_THROW(le.doAction(3), std::runtime_error)
+        << "Invalid actions should be rejected by the adapter.";
+}
+
+TEST_F(SharedMemoryLearningEnvironmentTest, Train)
+{
+    pid_t pid;
+    {
+        Learn::SharedMemoryLearningEnvironment<int> le(name, 3, 4);
+        pid = startSimulator();
+        ASSERT_GT(pid, 0);
+
+        Instructions::Set set;
+        set.add(*(new Instructions::AddPrimitiveType<int>()));
+        set.add(*(new Instructions::AddPrimitiveType<double>()));
+        Learn::LearningParameters params;
+        params.mutation.tpg.nbRoots = 10;
+        params.mutation.tpg.maxInitOutgoingEdges = 3;
+        params.mutation.tpg.maxOutgoingEdges = 4;
+        params.mutation.prog.maxProgramSize = 20;
+        params.nbIterationsPerPolicyEvaluation = 2;
+
+        Learn::LearningAgent la(le, set, params);
+        la.init();
+        ASSERT_NO_THROW(la.trainOneGeneration(0))
+            << "Training with a shared memory environment failed.";
+        delete (&set.getInstruction(0));
+        delete (&set.getInstruction(1));
+    }
+    // Destruction of the environment stops the simulator
+    ASSERT_EQ(waitSimulator(pid), 0);
+}
+
+TEST_F(SharedMemoryLearningEnvironmentTest, SimulatorTimeout)
+{
+    // No simulator attaches to the region.
+    Learn::SharedMemoryLearningEnvironment<int> le(name, 3, 4);
+    le.setTimeout(std::chrono::milliseconds(50));
+    ASSERT_EQ(le.getTimeout(), std::chrono::milliseconds(50));
+
+    ASSERT_THROW(le.reset(0), std::runtime_error)
+        << "Waiting for a missing simulator should time out.";
+}
+
+TEST_F(SharedMemoryLearningEnvironmentTest, SimulatorTermination)
+{
+    Learn::SharedMemoryLearningEnvironment<int> le(name, 3, 4);
+    le.setTimeout(std::chrono::milliseconds::zero());
+    pid_t pid = startSimulator();
+    ASSERT_GT(pid, 0);
+
+    ASSERT_NO_THROW(le.reset(0));
+    ASSERT_TRUE(le.getChannel().isPeerAlive());
+
+    kill(pid, SIGKILL);
+    waitSimulator(pid);
+    ASSERT_FALSE(le.getChannel().isPeerAlive())
+        << "Termination of the simulator should be detected.";
+    ASSERT_THROW(le.doAction(0), std::runtime_error)
+        << "Waiting for a terminated simulator should fail, even without "
+           "timeout.";
+}
+
+TEST_F(SharedMemoryLearningEnvironmentTest, ManySteps)
+{
+    // Long sequence of steps, exercising the wrap-around of the rings.
+    const size_t nbSteps = 10 * Learn::SharedMemoryChannel::RING_SIZE;
+    Learn::SharedMemoryLearningEnvironment<int> le(name, 3, 4);
+    pid_t pid = startSimulator();
+    ASSERT_GT(pid, 0);
+
+    StickGameWithOpponent reference;
+    le.reset(0);
+    reference.reset(0);
+    for (size_t step = 0; step < nbSteps; step++) {
+        if (reference.isTerminal()) {
+            ASSERT_TRUE(le.isTerminal());
+            ASSERT_EQ(le.getScore(), reference.getScore());
+            le.reset(step);
+            reference.reset(step);
+        }
+        le.doAction(step % 3);
+        reference.doAction(step % 3);
+    }
+    ASSERT_EQ(le.getScore(), reference.getScore())
+        << "Score differs from the in-process environment.";
+}
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "util/threadAffinity.h"
+
+TEST(ThreadAffinityTest, ParseCPUList)
+{
+    std::vector<int> cpus;
+    ASSERT_NO_THROW(cpus = Util::ThreadAffinity::parseCPUList("0,2,4-7"))
+        << "Parsing of a valid CPU list failed.";
+    ASSERT_EQ(cpus, std::vector<int>({0, 2, 4, 5, 6, 7}));
+
+    ASSERT_THROW(Util::ThreadAffinity::parseCPUList("0,"), std::runtime_error)
+        << "A trailing comma should be rejected.";
+    ASSERT_THROW(Util::ThreadAffinity::parseCPUList("3-1"),
+                 std::runtime_error)
+        << "A decreasing range should be rejected.";
+    ASSERT_THROW(Util::ThreadAffinity::parseCPUList("a"), std::runtime_error)
+        << "A non numerical CPU should be rejected.";
+}
+
+TEST(ThreadAffinityTest, Policies)
+{
+    std::map<int, std::vector<int>> topology = {{0, {0, 1, 2}}, {1, {3, 4}}};
+
+    Util::ThreadAffinity none("none", topology);
+    ASSERT_EQ(none.getPolicy(), Util::ThreadAffinity::Policy::NONE);
+    ASSERT_EQ(none.getCPU(0), -1) << "Threads should not be pinned.";
+    ASSERT_EQ(none.getNbNodes(), 2);
+    ASSERT_EQ(none.getNode(4), 1);
+
+    Util::ThreadAffinity compact("compact", topology);
+    ASSERT_EQ(compact.getPolicy(), Util::ThreadAffinity::Policy::COMPACT);
+    std::vector<int> expectedCompact = {0, 1, 2, 3, 4, 0};
+    for (size_t i = 0; i < expectedCompact.size(); i++) {
+        ASSERT_EQ(compact.getCPU(i), expectedCompact.at(i))
+            << "Wrong CPU for worker " << i << " with compact policy.";
+    }
+
+    Util::ThreadAffinity scatter("scatter", topology);
+    ASSERT_EQ(scatter.getPolicy(), Util::ThreadAffinity::Policy::SCATTER);
+    std::vector<int> expectedScatter = {0, 3, 1, 4, 2, 0};
+    for (size_t i = 0; i < expectedScatter.size(); i++) {
+        ASSERT_EQ(scatter.getCPU(i), expectedScatter.at(i))
+            << "Wrong CPU for worker " << i << " with scatter policy.";
+    }
+
+    Util::ThreadAffinity explicitList("4,1", topology);
+    ASSERT_EQ(explicitList.getPolicy(),
+              Util::ThreadAffinity::Policy::EXPLICIT);
+    ASSERT_EQ(explicitList.getCPU(0), 4);
+    ASSERT_EQ(explicitList.getCPU(1), 1);
+    ASSERT_EQ(explicitList.getCPU(2), 4);
+
+    ASSERT_THROW(Util::ThreadAffinity("sparse", topology), std::runtime_error)
+        << "An unknown policy should be rejected.";
+}
+
+TEST(ThreadAffinityTest, PinCurrentThread)
+{
+    Util::ThreadAffinity affinity("compact");
+    ASSERT_GE(affinity.getNbNodes(), 1);
+    ASSERT_GE(affinity.getCPU(0), 0);
+
+#ifdef __linux__
+    std::thread thread([&affinity]() {
+        ASSERT_TRUE(Util::ThreadAffinity::pinCurrentThread(affinity.getCPU(0)))
+            << "Pinning a thread to an available CPU failed.";
+        ASSERT_EQ(affinity.getCurrentNode(),
+                  affinity.getNode(affinity.getCPU(0)));
+    });
+    thread.join();
+#endif
+    ASSERT_FALSE(Util::ThreadAffinity::pinCurrentThread(-1));
+}
+
+TEST(ThreadAffinityTest, ScopedPin)
+{
+    Util::ThreadAffinity affinity("compact");
+
+#ifdef __linux__
+    std::thread thread([&affinity]() {
+        std::vector<int> allowedCPUs =
+            Util::ThreadAffinity::getCurrentThreadCPUs();
+        ASSERT_FALSE(allowedCPUs.empty());
+        {
+            Util::ThreadAffinity::ScopedPin pin(affinity.getCPU(0));
+            ASSERT_TRUE(pin.isPinned());
+            ASSERT_EQ(Util::ThreadAffinity::getCurrentThreadCPUs(),
+                      std::vector<int>{affinity.getCPU(0)});
+        }
+        ASSERT_EQ(Util::ThreadAffinity::getCurrentThreadCPUs(), allowedCPUs)
+            << "CPUs of the thread should be restored.";
+    });
+    thread.join();
+#endif
+    Util::ThreadAffinity::ScopedPin unpinned(-1);
+    ASSERT_FALSE(unpinned.isPinned());
+}
+
+#ifdef __linux__
+TEST(ThreadAffinityTest, TopologyAllowedCPUs)
+{
+    cpu_set_t allowedSet;
+    CPU_ZERO(&allowedSet);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &allowedSet), 0);
+
+    // Policies only use the CPUs the process is allowed to run on.
+    for (const std::string& policy : {"compact", "scatter"}) {
+        Util::ThreadAffinity affinity(policy);
+        for (size_t worker = 0; worker < (size_t)CPU_COUNT(&allowedSet);
+             worker++) {
+            ASSERT_TRUE(CPU_ISSET(affinity.getCPU(worker), &allowedSet))
+                << "CPU " << affinity.getCPU(worker) << " of the " << policy
+                << " policy is not allowed for the process.";
+        }
+    }
+}
+#endif
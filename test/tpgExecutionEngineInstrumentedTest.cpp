@@ -37,6 +37,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <thread>
 
 #include "data/dataHandler.h"
 #include "data/primitiveTypeArray.h"
@@ -289,3 +290,183 @@ TEST_F(TPGExecutionEngineInstrumentedTest, TraceHistoryAccessors)
     ASSERT_EQ(tpeei.getTraceHistory().size(), 0)
         << "Trace history isn't empty after clear.";
 }
+
+TEST_F(TPGExecutionEngineInstrumentedTest, SamplingPeriod)
+{
+    TPG::TPGExecutionEngineInstrumented tpeei(*e);
+    const TPG::TPGActionInstrumented* action =
+        dynamic_cast<const TPG::TPGActionInstrumented*>(
+            tpg->getVertices().at(6));
+    const TPG::TPGTeamInstrumented* t0 =
+        dynamic_cast<const TPG::TPGTeamInstrumented*>(tpg->getVertices().at(0));
+
+    ASSERT_EQ(tpeei.getSamplingPeriod(), 1);
+    ASSERT_THROW(tpeei.setSamplingPeriod(0), std::invalid_argument)
+        << "A zero sampling period should be refused.";
+    ASSERT_NO_THROW(tpeei.setSamplingPeriod(3));
+    ASSERT_EQ(tpeei.getSamplingPeriod(), 3);
+
+    for (int i = 0; i < 7; i++) {
+        tpeei.executeFromRoot(*tpg->getRootVertices().at(0));
+    }
+
+    // Executions 0, 3 and 6 are recorded
+    ASSERT_EQ(tpeei.getTraceHistory().size(), 3)
+        << "Only sampled executions should be recorded.";
+    ASSERT_EQ(tpeei.getNbRecordedTraces(), 3);
+    ASSERT_EQ(action->getNbVisits(), 3)
+        << "Only sampled executions should update counters.";
+    ASSERT_EQ(t0->getNbVisits(), 3)
+        << "Only sampled executions should update counters.";
+
+    // Direct evaluations are always recorded
+    tpeei.evaluateTeam(*t0);
+    ASSERT_EQ(t0->getNbVisits(), 4);
+}
+
+TEST_F(TPGExecutionEngineInstrumentedTest, TraceReservoir)
+{
+    TPG::TPGExecutionEngineInstrumented tpeei(*e);
+    ASSERT_EQ(tpeei.getMaxNbTraces(), 0);
+    tpeei.setMaxNbTraces(4, 42);
+    ASSERT_EQ(tpeei.getMaxNbTraces(), 4);
+
+    // Alternate between the two roots
+    std::vector<const TPG::TPGVertex*> roots = tpg->getRootVertices();
+    for (int i = 0; i < 100; i++) {
+        tpeei.executeFromRoot(*roots.at(i % 2));
+    }
+
+    ASSERT_EQ(tpeei.getTraceHistory().size(), 4)
+        << "Trace history should not exceed its maximum size.";
+    ASSERT_EQ(tpeei.getNbRecordedTraces(), 100);
+    for (const auto& trace : tpeei.getTraceHistory()) {
+        ASSERT_TRUE(trace.front() == roots.at(0) ||
+                    trace.front() == roots.at(1))
+            << "Trace history should only contain recorded traces.";
+    }
+
+    // Counters are not bounded
+    const TPG::TPGVertexInstrumentation* root0 =
+        dynamic_cast<const TPG::TPGVertexInstrumentation*>(roots.at(0));
+    ASSERT_EQ(root0->getNbVisits(), 50);
+
+    // Same seed, same sample
+    TPG::TPGExecutionEngineInstrumented tpeei2(*e);
+    tpeei2.setMaxNbTraces(4, 42);
+    for (int i = 0; i < 100; i++) {
+        tpeei2.executeFromRoot(*roots.at(i % 2));
+    }
+    ASSERT_EQ(tpeei.getTraceHistory(), tpeei2.getTraceHistory());
+
+    // Reducing the bound truncates the history
+    tpeei.setMaxNbTraces(2);
+    ASSERT_EQ(tpeei.getTraceHistory().size(), 2);
+    tpeei.clearTraceHistory();
+    ASSERT_EQ(tpeei.getNbRecordedTraces(), 0);
+}
+
+TEST_F(TPGExecutionEngineInstrumentedTest, FactoryParameters)
+{
+    ASSERT_THROW(TPG::TPGInstrumentedFactory(0), std::invalid_argument);
+
+    TPG::TPGInstrumentedFactory factory(5, 10);
+    auto tee = factory.createTPGExecutionEngine(*e);
+    auto* tpeei =
+        dynamic_cast<TPG::TPGExecutionEngineInstrumented*>(tee.get());
+    ASSERT_NE(tpeei, nullptr);
+    ASSERT_EQ(tpeei->getSamplingPeriod(), 5);
+    ASSERT_EQ(tpeei->getMaxNbTraces(), 10);
+
+    // Parameters are kept by the factory of created TPGGraph
+    auto graph = factory.createTPGGraph(*e);
+    tee = graph->getFactory().createTPGExecutionEngine(*e);
+    tpeei = dynamic_cast<TPG::TPGExecutionEngineInstrumented*>(tee.get());
+    ASSERT_EQ(tpeei->getSamplingPeriod(), 5);
+    ASSERT_EQ(tpeei->getMaxNbTraces(), 10);
+}
+
+TEST_F(TPGExecutionEngineInstrumentedTest, ParallelExecutions)
+{
+    const size_t nbThreads = 4;
+    const size_t nbExecutions = 250;
+
+    // Each thread executes the TPGGraph with its own engine
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nbThreads; i++) {
+        threads.emplace_back([this, nbExecutions]() {
+            TPG::TPGExecutionEngineInstrumented tpeei(*e);
+            for (size_t j = 0; j < nbExecutions; j++) {
+                tpeei.executeFromRoot(*tpg->getRootVertices().at(0));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const TPG::TPGActionInstrumented* action =
+        dynamic_cast<const TPG::TPGActionInstrumented*>(
+            tpg->getVertices().at(6));
+    const TPG::TPGEdgeInstrumented* t0t1 =
+        dynamic_cast<const TPG::TPGEdgeInstrumented*>(edges.at(4));
+    ASSERT_EQ(action->getNbVisits(), nbThreads * nbExecutions)
+        << "Visits of all threads should be merged.";
+    ASSERT_EQ(t0t1->getNbTraversal(), nbThreads * nbExecutions)
+        << "Traversals of all threads should be merged.";
+
+    action->reset();
+    ASSERT_EQ(action->getNbVisits(), 0);
+}
+
+TEST_F(TPGExecutionEngineInstrumentedTest, Timing)
+{
+    TPG::TPGExecutionEngineInstrumented tpeei(*e);
+    ASSERT_FALSE(tpeei.isTimingEnabled());
+    ASSERT_EQ(tpeei.getCycleCounter(), nullptr);
+    ASSERT_TRUE(tpeei.getInstructionTimings().empty());
+
+    tpeei.enableTiming(Util::CycleCounter::Backend::CLOCK);
+    ASSERT_TRUE(tpeei.isTimingEnabled());
+    ASSERT_EQ(tpeei.getCycleCounter()->getBackend(),
+              Util::CycleCounter::Backend::CLOCK);
+
+    // Data sources given after enabling timing are used by timed executions
+    Data::PrimitiveTypeArray<double> otherData(
+        (const Data::PrimitiveTypeArray<double>&)vect.at(0).get());
+    otherData.setDataAt(typeid(double), 0, 0.5);
+    tpeei.setDataSources({otherData, vect.at(1).get()});
+
+    const TPG::TPGEdgeInstrumented* t0t1 =
+        dynamic_cast<const TPG::TPGEdgeInstrumented*>(edges.at(4));
+    ASSERT_NEAR(tpeei.evaluateEdge(*t0t1), 4.0, PARAM_FLOAT_PRECISION)
+        << "Timed execution should use the data sources of the engine.";
+    ASSERT_EQ(t0t1->getNbVisits(), 1);
+
+    for (int i = 0; i < 5; i++) {
+        tpeei.executeFromRoot(*tpg->getRootVertices().at(0));
+    }
+    ASSERT_GT(t0t1->getNbTicks(), 0)
+        << "Duration of edge evaluations should be measured.";
+
+    // Each program has a single MultByConstant line, and each
+    // inference evaluates 7 programs.
+    auto timings = tpeei.getInstructionTimings();
+    ASSERT_EQ(timings.size(), 2);
+    ASSERT_EQ(timings.at(0).nbExecutions, 0);
+    ASSERT_EQ(timings.at(1).nbExecutions, 1 + 5 * 7)
+        << "Number of timed executions of instructions is incorrect.";
+    ASSERT_GT(timings.at(1).nbTicks, 0);
+
+    tpeei.clearInstructionTimings();
+    ASSERT_EQ(tpeei.getInstructionTimings().at(1).nbExecutions, 0);
+
+    t0t1->reset();
+    ASSERT_EQ(t0t1->getNbTicks(), 0);
+
+    tpeei.disableTiming();
+    ASSERT_FALSE(tpeei.isTimingEnabled());
+    tpeei.executeFromRoot(*tpg->getRootVertices().at(0));
+    ASSERT_EQ(t0t1->getNbTicks(), 0)
+        << "Durations should not be measured once timing is disabled.";
+}
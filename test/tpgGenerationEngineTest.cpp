@@ -38,8 +38,10 @@
 
 #ifdef CODE_GENERATION
 #include <cstddef>
+#include <fstream>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <sstream>
 
 #if defined(_MSC_VER) || (__MINGW32__)
 // C++17 not available in gcc7 or clang7
@@ -49,12 +51,15 @@
 #include "environment.h"
 #include "instructions/lambdaInstruction.h"
 #include "instructions/set.h"
+#include "tpg/instrumented/executionStats.h"
+#include "tpg/tpgExecutionEngine.h"
 #include "tpg/tpgGraph.h"
 #include "tpg/tpgVertex.h"
 
 #include "codeGen/tpgGenerationEngineFactory.h"
 #include "codeGen/tpgStackGenerationEngine.h"
 #include "codeGen/tpgSwitchGenerationEngine.h"
+#include "codeGen/tpgTableGenerationEngine.h"
 #include "goldenReferenceComparison.h"
 
 class TPGGenerationEngineTest : public ::testing::Test
@@ -197,6 +202,21 @@ TEST_F(TPGGenerationEngineTest, TPGGenerationEngineFactoryCreateStack)
     ASSERT_NO_THROW(tpgGen.reset()) << "Destruction failed.";
 }
 
+TEST_F(TPGGenerationEngineTest, TPGGenerationEngineFactoryCreateTable)
+{
+    CodeGen::TPGGenerationEngineFactory factoryTable(
+        CodeGen::TPGGenerationEngineFactory::generationEngineMode::tableMode);
+    ASSERT_NO_THROW(tpgGen = factoryTable.create("constructor", *tpg))
+        << "Failed to construct a TPGGenerationEngine with a filename and a "
+           "TPG";
+
+    ASSERT_NE(dynamic_cast<CodeGen::TPGTableGenerationEngine*>(tpgGen.get()),
+              nullptr)
+        << "Created TPGGenerationEngine has incorrect type.";
+
+    ASSERT_NO_THROW(tpgGen.reset()) << "Destruction failed.";
+}
+
 TEST_F(TPGGenerationEngineTest, TPGGenerationEngineFactoryCreateNoMode)
 {
     // Create the factory with a non-existing mode.
@@ -270,7 +290,7 @@ std::string executableExtension = ".exe ";
 std::string executableExtension = " ";
 #endif
 
-#define TEST_BOTH_MODE(TEST_NAME, TEST_CODE)                                   \
+#define TEST_ALL_MODES(TEST_NAME, TEST_CODE)                                   \
     TEST_F(TPGGenerationEngineTest, TEST_NAME##Switch)                         \
     {                                                                          \
         CodeGen::TPGGenerationEngineFactory factory(                           \
@@ -284,9 +304,16 @@ std::string executableExtension = " ";
             CodeGen::TPGGenerationEngineFactory::generationEngineMode::        \
                 stackMode);                                                    \
         TEST_CODE                                                              \
+    }                                                                          \
+    TEST_F(TPGGenerationEngineTest, TEST_NAME##Table)                          \
+    {                                                                          \
+        CodeGen::TPGGenerationEngineFactory factory(                           \
+            CodeGen::TPGGenerationEngineFactory::generationEngineMode::        \
+                tableMode);                                                    \
+        TEST_CODE                                                              \
     }
 
-TEST_BOTH_MODE(OneLeaf, {
+TEST_ALL_MODES(OneLeaf, {
     const TPG::TPGVertex* leaf = (&tpg->addNewAction(1));
     const TPG::TPGVertex* root = (&tpg->addNewTeam());
 
@@ -324,7 +351,7 @@ TEST_BOTH_MODE(OneLeaf, {
         << "Error wrong action returned in test OneLeaf.";
 });
 
-TEST_BOTH_MODE(TwoLeaves, {
+TEST_ALL_MODES(TwoLeaves, {
     const TPG::TPGVertex* leaf = (&tpg->addNewAction(1));
     const TPG::TPGVertex* leaf2 = (&tpg->addNewAction(2));
     const TPG::TPGVertex* root = (&tpg->addNewTeam());
@@ -370,7 +397,7 @@ TEST_BOTH_MODE(TwoLeaves, {
         << "Error wrong action returned in test TwoLeaves.";
 });
 
-TEST_BOTH_MODE(ThreeLeaves, {
+TEST_ALL_MODES(ThreeLeaves, {
     // P1 < P2 = P3
     const TPG::TPGVertex* leaf = (&tpg->addNewAction(1));
     const TPG::TPGVertex* leaf2 = (&tpg->addNewAction(2));
@@ -430,7 +457,7 @@ TEST_BOTH_MODE(ThreeLeaves, {
         << "Error wrong action returned in test ThreeLeaves.";
 });
 
-TEST_BOTH_MODE(OneTeamOneLeaf, {
+TEST_ALL_MODES(OneTeamOneLeaf, {
     const TPG::TPGVertex* root = (&tpg->addNewTeam());
     const TPG::TPGVertex* T1 = (&tpg->addNewTeam());
     const TPG::TPGVertex* leaf = (&tpg->addNewAction(1));
@@ -479,7 +506,7 @@ TEST_BOTH_MODE(OneTeamOneLeaf, {
         << "Error wrong action returned in test OneTeamOneLeaf";
 });
 
-TEST_BOTH_MODE(OneTeamTwoLeaves, {
+TEST_ALL_MODES(OneTeamTwoLeaves, {
     const TPG::TPGVertex* root = (&tpg->addNewTeam());
     const TPG::TPGVertex* T1 = (&tpg->addNewTeam());
     const TPG::TPGVertex* leaf = (&tpg->addNewAction(1));
@@ -538,7 +565,7 @@ TEST_BOTH_MODE(OneTeamTwoLeaves, {
         << "Error wrong action returned in test OneTeamTwoLeaves.";
 });
 
-TEST_BOTH_MODE(TwoTeams, {
+TEST_ALL_MODES(TwoTeams, {
     const TPG::TPGVertex* root = (&tpg->addNewTeam());
     const TPG::TPGVertex* T1 = (&tpg->addNewTeam());
     const TPG::TPGVertex* T2 = (&tpg->addNewTeam());
@@ -605,7 +632,7 @@ TEST_BOTH_MODE(TwoTeams, {
         << "Error wrong action returned in test TwoTeams.";
 });
 
-TEST_BOTH_MODE(TwoTeamsNegativeBid, {
+TEST_ALL_MODES(TwoTeamsNegativeBid, {
     const TPG::TPGVertex* root = (&tpg->addNewTeam());
     const TPG::TPGVertex* T1 = (&tpg->addNewTeam());
     const TPG::TPGVertex* T2 = (&tpg->addNewTeam());
@@ -697,7 +724,37 @@ static void setProgLine(const std::shared_ptr<Program::Program> prog,
     line.setOperand(1, 0, 1);
 }
 
-TEST_BOTH_MODE(ThreeTeamsThreeLeaves, {
+/**
+ * \brief Profile the inferences of a TPGGraph from its root.
+ *
+ * \param[in] graph the profiled TPGGraph.
+ * \param[in] data the data source of the Environment of graph.
+ * \param[in] inputs the values of data for each inference.
+ * \return the ExecutionStats with the traces of all inferences.
+ */
+static TPG::ExecutionStats profileTPG(
+    const TPG::TPGGraph& graph, Data::PrimitiveTypeArray<double>& data,
+    const std::vector<std::vector<double>>& inputs)
+{
+    TPG::ExecutionStats stats;
+    TPG::TPGExecutionEngine engine(graph.getEnvironment());
+    for (const auto& input : inputs) {
+        for (size_t i = 0; i < input.size(); i++) {
+            data.setDataAt(typeid(double), i, input.at(i));
+        }
+        stats.analyzeInferenceTrace(
+            engine.executeFromRoot(*graph.getRootVertices().at(0)));
+    }
+    return stats;
+}
+
+/// Inputs of profileTPG() for the TPGGraph of ThreeTeamsThreeLeaves: T1 and
+/// T3 are hot, T2 is visited once.
+static const std::vector<std::vector<double>> threeTeamsProfileInputs{
+    {1, 0, 5, 0, 0, 0}, {1, 0, 5, 0, 0, 0}, {1, 0, 5, 0, 0, 0},
+    {1, 0, 5, 0, 0, 0}, {5, 0, 1, 2, 0, 0}};
+
+TEST_ALL_MODES(ThreeTeamsThreeLeaves, {
     const TPG::TPGVertex* A1 = (&tpg->addNewAction(1));
     const TPG::TPGVertex* A2 = (&tpg->addNewAction(2));
     const TPG::TPGVertex* A0 = (&tpg->addNewAction(0));
@@ -761,4 +818,233 @@ TEST_BOTH_MODE(ThreeTeamsThreeLeaves, {
         << "Error wrong action returned in test "
            "ThreeTeamsThreeLeaves.";
 });
+
+TEST_ALL_MODES(ThreeTeamsBatch, {
+    const TPG::TPGVertex* A1 = (&tpg->addNewAction(1));
+    const TPG::TPGVertex* A2 = (&tpg->addNewAction(2));
+    const TPG::TPGVertex* A0 = (&tpg->addNewAction(0));
+    const TPG::TPGVertex* T1 = (&tpg->addNewTeam());
+    const TPG::TPGVertex* T2 = (&tpg->addNewTeam());
+    const TPG::TPGVertex* T3 = (&tpg->addNewTeam());
+
+    std::vector<std::shared_ptr<Program::Program>> progs;
+    for (int i = 0; i < 6; i++) {
+        progs.push_back(std::make_shared<Program::Program>(*e));
+        setProgLine(progs.back(), i);
+    }
+
+    tpg->addNewEdge(*T1, *T2, progs.at(0));
+    tpg->addNewEdge(*T1, *A1, progs.at(1));
+    tpg->addNewEdge(*T1, *T3, progs.at(2));
+
+    tpg->addNewEdge(*T2, *A0, progs.at(3));
+    tpg->addNewEdge(*T2, *T3, progs.at(4));
+
+    tpg->addNewEdge(*T3, *A2, progs.at(5));
+
+    tpgGen = factory.create("ThreeTeamsBatch", *tpg, "./src/");
+    ASSERT_FALSE(tpgGen->isBatchInference())
+        << "Batch inference should be disabled by default.";
+    tpgGen->setBatchInference(true);
+    ASSERT_TRUE(tpgGen->isBatchInference())
+        << "Batch inference was not enabled.";
+    ASSERT_NO_THROW(tpgGen->generateTPGGraph())
+        << "Generation of the batch inference of an acyclic TPG failed.";
+    // call the destructor to close the file
+    tpgGen.reset();
+    cmdCompile += "ThreeTeamsBatch";
+    ASSERT_EQ(system(cmdCompile.c_str()), 0)
+        << "Error while compiling the test ThreeTeamsBatch";
+
+    cmdExec += "ThreeTeamsBatch" + executableExtension;
+
+    ASSERT_EQ(system(cmdExec.c_str()), 0)
+        << "Batch inference and single inference returned different actions "
+           "in test ThreeTeamsBatch.";
+});
+
+TEST_ALL_MODES(ThreeTeamsOptimized, {
+    const TPG::TPGVertex* A1 = (&tpg->addNewAction(1));
+    const TPG::TPGVertex* A2 = (&tpg->addNewAction(2));
+    const TPG::TPGVertex* A0 = (&tpg->addNewAction(0));
+    const TPG::TPGVertex* T1 = (&tpg->addNewTeam());
+    const TPG::TPGVertex* T2 = (&tpg->addNewTeam());
+    const TPG::TPGVertex* T3 = (&tpg->addNewTeam());
+
+    std::vector<std::shared_ptr<Program::Program>> progs;
+    for (int i = 0; i < 6; i++) {
+        progs.push_back(std::make_shared<Program::Program>(*e));
+        setProgLine(progs.back(), i);
+        // Dead store: reg[2] = in1[i] - reg[0]
+        Program::Line& line = progs.back()->addNewLine();
+        line.setDestinationIndex(2);
+        line.setInstructionIndex(1);
+        line.setOperand(0, 1, i);
+        line.setOperand(1, 0, 0);
+    }
+
+    tpg->addNewEdge(*T1, *T2, progs.at(0));
+    tpg->addNewEdge(*T1, *A1, progs.at(1));
+    tpg->addNewEdge(*T1, *T3, progs.at(2));
+
+    tpg->addNewEdge(*T2, *A0, progs.at(3));
+    tpg->addNewEdge(*T2, *T3, progs.at(4));
+
+    tpg->addNewEdge(*T3, *A2, progs.at(5));
+
+    // Reuse the main file and data of ThreeTeamsThreeLeaves.
+    tpgGen = factory.create("ThreeTeamsThreeLeaves", *tpg, "./src/");
+    ASSERT_FALSE(tpgGen->isProgramOptimization())
+        << "Program optimization should be disabled by default.";
+    tpgGen->setProgramOptimization(true);
+    ASSERT_TRUE(tpgGen->isProgramOptimization())
+        << "Program optimization was not enabled.";
+    tpgGen->setBatchInference(true);
+    tpgGen->generateTPGGraph();
+    // call the destructor to close the file
+    tpgGen.reset();
+    cmdCompile += "ThreeTeamsThreeLeaves";
+    ASSERT_EQ(system(cmdCompile.c_str()), 0)
+        << "Error while compiling the test ThreeTeamsOptimized";
+
+    cmdExec += "ThreeTeamsThreeLeaves" + executableExtension;
+
+    ASSERT_EQ(system((cmdExec + path +
+                      "/ThreeTeamsThreeLeaves/"
+                      "DataThreeTeamsThreeLeaves.csv")
+                         .c_str()),
+              0)
+        << "Error wrong action returned in test ThreeTeamsOptimized.";
+});
+
+TEST_ALL_MODES(ThreeTeamsProfiled, {
+    const TPG::TPGVertex* A1 = (&tpg->addNewAction(1));
+    const TPG::TPGVertex* A2 = (&tpg->addNewAction(2));
+    const TPG::TPGVertex* A0 = (&tpg->addNewAction(0));
+    const TPG::TPGVertex* T1 = (&tpg->addNewTeam());
+    const TPG::TPGVertex* T2 = (&tpg->addNewTeam());
+    const TPG::TPGVertex* T3 = (&tpg->addNewTeam());
+
+    std::vector<std::shared_ptr<Program::Program>> progs;
+    for (int i = 0; i < 6; i++) {
+        progs.push_back(std::make_shared<Program::Program>(*e));
+        setProgLine(progs.back(), i);
+    }
+
+    tpg->addNewEdge(*T1, *T2, progs.at(0));
+    tpg->addNewEdge(*T1, *A1, progs.at(1));
+    tpg->addNewEdge(*T1, *T3, progs.at(2));
+
+    tpg->addNewEdge(*T2, *A0, progs.at(3));
+    tpg->addNewEdge(*T2, *T3, progs.at(4));
+
+    tpg->addNewEdge(*T3, *A2, progs.at(5));
+
+    TPG::ExecutionStats stats =
+        profileTPG(*tpg, currentState, threeTeamsProfileInputs);
+
+    // Reuse the main file and data of ThreeTeamsThreeLeaves.
+    tpgGen = factory.create("ThreeTeamsThreeLeaves", *tpg, "./src/");
+    ASSERT_FALSE(tpgGen->isProfileGuided())
+        << "Code generation should not be profile-guided by default.";
+    tpgGen->setProfile(stats);
+    ASSERT_TRUE(tpgGen->isProfileGuided())
+        << "Code generation is not profile-guided after setting a profile.";
+    tpgGen->generateTPGGraph();
+    // call the destructor to close the file
+    tpgGen.reset();
+    cmdCompile += "ThreeTeamsThreeLeaves";
+    ASSERT_EQ(system(cmdCompile.c_str()), 0)
+        << "Error while compiling the test ThreeTeamsProfiled";
+
+    cmdExec += "ThreeTeamsThreeLeaves" + executableExtension;
+
+    ASSERT_EQ(system((cmdExec + path +
+                      "/ThreeTeamsThreeLeaves/"
+                      "DataThreeTeamsThreeLeaves.csv")
+                         .c_str()),
+              0)
+        << "Error wrong action returned in test ThreeTeamsProfiled.";
+});
+
+TEST_F(TPGGenerationEngineTest, ProfileGuidedSwitchLayout)
+{
+    const TPG::TPGVertex* A1 = (&tpg->addNewAction(1));
+    const TPG::TPGVertex* A2 = (&tpg->addNewAction(2));
+    const TPG::TPGVertex* A0 = (&tpg->addNewAction(0));
+    const TPG::TPGVertex* T1 = (&tpg->addNewTeam());
+    const TPG::TPGVertex* T2 = (&tpg->addNewTeam());
+    const TPG::TPGVertex* T3 = (&tpg->addNewTeam());
+    // Team never visited during profiling.
+    const TPG::TPGVertex* T4 = (&tpg->addNewTeam());
+
+    std::vector<std::shared_ptr<Program::Program>> progs;
+    for (int i = 0; i < 7; i++) {
+        progs.push_back(std::make_shared<Program::Program>(*e));
+        setProgLine(progs.back(), i);
+    }
+
+    tpg->addNewEdge(*T1, *T2, progs.at(0));
+    tpg->addNewEdge(*T1, *A1, progs.at(1));
+    tpg->addNewEdge(*T1, *T3, progs.at(2));
+
+    tpg->addNewEdge(*T2, *A0, progs.at(3));
+    tpg->addNewEdge(*T2, *T3, progs.at(4));
+
+    tpg->addNewEdge(*T3, *A2, progs.at(5));
+
+    tpg->addNewEdge(*T4, *A0, progs.at(6));
+
+    // Profile from T1 only.
+    TPG::ExecutionStats stats;
+    TPG::TPGExecutionEngine engine(*e);
+    for (const auto& input : threeTeamsProfileInputs) {
+        for (size_t i = 0; i < input.size(); i++) {
+            currentState.setDataAt(typeid(double), i, input.at(i));
+        }
+        stats.analyzeInferenceTrace(engine.executeFromRoot(*T1));
+    }
+
+    CodeGen::TPGGenerationEngineFactory factory(
+        CodeGen::TPGGenerationEngineFactory::generationEngineMode::switchMode);
+    tpgGen = factory.create("ProfileGuidedSwitchLayout", *tpg, "./src/");
+    tpgGen->setProfile(stats);
+    tpgGen->generateTPGGraph();
+    // call the destructor to close the file
+    tpgGen.reset();
+
+    std::vector<std::string> fileGenerated{
+        "ProfileGuidedSwitchLayout.c", "ProfileGuidedSwitchLayout_program.h"};
+    for (const std::string& file : fileGenerated) {
+        ASSERT_TRUE(compare_files("./src/" + file,
+                                  TESTS_DAT_PATH
+                                  "codeGen/ProfileGuidedSwitchLayout/" +
+                                      file + "_ref"))
+            << "Error the generated file " << file
+            << " is different from the golden reference.";
+    }
+}
+
+TEST_ALL_MODES(CyclicBatch, {
+    const TPG::TPGVertex* A0 = (&tpg->addNewAction(0));
+    const TPG::TPGVertex* T1 = (&tpg->addNewTeam());
+    const TPG::TPGVertex* T2 = (&tpg->addNewTeam());
+    const TPG::TPGVertex* T3 = (&tpg->addNewTeam());
+
+    std::vector<std::shared_ptr<Program::Program>> progs;
+    for (int i = 0; i < 4; i++) {
+        progs.push_back(std::make_shared<Program::Program>(*e));
+        setProgLine(progs.back(), i);
+    }
+
+    tpg->addNewEdge(*T1, *T2, progs.at(0));
+    tpg->addNewEdge(*T2, *T3, progs.at(1));
+    tpg->addNewEdge(*T3, *T2, progs.at(2));
+    tpg->addNewEdge(*T3, *A0, progs.at(3));
+
+    tpgGen = factory.create("CyclicBatch", *tpg, "./src/");
+    tpgGen->setBatchInference(true);
+    ASSERT_THROW(tpgGen->generateTPGGraph(), std::runtime_error)
+        << "Batch inference should not be generated for a cyclic TPG.";
+});
 #endif // CODE_GENERATION
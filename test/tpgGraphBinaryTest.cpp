@@ -0,0 +1,304 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2024) :
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+#include "environment.h"
+#include "instructions/addPrimitiveType.h"
+#include "instructions/set.h"
+#include "learn/learningAgent.h"
+#include "learn/learningParameters.h"
+#include "learn/stickGameWithOpponent.h"
+#include "program/line.h"
+#include "program/program.h"
+#include "tpg/tpgAction.h"
+#include "tpg/tpgEdge.h"
+#include "tpg/tpgExecutionEngine.h"
+#include "tpg/tpgGraph.h"
+
+#include "file/mappedTPGPolicy.h"
+#include "file/tpgGraphBinaryExporter.h"
+#include "file/tpgGraphBinaryFormat.h"
+#include "file/tpgGraphBinaryImporter.h"
+#include "file/tpgGraphConverter.h"
+#include "file/tpgGraphDotExporter.h"
+
+class TPGGraphBinaryTest : public ::testing::Test
+{
+  protected:
+    Instructions::Set set;
+    StickGameWithOpponent le;
+    Learn::LearningParameters params;
+    Learn::LearningAgent* la = nullptr;
+
+    void SetUp() override
+    {
+        set.add(*(new Instructions::AddPrimitiveType<int>()));
+        set.add(*(new Instructions::AddPrimitiveType<double>()));
+
+        params.archiveSize = 50;
+        params.maxNbActionsPerEval = 11;
+        params.nbIterationsPerPolicyEvaluation = 3;
+        params.nbProgramConstant = 3;
+        params.mutation.tpg.maxInitOutgoingEdges = 3;
+        params.mutation.prog.maxProgramSize = 48;
+        params.mutation.tpg.nbRoots = 15;
+        params.mutation.tpg.pEdgeDeletion = 0.7;
+        params.mutation.tpg.pEdgeAddition = 0.7;
+        params.mutation.tpg.pProgramMutation = 0.2;
+        params.mutation.tpg.pEdgeDestinationChange = 0.1;
+        params.mutation.tpg.pEdgeDestinationIsAction = 0.5;
+        params.mutation.tpg.maxOutgoingEdges = 4;
+        params.mutation.prog.pAdd = 0.5;
+        params.mutation.prog.pDelete = 0.5;
+        params.mutation.prog.pMutate = 1.0;
+        params.mutation.prog.pSwap = 1.0;
+        params.mutation.prog.pConstantMutation = 0.5;
+        params.mutation.prog.minConstValue = -5;
+        params.mutation.prog.maxConstValue = 5;
+
+        // Train a few generations to get a non-trivial graph.
+        la = new Learn::LearningAgent(le, set, params);
+        la->init(3);
+        for (uint64_t i = 0; i < 3; i++) {
+            la->trainOneGeneration(i);
+        }
+    }
+
+    void TearDown() override
+    {
+        delete la;
+        remove("binaryTPGForTest.bin");
+        remove("binaryTPGForTest.dot");
+        delete (&set.getInstruction(0));
+        delete (&set.getInstruction(1));
+    }
+};
+
+TEST_F(TPGGraphBinaryTest, ExportImport)
+{
+    const TPG::TPGGraph& graph = *la->getTPGGraph();
+    File::TPGGraphBinaryExporter exporter("binaryTPGForTest.bin", graph);
+    ASSERT_NO_THROW(exporter.exportGraph())
+        << "Export of a TPGGraph in binary format failed.";
+
+    TPG::TPGGraph imported(la->getEnvironment());
+    ASSERT_NO_THROW(
+        File::TPGGraphBinaryImporter("binaryTPGForTest.bin", imported))
+        << "Import of a TPGGraph in binary format failed.";
+
+    ASSERT_EQ(imported.getNbVertices(), graph.getNbVertices())
+        << "Number of vertices of the imported graph is incorrect.";
+    ASSERT_EQ(imported.getNbRootVertices(), graph.getNbRootVertices())
+        << "Number of roots of the imported graph is incorrect.";
+    ASSERT_EQ(imported.getEdges().size(), graph.getEdges().size())
+        << "Number of edges of the imported graph is incorrect.";
+
+    // Outgoing edges of each vertex are identical, in the same order.
+    const auto vertices = graph.getVertices();
+    const auto importedVertices = imported.getVertices();
+    for (size_t v = 0; v < vertices.size(); v++) {
+        const auto& edges = vertices.at(v)->getOutgoingEdges();
+        const auto& importedEdges = importedVertices.at(v)->getOutgoingEdges();
+        ASSERT_EQ(edges.size(), importedEdges.size());
+        auto importedEdge = importedEdges.begin();
+        for (const TPG::TPGEdge* edge : edges) {
+            const Program::Program& p1 = edge->getProgram();
+            const Program::Program& p2 = (*importedEdge)->getProgram();
+            ASSERT_EQ(p1.getNbLines(), p2.getNbLines());
+            for (uint64_t i = 0; i < p1.getNbLines(); i++) {
+                ASSERT_EQ(p1.getLine(i), p2.getLine(i))
+                    << "Imported Program lines differ.";
+                ASSERT_EQ(p1.isIntron(i), p2.isIntron(i))
+                    << "Imported intron property differs.";
+            }
+            for (size_t i = 0; i < params.nbProgramConstant; i++) {
+                ASSERT_EQ(p1.getConstantAt(i), p2.getConstantAt(i))
+                    << "Imported Program constants differ.";
+            }
+            importedEdge++;
+        }
+    }
+
+    // Without intron mask, introns are identified when importing.
+    ASSERT_NO_THROW(exporter.exportGraph(false));
+    TPG::TPGGraph importedNoMask(la->getEnvironment());
+    File::TPGGraphBinaryImporter("binaryTPGForTest.bin", importedNoMask);
+    ASSERT_EQ(importedNoMask.getEdges().size(), graph.getEdges().size());
+}
+
+TEST_F(TPGGraphBinaryTest, MappedTPGPolicy)
+{
+    const TPG::TPGGraph& graph = *la->getTPGGraph();
+    File::TPGGraphBinaryExporter("binaryTPGForTest.bin", graph).exportGraph();
+
+    File::MappedTPGPolicy* policy;
+    ASSERT_NO_THROW(policy = new File::MappedTPGPolicy("binaryTPGForTest.bin",
+                                                       la->getEnvironment()))
+        << "Mapping a binary TPG file failed.";
+    ASSERT_EQ(policy->getNbRoots(), graph.getNbRootVertices());
+
+    // Compare decisions with the TPGExecutionEngine over a few game states.
+    TPG::TPGExecutionEngine tee(la->getEnvironment());
+    const auto roots = graph.getRootVertices();
+    le.reset(0);
+    for (int step = 0; step < 5 && !le.isTerminal(); step++) {
+        for (size_t r = 0; r < roots.size(); r++) {
+            const TPG::TPGAction* action = (const TPG::TPGAction*)tee
+                                               .executeFromRoot(*roots.at(r))
+                                               .back();
+            ASSERT_EQ(policy->executeFromRoot(r), action->getActionID())
+                << "MappedTPGPolicy decision differs from TPGExecutionEngine.";
+        }
+        le.doAction(policy->executeFromRoot(0));
+    }
+
+    ASSERT_THROW(policy->executeFromRoot(roots.size()), std::out_of_range)
+        << "Executing an invalid root should fail.";
+    delete policy;
+}
+
+TEST_F(TPGGraphBinaryTest, InvalidFile)
+{
+    const TPG::TPGGraph& graph = *la->getTPGGraph();
+    File::TPGGraphBinaryExporter("binaryTPGForTest.bin", graph).exportGraph();
+
+    // Non-existing file
+    TPG::TPGGraph imported(la->getEnvironment());
+    ASSERT_THROW(File::TPGGraphBinaryImporter("nonExistingFile.bin", imported),
+                 std::runtime_error)
+        << "Importing a non-existing file should fail.";
+
+    // Different Environment
+    Environment otherEnv(set, le.getDataSources(), 4, 0);
+    TPG::TPGGraph otherGraph(otherEnv);
+    ASSERT_THROW(
+        File::TPGGraphBinaryImporter("binaryTPGForTest.bin", otherGraph),
+        std::runtime_error)
+        << "Importing a file exported with a different Environment should "
+           "fail.";
+    ASSERT_THROW(File::MappedTPGPolicy("binaryTPGForTest.bin", otherEnv),
+                 std::runtime_error)
+        << "Mapping a file exported with a different Environment should "
+           "fail.";
+
+    // Corrupted files
+    std::string content;
+    {
+        std::ifstream in("binaryTPGForTest.bin", std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(in),
+                       std::istreambuf_iterator<char>());
+    }
+
+    // Operand out of the address space, or whose data source does not
+    // provide the operand type (constants for the AddPrimitiveType).
+    using File::TPGGraphBinaryFormat::Header;
+    using File::TPGGraphBinaryFormat::OperandRecord;
+    Header header;
+    std::memcpy(&header, content.data(), sizeof(Header));
+    ASSERT_GT(header.nbLines, 0) << "Test requires a program with lines.";
+    OperandRecord validOperand;
+    std::memcpy(&validOperand, content.data() + header.operandTableOffset,
+                sizeof(OperandRecord));
+    OperandRecord invalidOperands[2] = {validOperand, validOperand};
+    invalidOperands[0].location = la->getEnvironment().getLargestAddressSpace();
+    invalidOperands[1].dataSource = 1;
+    for (const OperandRecord& operand : invalidOperands) {
+        std::string corrupted = content;
+        std::memcpy(&corrupted[header.operandTableOffset], &operand,
+                    sizeof(OperandRecord));
+        {
+            std::ofstream out("binaryTPGForTest.bin", std::ios::binary);
+            out.write(corrupted.data(), corrupted.size());
+        }
+        ASSERT_THROW(
+            File::TPGGraphBinaryImporter("binaryTPGForTest.bin", imported),
+            std::runtime_error)
+            << "Importing a file with an invalid operand should fail.";
+        ASSERT_THROW(File::MappedTPGPolicy("binaryTPGForTest.bin",
+                                           la->getEnvironment()),
+                     std::runtime_error)
+            << "Mapping a file with an invalid operand should fail.";
+    }
+
+    // Truncated file
+    {
+        std::ofstream out("binaryTPGForTest.bin", std::ios::binary);
+        out.write(content.data(), content.size() / 2);
+    }
+    ASSERT_THROW(File::TPGGraphBinaryImporter("binaryTPGForTest.bin", imported),
+                 std::runtime_error)
+        << "Importing a truncated file should fail.";
+    ASSERT_EQ(imported.getNbVertices(), 0)
+        << "A failed import should not modify the TPGGraph.";
+
+    // Not a binary TPG file
+    {
+        std::ofstream out("binaryTPGForTest.bin", std::ios::binary);
+        out << std::string(512, 'x');
+    }
+    ASSERT_THROW(File::TPGGraphBinaryImporter("binaryTPGForTest.bin", imported),
+                 std::runtime_error)
+        << "Importing a file with an invalid header should fail.";
+}
+
+TEST_F(TPGGraphBinaryTest, Converter)
+{
+    const TPG::TPGGraph& graph = *la->getTPGGraph();
+    File::TPGGraphDotExporter("binaryTPGForTest.dot", graph).print();
+
+    ASSERT_NO_THROW(File::TPGGraphConverter::dotToBinary(
+        "binaryTPGForTest.dot", "binaryTPGForTest.bin", la->getEnvironment()))
+        << "Conversion from dot to binary failed.";
+    TPG::TPGGraph fromBinary(la->getEnvironment());
+    File::TPGGraphBinaryImporter("binaryTPGForTest.bin", fromBinary);
+    ASSERT_EQ(fromBinary.getNbVertices(), graph.getNbVertices());
+    ASSERT_EQ(fromBinary.getEdges().size(), graph.getEdges().size());
+
+    ASSERT_NO_THROW(File::TPGGraphConverter::binaryToDot(
+        "binaryTPGForTest.bin", "binaryTPGForTest.dot", la->getEnvironment()))
+        << "Conversion from binary to dot failed.";
+    TPG::TPGGraph fromDot(la->getEnvironment());
+    File::TPGGraphConverter::dotToBinary(
+        "binaryTPGForTest.dot", "binaryTPGForTest.bin", la->getEnvironment());
+    TPG::TPGGraph fromBinary2(la->getEnvironment());
+    File::TPGGraphBinaryImporter("binaryTPGForTest.bin", fromBinary2);
+    ASSERT_EQ(fromBinary2.getNbVertices(), graph.getNbVertices());
+    ASSERT_EQ(fromBinary2.getEdges().size(), graph.getEdges().size());
+}
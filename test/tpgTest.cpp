@@ -592,6 +592,65 @@ TEST_F(TPGTest, TPGGraphCloneEdge)
         << "Cloning an edge not from the graph should not succeed.";
 }
 
+TEST_F(TPGTest, TPGGraphImportSubGraph)
+{
+    // Source graph: team0 -> team1 -> action4, team0 -> action4
+    TPG::TPGGraph src(*e);
+    const TPG::TPGTeam& team0 = src.addNewTeam();
+    const TPG::TPGTeam& team1 = src.addNewTeam();
+    const TPG::TPGAction& action4 = src.addNewAction(4);
+    // Line using the double instruction, reading registers only.
+    progPointer->addNewLine().setInstructionIndex(1);
+    src.addNewEdge(team0, team1, progPointer);
+    src.addNewEdge(team1, action4, progPointer);
+    auto otherProg =
+        std::shared_ptr<Program::Program>(new Program::Program(*e));
+    src.addNewEdge(team0, action4, otherProg);
+
+    // Destination graph already contains action 4 and a program
+    TPG::TPGGraph dest(*e);
+    const TPG::TPGAction& destAction4 = dest.addNewAction(4);
+    dest.addNewEdge(dest.addNewTeam(), destAction4, progPointer);
+
+    const TPG::TPGVertex* imported;
+    ASSERT_NO_THROW(imported = &dest.importSubGraph(team0))
+        << "Importing a subgraph from another TPGGraph failed.";
+    ASSERT_EQ(dest.getNbVertices(), 4)
+        << "Number of vertices after import is incorrect.";
+    ASSERT_EQ(dest.getEdges().size(), 4)
+        << "Number of edges after import is incorrect.";
+    ASSERT_EQ(dest.getNbRootVertices(), 2)
+        << "Imported root should be a root of the destination graph.";
+    ASSERT_EQ(typeid(*imported), typeid(TPG::TPGTeam));
+
+    // Existing action is reused, programs are deep copies shared as in the
+    // source graph.
+    const Program::Program* copiedProg = nullptr;
+    for (const TPG::TPGEdge* edge : imported->getOutgoingEdges()) {
+        ASSERT_NE(&edge->getProgram(), progPointer.get())
+            << "Imported edges should not share programs with the source.";
+        if (edge->getDestination() == &destAction4) {
+            ASSERT_EQ(edge->getProgram().getNbLines(), 0);
+        }
+        else {
+            ASSERT_EQ(edge->getProgram().getNbLines(), 1);
+            copiedProg = &edge->getProgram();
+            const TPG::TPGEdge* next =
+                *edge->getDestination()->getOutgoingEdges().begin();
+            ASSERT_EQ(next->getDestination(), &destAction4)
+                << "Action with an existing ID should be reused.";
+            ASSERT_EQ(&next->getProgram(), copiedProg)
+                << "A Program shared in the source graph should be shared "
+                   "once copied.";
+        }
+    }
+    ASSERT_NE(copiedProg, nullptr);
+
+    // Importing a vertex of the graph itself is not possible.
+    ASSERT_THROW(dest.importSubGraph(*imported), std::runtime_error)
+        << "Importing a vertex of the graph itself should fail.";
+}
+
 TEST_F(TPGTest, TPGGraphSetEdgeDestination)
 {
     TPG::TPGGraph tpg(*e);